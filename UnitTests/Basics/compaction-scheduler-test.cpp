@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for CompactionScheduler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "VocBase/CompactionScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CCompactionSchedulerSetup {
+  CCompactionSchedulerSetup () {
+    BOOST_TEST_MESSAGE("setup CompactionScheduler");
+  }
+
+  ~CCompactionSchedulerSetup () {
+    BOOST_TEST_MESSAGE("tear-down CompactionScheduler");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CCompactionSchedulerTest, CCompactionSchedulerSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that an unlimited bandwidth never makes compaction wait
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unlimited) {
+  CompactionScheduler scheduler(0, 0);
+
+  BOOST_CHECK_EQUAL(0.0, scheduler.consume(1024 * 1024 * 1024));
+  BOOST_CHECK_EQUAL(0.0, scheduler.consume(1024 * 1024 * 1024));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that consuming more than the bandwidth asks for a wait
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_consume) {
+  CompactionScheduler scheduler(0, 1000);
+
+  // the bucket starts full
+  BOOST_CHECK_EQUAL(0.0, scheduler.consume(500));
+
+  // 2000 bytes over the limit take two seconds
+  double wait = scheduler.consume(2500);
+  BOOST_CHECK(wait > 1.9);
+  BOOST_CHECK(wait <= 2.0);
+
+  // the debt accumulates
+  wait = scheduler.consume(1000);
+  BOOST_CHECK(wait > 2.9);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a throttled compaction waits
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_throttle_waits) {
+  CompactionScheduler scheduler(0, 10000);
+
+  auto start = chrono::steady_clock::now();
+  scheduler.throttle(12000, [] () -> bool { return false; });
+  auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+  BOOST_CHECK(elapsed.count() >= 150);
+  BOOST_CHECK(elapsed.count() < 2000);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a throttled compaction stops waiting at shutdown
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_throttle_stops) {
+  CompactionScheduler scheduler(0, 1000);
+  atomic<bool> shutdown(false);
+
+  thread stopper([&shutdown] () {
+    this_thread::sleep_for(chrono::milliseconds(50));
+    shutdown = true;
+  });
+
+  // this would wait for an hour
+  auto start = chrono::steady_clock::now();
+  scheduler.throttle(3600 * 1000, [&shutdown] () -> bool { return shutdown.load(); });
+  auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+  stopper.join();
+
+  BOOST_CHECK(elapsed.count() < 1000);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test waiting in slices
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_wait) {
+  BOOST_CHECK_EQUAL(true, CompactionScheduler::wait(0.05, [] () -> bool { return false; }));
+  BOOST_CHECK_EQUAL(false, CompactionScheduler::wait(10.0, [] () -> bool { return true; }));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that tasks run in order of priority
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_execute_serially) {
+  string order;
+  vector<CompactionScheduler::Task> tasks;
+
+  tasks.emplace_back(0.1, [&order] () -> bool { order += "c"; return false; });
+  tasks.emplace_back(0.9, [&order] () -> bool { order += "a"; return true; });
+  tasks.emplace_back(0.5, [&order] () -> bool { order += "b"; return true; });
+
+  BOOST_CHECK_EQUAL((size_t) 2, CompactionScheduler::executeSerially(tasks));
+  BOOST_CHECK_EQUAL("abc", order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the lanes of the Dispatcher
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/DispatcherQueue.h"
+#include "Dispatcher/DispatcherThread.h"
+#include "Dispatcher/Job.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace std;
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a job which runs a function
+////////////////////////////////////////////////////////////////////////////////
+
+class TestJob : public Job {
+  public:
+
+    TestJob (size_t queue, size_t lane, function<void()> const& work)
+      : Job("TestJob"),
+        _queue(queue),
+        _lane(lane),
+        _work(work) {
+    }
+
+    size_t queue () const override {
+      return _queue;
+    }
+
+    size_t lane () const override {
+      return _lane;
+    }
+
+    status_t work () override {
+      _work();
+      return status_t(JOB_DONE);
+    }
+
+    bool cancel () override {
+      return false;
+    }
+
+    void cleanup (DispatcherQueue* queue) override {
+      queue->removeJob(this);
+      delete this;
+    }
+
+    void handleError (Exception const&) override {
+    }
+
+  private:
+
+    size_t const _queue;
+    size_t const _lane;
+    function<void()> const _work;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CDispatcherSetup {
+  CDispatcherSetup ()
+    : dispatcher(nullptr) {
+    BOOST_TEST_MESSAGE("setup Dispatcher");
+  }
+
+  ~CDispatcherSetup () {
+    release = true;
+    dispatcher.beginShutdown();
+    dispatcher.shutdown();
+
+    BOOST_TEST_MESSAGE("tear-down Dispatcher");
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a job running the function
+////////////////////////////////////////////////////////////////////////////////
+
+  void add (size_t queue, size_t lane, function<void()> const& work) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, dispatcher.addJob(new TestJob(queue, lane, work)));
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a job which waits until the jobs are released
+////////////////////////////////////////////////////////////////////////////////
+
+  void addBlocker (size_t queue, DispatcherThread** thread) {
+    add(queue, Dispatcher::LONG_LANE, [this, thread] () -> void {
+      *thread = DispatcherThread::currentDispatcherThread;
+      ++started;
+
+      while (! release) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+      }
+    });
+
+    BOOST_CHECK(waitFor(started, 1));
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits at most ten seconds until the counter reaches the value
+////////////////////////////////////////////////////////////////////////////////
+
+  bool waitFor (atomic<int>& counter, int value) {
+    for (int i = 0;  i < 10000;  ++i) {
+      if (counter >= value) {
+        return true;
+      }
+
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    return false;
+  }
+
+  Dispatcher dispatcher;
+  atomic<bool> release{false};
+  atomic<int> started{0};
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CDispatcherTest, CDispatcherSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that short jobs run before long ones and never wait for them
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_short_lane) {
+  dispatcher.addStandardQueue(2, 64);
+
+  DispatcherThread* blocker = nullptr;
+  addBlocker(Dispatcher::STANDARD_QUEUE, &blocker);
+
+  atomic<int> longDone(0);
+  atomic<int> shortDone(0);
+
+  for (int i = 0;  i < 3;  ++i) {
+    add(Dispatcher::STANDARD_QUEUE, Dispatcher::LONG_LANE, [&longDone] () -> void {
+      ++longDone;
+    });
+  }
+
+  for (int i = 0;  i < 3;  ++i) {
+    add(Dispatcher::STANDARD_QUEUE, Dispatcher::SHORT_LANE, [&shortDone, &blocker] () -> void {
+      BOOST_CHECK(DispatcherThread::currentDispatcherThread != blocker);
+      ++shortDone;
+    });
+  }
+
+  // the last thread is kept free for the short jobs
+  BOOST_CHECK(waitFor(shortDone, 3));
+  this_thread::sleep_for(chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(0, longDone.load());
+
+  release = true;
+  BOOST_CHECK(waitFor(longDone, 3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that an idle thread takes short, but not long jobs of a busy
+/// queue
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_steal) {
+  dispatcher.addStandardQueue(1, 64);
+  dispatcher.addAQLQueue(1, 64);
+
+  // start the thread of the standard queue
+  atomic<int> done(0);
+  DispatcherThread* standard = nullptr;
+
+  add(Dispatcher::STANDARD_QUEUE, Dispatcher::SHORT_LANE, [&done, &standard] () -> void {
+    standard = DispatcherThread::currentDispatcherThread;
+    ++done;
+  });
+
+  BOOST_CHECK(waitFor(done, 1));
+
+  DispatcherThread* blocker = nullptr;
+  addBlocker(Dispatcher::AQL_QUEUE, &blocker);
+  BOOST_CHECK(blocker != standard);
+
+  atomic<int> longDone(0);
+
+  add(Dispatcher::AQL_QUEUE, Dispatcher::LONG_LANE, [&longDone] () -> void {
+    ++longDone;
+  });
+
+  add(Dispatcher::AQL_QUEUE, Dispatcher::SHORT_LANE, [&done, &standard] () -> void {
+    BOOST_CHECK(DispatcherThread::currentDispatcherThread == standard);
+    ++done;
+  });
+
+  BOOST_CHECK(waitFor(done, 2));
+  this_thread::sleep_for(chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(0, longDone.load());
+
+  release = true;
+  BOOST_CHECK(waitFor(longDone, 1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a stolen job blocks a thread of the queue it belongs to
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_steal_block) {
+  dispatcher.addStandardQueue(1, 64);
+  dispatcher.addAQLQueue(1, 64);
+
+  atomic<int> done(0);
+  DispatcherThread* standard = nullptr;
+
+  add(Dispatcher::STANDARD_QUEUE, Dispatcher::SHORT_LANE, [&done, &standard] () -> void {
+    standard = DispatcherThread::currentDispatcherThread;
+    ++done;
+  });
+
+  BOOST_CHECK(waitFor(done, 1));
+
+  DispatcherThread* blocker = nullptr;
+  addBlocker(Dispatcher::AQL_QUEUE, &blocker);
+
+  atomic<bool> blocked(false);
+  atomic<bool> resume(false);
+
+  add(Dispatcher::AQL_QUEUE, Dispatcher::SHORT_LANE, [&] () -> void {
+    DispatcherThread* thread = DispatcherThread::currentDispatcherThread;
+    BOOST_CHECK(thread == standard);
+
+    thread->block();
+    blocked = true;
+
+    while (! resume) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    thread->unblock();
+    ++done;
+  });
+
+  for (int i = 0;  i < 10000 && ! blocked;  ++i) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+
+  BOOST_CHECK(blocked.load());
+
+  // the blocked thread belongs to the standard queue, but the job to the
+  // AQL queue, so the AQL queue starts another thread for its next job
+  add(Dispatcher::AQL_QUEUE, Dispatcher::SHORT_LANE, [&done, &standard, &blocker] () -> void {
+    BOOST_CHECK(DispatcherThread::currentDispatcherThread != standard);
+    BOOST_CHECK(DispatcherThread::currentDispatcherThread != blocker);
+    ++done;
+  });
+
+  BOOST_CHECK(waitFor(done, 2));
+
+  resume = true;
+  BOOST_CHECK(waitFor(done, 3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -391,6 +391,55 @@ BOOST_AUTO_TEST_CASE (tst_json_hash) {
   FREE_JSON
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that values which compare equal have the same value hash
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_value_hash) {
+  char const* equal[][2] = {
+    { "null", "null" },
+    { "0", "-0" },
+    { "\"abc\"", "\"abc\"" },
+    { "{ \"a\": 1, \"b\": 2 }", "{ \"b\": 2, \"a\": 1 }" },
+    { "{ \"a\": null }", "{ }" },
+    { "{ \"a\": null, \"b\": [ 1 ] }", "{ \"b\": [ 1, null ] }" },
+    { "[ 1 ]", "[ 1, null ]" },
+    { "[ { \"x\": 1, \"y\": 2 } ]", "[ { \"y\": 2, \"x\": 1 } ]" }
+  };
+
+  for (auto& pair : equal) {
+    TRI_json_t* l = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, pair[0]);
+    TRI_json_t* r = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, pair[1]);
+
+    BOOST_CHECK(TRI_CheckSameValueJson(l, r));
+    BOOST_CHECK_EQUAL(TRI_ValueHashJson(l), TRI_ValueHashJson(r));
+
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, l);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, r);
+  }
+
+  char const* different[][2] = {
+    { "null", "false" },
+    { "0", "1" },
+    { "\"a\"", "\"b\"" },
+    { "[ 1, 2 ]", "[ 2, 1 ]" },
+    { "{ \"a\": 1 }", "{ \"b\": 1 }" },
+    { "{ \"a\": 1, \"b\": 2 }", "{ \"a\": 2, \"b\": 1 }" },
+    { "[ ]", "{ }" }
+  };
+
+  for (auto& pair : different) {
+    TRI_json_t* l = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, pair[0]);
+    TRI_json_t* r = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, pair[1]);
+
+    BOOST_CHECK(! TRI_CheckSameValueJson(l, r));
+    BOOST_CHECK(TRI_ValueHashJson(l) != TRI_ValueHashJson(r));
+
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, l);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, r);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test hashing by attribute names
 ////////////////////////////////////////////////////////////////////////////////
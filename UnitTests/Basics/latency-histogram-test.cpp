@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for LatencyHistogram
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Dr. Frank Celler
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/LatencyHistogram.h"
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CLatencyHistogramSetup {
+  CLatencyHistogramSetup () {
+    BOOST_TEST_MESSAGE("setup LatencyHistogram");
+  }
+
+  ~CLatencyHistogramSetup () {
+    BOOST_TEST_MESSAGE("tear-down LatencyHistogram");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CLatencyHistogramTest, CLatencyHistogramSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the buckets cover all values without gaps
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_buckets) {
+  BOOST_CHECK_EQUAL((size_t) 0, LatencyHistogram::bucketIndex(0));
+  BOOST_CHECK_EQUAL((size_t) 127, LatencyHistogram::bucketIndex(127));
+  BOOST_CHECK_EQUAL((size_t) 128, LatencyHistogram::bucketIndex(128));
+  BOOST_CHECK_EQUAL((size_t) 128, LatencyHistogram::bucketIndex(129));
+  BOOST_CHECK_EQUAL(LatencyHistogram::BucketCount - 1, LatencyHistogram::bucketIndex(LatencyHistogram::MaxValue));
+  BOOST_CHECK_EQUAL(LatencyHistogram::BucketCount - 1, LatencyHistogram::bucketIndex(UINT64_MAX));
+
+  uint64_t low = 0;
+
+  for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+    uint64_t high = LatencyHistogram::highestEquivalentValue(i);
+
+    BOOST_CHECK_EQUAL(i, LatencyHistogram::bucketIndex(low));
+    BOOST_CHECK_EQUAL(i, LatencyHistogram::bucketIndex(high));
+
+    // the width of a bucket is small compared to its values
+    BOOST_CHECK(high - low <= low / 64);
+
+    low = high + 1;
+  }
+
+  BOOST_CHECK_EQUAL(LatencyHistogram::MaxValue + 1, low);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test an empty histogram
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_empty) {
+  LatencyHistogram histogram;
+
+  BOOST_CHECK_EQUAL((uint64_t) 0, histogram.count());
+  BOOST_CHECK_EQUAL((uint64_t) 0, histogram.sum());
+  BOOST_CHECK_EQUAL((uint64_t) 0, histogram.max());
+  BOOST_CHECK_EQUAL((uint64_t) 0, histogram.valueAtPercentile(50.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test percentiles
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_percentiles) {
+  LatencyHistogram histogram;
+
+  for (uint64_t i = 1; i <= 100000; ++i) {
+    histogram.record(i);
+  }
+
+  BOOST_CHECK_EQUAL((uint64_t) 100000, histogram.count());
+  BOOST_CHECK_EQUAL((uint64_t) 100000 * 100001 / 2, histogram.sum());
+  BOOST_CHECK_EQUAL((uint64_t) 100000, histogram.max());
+
+  double const percentiles[] = { 0.0, 10.0, 50.0, 90.0, 99.0, 99.9 };
+
+  for (auto percentile : percentiles) {
+    double expected = (percentile == 0.0 ? 1.0 : percentile * 1000.0);
+    double value = (double) histogram.valueAtPercentile(percentile);
+
+    BOOST_CHECK(value >= expected);
+    BOOST_CHECK(value <= expected * (1.0 + 1.0 / 64.0));
+  }
+
+  BOOST_CHECK_EQUAL((uint64_t) 100000, histogram.valueAtPercentile(100.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test a long tail
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_tail) {
+  LatencyHistogram histogram;
+
+  for (int i = 0; i < 9990; ++i) {
+    histogram.record(100);
+  }
+
+  for (int i = 0; i < 10; ++i) {
+    histogram.record(5000000);
+  }
+
+  BOOST_CHECK_EQUAL((uint64_t) 100, histogram.valueAtPercentile(50.0));
+  BOOST_CHECK_EQUAL((uint64_t) 100, histogram.valueAtPercentile(99.0));
+  BOOST_CHECK_EQUAL((uint64_t) 100, histogram.valueAtPercentile(99.8));
+  BOOST_CHECK_EQUAL((uint64_t) 5000000, histogram.valueAtPercentile(99.99));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test concurrent writers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_concurrent) {
+  LatencyHistogram histogram;
+
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram, t] () {
+      for (uint64_t i = 0; i < 10000; ++i) {
+        histogram.record(i + t);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  BOOST_CHECK_EQUAL((uint64_t) 40000, histogram.count());
+  BOOST_CHECK_EQUAL((uint64_t) 10002, histogram.max());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
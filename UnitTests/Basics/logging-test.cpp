@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for threaded logging
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/files.h"
+#include "Basics/logging.h"
+#include "Basics/random.h"
+#include "Basics/tri-strings.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CLoggingSetup {
+  CLoggingSetup () {
+    BOOST_TEST_MESSAGE("setup logging");
+
+    ostringstream name;
+    name << "/tmp/arangotest-logging-" << (uint64_t) TRI_microtime() << TRI_UInt32Random();
+    _filename = name.str();
+
+    initialize();
+  }
+
+  ~CLoggingSetup () {
+    BOOST_TEST_MESSAGE("tear-down logging");
+
+    TRI_SetBlockOnOverflowLogging(false);
+    TRI_ShutdownLogging(true);
+    TRI_UnlinkFile(_filename.c_str());
+  }
+
+  void initialize () {
+    TRI_InitializeLogging(true);
+    TRI_CreateLogAppenderFile(_filename.c_str(), nullptr, TRI_LOG_SEVERITY_UNKNOWN, false, false);
+    TRI_SetLogLevelLogging("info");
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lines of the log file that contain the marker
+////////////////////////////////////////////////////////////////////////////////
+
+  vector<string> lines (char const* marker) {
+    TRI_FlushLogging();
+
+    vector<string> result;
+    size_t length;
+    char* content = TRI_SlurpFile(TRI_UNKNOWN_MEM_ZONE, _filename.c_str(), &length);
+
+    if (content == nullptr) {
+      return result;
+    }
+
+    istringstream input(string(content, length));
+    TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, content);
+
+    string line;
+    while (getline(input, line)) {
+      size_t pos = line.find(marker);
+
+      if (pos != string::npos) {
+        result.emplace_back(line.substr(pos));
+      }
+    }
+
+    return result;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that each of the threads logged all of its messages
+////////////////////////////////////////////////////////////////////////////////
+
+  void checkMessages (char const* marker,
+                      int numThreads,
+                      int numMessages,
+                      bool ordered) {
+    vector<int> next(numThreads, 0);
+    vector<int> count(numThreads, 0);
+
+    for (auto const& line : lines(marker)) {
+      int thread, message;
+      BOOST_REQUIRE_EQUAL(2, sscanf(line.c_str() + strlen(marker), " %d %d", &thread, &message));
+      BOOST_REQUIRE(thread >= 0 && thread < numThreads);
+
+      if (ordered) {
+        BOOST_CHECK_EQUAL(next[thread], message);
+        next[thread] = message + 1;
+      }
+      ++count[thread];
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+      BOOST_CHECK_EQUAL(numMessages, count[i]);
+    }
+  }
+
+  string _filename;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CLoggingTest, CLoggingSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that no message is lost if threads wait for room
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_block_on_overflow) {
+  int const numThreads = 4;
+  int const numMessages = 5000;
+
+  TRI_SetBlockOnOverflowLogging(true);
+  uint64_t dropped = TRI_DroppedMessagesLogging();
+
+  vector<thread> threads;
+
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([i] () {
+      for (int j = 0; j < numMessages; ++j) {
+        LOG_INFO("blocking %d %d", i, j);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  checkMessages("blocking", numThreads, numMessages, true);
+  BOOST_CHECK_EQUAL(dropped, TRI_DroppedMessagesLogging());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that errors are not dropped if the rings are full
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_errors_not_dropped) {
+  int const numThreads = 4;
+  int const numMessages = 5000;
+
+  TRI_SetBlockOnOverflowLogging(false);
+  uint64_t dropped = TRI_DroppedMessagesLogging();
+
+  vector<thread> threads;
+
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([i] () {
+      for (int j = 0; j < numMessages; ++j) {
+        LOG_ERROR("important %d %d", i, j);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // errors written by their thread may overtake the ring
+  checkMessages("important", numThreads, numMessages, false);
+  BOOST_CHECK_EQUAL(dropped, TRI_DroppedMessagesLogging());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the messages of an ended thread are written
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_ended_thread) {
+  int const numMessages = 100;
+
+  thread t([] () {
+    for (int j = 0; j < numMessages; ++j) {
+      LOG_INFO("ended %d %d", 0, j);
+    }
+  });
+  t.join();
+
+  checkMessages("ended", 1, numMessages, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a thread can log after logging was restarted
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_restart) {
+  LOG_INFO("restart %d %d", 0, 0);
+  BOOST_CHECK_EQUAL((size_t) 1, lines("restart").size());
+
+  // the ring of this thread is kept and used again
+  TRI_ShutdownLogging(false);
+  initialize();
+
+  LOG_INFO("restart %d %d", 0, 1);
+  checkMessages("restart", 1, 2, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that running threads keep their rings over a restart and that
+/// their pending messages are written at shutdown
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_restart_running_threads) {
+  int const numThreads = 4;
+  int const numMessages = 1000;
+
+  TRI_SetBlockOnOverflowLogging(true);
+
+  atomic<int> logged(0);
+  atomic<bool> restarted(false);
+  vector<thread> threads;
+
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([i, &logged, &restarted] () {
+      for (int j = 0; j < numMessages; ++j) {
+        LOG_INFO("running %d %d", i, j);
+      }
+
+      ++logged;
+
+      while (! restarted) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+      }
+
+      for (int j = numMessages; j < 2 * numMessages; ++j) {
+        LOG_INFO("running %d %d", i, j);
+      }
+    });
+  }
+
+  while (logged < numThreads) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+
+  TRI_ShutdownLogging(false);
+  initialize();
+  restarted = true;
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  checkMessages("running", numThreads, 2 * numMessages, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
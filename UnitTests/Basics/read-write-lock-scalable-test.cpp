@@ -0,0 +1,338 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for ReadWriteLockScalable
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/ReadWriteLockScalable.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CReadWriteLockScalableSetup {
+  CReadWriteLockScalableSetup () {
+    BOOST_TEST_MESSAGE("setup ReadWriteLockScalable");
+  }
+
+  ~CReadWriteLockScalableSetup () {
+    BOOST_TEST_MESSAGE("tear-down ReadWriteLockScalable");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CReadWriteLockScalableTest, CReadWriteLockScalableSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test read locks exclude write locks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_read_excludes_write) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  lock.readLock();
+  BOOST_CHECK_EQUAL(true, lock.tryReadLock());
+  BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+
+  lock.unlock();
+  BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+
+  lock.unlock();
+  BOOST_CHECK_EQUAL(true, lock.tryWriteLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test write locks exclude all other locks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_write_excludes_all) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  lock.writeLock();
+  BOOST_CHECK_EQUAL(false, lock.tryReadLock());
+  BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+
+  lock.unlock();
+  BOOST_CHECK_EQUAL(true, lock.tryReadLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the scoped lockers release the lock
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_lockers) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  {
+    READ_LOCKER_SCALABLE(lock);
+    BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+
+    {
+      READ_LOCKER_SCALABLE(lock);
+      BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+    }
+
+    BOOST_CHECK_EQUAL(false, lock.tryWriteLock());
+  }
+
+  {
+    WRITE_LOCKER_SCALABLE(lock);
+    BOOST_CHECK_EQUAL(false, lock.tryReadLock());
+  }
+
+  BOOST_CHECK_EQUAL(true, lock.tryWriteLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test releasing a read lock in another thread
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unlock_other_thread) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  lock.readLock();
+
+  std::thread t([&lock] () {
+    lock.unlock();
+  });
+  t.join();
+
+  BOOST_CHECK_EQUAL(true, lock.tryWriteLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the write lock holder sees waiting readers and writers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_has_waiters) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  lock.writeLock();
+  BOOST_CHECK_EQUAL(false, lock.hasWaiters());
+
+  // a reader that only tries
+  BOOST_CHECK_EQUAL(false, lock.tryReadLock());
+  BOOST_CHECK_EQUAL(true, lock.hasWaiters());
+
+  lock.unlock();
+
+  // acquiring the write lock again resets the flag
+  lock.writeLock();
+  BOOST_CHECK_EQUAL(false, lock.hasWaiters());
+
+  // a blocked reader
+  std::thread reader([&lock] () {
+    lock.readLock();
+    lock.unlock();
+  });
+
+  while (! lock.hasWaiters()) {
+    std::this_thread::yield();
+  }
+
+  lock.unlock();
+  reader.join();
+
+  // a blocked writer
+  lock.writeLock();
+  BOOST_CHECK_EQUAL(false, lock.hasWaiters());
+
+  std::thread writer([&lock] () {
+    lock.writeLock();
+    lock.unlock();
+  });
+
+  while (! lock.hasWaiters()) {
+    std::this_thread::yield();
+  }
+
+  lock.unlock();
+  writer.join();
+
+  BOOST_CHECK_EQUAL(true, lock.tryWriteLock());
+  BOOST_CHECK_EQUAL(false, lock.hasWaiters());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that blocked readers get the lock before the next writer
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_reader_turn) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  std::atomic<int> order(0);
+  int readerPosition = 0;
+  int writerPosition = 0;
+
+  lock.writeLock();
+
+  std::thread reader([&] () {
+    lock.readLock();
+    readerPosition = ++order;
+    lock.unlock();
+  });
+
+  while (! lock.hasWaiters()) {
+    std::this_thread::yield();
+  }
+
+  std::thread writer([&] () {
+    lock.writeLock();
+    writerPosition = ++order;
+    lock.unlock();
+  });
+
+  // give the second writer time to queue up behind us
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  lock.unlock();
+  reader.join();
+  writer.join();
+
+  BOOST_CHECK_EQUAL(1, readerPosition);
+  BOOST_CHECK_EQUAL(2, writerPosition);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that readers make progress while writers queue up all the time
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_writers_do_not_starve_readers) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  std::atomic<bool> done(false);
+  std::atomic<int> reads(0);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] () {
+      while (! done.load()) {
+        lock.writeLock();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        lock.unlock();
+      }
+    });
+  }
+
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&] () {
+      for (int i = 0; i < 100; ++i) {
+        lock.readLock();
+        ++reads;
+        lock.unlock();
+      }
+    });
+  }
+
+  // the readers must finish although there always is a writer waiting
+  while (reads.load() < 200) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  done = true;
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  BOOST_CHECK_EQUAL(200, reads.load());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test concurrent readers and writers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_concurrent) {
+  triagens::basics::ReadWriteLockScalable lock;
+
+  std::atomic<int> readers(0);
+  std::atomic<int> writers(0);
+  std::atomic<bool> conflict(false);
+  uint64_t value = 0;
+
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] () {
+      for (int i = 0; i < 20000; ++i) {
+        if ((i + t) % 50 == 0) {
+          lock.writeLock();
+          if (readers > 0 || writers++ > 0) {
+            conflict = true;
+          }
+          ++value;
+          --writers;
+          lock.unlock();
+        }
+        else {
+          lock.readLock();
+          ++readers;
+          if (writers > 0) {
+            conflict = true;
+          }
+          --readers;
+          lock.unlock();
+        }
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  BOOST_CHECK_EQUAL(false, conflict.load());
+  BOOST_CHECK_EQUAL(8 * 20000 / 50, (int) value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
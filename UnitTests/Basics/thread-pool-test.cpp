@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for ThreadPool
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CThreadPoolSetup {
+  CThreadPoolSetup () {
+    BOOST_TEST_MESSAGE("setup ThreadPool");
+  }
+
+  ~CThreadPoolSetup () {
+    BOOST_TEST_MESSAGE("tear-down ThreadPool");
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs n items concurrently and returns the maximum number of
+/// threads that worked at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+  size_t run (ThreadPool* pool,
+              size_t concurrency,
+              size_t n,
+              vector<atomic<int>>& done) {
+    atomic<size_t> next(0);
+    atomic<size_t> active(0);
+    atomic<size_t> maxActive(0);
+
+    auto work = [&] () -> void {
+      size_t current = ++active;
+      size_t expected = maxActive.load();
+
+      while (current > expected && ! maxActive.compare_exchange_weak(expected, current)) {
+      }
+
+      size_t i;
+      while ((i = next++) < n) {
+        ++done[i];
+        this_thread::sleep_for(chrono::microseconds(100));
+      }
+
+      --active;
+    };
+
+    ThreadPool::runConcurrently(pool, work, concurrency);
+
+    BOOST_CHECK_EQUAL((size_t) 0, active.load());
+    return maxActive.load();
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CThreadPoolTest, CThreadPoolSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the work runs in the calling thread without a pool
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_no_pool) {
+  vector<atomic<int>> done(100);
+
+  BOOST_CHECK_EQUAL((size_t) 1, run(nullptr, 8, done.size(), done));
+
+  for (auto const& it : done) {
+    BOOST_CHECK_EQUAL(1, it.load());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that each item is done once and the concurrency is bounded
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_concurrency) {
+  ThreadPool pool(4, "Test");
+  vector<atomic<int>> done(2000);
+
+  size_t maxActive = run(&pool, 3, done.size(), done);
+  BOOST_CHECK(maxActive >= 1);
+  BOOST_CHECK(maxActive <= 3);
+
+  for (auto const& it : done) {
+    BOOST_CHECK_EQUAL(1, it.load());
+  }
+
+  // never more threads than the pool has, plus the caller
+  for (auto& it : done) {
+    it = 0;
+  }
+
+  maxActive = run(&pool, 100, done.size(), done);
+  BOOST_CHECK(maxActive <= 5);
+
+  for (auto const& it : done) {
+    BOOST_CHECK_EQUAL(1, it.load());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a pool thread can run work on its own pool
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_nested) {
+  ThreadPool pool(2, "Test");
+  vector<atomic<int>> done(200);
+  atomic<size_t> next(0);
+
+  auto outer = [&] () -> void {
+    size_t i;
+    while ((i = next.fetch_add(10)) < done.size()) {
+      atomic<size_t> inner(i);
+
+      ThreadPool::runConcurrently(&pool, [&] () -> void {
+        size_t j;
+        while ((j = inner++) < i + 10) {
+          ++done[j];
+          this_thread::sleep_for(chrono::microseconds(100));
+        }
+      }, 3);
+    }
+  };
+
+  ThreadPool::runConcurrently(&pool, outer, 3);
+
+  for (auto const& it : done) {
+    BOOST_CHECK_EQUAL(1, it.load());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that exceptions are rethrown in the calling thread
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_exception) {
+  ThreadPool pool(4, "Test");
+  atomic<int> calls(0);
+
+  auto work = [&calls] () -> void {
+    ++calls;
+    this_thread::sleep_for(chrono::milliseconds(10));
+    throw runtime_error("failed");
+  };
+
+  BOOST_CHECK_THROW(ThreadPool::runConcurrently(&pool, work, 4), runtime_error);
+  BOOST_CHECK(calls.load() >= 1);
+  BOOST_CHECK(calls.load() <= 4);
+
+  // the pool is still usable
+  vector<atomic<int>> done(100);
+  run(&pool, 4, done.size(), done);
+
+  for (auto const& it : done) {
+    BOOST_CHECK_EQUAL(1, it.load());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
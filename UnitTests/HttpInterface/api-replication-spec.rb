@@ -334,6 +334,90 @@ describe ArangoDB do
          
       end
 
+      it "fetches some collection operations from the follow log in binary format" do
+        ArangoDB.drop_collection("UnitTestsReplication")
+        
+        sleep 1
+
+        cmd = api + "/logger-state"
+        doc = ArangoDB.log_get("#{prefix}-follow-binary", cmd, :body => "")
+        doc.code.should eq(200)
+        doc.parsed_response["state"]["running"].should eq(true)
+        fromTick = doc.parsed_response["state"]["lastLogTick"]
+
+        # create collection 
+        cid = ArangoDB.create_collection("UnitTestsReplication")
+
+        # create document 
+        cmd = "/_api/document?collection=UnitTestsReplication"
+        body = "{ \"_key\" : \"test\", \"test\" : false }"
+        doc = ArangoDB.log_post("#{prefix}-follow-binary", cmd, :body => body) 
+        doc.code.should eq(201)
+        
+        # delete document 
+        cmd = "/_api/document/UnitTestsReplication/test"
+        doc = ArangoDB.log_delete("#{prefix}-follow-binary", cmd) 
+        doc.code.should eq(200)
+
+        sleep 1
+
+        cmd = api + "/logger-follow?binary=true&from=" + fromTick
+        doc = ArangoDB.log_get("#{prefix}-follow-binary", cmd, :body => "", :format => :plain)
+        doc.code.should eq(200)
+
+        doc.headers["x-arango-replication-lastincluded"].should match(/^\d+$/)
+        doc.headers["x-arango-replication-lastincluded"].should_not eq("0")
+        doc.headers["content-type"].should eq("application/x-arango-dump-binary")
+        
+        body = doc.response.body.force_encoding("BINARY")
+
+        # the first record is the header with version, byte order and word size
+        length, type, version, byteOrder, wordSize = body.unpack("LCCLC")
+        length.should eq(11)
+        type.should eq(6)
+        version.should eq(1)
+        byteOrder.should eq(0x01020304)
+        wordSize.should eq(8)
+
+        types = [ ]
+        keys = [ ]
+        offset = length
+
+        while offset < body.length
+          length, type = body.unpack("@#{offset}LC")
+          length.should >= 5
+          type.should_not eq(6)
+
+          if type == 1 
+            # collection name
+            if body.unpack("@#{offset + 5}Q")[0].to_s == cid
+              body[offset + 13, length - 13].should eq("UnitTestsReplication")
+              types.push(type)
+            end
+          elsif type == 4 
+            # document or removal
+            operation, tick, tid, recordCid, rev, keyLength = body.unpack("@#{offset + 5}SQQQQS")
+            if recordCid.to_s == cid
+              tick.to_s.to_i.should >= fromTick.to_i
+              rev.should_not eq(0)
+              keys.push([ operation, body[offset + 41, keyLength] ])
+              types.push(type)
+            end
+          elsif type == 5
+            # other marker as JSON
+            document = JSON.parse(body[offset + 5, length - 6])
+            document.should have_key("tick") 
+            document.should have_key("type") 
+          end
+
+          offset += length
+        end
+
+        offset.should eq(body.length)
+        types.should eq([ 1, 4, 4 ])
+        keys.should eq([ [ 2300, "test" ], [ 2302, "test" ] ])
+      end
+
     end
 
 ################################################################################
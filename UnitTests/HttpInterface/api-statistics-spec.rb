@@ -44,6 +44,123 @@ describe ArangoDB do
       doc.code.should eq(200)
     end
 
+################################################################################
+## check V8 context wait time distribution
+###############################################################################
+
+    it "testing statistics V8 context wait time" do 
+      cmd = "/_admin/statistics"
+      doc = ArangoDB.log_get("#{prefix}-v8-context", cmd) 
+  
+      doc.code.should eq(200)
+      dist = doc.parsed_response['server']['v8ContextWaitTime']
+      dist['count'].should be_kind_of(Integer)
+      dist['sum'].should be_kind_of(Numeric)
+      dist['counts'].length.should eq(6)
+    end
+
+    it "testing statistics of the V8 contexts" do
+      cmd = "/_admin/statistics"
+      doc = ArangoDB.log_get("#{prefix}", cmd)
+
+      doc.code.should eq(200)
+
+      contexts = doc.parsed_response['server']['v8Contexts']
+      contexts.should be_kind_of(Array)
+      contexts.length.should be > 0
+      contexts.each do |context|
+        context['heapLimit'].should be > 0
+        context['heapUsed'].should be_kind_of(Integer)
+        context['gcPauses'].should be_kind_of(Integer)
+        context['gcPauseMax'].should be_kind_of(Numeric)
+      end
+    end
+
+################################################################################
+## check request latency histograms
+###############################################################################
+
+    it "testing statistics request latencies" do 
+      cmd = "/_admin/statistics"
+      doc = ArangoDB.log_get("#{prefix}-latency", cmd) 
+      doc.code.should eq(200)
+
+      # the statistics of a request are processed in the background
+      doc = nil
+      10.times do
+        doc = ArangoDB.log_get("#{prefix}-latency", cmd + "?percentiles=50,99.9") 
+        doc.code.should eq(200)
+        break if doc.parsed_response['latency'].has_key?('/_admin')
+        sleep 1
+      end
+
+      latency = doc.parsed_response['latency']['/_admin']['GET']
+      [ "totalTime", "requestTime", "queueTime", "ioTime" ].each do |name|
+        latency[name]['count'].should be_kind_of(Integer)
+        latency[name]['sum'].should be_kind_of(Numeric)
+        latency[name]['max'].should be_kind_of(Numeric)
+        latency[name]['percentiles'].keys.sort.should eq([ "50", "99.9" ])
+      end
+
+      total = latency['totalTime']
+      total['count'].should be > 0
+      total['percentiles']['50'].should be <= total['percentiles']['99.9']
+      total['percentiles']['99.9'].should be <= total['max']
+    end
+
+    it "testing statistics invalid percentiles" do 
+      cmd = "/_admin/statistics?percentiles=50,101"
+      doc = ArangoDB.log_get("#{prefix}-latency", cmd) 
+  
+      doc.code.should eq(400)
+      doc.parsed_response['error'].should eq(true)
+      doc.parsed_response['errorNum'].should eq(400)
+    end
+
+################################################################################
+## check wait statistics
+###############################################################################
+
+    it "testing wait statistics" do 
+      cmd = "/_admin/statistics/waits"
+      doc = ArangoDB.log_get("#{prefix}-waits", cmd) 
+  
+      doc.code.should eq(200)
+
+      cuts = doc.parsed_response['cuts']
+      cuts.length.should eq(6)
+
+      waits = doc.parsed_response['waits']
+      [ "walSlot", "walSync", "datafileSync", "v8Context", "dispatcherQueue" ].each do |name|
+        waits[name]['count'].should be_kind_of(Integer)
+        waits[name]['sum'].should be_kind_of(Numeric)
+        waits[name]['counts'].length.should eq(cuts.length + 1)
+      end
+
+      # this request itself went through a dispatcher queue
+      waits['dispatcherQueue']['count'].should be > 0
+      doc.parsed_response['handlers'].should be_kind_of(Hash)
+      doc.parsed_response['handlers'].length.should be > 0
+
+      lanes = doc.parsed_response['lanes']
+      [ "short", "long" ].each do |name|
+        lanes[name]['count'].should be_kind_of(Integer)
+        lanes[name]['sum'].should be_kind_of(Numeric)
+        lanes[name]['max'].should be_kind_of(Numeric)
+        lanes[name]['percentiles'].keys.should eq([ "50", "90", "99", "99.9" ])
+      end
+
+      # this request itself went through the long lane
+      lanes['long']['count'].should be > 0
+
+      doc.parsed_response['collections'].each do |name, locks|
+        locks['readWaits'].should be_kind_of(Integer)
+        locks['writeWaits'].should be_kind_of(Integer)
+        locks['readWaitTime'].should be_kind_of(Numeric)
+        locks['writeWaitTime'].should be_kind_of(Numeric)
+      end
+    end
+
 ################################################################################
 ## check statistics for wrong user interaction
 ###############################################################################
@@ -113,6 +113,7 @@ ApplicationServer::ApplicationServer (std::string const& name, std::string const
     _logThreadId(false),
     _logLineNumber(false),
     _logLocalTime(false),
+    _logOverflow("drop"),
     _logSourceFilter(),
     _logContentFilter(),
 #ifdef _WIN32
@@ -202,6 +203,16 @@ void ApplicationServer::setupLogging (bool threaded, bool daemon, bool backgroun
   TRI_SetUseLocalTimeLogging(_logLocalTime);
   TRI_SetLineNumberLogging(_logLineNumber);
 
+  if (_logOverflow == "block") {
+    TRI_SetBlockOnOverflowLogging(true);
+  }
+  else {
+    if (_logOverflow != "drop") {
+      LOG_WARNING("unknown value '%s' for --log.overflow. using 'drop'", _logOverflow.c_str());
+    }
+    TRI_SetBlockOnOverflowLogging(false);
+  }
+
   TRI_SetLogLevelLogging(_logLevel.c_str());
   TRI_SetLogSeverityLogging(severity.c_str());
   TRI_SetPrefixLogging(_logPrefix.c_str());
@@ -788,6 +799,7 @@ void ApplicationServer::setupOptions (map<string, ProgramOptionsDescription>& op
     ("log.source-filter", &_logSourceFilter, "only debug and trace messages emitted by specific C source file")
     ("log.content-filter", &_logContentFilter, "only log message containing the specified string (case-sensitive)")
     ("log.line-number", "always log file and line number")
+    ("log.overflow", &_logOverflow, "if a thread logs faster than messages are written: 'drop' or 'block'")
     ("log.performance", "log performance indicators")
     ("log.prefix", &_logPrefix, "prefix log")
     ("log.thread", "log the thread identifier")
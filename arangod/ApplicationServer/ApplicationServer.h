@@ -678,6 +678,23 @@ namespace triagens {
         
         bool _logLocalTime;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief behavior if a thread produces log messages faster than they are
+/// written
+/// @startDocuBlock logOverflow
+/// `--log.overflow arg`
+///
+/// Each thread hands its log messages to the logging thread in a buffer of
+/// its own, which holds up to 1024 messages. If *arg* is `drop`, a message
+/// that does not fit into the full buffer is dropped, and the number of
+/// dropped messages is logged as a warning. If *arg* is `block`, the thread
+/// waits until the logging thread has made room. The default is `drop`, so
+/// that a slow log target never stalls the server.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _logOverflow;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief log source filter
 /// @startDocuBlock logSourceFilter
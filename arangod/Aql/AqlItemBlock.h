@@ -299,6 +299,18 @@ namespace triagens {
           return _docColls;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief approximate memory used by the block itself, i.e. its registers
+/// and the bookkeeping of its values, but not the values' contents
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memoryUsage () const {
+          return sizeof(AqlItemBlock) +
+                 _data.capacity() * sizeof(AqlValue) +
+                 _valueCount.size() * (sizeof(AqlValue) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+                 _docColls.capacity() * sizeof(TRI_document_collection_t const*);
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief shrink the block to the specified number of rows
 ////////////////////////////////////////////////////////////////////////////////
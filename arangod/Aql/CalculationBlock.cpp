@@ -221,7 +221,14 @@ void CalculationBlock::doEvaluation (AqlItemBlock* result) {
     // do not merge the following function call with the same function call above!
     // the V8 expression execution must happen in the scope that contains
     // the V8 handle scope and the scope guard
-    executeExpression(result);
+    if (_profiling) {
+      double const start = TRI_microtime();
+      executeExpression(result);
+      addExpressionRuntime(TRI_microtime() - start);
+    }
+    else {
+      executeExpression(result);
+    }
   }
 }
 
@@ -259,10 +259,10 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
+    auto res = _dependencies.at(_atDep)->getSomeProfiled(atLeast, atMost);
     while (res == nullptr && _atDep < _dependencies.size() - 1) {
       _atDep++;
-      res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
+      res = _dependencies.at(_atDep)->getSomeProfiled(atLeast, atMost);
     }
     if (res == nullptr) {
       _done = true;
@@ -381,10 +381,10 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+    auto skipped = _dependencies.at(_atDep)->skipSomeProfiled(atLeast, atMost);
     while (skipped == 0 && _atDep < _dependencies.size() - 1) {
       _atDep++;
-      skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+      skipped = _dependencies.at(_atDep)->skipSomeProfiled(atLeast, atMost);
     }
     if (skipped == 0) {
       _done = true;
@@ -464,7 +464,7 @@ bool GatherBlock::getBlock (size_t i, size_t atLeast, size_t atMost) {
   ENTER_BLOCK
   TRI_ASSERT(i < _dependencies.size());
   TRI_ASSERT(! _isSimple);
-  AqlItemBlock* docs = _dependencies.at(i)->getSome(atLeast, atMost);
+  AqlItemBlock* docs = _dependencies.at(i)->getSomeProfiled(atLeast, atMost);
   if (docs != nullptr) {
     try {
       _gatherBlockBuffer.at(i).emplace_back(docs);
@@ -1530,6 +1530,15 @@ int RemoteBlock::shutdown (int errorCode) {
 
   // read "warnings" attribute if present and add it our query
   if (responseBodyJson.isObject()) {
+    if (_profiling) {
+      try {
+        _engine->addRemoteNodeStats(responseBodyJson.get("nodes"));
+      }
+      catch (...) {
+        // node statistics are informational only
+      }
+    }
+
     auto warnings = responseBodyJson.get("warnings");
     if (warnings.isArray()) {
       auto query = _engine->getQuery();
@@ -117,6 +117,58 @@ void LinearCollectionScanner::reset () {
   position.reset();
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct SnapshotCollectionScanner
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+SnapshotCollectionScanner::SnapshotCollectionScanner (triagens::arango::AqlTransaction* trx,
+                                                      TRI_transaction_collection_t* trxCollection) 
+  : CollectionScanner(trx, trxCollection),
+    next(0) {
+
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+  TRI_ASSERT(document != nullptr);
+
+  // the transaction still holds the collection lock, so no other lock is
+  // acquired here and the copy reflects the state of the collection at the
+  // time the transaction started
+  documents.reserve(static_cast<size_t>(document->size()));
+
+  auto primaryIndex = document->primaryIndex();
+
+  while (true) {
+    TRI_doc_mptr_t const* mptr = primaryIndex->lookupSequential(position, totalCount);
+
+    if (mptr == nullptr) {
+      break;
+    }
+
+    documents.emplace_back(*mptr);
+  }
+}
+
+int SnapshotCollectionScanner::scan (std::vector<TRI_doc_mptr_copy_t>& docs,
+                                     size_t batchSize) {
+  size_t const n = (std::min)(batchSize, documents.size() - next);
+
+  docs.insert(docs.end(), documents.begin() + next, documents.begin() + next + n);
+  next += n;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+void SnapshotCollectionScanner::reset () {
+  next = 0;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -109,6 +109,35 @@ namespace triagens {
       void reset () override;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct SnapshotCollectionScanner
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scanner that copies the master pointers of all documents when it is
+/// created and then serves them from the copy. the collection must be locked
+/// by the transaction while the scanner is created, but not afterwards, as the
+/// transaction's ditch keeps the documents of the copy alive
+////////////////////////////////////////////////////////////////////////////////
+
+    struct SnapshotCollectionScanner final : public CollectionScanner {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+  
+      SnapshotCollectionScanner (triagens::arango::AqlTransaction*,
+                                 TRI_transaction_collection_t*); 
+
+      int scan (std::vector<TRI_doc_mptr_copy_t>&,
+                size_t) override;
+      
+      void reset () override;
+
+      std::vector<TRI_doc_mptr_copy_t> documents;
+      size_t next;
+    };
+
   }
 }
 
@@ -29,6 +29,7 @@
 #include "Aql/AqlItemBlock.h"
 #include "Aql/CollectionScanner.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
 #include "Basics/Exceptions.h"
 #include "VocBase/vocbase.h"
 
@@ -60,6 +61,13 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
     // random scan
     _scanner = new RandomCollectionScanner(_trx, trxCollection);
   }
+  else if (engine->getQuery()->snapshotReads()) {
+    // copy the documents while the collection is still locked, so the
+    // query can release the lock before it is executed
+    auto scanner = new SnapshotCollectionScanner(_trx, trxCollection);
+    engine->getQuery()->addSnapshotDocuments(scanner->documents.size());
+    _scanner = scanner;
+  }
   else {
     // default: linear scan
     _scanner = new LinearCollectionScanner(_trx, trxCollection);
@@ -58,7 +58,9 @@ ExecutionBlock::ExecutionBlock (ExecutionEngine* engine,
   : _engine(engine),
     _trx(engine->getQuery()->trx()), 
     _exeNode(ep), 
-    _done(false) {
+    _done(false),
+    _profiling(engine->getQuery()->profiling()),
+    _nodeStats() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -323,7 +325,7 @@ void ExecutionBlock::inheritRegisters (AqlItemBlock const* src,
 bool ExecutionBlock::getBlock (size_t atLeast, size_t atMost) {
   throwIfKilled(); // check if we were aborted
 
-  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->getSome(atLeast, atMost));
+  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->getSomeProfiled(atLeast, atMost));
 
   if (docs == nullptr) {
     return false;
@@ -388,10 +390,10 @@ size_t ExecutionBlock::skipSome (size_t atLeast, size_t atMost) {
 // skip exactly <number> outputs, returns <true> if _done after
 // skipping, and <false> otherwise . . .
 bool ExecutionBlock::skip (size_t number) {
-  size_t skipped = skipSome(number, number);
+  size_t skipped = skipSomeProfiled(number, number);
   size_t nr = skipped;
   while (nr != 0 && skipped < number) {
-    nr = skipSome(number - skipped, number - skipped);
+    nr = skipSomeProfiled(number - skipped, number - skipped);
     skipped += nr;
   }
   if (nr == 0) {
@@ -423,6 +425,46 @@ int64_t ExecutionBlock::remaining () {
   return sum + _dependencies[0]->remaining();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, recording the node statistics
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* ExecutionBlock::getSomeWithStatistics (size_t atLeast, 
+                                                     size_t atMost) {
+  double const start = TRI_microtime();
+  AqlItemBlock* result = getSome(atLeast, atMost);
+
+  _nodeStats.runtime += TRI_microtime() - start;
+  ++_nodeStats.calls;
+
+  if (result != nullptr) {
+    _nodeStats.rowsOut += static_cast<int64_t>(result->size());
+
+    size_t const memory = result->memoryUsage();
+    if (memory > _nodeStats.peakMemory) {
+      _nodeStats.peakMemory = memory;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, recording the node statistics
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ExecutionBlock::skipSomeWithStatistics (size_t atLeast,
+                                               size_t atMost) {
+  double const start = TRI_microtime();
+  size_t skipped = skipSome(atLeast, atMost);
+
+  _nodeStats.runtime += TRI_microtime() - start;
+  ++_nodeStats.calls;
+  _nodeStats.rowsOut += static_cast<int64_t>(skipped);
+
+  return skipped;
+}
+
 int ExecutionBlock::getOrSkipSome (size_t atLeast,
                                    size_t atMost,
                                    bool skipping,
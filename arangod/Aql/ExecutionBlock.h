@@ -30,6 +30,7 @@
 
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionNode.h"
+#include "Aql/ExecutionStats.h"
 
 namespace triagens {
   namespace arango {
@@ -253,6 +254,38 @@ namespace triagens {
 
         virtual size_t skipSome (size_t atLeast, size_t atMost);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, recording the node statistics if the query is profiled.
+/// this must be used instead of getSome when pulling from another block
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSomeProfiled (size_t atLeast, size_t atMost) {
+          if (! _profiling) {
+            return getSome(atLeast, atMost);
+          }
+          return getSomeWithStatistics(atLeast, atMost);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, recording the node statistics if the query is profiled
+/// this must be used instead of skipSome when skipping in another block
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSomeProfiled (size_t atLeast, size_t atMost) {
+          if (! _profiling) {
+            return skipSome(atLeast, atMost);
+          }
+          return skipSomeWithStatistics(atLeast, atMost);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the statistics of the block, only filled if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNodeStats const& nodeStats () const {
+          return _nodeStats;
+        }
+
         // skip exactly <number> outputs, returns <true> if _done after
         // skipping, and <false> otherwise . . .
         bool skip (size_t number);
@@ -271,6 +304,14 @@ namespace triagens {
 
       protected:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds time spent executing V8 expressions to the node statistics
+////////////////////////////////////////////////////////////////////////////////
+
+        void addExpressionRuntime (double runtime) {
+          _nodeStats.expressionRuntime += runtime;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generic method to get or skip some
 ////////////////////////////////////////////////////////////////////////////////
@@ -329,6 +370,36 @@ namespace triagens {
 
         bool _done;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _profiling;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics of the block, only filled if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNodeStats _nodeStats;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, recording the node statistics
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSomeWithStatistics (size_t atLeast, size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, recording the node statistics
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSomeWithStatistics (size_t atLeast, size_t atMost);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
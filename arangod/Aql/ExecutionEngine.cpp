@@ -38,6 +38,7 @@
 #include "Aql/ExecutionBlock.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/HashJoinBlock.h"
 #include "Aql/IndexRangeBlock.h"
 #include "Aql/ModificationBlock.h"
 #include "Aql/QueryRegistry.h"
@@ -67,6 +68,9 @@ static ExecutionBlock* CreateBlock (ExecutionEngine* engine,
     case ExecutionNode::INDEX_RANGE: {
       return new IndexRangeBlock(engine, static_cast<IndexRangeNode const*>(en));
     }
+    case ExecutionNode::HASH_JOIN: {
+      return new HashJoinBlock(engine, static_cast<HashJoinNode const*>(en));
+    }
     case ExecutionNode::ENUMERATE_COLLECTION: {
       return new EnumerateCollectionBlock(engine,
                                           static_cast<EnumerateCollectionNode const*>(en));
@@ -546,6 +550,10 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     optimizerOptionsRules.add(Json("-all"));
     optimizerOptions.set("rules", optimizerOptionsRules);
     options.set("optimizer", optimizerOptions);
+    if (query->profiling()) {
+      // let the remote engines collect node statistics, too
+      options.set("profile", Json(true));
+    }
     result.set("options", options);
     std::unique_ptr<std::string> body(new std::string(triagens::basics::JsonHelper::toString(result.json())));
     
@@ -1124,6 +1132,82 @@ void ExecutionEngine::addBlock (ExecutionBlock* block) {
   _blocks.emplace_back(block);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the statistics of all nodes of a profiled query as JSON
+////////////////////////////////////////////////////////////////////////////////
+
+Json ExecutionEngine::nodeStatsToJson () const {
+  std::map<size_t, std::pair<std::string, ExecutionNodeStats>> nodes(_remoteNodeStats);
+
+  for (auto const& block : _blocks) {
+    auto const node = block->getPlanNode();
+    ExecutionNodeStats stats(block->nodeStats());
+
+    for (auto const& dependency : block->getDependencies()) {
+      stats.rowsIn += dependency->nodeStats().rowsOut;
+    }
+
+    auto it = nodes.find(node->id());
+
+    if (it == nodes.end()) {
+      nodes.emplace(node->id(), std::make_pair(node->getTypeString(), stats));
+    }
+    else {
+      (*it).second.second.add(stats);
+    }
+  }
+
+  Json result(Json::Array, nodes.size());
+
+  for (auto const& it : nodes) {
+    Json node = it.second.second.toJson();
+    node.set("id", Json(static_cast<double>(it.first)));
+    node.set("type", Json(it.second.first));
+    result.add(node);
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge the node statistics reported by a remote engine
+////////////////////////////////////////////////////////////////////////////////
+
+void ExecutionEngine::addRemoteNodeStats (Json const& nodes) {
+  if (! nodes.isArray()) {
+    return;
+  }
+
+  std::unordered_set<size_t> local;
+  for (auto const& block : _blocks) {
+    local.emplace(block->getPlanNode()->id());
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    auto node = nodes.at(i);
+
+    if (! node.isObject()) {
+      continue;
+    }
+
+    auto id = triagens::basics::JsonHelper::getNumericValue<size_t>(node.json(), "id", 0);
+
+    if (local.find(id) != local.end()) {
+      continue;
+    }
+
+    ExecutionNodeStats stats(node);
+    auto it = _remoteNodeStats.find(id);
+
+    if (it == _remoteNodeStats.end()) {
+      _remoteNodeStats.emplace(id, std::make_pair(triagens::basics::JsonHelper::getStringValue(node.json(), "type", ""), stats));
+    }
+    else {
+      (*it).second.second.add(stats);
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
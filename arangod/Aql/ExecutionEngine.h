@@ -149,7 +149,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         AqlItemBlock* getSome (size_t atLeast, size_t atMost) {
-          return _root->getSome(atLeast, atMost);
+          return _root->getSomeProfiled(atLeast, atMost);
         }
         
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,7 +157,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t skipSome (size_t atLeast, size_t atMost) {
-          return _root->skipSome(atLeast, atMost);
+          return _root->skipSomeProfiled(atLeast, atMost);
         }
         
 ////////////////////////////////////////////////////////////////////////////////
@@ -165,7 +165,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         AqlItemBlock* getOne () {
-          return _root->getSome(1, 1);
+          return _root->getSomeProfiled(1, 1);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +206,21 @@ namespace triagens {
 
         void addBlock (ExecutionBlock*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the statistics of all nodes of a profiled query as JSON,
+/// including the statistics reported by remote engines
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json nodeStatsToJson () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge the node statistics reported by a remote engine. statistics
+/// of nodes that are executed by this engine are ignored, so they are not
+/// counted twice when engines report each other's nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        void addRemoteNodeStats (triagens::basics::Json const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set the register the final result of the query is stored in
 ////////////////////////////////////////////////////////////////////////////////
@@ -293,6 +308,12 @@ namespace triagens {
 
         bool                         _wasShutdown;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics of nodes executed by remote engines, by node id
+////////////////////////////////////////////////////////////////////////////////
+
+        std::map<size_t, std::pair<std::string, ExecutionNodeStats>> _remoteNodeStats;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _previouslyLockedShards, this is read off at instanciating
 /// time from a thread local variable
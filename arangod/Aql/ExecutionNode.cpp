@@ -75,7 +75,8 @@ std::unordered_map<int, std::string const> const ExecutionNode::TypeNames{
   { static_cast<int>(DISTRIBUTE),                   "DistributeNode" },
   { static_cast<int>(GATHER),                       "GatherNode" },
   { static_cast<int>(NORESULTS),                    "NoResultsNode" },
-  { static_cast<int>(UPSERT),                       "UpsertNode" }
+  { static_cast<int>(UPSERT),                       "UpsertNode" },
+  { static_cast<int>(HASH_JOIN),                    "HashJoinNode" }
 };
           
 // -----------------------------------------------------------------------------
@@ -228,6 +229,8 @@ ExecutionNode* ExecutionNode::fromJsonFactory (ExecutionPlan* plan,
       return new NoResultsNode(plan, oneNode);
     case INDEX_RANGE:
       return new IndexRangeNode(plan, oneNode);
+    case HASH_JOIN:
+      return new HashJoinNode(plan, oneNode);
     case REMOTE:
       return new RemoteNode(plan, oneNode);
     case GATHER: {
@@ -942,6 +945,21 @@ void ExecutionNode::RegisterPlan::after (ExecutionNode *en) {
       break;
     }
 
+    case ExecutionNode::HASH_JOIN: {
+      depth++;
+      nrRegsHere.emplace_back(1);
+      // create a copy of the last value here
+      // this is requried because back returns a reference and emplace/push_back may invalidate all references
+      RegisterId registerId = 1 + nrRegs.back();
+      nrRegs.emplace_back(registerId);
+
+      auto ep = static_cast<HashJoinNode const*>(en);
+      TRI_ASSERT(ep != nullptr);
+      varInfo.emplace(ep->outVariable()->id, VarInfo(depth, totalNrRegs));
+      totalNrRegs++;
+      break;
+    }
+
     case ExecutionNode::ENUMERATE_LIST: {
       depth++;
       nrRegsHere.emplace_back(1);
@@ -1831,6 +1849,169 @@ bool IndexRangeNode::estimateItemsWithIndexSelectivity (size_t incoming,
   return true;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                           methods of HashJoinNode
+// -----------------------------------------------------------------------------
+
+HashJoinNode::HashJoinNode (ExecutionPlan* plan,
+                            triagens::basics::Json const& base)
+  : ExecutionNode(plan, base),
+    _vocbase(plan->getAst()->query()->vocbase()),
+    _collection(plan->getAst()->query()->collections()->get(JsonHelper::checkAndGetStringValue(base.json(), "collection"))),
+    _inVariable(varFromJson(plan->getAst(), base, "inVariable")),
+    _outVariable(varFromJson(plan->getAst(), base, "outVariable")),
+    _attribute() {
+
+  TRI_json_t const* attribute = JsonHelper::checkAndGetArrayValue(base.json(), "attribute");
+  size_t const n = TRI_LengthArrayJson(attribute);
+
+  for (size_t i = 0; i < n; ++i) {
+    auto part = TRI_LookupArrayJson(attribute, i);
+
+    if (! JsonHelper::isString(part)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "invalid join attribute");
+    }
+    _attribute.emplace_back(JsonHelper::getStringValue(part, ""));
+  }
+
+  if (_attribute.empty()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "invalid join attribute");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toJson, for HashJoinNode
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinNode::toJsonHelper (triagens::basics::Json& nodes,
+                                 TRI_memory_zone_t* zone,
+                                 bool verbose) const {
+  triagens::basics::Json json(ExecutionNode::toJsonHelperGeneric(nodes, zone, verbose));  // call base class method
+
+  if (json.isEmpty()) {
+    return;
+  }
+
+  triagens::basics::Json attribute(triagens::basics::Json::Array, _attribute.size());
+
+  for (auto const& it : _attribute) {
+    attribute.add(triagens::basics::Json(it));
+  }
+
+  json("database", triagens::basics::Json(_vocbase->_name))
+      ("collection", triagens::basics::Json(_collection->getName()))
+      ("inVariable", _inVariable->toJson())
+      ("outVariable", _outVariable->toJson())
+      ("attribute", attribute);
+
+  // And add it:
+  nodes(json);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+ExecutionNode* HashJoinNode::clone (ExecutionPlan* plan,
+                                    bool withDependencies,
+                                    bool withProperties) const {
+  auto inVariable = _inVariable;
+  auto outVariable = _outVariable;
+
+  if (withProperties) {
+    inVariable = plan->getAst()->variables()->createVariable(inVariable);
+    outVariable = plan->getAst()->variables()->createVariable(outVariable);
+  }
+
+  auto c = new HashJoinNode(plan, _id, _vocbase, _collection, inVariable, outVariable, _attribute);
+
+  cloneHelper(c, plan, withDependencies, withProperties);
+
+  return static_cast<ExecutionNode*>(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cost of a hash join node is the cost of building the hash
+/// table once plus one lookup per incoming item
+////////////////////////////////////////////////////////////////////////////////
+        
+double HashJoinNode::estimateCost (size_t& nrItems) const { 
+  // building an entry in the hash table is more expensive than a plain
+  // iteration, so the optimizer prefers to build the table over the
+  // smaller of the two joined collections
+  static double const BuildFactor = 1.5;
+
+  size_t incoming;
+  double depCost = _dependencies.at(0)->getCost(incoming);
+  size_t count = _collection->count();
+
+  nrItems = static_cast<size_t>(incoming * estimateMatchesPerItem(incoming, count));
+
+  // the hash table is built only once, regardless of the number of
+  // incoming items
+  return depCost + count * BuildFactor + incoming + nrItems;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimate the number of documents of the inner collection that
+/// match one incoming item
+///
+/// an index on the join attribute tells how many documents share a value.
+/// without one, we assume that the incoming values spread evenly over the
+/// documents of the inner collection, but find at least one match each
+////////////////////////////////////////////////////////////////////////////////
+
+double HashJoinNode::estimateMatchesPerItem (size_t incoming,
+                                             size_t count) const {
+  if (count == 0) {
+    return 0.0;
+  }
+
+  if (_attribute.size() == 1 &&
+      (_attribute[0] == TRI_VOC_ATTRIBUTE_KEY ||
+       _attribute[0] == TRI_VOC_ATTRIBUTE_ID)) {
+    // primary index
+    return 1.0;
+  }
+
+  for (auto const& idx : _collection->getIndexes()) {
+    if ((idx->type != triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX &&
+         idx->type != triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX) ||
+        idx->fields.size() != 1 ||
+        idx->fields[0].size() != _attribute.size()) {
+      continue;
+    }
+
+    bool sameAttribute = true;
+
+    for (size_t i = 0; i < _attribute.size(); ++i) {
+      if (idx->fields[0][i].name != _attribute[i] ||
+          idx->fields[0][i].shouldExpand) {
+        sameAttribute = false;
+        break;
+      }
+    }
+
+    if (! sameAttribute) {
+      continue;
+    }
+
+    if (idx->unique) {
+      return 1.0;
+    }
+
+    if (idx->hasSelectivityEstimate()) {
+      double estimate = idx->selectivityEstimate();
+
+      if (estimate > 0.0) {
+        return 1.0 / estimate;
+      }
+    }
+  }
+
+  return (std::max)(1.0, static_cast<double>(count) / static_cast<double>((std::max)(incoming, static_cast<size_t>(1))));
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              methods of LimitNode
 // -----------------------------------------------------------------------------
@@ -2515,6 +2696,7 @@ struct UserVarFinder final : public WalkerWorker<ExecutionNode> {
     }
     else if (en->getType() == ExecutionNode::ENUMERATE_COLLECTION ||
              en->getType() == ExecutionNode::INDEX_RANGE ||
+             en->getType() == ExecutionNode::HASH_JOIN ||
              en->getType() == ExecutionNode::ENUMERATE_LIST ||
              en->getType() == ExecutionNode::AGGREGATE) {
       depth += 1;
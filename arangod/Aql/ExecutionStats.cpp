@@ -96,6 +96,48 @@ ExecutionStats::ExecutionStats (triagens::basics::Json const& jsonStats) {
   fullCount      = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "fullCount", -1);
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                          struct ExecutionNodeStats
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief convert the statistics to JSON
+////////////////////////////////////////////////////////////////////////////////
+
+Json ExecutionNodeStats::toJson () const {
+  Json json(Json::Object, 6);
+  json.set("calls",             Json(static_cast<double>(calls)));
+  json.set("rowsIn",            Json(static_cast<double>(rowsIn)));
+  json.set("rowsOut",           Json(static_cast<double>(rowsOut)));
+  json.set("runtime",           Json(runtime));
+  json.set("expressionRuntime", Json(expressionRuntime));
+  json.set("peakMemory",        Json(static_cast<double>(peakMemory)));
+
+  return json;
+}
+
+ExecutionNodeStats::ExecutionNodeStats ()
+  : calls(0),
+    rowsIn(0),
+    rowsOut(0),
+    runtime(0.0),
+    expressionRuntime(0.0),
+    peakMemory(0) {
+}
+
+ExecutionNodeStats::ExecutionNodeStats (triagens::basics::Json const& jsonStats) {
+  if (! jsonStats.isObject()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "node stats is not an object");
+  }
+
+  calls             = JsonHelper::checkAndGetNumericValue<int64_t>(jsonStats.json(), "calls");
+  rowsIn            = JsonHelper::checkAndGetNumericValue<int64_t>(jsonStats.json(), "rowsIn");
+  rowsOut           = JsonHelper::checkAndGetNumericValue<int64_t>(jsonStats.json(), "rowsOut");
+  runtime           = JsonHelper::checkAndGetNumericValue<double>(jsonStats.json(), "runtime");
+  expressionRuntime = JsonHelper::checkAndGetNumericValue<double>(jsonStats.json(), "expressionRuntime");
+  peakMemory        = JsonHelper::checkAndGetNumericValue<size_t>(jsonStats.json(), "peakMemory");
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -123,6 +123,87 @@ namespace triagens {
 
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                          struct ExecutionNodeStats
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics of a single execution node, only collected when the
+/// query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ExecutionNodeStats {
+
+      ExecutionNodeStats ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief instantiate the statistics from JSON
+////////////////////////////////////////////////////////////////////////////////
+
+      ExecutionNodeStats (triagens::basics::Json const& jsonStats);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief convert the statistics to JSON
+////////////////////////////////////////////////////////////////////////////////
+
+      triagens::basics::Json toJson () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sumarize two sets of ExecutionNodeStats, used when the same node
+/// was executed for several shards
+////////////////////////////////////////////////////////////////////////////////
+
+      void add (ExecutionNodeStats const& summand) {
+        calls             += summand.calls;
+        rowsIn            += summand.rowsIn;
+        rowsOut           += summand.rowsOut;
+        runtime           += summand.runtime;
+        expressionRuntime += summand.expressionRuntime;
+
+        if (summand.peakMemory > peakMemory) {
+          peakMemory = summand.peakMemory;
+        }
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of calls to getSome and skipSome
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t calls;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows produced by the node's dependencies
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t rowsIn;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows the node returned or skipped
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t rowsOut;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wall time spent in getSome and skipSome in seconds, including the
+/// time spent in the node's dependencies
+////////////////////////////////////////////////////////////////////////////////
+
+      double runtime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wall time spent executing V8 expressions in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+      double expressionRuntime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory of the largest AqlItemBlock returned by the node
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t peakMemory;
+
+    };
+
   }
 }
 
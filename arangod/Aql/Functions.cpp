@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Aql/Functions.h"
+#include "Aql/CollectionScanner.h"
 #include "Aql/Function.h"
 #include "Aql/Query.h"
 #include "Basics/Exceptions.h"
@@ -36,10 +37,17 @@
 #include "Basics/json-utilities.h"
 #include "Basics/ScopeGuard.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/StringUtils.h"
+#include "Basics/system-functions.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/Utf8Helper.h"
 #include "Rest/SslInterface.h"
 #include "V8Server/V8Traverser.h"
+#include "VocBase/ExampleMatcher.h"
+#include "VocBase/GraphCentrality.h"
+#include "VocBase/GraphSnapshot.h"
 #include "VocBase/KeyGenerator.h"
+#include "VocBase/server.h"
 #include "VocBase/VocShaper.h"
 
 using namespace triagens::aql;
@@ -1715,17 +1723,16 @@ static inline Json TRI_ExpandShapedJson (VocShaper* shaper,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Transforms VertexId to Json
+/// @brief returns a collection of the transaction. if the collection is not
+/// yet part of the transaction, it is added
 ////////////////////////////////////////////////////////////////////////////////
 
-static Json VertexIdToJson (triagens::arango::AqlTransaction* trx,
-                            CollectionNameResolver const* resolver,
-                            VertexId const& id) {
-  TRI_doc_mptr_copy_t mptr;
-  auto collection = trx->trxCollection(id.cid);
+static TRI_transaction_collection_t* TransactionCollection (triagens::arango::AqlTransaction* trx,
+                                                            TRI_voc_cid_t cid) {
+  auto collection = trx->trxCollection(cid);
   if (collection == nullptr) {
     int res = TRI_AddCollectionTransaction(trx->getInternals(), 
-                                           id.cid,
+                                           cid,
                                            TRI_TRANSACTION_READ,
                                            trx->nestingLevel(),
                                            true,
@@ -1734,11 +1741,23 @@ static Json VertexIdToJson (triagens::arango::AqlTransaction* trx,
       THROW_ARANGO_EXCEPTION(res);
     }
     TRI_EnsureCollectionsTransaction(trx->getInternals());
-    collection = trx->trxCollection(id.cid);
+    collection = trx->trxCollection(cid);
     if (collection == nullptr) {
       THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "collection is a nullptr");
     }
   }
+  return collection;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Transforms VertexId to Json
+////////////////////////////////////////////////////////////////////////////////
+
+static Json VertexIdToJson (triagens::arango::AqlTransaction* trx,
+                            CollectionNameResolver const* resolver,
+                            VertexId const& id) {
+  TRI_doc_mptr_copy_t mptr;
+  auto collection = TransactionCollection(trx, id.cid);
   int res = trx->readSingle(collection, &mptr, id.key); 
 
   if (res != TRI_ERROR_NO_ERROR) {
@@ -1963,6 +1982,638 @@ AqlValue Functions::Neighbors (triagens::aql::Query* query,
   return VertexIdsToAqlValue(trx, resolver, neighbors, includeData);
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                        graph measurement functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply a collection restriction to a list of collection names. this
+/// is the same as FILTER_RESTRICTION in the JavaScript implementation
+////////////////////////////////////////////////////////////////////////////////
+
+static void FilterRestriction (TRI_json_t const* list,
+                               TRI_json_t const* restriction,
+                               std::vector<std::string>& result) {
+  if (! TRI_IsArrayJson(list)) {
+    return;
+  }
+
+  size_t const n = TRI_LengthArrayJson(list);
+
+  if (TRI_IsStringJson(restriction)) {
+    std::string const name = triagens::basics::JsonHelper::getStringValue(restriction, "");
+
+    for (size_t i = 0; i < n; ++i) {
+      if (name == triagens::basics::JsonHelper::getStringValue(TRI_LookupArrayJson(list, i), "")) {
+        result.emplace_back(name);
+        break;
+      }
+    }
+    return;
+  }
+
+  if (TRI_IsArrayJson(restriction)) {
+    size_t const m = TRI_LengthArrayJson(restriction);
+
+    for (size_t j = 0; j < m; ++j) {
+      std::string const name = triagens::basics::JsonHelper::getStringValue(TRI_LookupArrayJson(restriction, j), "");
+
+      for (size_t i = 0; i < n; ++i) {
+        if (name == triagens::basics::JsonHelper::getStringValue(TRI_LookupArrayJson(list, i), "")) {
+          result.emplace_back(name);
+          break;
+        }
+      }
+    }
+    return;
+  }
+
+  // no restriction
+  for (size_t i = 0; i < n; ++i) {
+    TRI_json_t const* value = TRI_LookupArrayJson(list, i);
+
+    if (TRI_IsStringJson(value)) {
+      result.emplace_back(triagens::basics::JsonHelper::getStringValue(value, ""));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read all documents of a collection in batches
+////////////////////////////////////////////////////////////////////////////////
+
+static void ScanCollection (triagens::aql::Query* query,
+                            triagens::arango::AqlTransaction* trx,
+                            TRI_transaction_collection_t* trxCollection,
+                            std::function<void(std::vector<TRI_doc_mptr_copy_t> const&)> const& callback) {
+  size_t const batchSize = 1000;
+  LinearCollectionScanner scanner(trx, trxCollection);
+  std::vector<TRI_doc_mptr_copy_t> documents;
+
+  while (true) {
+    if (query->killed()) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_QUERY_KILLED);
+    }
+
+    documents.clear();
+    int res = scanner.scan(documents, batchSize);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    if (documents.empty()) {
+      break;
+    }
+
+    callback(documents);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief load the graph used by the graph measurement functions into a
+/// snapshot. the function parameters are the graph name and an optional
+/// options object, with the same meaning as in the JavaScript implementation.
+/// further parameters up to maxParameters are ignored. sources receives the
+/// start vertices of the measurement, isTarget flags the vertices that count
+/// as end vertices
+////////////////////////////////////////////////////////////////////////////////
+
+static void LoadGraphSnapshot (triagens::aql::Query* query,
+                               triagens::arango::AqlTransaction* trx,
+                               FunctionParameters const& parameters,
+                               char const* functionName,
+                               size_t maxParameters,
+                               triagens::arango::GraphSnapshot& snapshot,
+                               TRI_edge_direction_e& direction,
+                               std::vector<triagens::arango::GraphSnapshot::VertexIndex>& sources,
+                               std::vector<bool>& isTarget) {
+  size_t const n = parameters.size();
+
+  if (n < 1 || n > maxParameters) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, functionName, (int) 1, (int) maxParameters);
+  }
+
+  Json graphName = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (! graphName.isString()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, functionName);
+  }
+
+  Json options = ExtractFunctionParameter(trx, parameters, 1, false);
+
+  if (! options.isObject() && ! options.isNull()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, functionName);
+  }
+
+  TRI_json_t const* opts = options.isObject() ? options.json() : nullptr;
+
+  std::string const dir = triagens::basics::JsonHelper::getStringValue(opts, "direction", "any");
+
+  if (dir == "outbound") {
+    direction = TRI_EDGE_OUT;
+  }
+  else if (dir == "inbound") {
+    direction = TRI_EDGE_IN;
+  }
+  else if (dir == "any") {
+    direction = TRI_EDGE_ANY;
+  }
+  else {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, functionName);
+  }
+
+  // the searches always compute exact shortest paths, so both algorithms the
+  // JavaScript implementation offers lead to the same result. other values
+  // are rejected
+  TRI_json_t const* algorithm = opts == nullptr ? nullptr : TRI_LookupObjectJson(opts, "algorithm");
+
+  if (algorithm != nullptr && ! TRI_IsNullJson(algorithm)) {
+    if (! TRI_IsStringJson(algorithm)) {
+      THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, functionName);
+    }
+
+    std::string const name = triagens::basics::StringUtils::tolower(
+      triagens::basics::JsonHelper::getStringValue(algorithm, "")
+    );
+
+    if (! name.empty() && name != "floyd-warshall" && name != "dijkstra") {
+      THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, functionName);
+    }
+  }
+
+  auto resolver = trx->resolver();
+
+  // read the graph definition
+  TRI_voc_cid_t const graphsCid = resolver->getCollectionId("_graphs");
+
+  if (graphsCid == 0) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_GRAPH_INVALID_GRAPH);
+  }
+
+  auto graphsCollection = TransactionCollection(trx, graphsCid);
+  std::string const name = triagens::basics::JsonHelper::getStringValue(graphName.json(), "");
+  TRI_doc_mptr_copy_t mptr;
+
+  int res = trx->readSingle(graphsCollection, &mptr, name);
+
+  if (res == TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_GRAPH_INVALID_GRAPH);
+  }
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+
+  Json graph = TRI_ExpandShapedJson(
+    graphsCollection->_collection->_collection->getShaper(),
+    resolver,
+    graphsCid,
+    &mptr
+  );
+
+  TRI_json_t const* edgeRestriction  = opts == nullptr ? nullptr : TRI_LookupObjectJson(opts, "edgeCollectionRestriction");
+  TRI_json_t const* startRestriction = opts == nullptr ? nullptr : TRI_LookupObjectJson(opts, "startVertexCollectionRestriction");
+  TRI_json_t const* endRestriction   = opts == nullptr ? nullptr : TRI_LookupObjectJson(opts, "endVertexCollectionRestriction");
+
+  std::vector<std::string> edgeCollections;
+  std::vector<std::string> vertexCollections;
+  std::vector<std::string> fromCollections;
+  std::vector<std::string> toCollections;
+
+  TRI_json_t const* definitions = TRI_LookupObjectJson(graph.json(), "edgeDefinitions");
+  size_t const numDefinitions = TRI_IsArrayJson(definitions) ? TRI_LengthArrayJson(definitions) : 0;
+
+  for (size_t i = 0; i < numDefinitions; ++i) {
+    TRI_json_t const* definition = TRI_LookupArrayJson(definitions, i);
+
+    if (! TRI_IsObjectJson(definition)) {
+      continue;
+    }
+
+    TRI_json_t const* from = TRI_LookupObjectJson(definition, "from");
+    TRI_json_t const* to = TRI_LookupObjectJson(definition, "to");
+
+    Json collection(Json::Array, 1);
+    collection.add(Json(triagens::basics::JsonHelper::getStringValue(definition, "collection", "")));
+    FilterRestriction(collection.json(), edgeRestriction, edgeCollections);
+
+    FilterRestriction(from, nullptr, vertexCollections);
+    FilterRestriction(to, nullptr, vertexCollections);
+
+    if (direction == TRI_EDGE_OUT) {
+      FilterRestriction(from, startRestriction, fromCollections);
+      FilterRestriction(to, endRestriction, toCollections);
+    }
+    else if (direction == TRI_EDGE_IN) {
+      FilterRestriction(to, endRestriction, fromCollections);
+      FilterRestriction(from, startRestriction, toCollections);
+    }
+    else {
+      FilterRestriction(from, startRestriction, fromCollections);
+      FilterRestriction(to, startRestriction, fromCollections);
+      FilterRestriction(from, endRestriction, toCollections);
+      FilterRestriction(to, endRestriction, toCollections);
+    }
+  }
+
+  TRI_json_t const* orphans = TRI_LookupObjectJson(graph.json(), "orphanCollections");
+  FilterRestriction(orphans, nullptr, vertexCollections);
+
+  if (triagens::basics::JsonHelper::getBooleanValue(opts, "includeOrphans", false)) {
+    FilterRestriction(orphans, TRI_LookupObjectJson(opts, "orphanCollectionRestriction"), fromCollections);
+  }
+
+  // load the vertices
+  std::unordered_set<TRI_voc_cid_t> seen;
+
+  for (auto const& it : vertexCollections) {
+    TRI_voc_cid_t const cid = resolver->getCollectionId(it);
+
+    if (cid == 0) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND, it);
+    }
+
+    if (! seen.emplace(cid).second) {
+      continue;
+    }
+
+    ScanCollection(query, trx, TransactionCollection(trx, cid), [&] (std::vector<TRI_doc_mptr_copy_t> const& documents) -> void {
+      snapshot.addVertices(cid, documents);
+    });
+  }
+
+  // load the edges
+  std::string const weightAttribute = triagens::basics::JsonHelper::getStringValue(opts, "weight", "");
+  double const defaultWeight = triagens::basics::JsonHelper::getNumericValue<double>(opts, "defaultWeight", HUGE_VAL);
+  TRI_json_t const* edgeExamples = opts == nullptr ? nullptr : TRI_LookupObjectJson(opts, "edgeExamples");
+
+  if (edgeExamples != nullptr && ! TRI_IsObjectJson(edgeExamples) && ! TRI_IsArrayJson(edgeExamples)) {
+    edgeExamples = nullptr;
+  }
+
+  seen.clear();
+
+  for (auto const& it : edgeCollections) {
+    TRI_voc_cid_t const cid = resolver->getCollectionId(it);
+
+    if (cid == 0) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND, it);
+    }
+
+    if (! seen.emplace(cid).second) {
+      continue;
+    }
+
+    auto trxCollection = TransactionCollection(trx, cid);
+    VocShaper* shaper = trxCollection->_collection->_collection->getShaper();
+
+    std::unique_ptr<triagens::arango::ExampleMatcher> matcher;
+
+    if (edgeExamples != nullptr) {
+      try {
+        matcher.reset(new triagens::arango::ExampleMatcher(edgeExamples, shaper, resolver));
+      }
+      catch (triagens::basics::Exception const& ex) {
+        if (ex.code() != TRI_RESULT_ELEMENT_NOT_FOUND) {
+          throw;
+        }
+        // the examples use attributes that no edge in the collection has
+        continue;
+      }
+    }
+
+    triagens::arango::GraphSnapshot::EdgeFilter filter;
+
+    if (matcher != nullptr) {
+      auto m = matcher.get();
+      filter = [m] (TRI_voc_cid_t cid, TRI_doc_mptr_t const* edge) -> bool {
+        return m->matches(cid, edge);
+      };
+    }
+
+    triagens::arango::GraphSnapshot::EdgeWeighter weighter;
+
+    if (! weightAttribute.empty()) {
+      TRI_shape_pid_t const pid = shaper->lookupAttributePathByName(weightAttribute.c_str());
+
+      weighter = [shaper, pid, defaultWeight] (TRI_doc_mptr_t const* edge) -> double {
+        if (pid == 0) {
+          return defaultWeight;
+        }
+
+        TRI_shape_sid_t sid;
+        TRI_EXTRACT_SHAPE_IDENTIFIER_MARKER(sid, edge->getDataPtr());
+        TRI_shape_access_t const* accessor = shaper->findAccessor(sid, pid);
+
+        if (accessor == nullptr) {
+          return defaultWeight;
+        }
+
+        TRI_shaped_json_t shapedJson;
+        TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, edge->getDataPtr());
+        TRI_shaped_json_t resultJson;
+
+        if (! TRI_ExecuteShapeAccessor(accessor, &shapedJson, &resultJson) ||
+            resultJson._sid != TRI_SHAPE_NUMBER) {
+          return defaultWeight;
+        }
+
+        return *reinterpret_cast<TRI_shape_number_t const*>(resultJson._data.data);
+      };
+    }
+
+    if (query->killed()) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_QUERY_KILLED);
+    }
+
+    // the edges are read from the cached adjacency snapshot of the edge
+    // collection, which is only rebuilt when the collection was modified.
+    // the collection is read-locked by the surrounding transaction
+    TRI_document_collection_t* document = trxCollection->_collection->_collection;
+
+    if (document->_info._type != TRI_COL_TYPE_EDGE) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID, it);
+    }
+
+    auto edges = document->edgeSnapshots()->get(document, true);
+    TRI_ASSERT(edges != nullptr);
+
+    snapshot.addEdges(cid, *edges, weighter, filter);
+  }
+
+  snapshot.finalize();
+
+  // determine start and end vertices
+  std::unordered_set<TRI_voc_cid_t> fromCids;
+  for (auto const& it : fromCollections) {
+    fromCids.emplace(resolver->getCollectionId(it));
+  }
+
+  std::unordered_set<TRI_voc_cid_t> toCids;
+  for (auto const& it : toCollections) {
+    toCids.emplace(resolver->getCollectionId(it));
+  }
+
+  size_t const numVertices = snapshot.numberOfVertices();
+  isTarget.resize(numVertices, false);
+
+  for (size_t i = 0; i < numVertices; ++i) {
+    auto const v = static_cast<triagens::arango::GraphSnapshot::VertexIndex>(i);
+    TRI_voc_cid_t const cid = snapshot.vertexCid(v);
+
+    if (fromCids.find(cid) != fromCids.end()) {
+      sources.emplace_back(v);
+    }
+    if (toCids.find(cid) != toCids.end()) {
+      isTarget[i] = true;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the _id value of a vertex of a graph snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string SnapshotVertexId (CollectionNameResolver const* resolver,
+                                     triagens::arango::GraphSnapshot const& snapshot,
+                                     triagens::arango::GraphSnapshot::VertexIndex vertex) {
+  std::string id(resolver->getCollectionName(snapshot.vertexCid(vertex)));
+  id.push_back('/');
+  id.append(snapshot.vertexKey(vertex));
+  return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the result object of a graph measurement function, mapping
+/// each vertex _id to its value. unless normalize is false, the values are
+/// normalized so that the maximum value is 1
+////////////////////////////////////////////////////////////////////////////////
+
+static AqlValue NormalizedVertexValues (CollectionNameResolver const* resolver,
+                                        triagens::arango::GraphSnapshot const& snapshot,
+                                        std::vector<triagens::arango::GraphSnapshot::VertexIndex> const& vertices,
+                                        std::vector<double>& values,
+                                        bool normalize = true) {
+  TRI_ASSERT(vertices.size() == values.size());
+
+  double max = 0.0;
+
+  if (normalize) {
+    for (auto const& it : values) {
+      if (it > max) {
+        max = it;
+      }
+    }
+  }
+
+  std::unique_ptr<Json> result(new Json(Json::Object, vertices.size()));
+
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    double const value = (max > 0.0 ? values[i] / max : values[i]);
+    result->set(SnapshotVertexId(resolver, snapshot, vertices[i]), Json(value));
+  }
+
+  AqlValue v(result.get());
+  result.release();
+
+  return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the centrality computation for a graph snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::GraphCentrality* CreateCentrality (triagens::aql::Query* query,
+                                                             triagens::arango::GraphSnapshot const& snapshot,
+                                                             TRI_edge_direction_e direction) {
+  auto pool = query->vocbase()->_server->_graphPool;
+
+  return new triagens::arango::GraphCentrality(
+    snapshot,
+    direction,
+    pool,
+    pool == nullptr ? 1 : pool->numThreads() + 1,
+    [query] () -> bool {
+      return query->killed();
+    }
+  );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_CLOSENESS
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphCloseness (triagens::aql::Query* query,
+                                    triagens::arango::AqlTransaction* trx,
+                                    FunctionParameters const& parameters) {
+  triagens::arango::GraphSnapshot snapshot;
+  TRI_edge_direction_e direction;
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> sources;
+  std::vector<bool> isTarget;
+
+  LoadGraphSnapshot(query, trx, parameters, "GRAPH_CLOSENESS", 2, snapshot, direction, sources, isTarget);
+
+  std::unique_ptr<triagens::arango::GraphCentrality> centrality(CreateCentrality(query, snapshot, direction));
+  auto distances = centrality->distances(sources, isTarget);
+
+  std::vector<double> values;
+  values.reserve(distances.size());
+
+  for (auto const& it : distances) {
+    values.emplace_back(it.sum > 0.0 ? 1.0 / it.sum : 0.0);
+  }
+
+  return NormalizedVertexValues(trx->resolver(), snapshot, sources, values);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_ECCENTRICITY
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphEccentricity (triagens::aql::Query* query,
+                                       triagens::arango::AqlTransaction* trx,
+                                       FunctionParameters const& parameters) {
+  triagens::arango::GraphSnapshot snapshot;
+  TRI_edge_direction_e direction;
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> sources;
+  std::vector<bool> isTarget;
+
+  LoadGraphSnapshot(query, trx, parameters, "GRAPH_ECCENTRICITY", 2, snapshot, direction, sources, isTarget);
+
+  std::unique_ptr<triagens::arango::GraphCentrality> centrality(CreateCentrality(query, snapshot, direction));
+  auto distances = centrality->distances(sources, isTarget);
+
+  std::vector<double> values;
+  values.reserve(distances.size());
+
+  for (auto const& it : distances) {
+    if (! it.reached) {
+      values.emplace_back(0.0);
+    }
+    else {
+      // the JavaScript implementation caps the inverse eccentricity at 1
+      values.emplace_back(it.max > 1.0 ? 1.0 / it.max : 1.0);
+    }
+  }
+
+  return NormalizedVertexValues(trx->resolver(), snapshot, sources, values);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute the betweenness of all vertices of the graph
+////////////////////////////////////////////////////////////////////////////////
+
+static AqlValue Betweenness (triagens::aql::Query* query,
+                             triagens::arango::AqlTransaction* trx,
+                             FunctionParameters const& parameters,
+                             char const* functionName,
+                             size_t maxParameters,
+                             bool normalize) {
+  triagens::arango::GraphSnapshot snapshot;
+  TRI_edge_direction_e direction;
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> sources;
+  std::vector<bool> isTarget;
+
+  LoadGraphSnapshot(query, trx, parameters, functionName, maxParameters, snapshot, direction, sources, isTarget);
+
+  std::unique_ptr<triagens::arango::GraphCentrality> centrality(CreateCentrality(query, snapshot, direction));
+  auto values = centrality->betweenness();
+
+  // betweenness is reported for all vertices of the graph
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> vertices;
+  vertices.reserve(values.size());
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    vertices.emplace_back(static_cast<triagens::arango::GraphSnapshot::VertexIndex>(i));
+  }
+
+  return NormalizedVertexValues(trx->resolver(), snapshot, vertices, values, normalize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_BETWEENNESS
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphBetweenness (triagens::aql::Query* query,
+                                      triagens::arango::AqlTransaction* trx,
+                                      FunctionParameters const& parameters) {
+  return Betweenness(query, trx, parameters, "GRAPH_BETWEENNESS", 2, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_ABSOLUTE_BETWEENNESS
+///
+/// like the JavaScript implementation, this takes the options as the second
+/// parameter and ignores a third parameter
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphAbsoluteBetweenness (triagens::aql::Query* query,
+                                              triagens::arango::AqlTransaction* trx,
+                                              FunctionParameters const& parameters) {
+  return Betweenness(query, trx, parameters, "GRAPH_ABSOLUTE_BETWEENNESS", 3, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_DIAMETER
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphDiameter (triagens::aql::Query* query,
+                                   triagens::arango::AqlTransaction* trx,
+                                   FunctionParameters const& parameters) {
+  triagens::arango::GraphSnapshot snapshot;
+  TRI_edge_direction_e direction;
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> sources;
+  std::vector<bool> isTarget;
+
+  LoadGraphSnapshot(query, trx, parameters, "GRAPH_DIAMETER", 2, snapshot, direction, sources, isTarget);
+
+  std::unique_ptr<triagens::arango::GraphCentrality> centrality(CreateCentrality(query, snapshot, direction));
+  auto distances = centrality->distances(sources, isTarget);
+
+  double max = 0.0;
+
+  for (auto const& it : distances) {
+    if (it.max > max) {
+      max = it.max;
+    }
+  }
+
+  return AqlValue(new Json(max));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function GRAPH_RADIUS
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::GraphRadius (triagens::aql::Query* query,
+                                 triagens::arango::AqlTransaction* trx,
+                                 FunctionParameters const& parameters) {
+  triagens::arango::GraphSnapshot snapshot;
+  TRI_edge_direction_e direction;
+  std::vector<triagens::arango::GraphSnapshot::VertexIndex> sources;
+  std::vector<bool> isTarget;
+
+  LoadGraphSnapshot(query, trx, parameters, "GRAPH_RADIUS", 2, snapshot, direction, sources, isTarget);
+
+  std::unique_ptr<triagens::arango::GraphCentrality> centrality(CreateCentrality(query, snapshot, direction));
+  auto distances = centrality->distances(sources, isTarget);
+
+  double min = HUGE_VAL;
+
+  for (auto const& it : distances) {
+    // vertices that cannot reach any other vertex are ignored
+    if (it.max > 0.0 && it.max < min) {
+      min = it.max;
+    }
+  }
+
+  if (min == HUGE_VAL) {
+    return AqlValue(new Json(Json::Null));
+  }
+
+  return AqlValue(new Json(min));
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -0,0 +1,396 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL HashJoinBlock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/HashJoinBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/CollectionScanner.h"
+#include "Aql/ExecutionEngine.h"
+#include "Basics/Exceptions.h"
+#include "Basics/json-utilities.h"
+#include "VocBase/vocbase.h"
+
+using namespace std;
+using namespace triagens::arango;
+using namespace triagens::aql;
+
+using Json = triagens::basics::Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class HashJoinBlock
+// -----------------------------------------------------------------------------
+
+HashJoinBlock::HashJoinBlock (ExecutionEngine* engine,
+                              HashJoinNode const* ep)
+  : ExecutionBlock(engine, ep),
+    _collection(ep->_collection),
+    _document(nullptr),
+    _inRegister(ExecutionNode::MaxRegisterId),
+    _table(1024, KeyHash(_trx), KeyEqual(_trx)),
+    _tableBuilt(false),
+    _matches(nullptr),
+    _posInMatches(0),
+    _attributeBuffer(TRI_UNKNOWN_MEM_ZONE),
+    _mustStoreResult(true) {
+
+  auto trxCollection = _trx->trxCollection(_collection->cid());
+  if (trxCollection != nullptr) {
+    _trx->orderDitch(trxCollection);
+  }
+
+  _document = _trx->documentCollection(_collection->cid());
+
+  auto it = ep->getRegisterPlan()->varInfo.find(ep->_inVariable->id);
+  TRI_ASSERT(it != ep->getRegisterPlan()->varInfo.end());
+  _inRegister = it->second.registerId;
+}
+
+HashJoinBlock::~HashJoinBlock () {
+  freeTable();
+}
+
+int HashJoinBlock::initialize () {
+  auto ep = static_cast<HashJoinNode const*>(_exeNode);
+  _mustStoreResult = ep->isVarUsedLater(ep->_outVariable);
+
+  return ExecutionBlock::initialize();
+}
+
+int HashJoinBlock::initializeCursor (AqlItemBlock* items,
+                                     size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // the hash table is kept, as the collection contents do not change
+  // during the query
+  _matches = nullptr;
+  _posInMatches = 0;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* HashJoinBlock::getSome (size_t, // atLeast,
+                                      size_t atMost) {
+  if (_done) {
+    return nullptr;
+  }
+
+  if (! _tableBuilt) {
+    buildTable();
+  }
+
+  if (! findMatches(atMost)) {
+    _done = true;
+    return nullptr;
+  }
+
+  // If we get here, we do have _buffer.front() and at least one match
+  AqlItemBlock* cur = _buffer.front();
+  size_t const curRegs = cur->getNrRegs();
+
+  size_t available = _matches->size() - _posInMatches;
+  size_t toSend = (std::min)(atMost, available);
+  RegisterId nrRegs = getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()];
+
+  std::unique_ptr<AqlItemBlock> res(requestBlock(toSend, nrRegs));
+  // automatically freed if we throw
+  TRI_ASSERT(curRegs <= res->getNrRegs());
+
+  // only copy 1st row of registers inherited from previous frame(s)
+  inheritRegisters(cur, res.get(), _pos);
+
+  // set our collection for our output register
+  res->setDocumentCollection(static_cast<triagens::aql::RegisterId>(curRegs), _document);
+
+  for (size_t j = 0; j < toSend; j++) {
+    if (j > 0) {
+      // re-use already copied aqlvalues
+      for (RegisterId i = 0; i < curRegs; i++) {
+        res->setValue(j, i, res->getValueReference(0, i));
+        // Note: if this throws, then all values will be deleted
+        // properly since the first one is.
+      }
+    }
+
+    if (_mustStoreResult) {
+      res->setShaped(j, 
+                     static_cast<triagens::aql::RegisterId>(curRegs),
+                     (*_matches)[_posInMatches]);
+    }
+
+    ++_posInMatches;
+  }
+
+  // Advance read position:
+  if (_posInMatches >= _matches->size()) {
+    nextRow();
+  }
+
+  // Clear out registers no longer needed later:
+  clearRegisters(res.get());
+
+  return res.release();
+}
+
+size_t HashJoinBlock::skipSome (size_t atLeast, size_t atMost) {
+  size_t skipped = 0;
+
+  if (_done) {
+    return skipped;
+  }
+
+  if (! _tableBuilt) {
+    buildTable();
+  }
+
+  while (skipped < atLeast) {
+    if (! findMatches(atMost - skipped)) {
+      _done = true;
+      return skipped;
+    }
+
+    size_t available = _matches->size() - _posInMatches;
+    size_t toSkip = (std::min)(atMost - skipped, available);
+
+    skipped += toSkip;
+    _posInMatches += toSkip;
+
+    if (_posInMatches >= _matches->size()) {
+      nextRow();
+    }
+  }
+
+  return skipped;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the hash table from the documents of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::buildTable () {
+  TRI_ASSERT(! _tableBuilt);
+
+  TRI_IF_FAILURE("HashJoinBlock::buildTable") {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+  }
+
+  LinearCollectionScanner scanner(_trx, _trx->trxCollection(_collection->cid()));
+  std::vector<TRI_doc_mptr_copy_t> documents;
+
+  while (true) {
+    throwIfKilled(); // check if we were aborted
+
+    documents.clear();
+    documents.reserve(DefaultBatchSize);
+
+    int res = scanner.scan(documents, DefaultBatchSize);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    if (documents.empty()) {
+      break;
+    }
+
+    _engine->_stats.scannedFull += static_cast<int64_t>(documents.size());
+
+    for (auto const& it : documents) {
+      auto marker = reinterpret_cast<TRI_df_marker_t const*>(it.getDataPtr());
+      AqlValue key = extractKey(marker);
+
+      try {
+        auto found = _table.find(key);
+
+        if (found == _table.end()) {
+          // the table takes over the ownership for the key
+          _table.emplace(key, std::vector<TRI_df_marker_t const*>({ marker }));
+        }
+        else {
+          key.destroy();
+          found->second.emplace_back(marker);
+        }
+      }
+      catch (...) {
+        key.destroy();
+        throw;
+      }
+    }
+  }
+
+  _tableBuilt = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the keys of the hash table
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::freeTable () {
+  for (auto& it : _table) {
+    const_cast<AqlValue&>(it.first).destroy();
+  }
+  _table.clear();
+  _tableBuilt = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the join attribute value from a document
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue HashJoinBlock::extractKey (TRI_df_marker_t const* marker) {
+  auto ep = static_cast<HashJoinNode const*>(_exeNode);
+  auto const& attribute = ep->_attribute;
+  TRI_ASSERT(! attribute.empty());
+
+  AqlValue document(marker);
+  Json json = document.extractObjectMember(_trx, _document, attribute[0].c_str(), true, _attributeBuffer);
+
+  size_t const n = attribute.size();
+
+  for (size_t i = 1; i < n; ++i) {
+    TRI_json_t const* sub = nullptr;
+
+    if (json.isObject()) {
+      sub = TRI_LookupObjectJson(json.json(), attribute[i].c_str());
+    }
+
+    if (sub == nullptr) {
+      // attribute path does not exist
+      return AqlValue(new Json(Json::Null));
+    }
+
+    Json copy(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, sub));
+
+    if (copy.json() == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    json = copy;
+  }
+
+  return AqlValue(new Json(json));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the matches for the current input row, advances the input
+/// until a row with at least one match is found. returns false if the input
+/// is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+bool HashJoinBlock::findMatches (size_t atMost) {
+  while (_matches == nullptr || _posInMatches >= _matches->size()) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(DefaultBatchSize, atMost);
+      if (! ExecutionBlock::getBlock(toFetch, toFetch)) {
+        return false;
+      }
+      _pos = 0;           // this is in the first block
+    }
+
+    // if we get here, then _buffer.front() exists
+    AqlItemBlock* cur = _buffer.front();
+    AqlValue const& value = cur->getValueReference(_pos, _inRegister);
+
+    HashTable::const_iterator it;
+
+    if (value.isJson()) {
+      it = _table.find(value);
+    }
+    else {
+      // keys in the hash table are always JSON, so convert the value first
+      Json json = value.toJson(_trx, cur->getDocumentCollection(_inRegister), false);
+      it = _table.find(AqlValue(&json));
+    }
+
+    if (it == _table.end()) {
+      // no match for this input row
+      nextRow();
+    }
+    else {
+      _matches = &((*it).second);
+      _posInMatches = 0;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::nextRow () {
+  _matches = nullptr;
+  _posInMatches = 0;
+
+  AqlItemBlock* cur = _buffer.front();
+
+  if (++_pos >= cur->size()) {
+    _buffer.pop_front();  // does not throw
+    returnBlock(cur);
+    _pos = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hasher for a join key
+///
+/// the keys are compared with TRI_CompareValuesJson, which ignores the order
+/// of object attributes and treats missing attributes and array elements like
+/// null, so they must be hashed with TRI_ValueHashJson and not with the
+/// byte-wise AqlValue::hash
+////////////////////////////////////////////////////////////////////////////////
+
+size_t HashJoinBlock::KeyHash::operator() (AqlValue const& value) const {
+  // both the build and the probe side convert their keys to JSON
+  TRI_ASSERT(value._type == AqlValue::JSON);
+  return static_cast<size_t>(TRI_ValueHashJson(value._json->json()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief comparator for join keys
+////////////////////////////////////////////////////////////////////////////////
+
+bool HashJoinBlock::KeyEqual::operator() (AqlValue const& lhs,
+                                          AqlValue const& rhs) const {
+  return AqlValue::Compare(_trx, lhs, nullptr, rhs, nullptr, false) == 0;
+}
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL HashJoinBlock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_HASH_JOIN_BLOCK_H
+#define ARANGODB_AQL_HASH_JOIN_BLOCK_H 1
+
+#include "Basics/Common.h"
+#include "Aql/Collection.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/ExecutionNode.h"
+#include "Basics/StringBuffer.h"
+
+struct TRI_document_collection_t;
+
+namespace triagens {
+  namespace aql {
+
+    class AqlItemBlock;
+
+    class ExecutionEngine;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     HashJoinBlock
+// -----------------------------------------------------------------------------
+
+    class HashJoinBlock : public ExecutionBlock {
+
+      public:
+
+        HashJoinBlock (ExecutionEngine* engine,
+                       HashJoinNode const* ep);
+
+        ~HashJoinBlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize
+////////////////////////////////////////////////////////////////////////////////
+
+        int initialize () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSome (size_t atLeast, size_t atMost) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+// skip between atLeast and atMost, returns the number actually skipped . . .
+// will only return less than atLeast if there aren't atLeast many
+// things to skip overall.
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSome (size_t atLeast, size_t atMost) override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the hash table from the documents of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildTable ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the keys of the hash table
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeTable ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the join attribute value from a document
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue extractKey (TRI_df_marker_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the matches for the current input row, advances the input
+/// until a row with at least one match is found. returns false if the input
+/// is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        bool findMatches (size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+        void nextRow ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hasher for a join key
+////////////////////////////////////////////////////////////////////////////////
+
+        struct KeyHash {
+          explicit KeyHash (triagens::arango::AqlTransaction* trx)
+            : _trx(trx) {
+          }
+
+          size_t operator() (AqlValue const&) const;
+
+          triagens::arango::AqlTransaction* _trx;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief comparator for join keys, uses the same semantics as the AQL
+/// equality operator
+////////////////////////////////////////////////////////////////////////////////
+
+        struct KeyEqual {
+          explicit KeyEqual (triagens::arango::AqlTransaction* trx)
+            : _trx(trx) {
+          }
+
+          bool operator() (AqlValue const&,
+                           AqlValue const&) const;
+
+          triagens::arango::AqlTransaction* _trx;
+        };
+
+        typedef std::unordered_map<AqlValue, std::vector<TRI_df_marker_t const*>, KeyHash, KeyEqual> HashTable;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection
+////////////////////////////////////////////////////////////////////////////////
+
+        Collection const* _collection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the underlying document collection
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_document_collection_t const* _document;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input register
+////////////////////////////////////////////////////////////////////////////////
+
+        RegisterId _inRegister;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash table with all documents of the collection, keyed by the
+/// join attribute value. documents with the same key are stored in the order
+/// in which they were scanned
+////////////////////////////////////////////////////////////////////////////////
+
+        HashTable _table;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the hash table has been built
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _tableBuilt;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief matches for the current input row
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_df_marker_t const*> const* _matches;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current position in _matches
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _posInMatches;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief buffer for extracting attribute values
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::StringBuffer _attributeBuffer;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the joined documents need to be stored
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _mustStoreResult;
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -53,6 +53,85 @@ using Json = triagens::basics::Json;
 #define LEAVE_BLOCK
 #endif
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  static variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents cached per incoming block
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const IndexRangeBlock::MaxCachedDocuments = 10000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marker value for "no row"
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const IndexRangeBlock::NoRow = SIZE_MAX;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash an index condition. only the lower bounds are taken into
+/// account, as this is used for equality indexes only
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t HashCondition (IndexOrCondition const& condition) {
+  uint64_t hash = 0x12345678;
+
+  for (auto const& andCondition : condition) {
+    for (auto const& ri : andCondition) {
+      hash ^= std::hash<std::string>()(ri._attr);
+
+      if (ri._lowConst.isDefined()) {
+        hash = hash * 31 + TRI_FastHashJson(ri._lowConst.bound().json());
+      }
+    }
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compare two index conditions. only the lower bounds are taken into
+/// account, as this is used for equality indexes only
+///
+/// the bounds are compared byte-wise like HashCondition hashes them, so equal
+/// conditions always have the same hash
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ConditionsEqual (IndexOrCondition const& lhs,
+                             IndexOrCondition const& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i].size() != rhs[i].size()) {
+      return false;
+    }
+
+    for (size_t j = 0; j < lhs[i].size(); ++j) {
+      auto const& l = lhs[i][j];
+      auto const& r = rhs[i][j];
+
+      if (l._attr != r._attr ||
+          l._lowConst.isDefined() != r._lowConst.isDefined()) {
+        return false;
+      }
+
+      if (l._lowConst.isDefined() &&
+          ! TRI_CheckSameValueJson(l._lowConst.bound().json(), r._lowConst.bound().json())) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             class IndexRangeBlock
 // -----------------------------------------------------------------------------
@@ -71,7 +150,11 @@ IndexRangeBlock::IndexRangeBlock (ExecutionEngine* engine,
     _posInRanges(0),
     _sortCoords(),
     _freeCondition(true),
-    _hasV8Expression(false) {
+    _hasV8Expression(false),
+    _rowConditionsValid(false),
+    _cachedDocuments(0),
+    _recordRow(NoRow),
+    _cachedRow(NoRow) {
 
   auto trxCollection = _trx->trxCollection(_collection->cid());
 
@@ -114,6 +197,7 @@ IndexRangeBlock::IndexRangeBlock (ExecutionEngine* engine,
 
 IndexRangeBlock::~IndexRangeBlock () {
   destroyHashIndexSearchValues();
+  freeRowConditions();
 
   for (auto& e : _allVariableBoundExpressions) {
     delete e;
@@ -132,6 +216,15 @@ bool IndexRangeBlock::useHighBounds () const {
   return (en->_index->type == triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX);
 }
 
+bool IndexRangeBlock::isEqualityIndex () const {
+  auto en = static_cast<IndexRangeNode const*>(getPlanNode());
+  auto const type = en->_index->type;
+
+  return (type == triagens::arango::Index::TRI_IDX_TYPE_PRIMARY_INDEX ||
+          type == triagens::arango::Index::TRI_IDX_TYPE_EDGE_INDEX ||
+          type == triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX);
+}
+
 bool IndexRangeBlock::hasV8Expression () const {
   for (auto const& expression : _allVariableBoundExpressions) {
     TRI_ASSERT(expression != nullptr);
@@ -143,15 +236,12 @@ bool IndexRangeBlock::hasV8Expression () const {
   return false;
 }
 
-void IndexRangeBlock::buildExpressions () {
+IndexOrCondition* IndexRangeBlock::buildExpressions (AqlItemBlock* cur,
+                                                     size_t pos) {
   bool const useHighBounds = this->useHighBounds(); 
 
   size_t posInExpressions = 0;
     
-  // The following are needed to evaluate expressions with local data from
-  // the current incoming item:
-  AqlItemBlock* cur = _buffer.front();
-        
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
   std::unique_ptr<IndexOrCondition> newCondition;
 
@@ -177,7 +267,7 @@ void IndexRangeBlock::buildExpressions () {
         Expression* e = _allVariableBoundExpressions[posInExpressions];
         TRI_ASSERT(e != nullptr);
         TRI_document_collection_t const* myCollection = nullptr; 
-        AqlValue a = e->execute(_trx, cur, _pos, _inVars[posInExpressions], _inRegs[posInExpressions], &myCollection);
+        AqlValue a = e->execute(_trx, cur, pos, _inVars[posInExpressions], _inRegs[posInExpressions], &myCollection);
         posInExpressions++;
 
         Json bound;
@@ -247,7 +337,7 @@ void IndexRangeBlock::buildExpressions () {
           Expression* e = _allVariableBoundExpressions[posInExpressions];
           TRI_ASSERT(e != nullptr);
           TRI_document_collection_t const* myCollection = nullptr; 
-          AqlValue a = e->execute(_trx, cur, _pos, _inVars[posInExpressions], _inRegs[posInExpressions], &myCollection);
+          AqlValue a = e->execute(_trx, cur, pos, _inVars[posInExpressions], _inRegs[posInExpressions], &myCollection);
           posInExpressions++;
 
           Json bound;
@@ -326,19 +416,153 @@ void IndexRangeBlock::buildExpressions () {
 
   }
     
-  freeCondition(); 
-    
   if (newCondition != nullptr) {
-    _condition = newCondition.release();
-    _freeCondition = true;
- 
     // remove duplicates . . .
-    removeOverlapsIndexOr(*_condition);
+    removeOverlapsIndexOr(*newCondition);
+
+    return newCondition.release();
   }
-  else {
-    _condition = new IndexOrCondition;
-    _freeCondition = true;
+
+  return new IndexOrCondition;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evaluate the index conditions for all rows of the current
+/// incoming block at once, and find rows with identical conditions
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexRangeBlock::buildConditions () {
+  freeRowConditions();
+
+  AqlItemBlock* cur = _buffer.front();
+  size_t const n = cur->size();
+
+  if (_anyBoundVariable) {
+    _rowConditions.reserve(n);
+
+    auto evaluate = [&] () -> void {
+      for (size_t i = 0; i < n; ++i) {
+        std::unique_ptr<IndexOrCondition> condition(buildExpressions(cur, i));
+        _rowConditions.emplace_back(condition.get());
+        condition.release();
+      }
+    };
+
+    if (_hasV8Expression) {
+      bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster();
+
+      // must have a V8 context here to protect Expression::execute()
+      auto engine = _engine;
+      triagens::basics::ScopeGuard guard{
+        [&engine]() -> void { 
+          engine->getQuery()->enterContext(); 
+        },
+        [&]() -> void {
+          if (isRunningInCluster) {
+            // must invalidate the expression now as we might be called from
+            // different threads
+            if (triagens::arango::ServerState::instance()->isRunningInCluster()) {
+              for (auto const& e : _allVariableBoundExpressions) {
+                e->invalidate();
+              }
+            }
+          
+            engine->getQuery()->exitContext(); 
+          }
+        }
+      };
+
+      ISOLATE;
+      v8::HandleScope scope(isolate); // do not delete this!
+    
+      evaluate();
+    }
+    else {
+      // no V8 context required!
+
+      Functions::InitializeThreadContext();
+      try {
+        evaluate();
+        Functions::DestroyThreadContext();
+      }
+      catch (...) {
+        Functions::DestroyThreadContext();
+        throw;
+      }
+    }
   }
+
+  if (isEqualityIndex()) {
+    // find rows with identical lookup values. the index is probed only once
+    // for them, and the result is reused for the later rows
+    _rowSource.reserve(n);
+    _rowShared.resize(n, false);
+    _rowComplete.resize(n, false);
+    _rowDocuments.resize(n);
+
+    if (! _anyBoundVariable) {
+      // all rows use the same constant condition
+      for (size_t i = 0; i < n; ++i) {
+        _rowSource.emplace_back(0);
+      }
+      _rowShared[0] = (n > 1);
+    }
+    else {
+      std::unordered_multimap<uint64_t, size_t> seen;
+      seen.reserve(n);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto const& condition = *_rowConditions[i];
+        uint64_t const hash = HashCondition(condition);
+        size_t source = i;
+
+        auto range = seen.equal_range(hash);
+
+        for (auto it = range.first; it != range.second; ++it) {
+          if (ConditionsEqual(condition, *_rowConditions[(*it).second])) {
+            source = (*it).second;
+            break;
+          }
+        }
+
+        if (source == i) {
+          seen.emplace(hash, i);
+        }
+        else {
+          _rowShared[source] = true;
+        }
+
+        _rowSource.emplace_back(source);
+      }
+    }
+  }
+
+  _rowConditionsValid = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the conditions and cached lookup results of the current block
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexRangeBlock::freeRowConditions () {
+  if (! _freeCondition && ! _rowConditions.empty()) {
+    // _condition points into _rowConditions
+    _condition = nullptr;
+  }
+
+  for (auto& it : _rowConditions) {
+    delete it;
+  }
+
+  _rowConditions.clear();
+  _rowSource.clear();
+  _rowShared.clear();
+  _rowDocuments.clear();
+  _rowComplete.clear();
+  _cachedDocuments = 0;
+  _recordRow = NoRow;
+  _cachedRow = NoRow;
+  _rowConditionsValid = false;
 }
 
 int IndexRangeBlock::initialize () {
@@ -426,15 +650,17 @@ int IndexRangeBlock::initialize () {
   LEAVE_BLOCK;
 }
 
-// init the ranges for reading, this should be called once per new incoming
-// block!
+// init the ranges for reading, this should be called once per incoming
+// item!
 //
-// This is either called every time we get a new incoming block. 
 // If all the bounds are constant, then in the case of hash, primary or edges
 // indexes it does nothing. In the case of a skiplist index, it creates a
 // skiplistIterator which is used by readIndex. If at least one bound is
-// variable, then this this also evaluates the IndexOrCondition required to
-// determine the values of the bounds. 
+// variable, then the IndexOrConditions required to determine the values of 
+// the bounds are evaluated for all items of the incoming block at once, when
+// the first item of the block is initialized. For equality indexes, items
+// with the same lookup values as an earlier item of the block reuse that
+// item's lookup result instead of probing the index again.
 //
 // It is guaranteed that
 //   _buffer   is not empty, in particular _buffer.front() is defined
@@ -445,51 +671,34 @@ int IndexRangeBlock::initialize () {
 bool IndexRangeBlock::initRanges () {
   ENTER_BLOCK
   _flag = true; 
+  _recordRow = NoRow;
+  _cachedRow = NoRow;
 
-  // Find out about the actual values for the bounds in the variable bound case:
+  if (! _rowConditionsValid) {
+    // a new incoming block. evaluate the bounds for all of its rows
+    buildConditions();
+  }
 
+  // Use the actual values for the bounds in the variable bound case:
   if (_anyBoundVariable) {
-    if (_hasV8Expression) {
-      bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster();
+    freeCondition();
+    _condition = _rowConditions[_pos];
+    _freeCondition = false;
+  }
 
-      // must have a V8 context here to protect Expression::execute()
-      auto engine = _engine;
-      triagens::basics::ScopeGuard guard{
-        [&engine]() -> void { 
-          engine->getQuery()->enterContext(); 
-        },
-        [&]() -> void {
-          if (isRunningInCluster) {
-            // must invalidate the expression now as we might be called from
-            // different threads
-            if (triagens::arango::ServerState::instance()->isRunningInCluster()) {
-              for (auto const& e : _allVariableBoundExpressions) {
-                e->invalidate();
-              }
-            }
-          
-            engine->getQuery()->exitContext(); 
-          }
-        }
-      };
+  if (! _rowSource.empty()) {
+    size_t const source = _rowSource[_pos];
 
-      ISOLATE;
-      v8::HandleScope scope(isolate); // do not delete this!
-    
-      buildExpressions();
+    if (source != _pos && _rowComplete[source]) {
+      // an earlier row had the same lookup values, and its result is
+      // complete. no need to probe the index again
+      _cachedRow = source;
+      return true;
     }
-    else {
-      // no V8 context required!
 
-      Functions::InitializeThreadContext();
-      try {
-        buildExpressions();
-        Functions::DestroyThreadContext();
-      }
-      catch (...) {
-        Functions::DestroyThreadContext();
-        throw;
-      }
+    if (source == _pos && _rowShared[_pos]) {
+      // later rows will have the same lookup values, so keep the result
+      _recordRow = _pos;
     }
   }
   
@@ -793,6 +1002,16 @@ bool IndexRangeBlock::readIndex (size_t atMost) {
   else { 
     _documents.clear();
   }
+
+  if (_cachedRow != NoRow) {
+    // reuse the result of an earlier item with the same lookup values
+    if (_flag) {
+      auto const& cached = _rowDocuments[_cachedRow];
+      _documents.insert(_documents.end(), cached.begin(), cached.end());
+    }
+    _flag = false;
+    return (! _documents.empty());
+  }
   
   auto en = static_cast<IndexRangeNode const*>(getPlanNode());
   
@@ -814,6 +1033,27 @@ bool IndexRangeBlock::readIndex (size_t atMost) {
     TRI_ASSERT(false);
   }
   _flag = false;
+
+  if (_recordRow != NoRow) {
+    auto& cached = _rowDocuments[_recordRow];
+
+    if (_documents.empty()) {
+      // the lookup is complete now, later items can reuse the result
+      _rowComplete[_recordRow] = true;
+      _recordRow = NoRow;
+    }
+    else if (_cachedDocuments + _documents.size() <= MaxCachedDocuments) {
+      cached.insert(cached.end(), _documents.begin(), _documents.end());
+      _cachedDocuments += _documents.size();
+    }
+    else {
+      // result is too big to be cached
+      _cachedDocuments -= cached.size();
+      std::vector<TRI_doc_mptr_copy_t>().swap(cached);
+      _recordRow = NoRow;
+    }
+  }
+
   return (! _documents.empty());
   LEAVE_BLOCK;
 }
@@ -827,6 +1067,7 @@ int IndexRangeBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   }
   _pos = 0;
   _posInDocs = 0;
+  freeRowConditions();
   
   return TRI_ERROR_NO_ERROR; 
   LEAVE_BLOCK;
@@ -876,6 +1117,7 @@ AqlItemBlock* IndexRangeBlock::getSome (size_t atLeast,
           _buffer.pop_front();  // does not throw
           delete cur;
           _pos = 0;
+          freeRowConditions();
         }
         if (_buffer.empty()) {
           if (! ExecutionBlock::getBlock(DefaultBatchSize, DefaultBatchSize) ) {
@@ -991,6 +1233,7 @@ size_t IndexRangeBlock::skipSome (size_t atLeast,
           _buffer.pop_front();  // does not throw
           delete cur;
           _pos = 0;
+          freeRowConditions();
         }
 
         // let's read the index if bounds are variable:
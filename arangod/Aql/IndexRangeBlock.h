@@ -102,10 +102,30 @@ namespace triagens {
         bool hasV8Expression () const;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief build the bounds expressions
+/// @brief whether or not the index only supports equality lookups, i.e.
+/// primary index, edge index and hash index
 ////////////////////////////////////////////////////////////////////////////////
 
-        void buildExpressions ();
+        bool isEqualityIndex () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the bounds expressions for a row of the given block
+////////////////////////////////////////////////////////////////////////////////
+
+        IndexOrCondition* buildExpressions (AqlItemBlock*, size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evaluate the index conditions for all rows of the current
+/// incoming block at once, and find rows with identical conditions
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildConditions ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the conditions and cached lookup results of the current block
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeRowConditions ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief free _condition if it belongs to us
@@ -343,6 +363,76 @@ namespace triagens {
 
         bool _hasV8Expression;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the evaluated conditions for each row of the current incoming
+/// block, only used if any of the bounds is variable
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<IndexOrCondition*> _rowConditions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the conditions for the current incoming block
+/// have been evaluated
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _rowConditionsValid;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief for each row of the current incoming block, the first row with an
+/// identical condition. only used for equality indexes
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _rowSource;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief for each row of the current incoming block, whether or not later
+/// rows have the same condition, so the lookup result should be kept
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<bool> _rowShared;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup results of the shared rows of the current incoming block
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::vector<TRI_doc_mptr_copy_t>> _rowDocuments;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the lookup result of a shared row is complete
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<bool> _rowComplete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total number of documents in _rowDocuments
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _cachedDocuments;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the row whose lookup result is currently recorded in _rowDocuments
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _recordRow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the row whose cached lookup result is used for the current row
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _cachedRow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents cached per incoming block
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxCachedDocuments;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marker value for "no row"
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NoRow;
+
     };
 
   }  // namespace triagens::aql
@@ -583,6 +583,12 @@ void Optimizer::setupRules () {
                removeFiltersCoveredByIndexRule_pass6,
                true);
 
+  // try to replace nested loops by hash joins
+  registerRule("use-hash-join",
+               useHashJoinRule,
+               useHashJoinRule_pass6,
+               true);
+
   // try to find sort blocks which are superseeded by indexes
   registerRule("use-index-for-sort",
                useIndexForSortRule,
@@ -188,6 +188,9 @@ namespace triagens {
 
         // try to remove filters covered by index ranges
         removeFiltersCoveredByIndexRule_pass6         = 840,
+
+        // try to replace nested loops with equality join conditions by hash joins
+        useHashJoinRule_pass6                         = 845,
   
         // try to find sort blocks which are superseeded by indexes
         useIndexForSortRule_pass6                     = 850,
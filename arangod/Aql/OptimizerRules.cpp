@@ -845,9 +845,10 @@ int triagens::aql::removeSortRandRule (Optimizer* opt,
         case EN::FILTER: 
         case EN::SUBQUERY:
         case EN::ENUMERATE_LIST:
-        case EN::INDEX_RANGE: {
+        case EN::INDEX_RANGE:
+        case EN::HASH_JOIN: {
           // if we found another SortNode, an AggregateNode, FilterNode, a SubqueryNode, 
-          // an EnumerateListNode or an IndexRangeNode
+          // an EnumerateListNode, an IndexRangeNode or a HashJoinNode
           // this means we cannot apply our optimization
           collectionNode = nullptr;
           current = nullptr;
@@ -1045,6 +1046,7 @@ int triagens::aql::moveCalculationsDownRule (Optimizer* opt,
         shouldMove = true;
       } 
       else if (currentType == EN::INDEX_RANGE ||
+               currentType == EN::HASH_JOIN ||
                currentType == EN::ENUMERATE_COLLECTION ||
                currentType == EN::ENUMERATE_LIST ||
                currentType == EN::AGGREGATE ||
@@ -2095,6 +2097,7 @@ class FilterToEnumCollFinder final : public WalkerWorker<ExecutionNode> {
         case EN::SUBQUERY:        
         case EN::SORT:
         case EN::INDEX_RANGE:
+        case EN::HASH_JOIN:
           break;
 
         case EN::CALCULATION: {
@@ -2937,6 +2940,7 @@ class SortToIndexNode final : public WalkerWorker<ExecutionNode> {
 
         if (node->getType() == EN::ENUMERATE_COLLECTION ||
             node->getType() == EN::INDEX_RANGE ||
+            node->getType() == EN::HASH_JOIN ||
             node->getType() == EN::ENUMERATE_LIST) {
           // we are contained in an outer loop
           return true;
@@ -3065,6 +3069,7 @@ class SortToIndexNode final : public WalkerWorker<ExecutionNode> {
       case EN::GATHER:
       case EN::REMOTE:
       case EN::ILLEGAL:
+      case EN::HASH_JOIN:
       case EN::LIMIT:                      // LIMIT is criterion to stop
         return true;  // abort.
 
@@ -3356,6 +3361,272 @@ int triagens::aql::removeFiltersCoveredByIndexRule (Optimizer* opt,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper function to determine the attribute path of an attribute
+/// access on the given variable, e.g. [ "a", "b" ] for doc.a.b
+////////////////////////////////////////////////////////////////////////////////
+
+static bool GetAttributePath (AstNode const* node,
+                              Variable const* variable,
+                              std::vector<std::string>& attribute) {
+  attribute.clear();
+
+  while (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+    attribute.emplace_back(std::string(node->getStringValue(), node->getStringLength()));
+    node = node->getMember(0);
+  }
+
+  if (attribute.empty() ||
+      node->type != NODE_TYPE_REFERENCE ||
+      static_cast<Variable const*>(node->getData()) != variable) {
+    attribute.clear();
+    return false;
+  }
+
+  std::reverse(attribute.begin(), attribute.end());
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a FILTER that can be turned into a hash join
+////////////////////////////////////////////////////////////////////////////////
+
+struct HashJoinCandidate {
+  EnumerateCollectionNode* enumerateNode;
+  FilterNode* filterNode;
+  CalculationNode* calculationNode;
+  AstNode const* outerExpression;
+  std::vector<std::string> attribute;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether a FILTER compares an attribute of the directly
+/// preceeding EnumerateCollectionNode with an expression that only depends
+/// on the outer loops, i.e. FOR a IN A FOR b IN B FILTER b.x == a.y
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FindHashJoinCandidate (ExecutionPlan* plan,
+                                   FilterNode* fn,
+                                   HashJoinCandidate& candidate) {
+  auto inVar = fn->getVariablesUsedHere();
+  TRI_ASSERT(inVar.size() == 1);
+
+  auto setter = plan->getVarSetBy(inVar[0]->id);
+
+  if (setter == nullptr ||
+      setter->getType() != EN::CALCULATION) {
+    return false;
+  }
+
+  auto cn = static_cast<CalculationNode*>(setter);
+  auto node = cn->expression()->node();
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return false;
+  }
+
+  // walk up to the enumeration. only calculations and filters may be
+  // in between, and none of them must be able to throw, because they will
+  // be executed for less documents afterwards
+  bool foundCalculation = false;
+  ExecutionNode* current = fn->hasDependency() ? fn->getFirstDependency() : nullptr;
+
+  while (current != nullptr) {
+    auto const type = current->getType();
+
+    if (type == EN::ENUMERATE_COLLECTION) {
+      break;
+    }
+
+    if (type != EN::CALCULATION &&
+        type != EN::FILTER) {
+      return false;
+    }
+
+    if (current == cn) {
+      foundCalculation = true;
+    }
+    else if (current->canThrow()) {
+      return false;
+    }
+
+    current = current->hasDependency() ? current->getFirstDependency() : nullptr;
+  }
+
+  if (current == nullptr || 
+      ! foundCalculation ||
+      ! current->hasDependency()) {
+    return false;
+  }
+
+  auto en = static_cast<EnumerateCollectionNode*>(current);
+
+  if (en->isRandom()) {
+    return false;
+  }
+
+  // variables that are valid before the enumeration
+  auto const& varsValid = en->getFirstDependency()->getVarsValid();
+
+  for (size_t i = 0; i < 2; ++i) {
+    auto inner = node->getMember(i);
+    auto outer = node->getMember(1 - i);
+
+    if (! GetAttributePath(inner, en->outVariable(), candidate.attribute)) {
+      continue;
+    }
+
+    // the outer expression will be executed once per outer document instead
+    // of once per pair of documents
+    if (! outer->isDeterministic() || outer->canThrow()) {
+      continue;
+    }
+
+    std::unordered_set<Variable const*> varsUsed;
+    Ast::getReferencedVariables(outer, varsUsed);
+
+    if (varsUsed.empty()) {
+      // comparison with a constant. this is handled better by indexes
+      continue;
+    }
+
+    bool valid = true;
+
+    for (auto const& v : varsUsed) {
+      if (varsValid.find(v) == varsValid.end()) {
+        valid = false;
+        break;
+      }
+    }
+
+    if (! valid) {
+      continue;
+    }
+
+    candidate.enumerateNode = en;
+    candidate.filterNode = fn;
+    candidate.calculationNode = cn;
+    candidate.outerExpression = outer;
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use a hash join for equality joins between collections
+/// this rule creates an additional plan in which the inner EnumerateCollectionNode
+/// of an equality join is replaced by a HashJoinNode. The inner collection is
+/// then scanned only once instead of once per outer document. The plans'
+/// costs decide whether the hash join is used. Together with the permutations
+/// created by "interchange-adjacent-enumerations", this makes the optimizer
+/// build the hash table over the smaller of the two collections
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useHashJoinRule (Optimizer* opt,
+                                    ExecutionPlan* plan,
+                                    Optimizer::Rule const* rule) {
+  std::vector<HashJoinCandidate> candidates;
+
+  // in the cluster, the collections are distributed over multiple shards,
+  // which the hash join cannot handle. additionally, the hash table is built
+  // only once per query, so the inner collection must not be modified by 
+  // the query itself
+  std::vector<ExecutionNode::NodeType> const types = { 
+    ExecutionNode::INSERT,
+    ExecutionNode::UPDATE,
+    ExecutionNode::REPLACE,
+    ExecutionNode::REMOVE,
+    ExecutionNode::UPSERT
+  };
+
+  if (! triagens::arango::ServerState::instance()->isCoordinator() &&
+      plan->findNodesOfType(types, true).empty()) {
+    plan->findVarUsage();
+
+    std::unordered_set<ExecutionNode*> seen;
+    std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::FILTER, true);
+
+    for (auto const& n : nodes) {
+      HashJoinCandidate candidate;
+
+      if (! FindHashJoinCandidate(plan, static_cast<FilterNode*>(n), candidate)) {
+        continue;
+      }
+
+      if (seen.find(candidate.enumerateNode) != seen.end()) {
+        // can only use one join condition per enumeration
+        continue;
+      }
+
+      seen.emplace(candidate.enumerateNode);
+      candidates.emplace_back(candidate);
+    }
+  }
+
+  opt->addPlan(plan, rule, false);
+
+  if (candidates.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  auto newPlan = plan->clone();
+
+  try {
+    auto ast = newPlan->getAst();
+
+    for (auto const& candidate : candidates) {
+      auto en = static_cast<EnumerateCollectionNode*>(newPlan->getNodeById(candidate.enumerateNode->id()));
+      auto fn = newPlan->getNodeById(candidate.filterNode->id());
+      auto cn = static_cast<CalculationNode*>(newPlan->getNodeById(candidate.calculationNode->id()));
+      TRI_ASSERT(en != nullptr && fn != nullptr && cn != nullptr);
+
+      // calculate the outer join value before the hash join
+      auto calculation = static_cast<CalculationNode*>(newPlan->createTemporaryCalculation(ast->clone(candidate.outerExpression), nullptr));
+
+      auto joinNode = new HashJoinNode(newPlan, 
+                                       newPlan->nextId(), 
+                                       en->vocbase(), 
+                                       en->collection(), 
+                                       calculation->outVariable(), 
+                                       en->outVariable(),
+                                       candidate.attribute);
+      newPlan->registerNode(joinNode);
+      newPlan->replaceNode(en, joinNode);
+      newPlan->insertDependency(joinNode, calculation);
+
+      // the join condition is now fulfilled by the hash join
+      newPlan->unlinkNode(fn);
+    }
+
+    newPlan->findVarUsage();
+
+    // remove the join conditions if they are not needed anymore
+    std::unordered_set<ExecutionNode*> toUnlink;
+
+    for (auto const& candidate : candidates) {
+      auto cn = static_cast<CalculationNode*>(newPlan->getNodeById(candidate.calculationNode->id()));
+
+      if (! cn->isVarUsedLater(cn->outVariable())) {
+        toUnlink.emplace(cn);
+      }
+    }
+
+    if (! toUnlink.empty()) {
+      newPlan->unlinkNodes(toUnlink);
+      newPlan->findVarUsage();
+    }
+
+    opt->addPlan(newPlan, rule, true);
+  }
+  catch (...) {
+    delete newPlan;
+    throw;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief helper to compute lots of permutation tuples
 /// a permutation tuple is represented as a single vector together with
@@ -3893,6 +4164,7 @@ int triagens::aql::distributeFilternCalcToClusterRule (Optimizer* opt,
         case EN::LIMIT:
         case EN::SORT:
         case EN::INDEX_RANGE:
+        case EN::HASH_JOIN:
         case EN::ENUMERATE_COLLECTION:
           //do break
           stopSearching = true;
@@ -3989,6 +4261,7 @@ int triagens::aql::distributeSortToClusterRule (Optimizer* opt,
         case EN::REMOTE:
         case EN::LIMIT:
         case EN::INDEX_RANGE:
+        case EN::HASH_JOIN:
         case EN::ENUMERATE_COLLECTION:
           // For all these, we do not want to pull a SortNode further down
           // out to the DBservers, note that potential FilterNodes and
@@ -4262,7 +4535,8 @@ class RemoveToEnumCollFinder final : public WalkerWorker<ExecutionNode> {
         case EN::ILLEGAL:
         case EN::LIMIT:           
         case EN::SORT:
-        case EN::INDEX_RANGE: {
+        case EN::INDEX_RANGE:
+        case EN::HASH_JOIN: {
           // if we meet any of the above, then we abort . . .
         }
     }
@@ -4804,6 +5078,7 @@ int triagens::aql::patchUpdateStatementsRule (Optimizer* opt,
 
       if (type == EN::ENUMERATE_LIST || 
           type == EN::INDEX_RANGE ||
+          type == EN::HASH_JOIN ||
           type == EN::SUBQUERY) {
         // not suitable
         modified = false;
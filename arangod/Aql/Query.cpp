@@ -65,6 +65,14 @@ using Json = triagens::basics::Json;
     
 static char const* EmptyString = "";
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents in a collection that a query copies
+/// into a snapshot. larger collections are scanned under the collection lock
+/// as before, as the copy would need too much memory
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxSnapshotDocuments = 1000000;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief names of query phases / states
 ////////////////////////////////////////////////////////////////////////////////
@@ -196,6 +204,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _shortStringStorage(1024),
     _ast(nullptr),
     _profile(nullptr),
+    _nodeStats(nullptr),
     _state(INVALID_STATE),
     _plan(nullptr),
     _parser(nullptr),
@@ -206,7 +215,9 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _part(part),
     _contextOwnedByExterior(contextOwnedByExterior),
     _killed(false),
-    _isModificationQuery(false) {
+    _isModificationQuery(false),
+    _snapshotReads(false),
+    _snapshotDocuments(0) {
 
   // std::cout << TRI_CurrentThreadId() << ", QUERY " << this << " CTOR: " << queryString << "\n";
 
@@ -238,6 +249,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _shortStringStorage(1024),
     _ast(nullptr),
     _profile(nullptr),
+    _nodeStats(nullptr),
     _state(INVALID_STATE),
     _plan(nullptr),
     _parser(nullptr),
@@ -248,7 +260,9 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _part(part),
     _contextOwnedByExterior(contextOwnedByExterior),
     _killed(false),
-    _isModificationQuery(false) {
+    _isModificationQuery(false),
+    _snapshotReads(false),
+    _snapshotDocuments(0) {
 
   // std::cout << TRI_CurrentThreadId() << ", QUERY " << this << " CTOR (JSON): " << _queryJson.toString() << "\n";
 
@@ -266,6 +280,11 @@ Query::~Query () {
   delete _profile;
   _profile = nullptr;
 
+  if (_nodeStats != nullptr) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _nodeStats);
+    _nodeStats = nullptr;
+  }
+
   if (_options != nullptr) {
     TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _options);
     _options = nullptr;
@@ -601,8 +620,15 @@ QueryResult Query::prepare (QueryRegistry* registry) {
     exitContext();
 
     enterState(EXECUTION);
+    _snapshotReads = canUseSnapshotReads(plan.get());
+
     ExecutionEngine* engine(ExecutionEngine::instantiateFromPlan(registry, this, plan.get(), planRegisters));
 
+    if (_snapshotReads) {
+      // all collection scanners have copied their documents now
+      unlockSnapshotCollections(plan.get());
+    }
+
     // If all went well so far, then we keep _plan, _parser and _trx and
     // return:
     _plan = plan.release();
@@ -742,6 +768,8 @@ QueryResult Query::execute (QueryRegistry* registry) {
 
     enterState(FINALIZATION); 
 
+    addNodeStats(stats);
+
     QueryResult result(TRI_ERROR_NO_ERROR);
     result.warnings = warningsToJson(TRI_UNKNOWN_MEM_ZONE);
     result.json     = jsonResult.steal();
@@ -888,6 +916,8 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate,
 
     enterState(FINALIZATION); 
 
+    addNodeStats(stats);
+
     result.warnings = warningsToJson(TRI_UNKNOWN_MEM_ZONE);
     result.stats    = stats.steal(); 
 
@@ -1321,6 +1351,94 @@ bool Query::canUseQueryCache () const {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the query can read its collections from snapshots
+/// this is the case for read-only queries that access their collections only
+/// by full collection scans. such a query copies the master pointers of each
+/// collection once while the transaction still holds all collection locks,
+/// so it sees all collections as of the start of the transaction and does
+/// not need the locks while it is executed. queries that use indexes or call
+/// functions that access collections directly keep their locks.
+/// as the copy costs time and memory proportional to the size of the
+/// collections, snapshots must be requested with the option snapshotReads,
+/// and they are not taken for queries with a LIMIT, which may only need a
+/// few documents
+////////////////////////////////////////////////////////////////////////////////
+
+bool Query::canUseSnapshotReads (ExecutionPlan* plan) const {
+  if (_part != PART_MAIN ||
+      _isModificationQuery ||
+      ! getBooleanOption("snapshotReads", false)) {
+    return false;
+  }
+
+  if (_trx->isEmbeddedTransaction() ||
+      triagens::arango::ServerState::instance()->isRunningInCluster()) {
+    // the locks belong to a surrounding transaction or to the cluster
+    return false;
+  }
+
+  std::vector<ExecutionNode::NodeType> const excludedTypes{
+    ExecutionNode::INDEX_RANGE,
+    ExecutionNode::HASH_JOIN,
+    ExecutionNode::LIMIT,
+    ExecutionNode::INSERT,
+    ExecutionNode::REMOVE,
+    ExecutionNode::REPLACE,
+    ExecutionNode::UPDATE,
+    ExecutionNode::UPSERT,
+    ExecutionNode::SCATTER,
+    ExecutionNode::GATHER,
+    ExecutionNode::REMOTE,
+    ExecutionNode::DISTRIBUTE
+  };
+
+  if (! plan->findNodesOfType(excludedTypes, true).empty()) {
+    return false;
+  }
+
+  for (auto const& it : plan->findNodesOfType(ExecutionNode::CALCULATION, true)) {
+    auto expression = static_cast<CalculationNode const*>(it)->expression();
+
+    if (! expression->canRunOnDBServer()) {
+      // expression calls a function that accesses collections
+      return false;
+    }
+  }
+
+  auto const nodes = plan->findNodesOfType(ExecutionNode::ENUMERATE_COLLECTION, true);
+
+  if (nodes.empty()) {
+    return false;
+  }
+
+  for (auto const& it : nodes) {
+    auto node = static_cast<EnumerateCollectionNode const*>(it);
+
+    if (node->isRandom() || 
+        node->collection()->count() > MaxSnapshotDocuments) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief release the locks on all collections read from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+void Query::unlockSnapshotCollections (ExecutionPlan* plan) {
+  for (auto const& it : plan->findNodesOfType(ExecutionNode::ENUMERATE_COLLECTION, true)) {
+    auto node = static_cast<EnumerateCollectionNode const*>(it);
+    int res = _trx->unlockCollection(node->collection()->cid());
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fetch a numeric value from the options
 ////////////////////////////////////////////////////////////////////////////////
@@ -1450,6 +1568,17 @@ void Query::cleanupPlanAndEngine (int errorCode) {
       // shutdown may fail but we must not throw here 
       // (we're also called from the destructor)
     }
+
+    if (errorCode == TRI_ERROR_NO_ERROR && 
+        _nodeStats == nullptr && 
+        profiling()) {
+      // the statistics of remote nodes are only complete after the shutdown
+      try {
+        _nodeStats = _engine->nodeStatsToJson().steal();
+      }
+      catch (...) {
+      }
+    }
     delete _engine;
     _engine = nullptr;
   }
@@ -1471,6 +1600,25 @@ void Query::cleanupPlanAndEngine (int errorCode) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the statistics of the execution nodes to the query statistics
+/// if the query was profiled, and the number of documents copied into
+/// snapshots if the query read from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+void Query::addNodeStats (triagens::basics::Json& stats) {
+  if (_snapshotReads) {
+    stats.set("snapshotDocuments", triagens::basics::Json(static_cast<double>(_snapshotDocuments)));
+  }
+
+  if (_nodeStats == nullptr) {
+    return;
+  }
+
+  stats.set("nodes", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, _nodeStats, triagens::basics::Json::AUTOFREE));
+  _nodeStats = nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set the plan for the query
 ////////////////////////////////////////////////////////////////////////////////
@@ -272,6 +272,23 @@ namespace triagens {
           return getBooleanOption("profile", false);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the query reads collections from snapshots and does not
+/// keep them locked while it is executed
+////////////////////////////////////////////////////////////////////////////////
+
+        bool snapshotReads () const {  
+          return _snapshotReads;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts documents copied into a snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        void addSnapshotDocuments (size_t count) {
+          _snapshotDocuments += count;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum number of plans to produce
 ////////////////////////////////////////////////////////////////////////////////
@@ -507,6 +524,18 @@ namespace triagens {
 
         bool canUseQueryCache () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the query can read its collections from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+        bool canUseSnapshotReads (ExecutionPlan*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief release the locks on all collections read from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+        void unlockSnapshotCollections (ExecutionPlan*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fetch a numeric value from the options
 ////////////////////////////////////////////////////////////////////////////////
@@ -550,6 +579,14 @@ namespace triagens {
 
         void cleanupPlanAndEngine (int);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the statistics of the execution nodes to the query statistics
+/// if the query was profiled, and the number of documents copied into
+/// snapshots if the query read from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+        void addNodeStats (triagens::basics::Json&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a TransactionContext
 ////////////////////////////////////////////////////////////////////////////////
@@ -659,6 +696,12 @@ namespace triagens {
 
         Profile*                          _profile;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics of the execution nodes, if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_json_t*                       _nodeStats;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief current state the query is in (used for profiling and error messages)
 ////////////////////////////////////////////////////////////////////////////////
@@ -727,6 +770,18 @@ namespace triagens {
 
         bool                              _isModificationQuery;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the query reads its collections from snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+        bool                              _snapshotReads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents the query copied into snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t                            _snapshotDocuments;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not query tracking is disabled globally
 ////////////////////////////////////////////////////////////////////////////////
@@ -858,6 +858,11 @@ void RestAqlHandler::handleUseQuery (std::string const& operation,
       // return statistics
       answerBody("stats", query->getStats());
 
+      if (query->profiling()) {
+        // return the statistics of the nodes, merged by the coordinator
+        answerBody("nodes", query->engine()->nodeStatsToJson());
+      }
+
       // return warnings if present
       auto warnings = query->warningsToJson(TRI_UNKNOWN_MEM_ZONE);
       if (warnings != nullptr) {
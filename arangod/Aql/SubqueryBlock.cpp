@@ -151,7 +151,7 @@ std::vector<AqlItemBlock*>* SubqueryBlock::executeSubquery () {
 
   try {
     do {
-      std::unique_ptr<AqlItemBlock> tmp(_subquery->getSome(DefaultBatchSize, DefaultBatchSize));
+      std::unique_ptr<AqlItemBlock> tmp(_subquery->getSomeProfiled(DefaultBatchSize, DefaultBatchSize));
 
       if (tmp.get() == nullptr) {
         break;
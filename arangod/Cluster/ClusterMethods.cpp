@@ -442,6 +442,11 @@ int figuresOnCoordinator (string const& dbname,
             result->_journalfileSize      += ExtractFigure<int64_t>(figures, "journals", "fileSize");
             result->_compactorfileSize    += ExtractFigure<int64_t>(figures, "compactors", "fileSize");
             result->_shapefileSize        += ExtractFigure<int64_t>(figures, "shapefiles", "fileSize");
+
+            result->_lockReadWaits        += ExtractFigure<uint64_t>(figures, "locks", "readWaits");
+            result->_lockWriteWaits       += ExtractFigure<uint64_t>(figures, "locks", "writeWaits");
+            result->_lockReadWaitTime     += ExtractFigure<double>(figures, "locks", "readWaitTime");
+            result->_lockWriteWaitTime    += ExtractFigure<double>(figures, "locks", "writeWaitTime");
           }
           nrok++;
         }
@@ -199,6 +199,42 @@ bool Dispatcher::cancelJob (uint64_t jobId) {
   return done;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a short job of another queue for an idle thread
+////////////////////////////////////////////////////////////////////////////////
+
+DispatcherQueue* Dispatcher::stealJob (DispatcherQueue* thief, Job*& job) {
+  if (_stopping.load(memory_order_relaxed)) {
+    return nullptr;
+  }
+
+  // the list of queues is only changed during initialization
+  for (size_t i = 0;  i < _queues.size();  ++i) {
+    DispatcherQueue* queue = _queues[i];
+
+    if (queue != nullptr && queue != thief && queue->stealJob(job)) {
+      return queue;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up a waiting thread of another queue to take a short job
+////////////////////////////////////////////////////////////////////////////////
+
+void Dispatcher::wakeUpIdleThread (DispatcherQueue* busy) {
+  for (size_t i = 0;  i < _queues.size();  ++i) {
+    DispatcherQueue* queue = _queues[i];
+
+    if (queue != nullptr && queue != busy && 0 < queue->_nrWaiting) {
+      queue->_waitLock.signal();
+      return;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief begins shutdown process
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +82,30 @@ namespace triagens {
 
         static const size_t SYSTEM_QUEUE_SIZE = 2;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lane for short jobs, such as single document operations
+///
+/// the jobs of this lane are run before the jobs of the long lane, and idle
+/// threads of other queues help to run them
+////////////////////////////////////////////////////////////////////////////////
+
+        static const size_t SHORT_LANE = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lane for all other jobs
+///
+/// the jobs of this lane never occupy the last thread of a queue, so a short
+/// job does not wait for a long-running one to finish
+////////////////////////////////////////////////////////////////////////////////
+
+        static const size_t LONG_LANE = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of lanes
+////////////////////////////////////////////////////////////////////////////////
+
+        static const size_t LANE_SIZE = 2;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -155,6 +179,20 @@ namespace triagens {
 
         bool cancelJob (uint64_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a short job of another queue for an idle thread
+///
+/// returns the queue the job belongs to, or nullptr if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        DispatcherQueue* stealJob (DispatcherQueue* thief, Job*& job);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up a waiting thread of another queue to take a short job
+////////////////////////////////////////////////////////////////////////////////
+
+        void wakeUpIdleThread (DispatcherQueue* busy);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief begins shutdown process
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,7 +57,7 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _nrThreads(nrThreads),
     _maxSize(maxSize),
     _waitLock(),
-    _readyJobs(maxSize),
+    _readyJobs(),
     _hazardLock(),
     _hazardPointer(nullptr),
     _stopping(false),
@@ -67,6 +67,7 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _nrRunning(0),
     _nrWaiting(0),
     _nrBlocked(0),
+    _nrLongRunning(0),
     _lastChanged(0.0),
     _gracePeriod(5.0),
     _scheduler(scheduler),
@@ -77,6 +78,10 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _jobs(),
     _jobPositions(_maxSize) {
 
+  for (size_t i = 0;  i < Dispatcher::LANE_SIZE;  ++i) {
+    _readyJobs[i] = new boost::lockfree::queue<Job*>(maxSize);
+  }
+
   // keep a list of all jobs
   _jobs = new atomic<Job*>[maxSize];
 
@@ -94,6 +99,10 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
 DispatcherQueue::~DispatcherQueue () {
   beginShutdown();
   delete[] _jobs;
+
+  for (size_t i = 0;  i < Dispatcher::LANE_SIZE;  ++i) {
+    delete _readyJobs[i];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -122,9 +131,17 @@ int DispatcherQueue::addJob (Job* job) {
 
   // set the position inside the job
   job->setQueuePosition(pos);
+  job->setQueueStart(TRI_microtime());
+  job->setDispatcherQueue(this);
+
+  size_t lane = job->lane();
+
+  if (lane >= Dispatcher::LANE_SIZE) {
+    lane = Dispatcher::LONG_LANE;
+  }
 
-  // add the job to the list of ready jobs
-  bool ok = _readyJobs.push(job);
+  // add the job to the list of ready jobs of its lane
+  bool ok = _readyJobs[lane]->push(job);
 
   if (! ok) {
     LOG_WARNING("cannot insert job into ready queue, giving up");
@@ -145,6 +162,12 @@ int DispatcherQueue::addJob (Job* job) {
     startQueueThread();
   }
 
+  // all our threads are busy, let an idle thread of another queue take a
+  // short job
+  else if (lane == Dispatcher::SHORT_LANE) {
+    _dispatcher->wakeUpIdleThread(this);
+  }
+
   return TRI_ERROR_NO_ERROR;
 }
 
@@ -254,10 +277,10 @@ void DispatcherQueue::beginShutdown () {
   _stopping = true;
   
   // kill all jobs in the queue
-  {
+  for (size_t i = 0;  i < Dispatcher::LANE_SIZE;  ++i) {
     Job* job = nullptr;
     
-    while(_readyJobs.pop(job)) {
+    while(_readyJobs[i]->pop(job)) {
       if (job != nullptr) {
         try {
           job->cancel();
@@ -494,6 +517,77 @@ void DispatcherQueue::deleteOldThreads () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes the next job for a thread of this queue
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::popJob (Job*& job, size_t& lane) {
+  if (_readyJobs[Dispatcher::SHORT_LANE]->pop(job)) {
+    lane = Dispatcher::SHORT_LANE;
+    return true;
+  }
+
+  // reserve a thread for the long job first, so that concurrent threads
+  // cannot exceed the limit together
+  if (++_nrLongRunning <= longJobLimit()) {
+    if (_readyJobs[Dispatcher::LONG_LANE]->pop(job)) {
+      lane = Dispatcher::LONG_LANE;
+      return true;
+    }
+  }
+
+  --_nrLongRunning;
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a short job for an idle thread of another queue
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::stealJob (Job*& job) {
+  if (_stopping.load(memory_order_relaxed)) {
+    return false;
+  }
+
+  return _readyJobs[Dispatcher::SHORT_LANE]->pop(job);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called when a job taken by popJob is done
+////////////////////////////////////////////////////////////////////////////////
+
+void DispatcherQueue::finishJob (size_t lane) {
+  if (lane == Dispatcher::LONG_LANE) {
+    --_nrLongRunning;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if there are jobs a thread of this queue may take
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::hasReadyJobs () {
+  if (! _readyJobs[Dispatcher::SHORT_LANE]->empty()) {
+    return true;
+  }
+
+  return _nrLongRunning.load() < longJobLimit() &&
+         ! _readyJobs[Dispatcher::LONG_LANE]->empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads long jobs may occupy
+///
+/// one thread is kept free for short jobs. blocked threads are replaced by
+/// new ones, so they do not count
+////////////////////////////////////////////////////////////////////////////////
+
+ssize_t DispatcherQueue::longJobLimit () const {
+  ssize_t limit = (ssize_t) _nrThreads + _nrBlocked.load(memory_order_relaxed) - 1;
+
+  return (limit < 1 ? 1 : limit);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
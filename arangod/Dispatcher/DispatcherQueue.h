@@ -175,6 +175,40 @@ namespace triagens {
 
       void deleteOldThreads ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes the next job for a thread of this queue
+///
+/// short jobs are taken first. a long job is only taken if it does not
+/// occupy the last thread of the queue. the caller must call finishJob
+/// when the job is done
+////////////////////////////////////////////////////////////////////////////////
+
+      bool popJob (Job*& job, size_t& lane);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a short job for an idle thread of another queue
+////////////////////////////////////////////////////////////////////////////////
+
+      bool stealJob (Job*& job);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called when a job taken by popJob is done
+////////////////////////////////////////////////////////////////////////////////
+
+      void finishJob (size_t lane);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if there are jobs a thread of this queue may take
+////////////////////////////////////////////////////////////////////////////////
+
+      bool hasReadyJobs ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads long jobs may occupy
+////////////////////////////////////////////////////////////////////////////////
+
+      ssize_t longJobLimit () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -210,10 +244,10 @@ namespace triagens {
         basics::ConditionVariable _waitLock;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief list of ready jobs
+/// @brief lists of ready jobs, one per lane
 ////////////////////////////////////////////////////////////////////////////////
 
-        boost::lockfree::queue<Job*> _readyJobs;
+        boost::lockfree::queue<Job*>* _readyJobs[Dispatcher::LANE_SIZE];
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief guard for hazard pointer
@@ -289,6 +323,14 @@ namespace triagens {
 
         std::atomic<ssize_t> _nrBlocked;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads of this queue running a long job
+///
+/// This variable is accessed using "memory_order_seq_cst".
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<ssize_t> _nrLongRunning;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief last time we created or deleted a queue thread
 ///
@@ -40,6 +40,7 @@
 #include "Dispatcher/Job.h"
 #include "Dispatcher/RequeueTask.h"
 #include "Scheduler/Scheduler.h"
+#include "Statistics/statistics.h"
 
 using namespace std;
 using namespace triagens::basics;
@@ -74,7 +75,8 @@ DispatcherThread::DispatcherThread (DispatcherQueue* queue)
             ? std::string("_std")
             : (queue->_id == Dispatcher::AQL_QUEUE 
                ? std::string("_aql") : ("_" + to_string(queue->_id))))),
-    _queue(queue) {
+    _queue(queue),
+    _job(nullptr) {
 
   allowAsynchronousCancelation();
 }
@@ -99,16 +101,32 @@ void DispatcherThread::run () {
     // drain the job queue
     {
       Job* job = nullptr;
+      size_t lane;
 
-      while (_queue->_readyJobs.pop(job)) {
+      while (_queue->popJob(job, lane)) {
         if (job != nullptr) {
           worked = now;
-          handleJob(job);
+          handleJob(job, _queue, lane);
         }
+
+        _queue->finishJob(lane);
+      }
+
+      // our queue has nothing to do for us, help the other queues with their
+      // short jobs
+      DispatcherQueue* owner = _queue->_dispatcher->stealJob(_queue, job);
+
+      if (owner != nullptr) {
+        if (job != nullptr) {
+          worked = now;
+          handleJob(job, owner, Dispatcher::SHORT_LANE);
+        }
+
+        continue;
       }
 
       // we need to check again if more work has arrived after we have
-      // aquired the lock. The lockfree queue and _nrWaiting are accessed
+      // aquired the lock. The lockfree queues and _nrWaiting are accessed
       // using "memory_order_seq_cst", this guaranties that we do not
       // miss a signal.
 
@@ -117,7 +135,7 @@ void DispatcherThread::run () {
 
         CONDITION_LOCKER(guard, _queue->_waitLock);
 
-        if (! _queue->_readyJobs.empty()) {
+        if (_queue->hasReadyJobs()) {
           --_queue->_nrWaiting;
           continue;
         }
@@ -156,7 +174,7 @@ void DispatcherThread::run () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void DispatcherThread::block () {
-  _queue->blockThread();
+  runningQueue()->blockThread();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -164,22 +182,39 @@ void DispatcherThread::block () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void DispatcherThread::unblock () {
-  _queue->unblockThread();
+  runningQueue()->unblockThread();
 }
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the queue of the running job
+////////////////////////////////////////////////////////////////////////////////
+
+DispatcherQueue* DispatcherThread::runningQueue () const {
+  if (_job == nullptr || _job->dispatcherQueue() == nullptr) {
+    return _queue;
+  }
+
+  return _job->dispatcherQueue();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief do the real work
 ////////////////////////////////////////////////////////////////////////////////
 
-void DispatcherThread::handleJob (Job* job) {
+void DispatcherThread::handleJob (Job* job, DispatcherQueue* queue, size_t lane) {
 
   // set running job
   LOG_DEBUG("starting to run job: %s", job->getName().c_str());
 
+  double const waited = TRI_microtime() - job->queueStart();
+
+  TRI_DispatcherQueueWaitStatistics(job->getName(), waited);
+  TRI_DispatcherLaneWaitStatistics(lane, waited);
+
   // do the work (this might change the job type)
   Job::status_t status(Job::JOB_FAILED);
 
@@ -187,6 +222,7 @@ void DispatcherThread::handleJob (Job* job) {
     RequestStatisticsAgentSetQueueEnd(job);
 
     // set current thread
+    _job = job;
     job->setDispatcherThread(this);
 
     // and do all the dirty work
@@ -255,23 +291,25 @@ void DispatcherThread::handleJob (Job* job) {
     status = Job::status_t(Job::JOB_FAILED);
   }
 
+  _job = nullptr;
+
   // finish jobs
   try {
     job->setDispatcherThread(nullptr);
 
     if (status.status == Job::JOB_DONE || status.status == Job::JOB_FAILED) {
-      job->cleanup(_queue);
+      job->cleanup(queue);
     }
     else if (status.status == Job::JOB_REQUEUE) {
       if (0.0 < status.sleep) {
-        _queue->_scheduler->registerTask(
-          new RequeueTask(_queue->_scheduler,
-                          _queue->_dispatcher,
+        queue->_scheduler->registerTask(
+          new RequeueTask(queue->_scheduler,
+                          queue->_dispatcher,
                           status.sleep,
                           job));
       }
       else {
-        _queue->_dispatcher->addJob(job);
+        queue->_dispatcher->addJob(job);
       }
     }
   }
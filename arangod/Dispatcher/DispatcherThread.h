@@ -103,6 +103,9 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief indicates that thread is doing a blocking operation
+///
+/// the blocked thread is accounted for in the queue of the running job, so
+/// a stolen job lets its own queue start another thread
 ////////////////////////////////////////////////////////////////////////////////
 
         void block ();
@@ -119,9 +122,18 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief do the real work
+///
+/// the job belongs to the given queue, which is another queue than the one
+/// of the thread if the job was stolen
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleJob (Job* job, DispatcherQueue* queue, size_t lane);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the queue of the running job
 ////////////////////////////////////////////////////////////////////////////////
 
-        void handleJob (Job* job);
+        DispatcherQueue* runningQueue () const;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -134,6 +146,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         DispatcherQueue* _queue;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the job currently running, or nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+        Job* _job;
     };
   }
 }
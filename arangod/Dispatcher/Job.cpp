@@ -46,7 +46,9 @@ using namespace std;
 Job::Job (string const& name)
   : _name(name),
     _id(0),
-    _queuePosition((size_t) -1) {
+    _queuePosition((size_t) -1),
+    _queueStart(0.0),
+    _dispatcherQueue(nullptr) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +70,14 @@ size_t Job::queue () const {
   return Dispatcher::STANDARD_QUEUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane to use within the queue
+////////////////////////////////////////////////////////////////////////////////
+
+size_t Job::lane () const {
+  return Dispatcher::LONG_LANE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,7 +119,7 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief gets the name
-/// Note: currently unused
+/// the wait statistics of the dispatcher queues are kept by job name
 ////////////////////////////////////////////////////////////////////////////////
 
         virtual const std::string& getName () const {
@@ -160,6 +160,40 @@ namespace triagens {
           return _queuePosition;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the time the job was put into a queue
+////////////////////////////////////////////////////////////////////////////////
+
+        void setQueueStart (double start) {
+          _queueStart = start;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the time the job was put into a queue
+////////////////////////////////////////////////////////////////////////////////
+
+        double queueStart () const {
+          return _queueStart;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the queue the job was added to
+////////////////////////////////////////////////////////////////////////////////
+
+        void setDispatcherQueue (DispatcherQueue* queue) {
+          _dispatcherQueue = queue;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the queue the job was added to
+///
+/// this is not the queue of the running thread if the job was stolen
+////////////////////////////////////////////////////////////////////////////////
+
+        DispatcherQueue* dispatcherQueue () const {
+          return _dispatcherQueue;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            virtual public methods
 // -----------------------------------------------------------------------------
@@ -172,6 +206,12 @@ namespace triagens {
 
         virtual size_t queue () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane to use within the queue
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual size_t lane () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -225,6 +265,18 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t _queuePosition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time the job was put into a queue
+////////////////////////////////////////////////////////////////////////////////
+
+        double _queueStart;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queue the job was added to
+////////////////////////////////////////////////////////////////////////////////
+
+        DispatcherQueue* _dispatcherQueue;
     };
   }
 }
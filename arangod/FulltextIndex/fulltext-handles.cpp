@@ -51,6 +51,7 @@
 static void FreeSlot (TRI_fulltext_handle_slot_t* slot) {
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_documents);
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_deleted);
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_lengths);
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot);
 }
 
@@ -89,6 +90,16 @@ static bool AllocateSlot (TRI_fulltext_handles_t* const handles,
     return false;
   }
 
+  // allocate and clear document lengths
+  slot->_lengths = static_cast<uint16_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(uint16_t) * handles->_slotSize, true));
+
+  if (slot->_lengths == nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_deleted);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_documents);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot);
+    return false;
+  }
+
   // set initial statistics
   slot->_min        = UINT32_MAX; // yes, this is intentional
   slot->_max        = 0;
@@ -164,8 +175,9 @@ TRI_fulltext_handles_t* TRI_CreateHandlesFulltextIndex (const uint32_t slotSize)
     return nullptr;
   }
 
-  handles->_numDeleted = 0;
-  handles->_next       = 1;
+  handles->_numDeleted  = 0;
+  handles->_totalLength = 0;
+  handles->_next        = 1;
 
   handles->_slotSize   = slotSize;
   handles->_numSlots   = 0;
@@ -220,6 +232,20 @@ uint32_t TRI_NumDeletedHandleFulltextIndex (TRI_fulltext_handles_t* const handle
   return handles->_numDeleted;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the average number of words of non-deleted documents
+////////////////////////////////////////////////////////////////////////////////
+
+double TRI_AverageLengthHandleFulltextIndex (TRI_fulltext_handles_t* const handles) {
+  uint32_t numDocuments = (handles->_next - 1) - handles->_numDeleted;
+
+  if (numDocuments == 0) {
+    return 0.0;
+  }
+
+  return ((double) handles->_totalLength / (double) numDocuments);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get handle list deletion grade
 ////////////////////////////////////////////////////////////////////////////////
@@ -283,7 +309,7 @@ TRI_fulltext_handles_t* TRI_CompactHandleFulltextIndex (TRI_fulltext_handles_t*
       else {
         // printf("- setting map at #%lu to %lu\n", (unsigned long) j, (unsigned long) targetHandle);
         map[originalHandle++] = targetHandle++;
-        TRI_InsertHandleFulltextIndex(clone, originalSlot->_documents[j]);
+        TRI_InsertHandleFulltextIndex(clone, originalSlot->_documents[j], originalSlot->_lengths[j]);
       }
     }
   }
@@ -298,7 +324,8 @@ TRI_fulltext_handles_t* TRI_CompactHandleFulltextIndex (TRI_fulltext_handles_t*
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_handle_t TRI_InsertHandleFulltextIndex (TRI_fulltext_handles_t* const handles,
-                                                     const TRI_fulltext_doc_t document) {
+                                                     const TRI_fulltext_doc_t document,
+                                                     uint32_t length) {
   TRI_fulltext_handle_t handle;
   TRI_fulltext_handle_slot_t* slot;
   uint32_t slotNumber;
@@ -332,9 +359,15 @@ TRI_fulltext_handle_t TRI_InsertHandleFulltextIndex (TRI_fulltext_handles_t* con
 
   slot = handles->_slots[slotNumber];
 
+  if (length > UINT16_MAX) {
+    length = UINT16_MAX;
+  }
+
   // fill in document
   slot->_documents[slotPosition] = document;
+  slot->_lengths[slotPosition]   = (uint16_t) length;
   slot->_numUsed++;
+  handles->_totalLength += length;
   // no need to fill in deleted flag as it is initialized to false
 
   if (document > slot->_max) {
@@ -380,6 +413,7 @@ bool TRI_DeleteDocumentHandleFulltextIndex (TRI_fulltext_handles_t* const handle
         slot->_documents[j] = 0;
         slot->_numDeleted++;
         handles->_numDeleted++;
+        handles->_totalLength -= slot->_lengths[j];
         return true;
       }
     }
@@ -417,6 +451,18 @@ TRI_fulltext_doc_t TRI_GetDocumentFulltextIndex (const TRI_fulltext_handles_t* c
   return slot->_documents[slotPosition];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the number of words of the document for a handle
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_GetLengthFulltextIndex (const TRI_fulltext_handles_t* const handles,
+                                     const TRI_fulltext_handle_t handle) {
+  uint32_t slotNumber = handle / handles->_slotSize;
+  uint32_t slotPosition = handle % handles->_slotSize;
+
+  return handles->_slots[slotNumber]->_lengths[slotPosition];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dump all handles
 ////////////////////////////////////////////////////////////////////////////////
@@ -459,7 +505,7 @@ size_t TRI_MemoryHandleFulltextIndex (const TRI_fulltext_handles_t* const handle
 
   numSlots = handles->_numSlots;
 
-  perSlot = (sizeof(TRI_fulltext_doc_t) + sizeof(uint8_t)) * handles->_slotSize;
+  perSlot = (sizeof(TRI_fulltext_doc_t) + sizeof(uint8_t) + sizeof(uint16_t)) * handles->_slotSize;
 
   // slots list
   memory =  sizeof(TRI_fulltext_handle_slot_t*) * numSlots;
@@ -89,6 +89,7 @@ typedef struct TRI_fulltext_handle_slot_s {
   TRI_fulltext_doc_t           _max;         // maximum handle value in slot
   TRI_fulltext_doc_t*          _documents;   // document ids for the slots
   uint8_t*                     _deleted;     // deleted flags for the slots
+  uint16_t*                    _lengths;     // number of words of the documents
 }
 TRI_fulltext_handle_slot_t;
 
@@ -102,6 +103,8 @@ typedef struct TRI_fulltext_handles_s {
   TRI_fulltext_handle_slot_t** _slots;       // pointers to slots
   uint32_t                     _slotSize;    // the size of each slot
   uint32_t                     _numDeleted;  // total number of deleted documents
+  uint64_t                     _totalLength; // total number of words of all
+                                             // non-deleted documents
   TRI_fulltext_handle_t*       _map;         // a temporary map for remapping existing
                                              // handles to new handles during compaction
 }
@@ -139,6 +142,12 @@ uint32_t TRI_NumHandlesHandleFulltextIndex (TRI_fulltext_handles_t* const);
 
 uint32_t TRI_NumDeletedHandleFulltextIndex (TRI_fulltext_handles_t* const);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the average number of words of non-deleted documents
+////////////////////////////////////////////////////////////////////////////////
+
+double TRI_AverageLengthHandleFulltextIndex (TRI_fulltext_handles_t* const);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get handle list fill grade
 ////////////////////////////////////////////////////////////////////////////////
@@ -162,7 +171,8 @@ TRI_fulltext_handles_t* TRI_CompactHandleFulltextIndex (TRI_fulltext_handles_t*
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_handle_t TRI_InsertHandleFulltextIndex (TRI_fulltext_handles_t* const,
-                                                     const TRI_fulltext_doc_t);
+                                                     const TRI_fulltext_doc_t,
+                                                     uint32_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief mark a document as deleted in the handle list
@@ -178,6 +188,13 @@ bool TRI_DeleteDocumentHandleFulltextIndex (TRI_fulltext_handles_t* const,
 TRI_fulltext_doc_t TRI_GetDocumentFulltextIndex (const TRI_fulltext_handles_t* const,
                                                  const TRI_fulltext_handle_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the number of words of the document for a handle
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_GetLengthFulltextIndex (const TRI_fulltext_handles_t* const,
+                                     const TRI_fulltext_handle_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dump all handles
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,8 +29,10 @@
 
 #include "fulltext-index.h"
 
+#include "Basics/hashes.h"
 #include "Basics/locks.h"
 #include "Basics/logging.h"
+#include "Basics/ThreadPool.h"
 
 #include "fulltext-handles.h"
 #include "fulltext-list.h"
@@ -38,6 +40,12 @@
 #include "fulltext-result.h"
 #include "fulltext-wordlist.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private defines
 // -----------------------------------------------------------------------------
@@ -55,6 +63,18 @@
 
 #define MAX_WORD_BYTES ((TRI_FULLTEXT_MAX_WORD_LENGTH) * 4)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief BM25 term frequency saturation parameter
+////////////////////////////////////////////////////////////////////////////////
+
+#define BM25_K1 1.2
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief BM25 document length normalisation parameter
+////////////////////////////////////////////////////////////////////////////////
+
+#define BM25_B 0.75
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
@@ -96,11 +116,15 @@ typedef void followers_t;
 /// - uint32_t numAllocated: number of handles allocated for the node
 /// - unit32_t numEntries: number of handles currently in use
 /// - TRI_fulltext_handle_t* handles: all the handle values subsequently
+/// - uint8_t* frequencies: the number of occurrences of the node's word in
+///   the documents, in the same order as the handles
 /// Note that the highest bit of the numAllocated value contains a flag whether
-/// the handles list is sorted or not. It is therefore not safe to access the
-/// properties directly, but instead always the special functions provided in
-/// fulltext-list.c must be used. These provide access to the individual values
-/// at relatively low cost
+/// the handles list is sorted or not. The second highest bit indicates that
+/// the list has grown big and has been converted into compressed form, with
+/// the handles stored as delta-encoded blocks plus skip entries. It is
+/// therefore not safe to access the properties directly, but instead always
+/// the special functions provided in fulltext-list.cpp must be used. These
+/// provide access to the individual values at relatively low cost
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef struct node_s {
@@ -133,6 +157,19 @@ typedef struct {
 }
 index_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a word occurrence during a batch insert. position is the position
+/// of the document in the batch
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  uint64_t                _prefix;      // first bytes of the word, big-endian
+  char const*             _word;
+  size_t                  _position;
+  uint32_t                _frequency;
+}
+batch_entry_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                          forwards
 // -----------------------------------------------------------------------------
@@ -702,7 +739,11 @@ static bool CleanupNodes (index_t* idx,
   if (node->_handles != nullptr) {
     uint32_t remain;
 
+    // the rewrite might change the memory usage of compressed lists
+    idx->_memoryAllocated -= TRI_MemoryListFulltextIndex(node->_handles);
     remain = TRI_RewriteListFulltextIndex(node->_handles, map);
+    idx->_memoryAllocated += TRI_MemoryListFulltextIndex(node->_handles);
+
     if (remain > 0) {
       // there are still handles left in the rewritten handles list
       // we must keep this node
@@ -1100,7 +1141,8 @@ static node_t* EnsureSubNode (index_t* const idx,
 
 static bool InsertHandle (index_t* const idx,
                           node_t* const node,
-                          const TRI_fulltext_handle_t handle) {
+                          const TRI_fulltext_handle_t handle,
+                          const uint32_t frequency) {
   TRI_fulltext_list_t* list;
   TRI_fulltext_list_t* oldList;
   size_t oldAlloc;
@@ -1127,18 +1169,20 @@ static bool InsertHandle (index_t* const idx,
   oldAlloc = TRI_MemoryListFulltextIndex(oldList);
 
   // adding to the list might change the list pointer!
-  list = TRI_InsertListFulltextIndex(node->_handles, handle);
+  list = TRI_InsertListFulltextIndex(node->_handles, handle, frequency);
   if (list == nullptr) {
-    // out of memory
+    // out of memory. the old list is still valid, but a compressed list
+    // might have grown its blocks before failing
+    idx->_memoryAllocated += TRI_MemoryListFulltextIndex(oldList);
+    idx->_memoryAllocated -= oldAlloc;
     return false;
   }
 
-  if (list != oldList) {
-    // the insert might have changed the pointer
-    node->_handles = list;
-    idx->_memoryAllocated += TRI_MemoryListFulltextIndex(list);
-    idx->_memoryAllocated -= oldAlloc;
-  }
+  // the insert might have changed the pointer, and compressed lists grow
+  // in place
+  node->_handles = list;
+  idx->_memoryAllocated += TRI_MemoryListFulltextIndex(list);
+  idx->_memoryAllocated -= oldAlloc;
 
   return true;
 }
@@ -1230,6 +1274,607 @@ TRI_fulltext_result_t* FindDocuments (index_t* const idx,
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evaluate the boolean operations of a query
+/// returns the list of matching handles. the caller must hold the read lock
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_fulltext_list_t* EvaluateQuery (index_t* const idx,
+                                           TRI_fulltext_query_t const* query,
+                                           std::vector<node_t*> const& nodes,
+                                           std::vector<size_t> const& order) {
+  TRI_fulltext_list_t* result;
+
+  // initial result is empty
+  result = nullptr;
+
+  // iterate over all words in query
+  for (size_t n = 0; n < order.size(); ++n) {
+    TRI_fulltext_query_match_e match;
+    TRI_fulltext_query_operation_e operation;
+    TRI_fulltext_list_t* list;
+    node_t* node;
+    size_t i;
+
+    i = order[n];
+
+    match     = query->_matches[i];
+    operation = query->_operations[i];
+    node      = nodes[i];
+
+    LOG_DEBUG("searching for word: '%s'", query->_words[i]);
+
+    if ((operation == TRI_FULLTEXT_AND || operation == TRI_FULLTEXT_EXCLUDE) &&
+        n > 0 && 
+        TRI_NumEntriesListFulltextIndex(result) == 0) {
+      // current result set is empty so logical AND or EXCLUDE will not have any result either
+      continue;
+    }
+
+    if (match == TRI_FULLTEXT_COMPLETE && 
+        result != nullptr &&
+        (operation == TRI_FULLTEXT_AND || operation == TRI_FULLTEXT_EXCLUDE)) {
+      // the node's handles can be used directly without copying them
+      TRI_fulltext_list_t const* stored = (node == nullptr ? nullptr : node->_handles);
+
+      if (operation == TRI_FULLTEXT_AND) {
+        if (stored == nullptr) {
+          TRI_FreeListFulltextIndex(result);
+          result = TRI_CreateListFulltextIndex(0);
+        }
+        else {
+          result = TRI_IntersectStoredListFulltextIndex(result, stored);
+        }
+      }
+      else {
+        result = TRI_ExcludeStoredListFulltextIndex(result, stored);
+      }
+
+      if (result == nullptr) {
+        // out of memory
+        break;
+      }
+
+      continue;
+    }
+
+    list = nullptr;
+    if (node != nullptr) {
+      if (match == TRI_FULLTEXT_COMPLETE) {
+        // complete matching
+        list = GetDirectNodeHandles(node);
+      }
+      else if (match == TRI_FULLTEXT_PREFIX) {
+        // prefix matching
+        list = GetSubNodeHandles(node);
+      }
+      else {
+        LOG_WARNING("invalid matching option for fulltext index query");
+        list = TRI_CreateListFulltextIndex(0);
+      }
+    }
+    else {
+      list = TRI_CreateListFulltextIndex(0);
+    }
+
+    if (operation == TRI_FULLTEXT_AND) {
+      // perform a logical AND of current and previous result (if any)
+      result = TRI_IntersectListFulltextIndex(result, list);
+    }
+    else if (operation == TRI_FULLTEXT_OR) {
+      // perform a logical OR of current and previous result (if any)
+      result = TRI_UnioniseListFulltextIndex(result, list);
+    }
+    else if (operation == TRI_FULLTEXT_EXCLUDE) {
+      // perform a logical exclusion of current from previous result (if any)
+      result = TRI_ExcludeListFulltextIndex(result, list);
+    }
+
+    if (result == nullptr) {
+      // out of memory
+      break;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a search word of a ranked query
+////////////////////////////////////////////////////////////////////////////////
+
+struct ranked_term_t {
+  TRI_fulltext_list_t const* _list;      // handles of the word
+  TRI_fulltext_list_t*       _owned;     // collected handles of a prefix match
+  double                     _idf;       // inverse document frequency
+  double                     _maxScore;  // upper bound for the word's score
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the currently best results of a ranked query
+///
+/// this is a min-heap of at most maxResults (score, handle) pairs. a document
+/// can only enter the heap if its score is greater than the threshold, which
+/// is the lowest score in the heap once the heap is full
+////////////////////////////////////////////////////////////////////////////////
+
+class TopResults {
+
+  public:
+
+    explicit TopResults (size_t maxResults) 
+      : _maxResults(maxResults) {
+    }
+
+    inline bool full () const {
+      return _heap.size() >= _maxResults;
+    }
+
+    inline double threshold () const {
+      return full() ? _heap.front().first : -1.0;
+    }
+
+    void add (double score, TRI_fulltext_handle_t handle) {
+      if (! full()) {
+        _heap.emplace_back(score, handle);
+        std::push_heap(_heap.begin(), _heap.end(), Compare);
+      }
+      else if (score > _heap.front().first) {
+        std::pop_heap(_heap.begin(), _heap.end(), Compare);
+        _heap.back() = std::make_pair(score, handle);
+        std::push_heap(_heap.begin(), _heap.end(), Compare);
+      }
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the results, ordered by descending score
+/// documents with equal scores are returned in insertion order
+////////////////////////////////////////////////////////////////////////////////
+
+    std::vector<std::pair<double, TRI_fulltext_handle_t>>& sorted () {
+      std::sort(_heap.begin(), _heap.end(), [] (std::pair<double, TRI_fulltext_handle_t> const& lhs,
+                                                std::pair<double, TRI_fulltext_handle_t> const& rhs) {
+        if (lhs.first != rhs.first) {
+          return lhs.first > rhs.first;
+        }
+        return lhs.second < rhs.second;
+      });
+
+      return _heap;
+    }
+
+  private:
+
+    static bool Compare (std::pair<double, TRI_fulltext_handle_t> const& lhs,
+                         std::pair<double, TRI_fulltext_handle_t> const& rhs) {
+      if (lhs.first != rhs.first) {
+        return lhs.first > rhs.first;
+      }
+      // among equal scores, the most recent handle is evicted first
+      return lhs.second < rhs.second;
+    }
+
+  private:
+
+    size_t const _maxResults;
+
+    std::vector<std::pair<double, TRI_fulltext_handle_t>> _heap;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calculate the BM25 score of a word in a document
+////////////////////////////////////////////////////////////////////////////////
+
+static inline double Bm25Score (double idf,
+                                uint32_t frequency,
+                                double lengthNorm) {
+  return idf * ((double) frequency * (BM25_K1 + 1.0)) / ((double) frequency + lengthNorm);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calculate the BM25 length normalisation for a document
+////////////////////////////////////////////////////////////////////////////////
+
+static inline double Bm25LengthNorm (index_t const* idx,
+                                     TRI_fulltext_handle_t handle,
+                                     double averageLength) {
+  if (averageLength <= 0.0) {
+    return BM25_K1;
+  }
+
+  double length = (double) TRI_GetLengthFulltextIndex(idx->_handles, handle);
+
+  return BM25_K1 * (1.0 - BM25_B + BM25_B * length / averageLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rank all documents matching all words (logical AND)
+///
+/// the lists of all words are traversed in parallel, starting with the word
+/// with the fewest documents. documents not contained in all lists are
+/// skipped using the lists' skip entries
+////////////////////////////////////////////////////////////////////////////////
+
+static void RankConjunction (index_t const* idx,
+                             std::vector<ranked_term_t> const& terms,
+                             double averageLength,
+                             TopResults& top) {
+  std::vector<TRI_fulltext_list_iterator_t> iterators;
+  iterators.reserve(terms.size());
+
+  double maxScore = 0.0;
+
+  for (auto const& term : terms) {
+    iterators.emplace_back(term._list);
+    maxScore += term._maxScore;
+  }
+
+  size_t const n = iterators.size();
+  TRI_fulltext_list_iterator_t& lead = iterators[0];
+
+  while (lead.valid()) {
+    if (top.full() && maxScore <= top.threshold()) {
+      // no document can make it into the result anymore
+      return;
+    }
+
+    TRI_fulltext_handle_t handle = lead.value();
+    TRI_fulltext_handle_t next = handle;
+
+    for (size_t j = 1; j < n; ++j) {
+      iterators[j].seek(handle);
+
+      if (! iterators[j].valid()) {
+        return;
+      }
+
+      if (iterators[j].value() != handle) {
+        next = iterators[j].value();
+        break;
+      }
+    }
+
+    if (next != handle) {
+      lead.seek(next);
+      continue;
+    }
+
+    if (TRI_GetDocumentFulltextIndex(idx->_handles, handle) != 0) {
+      double lengthNorm = Bm25LengthNorm(idx, handle, averageLength);
+      double score = 0.0;
+
+      for (size_t j = 0; j < n; ++j) {
+        score += Bm25Score(terms[j]._idf, iterators[j].frequency(), lengthNorm);
+      }
+
+      top.add(score, handle);
+    }
+
+    lead.next();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rank all documents matching any of the words (logical OR)
+///
+/// this uses the WAND algorithm: the lists are ordered by their current
+/// handles, and the first handle at which the sum of the maximum scores of
+/// the preceding lists exceeds the current threshold is the pivot. all
+/// handles before the pivot cannot make it into the result and are skipped
+////////////////////////////////////////////////////////////////////////////////
+
+static void RankDisjunction (index_t const* idx,
+                             std::vector<ranked_term_t> const& terms,
+                             double averageLength,
+                             TopResults& top) {
+  std::vector<TRI_fulltext_list_iterator_t> iterators;
+  iterators.reserve(terms.size());
+
+  for (auto const& term : terms) {
+    iterators.emplace_back(term._list);
+  }
+
+  size_t const n = iterators.size();
+  std::vector<size_t> positions;
+  std::vector<double> contributions(n, 0.0);
+
+  for (size_t j = 0; j < n; ++j) {
+    positions.emplace_back(j);
+  }
+
+  while (true) {
+    // order the lists by their current handles. exhausted lists go last
+    std::sort(positions.begin(), positions.end(), [&] (size_t lhs, size_t rhs) {
+      if (! iterators[lhs].valid()) {
+        return false;
+      }
+      if (! iterators[rhs].valid()) {
+        return true;
+      }
+      return iterators[lhs].value() < iterators[rhs].value();
+    });
+
+    // find the pivot
+    double const threshold = top.threshold();
+    double accumulated = 0.0;
+    size_t pivot = n;
+
+    for (size_t p = 0; p < n && iterators[positions[p]].valid(); ++p) {
+      accumulated += terms[positions[p]]._maxScore;
+
+      if (accumulated > threshold) {
+        pivot = p;
+        break;
+      }
+    }
+
+    if (pivot == n) {
+      // no document can make it into the result anymore
+      return;
+    }
+
+    TRI_fulltext_handle_t handle = iterators[positions[pivot]].value();
+
+    if (iterators[positions[0]].value() != handle) {
+      // skip all lists before the pivot to the pivot handle
+      for (size_t p = 0; p < pivot; ++p) {
+        iterators[positions[p]].seek(handle);
+      }
+      continue;
+    }
+
+    // all lists up to the pivot point to the pivot handle. score it
+    bool const exists = (TRI_GetDocumentFulltextIndex(idx->_handles, handle) != 0);
+    double const lengthNorm = (exists ? Bm25LengthNorm(idx, handle, averageLength) : 0.0);
+
+    for (size_t p = 0; p < n; ++p) {
+      size_t const j = positions[p];
+      TRI_fulltext_list_iterator_t& it = iterators[j];
+
+      if (! it.valid() || it.value() != handle) {
+        break;
+      }
+
+      if (exists) {
+        contributions[j] = Bm25Score(terms[j]._idf, it.frequency(), lengthNorm);
+      }
+
+      it.next();
+    }
+
+    if (exists) {
+      // sum up in word order so equal documents get bitwise equal scores
+      double score = 0.0;
+
+      for (size_t j = 0; j < n; ++j) {
+        score += contributions[j];
+        contributions[j] = 0.0;
+      }
+
+      top.add(score, handle);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rank the documents of a previously evaluated result
+///
+/// this is used for queries mixing different logical operators. the words are
+/// looked at in order of decreasing maximum score. a document is not looked
+/// up in the remaining lists once it cannot make it into the result anymore
+////////////////////////////////////////////////////////////////////////////////
+
+static void RankList (index_t const* idx,
+                      TRI_fulltext_list_t* list,
+                      std::vector<ranked_term_t>& terms,
+                      double averageLength,
+                      TopResults& top) {
+  std::sort(terms.begin(), terms.end(), [] (ranked_term_t const& lhs, ranked_term_t const& rhs) {
+    return lhs._maxScore > rhs._maxScore;
+  });
+
+  std::vector<TRI_fulltext_list_iterator_t> iterators;
+  iterators.reserve(terms.size());
+
+  size_t const n = terms.size();
+  std::vector<double> remaining(n + 1, 0.0);
+
+  for (size_t j = 0; j < n; ++j) {
+    iterators.emplace_back(terms[j]._list);
+  }
+
+  for (size_t j = n; j > 0; --j) {
+    remaining[j - 1] = remaining[j] + terms[j - 1]._maxScore;
+  }
+
+  TRI_SortListFulltextIndex(list);
+
+  TRI_fulltext_list_entry_t const* listEntries = TRI_StartListFulltextIndex(list);
+  uint32_t const numEntries = TRI_NumEntriesListFulltextIndex(list);
+
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    TRI_fulltext_handle_t handle = listEntries[i];
+
+    if (top.full() && remaining[0] <= top.threshold()) {
+      // no document can make it into the result anymore
+      return;
+    }
+
+    if (TRI_GetDocumentFulltextIndex(idx->_handles, handle) == 0) {
+      // deleted document
+      continue;
+    }
+
+    double lengthNorm = Bm25LengthNorm(idx, handle, averageLength);
+    double score = 0.0;
+    bool pruned = false;
+
+    for (size_t j = 0; j < n; ++j) {
+      if (top.full() && score + remaining[j] <= top.threshold()) {
+        pruned = true;
+        break;
+      }
+
+      iterators[j].seek(handle);
+
+      if (iterators[j].valid() && iterators[j].value() == handle) {
+        score += Bm25Score(terms[j]._idf, iterators[j].frequency(), lengthNorm);
+      }
+    }
+
+    if (! pruned) {
+      top.add(score, handle);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute a query and return the best maxResults documents, ordered
+/// by their BM25 relevance score. the caller must hold the read lock
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_fulltext_result_t* RankedQuery (index_t* const idx,
+                                           TRI_fulltext_query_t const* query,
+                                           std::vector<node_t*> const& nodes,
+                                           std::vector<size_t> const& order,
+                                           size_t maxResults) {
+  size_t const numWords = order.size();
+  bool onlyAnd = true;
+  bool onlyOr = (query->_operations[0] != TRI_FULLTEXT_EXCLUDE);
+
+  for (size_t i = 0; i < numWords; ++i) {
+    if (query->_operations[i] != TRI_FULLTEXT_AND) {
+      onlyAnd = false;
+    }
+    if (i > 0 && query->_operations[i] != TRI_FULLTEXT_OR) {
+      onlyOr = false;
+    }
+  }
+
+  // collection statistics
+  double numDocuments = (double) TRI_NumHandlesHandleFulltextIndex(idx->_handles) -
+                        (double) TRI_NumDeletedHandleFulltextIndex(idx->_handles);
+  double averageLength = TRI_AverageLengthHandleFulltextIndex(idx->_handles);
+
+  // set up the words that contribute to the score
+  std::vector<ranked_term_t> terms;
+  terms.reserve(numWords);
+
+  bool ok = true;
+
+  for (size_t n = 0; n < numWords; ++n) {
+    size_t i = order[n];
+    node_t const* node = nodes[i];
+
+    if (query->_operations[i] == TRI_FULLTEXT_EXCLUDE) {
+      continue;
+    }
+
+    ranked_term_t term = { nullptr, nullptr, 0.0, 0.0 };
+
+    if (node != nullptr) {
+      if (query->_matches[i] == TRI_FULLTEXT_COMPLETE) {
+        term._list = node->_handles;
+      }
+      else {
+        term._owned = GetSubNodeHandles(node);
+
+        if (term._owned == nullptr) {
+          ok = false;
+          break;
+        }
+
+        TRI_SortListFulltextIndex(term._owned);
+        term._list = term._owned;
+      }
+    }
+
+    if (term._list == nullptr || TRI_NumEntriesListFulltextIndex(term._list) == 0) {
+      if (onlyAnd) {
+        // no document can contain all words
+        for (auto& it : terms) {
+          TRI_FreeListFulltextIndex(it._owned);
+        }
+        TRI_FreeListFulltextIndex(term._owned);
+        return TRI_CreateResultFulltextIndex(0);
+      }
+
+      TRI_FreeListFulltextIndex(term._owned);
+      continue;
+    }
+
+    double documentFrequency = (double) TRI_NumEntriesListFulltextIndex(term._list);
+    double maxFrequency = (double) TRI_MaxFrequencyListFulltextIndex(term._list);
+    double rest = numDocuments - documentFrequency;
+
+    if (rest < 0.0) {
+      // the list still contains handles of deleted documents
+      rest = 0.0;
+    }
+
+    term._idf = log(1.0 + (rest + 0.5) / (documentFrequency + 0.5));
+    // the score of a word is highest for the highest frequency in the
+    // shortest possible document
+    term._maxScore = term._idf * (maxFrequency * (BM25_K1 + 1.0)) / (maxFrequency + BM25_K1 * (1.0 - BM25_B));
+
+    terms.emplace_back(term);
+  }
+
+  TopResults top(maxResults);
+
+  if (ok && ! terms.empty()) {
+    try {
+      if (onlyAnd) {
+        std::sort(terms.begin(), terms.end(), [] (ranked_term_t const& lhs, ranked_term_t const& rhs) {
+          return TRI_NumEntriesListFulltextIndex(lhs._list) < TRI_NumEntriesListFulltextIndex(rhs._list);
+        });
+
+        RankConjunction(idx, terms, averageLength, top);
+      }
+      else if (onlyOr) {
+        RankDisjunction(idx, terms, averageLength, top);
+      }
+      else {
+        TRI_fulltext_list_t* list = EvaluateQuery(idx, query, nodes, order);
+
+        if (list == nullptr) {
+          ok = false;
+        }
+        else {
+          RankList(idx, list, terms, averageLength, top);
+          TRI_FreeListFulltextIndex(list);
+        }
+      }
+    }
+    catch (...) {
+      ok = false;
+    }
+  }
+
+  for (auto& it : terms) {
+    TRI_FreeListFulltextIndex(it._owned);
+  }
+
+  if (! ok) {
+    return nullptr;
+  }
+
+  auto const& results = top.sorted();
+  TRI_fulltext_result_t* result = TRI_CreateRankedResultFulltextIndex(static_cast<uint32_t>(results.size()));
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (auto const& it : results) {
+    result->_documents[result->_numDocuments] = TRI_GetDocumentFulltextIndex(idx->_handles, it.second);
+    result->_scores[result->_numDocuments] = it.first;
+    ++result->_numDocuments;
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  string functions
 // -----------------------------------------------------------------------------
@@ -1249,6 +1894,143 @@ static inline size_t CommonPrefixLength (const char* const lhs,
   return length;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   batch functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief orders batch entries by word, and by document for the same word
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool BatchEntryLess (batch_entry_t const& lhs,
+                                   batch_entry_t const& rhs) {
+  // the prefixes order words like strcmp does, so the words themselves only
+  // need to be compared if the prefixes are equal
+  if (lhs._prefix != rhs._prefix) {
+    return (lhs._prefix < rhs._prefix);
+  }
+
+  int res = strcmp(lhs._word, rhs._word);
+
+  if (res != 0) {
+    return (res < 0);
+  }
+  return (lhs._position < rhs._position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash function for words during a batch insert
+////////////////////////////////////////////////////////////////////////////////
+
+struct BatchWordHash {
+  size_t operator() (char const* word) const {
+    return static_cast<size_t>(TRI_FnvHashString(word));
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief equality function for words during a batch insert
+////////////////////////////////////////////////////////////////////////////////
+
+struct BatchWordEqual {
+  bool operator() (char const* lhs, char const* rhs) const {
+    return (strcmp(lhs, rhs) == 0);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the (sorted) wordlists of the documents in [lower, upper)
+/// into a list of word occurrences, sorted by word and document
+///
+/// documents contain the same words over and over again, so only the
+/// distinct words are sorted. the occurrences are then distributed by the
+/// rank of their word, which keeps them in document order per word
+////////////////////////////////////////////////////////////////////////////////
+
+static void BuildBatchEntries (TRI_fulltext_wordlist_t* const* wordlists,
+                               size_t lower,
+                               size_t upper,
+                               std::vector<batch_entry_t>& entries) {
+  std::unordered_map<char const*, uint32_t, BatchWordHash, BatchWordEqual> ids;
+  std::vector<char const*> words;
+  std::vector<batch_entry_t> occurrences;
+
+  for (size_t i = lower; i < upper; ++i) {
+    TRI_fulltext_wordlist_t const* wordlist = wordlists[i];
+    uint32_t w = 0;
+
+    while (w < wordlist->_numWords) {
+      // duplicates are adjacent in a sorted wordlist
+      uint32_t frequency = 1;
+      while (w + frequency < wordlist->_numWords &&
+             strcmp(wordlist->_words[w], wordlist->_words[w + frequency]) == 0) {
+        ++frequency;
+      }
+
+      char const* word = wordlist->_words[w];
+      auto it = ids.emplace(word, static_cast<uint32_t>(words.size()));
+
+      if (it.second) {
+        words.push_back(word);
+      }
+
+      // the word's id is kept in _prefix until the words are ranked
+      occurrences.push_back(batch_entry_t{ (*it.first).second, word, i, frequency });
+      w += frequency;
+    }
+  }
+
+  // sort the distinct words
+  size_t const n = words.size();
+  std::vector<uint32_t> order(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+
+  std::sort(order.begin(), order.end(), [&words] (uint32_t lhs, uint32_t rhs) -> bool {
+    return (strcmp(words[lhs], words[rhs]) < 0);
+  });
+
+  // offsets[id] is the position of the next occurrence of word id
+  std::vector<size_t> offsets(n);
+  std::vector<uint64_t> prefixes(n);
+  {
+    std::vector<size_t> counts(n, 0);
+
+    for (auto const& it : occurrences) {
+      ++counts[it._prefix];
+    }
+
+    size_t offset = 0;
+
+    for (auto const& id : order) {
+      offsets[id] = offset;
+      offset += counts[id];
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    char const* word = words[i];
+    uint64_t prefix = 0;
+
+    for (size_t j = 0; j < sizeof(uint64_t); ++j) {
+      prefix <<= 8;
+      if (*word != '\0') {
+        prefix |= (uint8_t) *(word++);
+      }
+    }
+    prefixes[i] = prefix;
+  }
+
+  entries.resize(occurrences.size());
+
+  for (auto const& it : occurrences) {
+    auto id = it._prefix;
+    entries[offsets[id]++] = batch_entry_t{ prefixes[id], it._word, it._position, it._frequency };
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -1358,7 +2140,7 @@ void TRI_DeleteDocumentFulltextIndex (TRI_fts_index_t* const ftx,
 /// MAX_WORD_BYTES. the caller must check this before calling this function
 ///
 /// The function will sort the wordlist in place to
-/// - filter out duplicates on insertion
+/// - filter out duplicates on insertion and count the occurrences of words
 /// - save redundant lookups of prefix nodes for adjacent words with shared
 ///   prefixes
 ////////////////////////////////////////////////////////////////////////////////
@@ -1388,8 +2170,9 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
 
   TRI_WriteLockReadWriteLock(&idx->_lock);
 
-  // get a new handle for the document
-  handle = TRI_InsertHandleFulltextIndex(idx->_handles, document);
+  // get a new handle for the document. the number of words is stored
+  // for the relevance ranking
+  handle = TRI_InsertHandleFulltextIndex(idx->_handles, document, (uint32_t) wordlist->_numWords);
   if (handle == 0) {
     TRI_WriteUnlockReadWriteLock(&idx->_lock);
     return false;
@@ -1406,6 +2189,7 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
     char* p;
     size_t start;
     size_t i;
+    uint32_t frequency;
 
     // LOG_DEBUG("checking word %s", wordlist->_words[w]);
 
@@ -1438,8 +2222,17 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
     TRI_ASSERT(node != nullptr);
 #endif
 
+    // count the occurrences of the word in the document. as the words are
+    // sorted, all occurrences are adjacent
+    frequency = 1;
+    while (w + frequency < wordlist->_numWords &&
+           strcmp(wordlist->_words[w], wordlist->_words[w + frequency]) == 0) {
+      ++frequency;
+    }
+
     // now insert into the tree, starting at the next character after the common prefix
-    p = wordlist->_words[w++] + start;
+    p = wordlist->_words[w] + start;
+    w += frequency;
 
     for (i = start; *p && i <= MAX_WORD_BYTES; ++i) {
       node_char_t c = (node_char_t) *(p++);
@@ -1461,7 +2254,7 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
       paths[i + 1] = node;
     }
 
-    if (! InsertHandle(idx, node, handle)) {
+    if (! InsertHandle(idx, node, handle, frequency)) {
       // document was added at least once, mark it as deleted
       TRI_DeleteDocumentHandleFulltextIndex(idx->_handles, document);
       TRI_WriteUnlockReadWriteLock(&idx->_lock);
@@ -1478,6 +2271,186 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert the words of many documents into the index at once
+/// the wordlists must have been sorted with TRI_SortWordlistFulltextIndex,
+/// and must not be empty. words must not be longer than MAX_WORD_BYTES, as
+/// for TRI_InsertWordsFulltextIndex
+///
+/// instead of walking the tree once per document, the word occurrences of
+/// all documents are sorted by word, so every node is visited only once per
+/// batch and its handles are appended in one go. the occurrences are built
+/// and sorted in up to numThreads runs, in parallel in the pool and outside
+/// of the index lock, and the runs are merged while inserting. documents get their
+/// handles in batch order, so the handles per word are still appended in
+/// ascending order
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_InsertWordsBatchFulltextIndex (TRI_fts_index_t* const ftx,
+                                        TRI_fulltext_doc_t const* documents,
+                                        TRI_fulltext_wordlist_t* const* wordlists,
+                                        size_t numDocuments,
+                                        triagens::basics::ThreadPool* pool,
+                                        size_t numThreads) {
+  index_t* idx = (index_t*) ftx;
+
+  if (numDocuments == 0) {
+    return true;
+  }
+
+  if (numThreads > numDocuments / 1024) {
+    numThreads = numDocuments / 1024;
+  }
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
+
+  std::vector<std::vector<batch_entry_t>> runs;
+  std::vector<TRI_fulltext_handle_t> handles;
+  std::atomic<bool> failed(false);
+
+  try {
+    runs.resize(numThreads);
+    handles.resize(numDocuments);
+
+    size_t const chunkSize = (numDocuments + numThreads - 1) / numThreads;
+
+    std::atomic<size_t> next(0);
+
+    auto builder = [&] () -> void {
+      try {
+        while (! failed) {
+          size_t run = next++;
+
+          if (run >= numThreads) {
+            break;
+          }
+
+          size_t lower = run * chunkSize;
+          BuildBatchEntries(wordlists, lower, (std::min)(numDocuments, lower + chunkSize), runs[run]);
+        }
+      }
+      catch (...) {
+        failed = true;
+      }
+    };
+
+    triagens::basics::ThreadPool::runConcurrently(pool, builder, numThreads);
+  }
+  catch (...) {
+    failed = true;
+  }
+
+  if (failed) {
+    return false;
+  }
+
+  TRI_WriteLockReadWriteLock(&idx->_lock);
+
+  // get the handles for all documents first. the number of words is stored
+  // for the relevance ranking
+  for (size_t i = 0; i < numDocuments; ++i) {
+    handles[i] = TRI_InsertHandleFulltextIndex(idx->_handles, documents[i], (uint32_t) wordlists[i]->_numWords);
+
+    if (handles[i] == 0) {
+      while (i > 0) {
+        TRI_DeleteDocumentHandleFulltextIndex(idx->_handles, documents[--i]);
+      }
+      TRI_WriteUnlockReadWriteLock(&idx->_lock);
+      return false;
+    }
+  }
+
+  // merge the runs. the heap holds the run numbers, smallest entry on top
+  std::vector<size_t> positions(numThreads, 0);
+  std::vector<size_t> heap;
+  heap.reserve(numThreads);
+
+  auto greater = [&] (size_t lhs, size_t rhs) -> bool {
+    return BatchEntryLess(runs[rhs][positions[rhs]], runs[lhs][positions[lhs]]);
+  };
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    if (! runs[i].empty()) {
+      heap.push_back(i);
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), greater);
+
+  node_t* paths[MAX_WORD_BYTES + 4];
+  paths[0] = idx->_root;
+  paths[MAX_WORD_BYTES] = nullptr;
+
+  node_t* node = nullptr;
+  char const* last = nullptr;
+  bool ok = true;
+
+  while (! heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    size_t run = heap.back();
+    batch_entry_t const& entry = runs[run][positions[run]];
+
+    if (last == nullptr || strcmp(last, entry._word) != 0) {
+      // a new word. start at the end of the prefix it shares with the
+      // previous word, as TRI_InsertWordsFulltextIndex does
+      size_t start = 0;
+
+      if (last != nullptr) {
+        start = CommonPrefixLength(last, entry._word);
+
+        if (start > MAX_WORD_BYTES) {
+          start = MAX_WORD_BYTES;
+        }
+      }
+
+      node = paths[start];
+      char const* p = entry._word + start;
+
+      for (size_t i = start; *p && i <= MAX_WORD_BYTES; ++i) {
+        node_char_t c = (node_char_t) *(p++);
+
+        node = EnsureSubNode(idx, node, c);
+
+        if (node == nullptr) {
+          ok = false;
+          break;
+        }
+
+        paths[i + 1] = node;
+      }
+
+      if (! ok) {
+        break;
+      }
+
+      last = entry._word;
+    }
+
+    if (! InsertHandle(idx, node, handles[entry._position], entry._frequency)) {
+      ok = false;
+      break;
+    }
+
+    if (++positions[run] < runs[run].size()) {
+      std::push_heap(heap.begin(), heap.end(), greater);
+    }
+    else {
+      heap.pop_back();
+    }
+  }
+
+  if (! ok) {
+    // documents might have been added partially. mark them all as deleted
+    for (size_t i = 0; i < numDocuments; ++i) {
+      TRI_DeleteDocumentHandleFulltextIndex(idx->_handles, documents[i]);
+    }
+  }
+
+  TRI_WriteUnlockReadWriteLock(&idx->_lock);
+
+  return ok;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   query functions
 // -----------------------------------------------------------------------------
@@ -1533,73 +2506,88 @@ TRI_fulltext_result_t* TRI_QueryFulltextIndex (TRI_fts_index_t* const ftx,
 
   TRI_ReadLockReadWriteLock(&idx->_lock);
 
-  // initial result is empty
-  result = nullptr;
+  // look up the nodes of all words first
+  size_t numWords = 0;
+  bool onlyAnd = true;
+  std::vector<node_t*> nodes;
+  std::vector<size_t> order;
 
-  // iterate over all words in query
-  for (i = 0; i < query->_numWords; ++i) {
-    char* word;
-    TRI_fulltext_query_match_e match;
-    TRI_fulltext_query_operation_e operation;
-    TRI_fulltext_list_t* list;
-    node_t* node;
+  try {
+    nodes.reserve(query->_numWords);
+    order.reserve(query->_numWords);
 
-    word      = query->_words[i];
-    if (word == nullptr) {
-      break;
-    }
+    for (i = 0; i < query->_numWords; ++i) {
+      char* word = query->_words[i];
 
-    match     = query->_matches[i];
-    operation = query->_operations[i];
+      if (word == nullptr) {
+        break;
+      }
 
-    LOG_DEBUG("searching for word: '%s'", word);
+      nodes.emplace_back(FindNode(idx, word, strlen(word)));
+      order.emplace_back(i);
 
-    if ((operation == TRI_FULLTEXT_AND || operation == TRI_FULLTEXT_EXCLUDE) &&
-        i > 0 && 
-        TRI_NumEntriesListFulltextIndex(result) == 0) {
-      // current result set is empty so logical AND or EXCLUDE will not have any result either
-      continue;
+      if (query->_operations[i] != TRI_FULLTEXT_AND) {
+        onlyAnd = false;
+      }
     }
+  }
+  catch (...) {
+    TRI_ReadUnlockReadWriteLock(&idx->_lock);
+    TRI_FreeQueryFulltextIndex(query);
+    return nullptr;
+  }
 
-    list = nullptr;
-    node = FindNode(idx, word, strlen(word));
-    if (node != nullptr) {
-      if (match == TRI_FULLTEXT_COMPLETE) {
-        // complete matching
-        list = GetDirectNodeHandles(node);
+  numWords = order.size();
+
+  if (onlyAnd && numWords > 1) {
+    // for a pure AND query, start with the word with the fewest handles.
+    // the result can then only shrink, and each following intersection
+    // iterates over the (small) result and seeks in the (big) stored list.
+    // prefix matches are evaluated last, as they must be collected from all
+    // sub-nodes
+    auto estimate = [&] (size_t pos) -> size_t {
+      node_t const* node = nodes[pos];
+
+      if (node == nullptr) {
+        return 0;
       }
-      else if (match == TRI_FULLTEXT_PREFIX) {
-        // prefix matching
-        list = GetSubNodeHandles(node);
+
+      if (query->_matches[pos] != TRI_FULLTEXT_COMPLETE) {
+        return SIZE_MAX;
       }
-      else {
-        LOG_WARNING("invalid matching option for fulltext index query");
-        list = TRI_CreateListFulltextIndex(0);
+
+      if (node->_handles == nullptr) {
+        return 0;
       }
-    }
-    else {
-      list = TRI_CreateListFulltextIndex(0);
-    }
 
-    if (operation == TRI_FULLTEXT_AND) {
-      // perform a logical AND of current and previous result (if any)
-      result = TRI_IntersectListFulltextIndex(result, list);
-    }
-    else if (operation == TRI_FULLTEXT_OR) {
-      // perform a logical OR of current and previous result (if any)
-      result = TRI_UnioniseListFulltextIndex(result, list);
+      return TRI_NumEntriesListFulltextIndex(node->_handles);
+    };
+
+    std::stable_sort(order.begin(), order.end(), [&] (size_t lhs, size_t rhs) {
+      return estimate(lhs) < estimate(rhs);
+    });
+  }
+
+  if (maxResults > 0) {
+    // rank the documents and only return the best ones
+    TRI_fulltext_result_t* ranked;
+
+    try {
+      ranked = RankedQuery(idx, query, nodes, order, maxResults);
     }
-    else if (operation == TRI_FULLTEXT_EXCLUDE) {
-      // perform a logical exclusion of current from previous result (if any)
-      result = TRI_ExcludeListFulltextIndex(result, list);
+    catch (...) {
+      ranked = nullptr;
     }
 
-    if (result == nullptr) {
-      // out of memory
-      break;
-    }
+    TRI_ReadUnlockReadWriteLock(&idx->_lock);
+
+    TRI_FreeQueryFulltextIndex(query);
+
+    return ranked;
   }
 
+  result = EvaluateQuery(idx, query, nodes, order);
+
   TRI_ReadUnlockReadWriteLock(&idx->_lock);
 
   TRI_FreeQueryFulltextIndex(query);
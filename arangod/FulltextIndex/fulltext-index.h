@@ -40,6 +40,12 @@ struct TRI_fulltext_query_s;
 struct TRI_fulltext_result_s;
 struct TRI_fulltext_wordlist_s;
 
+namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                     public macros
 // -----------------------------------------------------------------------------
@@ -118,6 +124,17 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const,
                                    const TRI_fulltext_doc_t,
                                    struct TRI_fulltext_wordlist_s*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert the sorted word lists of many documents into the index
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_InsertWordsBatchFulltextIndex (TRI_fts_index_t* const,
+                                        TRI_fulltext_doc_t const*,
+                                        struct TRI_fulltext_wordlist_s* const*,
+                                        size_t,
+                                        triagens::basics::ThreadPool*,
+                                        size_t);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   query functions
 // -----------------------------------------------------------------------------
@@ -29,6 +29,8 @@
 
 #include "fulltext-list.h"
 
+#include <algorithm>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private defines
 // -----------------------------------------------------------------------------
@@ -44,33 +46,96 @@
 
 #define SORTED_BIT 2147483648UL
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief we'll set this bit (the second highest of a uint32_t) if the list
+/// is stored in compressed blocks. compressed lists are always sorted
+////////////////////////////////////////////////////////////////////////////////
+
+#define COMPRESSED_BIT 1073741824UL
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief growth factor for lists
 ////////////////////////////////////////////////////////////////////////////////
 
 #define GROWTH_FACTOR 1.2
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries in a compressed block
+////////////////////////////////////////////////////////////////////////////////
+
+#define BLOCK_SIZE TRI_FULLTEXT_LIST_BLOCK_SIZE
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries from which on a list is compressed
+////////////////////////////////////////////////////////////////////////////////
+
+#define COMPRESS_THRESHOLD (BLOCK_SIZE * 2)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of bytes of an encoded entry
+/// this is the delta plus the frequency flag (up to 5 bytes) and the
+/// frequency itself (up to 2 bytes)
+////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_ENCODED_BYTES 7
+
 // -----------------------------------------------------------------------------
-// --SECTION--                                                 private functions
+// --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief compare two entries in a list
+/// @brief skip entry of a compressed block
+///
+/// each block contains exactly BLOCK_SIZE entries. the first entry is stored
+/// in the skip entry. all entries are stored as varint-encoded deltas to their
+/// predecessors, starting at _offset in the list's data. the lowest bit of
+/// each delta indicates whether a frequency other than 1 follows
 ////////////////////////////////////////////////////////////////////////////////
 
-static int CompareEntries (const void* lhs, const void* rhs) {
-  TRI_fulltext_list_entry_t l = (*(TRI_fulltext_list_entry_t*) lhs);
-  TRI_fulltext_list_entry_t r = (*(TRI_fulltext_list_entry_t*) rhs);
+typedef struct {
+  TRI_fulltext_list_entry_t _first;
+  TRI_fulltext_list_entry_t _last;
+  uint32_t                  _offset;
+}
+block_t;
 
-  if (l < r) {
-    return -1;
-  }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a compressed list
+///
+/// the first two members are at the same positions as numAllocated and
+/// numEntries of uncompressed lists, so the flags and the number of entries
+/// can be read without knowing the type of the list. entries that do not yet
+/// fill a complete block are kept uncompressed in the tail
+////////////////////////////////////////////////////////////////////////////////
 
-  if (l > r) {
-    return 1;
-  }
+typedef struct {
+  uint32_t                      _flags;
+  uint32_t                      _numEntries;
+  uint32_t                      _numBlocks;
+  uint32_t                      _blocksAllocated;
+  uint32_t                      _dataUsed;
+  uint32_t                      _dataAllocated;
+  uint32_t                      _numTail;
+  uint32_t                      _maxFrequency;
+  block_t*                      _blocks;
+  uint8_t*                      _data;
+  TRI_fulltext_list_entry_t     _tail[BLOCK_SIZE];
+  TRI_fulltext_list_frequency_t _tailFrequencies[BLOCK_SIZE];
+}
+compressed_list_t;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
 
-  return 0;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return whether the list is compressed
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool IsCompressed (const TRI_fulltext_list_t* const list) {
+  uint32_t* head = (uint32_t*) list;
+
+  return ((*head & COMPRESSED_BIT) != 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -104,6 +169,7 @@ static inline void SetIsSorted (TRI_fulltext_list_t* const list,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the pointer to the start of the list entries
+/// must only be called for uncompressed lists
 ////////////////////////////////////////////////////////////////////////////////
 
 static inline TRI_fulltext_list_entry_t* GetStart (const TRI_fulltext_list_t* const list) {
@@ -136,12 +202,23 @@ static inline void SetNumEntries (TRI_fulltext_list_t* const list,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the number of allocated entries
+/// must only be called for uncompressed lists
 ////////////////////////////////////////////////////////////////////////////////
 
 static inline uint32_t GetNumAllocated (TRI_fulltext_list_t const* list) {
   uint32_t* head = (uint32_t*) list;
 
-  return (*head & ~SORTED_BIT);
+  return (*head & ~(SORTED_BIT | COMPRESSED_BIT));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the pointer to the frequencies of the list entries
+/// the frequencies follow the allocated entries. must only be called for
+/// uncompressed lists
+////////////////////////////////////////////////////////////////////////////////
+
+static inline TRI_fulltext_list_frequency_t* GetFrequencies (const TRI_fulltext_list_t* const list) {
+  return (TRI_fulltext_list_frequency_t*) (GetStart(list) + GetNumAllocated(list));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,7 +247,29 @@ static void SortList (TRI_fulltext_list_t* list) {
 
   if (numEntries > 1) {
     // only sort if more than one elements
-    qsort(GetStart(list), numEntries, sizeof(TRI_fulltext_list_entry_t), &CompareEntries);
+    // entries and frequencies are sorted together as pairs
+    TRI_fulltext_list_entry_t* listEntries = GetStart(list);
+    TRI_fulltext_list_frequency_t* listFrequencies = GetFrequencies(list);
+    uint64_t* pairs = static_cast<uint64_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, numEntries * sizeof(uint64_t), false));
+
+    if (pairs == nullptr) {
+      // out of memory. sort the entries only
+      std::sort(listEntries, listEntries + numEntries);
+    }
+    else {
+      for (uint32_t i = 0; i < numEntries; ++i) {
+        pairs[i] = (static_cast<uint64_t>(listEntries[i]) << 8) | listFrequencies[i];
+      }
+
+      std::sort(pairs, pairs + numEntries);
+
+      for (uint32_t i = 0; i < numEntries; ++i) {
+        listEntries[i] = static_cast<TRI_fulltext_list_entry_t>(pairs[i] >> 8);
+        listFrequencies[i] = static_cast<TRI_fulltext_list_frequency_t>(pairs[i] & 0xff);
+      }
+
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, pairs);
+    }
   }
 
   SetIsSorted(list, true);
@@ -183,30 +282,619 @@ static void SortList (TRI_fulltext_list_t* list) {
 static inline size_t MemoryList (const uint32_t size) {
   return sizeof(uint32_t) + // numAllocated
          sizeof(uint32_t) + // numEntries
-         size * sizeof(TRI_fulltext_list_entry_t); // entries
+         size * sizeof(TRI_fulltext_list_entry_t) + // entries
+         size * sizeof(TRI_fulltext_list_frequency_t); // frequencies
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the memory usage of a compressed list
+////////////////////////////////////////////////////////////////////////////////
+
+static inline size_t MemoryCompressedList (compressed_list_t const* list) {
+  return sizeof(compressed_list_t) +
+         list->_blocksAllocated * sizeof(block_t) +
+         list->_dataAllocated;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief increase an existing list
+/// the frequencies are moved behind the new end of the entries
 ////////////////////////////////////////////////////////////////////////////////
 
 static TRI_fulltext_list_t* IncreaseList (TRI_fulltext_list_t* list,
                                           const uint32_t size) {
+  uint32_t const numEntries = GetNumEntries(list);
+  uint32_t const oldSize = GetNumAllocated(list);
+  bool const sorted = IsSorted(list);
+
   TRI_fulltext_list_t* copy = TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list, MemoryList(size));
 
   if (copy != nullptr) {
+    TRI_fulltext_list_frequency_t* oldFrequencies = (TRI_fulltext_list_frequency_t*) (GetStart(copy) + oldSize);
+
     InitList(copy, size);
+    memmove(GetFrequencies(copy), oldFrequencies, numEntries * sizeof(TRI_fulltext_list_frequency_t));
+    SetNumEntries(copy, numEntries);
+    SetIsSorted(copy, sorted);
+  }
+
+  return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief varint-encode a value
+/// returns the number of bytes written
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t EncodeVarint (uint8_t* p,
+                                     uint64_t value) {
+  uint32_t length = 0;
+
+  while (value >= 0x80) {
+    p[length++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+
+  p[length++] = static_cast<uint8_t>(value);
+
+  return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief varint-decode a value
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t DecodeVarint (uint8_t const*& p) {
+  uint64_t value = *p & 0x7f;
+  uint32_t shift = 7;
+
+  while (*(p++) & 0x80) {
+    value |= static_cast<uint64_t>(*p & 0x7f) << shift;
+    shift += 7;
+  }
+
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decode a compressed block into the buffers
+/// the buffers must have room for BLOCK_SIZE entries
+////////////////////////////////////////////////////////////////////////////////
+
+static void DecodeBlock (compressed_list_t const* list,
+                         uint32_t block,
+                         TRI_fulltext_list_entry_t* entries,
+                         TRI_fulltext_list_frequency_t* frequencies) {
+  block_t const* b = &list->_blocks[block];
+  uint8_t const* p = list->_data + b->_offset;
+
+  TRI_fulltext_list_entry_t value = b->_first;
+
+  for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+    uint64_t code = DecodeVarint(p);
+
+    value += static_cast<TRI_fulltext_list_entry_t>(code >> 1);
+    entries[i] = value;
+    frequencies[i] = static_cast<TRI_fulltext_list_frequency_t>((code & 1) ? DecodeVarint(p) : 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty compressed list
+////////////////////////////////////////////////////////////////////////////////
+
+static compressed_list_t* CreateCompressedList () {
+  compressed_list_t* list = static_cast<compressed_list_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(compressed_list_t), false));
+
+  if (list == nullptr) {
+    return nullptr;
+  }
+
+  list->_flags           = COMPRESSED_BIT | SORTED_BIT;
+  list->_numEntries      = 0;
+  list->_numBlocks       = 0;
+  list->_blocksAllocated = 0;
+  list->_dataUsed        = 0;
+  list->_dataAllocated   = 0;
+  list->_numTail         = 0;
+  list->_maxFrequency    = 0;
+  list->_blocks          = nullptr;
+  list->_data            = nullptr;
+
+  return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free a compressed list
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeCompressedList (compressed_list_t* list) {
+  if (list->_blocks != nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, list->_blocks);
+  }
+
+  if (list->_data != nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, list->_data);
+  }
+
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, list);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress BLOCK_SIZE sorted and unique entries into a new block
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AppendBlock (compressed_list_t* list,
+                         TRI_fulltext_list_entry_t const* entries,
+                         TRI_fulltext_list_frequency_t const* frequencies) {
+  if (list->_numBlocks == list->_blocksAllocated) {
+    uint32_t newSize = (uint32_t) (list->_blocksAllocated * GROWTH_FACTOR);
+
+    if (newSize <= list->_blocksAllocated) {
+      newSize = list->_blocksAllocated + 4;
+    }
+
+    block_t* blocks = static_cast<block_t*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list->_blocks, newSize * sizeof(block_t)));
+
+    if (blocks == nullptr) {
+      return false;
+    }
+
+    list->_blocks = blocks;
+    list->_blocksAllocated = newSize;
+  }
+
+  uint32_t const maxLength = BLOCK_SIZE * MAX_ENCODED_BYTES;
+
+  if (list->_dataUsed + maxLength > list->_dataAllocated) {
+    uint32_t newSize = (uint32_t) (list->_dataAllocated * GROWTH_FACTOR);
+
+    if (newSize < list->_dataUsed + maxLength) {
+      newSize = list->_dataUsed + maxLength;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list->_data, newSize));
+
+    if (data == nullptr) {
+      return false;
+    }
+
+    list->_data = data;
+    list->_dataAllocated = newSize;
+  }
+
+  block_t* b = &list->_blocks[list->_numBlocks++];
+  b->_first  = entries[0];
+  b->_last   = entries[BLOCK_SIZE - 1];
+  b->_offset = list->_dataUsed;
+
+  uint8_t* p = list->_data + list->_dataUsed;
+  uint32_t length = 0;
+  TRI_fulltext_list_entry_t previous = entries[0];
+
+  for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+    uint64_t code = static_cast<uint64_t>(entries[i] - previous) << 1;
+
+    if (frequencies[i] != 1) {
+      length += EncodeVarint(p + length, code | 1);
+      length += EncodeVarint(p + length, frequencies[i]);
+    }
+    else {
+      length += EncodeVarint(p + length, code);
+    }
+
+    previous = entries[i];
+  }
+
+  list->_dataUsed += length;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a sorted entry to the tail of a compressed list
+/// the tail is compressed into a block when it is full. if that fails, the
+/// full tail is kept and compressed later
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendTail (compressed_list_t* list,
+                        TRI_fulltext_list_entry_t entry,
+                        TRI_fulltext_list_frequency_t frequency) {
+  TRI_ASSERT(list->_numTail < BLOCK_SIZE);
+
+  list->_tail[list->_numTail] = entry;
+  list->_tailFrequencies[list->_numTail] = frequency;
+  list->_numTail++;
+  list->_numEntries++;
+
+  if (frequency > list->_maxFrequency) {
+    list->_maxFrequency = frequency;
+  }
+
+  if (list->_numTail == BLOCK_SIZE &&
+      AppendBlock(list, list->_tail, list->_tailFrequencies)) {
+    list->_numTail = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fill a compressed list with sorted entries
+/// duplicate entries are removed. the list must be empty
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FillCompressedList (compressed_list_t* list,
+                                TRI_fulltext_list_entry_t const* entries,
+                                TRI_fulltext_list_frequency_t const* frequencies,
+                                uint32_t numEntries) {
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    if (i > 0 && entries[i] == entries[i - 1]) {
+      // duplicate
+      continue;
+    }
+
+    if (list->_numTail == BLOCK_SIZE) {
+      // compressing the full tail failed
+      return false;
+    }
+
+    AppendTail(list, entries[i], frequencies[i]);
+  }
+
+  return (list->_numTail < BLOCK_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shrink the memory of a compressed list to the memory in use
+////////////////////////////////////////////////////////////////////////////////
+
+static void ShrinkCompressedList (compressed_list_t* list) {
+  if (list->_numBlocks == 0) {
+    if (list->_blocks != nullptr) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, list->_blocks);
+      list->_blocks = nullptr;
+      list->_blocksAllocated = 0;
+    }
+
+    if (list->_data != nullptr) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, list->_data);
+      list->_data = nullptr;
+      list->_dataAllocated = 0;
+      list->_dataUsed = 0;
+    }
+
+    return;
+  }
+
+  if (list->_blocksAllocated > list->_numBlocks) {
+    block_t* blocks = static_cast<block_t*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list->_blocks, list->_numBlocks * sizeof(block_t)));
+
+    if (blocks != nullptr) {
+      list->_blocks = blocks;
+      list->_blocksAllocated = list->_numBlocks;
+    }
+  }
+
+  if (list->_dataAllocated > list->_dataUsed) {
+    uint8_t* data = static_cast<uint8_t*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list->_data, list->_dataUsed));
+
+    if (data != nullptr) {
+      list->_data = data;
+      list->_dataAllocated = list->_dataUsed;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief convert an uncompressed list into a compressed one
+/// returns nullptr if out of memory. the original list is left untouched
+/// in this case, and freed otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_fulltext_list_t* CompressList (TRI_fulltext_list_t* source) {
+  compressed_list_t* list = CreateCompressedList();
+
+  if (list == nullptr) {
+    return nullptr;
+  }
+
+  SortList(source);
+
+  if (! FillCompressedList(list, GetStart(source), GetFrequencies(source), GetNumEntries(source))) {
+    FreeCompressedList(list);
+    return nullptr;
+  }
+
+  TRI_FreeListFulltextIndex(source);
+
+  return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompress a compressed list into an uncompressed one
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_fulltext_list_t* DecompressList (compressed_list_t const* source,
+                                            uint32_t extra) {
+  TRI_fulltext_list_t* list = TRI_CreateListFulltextIndex(source->_numEntries + extra);
+
+  if (list == nullptr) {
+    return nullptr;
+  }
+
+  TRI_fulltext_list_entry_t* listEntries = GetStart(list);
+  TRI_fulltext_list_frequency_t* listFrequencies = GetFrequencies(list);
+
+  for (uint32_t i = 0; i < source->_numBlocks; ++i) {
+    DecodeBlock(source, i, listEntries, listFrequencies);
+    listEntries += BLOCK_SIZE;
+    listFrequencies += BLOCK_SIZE;
+  }
+
+  if (source->_numTail > 0) {
+    memcpy(listEntries, source->_tail, source->_numTail * sizeof(TRI_fulltext_list_entry_t));
+    memcpy(listFrequencies, source->_tailFrequencies, source->_numTail * sizeof(TRI_fulltext_list_frequency_t));
+  }
+
+  SetNumEntries(list, source->_numEntries);
+  SetIsSorted(list, true);
+
+  return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief galloping search for the first position >= target in a sorted array
+/// the search starts at position start
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t Gallop (TRI_fulltext_list_entry_t const* entries,
+                               uint32_t start,
+                               uint32_t length,
+                               TRI_fulltext_list_entry_t target) {
+  if (start >= length || entries[start] >= target) {
+    return start;
+  }
+
+  // entries[start] < target
+  uint32_t low  = start;
+  uint32_t step = 1;
+
+  while (low + step < length && entries[low + step] < target) {
+    low += step;
+    step *= 2;
+  }
+
+  uint32_t high = low + step;
+
+  if (high > length) {
+    high = length;
+  }
+
+  return static_cast<uint32_t>(std::lower_bound(entries + low + 1, entries + high, target) - entries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief intersect a sorted uncompressed list with another list
+/// the other list is not modified. the result is written into lhs
+////////////////////////////////////////////////////////////////////////////////
+
+static void IntersectInPlace (TRI_fulltext_list_t* lhs,
+                              TRI_fulltext_list_t const* rhs) {
+  TRI_fulltext_list_entry_t* lhsEntries = GetStart(lhs);
+  TRI_fulltext_list_frequency_t* lhsFrequencies = GetFrequencies(lhs);
+  uint32_t const numLhs = GetNumEntries(lhs);
+  uint32_t listPos = 0;
+  TRI_fulltext_list_entry_t last = 0;
+
+  TRI_fulltext_list_iterator_t it(rhs);
+
+  for (uint32_t l = 0; l < numLhs && it.valid(); ++l) {
+    TRI_fulltext_list_entry_t entry = lhsEntries[l];
+
+    if (entry <= last) {
+      // skip duplicates
+      continue;
+    }
+
+    it.seek(entry);
+
+    if (it.valid() && it.value() == entry) {
+      // match
+      lhsFrequencies[listPos] = lhsFrequencies[l];
+      lhsEntries[listPos++] = last = entry;
+    }
+  }
+
+  SetNumEntries(lhs, listPos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all entries of another list from a sorted uncompressed list
+/// the other list is not modified. the result is written into list
+////////////////////////////////////////////////////////////////////////////////
+
+static void ExcludeInPlace (TRI_fulltext_list_t* list,
+                            TRI_fulltext_list_t const* exclude) {
+  TRI_fulltext_list_entry_t* listEntries = GetStart(list);
+  TRI_fulltext_list_frequency_t* listFrequencies = GetFrequencies(list);
+  uint32_t const numEntries = GetNumEntries(list);
+  uint32_t listPos = 0;
+
+  TRI_fulltext_list_iterator_t it(exclude);
+
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    TRI_fulltext_list_entry_t entry = listEntries[i];
+
+    it.seek(entry);
+
+    if (it.valid() && it.value() == entry) {
+      // entry is contained in exclusion list
+      continue;
+    }
+
+    if (listPos != i) {
+      listEntries[listPos] = entry;
+      listFrequencies[listPos] = listFrequencies[i];
+    }
+    ++listPos;
+  }
+
+  // we may have less results in the list of exclusion
+  SetNumEntries(list, listPos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a sorted version of a list that must not be modified
+/// returns the list itself if it is already sorted, or a sorted copy which
+/// the caller must free
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_fulltext_list_t const* SortedView (TRI_fulltext_list_t const* list,
+                                              bool& mustFree) {
+  mustFree = false;
+
+  if (IsSorted(list)) {
+    return list;
+  }
+
+  TRI_fulltext_list_t* copy = TRI_CloneListFulltextIndex(list);
+
+  if (copy != nullptr) {
+    SortList(copy);
+    mustFree = true;
   }
 
   return copy;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                          iterator
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an iterator for a sorted list
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_iterator_t::TRI_fulltext_list_iterator_t (TRI_fulltext_list_t const* list)
+  : _compressed(nullptr),
+    _entries(nullptr),
+    _frequencies(nullptr),
+    _length(0),
+    _position(0),
+    _block(0) {
+
+  if (list == nullptr) {
+    return;
+  }
+
+  if (IsCompressed(list)) {
+    _compressed = list;
+    load(0);
+  }
+  else {
+    _entries     = GetStart(list);
+    _frequencies = GetFrequencies(list);
+    _length      = GetNumEntries(list);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance the iterator to the next entry
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_fulltext_list_iterator_t::next () {
+  if (++_position >= _length && 
+      _compressed != nullptr && 
+      _block < static_cast<compressed_list_t const*>(_compressed)->_numBlocks) {
+    load(_block + 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position the iterator at the first entry >= target
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_fulltext_list_iterator_t::seek (TRI_fulltext_list_entry_t target) {
+  if (! valid()) {
+    return;
+  }
+
+  compressed_list_t const* compressed = static_cast<compressed_list_t const*>(_compressed);
+
+  if (compressed != nullptr && 
+      _block < compressed->_numBlocks &&
+      _entries[_length - 1] < target) {
+    // target is not in the current block. gallop over the skip entries
+    uint32_t const numBlocks = compressed->_numBlocks;
+    uint32_t low  = _block + 1;
+    uint32_t step = 1;
+
+    if (low < numBlocks && compressed->_blocks[low]._last < target) {
+      while (low + step < numBlocks && compressed->_blocks[low + step]._last < target) {
+        low += step;
+        step *= 2;
+      }
+
+      uint32_t high = low + step;
+
+      if (high > numBlocks) {
+        high = numBlocks;
+      }
+
+      // find the first block in (low, high) with _last >= target
+      block_t const* b = std::lower_bound(compressed->_blocks + low + 1, 
+                                          compressed->_blocks + high, 
+                                          target, 
+                                          [] (block_t const& block, TRI_fulltext_list_entry_t value) {
+                                            return block._last < value;
+                                          });
+      low = static_cast<uint32_t>(b - compressed->_blocks);
+    }
+
+    // low is either a block that may contain the target, or the tail
+    load(low);
+
+    if (! valid()) {
+      return;
+    }
+  }
+
+  _position = Gallop(_entries, _position, _length, target);
+
+  if (_position >= _length && compressed != nullptr && _block < compressed->_numBlocks) {
+    load(_block + 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief load a block of a compressed list. the block numBlocks is the tail
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_fulltext_list_iterator_t::load (uint32_t block) {
+  compressed_list_t const* compressed = static_cast<compressed_list_t const*>(_compressed);
+
+  _block = block;
+  _position = 0;
+
+  if (block < compressed->_numBlocks) {
+    DecodeBlock(compressed, block, _entryBuffer, _frequencyBuffer);
+    _entries     = _entryBuffer;
+    _frequencies = _frequencyBuffer;
+    _length      = BLOCK_SIZE;
+  }
+  else {
+    _entries     = compressed->_tail;
+    _frequencies = compressed->_tailFrequencies;
+    _length      = compressed->_numTail;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief clone a list by copying an existing one
+/// the copy is always uncompressed
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_t* TRI_CloneListFulltextIndex (TRI_fulltext_list_t const* source) {
@@ -215,6 +903,9 @@ TRI_fulltext_list_t* TRI_CloneListFulltextIndex (TRI_fulltext_list_t const* sour
   if (source == nullptr) {
     numEntries = 0;
   }
+  else if (IsCompressed(source)) {
+    return DecompressList(static_cast<compressed_list_t const*>(source), 0);
+  }
   else {
     numEntries = GetNumEntries(source);
   }
@@ -224,7 +915,9 @@ TRI_fulltext_list_t* TRI_CloneListFulltextIndex (TRI_fulltext_list_t const* sour
   if (list != nullptr) {
     if (numEntries > 0) {
       memcpy(GetStart(list), GetStart(source), numEntries * sizeof(TRI_fulltext_list_entry_t));
+      memcpy(GetFrequencies(list), GetFrequencies(source), numEntries * sizeof(TRI_fulltext_list_frequency_t));
       SetNumEntries(list, numEntries);
+      SetIsSorted(list, IsSorted(source));
     }
   }
 
@@ -253,6 +946,15 @@ TRI_fulltext_list_t* TRI_CreateListFulltextIndex (const uint32_t size) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_FreeListFulltextIndex (TRI_fulltext_list_t* list) {
+  if (list == nullptr) {
+    return;
+  }
+
+  if (IsCompressed(list)) {
+    FreeCompressedList(static_cast<compressed_list_t*>(list));
+    return;
+  }
+
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, list);
 }
 
@@ -265,6 +967,10 @@ void TRI_FreeListFulltextIndex (TRI_fulltext_list_t* list) {
 ////////////////////////////////////////////////////////////////////////////////
 
 size_t TRI_MemoryListFulltextIndex (TRI_fulltext_list_t const* list) {
+  if (IsCompressed(list)) {
+    return MemoryCompressedList(static_cast<compressed_list_t const*>(list));
+  }
+
   uint32_t size = GetNumAllocated(list);
   return MemoryList(size);
 }
@@ -278,10 +984,8 @@ TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t* lhs,
                                                     TRI_fulltext_list_t* rhs) {
   TRI_fulltext_list_t* list;
   TRI_fulltext_list_entry_t last;
-  TRI_fulltext_list_entry_t* lhsEntries;
-  TRI_fulltext_list_entry_t* rhsEntries;
   TRI_fulltext_list_entry_t* listEntries;
-  uint32_t l, r;
+  TRI_fulltext_list_frequency_t* listFrequencies;
   uint32_t numLhs, numRhs;
   uint32_t listPos;
 
@@ -313,43 +1017,55 @@ TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t* lhs,
     return nullptr;
   }
 
-  SortList(lhs);
-  lhsEntries = GetStart(lhs);
-  l = 0;
+  // compressed lists are always sorted
+  if (! IsCompressed(lhs)) {
+    SortList(lhs);
+  }
+
+  if (! IsCompressed(rhs)) {
+    SortList(rhs);
+  }
 
-  SortList(rhs);
-  rhsEntries = GetStart(rhs);
-  r = 0;
+  // merge both lists. compressed lists are read block-wise
+  TRI_fulltext_list_iterator_t l(lhs);
+  TRI_fulltext_list_iterator_t r(rhs);
 
   listPos = 0;
   listEntries = GetStart(list);
+  listFrequencies = GetFrequencies(list);
   last = 0;
 
   while (true) {
-    while (l < numLhs && lhsEntries[l] <= last) {
-      ++l;
+    while (l.valid() && l.value() <= last) {
+      l.next();
     }
 
-    while (r < numRhs && rhsEntries[r] <= last) {
-      ++r;
+    while (r.valid() && r.value() <= last) {
+      r.next();
     }
 
-    if (l >= numLhs && r >= numRhs) {
+    if (! l.valid() && ! r.valid()) {
       break;
     }
 
-    if (l >= numLhs && r < numRhs) {
-      listEntries[listPos++] = last = rhsEntries[r++];
+    TRI_fulltext_list_iterator_t* next;
+
+    if (! l.valid()) {
+      next = &r;
     }
-    else if (l < numLhs && r >= numRhs) {
-      listEntries[listPos++] = last = lhsEntries[l++];
+    else if (! r.valid()) {
+      next = &l;
     }
-    else if (lhsEntries[l] < rhsEntries[r]) {
-      listEntries[listPos++] = last = lhsEntries[l++];
+    else if (l.value() <= r.value()) {
+      next = &l;
     }
     else {
-      listEntries[listPos++] = last = rhsEntries[r++];
+      next = &r;
     }
+
+    listFrequencies[listPos] = static_cast<TRI_fulltext_list_frequency_t>(next->frequency());
+    listEntries[listPos++] = last = next->value();
+    next->next();
   }
 
   SetNumEntries(list, listPos);
@@ -368,15 +1084,6 @@ TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t* lhs,
 
 TRI_fulltext_list_t* TRI_IntersectListFulltextIndex (TRI_fulltext_list_t* lhs,
                                                      TRI_fulltext_list_t* rhs) {
-  TRI_fulltext_list_t* list;
-  TRI_fulltext_list_entry_t last;
-  TRI_fulltext_list_entry_t* lhsEntries;
-  TRI_fulltext_list_entry_t* rhsEntries;
-  TRI_fulltext_list_entry_t* listEntries;
-  uint32_t l, r;
-  uint32_t numLhs, numRhs;
-  uint32_t listPos;
-
   // check if one of the pointers is NULL
   if (lhs == nullptr) {
     return rhs;
@@ -386,82 +1093,78 @@ TRI_fulltext_list_t* TRI_IntersectListFulltextIndex (TRI_fulltext_list_t* lhs,
     return lhs;
   }
 
-  numLhs = GetNumEntries(lhs);
-  numRhs = GetNumEntries(rhs);
+  // iterate over the smaller of the two lists and seek in the bigger one
+  if (IsCompressed(lhs) || 
+      (! IsCompressed(rhs) && GetNumEntries(rhs) < GetNumEntries(lhs))) {
+    std::swap(lhs, rhs);
+  }
 
-  // printf("list intersection lhs: %lu rhs: %lu\n\n", (unsigned long) numLhs, (unsigned long) numRhs);
+  if (IsCompressed(lhs)) {
+    // both lists are compressed. we need an uncompressed one to write into
+    TRI_fulltext_list_t* copy = TRI_CloneListFulltextIndex(lhs);
+    TRI_FreeListFulltextIndex(lhs);
 
-  // check the easy cases when one of the lists is empty
-  if (numLhs == 0 || numRhs == 0) {
-    if (lhs != nullptr) {
-      TRI_FreeListFulltextIndex(lhs);
-    }
-    if (rhs != nullptr) {
+    if (copy == nullptr) {
       TRI_FreeListFulltextIndex(rhs);
+      return nullptr;
     }
 
-    return TRI_CreateListFulltextIndex(0);
+    lhs = copy;
   }
 
+  lhs = TRI_IntersectStoredListFulltextIndex(lhs, rhs);
+  TRI_FreeListFulltextIndex(rhs);
 
-  // we have at least one entry in each list
-  list = TRI_CreateListFulltextIndex(numLhs < numRhs ? numLhs : numRhs);
-  if (list == nullptr) {
-    TRI_FreeListFulltextIndex(lhs);
-    TRI_FreeListFulltextIndex(rhs);
-    return nullptr;
-  }
-
-  SortList(lhs);
-  lhsEntries = GetStart(lhs);
-  l = 0;
+  return lhs;
+}
 
-  SortList(rhs);
-  rhsEntries = GetStart(rhs);
-  r = 0;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief intersect a list with a list that must not be modified
+/// this will modify lhs in place and leave the other list untouched
+////////////////////////////////////////////////////////////////////////////////
 
-  listPos = 0;
-  listEntries = GetStart(list);
-  last = 0;
+TRI_fulltext_list_t* TRI_IntersectStoredListFulltextIndex (TRI_fulltext_list_t* lhs,
+                                                           TRI_fulltext_list_t const* stored) {
+  if (lhs == nullptr) {
+    return TRI_CloneListFulltextIndex(stored);
+  }
 
-  while (true) {
-    while (l < numLhs && lhsEntries[l] <= last) {
-      ++l;
-    }
+  if (stored == nullptr || GetNumEntries(stored) == 0) {
+    SetNumEntries(lhs, 0);
+    return lhs;
+  }
 
-    while (r < numRhs && rhsEntries[r] <= last) {
-      ++r;
-    }
+  if (GetNumEntries(lhs) == 0) {
+    return lhs;
+  }
 
-again:
-    if (l >= numLhs || r >= numRhs) {
-      break;
-    }
+  if (IsCompressed(lhs)) {
+    TRI_fulltext_list_t* copy = TRI_CloneListFulltextIndex(lhs);
+    TRI_FreeListFulltextIndex(lhs);
 
-    if (lhsEntries[l] < rhsEntries[r]) {
-      ++l;
-      goto again;
-    }
-    else if (lhsEntries[l] > rhsEntries[r]) {
-      ++r;
-      goto again;
+    if (copy == nullptr) {
+      return nullptr;
     }
 
-    // match
-    listEntries[listPos++] = last = lhsEntries[l];
-    ++l;
-    ++r;
+    lhs = copy;
   }
 
-  SetNumEntries(list, listPos);
-  SetIsSorted(list, true);
+  bool mustFree;
+  TRI_fulltext_list_t const* other = SortedView(stored, mustFree);
 
-  TRI_FreeListFulltextIndex(lhs);
-  TRI_FreeListFulltextIndex(rhs);
+  if (other == nullptr) {
+    TRI_FreeListFulltextIndex(lhs);
+    return nullptr;
+  }
 
-  // printf("result list has %lu\n\n", (unsigned long) listPos);
+  SortList(lhs);
+  IntersectInPlace(lhs, other);
 
-  return list;
+  if (mustFree) {
+    TRI_FreeListFulltextIndex(const_cast<TRI_fulltext_list_t*>(other));
+  }
+
+  return lhs;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -471,12 +1174,6 @@ again:
 
 TRI_fulltext_list_t* TRI_ExcludeListFulltextIndex (TRI_fulltext_list_t* list,
                                                    TRI_fulltext_list_t* exclude) {
-  TRI_fulltext_list_entry_t* listEntries;
-  TRI_fulltext_list_entry_t* excludeEntries;
-  uint32_t numEntries;
-  uint32_t numExclude;
-  uint32_t i, j, listPos;
-
   if (list == nullptr) {
     TRI_FreeListFulltextIndex(exclude);
     return list;
@@ -486,60 +1183,125 @@ TRI_fulltext_list_t* TRI_ExcludeListFulltextIndex (TRI_fulltext_list_t* list,
     return list;
   }
 
-  numEntries = GetNumEntries(list);
-  numExclude = GetNumEntries(exclude);
+  list = TRI_ExcludeStoredListFulltextIndex(list, exclude);
+  TRI_FreeListFulltextIndex(exclude);
 
-  if (numEntries == 0 || numExclude == 0) {
-    // original list or exclusion list are empty
-    TRI_FreeListFulltextIndex(exclude);
+  return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief exclude the values of a list that must not be modified
+/// this will modify list in place and leave the other list untouched
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_t* TRI_ExcludeStoredListFulltextIndex (TRI_fulltext_list_t* list,
+                                                         TRI_fulltext_list_t const* stored) {
+  if (list == nullptr || stored == nullptr) {
     return list;
   }
 
-  SortList(list);
-
-  listEntries    = GetStart(list);
-  excludeEntries = GetStart(exclude);
+  if (GetNumEntries(list) == 0 || GetNumEntries(stored) == 0) {
+    // original list or exclusion list are empty
+    return list;
+  }
 
-  j = 0;
-  listPos = 0;
-  for (i = 0; i < numEntries; ++i) {
-    TRI_fulltext_list_entry_t entry;
+  if (IsCompressed(list)) {
+    TRI_fulltext_list_t* copy = TRI_CloneListFulltextIndex(list);
+    TRI_FreeListFulltextIndex(list);
 
-    entry = listEntries[i];
-    while (j < numExclude && excludeEntries[j] < entry) {
-      ++j;
+    if (copy == nullptr) {
+      return nullptr;
     }
 
-    if (j < numExclude && excludeEntries[j] == entry) {
-      // entry is contained in exclusion list
-      continue;
-    }
+    list = copy;
+  }
 
-    if (listPos != i) {
-      listEntries[listPos] = listEntries[i];
-    }
-    ++listPos;
+  bool mustFree;
+  TRI_fulltext_list_t const* other = SortedView(stored, mustFree);
+
+  if (other == nullptr) {
+    TRI_FreeListFulltextIndex(list);
+    return nullptr;
   }
 
-  // we may have less results in the list of exclusion
-  SetNumEntries(list, listPos);
-  TRI_FreeListFulltextIndex(exclude);
+  SortList(list);
+  ExcludeInPlace(list, other);
+
+  if (mustFree) {
+    TRI_FreeListFulltextIndex(const_cast<TRI_fulltext_list_t*>(other));
+  }
 
   return list;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief insert an element into a list
+/// @brief insert an element with its frequency into a list
 /// this might free the old list and allocate a new, bigger one
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t* list,
-                                                  const TRI_fulltext_list_entry_t entry) {
+                                                  const TRI_fulltext_list_entry_t entry,
+                                                  uint32_t frequency) {
   TRI_fulltext_list_entry_t* listEntries;
   uint32_t numAllocated;
   uint32_t numEntries;
   bool unsort;
 
+  if (frequency > TRI_FULLTEXT_LIST_MAX_FREQUENCY) {
+    frequency = TRI_FULLTEXT_LIST_MAX_FREQUENCY;
+  }
+
+  if (IsCompressed(list)) {
+    compressed_list_t* compressed = static_cast<compressed_list_t*>(list);
+
+    TRI_fulltext_list_entry_t lastEntry = 0;
+
+    if (compressed->_numTail > 0) {
+      lastEntry = compressed->_tail[compressed->_numTail - 1];
+    }
+    else if (compressed->_numBlocks > 0) {
+      lastEntry = compressed->_blocks[compressed->_numBlocks - 1]._last;
+    }
+
+    if (entry == lastEntry) {
+      // entry is already contained. no need to insert the same value again
+      return list;
+    }
+
+    if (entry < lastEntry) {
+      // compressed lists must be sorted. fall back to an uncompressed list,
+      // which will be compressed again when it grows
+      TRI_fulltext_list_t* copy = DecompressList(compressed, 1);
+
+      if (copy == nullptr) {
+        return nullptr;
+      }
+
+      uint32_t n = GetNumEntries(copy);
+      GetStart(copy)[n] = entry;
+      GetFrequencies(copy)[n] = static_cast<TRI_fulltext_list_frequency_t>(frequency);
+      SetNumEntries(copy, n + 1);
+      SetIsSorted(copy, false);
+
+      FreeCompressedList(compressed);
+
+      return copy;
+    }
+
+    if (compressed->_numTail == BLOCK_SIZE) {
+      // compressing the tail failed in a previous call
+      if (! AppendBlock(compressed, compressed->_tail, compressed->_tailFrequencies)) {
+        return nullptr;
+      }
+
+      compressed->_numTail = 0;
+    }
+
+    AppendTail(compressed, entry, static_cast<TRI_fulltext_list_frequency_t>(frequency));
+
+    return list;
+  }
+
   numAllocated = GetNumAllocated(list);
   numEntries   = GetNumEntries(list);
   listEntries  = GetStart(list);
@@ -562,6 +1324,17 @@ TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t* list,
     }
   }
 
+  if (numEntries + 1 >= COMPRESS_THRESHOLD && ! unsort) {
+    // the list has become big enough to be compressed
+    TRI_fulltext_list_t* compressed = CompressList(list);
+
+    if (compressed != nullptr) {
+      return TRI_InsertListFulltextIndex(compressed, entry, frequency);
+    }
+
+    // out of memory. we'll try to continue with the uncompressed list
+  }
+
   if (numEntries + 1 >= numAllocated) {
     // must allocate more memory
     TRI_fulltext_list_t* clone;
@@ -581,10 +1354,7 @@ TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t* list,
     }
 
     // switch over
-    if (list != clone) {
-      list = clone;
-      listEntries = GetStart(list);
-    }
+    list = clone;
   }
 
   if (unsort) {
@@ -592,12 +1362,23 @@ TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t* list,
   }
 
   // insert at the end
-  listEntries[numEntries] = entry;
+  GetStart(list)[numEntries] = entry;
+  GetFrequencies(list)[numEntries] = static_cast<TRI_fulltext_list_frequency_t>(frequency);
   SetNumEntries(list, numEntries + 1);
 
   return list;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sort a list in place
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SortListFulltextIndex (TRI_fulltext_list_t* list) {
+  TRI_ASSERT(! IsCompressed(list));
+
+  SortList(list);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief rewrites the list of entries using a map of handles
 /// returns the number of entries remaining in the list after rewrite
@@ -607,6 +1388,7 @@ TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t* list,
 uint32_t TRI_RewriteListFulltextIndex (TRI_fulltext_list_t* list,
                                        void const* data) {
   TRI_fulltext_list_entry_t* listEntries;
+  TRI_fulltext_list_frequency_t* listFrequencies;
   TRI_fulltext_list_entry_t* map;
   uint32_t numEntries;
   uint32_t i, j;
@@ -616,8 +1398,47 @@ uint32_t TRI_RewriteListFulltextIndex (TRI_fulltext_list_t* list,
     return 0;
   }
 
+  if (IsCompressed(list)) {
+    // decompress, rewrite and compress again
+    compressed_list_t* compressed = static_cast<compressed_list_t*>(list);
+    TRI_fulltext_list_t* copy = DecompressList(compressed, 0);
+
+    if (copy == nullptr) {
+      // out of memory. keep the list as it is
+      return numEntries;
+    }
+
+    uint32_t remain = TRI_RewriteListFulltextIndex(copy, data);
+
+    if (! std::is_sorted(GetStart(copy), GetStart(copy) + remain)) {
+      SetIsSorted(copy, false);
+      SortList(copy);
+    }
+
+    compressed_list_t* rewritten = CreateCompressedList();
+
+    if (rewritten == nullptr || 
+        ! FillCompressedList(rewritten, GetStart(copy), GetFrequencies(copy), remain)) {
+      if (rewritten != nullptr) {
+        FreeCompressedList(rewritten);
+      }
+      TRI_FreeListFulltextIndex(copy);
+      return numEntries;
+    }
+
+    TRI_FreeListFulltextIndex(copy);
+    ShrinkCompressedList(rewritten);
+
+    // swap the contents into the existing list, so the list pointer stays valid
+    std::swap(*compressed, *rewritten);
+    FreeCompressedList(rewritten);
+
+    return compressed->_numEntries;
+  }
+
   map = (TRI_fulltext_list_entry_t*) data;
   listEntries = GetStart(list);
+  listFrequencies = GetFrequencies(list);
   j = 0;
 
   for (i = 0; i < numEntries; ++i) {
@@ -635,6 +1456,7 @@ uint32_t TRI_RewriteListFulltextIndex (TRI_fulltext_list_t* list,
       continue;
     }
 
+    listFrequencies[j] = listFrequencies[i];
     listEntries[j++] = mapped;
   }
 
@@ -651,24 +1473,19 @@ uint32_t TRI_RewriteListFulltextIndex (TRI_fulltext_list_t* list,
 
 #if TRI_FULLTEXT_DEBUG
 void TRI_DumpListFulltextIndex (TRI_fulltext_list_t const* list) {
-  TRI_fulltext_list_entry_t* listEntries;
-  uint32_t numEntries;
-  uint32_t i;
-
-  numEntries = GetNumEntries(list);
-  listEntries = GetStart(list);
+  TRI_fulltext_list_iterator_t it(list);
+  bool first = true;
 
   printf("(");
 
-  for (i = 0; i < numEntries; ++i) {
-    TRI_fulltext_list_entry_t entry;
-
-    if (i > 0) {
+  while (it.valid()) {
+    if (! first) {
       printf(", ");
     }
+    first = false;
 
-    entry = listEntries[i];
-    printf("%lu", (unsigned long) entry);
+    printf("%lu", (unsigned long) it.value());
+    it.next();
   }
 
   printf(")");
@@ -683,11 +1500,36 @@ uint32_t TRI_NumEntriesListFulltextIndex (TRI_fulltext_list_t const* list) {
   return GetNumEntries(list);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum frequency of all entries
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_MaxFrequencyListFulltextIndex (TRI_fulltext_list_t const* list) {
+  if (IsCompressed(list)) {
+    return static_cast<compressed_list_t const*>(list)->_maxFrequency;
+  }
+
+  TRI_fulltext_list_frequency_t const* listFrequencies = GetFrequencies(list);
+  uint32_t const numEntries = GetNumEntries(list);
+  uint32_t result = 0;
+
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    if (listFrequencies[i] > result) {
+      result = listFrequencies[i];
+    }
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a pointer to the first list entry
+/// must only be called for uncompressed lists
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_entry_t* TRI_StartListFulltextIndex (TRI_fulltext_list_t const* list) {
+  TRI_ASSERT(! IsCompressed(list));
+
   return GetStart(list);
 }
 
@@ -32,6 +32,22 @@
 
 #include "fulltext-common.h"
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public defines
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries in a block of a compressed list
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_FULLTEXT_LIST_BLOCK_SIZE 128
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum frequency stored for a list entry
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_FULLTEXT_LIST_MAX_FREQUENCY 255
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -48,6 +64,67 @@ typedef void TRI_fulltext_list_t;
 
 typedef uint32_t TRI_fulltext_list_entry_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief typedef for the frequency of a fulltext list entry
+/// this is the number of occurrences of a word in a document
+////////////////////////////////////////////////////////////////////////////////
+
+typedef uint8_t TRI_fulltext_list_frequency_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief forward iterator over a sorted list
+///
+/// the iterator can be used for both compressed and uncompressed lists.
+/// compressed lists are decoded one block at a time. seeking uses the skip
+/// entries of the blocks, so blocks that cannot contain the target are not
+/// decoded at all. the list must not be modified while it is iterated
+////////////////////////////////////////////////////////////////////////////////
+
+class TRI_fulltext_list_iterator_t {
+
+  public:
+
+    explicit TRI_fulltext_list_iterator_t (TRI_fulltext_list_t const*);
+
+  public:
+
+    inline bool valid () const {
+      return _position < _length;
+    }
+
+    inline TRI_fulltext_list_entry_t value () const {
+      return _entries[_position];
+    }
+
+    inline uint32_t frequency () const {
+      return _frequencies[_position];
+    }
+
+    void next ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position the iterator at the first entry >= target
+/// the iterator only moves forward
+////////////////////////////////////////////////////////////////////////////////
+
+    void seek (TRI_fulltext_list_entry_t);
+
+  private:
+
+    void load (uint32_t);
+
+  private:
+
+    void const*                          _compressed;
+    TRI_fulltext_list_entry_t const*     _entries;
+    TRI_fulltext_list_frequency_t const* _frequencies;
+    uint32_t                             _length;
+    uint32_t                             _position;
+    uint32_t                             _block;
+    TRI_fulltext_list_entry_t            _entryBuffer[TRI_FULLTEXT_LIST_BLOCK_SIZE];
+    TRI_fulltext_list_frequency_t        _frequencyBuffer[TRI_FULLTEXT_LIST_BLOCK_SIZE];
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -96,6 +173,14 @@ TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t*,
 TRI_fulltext_list_t* TRI_IntersectListFulltextIndex (TRI_fulltext_list_t*,
                                                      TRI_fulltext_list_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief intersect a list with a list owned by the index
+/// this will modify the first list in place and not modify the second
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_t* TRI_IntersectStoredListFulltextIndex (TRI_fulltext_list_t*,
+                                                           TRI_fulltext_list_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief exclude values from a list
 /// this will modify the result in place
@@ -105,12 +190,28 @@ TRI_fulltext_list_t* TRI_ExcludeListFulltextIndex (TRI_fulltext_list_t*,
                                                    TRI_fulltext_list_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief insert an element into a list
+/// @brief exclude the values of a list owned by the index
+/// this will modify the first list in place and not modify the second
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_t* TRI_ExcludeStoredListFulltextIndex (TRI_fulltext_list_t*,
+                                                         TRI_fulltext_list_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert an element with its frequency into a list
 /// this might free the old list and allocate a new, bigger one
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_t* TRI_InsertListFulltextIndex (TRI_fulltext_list_t*,
-                                                  const TRI_fulltext_list_entry_t);
+                                                  const TRI_fulltext_list_entry_t,
+                                                  uint32_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sort a list in place
+/// must not be called for lists owned by the index, which may be compressed
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SortListFulltextIndex (TRI_fulltext_list_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief rewrites the list of entries using a map of values
@@ -134,8 +235,15 @@ void TRI_DumpListFulltextIndex (TRI_fulltext_list_t const*);
 
 uint32_t TRI_NumEntriesListFulltextIndex (TRI_fulltext_list_t const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum frequency of all entries
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_MaxFrequencyListFulltextIndex (TRI_fulltext_list_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a pointer to the first list entry
+/// must not be called for lists owned by the index, which may be compressed
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_entry_t* TRI_StartListFulltextIndex (TRI_fulltext_list_t const*);
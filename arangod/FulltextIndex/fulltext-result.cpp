@@ -45,6 +45,7 @@ TRI_fulltext_result_t* TRI_CreateResultFulltextIndex (const uint32_t size) {
   }
 
   result->_documents    = nullptr;
+  result->_scores       = nullptr;
   result->_numDocuments = 0;
 
   if (size > 0) {
@@ -59,6 +60,27 @@ TRI_fulltext_result_t* TRI_CreateResultFulltextIndex (const uint32_t size) {
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a result with relevance scores
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_result_t* TRI_CreateRankedResultFulltextIndex (const uint32_t size) {
+  TRI_fulltext_result_t* result = TRI_CreateResultFulltextIndex(size);
+
+  if (result == nullptr || size == 0) {
+    return result;
+  }
+
+  result->_scores = static_cast<double*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(double) * size, false));
+
+  if (result->_scores == nullptr) {
+    TRI_FreeResultFulltextIndex(result);
+    return nullptr;
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy a result
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +89,10 @@ void TRI_DestroyResultFulltextIndex (TRI_fulltext_result_t* result) {
   if (result->_documents != nullptr) {
     TRI_Free(TRI_UNKNOWN_MEM_ZONE, result->_documents);
   }
+
+  if (result->_scores != nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, result->_scores);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
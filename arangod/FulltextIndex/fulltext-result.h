@@ -43,6 +43,7 @@
 typedef struct TRI_fulltext_result_s {
   uint32_t             _numDocuments;
   TRI_fulltext_doc_t*  _documents;
+  double*              _scores;       // relevance scores, nullptr if unranked
 }
 TRI_fulltext_result_t;
 
@@ -56,6 +57,12 @@ TRI_fulltext_result_t;
 
 TRI_fulltext_result_t* TRI_CreateResultFulltextIndex (const uint32_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a result with relevance scores
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_result_t* TRI_CreateRankedResultFulltextIndex (const uint32_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy a result
 ////////////////////////////////////////////////////////////////////////////////
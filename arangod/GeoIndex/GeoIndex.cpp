@@ -33,6 +33,7 @@
 #include <math.h>
 
 #include "GeoIndex.h"
+#include "Basics/ThreadPool.h"
 
     /* Radius of the earth used for distances  */
 #define EARTHRADIUS 6371000.0
@@ -1236,6 +1237,572 @@ GeoCoordinates * GeoIndex_NearestCountPoints(GeoIndex * gi,
     return answer;   /* note - this may be NULL  */
 }
 /* =================================================== */
+/*                  GeoShape structure                 */
+/* The searches by rectangle and by polygon are given  */
+/* a shape rather than a target point.  The shape is   */
+/* held here together with its bounding box (in        */
+/* degrees) which is all that is needed for a rectangle*/
+/* A polygon additionally has its vertices, taken as a */
+/* closed ring in the latitude/longitude plane.        */
+/* =================================================== */
+typedef struct
+{
+    double latlo;
+    double lathi;
+    double lonlo;
+    double lonhi;
+    int vertexct;
+    GeoCoordinate * vertices;
+}
+GeoShape;
+/* =================================================== */
+/*                  GeoRange structure                 */
+/* A covering of a shape is a sorted list of disjoint  */
+/* ranges of GeoString (Hilbert) values.  Every point  */
+/* inside the shape has a GeoString in one of these    */
+/* ranges.  If "inside" is set, all points with a      */
+/* GeoString in the range are known to be inside the   */
+/* shape, otherwise they must be tested individually   */
+/* =================================================== */
+typedef struct
+{
+    GeoString start;
+    GeoString end;
+    int inside;
+}
+GeoRange;
+/* =================================================== */
+/*                  GeoCell structure                  */
+/* During the computation of a covering, the Hilbert   */
+/* square of each hemisphere is divided recursively    */
+/* into quadrants, exactly as GeoMkHilbert does.  A    */
+/* cell is one such quadrant at some level.  prefix    */
+/* holds the Hilbert digits chosen so far (including   */
+/* the hemisphere bit).  Since the quadrants are       */
+/* flipped and swapped on the way down, the cell also  */
+/* keeps the mapping from its local coordinates (0 to  */
+/* size-1 in each direction) to the integer coordinates*/
+/* used by GeoMkHilbert: x = a*lx + b*ly + c and       */
+/* y = d*lx + e*ly + f                                 */
+/* =================================================== */
+typedef struct
+{
+    GeoString prefix;
+    int level;
+    long long a,b,c,d,e,f;
+}
+GeoCell;
+/* =================================================== */
+/*                  GeoCovering structure              */
+/* Holds the ranges of a covering while it is built    */
+/* =================================================== */
+typedef struct
+{
+    int rangect;
+    int allocranges;
+    GeoRange * ranges;
+}
+GeoCovering;
+
+    /* maximum number of cells refined per level when  */
+    /* computing a covering.  More cells give a tighter*/
+    /* covering, but take longer to compute            */
+#define GEOCOVERCELLS 32
+    /* tolerance (in degrees) used when comparing a    */
+    /* cell to a shape, so that rounding can never     */
+    /* cause a point to be lost                        */
+#define GEOCOVEREPS 1e-9
+/* =================================================== */
+/*                GeoCellBounds                        */
+/* computes the bounding box, in degrees, of all the   */
+/* points whose GeoString lies in the cell.  The corner*/
+/* cells of the local square are mapped back to the    */
+/* GeoMkHilbert integer coordinates, and those are     */
+/* converted into degrees, undoing the shift of the    */
+/* western hemisphere.                                 */
+/* =================================================== */
+void GeoCellBounds(GeoCell * cell, double * latlo, double * lathi,
+                   double * lonlo, double * lonhi)
+{
+    long long size,x0,y0,x1,y1,t;
+    double hemi;
+    size=1ll<<(26-cell->level);
+    x0=cell->c;
+    y0=cell->f;
+    x1=cell->a*(size-1)+cell->b*(size-1)+cell->c;
+    y1=cell->d*(size-1)+cell->e*(size-1)+cell->f;
+    if(x0>x1) { t=x0; x0=x1; x1=t; }
+    if(y0>y1) { t=y0; y0=y1; y1=t; }
+    hemi=0.0;
+    if( ((cell->prefix)>>(2*cell->level)) != 0) hemi=-180.0;
+    *lonlo=((double) x0)/STRINGPERDEGREE+hemi;
+    *lonhi=((double) (x1+1))/STRINGPERDEGREE+hemi;
+    *latlo=((double) y0)/STRINGPERDEGREE-90.0;
+    *lathi=((double) (y1+1))/STRINGPERDEGREE-90.0;
+}
+/* =================================================== */
+/*                GeoCellChild                         */
+/* computes the child cell in quadrant nz (numbered as */
+/* in GeoMkHilbert, 2*y-bit + x-bit) of a cell, by     */
+/* composing the flip and swap of that quadrant with   */
+/* the mapping of the parent cell                      */
+/* =================================================== */
+void GeoCellChild(GeoCell * parent, int nz, GeoCell * child)
+{
+    long long half,lx0,ly0,l1,l2,m1,m2;
+    int digit;
+    half=1ll<<(25-parent->level);
+    if(nz==0)
+    {       /* swapped  */
+        lx0=0;        l1=0;  l2=1;
+        ly0=0;        m1=1;  m2=0;
+        digit=0;
+    }
+    else if(nz==1)
+    {       /* swapped and flipped  */
+        lx0=2*half-1; l1=0;  l2=-1;
+        ly0=half-1;   m1=-1; m2=0;
+        digit=3;
+    }
+    else if(nz==2)
+    {
+        lx0=0;        l1=1;  l2=0;
+        ly0=half;     m1=0;  m2=1;
+        digit=1;
+    }
+    else
+    {
+        lx0=half;     l1=1;  l2=0;
+        ly0=half;     m1=0;  m2=1;
+        digit=2;
+    }
+    child->prefix=(parent->prefix<<2)+digit;
+    child->level=parent->level+1;
+    child->a=parent->a*l1+parent->b*m1;
+    child->b=parent->a*l2+parent->b*m2;
+    child->c=parent->a*lx0+parent->b*ly0+parent->c;
+    child->d=parent->d*l1+parent->e*m1;
+    child->e=parent->d*l2+parent->e*m2;
+    child->f=parent->d*lx0+parent->e*ly0+parent->f;
+}
+/* =================================================== */
+/*                GeoSegmentMeetsBox                   */
+/* returns 1 if the segment from (x0,y0) to (x1,y1)    */
+/* has at least one point in common with the box, using*/
+/* the Liang-Barsky clipping of the segment to the box */
+/* =================================================== */
+int GeoSegmentMeetsBox(double x0, double y0, double x1, double y1,
+                       double xlo, double xhi, double ylo, double yhi)
+{
+    double t0,t1,dx,dy,p[4],q[4],r;
+    int i;
+    t0=0.0;
+    t1=1.0;
+    dx=x1-x0;
+    dy=y1-y0;
+    p[0]=-dx; q[0]=x0-xlo;
+    p[1]=dx;  q[1]=xhi-x0;
+    p[2]=-dy; q[2]=y0-ylo;
+    p[3]=dy;  q[3]=yhi-y0;
+    for(i=0;i<4;i++)
+    {
+        if(p[i]==0.0)
+        {
+            if(q[i]<0.0) return 0;
+            continue;
+        }
+        r=q[i]/p[i];
+        if(p[i]<0.0)
+        {
+            if(r>t1) return 0;
+            if(r>t0) t0=r;
+        }
+        else
+        {
+            if(r<t0) return 0;
+            if(r<t1) t1=r;
+        }
+    }
+    return 1;
+}
+/* =================================================== */
+/*                GeoPolygonContains                   */
+/* the exact test of a point against a polygon.  The   */
+/* polygon is taken in the (longitude, latitude) plane */
+/* and the even-odd rule is used, counting the edges   */
+/* crossed by a ray from the point.  Points on an edge */
+/* are considered to be inside the polygon.            */
+/* =================================================== */
+int GeoPolygonContains(GeoShape * gs, double lat, double lon)
+{
+    int i,j,in;
+    double xi,yi,xj,yj,cross;
+    in=0;
+    j=gs->vertexct-1;
+    for(i=0;i<gs->vertexct;i++)
+    {
+        xi=gs->vertices[i].longitude;
+        yi=gs->vertices[i].latitude;
+        xj=gs->vertices[j].longitude;
+        yj=gs->vertices[j].latitude;
+        j=i;
+        cross=(xj-xi)*(lat-yi)-(yj-yi)*(lon-xi);
+        if( (fabs(cross)<=1e-12) &&
+            (lon>=fmin(xi,xj)) && (lon<=fmax(xi,xj)) &&
+            (lat>=fmin(yi,yj)) && (lat<=fmax(yi,yj)) ) return 1;
+        if( (yi>lat) != (yj>lat) )
+        {
+            if(lon < (xj-xi)*(lat-yi)/(yj-yi)+xi) in=1-in;
+        }
+    }
+    return in;
+}
+/* =================================================== */
+/*                GeoShapeContains                     */
+/* the exact test of a point against a shape           */
+/* =================================================== */
+int GeoShapeContains(GeoShape * gs, GeoCoordinate * c)
+{
+    if( (c->latitude<gs->latlo) || (c->latitude>gs->lathi) ||
+        (c->longitude<gs->lonlo) || (c->longitude>gs->lonhi) ) return 0;
+    if(gs->vertexct==0) return 1;
+    return GeoPolygonContains(gs,c->latitude,c->longitude);
+}
+/* =================================================== */
+/*                GeoCellClassify                      */
+/* compares a cell to a shape.  Returns 0 if no point  */
+/* in the cell can be inside the shape, 2 if all the   */
+/* points in the cell are inside it, and 1 otherwise.  */
+/* The comparisons are done with a small tolerance, so */
+/* that the answer is 1 whenever there is any doubt    */
+/* A polygon that has no edge meeting the cell either  */
+/* contains the whole cell or none of it, which is     */
+/* then decided by testing the centre of the cell      */
+/* =================================================== */
+int GeoCellClassify(GeoShape * gs, GeoCell * cell)
+{
+    double latlo,lathi,lonlo,lonhi;
+    int i,j;
+    GeoCellBounds(cell,&latlo,&lathi,&lonlo,&lonhi);
+    if( (lathi+GEOCOVEREPS < gs->latlo) ||
+        (latlo-GEOCOVEREPS > gs->lathi) ||
+        (lonhi+GEOCOVEREPS < gs->lonlo) ||
+        (lonlo-GEOCOVEREPS > gs->lonhi) ) return 0;
+    if(gs->vertexct==0)
+    {
+        if( (latlo-GEOCOVEREPS >= gs->latlo) &&
+            (lathi+GEOCOVEREPS <= gs->lathi) &&
+            (lonlo-GEOCOVEREPS >= gs->lonlo) &&
+            (lonhi+GEOCOVEREPS <= gs->lonhi) ) return 2;
+        return 1;
+    }
+    j=gs->vertexct-1;
+    for(i=0;i<gs->vertexct;i++)
+    {
+        if(GeoSegmentMeetsBox(gs->vertices[j].longitude,
+                              gs->vertices[j].latitude,
+                              gs->vertices[i].longitude,
+                              gs->vertices[i].latitude,
+                              lonlo-GEOCOVEREPS, lonhi+GEOCOVEREPS,
+                              latlo-GEOCOVEREPS, lathi+GEOCOVEREPS)) return 1;
+        j=i;
+    }
+    if(GeoPolygonContains(gs,(latlo+lathi)/2.0,(lonlo+lonhi)/2.0)) return 2;
+    return 0;
+}
+/* =================================================== */
+/*                GeoCoveringAdd                       */
+/* appends the range of GeoStrings of a cell to the    */
+/* covering.  Returns -1 if there is not enough memory */
+/* =================================================== */
+int GeoCoveringAdd(GeoCovering * cov, GeoCell * cell, int inside)
+{
+    int shift,newsiz;
+    GeoRange * gr;
+    if(cov->rangect>=cov->allocranges)
+    {
+        newsiz=cov->allocranges+(cov->allocranges/2)+16;
+        gr=static_cast<GeoRange*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, cov->ranges, newsiz*sizeof(GeoRange)));
+        if(gr==NULL) return -1;
+        cov->ranges=gr;
+        cov->allocranges=newsiz;
+    }
+    shift=2*(26-cell->level);
+    gr=cov->ranges+cov->rangect;
+    gr->start=(cell->prefix<<shift)+1ll;
+    gr->end=(cell->prefix+1ll)<<shift;
+    gr->inside=inside;
+    cov->rangect++;
+    return 0;
+}
+/* =================================================== */
+/*                GeoRangeCompare                      */
+/* =================================================== */
+static int GeoRangeCompare(const void * l, const void * r)
+{
+    GeoString ls,rs;
+    ls=(static_cast<GeoRange const*>(l))->start;
+    rs=(static_cast<GeoRange const*>(r))->start;
+    if(ls<rs) return -1;
+    if(ls>rs) return 1;
+    return 0;
+}
+/* =================================================== */
+/*                GeoCover                             */
+/* Computes a covering of the shape.  Starting with    */
+/* the two hemispheres, the cells that are partly in   */
+/* the shape are refined, level by level, into their   */
+/* four quadrants.  Cells entirely outside the shape   */
+/* are dropped and cells entirely inside it are added  */
+/* to the covering straight away.  The refinement stops*/
+/* at the full resolution of the GeoString or when the */
+/* next level would have more than GEOCOVERCELLS cells */
+/* to look at, and the cells still partly in the shape */
+/* are then added to the covering as they are.  At the */
+/* end the ranges are sorted, and adjacent ranges are  */
+/* merged.  Returns -1 if there is not enough memory   */
+/* =================================================== */
+int GeoCover(GeoShape * gs, GeoCovering * cov)
+{
+    GeoCell * cells;
+    GeoCell * next;
+    GeoCell * temp;
+    GeoCell child;
+    int cellct,nextct,i,nz,k,j,res;
+    cov->rangect=0;
+    cov->allocranges=0;
+    cov->ranges=NULL;
+    cells=static_cast<GeoCell*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, 4*GEOCOVERCELLS*sizeof(GeoCell), false));
+    next=static_cast<GeoCell*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, 4*GEOCOVERCELLS*sizeof(GeoCell), false));
+    if( (cells==NULL) || (next==NULL) )
+    {
+        if(cells!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, cells);
+        if(next!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, next);
+        return -1;
+    }
+    cellct=0;
+    for(i=0;i<2;i++)
+    {
+        cells[cellct].prefix=i;
+        cells[cellct].level=0;
+        cells[cellct].a=1; cells[cellct].b=0; cells[cellct].c=0;
+        cells[cellct].d=0; cells[cellct].e=1; cells[cellct].f=0;
+        res=GeoCellClassify(gs,cells+cellct);
+        if(res==0) continue;
+        if(res==2)
+        {
+            if(GeoCoveringAdd(cov,cells+cellct,1)==-1) goto fail;
+            continue;
+        }
+        cellct++;
+    }
+    while( (cellct>0) && (cellct<=GEOCOVERCELLS) &&
+           (cells[0].level<26) )
+    {
+        nextct=0;
+        for(i=0;i<cellct;i++)
+        {
+            for(nz=0;nz<4;nz++)
+            {
+                GeoCellChild(cells+i,nz,&child);
+                res=GeoCellClassify(gs,&child);
+                if(res==0) continue;
+                if(res==2)
+                {
+                    if(GeoCoveringAdd(cov,&child,1)==-1) goto fail;
+                    continue;
+                }
+                next[nextct++]=child;
+            }
+        }
+        temp=cells;
+        cells=next;
+        next=temp;
+        cellct=nextct;
+    }
+    for(i=0;i<cellct;i++)
+    {
+        if(GeoCoveringAdd(cov,cells+i,0)==-1) goto fail;
+    }
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, cells);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, next);
+    if(cov->rangect==0) return 0;
+    qsort(cov->ranges,cov->rangect,sizeof(GeoRange),GeoRangeCompare);
+/* merge adjacent ranges  */
+    k=0;
+    for(j=1;j<cov->rangect;j++)
+    {
+        if( (cov->ranges[j].start==cov->ranges[k].end+1ll) &&
+            (cov->ranges[j].inside==cov->ranges[k].inside) )
+        {
+            cov->ranges[k].end=cov->ranges[j].end;
+            continue;
+        }
+        k++;
+        cov->ranges[k]=cov->ranges[j];
+    }
+    cov->rangect=k+1;
+    return 0;
+fail:
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, cells);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, next);
+    if(cov->ranges!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, cov->ranges);
+    cov->ranges=NULL;
+    return -1;
+}
+/* =================================================== */
+/*                GeoCoveringFind                      */
+/* returns the index of the first range of the covering*/
+/* that ends at or after the given GeoString, or the   */
+/* number of ranges if there is no such range          */
+/* =================================================== */
+int GeoCoveringFind(GeoCovering * cov, GeoString gs)
+{
+    int lo,hi,mid;
+    lo=0;
+    hi=cov->rangect;
+    while(lo<hi)
+    {
+        mid=(lo+hi)/2;
+        if(cov->ranges[mid].end<gs) lo=mid+1;
+        else                        hi=mid;
+    }
+    return lo;
+}
+/* =================================================== */
+/*                GeoShapeSearch                       */
+/* Finds all the points of the index inside the shape  */
+/* The covering of the shape is computed first.  The   */
+/* pots are then processed from a stack, as in the     */
+/* search by distance, but a pot is only looked at if  */
+/* the range of GeoStrings it holds meets one of the   */
+/* ranges of the covering.  If it lies entirely within */
+/* a range known to be inside the shape, then so do    */
+/* all its descendents, and their points are taken     */
+/* without further ado.  All other points are tested   */
+/* exactly.  The distances returned are all zero       */
+/* =================================================== */
+GeoCoordinates * GeoShapeSearch(GeoIx * gix, GeoShape * gs)
+{
+    GeoResults * gres;
+    GeoCovering cov;
+    GeoPot * gp;
+    int potid[50];
+    int potin[50];
+    int stacksize,pot,in,slot,i,r;
+    gres=GeoResultsCons(100);
+    if(gres==NULL) return NULL;
+    if(GeoCover(gs,&cov)==-1)
+    {
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->snmd);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->slot);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres);
+        return NULL;
+    }
+    stacksize=0;
+    if(cov.rangect>0)
+    {
+        potid[stacksize]=1;
+        potin[stacksize]=0;
+        stacksize++;
+    }
+    while(stacksize>=1)
+    {
+        stacksize--;
+        pot=potid[stacksize];
+        in=potin[stacksize];
+        gp=gix->pots+pot;
+        if(in==0)
+        {
+            i=GeoCoveringFind(&cov,gp->start);
+            if( (i>=cov.rangect) || (cov.ranges[i].start>gp->end) ) continue;
+            if( (cov.ranges[i].inside!=0) &&
+                (cov.ranges[i].start<=gp->start) &&
+                (cov.ranges[i].end>=gp->end) ) in=1;
+        }
+        if(gp->LorLeaf==0)
+        {
+            for(i=0;i<gp->RorPoints;i++)
+            {
+                slot=gp->points[i];
+                if( (in==0) && (GeoShapeContains(gs,gix->gc+slot)==0) ) continue;
+                r = GeoResultsGrow(gres);
+                if(r==-1)
+                {
+                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, cov.ranges);
+                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->snmd);
+                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->slot);
+                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres);
+                    return NULL;
+                }
+                gres->slot[gres->pointsct]=slot;
+                gres->snmd[gres->pointsct]=0.0;
+                gres->pointsct++;
+            }
+        }
+        else
+        {
+            potid[stacksize]=gp->RorPoints;
+            potin[stacksize]=in;
+            stacksize++;
+            potid[stacksize]=gp->LorLeaf;
+            potin[stacksize]=in;
+            stacksize++;
+        }
+    }
+    if(cov.ranges!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, cov.ranges);
+    return GeoAnswers(gix,gres);   /* note - this may be NULL  */
+}
+/* =================================================== */
+/*           GeoIndex_PointsWithinRectangle            */
+/* The user-visible call to find all the points in the */
+/* index whose latitude and longitude lie between those*/
+/* of the two given corners (inclusive).  The corners  */
+/* may be given in any order.                          */
+/* =================================================== */
+GeoCoordinates * GeoIndex_PointsWithinRectangle(GeoIndex * gi,
+                    double lat1, double lon1, double lat2, double lon2)
+{
+    GeoShape gs;
+    gs.latlo=fmin(lat1,lat2);
+    gs.lathi=fmax(lat1,lat2);
+    gs.lonlo=fmin(lon1,lon2);
+    gs.lonhi=fmax(lon1,lon2);
+    gs.vertexct=0;
+    gs.vertices=NULL;
+    return GeoShapeSearch((GeoIx *) gi,&gs);
+}
+/* =================================================== */
+/*           GeoIndex_PointsWithinPolygon              */
+/* The user-visible call to find all the points in the */
+/* index inside the polygon given by its vertices.  The*/
+/* polygon is closed automatically and is taken to be  */
+/* in the latitude/longitude plane (its edges are      */
+/* straight lines on a map rather than great circles). */
+/* At least three vertices must be given.              */
+/* =================================================== */
+GeoCoordinates * GeoIndex_PointsWithinPolygon(GeoIndex * gi,
+                    GeoCoordinate * vertices, int count)
+{
+    GeoShape gs;
+    int i;
+    if(count<3) return NULL;
+    gs.latlo=vertices[0].latitude;
+    gs.lathi=vertices[0].latitude;
+    gs.lonlo=vertices[0].longitude;
+    gs.lonhi=vertices[0].longitude;
+    for(i=1;i<count;i++)
+    {
+        gs.latlo=fmin(gs.latlo,vertices[i].latitude);
+        gs.lathi=fmax(gs.lathi,vertices[i].latitude);
+        gs.lonlo=fmin(gs.lonlo,vertices[i].longitude);
+        gs.lonhi=fmax(gs.lonhi,vertices[i].longitude);
+    }
+    gs.vertexct=count;
+    gs.vertices=vertices;
+    return GeoShapeSearch((GeoIx *) gi,&gs);
+}
+/* =================================================== */
 /*             GeoIndexFreeSlot                        */
 /* return the specified slot to the free list          */
 /* =================================================== */
@@ -1513,7 +2080,7 @@ void RotateRight(GeoIx * gix, int pote)
     GeoAdjust(gix,pote);
 }
 /* =================================================== */
-/*        GeoIndex_insert                              */
+/*        GeoIndex_insert / GeoInsertDetailed          */
 /* The user-facing routine to insert a new point into  */
 /* the index.  First the index is cast into a GeoIx    */
 /* so that it can be used, and then the point is       */
@@ -1527,13 +2094,12 @@ void RotateRight(GeoIx * gix, int pote)
 /* balancing operation) which starts by obtaining the  */
 /* two new pots. . . continued below                   */
 /* =================================================== */
-int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
+int GeoInsertDetailed(GeoIx * gix, GeoDetailedPoint * gd)
 {
     int i,j,js,slot,pot,pot1,pot2;
     int potx,pota,poty,potz;
     int lvx,lv1,lva,lvy,lvz;
     int height,rebalance;
-    GeoDetailedPoint gd;
     GeoPath gt;
     GeoPot * gp;
     GeoPot * gp1;
@@ -1544,15 +2110,10 @@ int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
     GeoPot * gpa;
     GeoString gsa[2];
     GeoString mings, gs;
-    GeoIx * gix;
-    gix = (GeoIx *) gi;
+    GeoCoordinate * c;
+    c = gd->gc;
     rebalance=0;
-    if(c->longitude < -180.0) return -3;
-    if(c->longitude >  180.0) return -3;
-    if(c->latitude  <  -90.0) return -3;
-    if(c->latitude  >   90.0) return -3;
-    GeoMkDetail(gix,&gd,c);
-    i = GeoFind(&gt,&gd);
+    i = GeoFind(&gt,gd);
     if(i==1) return -1;
     pot=gt.path[gt.pathlength-1];
     gp=gix->pots + pot;
@@ -1634,7 +2195,7 @@ int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
         gp->RorPoints=pot2;
         GeoAdjust(gix,pot);
         gt.pathlength++;
-        if(gd.gs<mings)
+        if(gd->gs<mings)
         {
             gp=gp1;
             gt.path[gt.pathlength-1]=pot1;
@@ -1670,8 +2231,8 @@ int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
         j=gt.pathlength-1;
         while(j>=0)
         {
-            if(gd.fixdist[i] > gix->pots[gt.path[j]].maxdist[i])
-                gix->pots[gt.path[j]].maxdist[i] = gd.fixdist[i];
+            if(gd->fixdist[i] > gix->pots[gt.path[j]].maxdist[i])
+                gix->pots[gt.path[j]].maxdist[i] = gd->fixdist[i];
             else break;
             j--;
         }
@@ -1746,6 +2307,288 @@ int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
     return 0;
 }
 /* =================================================== */
+/*        GeoIndex_insert continued                    */
+/* The user-facing routine itself only checks and      */
+/* details the point and leaves the rest of the work   */
+/* to GeoInsertDetailed, which is also used for the    */
+/* batch insertion below                               */
+/* =================================================== */
+int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c)
+{
+    GeoDetailedPoint gd;
+    GeoIx * gix;
+    gix = (GeoIx *) gi;
+    if(c->longitude < -180.0) return -3;
+    if(c->longitude >  180.0) return -3;
+    if(c->latitude  <  -90.0) return -3;
+    if(c->latitude  >   90.0) return -3;
+    GeoMkDetail(gix,&gd,c);
+    return GeoInsertDetailed(gix,&gd);
+}
+/* =================================================== */
+/*               GeoBatchPoint structure               */
+/* During a batch insertion, the part of the detailed  */
+/* point that is needed to build the index is kept for */
+/* every point in this smaller structure, so that a    */
+/* large batch can be detailed and sorted in one go    */
+/* "index" is the position of the point in the batch   */
+/* =================================================== */
+typedef struct
+{
+    GeoString gs;
+    GeoFix fixdist[GeoIndexFIXEDPOINTS];
+    int index;
+}
+GeoBatchPoint;
+    /* number of points of a batch that a thread       */
+    /* details at a time when they are done in parallel*/
+#define GEOBATCHCHUNK 16384
+/* =================================================== */
+/*                GeoBatchCompare                      */
+/* qsort comparison for batch points, by GeoString and */
+/* then by position in the batch so the order is stable*/
+/* =================================================== */
+static int GeoBatchCompare(const void * l, const void * r)
+{
+    const GeoBatchPoint * lp = static_cast<const GeoBatchPoint*>(l);
+    const GeoBatchPoint * rp = static_cast<const GeoBatchPoint*>(r);
+    if(lp->gs < rp->gs) return -1;
+    if(lp->gs > rp->gs) return  1;
+    if(lp->index < rp->index) return -1;
+    if(lp->index > rp->index) return  1;
+    return 0;
+}
+/* =================================================== */
+/*                GeoBatchDetail                       */
+/* details the batch points from lo to hi (exclusive)  */
+/* GeoMkDetail only reads the fixed points, so this can*/
+/* run for disjoint ranges in several threads at once  */
+/* =================================================== */
+void GeoBatchDetail(GeoIx * gix, GeoCoordinate * c, GeoBatchPoint * bp,
+                    int lo, int hi)
+{
+    GeoDetailedPoint gd;
+    int i,j;
+    for(i=lo;i<hi;i++)
+    {
+        GeoMkDetail(gix,&gd,c+bp[i].index);
+        bp[i].gs=gd.gs;
+        for(j=0;j<GeoIndexFIXEDPOINTS;j++)
+            bp[i].fixdist[j]=gd.fixdist[j];
+    }
+}
+/* =================================================== */
+/*                GeoBulkTree                          */
+/* builds the part of the tree above the leaf pots from*/
+/* lo to hi (exclusive) and returns its top pot.  The  */
+/* leaves are split in half at every level, so the two */
+/* children of a pot never differ by more than one in  */
+/* level, as the AVL rules require.  The top pot of the*/
+/* whole tree is given as "top", all other pots are    */
+/* taken from "pots" as they are needed                */
+/* =================================================== */
+int GeoBulkTree(GeoIx * gix, int * leaves, int lo, int hi,
+                int * pots, int * potsused, int top)
+{
+    int pot,mid,left,right;
+    GeoPot * gp;
+    if( (hi-lo) == 1) return leaves[lo];
+    pot=top;
+    if(pot==0)
+    {
+        pot=pots[*potsused];
+        (*potsused)++;
+    }
+    mid=lo+(hi-lo)/2;
+    left =GeoBulkTree(gix,leaves,lo,mid,pots,potsused,0);
+    right=GeoBulkTree(gix,leaves,mid,hi,pots,potsused,0);
+    gp=gix->pots+pot;
+    gp->LorLeaf=left;
+    gp->RorPoints=right;
+    GeoAdjust(gix,pot);
+    return pot;
+}
+/* =================================================== */
+/*                GeoBulkLoad                          */
+/* builds the whole index from scratch out of points   */
+/* already sorted by GeoString.  This is only valid if */
+/* the index is empty.  All the slots and pots needed  */
+/* are taken first, so that if memory runs out the     */
+/* index can be left unchanged.  The points are then   */
+/* packed into as few leaf pots as possible, spreading */
+/* them evenly, with the GeoString boundary between two*/
+/* leaf pots set halfway between their points as is    */
+/* done when a pot is split during GeoIndex_insert.    */
+/* Finally the tree is built on top of the leaf pots,  */
+/* using pot 1 (the old empty leaf) as the root        */
+/* =================================================== */
+int GeoBulkLoad(GeoIx * gix, GeoCoordinate * c, GeoBatchPoint * bp, int n)
+{
+    int * slots;
+    int * leaves;
+    int * pots;
+    int leafct,potct,potsused,i,j,k,lo,hi,slot;
+    GeoString start,end;
+    GeoPot * gp;
+    leafct=(n+GeoIndexPOTSIZE-1)/GeoIndexPOTSIZE;
+    potct=2*leafct-2;   /* pots needed apart from pot 1  */
+    slots =static_cast<int*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, n*sizeof(int), false));
+    leaves=static_cast<int*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, leafct*sizeof(int), false));
+    pots  =static_cast<int*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, (potct+1)*sizeof(int), false));
+    if( (slots==NULL) || (leaves==NULL) || (pots==NULL) )
+    {
+        if(slots!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, slots);
+        if(leaves!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, leaves);
+        if(pots!=NULL) TRI_Free(TRI_UNKNOWN_MEM_ZONE, pots);
+        return -2;
+    }
+/* get all the slots and pots, giving them back if we  */
+/* cannot get them all                                 */
+    for(i=0;i<n;i++)
+    {
+        slots[i]=GeoIndexNewSlot(gix);
+        if(slots[i]==-2) break;
+    }
+    for(j=0;(i==n) && (j<potct);j++)
+    {
+        pots[j]=GeoIndexNewPot(gix);
+        if(pots[j]==-2) break;
+    }
+    if( (i<n) || (j<potct) )
+    {
+        while(i>0) GeoIndexFreeSlot(gix,slots[--i]);
+        while(j>0) GeoIndexFreePot(gix,pots[--j]);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, slots);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, leaves);
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, pots);
+        return -2;
+    }
+/* the leaf pots.  With a single leaf, that is pot 1   */
+    start=gix->pots[1].start;
+    end  =gix->pots[1].end;
+    potsused=0;
+    for(k=0;k<leafct;k++)
+    {
+        if(leafct==1) leaves[k]=1;
+        else
+        {
+            leaves[k]=pots[potsused];
+            potsused++;
+        }
+        lo=(int) (((long long) k)*n/leafct);
+        hi=(int) (((long long) (k+1))*n/leafct);
+        gp=gix->pots+leaves[k];
+        gp->LorLeaf=0;
+        gp->RorPoints=hi-lo;
+        gp->level=1;
+        for(j=0;j<GeoIndexFIXEDPOINTS;j++) gp->maxdist[j]=0;
+        for(i=lo;i<hi;i++)
+        {
+            slot=slots[i];
+            gix->gc[slot].latitude =c[bp[i].index].latitude;
+            gix->gc[slot].longitude=c[bp[i].index].longitude;
+            gix->gc[slot].data     =c[bp[i].index].data;
+            gp->points[i-lo]=slot;
+            for(j=0;j<GeoIndexFIXEDPOINTS;j++)
+                if(bp[i].fixdist[j]>gp->maxdist[j])
+                    gp->maxdist[j]=bp[i].fixdist[j];
+        }
+        gp->start=start;
+        if(k==leafct-1) gp->end=end;
+        else
+        {
+            gp->end=(bp[hi-1].gs+bp[hi].gs)/2ll;
+            start=gp->end;
+        }
+    }
+/* and the tree above them, with pot 1 at the top      */
+    if(leafct>1) GeoBulkTree(gix,leaves,0,leafct,pots,&potsused,1);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slots);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, leaves);
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, pots);
+    return 0;
+}
+/* =================================================== */
+/*            GeoIndex_insertBatch                     */
+/* User-facing routine to insert many points at once,  */
+/* as is done when the index is built for a collection */
+/* that already has documents.  Points with illegal    */
+/* coordinates are skipped.  The points are detailed,  */
+/* using up to <threads> threads of <pool> for large   */
+/* batches, and sorted by GeoString.  If the index is  */
+/* still empty, it is then built bottom-up by          */
+/* GeoBulkLoad, which never has to split a pot.        */
+/* Otherwise the points are inserted one at a time in  */
+/* GeoString order so that consecutive insertions go   */
+/* to the same leaf pots.  Unlike GeoIndex_insert, the */
+/* bulk load does not check for duplicate points, so   */
+/* the caller must not pass a point that is already in */
+/* the index.  The return values are those of          */
+/* GeoIndex_insert                                     */
+/* =================================================== */
+int GeoIndex_insertBatch(GeoIndex * gi, GeoCoordinate * c, int count,
+                         triagens::basics::ThreadPool * pool, int threads)
+{
+    GeoIx * gix;
+    GeoBatchPoint * bp;
+    GeoDetailedPoint gd;
+    int i,j,n,res;
+    std::atomic<int> next(0);
+    gix = (GeoIx *) gi;
+    if(count<=0) return 0;
+    bp=static_cast<GeoBatchPoint*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, count*sizeof(GeoBatchPoint), false));
+    if(bp==NULL) return -2;
+    n=0;
+    for(i=0;i<count;i++)
+    {
+        if(c[i].longitude < -180.0) continue;
+        if(c[i].longitude >  180.0) continue;
+        if(c[i].latitude  <  -90.0) continue;
+        if(c[i].latitude  >   90.0) continue;
+        bp[n].index=i;
+        n++;
+    }
+    if(threads > n/GEOBATCHCHUNK) threads=n/GEOBATCHCHUNK;
+/* every thread details chunks until none are left    */
+    auto detail = [&] () -> void
+    {
+        int lower;
+        while((lower=next.fetch_add(GEOBATCHCHUNK)) < n)
+            GeoBatchDetail(gix,c,bp,lower,(std::min)(n,lower+GEOBATCHCHUNK));
+    };
+    try
+    {
+        triagens::basics::ThreadPool::runConcurrently(pool,detail,
+                                   (size_t) (std::max)(threads,1));
+    }
+    catch (...)
+    {
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, bp);
+        return -2;
+    }
+    qsort(bp,n,sizeof(GeoBatchPoint),GeoBatchCompare);
+    res=0;
+    if( (gix->pots[1].LorLeaf==0) && (gix->pots[1].RorPoints==0) )
+    {
+        if(n>0) res=GeoBulkLoad(gix,c,bp,n);
+    }
+    else
+    {
+        gd.gix=gix;
+        for(i=0;i<n;i++)
+        {
+            gd.gc=c+bp[i].index;
+            gd.gs=bp[i].gs;
+            for(j=0;j<GeoIndexFIXEDPOINTS;j++)
+                gd.fixdist[j]=bp[i].fixdist[j];
+            res=GeoInsertDetailed(gix,&gd);
+            if(res<0) break;
+        }
+    }
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, bp);
+    return res;
+}
+/* =================================================== */
 /*            GeoIndex_remove                          */
 /* As a user-facing routine, this starts by casting the*/
 /* GeoIndex structure to a GeoIx, so that its members  */
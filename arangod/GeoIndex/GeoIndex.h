@@ -96,6 +96,12 @@ GeoCoordinates;
 
 typedef char GeoIndex;   /* to keep the structure private  */
 
+namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+}
+
 
 size_t GeoIndex_MemoryUsage (void*);
 
@@ -103,12 +109,18 @@ GeoIndex * GeoIndex_new(void);
 void GeoIndex_free(GeoIndex * gi);
 double GeoIndex_distance(GeoCoordinate * c1, GeoCoordinate * c2);
 int GeoIndex_insert(GeoIndex * gi, GeoCoordinate * c);
+int GeoIndex_insertBatch(GeoIndex * gi, GeoCoordinate * c, int count,
+                         triagens::basics::ThreadPool * pool, int threads);
 int GeoIndex_remove(GeoIndex * gi, GeoCoordinate * c);
 int GeoIndex_hint(GeoIndex * gi, int hint);
 GeoCoordinates * GeoIndex_PointsWithinRadius(GeoIndex * gi,
                     GeoCoordinate * c, double d);
 GeoCoordinates * GeoIndex_NearestCountPoints(GeoIndex * gi,
                     GeoCoordinate * c, int count);
+GeoCoordinates * GeoIndex_PointsWithinRectangle(GeoIndex * gi,
+                    double lat1, double lon1, double lat2, double lon2);
+GeoCoordinates * GeoIndex_PointsWithinPolygon(GeoIndex * gi,
+                    GeoCoordinate * vertices, int count);
 void GeoIndex_CoordinatesFree(GeoCoordinates * clist);
 #ifdef TRI_GEO_DEBUG
 void GeoIndex_INDEXDUMP(GeoIndex * gi, FILE * f);
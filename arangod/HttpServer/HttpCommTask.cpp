@@ -962,6 +962,18 @@ void HttpCommTask::processRequest (uint32_t compatibility) {
     }
   }
 
+  // the latency histograms are kept by the prefix of the handler. all
+  // actions share the catch-all prefix, so the next part of the path is
+  // added for them
+  {
+    char const* prefix = _request->prefix();
+    std::vector<std::string> const& suffix = _request->suffix();
+
+    RequestStatisticsAgentSetEndpoint(this, 
+                                      prefix, 
+                                      (strcmp(prefix, "/") == 0 && ! suffix.empty()) ? suffix[0].c_str() : nullptr);
+  }
+
   // check for an async request
   std::string const& asyncExecution = _request->header("x-arango-async", found);
 
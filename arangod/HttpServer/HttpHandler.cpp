@@ -91,6 +91,14 @@ size_t HttpHandler::queue () const {
   return Dispatcher::STANDARD_QUEUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane within the queue
+////////////////////////////////////////////////////////////////////////////////
+
+size_t HttpHandler::lane () const {
+  return Dispatcher::LONG_LANE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -152,6 +152,14 @@ namespace triagens {
 
         virtual size_t queue () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane within the queue
+///
+/// handlers that only run for a short time should use the short lane
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual size_t lane () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
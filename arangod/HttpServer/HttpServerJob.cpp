@@ -40,6 +40,28 @@
 using namespace triagens::rest;
 using namespace std;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief name of the job, which is the prefix the handler was registered for
+////////////////////////////////////////////////////////////////////////////////
+
+static string JobName (HttpHandler* handler) {
+  HttpRequest const* request = handler->getRequest();
+
+  if (request != nullptr) {
+    char const* prefix = request->prefix();
+
+    if (prefix != nullptr && *prefix != '\0') {
+      return prefix;
+    }
+  }
+
+  return "HttpServerJob";
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                               class HttpServerJob
 // -----------------------------------------------------------------------------
@@ -55,7 +77,7 @@ using namespace std;
 HttpServerJob::HttpServerJob (HttpServer* server,
                               HttpHandler* handler,
                               HttpCommTask* task) 
-  : Job("HttpServerJob"),
+  : Job(JobName(handler)),
     _server(server),
     _handler(handler),
     _task(task),
@@ -103,6 +125,14 @@ size_t HttpServerJob::queue () const {
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t HttpServerJob::lane () const {
+  return _handler->lane();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
 void HttpServerJob::setDispatcherThread (DispatcherThread* thread) {
   _handler->setDispatcherThread(thread);
 }
@@ -29,10 +29,12 @@
 
 #include "FulltextIndex.h"
 #include "Basics/logging.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/Utf8Helper.h"
 #include "FulltextIndex/fulltext-index.h"
 #include "FulltextIndex/fulltext-wordlist.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/server.h"
 #include "VocBase/transaction.h"
 #include "VocBase/VocShaper.h"
 
@@ -219,6 +221,117 @@ int FulltextIndex::remove (TRI_doc_mptr_t const* doc,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts many documents at once
+/// the documents are tokenized in parallel by the threads of the index pool,
+/// and the sorted word lists of each slice of documents are then merged into
+/// the index in one go
+////////////////////////////////////////////////////////////////////////////////
+
+int FulltextIndex::batchInsert (std::vector<TRI_doc_mptr_t const*> const* documents,
+                                size_t numThreads) {
+  // the word lists of a slice are kept in memory until the slice is inserted
+  size_t const sliceSize = 64 * 1024;
+  size_t const n = documents->size();
+
+  std::vector<TRI_fulltext_wordlist_t*> wordlists;
+  std::vector<TRI_fulltext_doc_t> docs;
+
+  auto freeWordlists = [&wordlists] () -> void {
+    for (auto& it : wordlists) {
+      if (it != nullptr) {
+        TRI_FreeWordlistFulltextIndex(it);
+      }
+    }
+    wordlists.clear();
+  };
+
+  auto pool = _collection->_vocbase->_server->_indexPool;
+  int res = TRI_ERROR_NO_ERROR;
+
+  try {
+    for (size_t slice = 0; slice < n; slice += sliceSize) {
+      size_t const length = (std::min)(sliceSize, n - slice);
+
+      wordlists.assign(length, nullptr);
+      std::atomic<bool> failed(false);
+
+      // the documents are handed out in small chunks, so threads that are
+      // busy otherwise do not hold back the rest
+      size_t const chunkSize = 1024;
+      std::atomic<size_t> next(0);
+
+      auto tokenizer = [&] () -> void {
+        try {
+          while (! failed) {
+            size_t lower = next.fetch_add(chunkSize);
+
+            if (lower >= length) {
+              break;
+            }
+
+            size_t upper = (std::min)(length, lower + chunkSize);
+
+            for (size_t i = lower; i < upper; ++i) {
+              TRI_fulltext_wordlist_t* words = wordlist((*documents)[slice + i]);
+
+              if (words != nullptr && words->_numWords > 0) {
+                TRI_SortWordlistFulltextIndex(words);
+              }
+              wordlists[i] = words;
+            }
+          }
+        }
+        catch (...) {
+          failed = true;
+        }
+      };
+
+      triagens::basics::ThreadPool::runConcurrently(pool, tokenizer, (std::min)(numThreads, length / chunkSize));
+
+      if (failed) {
+        res = TRI_ERROR_OUT_OF_MEMORY;
+        break;
+      }
+
+      // documents without words are not indexed
+      docs.clear();
+      size_t k = 0;
+
+      for (size_t i = 0; i < length; ++i) {
+        TRI_fulltext_wordlist_t* words = wordlists[i];
+
+        if (words == nullptr) {
+          continue;
+        }
+        if (words->_numWords == 0) {
+          TRI_FreeWordlistFulltextIndex(words);
+          continue;
+        }
+
+        docs.emplace_back((TRI_fulltext_doc_t) ((uintptr_t) (*documents)[slice + i]));
+        wordlists[k++] = words;
+      }
+      wordlists.resize(k);
+
+      if (! TRI_InsertWordsBatchFulltextIndex(_fulltextIndex, docs.data(), wordlists.data(), k, pool, numThreads)) {
+        LOG_ERROR("adding documents to fulltext index failed");
+        res = TRI_ERROR_INTERNAL;
+        break;
+      }
+
+      freeWordlists();
+    }
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  freeWordlists();
+
+  return res;
+}
+
 int FulltextIndex::cleanup () {
   LOG_TRACE("fulltext cleanup called");
 
@@ -89,6 +89,13 @@ namespace triagens {
         int insert (struct TRI_doc_mptr_t const*, bool) override final;
          
         int remove (struct TRI_doc_mptr_t const*, bool) override final;
+
+        int batchInsert (std::vector<TRI_doc_mptr_t const*> const*,
+                         size_t) override final;
+
+        bool hasBatchInsert () const override final {
+          return true;
+        }
         
         int cleanup () override final;
 
@@ -29,7 +29,9 @@
 
 #include "GeoIndex2.h"
 #include "Basics/logging.h"
+#include "Basics/ThreadPool.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/server.h"
 #include "VocBase/transaction.h"
 #include "VocBase/VocShaper.h"
 
@@ -183,39 +185,13 @@ triagens::basics::Json GeoIndex2::toJsonFigures (TRI_memory_zone_t* zone) const
   
 int GeoIndex2::insert (TRI_doc_mptr_t const* doc, 
                        bool) {
-  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
-
-  // lookup latitude and longitude
-  TRI_shaped_json_t shapedJson;
-  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
-  
-  bool ok;
-  double latitude;
-  double longitude;
-
-  if (_location != 0) {
-    if (_geoJson) {
-      ok = extractDoubleArray(shaper, &shapedJson, &longitude, &latitude);
-    }
-    else {
-      ok = extractDoubleArray(shaper, &shapedJson, &latitude, &longitude);
-    }
-  }
-  else {
-    ok = extractDoubleObject(shaper, &shapedJson, 0, &latitude);
-    ok = ok && extractDoubleObject(shaper, &shapedJson, 1, &longitude);
-  }
+  GeoCoordinate gc;
 
-  if (! ok) {
+  if (! extractCoordinate(doc, &gc)) {
     return TRI_ERROR_NO_ERROR;
   }
 
   // and insert into index
-  GeoCoordinate gc;
-  gc.latitude = latitude;
-  gc.longitude = longitude;
-  gc.data = const_cast<void*>(static_cast<void const*>(doc));
-
   int res = GeoIndex_insert(_geoIndex, &gc);
 
   if (res == -1) {
@@ -235,6 +211,70 @@ int GeoIndex2::insert (TRI_doc_mptr_t const* doc,
 
   return TRI_ERROR_NO_ERROR;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts many documents at once
+/// the coordinates are extracted in parallel by the threads of the index
+/// pool, and the geo index then sorts
+/// them by their position on the Hilbert curve. if the index is still empty,
+/// it is built bottom-up from the sorted points instead of splitting pots
+/// over and over again
+////////////////////////////////////////////////////////////////////////////////
+
+int GeoIndex2::batchInsert (std::vector<TRI_doc_mptr_t const*> const* documents,
+                            size_t numThreads) {
+  size_t const n = documents->size();
+
+  if (n == 0) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // documents without (valid) coordinates are not indexed. their entries
+  // get an out-of-range latitude so the geo index skips them
+  std::vector<GeoCoordinate> coordinates(n);
+
+  // the documents are handed out in small chunks, so threads that are
+  // busy otherwise do not hold back the rest
+  size_t const chunkSize = 10000;
+  std::atomic<size_t> next(0);
+
+  auto extractor = [&] () -> void {
+    size_t lower;
+
+    while ((lower = next.fetch_add(chunkSize)) < n) {
+      size_t upper = (std::min)(n, lower + chunkSize);
+
+      for (size_t i = lower; i < upper; ++i) {
+        if (! extractCoordinate((*documents)[i], &coordinates[i])) {
+          coordinates[i].latitude = 1000.0;
+          coordinates[i].longitude = 0.0;
+        }
+      }
+    }
+  };
+
+  if (numThreads > n / chunkSize) {
+    numThreads = n / chunkSize;
+  }
+
+  auto pool = _collection->_vocbase->_server->_indexPool;
+  triagens::basics::ThreadPool::runConcurrently(pool, extractor, numThreads);
+
+  int res = GeoIndex_insertBatch(_geoIndex, coordinates.data(), static_cast<int>(n), pool, static_cast<int>(numThreads));
+
+  if (res == -1) {
+    LOG_WARNING("found duplicate entry in geo-index, should not happen");
+    return TRI_set_errno(TRI_ERROR_INTERNAL);
+  }
+  else if (res == -2) {
+    return TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  else if (res < 0) {
+    return TRI_set_errno(TRI_ERROR_INTERNAL);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
          
 int GeoIndex2::remove (TRI_doc_mptr_t const* doc, 
                       bool) {
@@ -298,11 +338,70 @@ GeoCoordinates* GeoIndex2::nearQuery (double lat,
   return GeoIndex_NearestCountPoints(_geoIndex, &gc, static_cast<int>(count));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points within a given rectangle
+////////////////////////////////////////////////////////////////////////////////
+
+GeoCoordinates* GeoIndex2::withinRectangleQuery (double lat1,
+                                                 double lon1,
+                                                 double lat2,
+                                                 double lon2) const {
+  return GeoIndex_PointsWithinRectangle(_geoIndex, lat1, lon1, lat2, lon2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points within a given polygon
+////////////////////////////////////////////////////////////////////////////////
+
+GeoCoordinates* GeoIndex2::withinPolygonQuery (std::vector<GeoCoordinate>& vertices) const {
+  return GeoIndex_PointsWithinPolygon(_geoIndex, vertices.data(), static_cast<int>(vertices.size()));
+}
+
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts latitude and longitude from a document
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeoIndex2::extractCoordinate (TRI_doc_mptr_t const* doc,
+                                   GeoCoordinate* gc) {
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  // lookup latitude and longitude
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
+  
+  bool ok;
+  double latitude;
+  double longitude;
+
+  if (_location != 0) {
+    if (_geoJson) {
+      ok = extractDoubleArray(shaper, &shapedJson, &longitude, &latitude);
+    }
+    else {
+      ok = extractDoubleArray(shaper, &shapedJson, &latitude, &longitude);
+    }
+  }
+  else {
+    ok = extractDoubleObject(shaper, &shapedJson, 0, &latitude);
+    ok = ok && extractDoubleObject(shaper, &shapedJson, 1, &longitude);
+  }
+
+  if (! ok) {
+    return false;
+  }
+
+  gc->latitude = latitude;
+  gc->longitude = longitude;
+  gc->data = const_cast<void*>(static_cast<void const*>(doc));
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extracts a double value from an object
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,6 +118,13 @@ namespace triagens {
          
         int remove (struct TRI_doc_mptr_t const*, bool) override final;
 
+        int batchInsert (std::vector<TRI_doc_mptr_t const*> const*,
+                         size_t) override final;
+
+        bool hasBatchInsert () const override final {
+          return true;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief looks up all points within a given radius
 ////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +137,18 @@ namespace triagens {
 
         GeoCoordinates* nearQuery (double, double, size_t) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points within a given rectangle
+////////////////////////////////////////////////////////////////////////////////
+
+        GeoCoordinates* withinRectangleQuery (double, double, double, double) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points within a given polygon
+////////////////////////////////////////////////////////////////////////////////
+
+        GeoCoordinates* withinPolygonQuery (std::vector<GeoCoordinate>&) const;
+
         bool isSame (TRI_shape_pid_t location, bool geoJson) const {
           return (_location != 0 && _location == location && _geoJson == geoJson);
         }
@@ -144,6 +163,13 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts latitude and longitude from a document
+////////////////////////////////////////////////////////////////////////////////
+
+        bool extractCoordinate (struct TRI_doc_mptr_t const*,
+                                GeoCoordinate*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extracts a double value from an object
 ////////////////////////////////////////////////////////////////////////////////
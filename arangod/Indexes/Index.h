@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "Basics/AttributeNameParser.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/Mutex.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
@@ -285,6 +286,15 @@ namespace triagens {
 
         virtual bool hasBatchInsert () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lock that serializes modifications of the index while
+/// single-document write operations run concurrently on the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex& concurrentWriteLock () {
+          return _concurrentWriteLock;
+        }
+
         friend std::ostream& operator<< (std::ostream&, Index const*);
         friend std::ostream& operator<< (std::ostream&, Index const&);
 
@@ -299,6 +309,14 @@ namespace triagens {
         struct TRI_document_collection_t*                                      _collection;
 
         std::vector<std::vector<triagens::basics::AttributeName>> const        _fields;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        triagens::basics::Mutex                                                _concurrentWriteLock;
                
     };
 
@@ -80,7 +80,8 @@ static bool IsEqualElementElement (TRI_doc_mptr_t const* left,
 
 PrimaryIndex::PrimaryIndex (TRI_document_collection_t* collection) 
   : Index(0, collection, std::vector<std::vector<triagens::basics::AttributeName>>( { { { TRI_VOC_ATTRIBUTE_KEY, false } } } )),
-    _primaryIndex(nullptr) {
+    _primaryIndex(nullptr),
+    _bucketLocks(nullptr) {
 
   uint32_t indexBuckets = 1;
 
@@ -97,9 +98,12 @@ PrimaryIndex::PrimaryIndex (TRI_document_collection_t* collection)
                                          indexBuckets,
                                          [] () -> std::string { return "primary"; }
   );
+
+  _bucketLocks = new triagens::basics::Mutex[_primaryIndex->numBuckets()];
 }
 
 PrimaryIndex::~PrimaryIndex () {
+  delete[] _bucketLocks;
   delete _primaryIndex;
 }
 
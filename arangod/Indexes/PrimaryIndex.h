@@ -32,6 +32,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/AssocUnique.h"
+#include "Basics/Mutex.h"
 #include "Indexes/Index.h"
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
@@ -159,6 +160,18 @@ namespace triagens {
         static uint64_t calculateHash (char const*, size_t);
 
         void invokeOnAllElements (std::function<void(TRI_doc_mptr_t*)>);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lock for the bucket a key with the given hash belongs to
+///
+/// the index itself does not use these locks. concurrent single-document
+/// write operations hold the bucket lock while they modify or look up the
+/// index, so that writers of different buckets do not block each other
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex& bucketLock (uint64_t hash) {
+          return _bucketLocks[_primaryIndex->bucketIndex(hash)];
+        }
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -172,6 +185,12 @@ namespace triagens {
 
         TRI_PrimaryIndex_t* _primaryIndex;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the bucket locks, one per bucket of the index
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex* _bucketLocks;
+
     };
 
   }
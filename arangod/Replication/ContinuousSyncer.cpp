@@ -33,6 +33,7 @@
 #include "Basics/json.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/WriteLocker.h"
 #include "Rest/HttpRequest.h"
 #include "Rest/SslInterface.h"
@@ -42,6 +43,9 @@
 #include "Utils/CollectionGuard.h"
 #include "Utils/transactions.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/Legends.h"
+#include "VocBase/server.h"
+#include "VocBase/shaped-json.h"
 #include "VocBase/transaction.h"
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
@@ -69,11 +73,13 @@ ContinuousSyncer::ContinuousSyncer (TRI_server_t* server,
     _server(server),
     _applier(vocbase->_replicationApplier),
     _chunkSize(),
+    _parallelism(1),
     _restrictType(RESTRICT_NONE),
     _initialTick(initialTick),
     _useTick(useTick),
     _includeSystem(configuration->_includeSystem),
     _requireFromPresent(configuration->_requireFromPresent),
+    _binaryFormat(configuration->_binaryFormat),
     _verbose(configuration->_verbose),
     _masterIs27OrHigher(false) {
 
@@ -86,6 +92,10 @@ ContinuousSyncer::ContinuousSyncer (TRI_server_t* server,
 
   _chunkSize = StringUtils::itoa(c);
 
+  if (configuration->_parallelism > 1) {
+    _parallelism = static_cast<size_t>((std::min)(configuration->_parallelism, (uint64_t) 64));
+  }
+
   if (configuration->_restrictType == "include") {
     _restrictType = RESTRICT_INCLUDE;
   }
@@ -245,6 +255,32 @@ int ContinuousSyncer::saveApplierState () {
 
   return res;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the replication lag in the applier state
+/// ticks on the master are not timestamps, so the lag in seconds is measured
+/// from the time we first saw a master tick that has not been applied yet
+////////////////////////////////////////////////////////////////////////////////
+
+void ContinuousSyncer::updateLag () {
+  auto& state = _applier->_state;
+
+  if (state._lagTick > 0 &&
+      state._lastAppliedContinuousTick < state._lagTick) {
+    // still behind the tick we are measuring from
+    return;
+  }
+
+  if (state._lastAvailableContinuousTick > state._lastAppliedContinuousTick) {
+    state._lagTick  = state._lastAvailableContinuousTick;
+    state._lagSince = TRI_microtime();
+  }
+  else {
+    state._lagTick  = 0;
+    state._lagSince = 0.0;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not a marker should be skipped
 ////////////////////////////////////////////////////////////////////////////////
@@ -369,21 +405,21 @@ int ContinuousSyncer::getLocalState (string& errorMsg) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief inserts a document, based on the JSON provided
+/// @brief determine the local collection id for a document marker
 ////////////////////////////////////////////////////////////////////////////////
 
-int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
-                                       TRI_json_t const* json,
-                                       string& errorMsg) {
+TRI_voc_cid_t ContinuousSyncer::documentCid (TRI_json_t const* json,
+                                             bool& isSystem) {
+  isSystem = false;
+
   // extract "cid"
   TRI_voc_cid_t cid = getCid(json);
 
   if (cid == 0) {
-    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+    return 0;
   }
 
   // extract optional "cname"
-  bool isSystem = false;
   TRI_json_t const* cnameJson = JsonHelper::getObjectElement(json, "cname");
 
   if (JsonHelper::isString(cnameJson)) {
@@ -400,6 +436,23 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
     }
   }
 
+  return cid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document, based on the JSON provided
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
+                                       TRI_json_t const* json,
+                                       string& errorMsg) {
+  bool isSystem;
+  TRI_voc_cid_t cid = documentCid(json, isSystem);
+
+  if (cid == 0) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
   // extract "key"
   TRI_json_t const* keyJson = JsonHelper::getObjectElement(json, "key");
 
@@ -782,8 +835,582 @@ int ContinuousSyncer::applyLogMarker (TRI_json_t const* json,
   return TRI_ERROR_REPLICATION_UNEXPECTED_MARKER;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether a marker can be applied as part of a batch, and if
+/// so, fill in the batch operation for it
+/// only standalone document operations are batched. markers that are part of
+/// a transaction or that change collections or indexes are applied one by one
+////////////////////////////////////////////////////////////////////////////////
+
+bool ContinuousSyncer::isBatchable (TRI_json_t const* json,
+                                    BatchOperation& op) {
+  int typeValue = JsonHelper::getNumericValue<int>(json, "type", 0);
+  TRI_replication_operation_e type = (TRI_replication_operation_e) typeValue;
+
+  if (type != REPLICATION_MARKER_DOCUMENT &&
+      type != REPLICATION_MARKER_EDGE &&
+      type != REPLICATION_MARKER_REMOVE) {
+    return false;
+  }
+
+  string const id = JsonHelper::getStringValue(json, "tid", "");
+
+  if (! id.empty() &&
+      StringUtils::uint64(id.c_str(), id.size()) > 0) {
+    // operation is part of a transaction
+    return false;
+  }
+
+  if (! JsonHelper::isString(JsonHelper::getObjectElement(json, "key"))) {
+    // let the regular code path report the error
+    return false;
+  }
+
+  TRI_voc_cid_t cid = documentCid(json, op.isSystem);
+
+  if (cid == 0) {
+    return false;
+  }
+
+  string const tick = JsonHelper::getStringValue(json, "tick", "");
+
+  op.tick = 0;
+  if (! tick.empty()) {
+    op.tick = static_cast<TRI_voc_tick_t>(StringUtils::uint64(tick.c_str(), tick.size()));
+  }
+  op.cid  = cid;
+  op.type = type;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the batch operations for a single collection in a single
+/// transaction
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyCollectionBatch (std::vector<BatchOperation> const& batch,
+                                            std::vector<size_t> const& positions,
+                                            string& errorMsg) {
+  TRI_ASSERT(! positions.empty());
+
+  SingleCollectionWriteTransaction<UINT64_MAX> trx(new StandaloneTransactionContext(), _vocbase, batch[positions[0]].cid);
+
+  int res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    errorMsg = "unable to create replication transaction: " + string(TRI_errno_string(res));
+
+    return res;
+  }
+
+  TRI_transaction_collection_t* trxCollection = trx.trxCollection();
+
+  if (trxCollection == nullptr) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  // acquire the write lock once for all operations instead of once per operation
+  res = trx.lockWrite();
+
+  for (auto const& position : positions) {
+    if (res != TRI_ERROR_NO_ERROR) {
+      break;
+    }
+
+    BatchOperation const& op = batch[position];
+    TRI_json_t const* keyJson = JsonHelper::getObjectElement(op.json.get(), "key");
+
+    // extract "rev"
+    TRI_voc_rid_t rid = 0;
+    string const ridString = JsonHelper::getStringValue(op.json.get(), "rev", "");
+
+    if (! ridString.empty()) {
+      rid = StringUtils::uint64(ridString.c_str(), ridString.size());
+    }
+
+    res = applyCollectionDumpMarker(trxCollection,
+                                    op.type,
+                                    (const TRI_voc_key_t) keyJson->_value._string.data,
+                                    rid,
+                                    JsonHelper::getObjectElement(op.json.get(), "data"),
+                                    errorMsg);
+
+    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && op.isSystem) {
+      // ignore unique constraint violations for system collections
+      res = TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  return trx.finish(res);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply a batch of standalone document operations
+/// the operations are grouped by collection. each group is applied in a single
+/// transaction, keeping the order of the operations from the log. groups for
+/// different collections are independent of each other and are applied by up
+/// to _parallelism threads, using the server's loader pool. if a group fails, its transaction is rolled back
+/// and its operations are applied again one by one, so errors are reported and
+/// ignored exactly as for markers that are not batched
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyBatch (std::vector<BatchOperation>& batch,
+                                  TRI_voc_tick_t firstRegularTick,
+                                  string& errorMsg,
+                                  uint64_t& ignoreCount) {
+  if (batch.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::unordered_map<TRI_voc_cid_t, size_t> groupIds;
+  std::vector<std::vector<size_t>> groups;
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    auto it = groupIds.find(batch[i].cid);
+
+    if (it == groupIds.end()) {
+      groupIds.emplace(batch[i].cid, groups.size());
+      groups.emplace_back(std::vector<size_t>({ i }));
+    }
+    else {
+      groups[(*it).second].emplace_back(i);
+    }
+  }
+
+  std::vector<int> results(groups.size(), TRI_ERROR_NO_ERROR);
+  // messages of failed groups are discarded, as their operations are applied again
+  std::vector<string> messages(groups.size());
+  std::atomic<size_t> next(0);
+
+  auto work = [&] () -> void {
+    while (true) {
+      size_t const g = next++;
+
+      if (g >= groups.size()) {
+        return;
+      }
+
+      try {
+        results[g] = applyCollectionBatch(batch, groups[g], messages[g]);
+      }
+      catch (triagens::basics::Exception const& ex) {
+        results[g] = ex.code();
+      }
+      catch (...) {
+        results[g] = TRI_ERROR_INTERNAL;
+      }
+    }
+  };
+
+  size_t const numThreads = (std::min)(_parallelism, groups.size());
+  triagens::basics::ThreadPool::runConcurrently(_vocbase->_server->_loaderPool, work, numThreads);
+
+  {
+    WRITE_LOCKER_EVENTUAL(_applier->_statusLock, 1000);
+
+    for (auto const& op : batch) {
+      if (op.tick >= firstRegularTick &&
+          op.tick > _applier->_state._lastProcessedContinuousTick) {
+        _applier->_state._lastProcessedContinuousTick = op.tick;
+      }
+    }
+  }
+
+  for (size_t g = 0; g < groups.size(); ++g) {
+    if (results[g] == TRI_ERROR_NO_ERROR) {
+      continue;
+    }
+
+    for (auto const& position : groups[g]) {
+      BatchOperation const& op = batch[position];
+
+      int res = processDocument(op.type, op.json.get(), errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        res = handleApplyError(res, op.json.get(), op.lineStart, op.lineLength, errorMsg, ignoreCount);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          return res;
+        }
+      }
+    }
+  }
+
+  // update tick value
+  WRITE_LOCKER_EVENTUAL(_applier->_statusLock, 1000);
+
+  if (_applier->_state._lastProcessedContinuousTick > _applier->_state._lastAppliedContinuousTick) {
+    _applier->_state._lastAppliedContinuousTick = _applier->_state._lastProcessedContinuousTick;
+  }
+
+  if (_ongoingTransactions.empty()) {
+    _applier->_state._safeResumeTick = _applier->_state._lastProcessedContinuousTick;
+  }
+
+  updateLag();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handle an error that occurred when applying a marker
+/// returns the error if it cannot be ignored, and TRI_ERROR_NO_ERROR otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::handleApplyError (int res,
+                                        TRI_json_t const* json,
+                                        char const* lineStart,
+                                        size_t lineLength,
+                                        string& errorMsg,
+                                        uint64_t& ignoreCount) {
+  TRI_ASSERT(res != TRI_ERROR_NO_ERROR);
+
+  if (errorMsg.empty()) {
+    // don't overwrite previous error message
+    errorMsg = TRI_errno_string(res);
+  }
+
+  if (ignoreCount == 0) {
+    std::string marker;
+
+    if (lineStart == nullptr) {
+      // marker was received in the binary format
+      marker = JsonHelper::toString(json);
+      lineStart = marker.c_str();
+      lineLength = marker.size();
+    }
+
+    if (lineLength > 256) {
+      errorMsg += ", offending marker: " + std::string(lineStart, 256) + "...";
+    }
+    else {
+      errorMsg += ", offending marker: " + std::string(lineStart, lineLength);
+    }
+
+    return res;
+  }
+
+  ignoreCount--;
+  LOG_WARNING("ignoring replication error for database '%s': %s",
+              _applier->databaseName(),
+              errorMsg.c_str());
+  errorMsg = "";
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection names and shapers received in the binary log format
+/// the master sends these once per response
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryDictionary {
+  std::unordered_map<TRI_voc_cid_t, std::string> names;
+  std::unordered_map<TRI_voc_cid_t, std::unique_ptr<triagens::basics::DictionaryShaper>> shapers;
+
+  triagens::basics::DictionaryShaper* shaper (TRI_voc_cid_t cid) {
+    auto& shaper = shapers[cid];
+
+    if (shaper == nullptr) {
+      shaper.reset(new triagens::basics::DictionaryShaper());
+    }
+
+    return shaper.get();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read a value from a binary log record
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static bool ReadBinaryValue (char*& p,
+                             char const* end,
+                             T& value) {
+  if (end - p < static_cast<ptrdiff_t>(sizeof(T))) {
+    return false;
+  }
+
+  memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read a key from a binary log record
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadBinaryKey (char*& p,
+                           char const* end,
+                           std::string& key) {
+  uint16_t length;
+
+  if (! ReadBinaryValue(p, end, length) || end - p < length) {
+    return false;
+  }
+
+  key.assign(p, length);
+  p += length;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add a string attribute to a marker built from a binary log record
+////////////////////////////////////////////////////////////////////////////////
+
+static void AddBinaryString (TRI_json_t* json,
+                             char const* name,
+                             std::string const& value) {
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, name, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, value.c_str(), value.size()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check the data of a binary header record against our own format
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CheckBinaryHeader (char* q,
+                               char const* recordEnd) {
+  uint8_t version;
+  uint32_t byteOrder;
+  uint8_t wordSize;
+
+  return (ReadBinaryValue(q, recordEnd, version) &&
+          ReadBinaryValue(q, recordEnd, byteOrder) &&
+          ReadBinaryValue(q, recordEnd, wordSize) &&
+          version == TRI_REPLICATION_BINARY_VERSION &&
+          byteOrder == TRI_REPLICATION_BINARY_BYTE_ORDER &&
+          wordSize == sizeof(size_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check that a response in the binary log format starts with a header
+/// record that matches our own format
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsCompatibleBinaryResponse (char* p,
+                                        char const* end) {
+  uint32_t length;
+  uint8_t type;
+
+  if (! ReadBinaryValue(p, end, length) ||
+      ! ReadBinaryValue(p, end, type) ||
+      type != REPLICATION_BINARY_HEADER ||
+      length < sizeof(uint32_t) + sizeof(uint8_t)) {
+    return false;
+  }
+
+  char const* recordEnd = p + length - sizeof(uint32_t) - sizeof(uint8_t);
+
+  if (recordEnd > end) {
+    return false;
+  }
+
+  return CheckBinaryHeader(p, recordEnd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decode the next record of the binary log format
+/// dictionary records are added to the dictionary and leave json empty. all
+/// other records are turned into the same JSON marker that the master sends in
+/// the JSON format. for documents, lineStart is set to nullptr as there is no
+/// marker text
+////////////////////////////////////////////////////////////////////////////////
+
+static int DecodeBinaryRecord (char*& p,
+                               char const* end,
+                               BinaryDictionary& dictionary,
+                               std::unique_ptr<TRI_json_t>& json,
+                               char const*& lineStart,
+                               size_t& lineLength) {
+  char* q = p;
+  uint32_t length;
+  uint8_t type;
+
+  if (! ReadBinaryValue(q, end, length) ||
+      length < sizeof(uint32_t) + sizeof(uint8_t) ||
+      end - p < static_cast<ptrdiff_t>(length) ||
+      ! ReadBinaryValue(q, end, type)) {
+    return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+  }
+
+  char const* recordEnd = p + length;
+  p += length;
+
+  lineStart = nullptr;
+  lineLength = 0;
+
+  switch (type) {
+    case REPLICATION_BINARY_HEADER: {
+      if (! CheckBinaryHeader(q, recordEnd)) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    case REPLICATION_BINARY_COLLECTION: {
+      uint64_t cid;
+
+      if (! ReadBinaryValue(q, recordEnd, cid)) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      dictionary.names[static_cast<TRI_voc_cid_t>(cid)] = std::string(q, recordEnd - q);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    case REPLICATION_BINARY_ATTRIBUTE: {
+      uint64_t cid;
+      uint64_t aid;
+
+      if (! ReadBinaryValue(q, recordEnd, cid) ||
+          ! ReadBinaryValue(q, recordEnd, aid)) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      dictionary.shaper(static_cast<TRI_voc_cid_t>(cid))->addAttribute(static_cast<TRI_shape_aid_t>(aid), q, recordEnd - q);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    case REPLICATION_BINARY_SHAPE: {
+      uint64_t cid;
+
+      if (! ReadBinaryValue(q, recordEnd, cid) ||
+          recordEnd - q < static_cast<ptrdiff_t>(sizeof(TRI_shape_t))) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      dictionary.shaper(static_cast<TRI_voc_cid_t>(cid))->addShape(q, recordEnd - q);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    case REPLICATION_BINARY_JSON: {
+      if (recordEnd == q || *(recordEnd - 1) != '\0') {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      lineStart = q;
+      lineLength = recordEnd - q - 1;
+
+      json.reset(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, q));
+
+      if (json == nullptr) {
+        return TRI_ERROR_OUT_OF_MEMORY;
+      }
+
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    case REPLICATION_BINARY_DOCUMENT: {
+      uint16_t operation;
+      uint64_t tick;
+      uint64_t tid;
+      uint64_t cid;
+      uint64_t rid;
+      std::string key;
+
+      if (! ReadBinaryValue(q, recordEnd, operation) ||
+          ! ReadBinaryValue(q, recordEnd, tick) ||
+          ! ReadBinaryValue(q, recordEnd, tid) ||
+          ! ReadBinaryValue(q, recordEnd, cid) ||
+          ! ReadBinaryValue(q, recordEnd, rid) ||
+          ! ReadBinaryKey(q, recordEnd, key)) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      json.reset(TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE));
+
+      if (json == nullptr) {
+        return TRI_ERROR_OUT_OF_MEMORY;
+      }
+
+      AddBinaryString(json.get(), "tick", StringUtils::itoa(tick));
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json.get(), "type", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, static_cast<double>(operation)));
+      AddBinaryString(json.get(), "tid", StringUtils::itoa(tid));
+      AddBinaryString(json.get(), "cid", StringUtils::itoa(cid));
+
+      auto it = dictionary.names.find(static_cast<TRI_voc_cid_t>(cid));
+
+      if (it != dictionary.names.end()) {
+        AddBinaryString(json.get(), "cname", (*it).second);
+      }
+
+      AddBinaryString(json.get(), "key", key);
+      AddBinaryString(json.get(), "rev", StringUtils::itoa(rid));
+
+      if (operation == REPLICATION_MARKER_REMOVE) {
+        return TRI_ERROR_NO_ERROR;
+      }
+
+      uint64_t fromCid = 0;
+      uint64_t toCid = 0;
+      std::string fromKey;
+      std::string toKey;
+
+      if (operation == REPLICATION_MARKER_EDGE) {
+        if (! ReadBinaryValue(q, recordEnd, fromCid) ||
+            ! ReadBinaryValue(q, recordEnd, toCid) ||
+            ! ReadBinaryKey(q, recordEnd, fromKey) ||
+            ! ReadBinaryKey(q, recordEnd, toKey)) {
+          return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+        }
+      }
+
+      uint8_t padding;
+      uint64_t sid;
+
+      if (! ReadBinaryValue(q, recordEnd, padding) ||
+          recordEnd - q < padding) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      q += padding;
+
+      if (! ReadBinaryValue(q, recordEnd, sid)) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      TRI_shaped_json_t shaped;
+      shaped._sid         = static_cast<TRI_shape_sid_t>(sid);
+      shaped._data.length = static_cast<uint32_t>(recordEnd - q);
+      shaped._data.data   = q;
+
+      TRI_json_t* doc = TRI_JsonShapedJson(dictionary.shaper(static_cast<TRI_voc_cid_t>(cid)), &shaped);
+
+      if (doc == nullptr) {
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      if (! TRI_IsObjectJson(doc)) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, doc);
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      // common document meta-data
+      AddBinaryString(doc, TRI_VOC_ATTRIBUTE_KEY, key);
+      AddBinaryString(doc, TRI_VOC_ATTRIBUTE_REV, StringUtils::itoa(rid));
+
+      if (operation == REPLICATION_MARKER_EDGE) {
+        AddBinaryString(doc, TRI_VOC_ATTRIBUTE_FROM, StringUtils::itoa(fromCid) + "/" + fromKey);
+        AddBinaryString(doc, TRI_VOC_ATTRIBUTE_TO, StringUtils::itoa(toCid) + "/" + toKey);
+      }
+
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json.get(), "data", doc);
+      return TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief apply the data from the continuous log
+/// consecutive standalone document operations are collected and applied in
+/// batches. all other markers act as barriers: the operations collected before
+/// them are applied first, and then the marker itself
 ////////////////////////////////////////////////////////////////////////////////
 
 int ContinuousSyncer::applyLog (SimpleHttpResult* response,
@@ -799,76 +1426,101 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
   // buffer must end with a NUL byte
   TRI_ASSERT(*end == '\0');
 
+  // check if the master sent the binary format
+  bool found;
+  std::string const contentType = response->getHeaderField("content-type", found);
+  bool const binary = (found && contentType.compare(0, strlen(TRI_REPLICATION_CONTENT_TYPE_BINARY), TRI_REPLICATION_CONTENT_TYPE_BINARY) == 0);
+  BinaryDictionary dictionary;
+
+  std::vector<BatchOperation> batch;
+  int res = TRI_ERROR_NO_ERROR;
+
   while (p < end) {
-    char* q = strchr(p, '\n');
+    std::unique_ptr<TRI_json_t> json;
+    char const* lineStart;
+    size_t lineLength;
 
-    if (q == nullptr) {
-      q = end;
+    if (binary) {
+      res = DecodeBinaryRecord(p, end, dictionary, json, lineStart, lineLength);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        break;
+      }
+
+      if (json == nullptr) {
+        // a dictionary entry
+        continue;
+      }
+
+      processedMarkers++;
     }
+    else {
+      char* q = strchr(p, '\n');
 
-    char const* lineStart = p;
-    size_t const lineLength = q - p;
+      if (q == nullptr) {
+        q = end;
+      }
+
+      lineStart = p;
+      lineLength = q - p;
     
-    if (lineLength < 2) {
-      // we are done
-      return TRI_ERROR_NO_ERROR;
-    }
+      if (lineLength < 2) {
+        // we are done
+        break;
+      }
 
-    TRI_ASSERT(q <= end);
-    *q = '\0';
+      TRI_ASSERT(q <= end);
+      *q = '\0';
 
-    processedMarkers++;
+      processedMarkers++;
 
-    std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, p));
+      json.reset(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, p));
     
-    p = q + 1;
+      p = q + 1;
 
-    if (json == nullptr) {
-      return TRI_ERROR_OUT_OF_MEMORY;
+      if (json == nullptr) {
+        res = TRI_ERROR_OUT_OF_MEMORY;
+        break;
+      }
     }
   
     if (! TRI_IsObjectJson(json.get())) {
-      errorMsg = "received invalid JSON data";
-
-      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      res = TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      break;
     }
 
-    int res;
-    bool skipped;
-    if (skipMarker(firstRegularTick, json.get())) {
-      // entry is skipped
-      res = TRI_ERROR_NO_ERROR;
-      skipped = true;
-    }
-    else {
-      res = applyLogMarker(json.get(), firstRegularTick, errorMsg);
-      skipped = false;
+    bool const skipped = skipMarker(firstRegularTick, json.get());
+
+    if (! skipped) {
+      BatchOperation op;
+
+      if (isBatchable(json.get(), op)) {
+        op.json       = std::move(json);
+        op.lineStart  = lineStart;
+        op.lineLength = lineLength;
+        batch.emplace_back(std::move(op));
+        continue;
+      }
     }
 
+    // apply the operations collected before this marker
+    res = applyBatch(batch, firstRegularTick, errorMsg, ignoreCount);
+    batch.clear();
+
     if (res != TRI_ERROR_NO_ERROR) {
-      // apply error
+      return res;
+    }
 
-      if (errorMsg.empty()) {
-        // don't overwrite previous error message
-        errorMsg = TRI_errno_string(res);
-      }
+    if (! skipped) {
+      res = applyLogMarker(json.get(), firstRegularTick, errorMsg);
 
-      if (ignoreCount == 0) {
-        if (lineLength > 256) {
-          errorMsg += ", offending marker: " + std::string(lineStart, 256) + "...";
-        }
-        else {
-          errorMsg += ", offending marker: " + std::string(lineStart, lineLength);
-        }
+      if (res != TRI_ERROR_NO_ERROR) {
+        // apply error
+        res = handleApplyError(res, json.get(), lineStart, lineLength, errorMsg, ignoreCount);
 
-        return res;
-      }
-      else {
-        ignoreCount--;
-        LOG_WARNING("ignoring replication error for database '%s': %s",
-                    _applier->databaseName(),
-                    errorMsg.c_str());
-        errorMsg = "";
+        if (res != TRI_ERROR_NO_ERROR) {
+          return res;
+        }
       }
     }
     
@@ -885,10 +1537,22 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
     else if (_ongoingTransactions.empty()) {
       _applier->_state._safeResumeTick = _applier->_state._lastProcessedContinuousTick;
     }
+
+    updateLag();
   }
 
-  // reached the end      
-  return TRI_ERROR_NO_ERROR;
+  // apply the operations collected at the end of the log chunk
+  int batchRes = applyBatch(batch, firstRegularTick, errorMsg, ignoreCount);
+
+  if (batchRes != TRI_ERROR_NO_ERROR) {
+    return batchRes;
+  }
+
+  if (res == TRI_ERROR_REPLICATION_INVALID_RESPONSE) {
+    errorMsg = "received invalid JSON data";
+  }
+
+  return res;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -912,6 +1576,8 @@ int ContinuousSyncer::runContinuousSync (string& errorMsg) {
       fromTick = _initialTick;
       _applier->_state._lastAppliedContinuousTick = 0;
       _applier->_state._lastProcessedContinuousTick = 0;
+      _applier->_state._lagTick = 0;
+      _applier->_state._lagSince = 0.0;
       saveApplierState();
     }
     else {
@@ -1174,7 +1840,8 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
                      "&from=" + StringUtils::itoa(fetchTick) +
                      "&firstRegular=" + StringUtils::itoa(firstRegularTick) + 
                      "&serverId=" + _localServerIdString + 
-                     "&includeSystem=" + (_includeSystem ? "true" : "false");
+                     "&includeSystem=" + (_includeSystem ? "true" : "false") +
+                     (_binaryFormat && _masterIs27OrHigher ? "&binary=true" : "");
 
   LOG_TRACE("running continuous replication request with from tick %llu, first regular tick %llu, url %s",
             (unsigned long long) fetchTick,
@@ -1234,14 +1901,33 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
     return TRI_ERROR_REPLICATION_MASTER_ERROR;
   }
 
+  bool found;
+  std::string header = response->getHeaderField("content-type", found);
+
+  if (found && 
+      header.compare(0, strlen(TRI_REPLICATION_CONTENT_TYPE_BINARY), TRI_REPLICATION_CONTENT_TYPE_BINARY) == 0) {
+    StringBuffer& data = response->getBody();
+
+    if (! IsCompatibleBinaryResponse(data.begin(), data.begin() + data.length())) {
+      // the master uses a binary format we do not understand. fetch the same
+      // data again in the JSON format
+      LOG_WARNING("binary replication log format of master at %s does not match ours. falling back to JSON",
+                  _masterInfo._endpoint);
+      _binaryFormat = false;
+      worked = true;
+      masterActive = true;
+
+      return TRI_ERROR_NO_ERROR;
+    }
+  }
+
   int res           = TRI_ERROR_NO_ERROR;
   bool checkMore    = false;
   bool active       = false;
   bool fromIncluded = false;
   TRI_voc_tick_t tick;
 
-  bool found;
-  std::string header = response->getHeaderField(TRI_REPLICATION_HEADER_CHECKMORE, found);
+  header = response->getHeaderField(TRI_REPLICATION_HEADER_CHECKMORE, found);
 
   if (found) {
     checkMore = StringUtils::boolean(header);
@@ -1277,6 +1963,7 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
 
         WRITE_LOCKER_EVENTUAL(_applier->_statusLock, 1000);
         _applier->_state._lastAvailableContinuousTick = tick;
+        updateLag();
       }
     }
   }
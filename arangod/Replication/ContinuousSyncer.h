@@ -106,6 +106,27 @@ namespace triagens {
           return _applier;
         }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a standalone document operation from the continuous log, collected
+/// for batched application
+////////////////////////////////////////////////////////////////////////////////
+
+        struct BatchOperation {
+          std::unique_ptr<struct TRI_json_t>  json;
+          char const*                         lineStart;
+          size_t                              lineLength;
+          TRI_voc_tick_t                      tick;
+          TRI_voc_cid_t                       cid;
+          TRI_replication_operation_e         type;
+          bool                                isSystem;
+        };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -126,6 +147,13 @@ namespace triagens {
 
         int saveApplierState ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the replication lag in the applier state
+/// the caller must hold the applier's status lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateLag ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not a collection should be excluded
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +199,50 @@ namespace triagens {
                              struct TRI_json_t const*,
                              std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine the local collection id for a document marker
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_cid_t documentCid (struct TRI_json_t const*,
+                                   bool&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether a marker can be applied as part of a batch, and if
+/// so, fill in the batch operation for it
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isBatchable (struct TRI_json_t const*,
+                          BatchOperation&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the batch operations for a single collection in a single
+/// transaction
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyCollectionBatch (std::vector<BatchOperation> const&,
+                                  std::vector<size_t> const&,
+                                  std::string&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply a batch of standalone document operations
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyBatch (std::vector<BatchOperation>&,
+                        TRI_voc_tick_t,
+                        std::string&,
+                        uint64_t&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handle an error that occurred when applying a marker
+////////////////////////////////////////////////////////////////////////////////
+
+        int handleApplyError (int,
+                              struct TRI_json_t const*,
+                              char const*,
+                              size_t,
+                              std::string&,
+                              uint64_t&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief renames a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -251,6 +323,12 @@ namespace triagens {
 
         std::string _chunkSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads used to apply batches for different collections
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _parallelism;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief collection restriction type
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,6 +360,13 @@ namespace triagens {
 
         bool _requireFromPresent;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not to ask the master for the binary log format. this is
+/// turned off if the master's binary format does not match ours
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _binaryFormat;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the applier should be verbose
 ////////////////////////////////////////////////////////////////////////////////
@@ -444,7 +444,9 @@ triagens::basics::Json RestCursorHandler::buildExtra (triagens::aql::QueryResult
 /// @RESTSTRUCT{profile,JSF_post_api_cursor_opts,boolean,optional,}
 /// if set to *true*, then the additional query profiling information
 /// will be returned in the *extra.stats* return attribute if the query result is not
-/// served from the query cache.
+/// served from the query cache. The *extra.stats.nodes* sub-attribute then contains
+/// the number of calls, the rows in and out, the runtime, the time spent in V8
+/// expressions and the peak item block memory of each execution node, by node id.
 ///
 /// @RESTDESCRIPTION
 /// The query details include the query string plus optional query options and
@@ -38,6 +38,7 @@
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ClusterMethods.h"
+#include "Dispatcher/Dispatcher.h"
 #include "Rest/HttpRequest.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/vocbase.h"
@@ -91,6 +92,20 @@ HttpHandler::status_t RestDocumentHandler::execute () {
   return status_t(HANDLER_DONE);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+size_t RestDocumentHandler::lane () const {
+  // reading all documents of a collection can take long
+  if (_request->requestType() == HttpRequest::HTTP_REQUEST_GET &&
+      _request->suffix().empty()) {
+    return Dispatcher::LONG_LANE;
+  }
+
+  return Dispatcher::SHORT_LANE;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
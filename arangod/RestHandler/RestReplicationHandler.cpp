@@ -1070,6 +1070,10 @@ void RestReplicationHandler::handleTrampolineCoordinator () {
 /// @RESTQUERYPARAM{includeSystem,boolean,optional}
 /// Include system collections in the result. The default value is *true*.
 ///
+/// @RESTQUERYPARAM{binary,boolean,optional}
+/// Return the log events in the binary format described below instead of
+/// one JSON object per line. The default value is *false*.
+///
 /// @RESTDESCRIPTION
 /// Returns data from the server's replication log. This method can be called
 /// by replication clients after an initial synchronization of data. The method
@@ -1132,6 +1136,20 @@ void RestReplicationHandler::handleTrampolineCoordinator () {
 /// A more detailed description of the individual replication event types and their
 /// data structures can be found in @ref RefManualReplicationEventTypes.
 ///
+/// If the *binary* URL parameter is set to *true*, the *Content-Type* of the
+/// result is *application/x-arango-dump-binary* instead. The response body then
+/// is a sequence of length-prefixed records. The first record holds the format
+/// version, byte order and word size of the server, so clients can check that
+/// they are able to read the data. Documents, edges and removals are
+/// sent with their data in the server's internal shaped format, and the
+/// attribute names and shapes this data refers to are sent as separate records
+/// once per response, before the first document that needs them. All other log
+/// events are sent as records containing the same JSON object as in the
+/// default format. This format is meant for ArangoDB's own replication applier,
+/// which saves converting each document to JSON on the server and parsing it
+/// again on the client. The layout of the records is internal and may change
+/// between versions.
+///
 /// The response will also contain the following HTTP headers:
 ///
 /// - *x-arango-replication-active*: whether or not the logger is active. Clients
@@ -1287,6 +1305,13 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
     includeSystem = StringUtils::boolean(value);
   }
 
+  bool binary = false;
+  value = _request->value("binary", found);
+
+  if (found) {
+    binary = StringUtils::boolean(value);
+  }
+
   // grab list of transactions from the body value
   std::unordered_set<TRI_voc_tid_t> transactionIds;
 
@@ -1325,6 +1350,7 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
   try {
     // initialize the dump container
     TRI_replication_dump_t dump(_vocbase, (size_t) determineChunkSize(), includeSystem);
+    dump._binary = binary;
 
     // and dump
     res = TRI_DumpLogReplication(&dump, transactionIds, firstRegularTick, tickStart, tickEnd, false);
@@ -1342,7 +1368,12 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
         _response = createResponse(HttpResponse::OK);
       }
 
-      _response->setContentType("application/x-arango-dump; charset=utf-8");
+      if (binary) {
+        _response->setContentType(TRI_REPLICATION_CONTENT_TYPE_BINARY);
+      }
+      else {
+        _response->setContentType("application/x-arango-dump; charset=utf-8");
+      }
 
       // set headers
       _response->setHeader(TRI_REPLICATION_HEADER_CHECKMORE,
@@ -3714,9 +3745,22 @@ void RestReplicationHandler::handleCommandDump () {
 /// the requested maximum size for log transfer packets that
 /// is used when the endpoint is contacted.
 ///
+/// @RESTBODYPARAM{parallelism,integer,optional,int64}
+/// the number of threads the replication applier uses to apply
+/// operations for different collections at the same time. Operations for
+/// the same collection and operations inside transactions are always
+/// applied in their original order. The default value is *1*.
+///
 /// @RESTBODYPARAM{adaptivePolling,boolean,required,}
 /// whether or not the replication applier will use adaptive polling.
 ///
+/// @RESTBODYPARAM{binaryFormat,boolean,optional,}
+/// if set to *true*, the replication applier asks the master for its log in the
+/// binary format, which saves converting documents to JSON on the master and
+/// parsing them again on the slave. The binary format is only used when the
+/// master is ArangoDB 2.7 or higher and runs on the same architecture as the
+/// slave; otherwise the applier falls back to JSON. The default value is *false*.
+///
 /// @RESTBODYPARAM{requireFromPresent,boolean,required,}
 /// if set to *true*, then the replication applier will check
 /// at start of its continuous replication if the start tick from the dump phase
@@ -3760,6 +3804,13 @@ void RestReplicationHandler::handleCommandDump () {
 ///   - *lastAvailableContinuousTick*: the last tick value the logger server can
 ///     provide.
 ///
+///   - *ticksBehind*: the difference between *lastAvailableContinuousTick* and
+///     *lastAppliedContinuousTick*.
+///
+///   - *secondsBehind*: the approximate time (in seconds) since the applier
+///     has first seen a tick on the logger server that it has not applied yet.
+///     This is *0* when the applier has applied everything it knows of.
+///
 ///   - *time*: the time on the applier server.
 ///
 ///   - *totalRequests*: the total number of requests the applier has made to the
@@ -3877,7 +3928,9 @@ void RestReplicationHandler::handleCommandMakeSlave () {
   config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json.get(), "maxConnectRetries", defaults._maxConnectRetries);
   config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json.get(), "sslProtocol", defaults._sslProtocol);
   config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json.get(), "chunkSize", defaults._chunkSize);
+  config._parallelism        = JsonHelper::getNumericValue<uint64_t>(json.get(), "parallelism", defaults._parallelism);
   config._adaptivePolling    = JsonHelper::getBooleanValue(json.get(), "adaptivePolling", defaults._adaptivePolling);
+  config._binaryFormat       = JsonHelper::getBooleanValue(json.get(), "binaryFormat", defaults._binaryFormat);
   config._verbose            = JsonHelper::getBooleanValue(json.get(), "verbose", defaults._verbose);
   config._requireFromPresent = JsonHelper::getBooleanValue(json.get(), "requireFromPresent", defaults._requireFromPresent);
   config._restrictType       = JsonHelper::getStringValue(json.get(), "restrictType", defaults._restrictType);
@@ -4261,6 +4314,9 @@ void RestReplicationHandler::handleCommandServerId () {
 /// - *chunkSize*: the requested maximum size for log transfer packets that
 ///   is used when the endpoint is contacted.
 ///
+/// - *parallelism*: the number of threads used to apply operations for
+///   different collections at the same time.
+///
 /// - *autoStart*: whether or not to auto-start the replication applier on
 ///   (next and following) server starts
 ///
@@ -4269,6 +4325,9 @@ void RestReplicationHandler::handleCommandServerId () {
 ///
 /// - *includeSystem*: whether or not system collection operations will be applied
 ///
+/// - *binaryFormat*: whether or not the replication applier asks the master for
+///   its log in the binary format.
+///
 /// - *requireFromPresent*: if set to *true*, then the replication applier will check
 ///   at start whether the start tick from which it starts or resumes replication is
 ///   still present on the master. If not, then there would be data loss. If 
@@ -4365,6 +4424,12 @@ void RestReplicationHandler::handleCommandApplierGetConfig () {
 /// the requested maximum size for log transfer packets that
 /// is used when the endpoint is contacted.
 ///
+/// @RESTBODYPARAM{parallelism,integer,optional,int64}
+/// the number of threads the replication applier uses to apply
+/// operations for different collections at the same time. Operations for
+/// the same collection and operations inside transactions are always
+/// applied in their original order. The default value is *1*.
+///
 /// @RESTBODYPARAM{autoStart,boolean,required,}
 /// whether or not to auto-start the replication applier on
 /// (next and following) server starts
@@ -4386,6 +4451,13 @@ void RestReplicationHandler::handleCommandApplierGetConfig () {
 /// @RESTBODYPARAM{includeSystem,boolean,required,}
 /// whether or not system collection operations will be applied
 ///
+/// @RESTBODYPARAM{binaryFormat,boolean,optional,}
+/// if set to *true*, the replication applier asks the master for its log in the
+/// binary format, which saves converting documents to JSON on the master and
+/// parsing them again on the slave. The binary format is only used when the
+/// master is ArangoDB 2.7 or higher and runs on the same architecture as the
+/// slave; otherwise the applier falls back to JSON. The default value is *false*.
+///
 /// @RESTBODYPARAM{requireFromPresent,boolean,required,}
 /// if set to *true*, then the replication applier will check
 /// at start whether the start tick from which it starts or resumes replication is
@@ -4517,8 +4589,10 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
   config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json.get(), "maxConnectRetries", config._maxConnectRetries);
   config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json.get(), "sslProtocol", config._sslProtocol);
   config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json.get(), "chunkSize", config._chunkSize);
+  config._parallelism        = JsonHelper::getNumericValue<uint64_t>(json.get(), "parallelism", config._parallelism);
   config._autoStart          = JsonHelper::getBooleanValue(json.get(), "autoStart", config._autoStart);
   config._adaptivePolling    = JsonHelper::getBooleanValue(json.get(), "adaptivePolling", config._adaptivePolling);
+  config._binaryFormat       = JsonHelper::getBooleanValue(json.get(), "binaryFormat", config._binaryFormat);
   config._includeSystem      = JsonHelper::getBooleanValue(json.get(), "includeSystem", config._includeSystem);
   config._verbose            = JsonHelper::getBooleanValue(json.get(), "verbose", config._verbose);
   config._requireFromPresent = JsonHelper::getBooleanValue(json.get(), "requireFromPresent", config._requireFromPresent);
@@ -4733,6 +4807,13 @@ void RestReplicationHandler::handleCommandApplierStop () {
 ///   - *lastAvailableContinuousTick*: the last tick value the logger server can
 ///     provide.
 ///
+///   - *ticksBehind*: the difference between *lastAvailableContinuousTick* and
+///     *lastAppliedContinuousTick*.
+///
+///   - *secondsBehind*: the approximate time (in seconds) since the applier
+///     has first seen a tick on the logger server that it has not applied yet.
+///     This is *0* when the applier has applied everything it knows of.
+///
 ///   - *time*: the time on the applier server.
 ///
 ///   - *totalRequests*: the total number of requests the applier has made to the
@@ -89,6 +89,7 @@
 #include "V8/v8-utils.h"
 #include "V8Server/ApplicationV8.h"
 #include "VocBase/auth.h"
+#include "VocBase/CompactionScheduler.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/server.h"
 #include "Wal/LogfileManager.h"
@@ -362,12 +363,17 @@ ArangoServer::ArangoServer (int argc, char** argv)
     _dispatcherQueueSize(16384),
     _v8Contexts(8),
     _indexThreads(2),
+    _loaderThreads(4),
+    _compactionThreads(2),
+    _compactionMaxBandwidth(0),
+    _preloadCollections(),
     _databasePath(),
     _queryCacheMode("off"),
     _queryCacheMaxResults(128),
     _defaultMaximalSize(TRI_JOURNAL_DEFAULT_MAXIMAL_SIZE),
     _defaultWaitForSync(false),
     _forceSyncProperties(true),
+    _indexCheckpoints(false),
     _ignoreDatafileErrors(false),
     _disableReplicationApplier(false),
     _disableQueryTracking(false),
@@ -379,6 +385,9 @@ ArangoServer::ArangoServer (int argc, char** argv)
     _pairForAqlHandler(nullptr),
     _pairForJobHandler(nullptr),
     _indexPool(nullptr),
+    _loaderPool(nullptr),
+    _graphPool(nullptr),
+    _compactionScheduler(nullptr),
     _threadAffinity(0) {
 
   TRI_SetApplicationName("arangod");
@@ -408,8 +417,12 @@ ArangoServer::ArangoServer (int argc, char** argv)
 
 ArangoServer::~ArangoServer () {
   delete _indexPool;
+  delete _loaderPool;
+  delete _graphPool;
   delete _jobManager;
   delete _server;
+  // the compactor threads of all databases have been stopped with the server
+  delete _compactionScheduler;
 
   Nonce::destroy();
 }
@@ -568,11 +581,16 @@ void ArangoServer::buildApplicationServer () {
     ("database.maximal-journal-size", &_defaultMaximalSize, "default maximal journal size, can be overwritten when creating a collection")
     ("database.wait-for-sync", &_defaultWaitForSync, "default wait-for-sync behavior, can be overwritten when creating a collection")
     ("database.force-sync-properties", &_forceSyncProperties, "force syncing of collection properties to disk, will use waitForSync value of collection when turned off")
+    ("database.index-checkpoints", &_indexCheckpoints, "write a primary index checkpoint when unloading a collection and use it to speed up the next load")
     ("database.ignore-datafile-errors", &_ignoreDatafileErrors, "load collections even if datafiles may contain errors")
     ("database.disable-query-tracking", &_disableQueryTracking, "turn off AQL query tracking by default")
     ("database.query-cache-mode", &_queryCacheMode, "mode for the AQL query cache (on, off, demand)")
     ("database.query-cache-max-results", &_queryCacheMaxResults, "maximum number of results in query cache per database")
     ("database.index-threads", &_indexThreads, "threads to start for parallel background index creation")
+    ("database.loader-threads", &_loaderThreads, "maximum number of threads for opening datafiles and preloading collections in parallel")
+    ("database.compaction-threads", &_compactionThreads, "number of threads for compacting collections, shared by all databases")
+    ("database.compaction-max-bandwidth", &_compactionMaxBandwidth, "maximum number of bytes per second written by compaction (0 = unlimited)")
+    ("database.preload-collections", &_preloadCollections, "collections to load at server start (<collection>, <database>/<collection>, <database>/* or *)")
     ("database.throw-collection-not-loaded-error", &_throwCollectionNotLoadedError, "throw an error when accessing a collection that is still loading")
   ;
 
@@ -806,6 +824,22 @@ void ArangoServer::buildApplicationServer () {
       _indexThreads = 128;
     }
   }
+
+  if (_loaderThreads < 1) {
+    _loaderThreads = 1;
+  }
+  else if (_loaderThreads > 128) {
+    // some arbitrary limit
+    _loaderThreads = 128;
+  }
+
+  if (_compactionThreads < 0) {
+    _compactionThreads = 0;
+  }
+  else if (_compactionThreads > 64) {
+    // some arbitrary limit
+    _compactionThreads = 64;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -875,6 +909,8 @@ int ArangoServer::startupServer () {
     if (! wal::LogfileManager::instance()->open()) {
       LOG_FATAL_AND_EXIT("Unable to finish WAL recovery procedure");
     }
+
+    TRI_PreloadCollectionsServer(_server, _preloadCollections);
   }
 
   startupProgress();
@@ -1515,6 +1551,7 @@ void ArangoServer::openDatabases (bool checkVersion,
   defaults.requireAuthenticationUnixSockets = ! _disableAuthenticationUnixSockets;
   defaults.authenticateSystemOnly           = _authenticateSystemOnly;
   defaults.forceSyncProperties              = _forceSyncProperties;
+  defaults.indexCheckpoints                 = _indexCheckpoints;
 
   TRI_ASSERT(_server != nullptr);
 
@@ -1523,6 +1560,27 @@ void ArangoServer::openDatabases (bool checkVersion,
     _indexPool = new triagens::basics::ThreadPool(_indexThreads, "IndexBuilder");
   }
 
+  // the thread that loads a collection works along with the pool threads
+  if (_loaderThreads > 1) {
+    _loaderPool = new triagens::basics::ThreadPool(static_cast<size_t>(_loaderThreads - 1), "Loader");
+  }
+
+  _server->_loaderPool = _loaderPool;
+  _server->_loaderThreads = static_cast<size_t>(_loaderThreads);
+
+  // graph computations in AQL use all processors, together with the thread
+  // that runs the query
+  size_t numProcessors = TRI_numberProcessors();
+
+  if (numProcessors > 1) {
+    _graphPool = new triagens::basics::ThreadPool(numProcessors - 1, "GraphWorker");
+  }
+
+  _server->_graphPool = _graphPool;
+
+  _compactionScheduler = new triagens::arango::CompactionScheduler(static_cast<size_t>(_compactionThreads), _compactionMaxBandwidth);
+  _server->_compactionScheduler = _compactionScheduler;
+
   int res = TRI_InitServer(_server,
                            _applicationEndpointServer,
                            _indexPool,
@@ -66,6 +66,7 @@ namespace triagens {
 
   namespace arango {
     class ApplicationV8;
+    class CompactionScheduler;
     class ApplicationCluster;
 
 // -----------------------------------------------------------------------------
@@ -376,6 +377,74 @@ namespace triagens {
 
         int _indexThreads;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads for loading collections
+/// @startDocuBlock loaderThreads
+/// `--database.loader-threads`
+///
+/// Specifies the maximum *number* of threads used when loading collections.
+/// The collections of a database are scanned in parallel when the database is
+/// opened, the datafiles of a collection are opened and checked by multiple
+/// threads in parallel, and the collections specified with
+/// `--database.preload-collections` are loaded in parallel at server start.
+/// Specifying a value of *1* will make a collection's datafiles be opened
+/// sequentially by the thread that loads the collection.
+/// The same threads are used for replaying operations during recovery and
+/// for applying replicated operations in parallel, so this value also limits
+/// `--wal.recovery-threads` and the *parallelism* of the replication applier.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _loaderThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads for collection compaction
+/// @startDocuBlock compactionThreads
+/// `--database.compaction-threads`
+///
+/// Specifies the *number* of threads that compact the datafiles of
+/// collections. The threads are shared by all databases. Collections with a
+/// higher share of dead data are compacted first. Specifying a value of *0*
+/// makes each database compact its collections sequentially in its own
+/// compactor thread.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _compactionThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum write rate of collection compaction
+/// @startDocuBlock compactionMaxBandwidth
+/// `--database.compaction-max-bandwidth`
+///
+/// Limits the number of bytes per second that are written by collection
+/// compaction, summed up over all databases. Compaction pauses between
+/// datafiles once the limit has been reached. Specifying a value of *0*
+/// (which is the default) turns off the limit.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _compactionMaxBandwidth;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collections to load at server start
+/// @startDocuBlock preloadCollections
+/// `--database.preload-collections`
+///
+/// Specifies collections that are loaded eagerly at server start, after the
+/// WAL recovery has finished. The option can be specified multiple times.
+/// Each value can be a collection name (which is then loaded in all
+/// databases that contain a collection with this name), a value in the
+/// format *database/collection*, *database/\** for all collections of a
+/// database, or *\** for all collections of all databases.
+/// The collections are loaded in parallel by `--database.loader-threads`
+/// threads. By default, no collections are preloaded and collections are
+/// loaded on first access.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _preloadCollections;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief path to the database
 /// @startDocuBlock DatabaseDirectory
@@ -488,6 +557,25 @@ namespace triagens {
 
         bool _forceSyncProperties;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write primary index checkpoints for faster collection loading
+/// @startDocuBlock databaseIndexCheckpoints
+/// `--database.index-checkpoints boolean`
+///
+/// If turned on, a collection that is unloaded cleanly (i.e. all its WAL
+/// entries have been transferred into its datafiles) will write a checkpoint
+/// of its primary index into the file `index-checkpoint.db` in the collection
+/// directory. When the collection is loaded again, the checkpoint is validated
+/// against the collection's datafiles and used instead of re-applying all
+/// document markers. Only datafiles that are newer than the checkpoint are
+/// scanned. The checkpoint is removed as soon as it has been read.
+///
+/// The default is *false*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _indexCheckpoints;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ignore datafile errors when loading collections
 /// @startDocuBlock databaseIgnoreDatafileErrors
@@ -710,6 +798,25 @@ namespace triagens {
 
         triagens::basics::ThreadPool* _indexPool;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief thread pool for loading collections, recovery and replication
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _loaderPool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief thread pool for graph computations in AQL and in shortest path
+/// searches
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _graphPool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scheduler for collection compaction
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::arango::CompactionScheduler* _compactionScheduler;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief use thread affinity
 ////////////////////////////////////////////////////////////////////////////////
@@ -212,6 +212,20 @@ namespace triagens {
   }                                                                                   \
   while (0)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the endpoint
+////////////////////////////////////////////////////////////////////////////////
+
+#define RequestStatisticsAgentSetEndpoint(a,b,c)                                      \
+  do {                                                                                \
+    if (TRI_ENABLE_STATISTICS) {                                                      \
+      if ((a)->RequestStatisticsAgent::_statistics != nullptr) {                      \
+        (a)->RequestStatisticsAgent::_statistics->setEndpoint(b, c);                  \
+      }                                                                               \
+    }                                                                                 \
+  }                                                                                   \
+  while (0)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the async flag
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,11 +31,14 @@
 
 #include "Basics/Mutex.h"
 #include "Basics/MutexLocker.h"
+#include "Basics/memory.h"
 #include "Basics/threads.h"
+#include "Dispatcher/Dispatcher.h"
 
 #include <boost/lockfree/queue.hpp>
 
 using namespace triagens::basics;
+using namespace triagens::rest;
 using namespace std;
 
 // -----------------------------------------------------------------------------
@@ -62,10 +65,87 @@ static boost::lockfree::queue<TRI_request_statistics_t*, boost::lockfree::capaci
 
 static boost::lockfree::queue<TRI_request_statistics_t*, boost::lockfree::capacity<QUEUE_SIZE>> RequestFinishedList;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of endpoint and method combinations with histograms
+/// of their own. the requests to further endpoints are counted as "other"
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MAX_LATENCY_ENDPOINTS = 128;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief latency histograms of the requests to one endpoint with one method
+////////////////////////////////////////////////////////////////////////////////
+
+struct RequestLatencyData {
+  RequestLatencyData (string const& endpoint,
+                      HttpRequest::HttpRequestType requestType)
+    : _endpoint(endpoint),
+      _requestType(requestType) {
+  }
+
+  string const _endpoint;
+  HttpRequest::HttpRequestType const _requestType;
+
+  LatencyHistogram _totalTime;
+  LatencyHistogram _requestTime;
+  LatencyHistogram _queueTime;
+  LatencyHistogram _ioTime;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for the list of latency histograms
+///
+/// only the statistics thread adds histograms, so it can look them up without
+/// the lock. the histograms are never freed
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex RequestLatencyLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief latency histograms, by method and endpoint
+////////////////////////////////////////////////////////////////////////////////
+
+static unordered_map<string, RequestLatencyData*> RequestLatencies;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                              private request statistics functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the latency histograms for an endpoint and a method
+////////////////////////////////////////////////////////////////////////////////
+
+static RequestLatencyData* GetRequestLatencyData (char const* endpoint,
+                                                  HttpRequest::HttpRequestType requestType) {
+  string name(*endpoint == '\0' ? "unknown" : endpoint);
+  string key = to_string((int) requestType) + ' ' + name;
+
+  auto it = RequestLatencies.find(key);
+
+  if (it != RequestLatencies.end()) {
+    return (*it).second;
+  }
+
+  if (RequestLatencies.size() >= MAX_LATENCY_ENDPOINTS && name != "other") {
+    return GetRequestLatencyData("other", requestType);
+  }
+
+  std::unique_ptr<RequestLatencyData> data(new RequestLatencyData(name, requestType));
+
+  MUTEX_LOCKER(RequestLatencyLock);
+  RequestLatencies.emplace(key, data.get());
+
+  return data.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a time in seconds to microseconds for a histogram
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t LatencyMicroseconds (double time) {
+  return (time <= 0.0 ? 0 : static_cast<uint64_t>(time * 1000000.0));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief processes a statistics block
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,6 +188,29 @@ static void ProcessRequestStatistics (TRI_request_statistics_t* statistics) {
     }
   }
 
+  // the histograms are only written by this thread and need no lock
+  if (statistics->_readStart != 0.0 && statistics->_writeEnd != 0.0) {
+    try {
+      RequestLatencyData* data = GetRequestLatencyData(statistics->_endpoint, statistics->_requestType);
+
+      double totalTime = statistics->_writeEnd - statistics->_readStart;
+      double requestTime = statistics->_requestEnd - statistics->_requestStart;
+      double queueTime = 0.0;
+
+      if (statistics->_queueStart != 0.0 && statistics->_queueEnd != 0.0) {
+        queueTime = statistics->_queueEnd - statistics->_queueStart;
+        data->_queueTime.record(LatencyMicroseconds(queueTime));
+      }
+
+      data->_totalTime.record(LatencyMicroseconds(totalTime));
+      data->_requestTime.record(LatencyMicroseconds(requestTime));
+      data->_ioTime.record(LatencyMicroseconds(totalTime - requestTime - queueTime));
+    }
+    catch (...) {
+      // out of memory. the request is not counted
+    }
+  }
+
   // clear statistics
   statistics->reset(); 
 
@@ -205,6 +308,31 @@ void TRI_FillRequestStatistics (StatisticsDistribution& totalTime,
   bytesReceived = *TRI_BytesReceivedDistributionStatistics;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the latency histograms of all endpoints
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillRequestLatencyStatistics (vector<TRI_request_latency_t>& latencies) {
+  latencies.clear();
+
+  MUTEX_LOCKER(RequestLatencyLock);
+  latencies.reserve(RequestLatencies.size());
+
+  for (auto const& it : RequestLatencies) {
+    RequestLatencyData const* data = it.second;
+
+    TRI_request_latency_t latency;
+    latency._endpoint    = data->_endpoint;
+    latency._requestType = data->_requestType;
+    latency._totalTime   = &data->_totalTime;
+    latency._requestTime = &data->_requestTime;
+    latency._queueTime   = &data->_queueTime;
+    latency._ioTime      = &data->_ioTime;
+
+    latencies.emplace_back(latency);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                           private connection statistics variables
 // -----------------------------------------------------------------------------
@@ -313,6 +441,452 @@ TRI_server_statistics_t TRI_GetServerStatistics () {
   return server;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                           private V8 context statistics variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for V8 context data
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex V8ContextDataLock;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                            public V8 context statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a thread waited for a V8 context
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_V8ContextWaitStatistics (double waitTime) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  TRI_WaitStatistics(TRI_WAIT_V8_CONTEXT, waitTime);
+
+  MUTEX_LOCKER(V8ContextDataLock);
+
+  // the distribution is gone when the statistics have been shut down
+  if (TRI_V8ContextWaitTimeDistributionStatistics != nullptr) {
+    TRI_V8ContextWaitTimeDistributionStatistics->addFigure(waitTime);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the current V8 context statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillV8ContextStatistics (StatisticsDistribution& waitTime) {
+  MUTEX_LOCKER(V8ContextDataLock);
+
+  if (TRI_V8ContextWaitTimeDistributionStatistics != nullptr) {
+    waitTime = *TRI_V8ContextWaitTimeDistributionStatistics;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                 private wait statistics variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cuts of the wait time distributions, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static double const WaitTimeCuts[] = { 0.00001, 0.0001, 0.001, 0.01, 0.1, 1.0 };
+
+static size_t const WaitTimeBuckets = sizeof(WaitTimeCuts) / sizeof(WaitTimeCuts[0]) + 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief figures of one wait point of one thread
+///
+/// the figures are only written by the thread they belong to, so plain loads
+/// and stores suffice. each wait point lies in a cache line of its own, so
+/// a thread that reads the figures does not slow down the writer more than
+/// necessary
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_ALIGNAS(64) WaitPointData {
+  WaitPointData () 
+    : _count(0),
+      _time(0) {
+    for (size_t i = 0; i < WaitTimeBuckets; ++i) {
+      _counts[i] = 0;
+    }
+  }
+
+  void add (double waitTime) {
+    _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _time.store(_time.load(std::memory_order_relaxed) + static_cast<uint64_t>(waitTime * 1000000.0), std::memory_order_relaxed);
+
+    size_t i = 0;
+    while (i < WaitTimeBuckets - 1 && waitTime >= WaitTimeCuts[i]) {
+      ++i;
+    }
+    _counts[i].store(_counts[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> _count;
+  std::atomic<uint64_t> _time;    // in microseconds
+  std::atomic<uint64_t> _counts[WaitTimeBuckets];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait statistics of one thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct ThreadWaitData {
+  WaitPointData _points[TRI_WAIT_POINTS_MAX];
+
+  // the dispatcher queue wait times by handler. the lock is only contended
+  // while the figures are read
+  Mutex _handlersLock;
+  std::unordered_map<std::string, StatisticsDistribution> _handlers;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the wait statistics of the current thread
+///
+/// when the thread ends, its figures are added to the figures of the ended
+/// threads and its wait statistics are freed. waits after the holder was
+/// destroyed are not counted
+////////////////////////////////////////////////////////////////////////////////
+
+struct ThreadWaitDataHolder {
+  ~ThreadWaitDataHolder ();
+
+  ThreadWaitData* _data;
+  char*           _memory;       // the allocated block _data is placed in
+  bool            _ended;        // the thread is ending
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for the list of wait statistics and the figures of the ended
+/// threads
+////////////////////////////////////////////////////////////////////////////////
+
+static Mutex WaitDataLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait statistics of all running threads that waited
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<ThreadWaitData*> WaitData;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the figures of all ended threads, one per wait point, so the totals
+/// do not decrease when a thread ends
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<StatisticsDistribution> EndedWaits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dispatcher queue wait times of all ended threads, by handler
+////////////////////////////////////////////////////////////////////////////////
+
+static std::map<std::string, StatisticsDistribution> EndedHandlerWaits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait statistics of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local ThreadWaitDataHolder CurrentWaitData = { nullptr, nullptr, false };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time jobs waited in the dispatcher queues, one histogram per lane
+////////////////////////////////////////////////////////////////////////////////
+
+static LatencyHistogram LaneWaitTimes[Dispatcher::LANE_SIZE];
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                 private wait statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the figures of a wait point to a distribution
+////////////////////////////////////////////////////////////////////////////////
+
+static void AddWaitPoint (StatisticsDistribution& dist,
+                          WaitPointData const& point) {
+  dist._count += point._count.load(std::memory_order_relaxed);
+  dist._total += point._time.load(std::memory_order_relaxed) / 1000000.0;
+
+  for (size_t j = 0; j < WaitTimeBuckets && j < dist._counts.size(); ++j) {
+    dist._counts[j] += point._counts[j].load(std::memory_order_relaxed);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the wait times of a handler to the wait times by handler
+////////////////////////////////////////////////////////////////////////////////
+
+static void AddHandlerWaits (std::map<std::string, StatisticsDistribution>& handlers,
+                             std::string const& handler,
+                             StatisticsDistribution const& waits) {
+  auto found = handlers.find(handler);
+
+  if (found == handlers.end()) {
+    handlers.emplace(handler, waits);
+    return;
+  }
+
+  StatisticsDistribution& dist = (*found).second;
+  dist._count += waits._count;
+  dist._total += waits._total;
+
+  for (size_t j = 0; j < dist._counts.size(); ++j) {
+    dist._counts[j] += waits._counts[j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the figures of an ending thread to the figures of the ended
+/// threads and frees its wait statistics
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadWaitDataHolder::~ThreadWaitDataHolder () {
+  _ended = true;
+
+  if (_data == nullptr) {
+    return;
+  }
+
+  {
+    MUTEX_LOCKER(WaitDataLock);
+
+    auto pos = std::find(WaitData.begin(), WaitData.end(), _data);
+
+    if (pos != WaitData.end()) {
+      *pos = WaitData.back();
+      WaitData.pop_back();
+    }
+
+    try {
+      if (EndedWaits.empty()) {
+        for (size_t i = 0; i < TRI_WAIT_POINTS_MAX; ++i) {
+          EndedWaits.emplace_back(TRI_WaitTimeDistributionVectorStatistics);
+        }
+      }
+
+      for (size_t i = 0; i < TRI_WAIT_POINTS_MAX; ++i) {
+        AddWaitPoint(EndedWaits[i], _data->_points[i]);
+      }
+
+      MUTEX_LOCKER(_data->_handlersLock);
+
+      for (auto const& it : _data->_handlers) {
+        AddHandlerWaits(EndedHandlerWaits, it.first, it.second);
+      }
+    }
+    catch (...) {
+      // out of memory. the figures of the thread are lost
+    }
+  }
+
+  _data->~ThreadWaitData();
+  delete[] _memory;
+
+  _data = nullptr;
+  _memory = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the wait statistics of the current thread, or a nullptr if
+/// the thread is ending
+///
+/// operator new does not honor the alignment of WaitPointData before C++17,
+/// so the wait statistics are placed at a cache line boundary inside a larger
+/// block
+////////////////////////////////////////////////////////////////////////////////
+
+static ThreadWaitData* GetThreadWaitData () {
+  if (CurrentWaitData._data == nullptr) {
+    if (CurrentWaitData._ended) {
+      return nullptr;
+    }
+
+    std::unique_ptr<char[]> memory(new char[sizeof(ThreadWaitData) + 64]);
+    ThreadWaitData* data = new (TRI_Align64(memory.get())) ThreadWaitData();
+
+    try {
+      MUTEX_LOCKER(WaitDataLock);
+      WaitData.emplace_back(data);
+    }
+    catch (...) {
+      data->~ThreadWaitData();
+      throw;
+    }
+
+    CurrentWaitData._data = data;
+    CurrentWaitData._memory = memory.release();
+  }
+
+  return CurrentWaitData._data;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                  public wait statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of a wait point
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_NameWaitPoint (TRI_wait_point_e point) {
+  switch (point) {
+    case TRI_WAIT_WAL_SLOT:
+      return "walSlot";
+    case TRI_WAIT_WAL_SYNC:
+      return "walSync";
+    case TRI_WAIT_DATAFILE_SYNC:
+      return "datafileSync";
+    case TRI_WAIT_V8_CONTEXT:
+      return "v8Context";
+    case TRI_WAIT_DISPATCHER_QUEUE:
+      return "dispatcherQueue";
+    case TRI_WAIT_POINTS_MAX:
+      break;
+  }
+
+  return "unknown";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time the current thread waited at a wait point
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_WaitStatistics (TRI_wait_point_e point, double waitTime) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  TRI_ASSERT(point < TRI_WAIT_POINTS_MAX);
+
+  try {
+    ThreadWaitData* data = GetThreadWaitData();
+
+    if (data != nullptr) {
+      data->_points[point].add(waitTime);
+    }
+  }
+  catch (...) {
+    // out of memory. the wait is not counted
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a job waited in a dispatcher queue
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DispatcherQueueWaitStatistics (std::string const& handler, 
+                                        double waitTime) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  try {
+    ThreadWaitData* data = GetThreadWaitData();
+
+    if (data == nullptr) {
+      return;
+    }
+
+    data->_points[TRI_WAIT_DISPATCHER_QUEUE].add(waitTime);
+
+    MUTEX_LOCKER(data->_handlersLock);
+    auto it = data->_handlers.find(handler);
+
+    if (it == data->_handlers.end()) {
+      it = data->_handlers.emplace(handler, StatisticsDistribution(TRI_WaitTimeDistributionVectorStatistics)).first;
+    }
+
+    (*it).second.addFigure(waitTime);
+  }
+  catch (...) {
+    // out of memory. the wait is not counted
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of a dispatcher lane
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_NameDispatcherLane (size_t lane) {
+  switch (lane) {
+    case Dispatcher::SHORT_LANE: return "short";
+    case Dispatcher::LONG_LANE:  return "long";
+  }
+
+  return "unknown";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a job waited in a dispatcher queue, for its lane
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DispatcherLaneWaitStatistics (size_t lane, double waitTime) {
+  if (! TRI_ENABLE_STATISTICS || lane >= Dispatcher::LANE_SIZE) {
+    return;
+  }
+
+  LaneWaitTimes[lane].record(LatencyMicroseconds(waitTime));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the histogram of the times jobs waited in a lane
+////////////////////////////////////////////////////////////////////////////////
+
+LatencyHistogram const* TRI_DispatcherLaneWaitHistogram (size_t lane) {
+  if (lane >= Dispatcher::LANE_SIZE) {
+    return nullptr;
+  }
+
+  return &LaneWaitTimes[lane];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the wait statistics of all threads, one per wait point
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillWaitStatistics (std::vector<StatisticsDistribution>& waits) {
+  waits.clear();
+
+  for (size_t i = 0; i < TRI_WAIT_POINTS_MAX; ++i) {
+    waits.emplace_back(TRI_WaitTimeDistributionVectorStatistics);
+  }
+
+  MUTEX_LOCKER(WaitDataLock);
+
+  if (! EndedWaits.empty()) {
+    waits = EndedWaits;
+  }
+
+  for (auto const& data : WaitData) {
+    for (size_t i = 0; i < TRI_WAIT_POINTS_MAX; ++i) {
+      AddWaitPoint(waits[i], data->_points[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the dispatcher queue wait statistics of all threads, by handler
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillHandlerWaitStatistics (std::map<std::string, StatisticsDistribution>& handlers) {
+  MUTEX_LOCKER(WaitDataLock);
+
+  handlers = EndedHandlerWaits;
+
+  for (auto const& data : WaitData) {
+    MUTEX_LOCKER(data->_handlersLock);
+
+    for (auto const& it : data->_handlers) {
+      AddHandlerWaits(handlers, it.first, it.second);
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -360,6 +934,12 @@ static void StatisticsQueueWorker (void* data) {
   delete TRI_BytesSentDistributionStatistics;
   delete TRI_BytesReceivedDistributionStatistics;
 
+  {
+    MUTEX_LOCKER(V8ContextDataLock);
+    delete TRI_V8ContextWaitTimeDistributionStatistics;
+    TRI_V8ContextWaitTimeDistributionStatistics = nullptr;
+  }
+
   {
     TRI_request_statistics_t* entry = nullptr;
     while (RequestFreeList.pop(entry)) {
@@ -482,6 +1062,24 @@ StatisticsVector TRI_BytesReceivedDistributionVectorStatistics;
 
 StatisticsDistribution* TRI_BytesReceivedDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsVector TRI_V8ContextWaitTimeDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_V8ContextWaitTimeDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait time distribution vector, used for all wait points
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsVector TRI_WaitTimeDistributionVectorStatistics;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief global server statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -520,6 +1118,11 @@ void TRI_InitializeStatistics () {
   TRI_BytesSentDistributionVectorStatistics << (250) << (1000) << (2 * 1000) << (5 * 1000) << (10 * 1000);
   TRI_BytesReceivedDistributionVectorStatistics << (250) << (1000) << (2 * 1000) << (5 * 1000) << (10 * 1000);
   TRI_RequestTimeDistributionVectorStatistics << (0.01) << (0.05) << (0.1) << (0.2) << (0.5) << (1.0);
+  TRI_V8ContextWaitTimeDistributionVectorStatistics << (0.0001) << (0.001) << (0.01) << (0.1) << (1.0);
+
+  for (size_t i = 0; i < WaitTimeBuckets - 1; ++i) {
+    TRI_WaitTimeDistributionVectorStatistics << WaitTimeCuts[i];
+  }
 
   TRI_ConnectionTimeDistributionStatistics = new StatisticsDistribution(TRI_ConnectionTimeDistributionVectorStatistics);
   TRI_TotalTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
@@ -528,6 +1131,7 @@ void TRI_InitializeStatistics () {
   TRI_IoTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
   TRI_BytesSentDistributionStatistics = new StatisticsDistribution(TRI_BytesSentDistributionVectorStatistics);
   TRI_BytesReceivedDistributionStatistics = new StatisticsDistribution(TRI_BytesReceivedDistributionVectorStatistics);
+  TRI_V8ContextWaitTimeDistributionStatistics = new StatisticsDistribution(TRI_V8ContextWaitTimeDistributionVectorStatistics);
 
   // initialize counters for all HTTP request types
   TRI_MethodRequestsStatistics.clear();
@@ -31,6 +31,7 @@
 #define ARANGODB_STATISTICS_STATISTICS_H 1
 
 #include "Basics/Common.h"
+#include "Basics/LatencyHistogram.h"
 #include "Rest/HttpRequest.h"
 #include "Statistics/figures.h"
 
@@ -38,6 +39,13 @@
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal length of the endpoint name of a request, including the
+/// terminating null byte
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REQUEST_STATISTICS_ENDPOINT_LENGTH 64
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief request statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +85,35 @@ struct TRI_request_statistics_t {
     _tooLarge      = false;
     _executeError  = false;
     _ignore        = false;
+    _endpoint[0]   = '\0';
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the endpoint from the prefix of the handler
+///
+/// the catch-all handler runs all actions, so its requests are told apart
+/// by the first part of the path after the prefix. too long names are cut
+////////////////////////////////////////////////////////////////////////////////
+
+  void setEndpoint (char const* prefix, char const* first) {
+    size_t n = 0;
+
+    auto append = [&] (char const* p) {
+      while (*p != '\0' && n < sizeof(_endpoint) - 1) {
+        _endpoint[n++] = *p++;
+      }
+    };
+
+    append(prefix);
+
+    if (first != nullptr) {
+      if (n == 0 || _endpoint[n - 1] != '/') {
+        append("/");
+      }
+      append(first);
+    }
+
+    _endpoint[n] = '\0';
   }
 
   double _readStart;
@@ -97,6 +134,24 @@ struct TRI_request_statistics_t {
   bool _tooLarge;
   bool _executeError;
   bool _ignore;
+
+  char _endpoint[TRI_REQUEST_STATISTICS_ENDPOINT_LENGTH];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief latency histograms of the requests to one endpoint with one method
+///
+/// the histograms count microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_request_latency_t {
+  std::string _endpoint;
+  triagens::rest::HttpRequest::HttpRequestType _requestType;
+
+  triagens::basics::LatencyHistogram const* _totalTime;
+  triagens::basics::LatencyHistogram const* _requestTime;
+  triagens::basics::LatencyHistogram const* _queueTime;
+  triagens::basics::LatencyHistogram const* _ioTime;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -139,6 +194,20 @@ struct TRI_server_statistics_t {
   double _uptime;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief points at which threads wait
+////////////////////////////////////////////////////////////////////////////////
+
+enum TRI_wait_point_e {
+  TRI_WAIT_WAL_SLOT = 0,           // for a free slot in the write-ahead log
+  TRI_WAIT_WAL_SYNC,               // for syncing the write-ahead log to disk
+  TRI_WAIT_DATAFILE_SYNC,          // for syncing a datafile to disk
+  TRI_WAIT_V8_CONTEXT,             // for a free V8 context
+  TRI_WAIT_DISPATCHER_QUEUE,       // in a dispatcher queue, until the job runs
+
+  TRI_WAIT_POINTS_MAX
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                               public request statistics functions
 // -----------------------------------------------------------------------------
@@ -166,6 +235,15 @@ void TRI_FillRequestStatistics (triagens::basics::StatisticsDistribution& totalT
                                 triagens::basics::StatisticsDistribution& bytesSent,
                                 triagens::basics::StatisticsDistribution& bytesReceived);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the latency histograms of all endpoints
+///
+/// the histograms are kept until the server ends and are updated without a
+/// lock, so they can be read while requests are counted
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillRequestLatencyStatistics (std::vector<TRI_request_latency_t>& latencies);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                            public connection statistics functions
 // -----------------------------------------------------------------------------
@@ -202,6 +280,81 @@ void TRI_FillConnectionStatistics (triagens::basics::StatisticsCounter& httpConn
 
 TRI_server_statistics_t TRI_GetServerStatistics ();
 
+// -----------------------------------------------------------------------------
+// --SECTION--                            public V8 context statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a thread waited for a V8 context
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_V8ContextWaitStatistics (double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the current V8 context statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillV8ContextStatistics (triagens::basics::StatisticsDistribution& waitTime);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                  public wait statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of a wait point
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_NameWaitPoint (TRI_wait_point_e);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time the current thread waited at a wait point
+///
+/// the figures are kept per thread, so threads never contend with each other
+/// when they record a wait. they are added up when they are read
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_WaitStatistics (TRI_wait_point_e, double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a job waited in a dispatcher queue, for the wait point
+/// and for the handler that runs the job
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DispatcherQueueWaitStatistics (std::string const& handler, double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of a dispatcher lane
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_NameDispatcherLane (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a job waited in a dispatcher queue, for its lane
+///
+/// the lanes share one histogram each, which is updated without a lock
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DispatcherLaneWaitStatistics (size_t lane, double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the histogram of the times jobs waited in a lane, in
+/// microseconds, or nullptr for an unknown lane
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::LatencyHistogram const* TRI_DispatcherLaneWaitHistogram (size_t lane);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the wait statistics of all threads, one per wait point
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillWaitStatistics (std::vector<triagens::basics::StatisticsDistribution>& waits);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the dispatcher queue wait statistics of all threads, by handler
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillHandlerWaitStatistics (std::map<std::string, triagens::basics::StatisticsDistribution>& handlers);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -302,6 +455,24 @@ extern triagens::basics::StatisticsVector TRI_BytesReceivedDistributionVectorSta
 
 extern triagens::basics::StatisticsDistribution* TRI_BytesReceivedDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsVector TRI_V8ContextWaitTimeDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_V8ContextWaitTimeDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait time distribution vector, used for all wait points
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsVector TRI_WaitTimeDistributionVectorStatistics;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief global server statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -201,6 +201,22 @@ namespace triagens {
           return TRI_ERROR_NO_ERROR;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief release the read lock on a collection before the transaction ends.
+/// this is used by queries that have copied all documents they need from the
+/// collection. the transaction's ditch still protects the copied documents
+////////////////////////////////////////////////////////////////////////////////
+
+        int unlockCollection (TRI_voc_cid_t cid) {
+          TRI_transaction_collection_t* trxCollection = this->trxCollection(cid);
+
+          if (trxCollection == nullptr) {
+            return TRI_ERROR_NO_ERROR;
+          }
+
+          return this->unlock(trxCollection, TRI_TRANSACTION_READ);
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief keep a copy of the collections, this is needed for the clone 
 /// operation
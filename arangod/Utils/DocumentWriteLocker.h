@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locker for single-document operations
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_UTILS_DOCUMENT_WRITE_LOCKER_H
+#define ARANGODB_UTILS_DOCUMENT_WRITE_LOCKER_H 1
+
+#include "Basics/Common.h"
+
+#include "VocBase/document-collection.h"
+#include "VocBase/transaction.h"
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class DocumentWriteLocker
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks a collection for writing a single document
+///
+/// operations of single-operation transactions share the write lock of the
+/// collection with each other and only lock the key of the document they
+/// modify. all other operations lock the collection exclusively, as does
+/// the CollectionWriteLocker. this is also done for collections with a cap
+/// constraint, because inserting a document there may remove other documents
+////////////////////////////////////////////////////////////////////////////////
+
+    class DocumentWriteLocker {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        DocumentWriteLocker (DocumentWriteLocker const&) = delete;
+        DocumentWriteLocker& operator= (DocumentWriteLocker const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the locker
+/// the hash is the primary index hash of the document key
+////////////////////////////////////////////////////////////////////////////////
+
+        DocumentWriteLocker (TRI_transaction_collection_t* trxCollection,
+                             uint64_t hash,
+                             bool doLock)
+          : _document(trxCollection->_collection->_collection),
+            _keyLock(nullptr),
+            _doLock(false) {
+
+          if (! doLock) {
+            return;
+          }
+
+          if (_document->_capConstraint == nullptr &&
+              TRI_IsSingleOperationTransaction(trxCollection->_transaction)) {
+            if (! _document->beginConcurrentWrite()) {
+              // collection must not be locked by command
+              return;
+            }
+
+            // a cap constraint may have been created while we waited
+            if (_document->_capConstraint == nullptr) {
+              _keyLock = &_document->keyLock(hash);
+              _keyLock->lock();
+              return;
+            }
+
+            _document->endConcurrentWrite();
+          }
+
+          _document->beginWrite();
+          _doLock = true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the locker
+////////////////////////////////////////////////////////////////////////////////
+
+        ~DocumentWriteLocker () {
+          if (_keyLock != nullptr) {
+            _keyLock->unlock();
+            _document->endConcurrentWrite();
+          }
+          else if (_doLock) {
+            _document->endWrite();
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection pointer
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_document_collection_t* _document;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the key lock, if the collection lock is shared
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex* _keyLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection is locked exclusively
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _doLock;
+
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
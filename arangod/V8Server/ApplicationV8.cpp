@@ -52,6 +52,7 @@
 #include "Rest/HttpRequest.h"
 #include "Scheduler/ApplicationScheduler.h"
 #include "Scheduler/Scheduler.h"
+#include "Statistics/statistics.h"
 #include "V8/v8-buffer.h"
 #include "V8/v8-conv.h"
 #include "V8/v8-shell.h"
@@ -113,6 +114,74 @@ static std::string DeprecatedPath;
 
 static bool DeprecatedOption;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief isolate data slot holding the V8Context of an isolate
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t const V8ContextSlot = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief growth of the heap usage since the last garbage collection of a
+/// context, as a fraction of the heap threshold, that is needed before the
+/// heap usage triggers another garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+static double const GcHeapGrowth = 0.25;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief notes the start of a garbage collection pause
+////////////////////////////////////////////////////////////////////////////////
+
+static void GcPrologueCallback (v8::Isolate* isolate,
+                                v8::GCType type,
+                                v8::GCCallbackFlags flags) {
+  auto context = static_cast<ApplicationV8::V8Context*>(isolate->GetData(V8ContextSlot));
+
+  if (context != nullptr) {
+    context->_gcStart = TRI_microtime();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records a garbage collection pause
+////////////////////////////////////////////////////////////////////////////////
+
+static void GcEpilogueCallback (v8::Isolate* isolate,
+                                v8::GCType type,
+                                v8::GCCallbackFlags flags) {
+  auto context = static_cast<ApplicationV8::V8Context*>(isolate->GetData(V8ContextSlot));
+
+  if (context == nullptr || context->_gcStart == 0.0) {
+    return;
+  }
+
+  double const pause = TRI_microtime() - context->_gcStart;
+  context->_gcStart = 0.0;
+
+  MUTEX_LOCKER(context->_statisticsLock);
+
+  ++context->_gcPauses;
+  context->_gcPauseTime += pause;
+
+  if (pause > context->_gcPauseMax) {
+    context->_gcPauseMax = pause;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the heap usage of a context, the isolate must be entered
+////////////////////////////////////////////////////////////////////////////////
+
+static void UpdateHeapStatistics (ApplicationV8::V8Context* context) {
+  v8::HeapStatistics heapStatistics;
+  context->isolate->GetHeapStatistics(&heapStatistics);
+
+  MUTEX_LOCKER(context->_statisticsLock);
+
+  context->_heapUsed  = heapStatistics.used_heap_size();
+  context->_heapLimit = heapStatistics.heap_size_limit();
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  class V8GcThread
 // -----------------------------------------------------------------------------
@@ -249,6 +318,27 @@ void ApplicationV8::V8Context::handleGlobalContextMethods () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the heap usage calls for a garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::V8Context::needsHeapGc (double threshold) const {
+  if (_heapLimit == 0) {
+    return false;
+  }
+
+  double const usage = heapUsage();
+
+  if (usage < threshold) {
+    return false;
+  }
+
+  // whatever survived the last garbage collection is likely still alive
+  double const usageAfterGc = static_cast<double>(_heapUsedAfterGc) / static_cast<double>(_heapLimit);
+
+  return usage - usageAfterGc >= threshold * GcHeapGrowth;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief executes the cancelation cleanup
 ////////////////////////////////////////////////////////////////////////////////
@@ -291,6 +381,8 @@ ApplicationV8::ApplicationV8 (TRI_server_t* server,
     _frontendVersionCheck(true),
     _gcInterval(1000),
     _gcFrequency(10.0),
+    _gcHeapThreshold(0.25),
+    _gcIdleTime(5),
     _v8Options(""),
     _startupLoader(),
     _vocbase(nullptr),
@@ -354,49 +446,60 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
   v8::Isolate* isolate = nullptr;
   V8Context* context   = nullptr;
 
+  double const waitStart = TRI_microtime();
+  auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+
   // this is for TESTING / DEBUGGING only
   if (forceContext != -1) {
     size_t id = (size_t) forceContext;
 
+    CONDITION_LOCKER(guard, _contextCondition);
+
     while (! _stopping) {
-      {
-	CONDITION_LOCKER(guard, _contextCondition);
-
-	for (auto iter = _freeContexts.begin();  iter != _freeContexts.end();  ++iter) {
-	  if ((*iter)->_id == id) {
-	    context = *iter;
-	    _freeContexts.erase(iter);
-	    _busyContexts.emplace(context);
-	    break;
-	  }
-	}
-
-	if (context != nullptr) {
-	  break;
-	}
-
-	for (auto iter = _dirtyContexts.begin();  iter != _dirtyContexts.end();  ++iter) {
-	  if ((*iter)->_id == id) {
-	    context = *iter;
-	    _dirtyContexts.erase(iter);
-	    _busyContexts.emplace(context);
-	    break;
-	  }
-	}
-
-	if (context != nullptr) {
-	  break;
-	}
+      for (auto iter = _freeContexts.begin();  iter != _freeContexts.end();  ++iter) {
+        if ((*iter)->_id == id) {
+          context = *iter;
+          _freeContexts.erase(iter);
+          _busyContexts.emplace(context);
+          break;
+        }
+      }
+
+      if (context != nullptr) {
+        break;
+      }
+
+      for (auto iter = _dirtyContexts.begin();  iter != _dirtyContexts.end();  ++iter) {
+        if ((*iter)->_id == id) {
+          context = *iter;
+          _dirtyContexts.erase(iter);
+          _busyContexts.emplace(context);
+          break;
+        }
       }
 
+      if (context != nullptr) {
+        break;
+      }
+
+      // the context is in use or in the garbage collection. both exitContext
+      // and the garbage collector signal the condition when they return it
       LOG_DEBUG("waiting for V8 context %d to become available", (int) id);
-      usleep(100 * 1000);
+
+      if (currentThread != nullptr) {
+        currentThread->block();
+      }
+      guard.wait();
+      if (currentThread != nullptr) {
+        currentThread->unblock();
+      }
     }
 
     if (context == nullptr) {
       return nullptr;
     }
 
+    context->_lastThread = currentThread;
     isolate = context->isolate;
   }
 
@@ -414,14 +517,12 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
         _dirtyContexts.pop_back();
       }
       else {
-        auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
-
         if (currentThread != nullptr) {
-          triagens::rest::DispatcherThread::currentDispatcherThread->block();
+          currentThread->block();
         }
         guard.wait();
         if (currentThread != nullptr) {
-          triagens::rest::DispatcherThread::currentDispatcherThread->unblock();
+          currentThread->unblock();
         }
       }
     }
@@ -435,13 +536,11 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
     LOG_TRACE("found unused V8 context");
     TRI_ASSERT(! _freeContexts.empty());
 
-    context = _freeContexts.back();
+    context = takeFreeContext();
     TRI_ASSERT(context != nullptr);
 
     isolate = context->isolate;
 
-    _freeContexts.pop_back();
-
     // should not fail because we reserved enough space beforehand
     _busyContexts.emplace(context);
   }
@@ -450,6 +549,8 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
   TRI_ASSERT(context != nullptr);
   TRI_ASSERT(isolate != nullptr);
 
+  TRI_V8ContextWaitStatistics(TRI_microtime() - waitStart);
+
   context->_locker = new v8::Locker(isolate);
   context->isolate->Enter();
 
@@ -533,6 +634,16 @@ void ApplicationV8::exitContext (V8Context* context) {
       context->handleGlobalContextMethods();
     }
 
+    UpdateHeapStatistics(context);
+
+    // if the heap is growing, let V8 run incremental garbage collection
+    // steps for a bounded time now instead of a long pause in a later request.
+    // this runs in the request thread, the context is not yet free
+    if (_gcIdleTime > 0 && context->heapUsage() >= _gcHeapThreshold / 2.0) {
+      isolate->IdleNotification(static_cast<int>(_gcIdleTime));
+      UpdateHeapStatistics(context);
+    }
+
     // now really exit
     auto localContext = v8::Local<v8::Context>::New(isolate, context->_context);
     localContext->Exit();
@@ -565,6 +676,10 @@ void ApplicationV8::exitContext (V8Context* context) {
     LOG_TRACE("V8 context has reached maximum number of requests and will be scheduled for GC");
     performGarbageCollection = true;
   }
+  else if (context->needsHeapGc(_gcHeapThreshold)) {
+    LOG_TRACE("V8 context has reached the heap usage threshold and will be scheduled for GC");
+    performGarbageCollection = true;
+  }
   
   { 
     CONDITION_LOCKER(guard, _contextCondition);
@@ -690,6 +805,8 @@ void ApplicationV8::collectGarbage () {
         TRI_GET_GLOBALS();
         hasActiveExternals = v8g->hasActiveExternals();
         TRI_RunGarbageCollectionV8(isolate, 1.0);
+        UpdateHeapStatistics(context);
+        context->_heapUsedAfterGc = context->_heapUsed;
 
         localContext->Exit();
       }
@@ -715,6 +832,41 @@ void ApplicationV8::collectGarbage () {
   _gcFinished = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the heap and garbage collection statistics of all contexts
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<ApplicationV8::V8ContextStatistics> ApplicationV8::contextStatistics () {
+  std::vector<V8ContextStatistics> result;
+
+  if (_contexts == nullptr) {
+    return result;
+  }
+
+  result.reserve(_nrInstances);
+
+  for (size_t i = 0; i < _nrInstances; ++i) {
+    V8Context* context = _contexts[i];
+
+    if (context == nullptr) {
+      continue;
+    }
+
+    MUTEX_LOCKER(context->_statisticsLock);
+
+    result.emplace_back(V8ContextStatistics{ 
+      context->_id,
+      context->_heapUsed,
+      context->_heapLimit,
+      context->_gcPauses,
+      context->_gcPauseTime,
+      context->_gcPauseMax
+    });
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -938,6 +1090,8 @@ void ApplicationV8::setupOptions (map<string, basics::ProgramOptionsDescription>
   options["Javascript Options:help-admin"]
     ("javascript.gc-interval", &_gcInterval, "JavaScript request-based garbage collection interval (each x requests)")
     ("javascript.gc-frequency", &_gcFrequency, "JavaScript time-based garbage collection frequency (each x seconds)")
+    ("javascript.gc-heap-threshold", &_gcHeapThreshold, "JavaScript heap usage (fraction of the heap limit) that triggers a garbage collection")
+    ("javascript.gc-idle-time", &_gcIdleTime, "JavaScript incremental garbage collection time when leaving a context (in milliseconds, spent in the request thread)")
     ("javascript.app-path", &_appPath, "directory for Foxx applications (normal mode)")
     ("javascript.startup-directory", &_startupPath, "path to the directory containing JavaScript startup scripts")
     ("javascript.v8-options", &_v8Options, "options to pass to v8")
@@ -1010,6 +1164,10 @@ bool ApplicationV8::prepare () {
     _gcFrequency = 1;
   }
 
+  if (_gcHeapThreshold <= 0.0 || _gcHeapThreshold > 1.0) {
+    LOG_FATAL_AND_EXIT("invalid value for --javascript.gc-heap-threshold, must be greater than 0 and at most 1");
+  }
+
   return true;
 }
 
@@ -1174,8 +1332,10 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
 
   V8Context* context = nullptr;
 
-  // we got more than 1 context to clean up, pick the one with the "oldest" GC stamp
-  int pickedContextNr = -1; // index of context with lowest GC stamp, -1 means "none"
+  // we got more than 1 context to clean up, pick the one with the highest
+  // heap usage, and among contexts with the same usage the one with the
+  // "oldest" GC stamp
+  int pickedContextNr = -1; // index of context to pick, -1 means "none"
 
   for (int i = 0; i < n; ++i) {
     // check if there's actually anything to clean up in the context
@@ -1183,9 +1343,18 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
       continue;
     }
 
-    // compare last GC stamp
-    if (pickedContextNr == -1 ||
-        _freeContexts[i]->_lastGcStamp <= _freeContexts[pickedContextNr]->_lastGcStamp) {
+    if (pickedContextNr == -1) {
+      pickedContextNr = i;
+      continue;
+    }
+
+    double const usage = _freeContexts[i]->heapUsage();
+    double const pickedUsage = _freeContexts[pickedContextNr]->heapUsage();
+
+    // compare heap usage and last GC stamp
+    if (usage > pickedUsage ||
+        (usage == pickedUsage &&
+         _freeContexts[i]->_lastGcStamp <= _freeContexts[pickedContextNr]->_lastGcStamp)) {
       pickedContextNr = i;
     }
   }
@@ -1201,7 +1370,8 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
   TRI_ASSERT(context != nullptr);
 
   // now compare its last GC timestamp with the last global GC stamp
-  if (context->_lastGcStamp + _gcFrequency >= gc->getLastGcStamp()) {
+  if (context->_lastGcStamp + _gcFrequency >= gc->getLastGcStamp() &&
+      ! context->needsHeapGc(_gcHeapThreshold)) {
     // no need yet to clean up the context
     return nullptr;
   }
@@ -1219,6 +1389,49 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
   return context;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a context from the free list, preferring the context that the
+/// current dispatcher thread used last
+////////////////////////////////////////////////////////////////////////////////
+
+ApplicationV8::V8Context* ApplicationV8::takeFreeContext () {
+  TRI_ASSERT(! _freeContexts.empty());
+
+  auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+
+  // the most recently returned context is at the end of the list. use it
+  // unless the current thread finds its own context or a context that no
+  // other dispatcher thread has used, so that each dispatcher thread keeps
+  // running on the same isolate and its compiled code when possible
+  size_t const n = _freeContexts.size();
+  size_t picked = n - 1;
+
+  if (currentThread != nullptr) {
+    bool foundUnbound = false;
+
+    for (size_t i = n; i > 0; --i) {
+      auto lastThread = _freeContexts[i - 1]->_lastThread;
+
+      if (lastThread == currentThread) {
+        picked = i - 1;
+        break;
+      }
+
+      if (lastThread == nullptr && ! foundUnbound) {
+        picked = i - 1;
+        foundUnbound = true;
+      }
+    }
+  }
+
+  V8Context* context = _freeContexts[picked];
+  _freeContexts.erase(_freeContexts.begin() + picked);
+
+  context->_lastThread = currentThread;
+
+  return context;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief prepares a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
@@ -1243,6 +1456,18 @@ bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
   // enter a new isolate
   context->_id = i;
   context->isolate = isolate;
+  context->_heapUsed = 0;
+  context->_heapLimit = 0;
+  context->_heapUsedAfterGc = 0;
+  context->_gcStart = 0.0;
+  context->_gcPauses = 0;
+  context->_gcPauseTime = 0.0;
+  context->_gcPauseMax = 0.0;
+
+  isolate->SetData(V8ContextSlot, context);
+  isolate->AddGCPrologueCallback(GcPrologueCallback);
+  isolate->AddGCEpilogueCallback(GcEpilogueCallback);
+
   TRI_ASSERT(context->_locker == nullptr);
   context->_locker = new v8::Locker(isolate);
   context->isolate->Enter();
@@ -1347,6 +1572,7 @@ bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
   context->_numExecutions      = 0;
   context->_hasActiveExternals = true;
   context->_lastGcStamp        = TRI_microtime() + randomWait;
+  context->_lastThread         = nullptr;
 
   LOG_TRACE("initialized V8 context #%d", (int) i);
 
@@ -56,6 +56,7 @@ namespace triagens {
   namespace rest {
     class HttpRequest;
     class ApplicationDispatcher;
+    class DispatcherThread;
     class ApplicationScheduler;
   }
 
@@ -279,6 +280,97 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
           bool _hasActiveExternals;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dispatcher thread that used the context last, nullptr if the
+/// context was last used by another thread or not at all
+////////////////////////////////////////////////////////////////////////////////
+
+          rest::DispatcherThread* _lastThread;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fraction of the heap limit in use when the context was left last
+////////////////////////////////////////////////////////////////////////////////
+
+          double heapUsage () const {
+            if (_heapLimit == 0) {
+              return 0.0;
+            }
+            return static_cast<double>(_heapUsed) / static_cast<double>(_heapLimit);
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the heap usage calls for a garbage collection
+///
+/// the usage must exceed the threshold and must have grown since the last
+/// garbage collection of the context. otherwise a context whose live objects
+/// alone exceed the threshold would be collected after each request
+////////////////////////////////////////////////////////////////////////////////
+
+          bool needsHeapGc (double threshold) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief mutex to protect the heap and garbage collection statistics
+////////////////////////////////////////////////////////////////////////////////
+
+          basics::Mutex _statisticsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief used heap size in bytes when the context was left last
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _heapUsed;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief heap size limit in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _heapLimit;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief used heap size in bytes after the last garbage collection of the
+/// garbage collection thread
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _heapUsedAfterGc;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief start of the running garbage collection, only used by the thread
+/// that holds the isolate
+////////////////////////////////////////////////////////////////////////////////
+
+          double _gcStart;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of garbage collection pauses
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _gcPauses;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time of all garbage collection pauses in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+          double _gcPauseTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief longest garbage collection pause in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+          double _gcPauseMax;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief heap and garbage collection statistics of a context
+////////////////////////////////////////////////////////////////////////////////
+
+        struct V8ContextStatistics {
+          size_t _id;
+          size_t _heapUsed;
+          size_t _heapLimit;
+          uint64_t _gcPauses;
+          double _gcPauseTime;
+          double _gcPauseMax;
         };
 
 // -----------------------------------------------------------------------------
@@ -352,6 +444,12 @@ namespace triagens {
 
         void collectGarbage ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the heap and garbage collection statistics of all contexts
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<V8ContextStatistics> contextStatistics ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -446,6 +544,15 @@ namespace triagens {
 
         V8Context* pickFreeContextForGc ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes a context from the free list, preferring the context that the
+/// current dispatcher thread used last
+///
+/// Caller must hold the _contextCondition.
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* takeFreeContext ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief prepares a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
@@ -558,6 +665,35 @@ namespace triagens {
 
         double _gcFrequency;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief JavaScript heap usage that triggers a garbage collection
+/// `--javascript.gc-heap-threshold fraction`
+///
+/// Specifies the fraction of the V8 heap limit that may be in use when a
+/// context is left. A context using more is handed to the garbage collection
+/// thread before it is used again, and the garbage collection thread prefers
+/// the contexts with the highest heap usage when it has idle time. A context
+/// is only handed over again once its heap usage has grown by a quarter of
+/// the threshold since its last garbage collection, so that a context whose
+/// live objects alone exceed the threshold is not collected after each
+/// request.
+////////////////////////////////////////////////////////////////////////////////
+
+        double _gcHeapThreshold;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief JavaScript idle garbage collection time (in milliseconds)
+/// `--javascript.gc-idle-time milliseconds`
+///
+/// Specifies the time V8 may spend on incremental garbage collection steps
+/// when a context whose heap usage exceeds half of the heap threshold is
+/// left. The steps run in the thread that leaves the context, before the
+/// context is released, so they add up to this time to the request. A value
+/// of 0 turns the incremental steps off.
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _gcIdleTime;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief optional arguments to pass to v8
 /// @startDocuBlock jsV8Options
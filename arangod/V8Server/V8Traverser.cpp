@@ -47,26 +47,6 @@ using namespace triagens::basics;
 using namespace triagens::basics::traverser;
 using namespace triagens::arango;
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief extract the _from Id out of mptr, we return an RValue reference
-/// to explicitly allow move semantics.
-////////////////////////////////////////////////////////////////////////////////
-
-static VertexId ExtractFromId (TRI_doc_mptr_copy_t const& ptr) {
-  return VertexId(TRI_EXTRACT_MARKER_FROM_CID(&ptr),
-                  TRI_EXTRACT_MARKER_FROM_KEY(&ptr));
-};
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief extract the _to Id out of mptr, we return an RValue reference
-/// to explicitly allow move semantics.
-////////////////////////////////////////////////////////////////////////////////
-
-static VertexId ExtractToId (TRI_doc_mptr_copy_t const& ptr) {
-  return VertexId(TRI_EXTRACT_MARKER_TO_CID(&ptr),
-                  TRI_EXTRACT_MARKER_TO_KEY(&ptr));
-};
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Expander for Multiple edge collections
 ////////////////////////////////////////////////////////////////////////////////
@@ -116,44 +96,33 @@ class MultiCollectionEdgeExpander {
       TransactionBase fake(true); // Fake a transaction to please checks. 
                                   // This is due to multi-threading
 
-      equal_to<VertexId> eq;
       for (auto const& edgeCollection : _edgeCollections) { 
-        auto edges = edgeCollection->getEdges(_direction, source); 
-
         unordered_map<VertexId, size_t> candidates;
-        for (size_t j = 0;  j < edges.size(); ++j) {
-          EdgeId edgeId = edgeCollection->extractEdgeId(edges[j]);
-          if (! _isAllowed(edgeId, &edges[j])) {
-            continue;
+
+        edgeCollection->forEachNeighbor(_direction, source, [&] (TRI_doc_mptr_copy_t& edge, VertexId& neighbor) {
+          EdgeId edgeId = edgeCollection->extractEdgeId(edge);
+          if (! _isAllowed(edgeId, &edge)) {
+            return;
           }
-          VertexId from = ExtractFromId(edges[j]);
-          VertexId to = ExtractToId(edges[j]);
-          double currentWeight = edgeCollection->weightEdge(edges[j]);
-          auto inserter = [&](VertexId& s, VertexId& t) {
-            if (_isAllowedVertex(t)) {
-              auto cand = candidates.find(t);
-              if (cand == candidates.end()) {
-                // Add weight
-                result.emplace_back(new ArangoDBPathFinder::Step(t, s, currentWeight,
-                                    edgeId));
-                candidates.emplace(t, result.size() - 1);
-              } 
-              else {
-                // Compare weight
-                auto oldWeight = result[cand->second]->weight();
-                if (currentWeight < oldWeight) {
-                  result[cand->second]->setWeight(currentWeight);
-                }
-              }
-            }
-          };
-          if (! eq(from, source)) {
-            inserter(to, from);
+          if (! _isAllowedVertex(neighbor)) {
+            return;
+          }
+          double currentWeight = edgeCollection->weightEdge(edge);
+          auto cand = candidates.find(neighbor);
+          if (cand == candidates.end()) {
+            // Add weight
+            result.emplace_back(new ArangoDBPathFinder::Step(neighbor, source, currentWeight,
+                                edgeId));
+            candidates.emplace(neighbor, result.size() - 1);
           } 
-          else if (! eq(to, source)) {
-            inserter(from, to);
+          else {
+            // Compare weight
+            auto oldWeight = result[cand->second]->weight();
+            if (currentWeight < oldWeight) {
+              result[cand->second]->setWeight(currentWeight);
+            }
           }
-        }
+        });
       }
     } 
 };
@@ -184,37 +153,25 @@ class SimpleEdgeExpander {
                      vector<ArangoDBPathFinder::Step*>& result) {
       TransactionBase fake(true); // Fake a transaction to please checks. 
                                   // This is due to multi-threading
-      auto edges = _edgeCollection->getEdges(_direction, source); 
-
-      equal_to<VertexId> eq;
       unordered_map<VertexId, size_t> candidates;
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        VertexId from = ExtractFromId(edges[j]);
-        VertexId to = ExtractToId(edges[j]);
-        double currentWeight = _edgeCollection->weightEdge(edges[j]);
-        auto inserter = [&](VertexId& s, VertexId& t) {
-          auto cand = candidates.find(t);
-          if (cand == candidates.end()) {
-            // Add weight
-            result.emplace_back(new ArangoDBPathFinder::Step(t, s, currentWeight, 
-                                _edgeCollection->extractEdgeId(edges[j])));
-            candidates.emplace(t, result.size() - 1);
-          } 
-          else {
-            // Compare weight
-            auto oldWeight = result[cand->second]->weight();
-            if (currentWeight < oldWeight) {
-              result[cand->second]->setWeight(currentWeight);
-            }
-          }
-        };
-        if (! eq(from, source)) {
-          inserter(to, from);
+
+      _edgeCollection->forEachNeighbor(_direction, source, [&] (TRI_doc_mptr_copy_t& edge, VertexId& neighbor) {
+        double currentWeight = _edgeCollection->weightEdge(edge);
+        auto cand = candidates.find(neighbor);
+        if (cand == candidates.end()) {
+          // Add weight
+          result.emplace_back(new ArangoDBPathFinder::Step(neighbor, source, currentWeight, 
+                              _edgeCollection->extractEdgeId(edge)));
+          candidates.emplace(neighbor, result.size() - 1);
         } 
-        else if (! eq(to, source)) {
-          inserter(from, to);
+        else {
+          // Compare weight
+          auto oldWeight = result[cand->second]->weight();
+          if (currentWeight < oldWeight) {
+            result[cand->second]->setWeight(currentWeight);
+          }
         }
-      }
+      });
     } 
 };
 
@@ -445,12 +402,14 @@ unique_ptr<ArangoDBPathFinder::Path> TRI_RunShortestPathSearch (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Wrapper for the shortest path computation
+/// @brief Wrapper for the shortest path computation without edge weights.
+/// the edge and vertex filters are applied while expanding
 ////////////////////////////////////////////////////////////////////////////////
 
 std::unique_ptr<ArangoDBConstDistancePathFinder::Path> TRI_RunSimpleShortestPathSearch ( 
     vector<EdgeCollectionInfo*>& collectionInfos,
-    ShortestPathOptions& opts) {
+    ShortestPathOptions& opts,
+    triagens::basics::ThreadPool* pool) {
 
   TRI_edge_direction_e forward;
   TRI_edge_direction_e backward;
@@ -468,205 +427,81 @@ std::unique_ptr<ArangoDBConstDistancePathFinder::Path> TRI_RunSimpleShortestPath
     backward = TRI_EDGE_ANY;
   }
 
-  auto fwExpander = [&collectionInfos, forward] (VertexId& v, vector<EdgeId>& res_edges, vector<VertexId>& neighbors) {
-    equal_to<VertexId> eq;
+  auto expander = [&collectionInfos, &opts] (TRI_edge_direction_e direction, VertexId& v, vector<EdgeId>& res_edges, vector<VertexId>& neighbors) {
+    TransactionBase fake(true); // Fake a transaction to please checks. 
+                                // This is due to multi-threading
     for (auto const& edgeCollection : collectionInfos) { 
-      auto edges = edgeCollection->getEdges(forward, v); 
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = edgeCollection->extractEdgeId(edges[j]);
-        VertexId from = ExtractFromId(edges[j]);
-        if (! eq(from, v)) {
-          res_edges.emplace_back(edgeId);
-          neighbors.emplace_back(from);
-        } else {
-          VertexId to = ExtractToId(edges[j]);
-          if (! eq(to, v)) {
-            res_edges.emplace_back(edgeId);
-            neighbors.emplace_back(to);
-          }
+      edgeCollection->forEachNeighbor(direction, v, [&] (TRI_doc_mptr_copy_t& edge, VertexId& neighbor) {
+        EdgeId edgeId = edgeCollection->extractEdgeId(edge);
+        if (! opts.matchesEdge(edgeId, &edge)) {
+          return;
         }
-      }
-    }
-  };
-  auto bwExpander = [&collectionInfos, backward] (VertexId& v, vector<EdgeId>& res_edges, vector<VertexId>& neighbors) {
-    equal_to<VertexId> eq;
-    for (auto const& edgeCollection : collectionInfos) { 
-      auto edges = edgeCollection->getEdges(backward, v); 
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = edgeCollection->extractEdgeId(edges[j]);
-        VertexId from = ExtractFromId(edges[j]);
-        if (! eq(from, v)) {
-          res_edges.emplace_back(edgeId);
-          neighbors.emplace_back(from);
-        } else {
-          VertexId to = ExtractToId(edges[j]);
-          if (! eq(to, v)) {
-            res_edges.emplace_back(edgeId);
-            neighbors.emplace_back(to);
-          }
+        if (! opts.matchesVertex(neighbor)) {
+          return;
         }
-      }
+        res_edges.emplace_back(edgeId);
+        neighbors.emplace_back(neighbor);
+      });
     }
   };
+  auto fwExpander = [&expander, forward] (VertexId& v, vector<EdgeId>& res_edges, vector<VertexId>& neighbors) {
+    expander(forward, v, res_edges, neighbors);
+  };
+  auto bwExpander = [&expander, backward] (VertexId& v, vector<EdgeId>& res_edges, vector<VertexId>& neighbors) {
+    expander(backward, v, res_edges, neighbors);
+  };
 
   ArangoDBConstDistancePathFinder pathFinder(fwExpander, bwExpander);
   std::unique_ptr<ArangoDBConstDistancePathFinder::Path> path;
-  path.reset(pathFinder.search(opts.start, opts.end));
-  return path;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief search for distinct inbound neighbors
-////////////////////////////////////////////////////////////////////////////////
-
-static void InboundNeighbors (vector<EdgeCollectionInfo*>& collectionInfos,
-                              NeighborsOptions& opts,
-                              unordered_set<VertexId>& startVertices,
-                              unordered_set<VertexId>& visited,
-                              unordered_set<VertexId>& distinct,
-                              uint64_t depth = 1) {
-
-  TRI_edge_direction_e dir = TRI_EDGE_IN;
-  unordered_set<VertexId> nextDepth;
-
-  for (auto const& col : collectionInfos) {
-    for (VertexId const& start : startVertices) {
-      auto edges = col->getEdges(dir, start);
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = col->extractEdgeId(edges[j]);
-
-        if (opts.matchesEdge(edgeId, &edges[j])) {
-          VertexId v = ExtractFromId(edges[j]);
-          if (visited.find(v) != visited.end()) {
-            // We have already visited this vertex
-            continue;
-          }
-          visited.emplace(v);
-          if (depth >= opts.minDepth) {
-            if (opts.matchesVertex(v)) {
-              distinct.emplace(v);
-            }
-          }
-          if (depth < opts.maxDepth) {
-            nextDepth.emplace(v);
-          }
-        }
-      }
-    }
+  if (opts.multiThreaded) {
+    path.reset(pathFinder.searchTwoThreads(opts.start, opts.end, pool));
   }
-
-  if (! nextDepth.empty()) {
-    InboundNeighbors(collectionInfos, opts, nextDepth, visited, distinct, depth + 1);
+  else {
+    path.reset(pathFinder.search(opts.start, opts.end));
   }
+  return path;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief search for distinct outbound neighbors
+/// @brief search for distinct neighbors in the given direction
 ////////////////////////////////////////////////////////////////////////////////
 
-static void OutboundNeighbors (vector<EdgeCollectionInfo*>& collectionInfos,
-                               NeighborsOptions& opts,
-                               unordered_set<VertexId>& startVertices,
-                               unordered_set<VertexId>& visited,
-                               unordered_set<VertexId>& distinct,
-                               uint64_t depth = 1) {
+static void Neighbors (vector<EdgeCollectionInfo*>& collectionInfos,
+                       NeighborsOptions& opts,
+                       TRI_edge_direction_e dir,
+                       unordered_set<VertexId>& startVertices,
+                       unordered_set<VertexId>& visited,
+                       unordered_set<VertexId>& distinct,
+                       uint64_t depth = 1) {
 
-  TRI_edge_direction_e dir = TRI_EDGE_OUT;
   unordered_set<VertexId> nextDepth;
 
   for (auto const& col : collectionInfos) {
     for (VertexId const& start : startVertices) {
-      auto edges = col->getEdges(dir, start);
-
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = col->extractEdgeId(edges[j]);
-        if (opts.matchesEdge(edgeId, &edges[j])) {
-          VertexId v = ExtractToId(edges[j]);
-          if (visited.find(v) != visited.end()) {
-            // We have already visited this vertex
-            continue;
-          }
-          visited.emplace(v);
-          if (depth >= opts.minDepth) {
-            if (opts.matchesVertex(v)) {
-              distinct.emplace(v);
-            }
-          }
-          if (depth < opts.maxDepth) {
-            nextDepth.emplace(v);
-          }
+      col->forEachNeighbor(dir, start, [&] (TRI_doc_mptr_copy_t& edge, VertexId& v) {
+        EdgeId edgeId = col->extractEdgeId(edge);
+        if (! opts.matchesEdge(edgeId, &edge)) {
+          return;
         }
-      }
-    }
-  }
-  if (! nextDepth.empty()) {
-    OutboundNeighbors(collectionInfos, opts, nextDepth, visited, distinct, depth + 1);
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief search for distinct in- and outbound neighbors
-////////////////////////////////////////////////////////////////////////////////
-
-static void AnyNeighbors (vector<EdgeCollectionInfo*>& collectionInfos,
-                          NeighborsOptions& opts,
-                          unordered_set<VertexId>& startVertices,
-                          unordered_set<VertexId>& visited,
-                          unordered_set<VertexId>& distinct,
-                          uint64_t depth = 1) {
-
-  TRI_edge_direction_e dir = TRI_EDGE_OUT;
-  unordered_set<VertexId> nextDepth;
-
-  for (auto const& col : collectionInfos) {
-    for (VertexId const& start : startVertices) {
-      dir = TRI_EDGE_OUT;
-      auto edges = col->getEdges(dir, start);
-
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = col->extractEdgeId(edges[j]);
-        if (opts.matchesEdge(edgeId, &edges[j])) {
-          VertexId v = ExtractToId(edges[j]);
-          if (visited.find(v) != visited.end()) {
-            // We have already visited this vertex
-            continue;
-          }
-          visited.emplace(v);
-          if (depth >= opts.minDepth) {
-            if (opts.matchesVertex(v)) {
-              distinct.emplace(v);
-            }
-          }
-          if (depth < opts.maxDepth) {
-            nextDepth.emplace(v);
-          }
+        if (visited.find(v) != visited.end()) {
+          // We have already visited this vertex
+          return;
         }
-      }
-      dir = TRI_EDGE_IN;
-      edges = col->getEdges(dir, start);
-      for (size_t j = 0;  j < edges.size(); ++j) {
-        EdgeId edgeId = col->extractEdgeId(edges[j]);
-        if (opts.matchesEdge(edgeId, &edges[j])) {
-          VertexId v = ExtractFromId(edges[j]);
-          if (visited.find(v) != visited.end()) {
-            // We have already visited this vertex
-            continue;
-          }
-          visited.emplace(v);
-          if (depth >= opts.minDepth) {
-            if (opts.matchesVertex(v)) {
-              distinct.emplace(v);
-            }
-          }
-          if (depth < opts.maxDepth) {
-            nextDepth.emplace(v);
+        visited.emplace(v);
+        if (depth >= opts.minDepth) {
+          if (opts.matchesVertex(v)) {
+            distinct.emplace(v);
           }
         }
-      }
+        if (depth < opts.maxDepth) {
+          nextDepth.emplace(v);
+        }
+      });
     }
   }
+
   if (! nextDepth.empty()) {
-    AnyNeighbors(collectionInfos, opts, nextDepth, visited, distinct, depth + 1);
+    Neighbors(collectionInfos, opts, dir, nextDepth, visited, distinct, depth + 1);
   }
 }
 
@@ -683,16 +518,6 @@ void TRI_RunNeighborsSearch (
   startVertices.emplace(opts.start);
   visited.emplace(opts.start);
 
-  switch (opts.direction) {
-    case TRI_EDGE_IN:
-      InboundNeighbors(collectionInfos, opts, startVertices, visited, result);
-      break;
-    case TRI_EDGE_OUT:
-      OutboundNeighbors(collectionInfos, opts, startVertices, visited, result);
-      break;
-    case TRI_EDGE_ANY:
-      AnyNeighbors(collectionInfos, opts, startVertices, visited, result);
-      break;
-  }
+  Neighbors(collectionInfos, opts, opts.direction, startVertices, visited, result);
 }
 
@@ -34,6 +34,7 @@
 #include "Basics/Traverser.h"
 #include "Utils/ExplicitTransaction.h"
 #include "VocBase/edge-collection.h"
+#include "VocBase/EdgeSnapshot.h"
 #include "VocBase/ExampleMatcher.h"
 
 class VocShaper;
@@ -276,6 +277,12 @@ class EdgeCollectionInfo {
 
     WeightCalculatorFunction _weighter;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adjacency snapshot of the edge collection, if available
+////////////////////////////////////////////////////////////////////////////////
+
+    std::shared_ptr<triagens::arango::EdgeSnapshot> _snapshot;
+
   public:
 
     EdgeCollectionInfo (TRI_voc_cid_t& edgeCollectionCid,
@@ -284,6 +291,11 @@ class EdgeCollectionInfo {
       : _edgeCollectionCid(edgeCollectionCid),
         _edgeCollection(edgeCollection),
         _weighter(weighter) {
+
+      if (edgeCollection->_info._type == TRI_COL_TYPE_EDGE) {
+        // the collection is read-locked by the surrounding transaction
+        _snapshot = edgeCollection->edgeSnapshots()->get(edgeCollection);
+      }
     }
 
     EdgeId extractEdgeId (TRI_doc_mptr_copy_t& ptr) {
@@ -307,6 +319,53 @@ class EdgeCollectionInfo {
     double weightEdge (TRI_doc_mptr_copy_t& ptr) {
       return _weighter(ptr);
     }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback with each edge connected to the vertex in the
+/// given direction and the vertex at the other end of the edge. self-loops
+/// are skipped. uses the adjacency snapshot if there is one, and the edge
+/// index otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+    template<typename F>
+    void forEachNeighbor (TRI_edge_direction_e direction,
+                          VertexId const& vertexId,
+                          F const& callback) const {
+      if (_snapshot != nullptr) {
+        triagens::arango::EdgeSnapshot const* snapshot = _snapshot.get();
+        triagens::arango::EdgeSnapshot::VertexIndex index;
+
+        if (! snapshot->lookupVertex(vertexId.cid, vertexId.key, index)) {
+          // no edges connected to the vertex
+          return;
+        }
+
+        snapshot->forEachEdge(index, direction, [&] (triagens::arango::EdgeSnapshot::VertexIndex other,
+                                                     TRI_doc_mptr_t const* mptr) {
+          TRI_doc_mptr_copy_t edge(*mptr);
+          VertexId neighbor(snapshot->vertexCid(other), snapshot->vertexKey(other));
+          callback(edge, neighbor);
+        });
+        return;
+      }
+
+      auto edges = getEdges(direction, vertexId);
+
+      for (auto& edge : edges) {
+        VertexId from(TRI_EXTRACT_MARKER_FROM_CID(&edge), TRI_EXTRACT_MARKER_FROM_KEY(&edge));
+
+        if (! (from == vertexId)) {
+          callback(edge, from);
+          continue;
+        }
+
+        VertexId to(TRI_EXTRACT_MARKER_TO_CID(&edge), TRI_EXTRACT_MARKER_TO_KEY(&edge));
+
+        if (! (to == vertexId)) {
+          callback(edge, to);
+        }
+      }
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -363,7 +422,8 @@ std::unique_ptr<ArangoDBPathFinder::Path> TRI_RunShortestPathSearch (
 
 std::unique_ptr<ArangoDBConstDistancePathFinder::Path> TRI_RunSimpleShortestPathSearch (
     std::vector<EdgeCollectionInfo*>& collectionInfos,
-    triagens::basics::traverser::ShortestPathOptions& opts
+    triagens::basics::traverser::ShortestPathOptions& opts,
+    triagens::basics::ThreadPool* pool
 );
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1747,6 +1747,14 @@ static TRI_doc_collection_info_t* GetFigures (TRI_vocbase_col_t* collection) {
 /// * *uncollectedLogfileEntries*: The number of markers in the write-ahead
 ///   log for this collection that have not been transferred to journals or
 ///   datafiles.
+/// * *locks.readWaits*: The number of times a reader had to wait for the
+///   collection's documents and indexes lock since the collection was loaded.
+/// * *locks.writeWaits*: The number of times a writer had to wait for the
+///   collection's documents and indexes lock since the collection was loaded.
+/// * *locks.readWaitTime*: The total time in seconds readers waited for the
+///   collection's documents and indexes lock since the collection was loaded.
+/// * *locks.writeWaitTime*: The total time in seconds writers waited for the
+///   collection's documents and indexes lock since the collection was loaded.
 ///
 /// **Note**: collection data that are stored in the write-ahead log only are
 /// not reported in the results. When the write-ahead log is collected, documents
@@ -1863,6 +1871,14 @@ static void JS_FiguresVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& arg
   result->Set(TRI_V8_ASCII_STRING("lastTick"),   V8TickId(isolate, info->_tickMax));
   result->Set(TRI_V8_ASCII_STRING("uncollectedLogfileEntries"), v8::Number::New(isolate, (double) info->_uncollectedLogfileEntries));
 
+  // lock contention info
+  v8::Handle<v8::Object> locks = v8::Object::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("locks"),      locks);
+  locks->Set(TRI_V8_ASCII_STRING("readWaits"),   v8::Number::New(isolate, (double) info->_lockReadWaits));
+  locks->Set(TRI_V8_ASCII_STRING("writeWaits"),  v8::Number::New(isolate, (double) info->_lockWriteWaits));
+  locks->Set(TRI_V8_ASCII_STRING("readWaitTime"),  v8::Number::New(isolate, info->_lockReadWaitTime));
+  locks->Set(TRI_V8_ASCII_STRING("writeWaitTime"), v8::Number::New(isolate, info->_lockWriteWaitTime));
+
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, info);
 
   TRI_V8_RETURN(result);
@@ -1798,6 +1798,14 @@ static void FulltextQuery (SingleCollectionReadOnlyTransaction& trx,
   v8::Handle<v8::Array> documents = v8::Array::New(isolate);
   result->Set(TRI_V8_ASCII_STRING("documents"), documents);
 
+  // ranked results (i.e. queries with a limit) also carry the BM25 scores
+  v8::Handle<v8::Array> scores;
+
+  if (queryResult->_scores != nullptr) {
+    scores = v8::Array::New(isolate);
+    result->Set(TRI_V8_ASCII_STRING("scores"), scores);
+  }
+
   bool error = false;
 
   for (uint32_t i = 0; i < queryResult->_numDocuments; ++i) {
@@ -1809,6 +1817,10 @@ static void FulltextQuery (SingleCollectionReadOnlyTransaction& trx,
     }
 
     documents->Set(i, doc);
+
+    if (queryResult->_scores != nullptr) {
+      scores->Set(i, v8::Number::New(isolate, queryResult->_scores[i]));
+    }
   }
 
   TRI_FreeResultFulltextIndex(queryResult);
@@ -2162,6 +2174,227 @@ static void JS_WithinQuery (const v8::FunctionCallbackInfo<v8::Value>& args) {
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects points within a given rectangle
+///
+/// the caller must ensure all relevant locks are acquired and freed
+////////////////////////////////////////////////////////////////////////////////
+
+static void WithinRectangleQuery (SingleCollectionReadOnlyTransaction& trx,
+                                  TRI_vocbase_col_t const* collection,
+                                  const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  // expect: WITHIN_RECTANGLE(<index-handle>, <latitude1>, <longitude1>, <latitude2>, <longitude2>)
+  if (args.Length() != 5) {
+    TRI_V8_THROW_EXCEPTION_USAGE("WITHIN_RECTANGLE(<index-handle>, <latitude1>, <longitude1>, <latitude2>, <longitude2>)");
+  }
+
+  // extract the index
+  auto idx = TRI_LookupIndexByHandle(isolate, trx.resolver(), collection, args[0], false);
+
+  if (idx == nullptr ||
+      (idx->type() != triagens::arango::Index::TRI_IDX_TYPE_GEO1_INDEX &&
+       idx->type() != triagens::arango::Index::TRI_IDX_TYPE_GEO2_INDEX)) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_NO_INDEX);
+  }
+
+  // extract the corners
+  double latitude1 = TRI_ObjectToDouble(args[1]);
+  double longitude1 = TRI_ObjectToDouble(args[2]);
+  double latitude2 = TRI_ObjectToDouble(args[3]);
+  double longitude2 = TRI_ObjectToDouble(args[4]);
+
+  // setup result
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  v8::Handle<v8::Array> documents = v8::Array::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("documents"), documents);
+
+  // distances are meaningless here and are not returned
+  v8::Handle<v8::Array> distances = v8::Array::New(isolate);
+
+  GeoCoordinates* cors = static_cast<triagens::arango::GeoIndex2*>(idx)->withinRectangleQuery(latitude1, longitude1, latitude2, longitude2);
+
+  if (cors != nullptr) {
+    int res = StoreGeoResult(isolate, trx, collection, cors, documents, distances);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      TRI_V8_THROW_EXCEPTION(res);
+    }
+  }
+
+  TRI_V8_RETURN(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects points within a given rectangle
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_WithinRectangleQuery (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  TRI_vocbase_col_t const* col = TRI_UnwrapClass<TRI_vocbase_col_t>(args.Holder(), TRI_GetVocBaseColType());
+
+  if (col == nullptr) {
+    TRI_V8_THROW_EXCEPTION_INTERNAL("cannot extract collection");
+  }
+
+  TRI_THROW_SHARDING_COLLECTION_NOT_YET_IMPLEMENTED(col);
+
+  SingleCollectionReadOnlyTransaction trx(new V8TransactionContext(true), col->_vocbase, col->_cid);
+
+  int res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  // .............................................................................
+  // inside a read transaction
+  // .............................................................................
+
+  trx.lockRead();
+
+  WithinRectangleQuery(trx, col, args);
+
+  trx.finish(res);
+
+  // .............................................................................
+  // outside a read transaction
+  // .............................................................................
+  TRI_V8_TRY_CATCH_END
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects points within a given polygon
+///
+/// the caller must ensure all relevant locks are acquired and freed
+////////////////////////////////////////////////////////////////////////////////
+
+static void WithinPolygonQuery (SingleCollectionReadOnlyTransaction& trx,
+                                TRI_vocbase_col_t const* collection,
+                                const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  // expect: WITHIN_POLYGON(<index-handle>, <polygon>)
+  if (args.Length() != 2) {
+    TRI_V8_THROW_EXCEPTION_USAGE("WITHIN_POLYGON(<index-handle>, <polygon>)");
+  }
+
+  // extract the index
+  auto idx = TRI_LookupIndexByHandle(isolate, trx.resolver(), collection, args[0], false);
+
+  if (idx == nullptr ||
+      (idx->type() != triagens::arango::Index::TRI_IDX_TYPE_GEO1_INDEX &&
+       idx->type() != triagens::arango::Index::TRI_IDX_TYPE_GEO2_INDEX)) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_NO_INDEX);
+  }
+
+  // extract the vertices, each given as [ <latitude>, <longitude> ]
+  if (! args[1]->IsArray()) {
+    TRI_V8_THROW_TYPE_ERROR("<polygon> must be an array of [ <latitude>, <longitude> ] pairs");
+  }
+
+  v8::Handle<v8::Array> polygon = v8::Handle<v8::Array>::Cast(args[1]);
+  uint32_t const n = polygon->Length();
+
+  std::vector<GeoCoordinate> vertices;
+  vertices.reserve(n);
+
+  for (uint32_t i = 0; i < n; ++i) {
+    v8::Handle<v8::Value> vertex = polygon->Get(i);
+
+    if (! vertex->IsArray() || v8::Handle<v8::Array>::Cast(vertex)->Length() != 2) {
+      TRI_V8_THROW_TYPE_ERROR("<polygon> must be an array of [ <latitude>, <longitude> ] pairs");
+    }
+
+    v8::Handle<v8::Array> pair = v8::Handle<v8::Array>::Cast(vertex);
+
+    GeoCoordinate gc;
+    gc.latitude = TRI_ObjectToDouble(pair->Get(0));
+    gc.longitude = TRI_ObjectToDouble(pair->Get(1));
+    gc.data = nullptr;
+
+    vertices.emplace_back(gc);
+  }
+
+  // a closing vertex equal to the first one is optional
+  if (vertices.size() > 1 &&
+      vertices.front().latitude == vertices.back().latitude &&
+      vertices.front().longitude == vertices.back().longitude) {
+    vertices.pop_back();
+  }
+
+  if (vertices.size() < 3) {
+    TRI_V8_THROW_EXCEPTION_PARAMETER("<polygon> must have at least 3 vertices");
+  }
+
+  // setup result
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  v8::Handle<v8::Array> documents = v8::Array::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("documents"), documents);
+
+  // distances are meaningless here and are not returned
+  v8::Handle<v8::Array> distances = v8::Array::New(isolate);
+
+  GeoCoordinates* cors = static_cast<triagens::arango::GeoIndex2*>(idx)->withinPolygonQuery(vertices);
+
+  if (cors != nullptr) {
+    int res = StoreGeoResult(isolate, trx, collection, cors, documents, distances);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      TRI_V8_THROW_EXCEPTION(res);
+    }
+  }
+
+  TRI_V8_RETURN(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects points within a given polygon
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_WithinPolygonQuery (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  TRI_vocbase_col_t const* col = TRI_UnwrapClass<TRI_vocbase_col_t>(args.Holder(), TRI_GetVocBaseColType());
+
+  if (col == nullptr) {
+    TRI_V8_THROW_EXCEPTION_INTERNAL("cannot extract collection");
+  }
+
+  TRI_THROW_SHARDING_COLLECTION_NOT_YET_IMPLEMENTED(col);
+
+  SingleCollectionReadOnlyTransaction trx(new V8TransactionContext(true), col->_vocbase, col->_cid);
+
+  int res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  // .............................................................................
+  // inside a read transaction
+  // .............................................................................
+
+  trx.lockRead();
+
+  WithinPolygonQuery(trx, col, args);
+
+  trx.finish(res);
+
+  // .............................................................................
+  // outside a read transaction
+  // .............................................................................
+  TRI_V8_TRY_CATCH_END
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fetches multiple documents by their keys
 /// @startDocuBlock collectionLookupByKeys
@@ -2375,6 +2608,8 @@ void TRI_InitV8Queries (v8::Isolate* isolate,
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("NEAR"), JS_NearQuery, true);
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("OUTEDGES"), JS_OutEdgesQuery, true);
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("WITHIN"), JS_WithinQuery, true);
+  TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("WITHIN_POLYGON"), JS_WithinPolygonQuery, true);
+  TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("WITHIN_RECTANGLE"), JS_WithinRectangleQuery, true);
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("lookupByKeys"), JS_LookupByKeys, true); // an alias for .documents
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("documents"), JS_LookupByKeys, true);
   TRI_AddMethodVocbase(isolate, VocbaseColTempl, TRI_V8_ASCII_STRING("removeByKeys"), JS_RemoveByKeys, true);
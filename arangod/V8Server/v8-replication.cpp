@@ -267,6 +267,12 @@ static void JS_SynchronizeReplication (const v8::FunctionCallbackInfo<v8::Value>
     }
   }
  
+  if (object->Has(TRI_V8_ASCII_STRING("parallelism"))) {
+    if (object->Get(TRI_V8_ASCII_STRING("parallelism"))->IsNumber()) {
+      config._parallelism = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("parallelism")), true);
+    }
+  }
+ 
   if (object->Has(TRI_V8_ASCII_STRING("includeSystem"))) {
     if (object->Get(TRI_V8_ASCII_STRING("includeSystem"))->IsBoolean()) {
       config._includeSystem = TRI_ObjectToBoolean(object->Get(TRI_V8_ASCII_STRING("includeSystem")));
@@ -488,6 +494,12 @@ static void JS_ConfigureApplierReplication (const v8::FunctionCallbackInfo<v8::V
       }
     }
 
+    if (object->Has(TRI_V8_ASCII_STRING("parallelism"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("parallelism"))->IsNumber()) {
+        config._parallelism = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("parallelism")), true);
+      }
+    }
+
     if (object->Has(TRI_V8_ASCII_STRING("autoStart"))) {
       if (object->Get(TRI_V8_ASCII_STRING("autoStart"))->IsBoolean()) {
         config._autoStart = TRI_ObjectToBoolean(object->Get(TRI_V8_ASCII_STRING("autoStart")));
@@ -500,6 +512,12 @@ static void JS_ConfigureApplierReplication (const v8::FunctionCallbackInfo<v8::V
       }
     }
     
+    if (object->Has(TRI_V8_ASCII_STRING("binaryFormat"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("binaryFormat"))->IsBoolean()) {
+        config._binaryFormat = TRI_ObjectToBoolean(object->Get(TRI_V8_ASCII_STRING("binaryFormat")));
+      }
+    }
+    
     if (object->Has(TRI_V8_ASCII_STRING("includeSystem"))) {
       if (object->Get(TRI_V8_ASCII_STRING("includeSystem"))->IsBoolean()) {
         config._includeSystem = TRI_ObjectToBoolean(object->Get(TRI_V8_ASCII_STRING("includeSystem")));
@@ -28,18 +28,35 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "v8-statistics.h"
+#include "Basics/logging.h"
 #include "Basics/process-utils.h"
 #include "Basics/StringUtils.h"
+#include "Dispatcher/Dispatcher.h"
 #include "Statistics/statistics.h"
 #include "V8/v8-conv.h"
 #include "V8/v8-globals.h"
 #include "V8/v8-utils.h"
+#include "V8Server/ApplicationV8.h"
 
 using namespace std;
 using namespace triagens::arango;
 using namespace triagens::basics;
 using namespace triagens::rest;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief percentiles returned for latency histograms by default
+////////////////////////////////////////////////////////////////////////////////
+
+static double const DefaultPercentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a distribution vector
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +99,32 @@ static void FillDistribution (v8::Isolate* isolate,
   list->Set(name, result);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the figures and percentiles of a latency histogram, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static void FillLatency (v8::Isolate* isolate,
+                         v8::Handle<v8::Object> list,
+                         v8::Handle<v8::String> name,
+                         LatencyHistogram const* histogram,
+                         vector<pair<v8::Handle<v8::String>, double>> const& percentiles) {
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  result->Set(TRI_V8_ASCII_STRING("count"), v8::Number::New(isolate, (double) histogram->count()));
+  result->Set(TRI_V8_ASCII_STRING("sum"),   v8::Number::New(isolate, histogram->sum() / 1000000.0));
+  result->Set(TRI_V8_ASCII_STRING("max"),   v8::Number::New(isolate, histogram->max() / 1000000.0));
+
+  v8::Handle<v8::Object> values = v8::Object::New(isolate);
+
+  for (auto const& it : percentiles) {
+    values->Set(it.first, v8::Number::New(isolate, histogram->valueAtPercentile(it.second) / 1000000.0));
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("percentiles"), values);
+
+  list->Set(name, result);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      JS functions
 // -----------------------------------------------------------------------------
@@ -94,6 +137,13 @@ static void FillDistribution (v8::Isolate* isolate,
 /// Returns information about the server:
 ///
 /// - `uptime`: time since server start in seconds.
+/// - `physicalMemory`: physical memory of the machine in bytes.
+/// - `droppedLogMessages`: number of log messages dropped because the log
+///   buffer of their thread was full.
+/// - `v8ContextWaitTime`: distribution of the time threads waited for a V8
+///   context in seconds.
+/// - `v8Contexts`: heap usage and garbage collection pauses of each V8
+///   context.
 ////////////////////////////////////////////////////////////////////////////////
 
 static void JS_ServerStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -106,6 +156,188 @@ static void JS_ServerStatistics (const v8::FunctionCallbackInfo<v8::Value>& args
 
   result->Set(TRI_V8_ASCII_STRING("uptime"),         v8::Number::New(isolate, (double) info._uptime));
   result->Set(TRI_V8_ASCII_STRING("physicalMemory"), v8::Number::New(isolate, (double) TRI_PhysicalMemory));
+  result->Set(TRI_V8_ASCII_STRING("droppedLogMessages"), v8::Number::New(isolate, (double) TRI_DroppedMessagesLogging()));
+
+  StatisticsDistribution v8ContextWaitTime(TRI_V8ContextWaitTimeDistributionVectorStatistics);
+
+  TRI_FillV8ContextStatistics(v8ContextWaitTime);
+
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("v8ContextWaitTime"), v8ContextWaitTime);
+
+  TRI_GET_GLOBALS();
+  auto applicationV8 = static_cast<ApplicationV8*>(v8g->_applicationV8);
+
+  if (applicationV8 != nullptr) {
+    auto const contexts = applicationV8->contextStatistics();
+    v8::Handle<v8::Array> list = v8::Array::New(isolate, (int) contexts.size());
+    uint32_t pos = 0;
+
+    for (auto const& it : contexts) {
+      v8::Handle<v8::Object> context = v8::Object::New(isolate);
+
+      context->Set(TRI_V8_ASCII_STRING("id"),          v8::Number::New(isolate, (double) it._id));
+      context->Set(TRI_V8_ASCII_STRING("heapUsed"),    v8::Number::New(isolate, (double) it._heapUsed));
+      context->Set(TRI_V8_ASCII_STRING("heapLimit"),   v8::Number::New(isolate, (double) it._heapLimit));
+      context->Set(TRI_V8_ASCII_STRING("gcPauses"),    v8::Number::New(isolate, (double) it._gcPauses));
+      context->Set(TRI_V8_ASCII_STRING("gcPauseTime"), v8::Number::New(isolate, it._gcPauseTime));
+      context->Set(TRI_V8_ASCII_STRING("gcPauseMax"),  v8::Number::New(isolate, it._gcPauseMax));
+
+      list->Set(pos++, context);
+    }
+
+    result->Set(TRI_V8_ASCII_STRING("v8Contexts"), list);
+  }
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the wait statistics
+///
+/// @FUN{internal.waitStatistics()}
+///
+/// Returns the distributions of the time threads waited, in seconds:
+///
+/// - `waits`: one distribution per wait point (`walSlot`, `walSync`,
+///   `datafileSync`, `v8Context` and `dispatcherQueue`).
+/// - `handlers`: the time jobs waited in a dispatcher queue, by the prefix
+///   of the handler that ran them.
+/// - `lanes`: latency histograms of the time jobs waited in the `short` and
+///   the `long` lane of the dispatcher queues, with the `count`, `sum` and
+///   `max` of the times and the `percentiles` 50, 90, 99 and 99.9.
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_WaitStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate)
+  v8::HandleScope scope(isolate);
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  vector<StatisticsDistribution> waits;
+  TRI_FillWaitStatistics(waits);
+
+  v8::Handle<v8::Object> points = v8::Object::New(isolate);
+
+  for (size_t i = 0; i < waits.size(); ++i) {
+    char const* name = TRI_NameWaitPoint(static_cast<TRI_wait_point_e>(i));
+    FillDistribution(isolate, points, TRI_V8_ASCII_STRING(name), waits[i]);
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("waits"), points);
+
+  map<string, StatisticsDistribution> handlers;
+  TRI_FillHandlerWaitStatistics(handlers);
+
+  v8::Handle<v8::Object> byHandler = v8::Object::New(isolate);
+
+  for (auto const& it : handlers) {
+    FillDistribution(isolate, byHandler, TRI_V8_STD_STRING(it.first), it.second);
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("handlers"), byHandler);
+
+  vector<pair<v8::Handle<v8::String>, double>> percentiles;
+
+  for (auto const& it : DefaultPercentiles) {
+    percentiles.emplace_back(v8::Number::New(isolate, it)->ToString(), it);
+  }
+
+  v8::Handle<v8::Object> lanes = v8::Object::New(isolate);
+
+  for (size_t i = 0; i < Dispatcher::LANE_SIZE; ++i) {
+    FillLatency(isolate, lanes, TRI_V8_ASCII_STRING(TRI_NameDispatcherLane(i)), TRI_DispatcherLaneWaitHistogram(i), percentiles);
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("lanes"), lanes);
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the request latencies by endpoint and method
+///
+/// @FUN{internal.requestLatencyStatistics(@FA{percentiles})}
+///
+/// Returns an object with an attribute for each endpoint, which is the prefix
+/// of the handler that served the requests. For actions, the first part of
+/// the path is added to the prefix. Each endpoint has an attribute for each
+/// HTTP method, which contains the histograms `totalTime`, `requestTime`,
+/// `queueTime` and `ioTime`. For each histogram the number of requests
+/// `count`, the sum `sum` and the maximum `max` of the times are returned,
+/// and `percentiles` contains the time below or at which the given
+/// percentages of the requests lie. The precision of a percentile is about
+/// 1.6 %. All times are in seconds.
+///
+/// @FA{percentiles} is an array of numbers between 0 and 100. It defaults to
+/// `[ 50, 90, 99, 99.9 ]`.
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_RequestLatencyStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate)
+  v8::HandleScope scope(isolate);
+
+  if (args.Length() > 1) {
+    TRI_V8_THROW_EXCEPTION_USAGE("requestLatencyStatistics(<percentiles>)");
+  }
+
+  v8::Handle<v8::Array> list;
+
+  if (args.Length() > 0 && ! args[0]->IsUndefined() && ! args[0]->IsNull()) {
+    if (! args[0]->IsArray()) {
+      TRI_V8_THROW_EXCEPTION_PARAMETER("<percentiles> must be an array");
+    }
+
+    list = v8::Handle<v8::Array>::Cast(args[0]);
+  }
+  else {
+    list = v8::Array::New(isolate);
+
+    for (uint32_t i = 0; i < sizeof(DefaultPercentiles) / sizeof(DefaultPercentiles[0]); ++i) {
+      list->Set(i, v8::Number::New(isolate, DefaultPercentiles[i]));
+    }
+  }
+
+  vector<pair<v8::Handle<v8::String>, double>> percentiles;
+
+  for (uint32_t i = 0; i < list->Length(); ++i) {
+    v8::Handle<v8::Value> value = list->Get(i);
+    double percentile = TRI_ObjectToDouble(value);
+
+    if (! value->IsNumber() || percentile < 0.0 || percentile > 100.0) {
+      TRI_V8_THROW_EXCEPTION_PARAMETER("<percentiles> must contain numbers between 0 and 100");
+    }
+
+    percentiles.emplace_back(value->ToString(), percentile);
+  }
+
+  vector<TRI_request_latency_t> latencies;
+  TRI_FillRequestLatencyStatistics(latencies);
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  for (auto const& it : latencies) {
+    v8::Handle<v8::String> name = TRI_V8_STD_STRING(it._endpoint);
+    v8::Handle<v8::Object> endpoint;
+
+    if (result->Has(name)) {
+      endpoint = result->Get(name)->ToObject();
+    }
+    else {
+      endpoint = v8::Object::New(isolate);
+      result->Set(name, endpoint);
+    }
+
+    v8::Handle<v8::Object> method = v8::Object::New(isolate);
+
+    FillLatency(isolate, method, TRI_V8_ASCII_STRING("totalTime"),   it._totalTime,   percentiles);
+    FillLatency(isolate, method, TRI_V8_ASCII_STRING("requestTime"), it._requestTime, percentiles);
+    FillLatency(isolate, method, TRI_V8_ASCII_STRING("queueTime"),   it._queueTime,   percentiles);
+    FillLatency(isolate, method, TRI_V8_ASCII_STRING("ioTime"),      it._ioTime,      percentiles);
+
+    endpoint->Set(TRI_V8_STD_STRING(HttpRequest::translateMethod(it._requestType)), method);
+  }
 
   TRI_V8_RETURN(result);
   TRI_V8_TRY_CATCH_END
@@ -205,11 +437,15 @@ void TRI_InitV8Statistics (v8::Isolate* isolate,
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_CLIENT_STATISTICS"), JS_ClientStatistics);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_HTTP_STATISTICS"), JS_HttpStatistics);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_SERVER_STATISTICS"), JS_ServerStatistics);
+  TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_WAIT_STATISTICS"), JS_WaitStatistics);
+  TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_REQUEST_LATENCY_STATISTICS"), JS_RequestLatencyStatistics);
 
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("CONNECTION_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_ConnectionTimeDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("REQUEST_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_RequestTimeDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("BYTES_SENT_DISTRIBUTION"), DistributionList(isolate, TRI_BytesSentDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("BYTES_RECEIVED_DISTRIBUTION"), DistributionList(isolate, TRI_BytesReceivedDistributionVectorStatistics));
+  TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("V8_CONTEXT_WAIT_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_V8ContextWaitTimeDistributionVectorStatistics));
+  TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("WAIT_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_WaitTimeDistributionVectorStatistics));
 }
 
 // -----------------------------------------------------------------------------
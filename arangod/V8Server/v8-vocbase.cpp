@@ -2114,23 +2114,24 @@ class AttributeWeightCalculator {
 
       TRI_shape_sid_t sid;
       TRI_EXTRACT_SHAPE_IDENTIFIER_MARKER(sid, edge.getDataPtr());
+      // the shaper caches the compiled accessor per shape
       TRI_shape_access_t const* accessor = _shaper->findAccessor(sid, _shapePid);
-      TRI_shaped_json_t shapedJson;
-      TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, edge.getDataPtr());
-      TRI_shaped_json_t resultJson;
-      TRI_ExecuteShapeAccessor(accessor, &shapedJson, &resultJson);
 
-      if (resultJson._sid != TRI_SHAPE_NUMBER) {
+      if (accessor == nullptr) {
         return _defaultWeight;
       }
 
-      std::unique_ptr<TRI_json_t> json(TRI_JsonShapedJson(_shaper, &resultJson));
+      TRI_shaped_json_t shapedJson;
+      TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, edge.getDataPtr());
+      TRI_shaped_json_t resultJson;
 
-      if (json == nullptr) {
+      if (! TRI_ExecuteShapeAccessor(accessor, &shapedJson, &resultJson) ||
+          resultJson._sid != TRI_SHAPE_NUMBER) {
         return _defaultWeight;
       }
 
-      return json.get()->_value._number;
+      // read the number directly from the shaped value
+      return *reinterpret_cast<TRI_shape_number_t const*>(resultJson._data.data);
     }
 };
 
@@ -2383,7 +2384,7 @@ static void JS_QueryShortestPath (const v8::FunctionCallbackInfo<v8::Value>& arg
     TRI_V8_THROW_EXCEPTION(e.code());
   }
   
-  if (opts.useVertexFilter || opts.useEdgeFilter || opts.useWeight) {
+  if (opts.useWeight) {
     // Compute the path
     unique_ptr<ArangoDBPathFinder::Path> path;
 
@@ -2422,14 +2423,15 @@ static void JS_QueryShortestPath (const v8::FunctionCallbackInfo<v8::Value>& arg
     }
   } 
   else {
-    // No Data reading required for this path. Use shortcuts.
+    // All edges have the same weight. Use a breadth-first search.
     // Compute the path
     unique_ptr<ArangoDBConstDistancePathFinder::Path> path;
 
     try {
       path = TRI_RunSimpleShortestPathSearch(
         edgeCollectionInfos,
-        opts
+        opts,
+        vocbase->_server->_graphPool
       );
     } 
     catch (Exception& e) {
@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compaction scheduler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "CompactionScheduler.h"
+#include "Basics/ConditionLocker.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/ThreadPool.h"
+#include "Basics/logging.h"
+
+#include <algorithm>
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the longest time a throttled compaction sleeps without checking
+/// whether it should stop, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static double const ThrottleSlice = 0.1;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class CompactionScheduler
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+CompactionScheduler::CompactionScheduler (size_t numThreads,
+                                          uint64_t bytesPerSecond)
+  : _pool(nullptr),
+    _condition(),
+    _queue(),
+    _sequence(0),
+    _bucketLock(),
+    _bytesPerSecond(bytesPerSecond),
+    _tokens(static_cast<double>(bytesPerSecond)),
+    _lastRefill(TRI_microtime()) {
+
+  if (numThreads > 0) {
+    _pool = new triagens::basics::ThreadPool(numThreads, "Compactor");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+CompactionScheduler::~CompactionScheduler () {
+  delete _pool;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the tasks and waits until all of them have finished
+////////////////////////////////////////////////////////////////////////////////
+
+size_t CompactionScheduler::execute (std::vector<Task>& tasks) {
+  if (tasks.empty()) {
+    return 0;
+  }
+
+  if (_pool == nullptr) {
+    // no worker threads
+    return executeSerially(tasks);
+  }
+
+  Batch batch;
+  batch.pending = tasks.size();
+  batch.worked  = 0;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    for (auto& it : tasks) {
+      Job job;
+      job.priority = it.priority;
+      job.sequence = ++_sequence;
+      job.func     = it.func;
+      job.batch    = &batch;
+
+      _queue.push(job);
+    }
+  }
+
+  // each pool task executes whatever job has the highest priority at the time
+  // it is run, which is not necessarily one of ours
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    _pool->enqueue([this] () -> void {
+      runNext();
+    });
+  }
+
+  CONDITION_LOCKER(guard, _condition);
+
+  while (batch.pending > 0) {
+    guard.wait();
+  }
+
+  return batch.worked;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the tasks in the calling thread, in order of priority
+////////////////////////////////////////////////////////////////////////////////
+
+size_t CompactionScheduler::executeSerially (std::vector<Task>& tasks) {
+  std::stable_sort(tasks.begin(), tasks.end(), [] (Task const& lhs, Task const& rhs) {
+    return lhs.priority > rhs.priority;
+  });
+
+  size_t worked = 0;
+
+  for (auto& it : tasks) {
+    if (it.func()) {
+      ++worked;
+    }
+  }
+
+  return worked;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief account for data written by a compaction
+////////////////////////////////////////////////////////////////////////////////
+
+double CompactionScheduler::consume (uint64_t bytes) {
+  if (_bytesPerSecond == 0 || bytes == 0) {
+    return 0.0;
+  }
+
+  double const rate = static_cast<double>(_bytesPerSecond);
+
+  MUTEX_LOCKER(_bucketLock);
+
+  double const now = TRI_microtime();
+  _tokens += (now - _lastRefill) * rate;
+  _lastRefill = now;
+
+  if (_tokens > rate) {
+    // allow bursts of at most one second
+    _tokens = rate;
+  }
+
+  _tokens -= static_cast<double>(bytes);
+
+  if (_tokens >= 0.0) {
+    return 0.0;
+  }
+
+  return - _tokens / rate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief account for data written by a compaction and wait if necessary
+////////////////////////////////////////////////////////////////////////////////
+
+void CompactionScheduler::throttle (uint64_t bytes,
+                                    std::function<bool()> const& stop) {
+  double const seconds = consume(bytes);
+
+  if (seconds <= 0.0) {
+    return;
+  }
+
+  LOG_TRACE("throttling compaction for %f s", seconds);
+
+  if (! wait(seconds, stop)) {
+    LOG_TRACE("throttled compaction was stopped");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits in short slices until the time is over or we should stop
+////////////////////////////////////////////////////////////////////////////////
+
+bool CompactionScheduler::wait (double seconds,
+                                std::function<bool()> const& stop) {
+  double const end = TRI_microtime() + seconds;
+
+  while (true) {
+    if (stop()) {
+      return false;
+    }
+
+    double const left = end - TRI_microtime();
+
+    if (left <= 0.0) {
+      return true;
+    }
+
+    usleep((unsigned long) ((std::min)(left, ThrottleSlice) * 1000.0 * 1000.0));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the queued job with the highest priority
+////////////////////////////////////////////////////////////////////////////////
+
+void CompactionScheduler::runNext () {
+  Job job;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    if (_queue.empty()) {
+      return;
+    }
+
+    job = _queue.top();
+    _queue.pop();
+  }
+
+  bool worked = false;
+
+  try {
+    worked = job.func();
+  }
+  catch (...) {
+    LOG_WARNING("caught exception during compaction");
+  }
+
+  CONDITION_LOCKER(guard, _condition);
+
+  if (worked) {
+    ++job.batch->worked;
+  }
+
+  --job.batch->pending;
+  guard.broadcast();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compaction scheduler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_COMPACTION_SCHEDULER_H
+#define ARANGODB_VOC_BASE_COMPACTION_SCHEDULER_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Mutex.h"
+
+#include <functional>
+#include <queue>
+
+namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class CompactionScheduler
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief server-wide scheduler for collection compaction
+///
+/// the compactor thread of each database hands its compaction candidates to
+/// the scheduler, which runs them on a shared pool of worker threads. pending
+/// compactions are executed in the order of their priority (the share of dead
+/// data in the collection), regardless of the database they belong to. the
+/// scheduler also limits the rate at which compaction writes data
+////////////////////////////////////////////////////////////////////////////////
+
+    class CompactionScheduler {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a compaction task. the function returns whether it compacted data
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Task {
+          Task (double priority,
+                std::function<bool()> const& func)
+            : priority(priority),
+              func(func) {
+          }
+
+          double                 priority;
+          std::function<bool()>  func;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        CompactionScheduler (CompactionScheduler const&) = delete;
+        CompactionScheduler& operator= (CompactionScheduler const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the scheduler
+/// if the number of threads is 0, compactions are executed by the calling
+/// thread. a bandwidth of 0 turns off rate limiting
+////////////////////////////////////////////////////////////////////////////////
+
+        CompactionScheduler (size_t,
+                             uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+        ~CompactionScheduler ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the tasks and waits until all of them have finished
+/// returns the number of tasks that compacted data
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t execute (std::vector<Task>&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the tasks in the calling thread, in order of priority
+/// returns the number of tasks that compacted data
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t executeSerially (std::vector<Task>&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief account for data written by a compaction
+/// returns the time in seconds the caller has to wait before it may write
+/// more data. this does not block
+////////////////////////////////////////////////////////////////////////////////
+
+        double consume (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief account for data written by a compaction and wait if the configured
+/// bandwidth has been exhausted
+///
+/// the wait is split into short slices, and the function returns early as
+/// soon as the stop predicate returns true. the caller must not hold the
+/// documents or datafiles locks of a collection, as writers wait for them
+////////////////////////////////////////////////////////////////////////////////
+
+        void throttle (uint64_t,
+                       std::function<bool()> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the given number of seconds in short slices, or until the
+/// stop predicate returns true
+/// returns false if the wait was stopped early
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool wait (double,
+                          std::function<bool()> const&);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a group of tasks submitted by one call to execute
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Batch {
+          size_t pending;
+          size_t worked;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a queued task
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Job {
+          double                 priority;
+          uint64_t               sequence;
+          std::function<bool()>  func;
+          Batch*                 batch;
+
+          bool operator< (Job const& other) const {
+            if (priority != other.priority) {
+              return priority < other.priority;
+            }
+            // equal priorities are executed in submission order
+            return sequence > other.sequence;
+          }
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the queued job with the highest priority
+////////////////////////////////////////////////////////////////////////////////
+
+        void runNext ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief worker threads, nullptr if compactions are run by the caller
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _pool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief condition protecting the queue and the batches
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ConditionVariable _condition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queued jobs, highest priority first
+////////////////////////////////////////////////////////////////////////////////
+
+        std::priority_queue<Job> _queue;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief submission counter
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _sequence;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for the token bucket
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex _bucketLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of bytes written per second, 0 means unlimited
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t const _bytesPerSecond;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief currently available bytes. can become negative, in which case
+/// writers must wait until the bucket has been refilled
+////////////////////////////////////////////////////////////////////////////////
+
+        double _tokens;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time of the last refill
+////////////////////////////////////////////////////////////////////////////////
+
+        double _lastRefill;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
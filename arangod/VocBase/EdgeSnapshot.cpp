@@ -0,0 +1,307 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adjacency snapshot of an edge collection
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "EdgeSnapshot.h"
+#include "Basics/Exceptions.h"
+#include "Basics/hashes.h"
+#include "Basics/MutexLocker.h"
+#include "Indexes/PrimaryIndex.h"
+#include "VocBase/document-collection.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class EdgeSnapshot
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a snapshot from all edges in the collection
+////////////////////////////////////////////////////////////////////////////////
+
+EdgeSnapshot::EdgeSnapshot (TRI_document_collection_t* document,
+                            TRI_voc_rid_t revision) 
+  : _revision(revision) {
+
+  build(document);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+EdgeSnapshot::~EdgeSnapshot () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the approximate memory usage of the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EdgeSnapshot::memoryUsage () const {
+  return _lookup.size() * (sizeof(VertexKey) + sizeof(VertexIndex) + 2 * sizeof(void*)) +
+         _vertexCids.capacity() * sizeof(TRI_voc_cid_t) +
+         _keyOffsets.capacity() * sizeof(uint32_t) +
+         _keys.capacity() +
+         (_outOffsets.capacity() + _inOffsets.capacity()) * sizeof(uint32_t) +
+         (_outVertices.capacity() + _inVertices.capacity()) * sizeof(VertexIndex) +
+         (_outEdges.capacity() + _inEdges.capacity()) * sizeof(TRI_doc_mptr_t const*);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the number of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+bool EdgeSnapshot::lookupVertex (TRI_voc_cid_t cid,
+                                 char const* key,
+                                 VertexIndex& result) const {
+  auto it = _lookup.find(VertexKey{ cid, key });
+
+  if (it == _lookup.end()) {
+    return false;
+  }
+
+  result = (*it).second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash a vertex lookup key
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EdgeSnapshot::VertexKeyHash::operator() (VertexKey const& value) const {
+  size_t h1 = std::hash<TRI_voc_cid_t>()(value.cid);
+  size_t h2 = TRI_FnvHashString(value.key);
+  return h1 ^ (h2 << 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compare two vertex lookup keys
+////////////////////////////////////////////////////////////////////////////////
+
+bool EdgeSnapshot::VertexKeyEqual::operator() (VertexKey const& lhs,
+                                               VertexKey const& rhs) const {
+  return lhs.cid == rhs.cid && strcmp(lhs.key, rhs.key) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the snapshot from the collection
+///
+/// the edges are numbered in a first pass over the primary index, using a
+/// temporary lookup table that points into the edge markers. the adjacency
+/// arrays are then filled by a counting sort over the collected edges. the
+/// final lookup table points to the snapshot's own copies of the keys, so it
+/// remains valid when the markers are moved by the collector or compactor
+////////////////////////////////////////////////////////////////////////////////
+
+void EdgeSnapshot::build (TRI_document_collection_t* document) {
+  struct PendingEdge {
+    VertexIndex           from;
+    VertexIndex           to;
+    TRI_doc_mptr_t const* edge;
+  };
+
+  auto primaryIndex = document->primaryIndex();
+
+  std::vector<PendingEdge> pending;
+  pending.reserve(primaryIndex->size());
+
+  std::unordered_map<VertexKey, VertexIndex, VertexKeyHash, VertexKeyEqual> numbers;
+
+  auto vertexNumber = [&] (TRI_voc_cid_t cid, char const* key) -> VertexIndex {
+    auto it = numbers.find(VertexKey{ cid, key });
+
+    if (it != numbers.end()) {
+      return (*it).second;
+    }
+
+    size_t const length = strlen(key) + 1;
+
+    if (_vertexCids.size() >= static_cast<size_t>(UINT32_MAX) ||
+        _keys.size() + length >= static_cast<size_t>(UINT32_MAX)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_OUT_OF_MEMORY, "too many vertices for edge snapshot");
+    }
+
+    VertexIndex const next = static_cast<VertexIndex>(_vertexCids.size());
+    _vertexCids.emplace_back(cid);
+    _keyOffsets.emplace_back(static_cast<uint32_t>(_keys.size()));
+    _keys.insert(_keys.end(), key, key + length);
+    numbers.emplace(VertexKey{ cid, key }, next);
+
+    return next;
+  };
+
+  primaryIndex->invokeOnAllElements([&] (TRI_doc_mptr_t* mptr) -> void {
+    TRI_df_marker_t const* marker = static_cast<TRI_df_marker_t const*>(mptr->getDataPtr());
+
+    if (marker->_type != TRI_DOC_MARKER_KEY_EDGE &&
+        marker->_type != TRI_WAL_MARKER_EDGE) {
+      return;
+    }
+
+    VertexIndex from = vertexNumber(TRI_EXTRACT_MARKER_FROM_CID(marker), TRI_EXTRACT_MARKER_FROM_KEY(marker));
+    VertexIndex to   = vertexNumber(TRI_EXTRACT_MARKER_TO_CID(marker), TRI_EXTRACT_MARKER_TO_KEY(marker));
+
+    if (from == to) {
+      // self-loops never lead to another vertex
+      return;
+    }
+
+    pending.emplace_back(PendingEdge{ from, to, mptr });
+  });
+
+  if (pending.size() >= static_cast<size_t>(UINT32_MAX)) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_OUT_OF_MEMORY, "too many edges for edge snapshot");
+  }
+
+  numbers.clear();
+
+  // the lookup table must point to our own copies of the keys
+  size_t const n = _vertexCids.size();
+  _lookup.reserve(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    _lookup.emplace(VertexKey{ _vertexCids[i], _keys.data() + _keyOffsets[i] }, static_cast<VertexIndex>(i));
+  }
+
+  // counting sort of the edges into both adjacency arrays
+  _outOffsets.assign(n + 1, 0);
+  _inOffsets.assign(n + 1, 0);
+
+  for (auto const& it : pending) {
+    ++_outOffsets[it.from + 1];
+    ++_inOffsets[it.to + 1];
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    _outOffsets[i + 1] += _outOffsets[i];
+    _inOffsets[i + 1] += _inOffsets[i];
+  }
+
+  _outVertices.resize(pending.size());
+  _outEdges.resize(pending.size());
+  _inVertices.resize(pending.size());
+  _inEdges.resize(pending.size());
+
+  std::vector<uint32_t> outPosition(_outOffsets.begin(), _outOffsets.end() - 1);
+  std::vector<uint32_t> inPosition(_inOffsets.begin(), _inOffsets.end() - 1);
+
+  for (auto const& it : pending) {
+    uint32_t const out = outPosition[it.from]++;
+    _outVertices[out] = it.to;
+    _outEdges[out] = it.edge;
+
+    uint32_t const in = inPosition[it.to]++;
+    _inVertices[in] = it.from;
+    _inEdges[in] = it.edge;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class EdgeSnapshotCache
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty cache
+////////////////////////////////////////////////////////////////////////////////
+
+EdgeSnapshotCache::EdgeSnapshotCache () 
+  : _lock(),
+    _snapshot(),
+    _requestedRevision(0),
+    _requested(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the cache
+////////////////////////////////////////////////////////////////////////////////
+
+EdgeSnapshotCache::~EdgeSnapshotCache () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a snapshot for the current revision of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<EdgeSnapshot> EdgeSnapshotCache::get (TRI_document_collection_t* document,
+                                                      bool readsAll) {
+  // all write operations update the revision while holding the write lock,
+  // so it cannot change while our caller holds the read lock
+  TRI_voc_rid_t const revision = document->_info._revision;
+
+  MUTEX_LOCKER(_lock);
+
+  if (_snapshot != nullptr) {
+    if (_snapshot->revision() == revision) {
+      return _snapshot;
+    }
+
+    // collection was modified since the snapshot was built
+    _snapshot.reset();
+  }
+
+  if (! readsAll && 
+      (! _requested || _requestedRevision != revision)) {
+    // first request for this revision. it is cheaper to use the edge index
+    // unless the collection is queried repeatedly without modifications
+    _requested = true;
+    _requestedRevision = revision;
+    return nullptr;
+  }
+
+  _snapshot.reset(new EdgeSnapshot(document, revision));
+
+  return _snapshot;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,353 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adjacency snapshot of an edge collection
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_EDGE_SNAPSHOT_H
+#define ARANGODB_VOC_BASE_EDGE_SNAPSHOT_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+#include "VocBase/edge-collection.h"
+#include "VocBase/voc-types.h"
+
+struct TRI_doc_mptr_t;
+struct TRI_document_collection_t;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class EdgeSnapshot
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace arango {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compact adjacency snapshot of a single edge collection
+///
+/// all vertices referenced by the edges of the collection are numbered
+/// densely, and the edges are stored in compressed sparse row (CSR) format,
+/// once for the outbound and once for the inbound direction. for each
+/// adjacency entry, the snapshot stores the number of the connected vertex
+/// and the master pointer of the edge document.
+///
+/// a snapshot is only valid for the collection revision it was built for.
+/// the master pointers stored in it may only be dereferenced while the
+/// collection is read-locked and its revision is still the same. the vertex
+/// keys are owned by the snapshot itself
+////////////////////////////////////////////////////////////////////////////////
+
+    class EdgeSnapshot {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dense vertex number
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef uint32_t VertexIndex;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        EdgeSnapshot (EdgeSnapshot const&) = delete;
+        EdgeSnapshot& operator= (EdgeSnapshot const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a snapshot from all edges in the collection. the collection
+/// must be read-locked by the caller
+////////////////////////////////////////////////////////////////////////////////
+
+        EdgeSnapshot (TRI_document_collection_t*,
+                      TRI_voc_rid_t);
+
+        ~EdgeSnapshot ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the collection revision the snapshot was built for
+////////////////////////////////////////////////////////////////////////////////
+
+        inline TRI_voc_rid_t revision () const {
+          return _revision;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of vertices
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t numberOfVertices () const {
+          return _vertexCids.size();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of edges
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t numberOfEdges () const {
+          return _outEdges.size();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the approximate memory usage of the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memoryUsage () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the number of a vertex. returns false if no edge of the
+/// collection is connected to the vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        bool lookupVertex (TRI_voc_cid_t,
+                           char const*,
+                           VertexIndex&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the collection id of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        inline TRI_voc_cid_t vertexCid (VertexIndex vertex) const {
+          return _vertexCids[vertex];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the key of a vertex. the key is owned by the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        inline char const* vertexKey (VertexIndex vertex) const {
+          return _keys.data() + _keyOffsets[vertex];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief call the callback for all edges of a vertex in the given
+/// direction, with the number of the vertex at the other end of the edge and
+/// the edge's master pointer. for TRI_EDGE_ANY, both the outbound and the
+/// inbound edges are visited. self-loops are not contained in the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        inline void forEachEdge (VertexIndex vertex,
+                                 TRI_edge_direction_e direction,
+                                 F const& callback) const {
+          if (direction != TRI_EDGE_IN) {
+            for (uint32_t i = _outOffsets[vertex]; i < _outOffsets[vertex + 1]; ++i) {
+              callback(_outVertices[i], _outEdges[i]);
+            }
+          }
+          if (direction != TRI_EDGE_OUT) {
+            for (uint32_t i = _inOffsets[vertex]; i < _inOffsets[vertex + 1]; ++i) {
+              callback(_inVertices[i], _inEdges[i]);
+            }
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief vertex lookup key, pointing to the snapshot-owned key string
+////////////////////////////////////////////////////////////////////////////////
+
+        struct VertexKey {
+          TRI_voc_cid_t cid;
+          char const*   key;
+        };
+
+        struct VertexKeyHash {
+          size_t operator() (VertexKey const&) const;
+        };
+
+        struct VertexKeyEqual {
+          bool operator() (VertexKey const&, VertexKey const&) const;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the snapshot from the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void build (TRI_document_collection_t*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the collection revision the snapshot was built for
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_rid_t const _revision;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief vertex numbers, per collection id and key
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<VertexKey, VertexIndex, VertexKeyHash, VertexKeyEqual> _lookup;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection ids of the vertices, indexed by vertex number
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_voc_cid_t> _vertexCids;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief offsets of the vertex keys in _keys, indexed by vertex number
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint32_t> _keyOffsets;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief all vertex keys, each terminated with a null byte
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<char> _keys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief outbound adjacency: CSR offsets, connected vertices and edges
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint32_t> _outOffsets;
+
+        std::vector<VertexIndex> _outVertices;
+
+        std::vector<TRI_doc_mptr_t const*> _outEdges;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inbound adjacency: CSR offsets, connected vertices and edges
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint32_t> _inOffsets;
+
+        std::vector<VertexIndex> _inVertices;
+
+        std::vector<TRI_doc_mptr_t const*> _inEdges;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class EdgeSnapshotCache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache for the adjacency snapshot of an edge collection
+///
+/// the snapshot is built on demand when the same collection revision is
+/// requested a second time, so that single lookups on frequently modified
+/// collections do not pay for a full scan. a cached snapshot is discarded as
+/// soon as the revision of the collection changes
+////////////////////////////////////////////////////////////////////////////////
+
+    class EdgeSnapshotCache {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        EdgeSnapshotCache (EdgeSnapshotCache const&) = delete;
+        EdgeSnapshotCache& operator= (EdgeSnapshotCache const&) = delete;
+
+        EdgeSnapshotCache ();
+
+        ~EdgeSnapshotCache ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a snapshot for the current revision of the collection, or
+/// a nullptr if the snapshot should not be used. callers that read all edges
+/// of the collection anyway pass true for the second parameter, and always
+/// get a snapshot. the collection must be read-locked by the caller for as
+/// long as the snapshot's edges are accessed
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<EdgeSnapshot> get (TRI_document_collection_t*,
+                                           bool = false);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex _lock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cached snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<EdgeSnapshot> _snapshot;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the collection revision last requested without a snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_rid_t _requestedRevision;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a revision has been requested yet
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _requested;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief graph centrality measures on a graph snapshot
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "GraphCentrality.h"
+#include "Basics/Exceptions.h"
+#include "Basics/ThreadPool.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distance of unreached vertices
+////////////////////////////////////////////////////////////////////////////////
+
+static double const Unreached = HUGE_VAL;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of source vertices a thread picks up at once
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const ChunkSize = 16;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       SearchState
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief per-thread state of the single-source searches. the vectors are
+/// indexed by vertex number. after each search, only the entries of the
+/// vertices touched by it are reset
+////////////////////////////////////////////////////////////////////////////////
+
+struct GraphCentrality::SearchState {
+  explicit SearchState (size_t n) 
+    : dist(n, Unreached),
+      sigma(n, 0.0),
+      settled(n, 0) {
+  }
+
+  std::vector<double> dist;
+  std::vector<double> sigma;
+  std::vector<char> settled;
+  std::vector<VertexIndex> order;
+  std::vector<std::pair<double, VertexIndex>> heap;
+
+  // only used for betweenness
+  std::vector<double> delta;
+  std::vector<double> result;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the computation
+////////////////////////////////////////////////////////////////////////////////
+
+GraphCentrality::GraphCentrality (GraphSnapshot const& graph,
+                                  TRI_edge_direction_e direction,
+                                  triagens::basics::ThreadPool* pool,
+                                  size_t numThreads,
+                                  AbortCheck const& abortCheck) 
+  : _graph(graph),
+    _direction(direction),
+    _pool(pool),
+    _numThreads(numThreads == 0 ? 1 : numThreads),
+    _abortCheck(abortCheck) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the computation
+////////////////////////////////////////////////////////////////////////////////
+
+GraphCentrality::~GraphCentrality () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute the distances from each source vertex to all target vertices
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<GraphCentrality::Distances> GraphCentrality::distances (std::vector<VertexIndex> const& sources,
+                                                                    std::vector<bool> const& isTarget) {
+  TRI_ASSERT(isTarget.size() == _graph.numberOfVertices());
+
+  std::vector<Distances> result(sources.size());
+
+  runParallel(sources.size(), [&] (size_t i, SearchState& state) -> void {
+    VertexIndex const source = sources[i];
+    search(state, source, false);
+
+    // each source has its own result slot, so no locking is required
+    Distances& d = result[i];
+
+    for (auto const& v : state.order) {
+      if (! isTarget[v]) {
+        continue;
+      }
+
+      double const dist = state.dist[v];
+      d.sum += dist;
+
+      if (v != source) {
+        d.reached = true;
+
+        if (dist > d.max) {
+          d.max = dist;
+        }
+      }
+    }
+
+    reset(state);
+  }, [] (SearchState&) -> void { });
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute the (absolute) betweenness of all vertices
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> GraphCentrality::betweenness () {
+  size_t const n = _graph.numberOfVertices();
+
+  TRI_edge_direction_e reverse = TRI_EDGE_ANY;
+
+  if (_direction == TRI_EDGE_OUT) {
+    reverse = TRI_EDGE_IN;
+  }
+  else if (_direction == TRI_EDGE_IN) {
+    reverse = TRI_EDGE_OUT;
+  }
+
+  std::vector<double> result(n, 0.0);
+
+  runParallel(n, [&] (size_t i, SearchState& state) -> void {
+    VertexIndex const source = static_cast<VertexIndex>(i);
+
+    if (state.result.empty()) {
+      state.delta.resize(n, 0.0);
+      state.result.resize(n, 0.0);
+    }
+
+    search(state, source, true);
+
+    // accumulate the dependencies, in order of decreasing distance
+    for (size_t j = state.order.size(); j > 0; --j) {
+      VertexIndex const w = state.order[j - 1];
+      double const dw = state.dist[w];
+      double const factor = (1.0 + state.delta[w]) / state.sigma[w];
+
+      _graph.forEachNeighbor(w, reverse, [&] (GraphSnapshot::Neighbor const& neighbor) -> void {
+        VertexIndex const v = neighbor.vertex;
+
+        if (state.settled[v] && state.dist[v] + neighbor.weight == dw) {
+          // v is a predecessor of w on a shortest path
+          state.delta[v] += state.sigma[v] * factor;
+        }
+      });
+
+      if (w != source) {
+        state.result[w] += state.delta[w];
+      }
+    }
+
+    for (auto const& v : state.order) {
+      state.delta[v] = 0.0;
+    }
+
+    reset(state);
+  }, [&] (SearchState& state) -> void {
+    for (size_t i = 0; i < state.result.size(); ++i) {
+      result[i] += state.result[i];
+    }
+  });
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief run a single-source shortest path search. afterwards, state.order
+/// contains all reachable vertices in order of non-decreasing distance. if
+/// countPaths is set, the number of shortest paths to each vertex is
+/// computed in state.sigma
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphCentrality::search (SearchState& state,
+                              VertexIndex source,
+                              bool countPaths) const {
+  TRI_ASSERT(state.order.empty());
+
+  auto& dist = state.dist;
+  auto& sigma = state.sigma;
+  auto& settled = state.settled;
+  auto& order = state.order;
+
+  dist[source] = 0.0;
+  sigma[source] = 1.0;
+
+  if (! _graph.isWeighted()) {
+    // breadth-first search. order is used as the queue
+    order.emplace_back(source);
+    settled[source] = 1;
+    size_t head = 0;
+
+    while (head < order.size()) {
+      VertexIndex const v = order[head++];
+      double const next = dist[v] + 1.0;
+
+      _graph.forEachNeighbor(v, _direction, [&] (GraphSnapshot::Neighbor const& neighbor) -> void {
+        VertexIndex const w = neighbor.vertex;
+
+        if (! settled[w]) {
+          settled[w] = 1;
+          dist[w] = next;
+          sigma[w] = countPaths ? sigma[v] : 0.0;
+          order.emplace_back(w);
+        }
+        else if (countPaths && dist[w] == next) {
+          sigma[w] += sigma[v];
+        }
+      });
+    }
+    return;
+  }
+
+  // Dijkstra
+  auto& heap = state.heap;
+  auto const compare = std::greater<std::pair<double, VertexIndex>>();
+
+  heap.clear();
+  heap.emplace_back(0.0, source);
+
+  while (! heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), compare);
+    auto const top = heap.back();
+    heap.pop_back();
+
+    VertexIndex const v = top.second;
+
+    if (settled[v] || top.first > dist[v]) {
+      // outdated heap entry
+      continue;
+    }
+
+    settled[v] = 1;
+    order.emplace_back(v);
+
+    _graph.forEachNeighbor(v, _direction, [&] (GraphSnapshot::Neighbor const& neighbor) -> void {
+      VertexIndex const w = neighbor.vertex;
+
+      if (settled[w]) {
+        return;
+      }
+
+      double const next = top.first + neighbor.weight;
+
+      if (next < dist[w]) {
+        dist[w] = next;
+        sigma[w] = countPaths ? sigma[v] : 0.0;
+        heap.emplace_back(next, w);
+        std::push_heap(heap.begin(), heap.end(), compare);
+      }
+      else if (countPaths && next == dist[w]) {
+        sigma[w] += sigma[v];
+      }
+    });
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the search state for the next search
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphCentrality::reset (SearchState& state) const {
+  // all vertices with a finite distance have been settled, and are thus
+  // contained in the order
+  for (auto const& v : state.order) {
+    state.dist[v] = Unreached;
+    state.sigma[v] = 0.0;
+    state.settled[v] = 0;
+  }
+
+  state.order.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief run the work callback for the numbers 0 to n - 1, using multiple
+/// threads of the pool
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphCentrality::runParallel (size_t n,
+                                   std::function<void(size_t, SearchState&)> const& work,
+                                   std::function<void(SearchState&)> const& finish) {
+  if (n == 0) {
+    return;
+  }
+
+  size_t numThreads = (std::min)(_numThreads, (n + ChunkSize - 1) / ChunkSize);
+
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
+
+  std::atomic<size_t> next(0);
+  std::atomic<int> res(TRI_ERROR_NO_ERROR);
+  std::mutex finishLock;
+
+  auto worker = [&] () -> void {
+    try {
+      SearchState state(_graph.numberOfVertices());
+
+      while (res.load() == TRI_ERROR_NO_ERROR) {
+        size_t const lower = next.fetch_add(ChunkSize);
+
+        if (lower >= n) {
+          break;
+        }
+
+        if (_abortCheck && _abortCheck()) {
+          res = TRI_ERROR_QUERY_KILLED;
+          return;
+        }
+
+        size_t const upper = (std::min)(lower + ChunkSize, n);
+
+        for (size_t i = lower; i < upper; ++i) {
+          work(i, state);
+        }
+      }
+
+      std::lock_guard<std::mutex> locker(finishLock);
+      finish(state);
+    }
+    catch (triagens::basics::Exception const& ex) {
+      res = ex.code();
+    }
+    catch (std::bad_alloc const&) {
+      res = TRI_ERROR_OUT_OF_MEMORY;
+    }
+    catch (...) {
+      res = TRI_ERROR_INTERNAL;
+    }
+  };
+
+  try {
+    triagens::basics::ThreadPool::runConcurrently(_pool, worker, numThreads);
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  if (res.load() != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res.load());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief graph centrality measures on a graph snapshot
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_GRAPH_CENTRALITY_H
+#define ARANGODB_VOC_BASE_GRAPH_CENTRALITY_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/GraphSnapshot.h"
+
+namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class GraphCentrality
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace arango {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes shortest-path based measures on a graph snapshot
+///
+/// all measures run one single-source shortest path search (BFS for
+/// unweighted, Dijkstra for weighted snapshots) per source vertex. the
+/// searches are distributed over the threads of a pool
+////////////////////////////////////////////////////////////////////////////////
+
+    class GraphCentrality {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+        typedef GraphSnapshot::VertexIndex VertexIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distances found from a single source vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Distances {
+          Distances () 
+            : sum(0.0),
+              max(0.0),
+              reached(false) {
+          }
+
+          double sum;    // sum of the distances to all reachable targets
+          double max;    // maximum distance to a reachable target
+          bool reached;  // whether any target other than the source is reachable
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback to check whether the computation should be aborted
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<bool()> AbortCheck;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        GraphCentrality (GraphCentrality const&) = delete;
+        GraphCentrality& operator= (GraphCentrality const&) = delete;
+
+        GraphCentrality (GraphSnapshot const&,
+                         TRI_edge_direction_e,
+                         triagens::basics::ThreadPool*,
+                         size_t,
+                         AbortCheck const&);
+
+        ~GraphCentrality ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute the distances from each source vertex to all target
+/// vertices. the result contains one entry per source vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Distances> distances (std::vector<VertexIndex> const&,
+                                          std::vector<bool> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute the (absolute) betweenness of all vertices, using Brandes'
+/// algorithm. the result contains one entry per vertex of the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<double> betweenness ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+        struct SearchState;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief run a single-source shortest path search
+////////////////////////////////////////////////////////////////////////////////
+
+        void search (SearchState&,
+                     VertexIndex,
+                     bool) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the search state for the next search
+////////////////////////////////////////////////////////////////////////////////
+
+        void reset (SearchState&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief run the work callback for the numbers 0 to n - 1, using multiple
+/// threads. each thread has its own search state. the finish callback is
+/// called once per thread after its work is done, with a mutex held
+////////////////////////////////////////////////////////////////////////////////
+
+        void runParallel (size_t,
+                          std::function<void(size_t, SearchState&)> const&,
+                          std::function<void(SearchState&)> const&);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the graph
+////////////////////////////////////////////////////////////////////////////////
+
+        GraphSnapshot const& _graph;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief direction in which edges are followed
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_edge_direction_e const _direction;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pool that runs the searches along with the calling thread
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _pool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of threads to use
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t const _numThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief abort check callback
+////////////////////////////////////////////////////////////////////////////////
+
+        AbortCheck const _abortCheck;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
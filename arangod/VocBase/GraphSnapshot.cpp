@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compact in-memory adjacency snapshot of a graph
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "GraphSnapshot.h"
+#include "Basics/Exceptions.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+GraphSnapshot::GraphSnapshot () 
+  : _weighted(false),
+    _finalized(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+GraphSnapshot::~GraphSnapshot () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the vertices from a batch of documents
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphSnapshot::addVertices (TRI_voc_cid_t cid,
+                                 std::vector<TRI_doc_mptr_copy_t> const& documents) {
+  TRI_ASSERT(! _finalized);
+  TRI_ASSERT(_pending.empty());
+
+  auto& keys = _lookup[cid];
+  keys.reserve(keys.size() + documents.size());
+
+  for (auto const& it : documents) {
+    if (_vertexCids.size() >= static_cast<size_t>(UINT32_MAX)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_OUT_OF_MEMORY, "too many vertices in graph");
+    }
+
+    VertexIndex const next = static_cast<VertexIndex>(_vertexCids.size());
+    auto result = keys.emplace(std::string(TRI_EXTRACT_MARKER_KEY(&it)), next);
+
+    if (! result.second) {
+      // vertex already present
+      continue;
+    }
+
+    _vertexCids.emplace_back(cid);
+    _vertexKeys.emplace_back(&(*result.first).first);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the edges from the adjacency snapshot of an edge collection
+///
+/// the vertex numbers of the edge snapshot are translated into our own
+/// numbers once per vertex, so the edges themselves need no key lookups.
+/// self-loops are not contained in the edge snapshot, which is fine as they
+/// can never be part of a shortest path
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphSnapshot::addEdges (TRI_voc_cid_t cid,
+                              EdgeSnapshot const& edges,
+                              EdgeWeighter const& weighter,
+                              EdgeFilter const& filter) {
+  TRI_ASSERT(! _finalized);
+
+  // addVertices never hands out this number
+  VertexIndex const NoVertex = static_cast<VertexIndex>(UINT32_MAX);
+
+  size_t const n = edges.numberOfVertices();
+  std::vector<VertexIndex> numbers(n, NoVertex);
+
+  for (size_t i = 0; i < n; ++i) {
+    auto const v = static_cast<EdgeSnapshot::VertexIndex>(i);
+
+    if (! lookupVertex(edges.vertexCid(v), edges.vertexKey(v), numbers[i])) {
+      numbers[i] = NoVertex;
+    }
+  }
+
+  _pending.reserve(_pending.size() + edges.numberOfEdges());
+
+  for (size_t i = 0; i < n; ++i) {
+    VertexIndex const from = numbers[i];
+
+    if (from == NoVertex) {
+      // dangling edges
+      continue;
+    }
+
+    edges.forEachEdge(static_cast<EdgeSnapshot::VertexIndex>(i), TRI_EDGE_OUT, [&] (EdgeSnapshot::VertexIndex other,
+                                                                                    TRI_doc_mptr_t const* edge) -> void {
+      VertexIndex const to = numbers[other];
+
+      if (to == NoVertex) {
+        // dangling edge
+        return;
+      }
+
+      if (filter && ! filter(cid, edge)) {
+        return;
+      }
+
+      double weight = 1.0;
+
+      if (weighter) {
+        weight = weighter(edge);
+
+        if (weight == HUGE_VAL || weight != weight) {
+          // infinite or invalid weight. the edge cannot be followed
+          return;
+        }
+      }
+
+      if (weight != 1.0) {
+        _weighted = true;
+      }
+
+      _pending.emplace_back(PendingEdge{ from, to, weight });
+    });
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the adjacency arrays
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphSnapshot::finalize () {
+  TRI_ASSERT(! _finalized);
+
+  buildAdjacency(true, _outOffsets, _outEdges);
+  buildAdjacency(false, _inOffsets, _inEdges);
+
+  // free the memory of the pending edges
+  std::vector<PendingEdge>().swap(_pending);
+
+  _finalized = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the number of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+bool GraphSnapshot::lookupVertex (TRI_voc_cid_t cid,
+                                  char const* key,
+                                  VertexIndex& result) const {
+  auto it = _lookup.find(cid);
+
+  if (it == _lookup.end()) {
+    return false;
+  }
+
+  auto it2 = (*it).second.find(std::string(key));
+
+  if (it2 == (*it).second.end()) {
+    return false;
+  }
+
+  result = (*it2).second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build one set of adjacency arrays from the pending edges, using a
+/// counting sort by source vertex
+////////////////////////////////////////////////////////////////////////////////
+
+void GraphSnapshot::buildAdjacency (bool outbound,
+                                    std::vector<size_t>& offsets,
+                                    std::vector<Neighbor>& edges) const {
+  size_t const n = _vertexCids.size();
+
+  offsets.clear();
+  offsets.resize(n + 1, 0);
+
+  for (auto const& it : _pending) {
+    ++offsets[(outbound ? it.from : it.to) + 1];
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+
+  edges.clear();
+  edges.resize(_pending.size());
+
+  std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+
+  for (auto const& it : _pending) {
+    if (outbound) {
+      edges[positions[it.from]++] = Neighbor{ it.to, it.weight };
+    }
+    else {
+      edges[positions[it.to]++] = Neighbor{ it.from, it.weight };
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compact in-memory adjacency snapshot of a graph
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_GRAPH_SNAPSHOT_H
+#define ARANGODB_VOC_BASE_GRAPH_SNAPSHOT_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/edge-collection.h"
+#include "VocBase/EdgeSnapshot.h"
+#include "VocBase/voc-types.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class GraphSnapshot
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace arango {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compact adjacency snapshot of a graph
+///
+/// the vertices are numbered densely from 0 to n - 1, and the edges are stored
+/// in compressed sparse row (CSR) format, once for the outbound and once for
+/// the inbound direction. the snapshot is filled by adding all vertices first,
+/// then all edges, and must be finalized before it can be used.
+/// the edges are taken from the cached EdgeSnapshot of each edge collection,
+/// so the graph snapshot only adds the vertex numbering across collections,
+/// the edge filter and the edge weights.
+/// a finalized snapshot is immutable and can be read by multiple threads
+/// concurrently.
+////////////////////////////////////////////////////////////////////////////////
+
+    class GraphSnapshot {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dense vertex number
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef uint32_t VertexIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an adjacency entry
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Neighbor {
+          VertexIndex vertex;
+          double      weight;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback to weight an edge. edges with an infinite weight are
+/// not added to the snapshot
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<double(TRI_doc_mptr_t const*)> EdgeWeighter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback to filter edges
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<bool(TRI_voc_cid_t, TRI_doc_mptr_t const*)> EdgeFilter;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        GraphSnapshot (GraphSnapshot const&) = delete;
+        GraphSnapshot& operator= (GraphSnapshot const&) = delete;
+
+        GraphSnapshot ();
+
+        ~GraphSnapshot ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the vertices from a batch of documents
+////////////////////////////////////////////////////////////////////////////////
+
+        void addVertices (TRI_voc_cid_t,
+                          std::vector<TRI_doc_mptr_copy_t> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add the edges from the adjacency snapshot of an edge collection.
+/// edges connecting vertices that are not contained in the snapshot are
+/// ignored. the edge collection must be read-locked until the snapshot has
+/// been finalized
+////////////////////////////////////////////////////////////////////////////////
+
+        void addEdges (TRI_voc_cid_t,
+                       EdgeSnapshot const&,
+                       EdgeWeighter const&,
+                       EdgeFilter const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the adjacency arrays. no more vertices or edges can be added
+/// afterwards
+////////////////////////////////////////////////////////////////////////////////
+
+        void finalize ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the number of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        bool lookupVertex (TRI_voc_cid_t,
+                           char const*,
+                           VertexIndex&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of vertices
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t numberOfVertices () const {
+          return _vertexCids.size();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of edges
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t numberOfEdges () const {
+          return _outEdges.size();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the snapshot contains edges with a weight other
+/// than 1
+////////////////////////////////////////////////////////////////////////////////
+
+        inline bool isWeighted () const {
+          return _weighted;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the collection id of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        inline TRI_voc_cid_t vertexCid (VertexIndex vertex) const {
+          return _vertexCids[vertex];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the key of a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        inline std::string const& vertexKey (VertexIndex vertex) const {
+          return *_vertexKeys[vertex];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief call the callback for all neighbors of a vertex in the given
+/// direction. for TRI_EDGE_ANY, both the outbound and the inbound neighbors
+/// are visited
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        inline void forEachNeighbor (VertexIndex vertex,
+                                     TRI_edge_direction_e direction,
+                                     F const& callback) const {
+          TRI_ASSERT(_finalized);
+
+          if (direction != TRI_EDGE_IN) {
+            for (size_t i = _outOffsets[vertex]; i < _outOffsets[vertex + 1]; ++i) {
+              callback(_outEdges[i]);
+            }
+          }
+          if (direction != TRI_EDGE_OUT) {
+            for (size_t i = _inOffsets[vertex]; i < _inOffsets[vertex + 1]; ++i) {
+              callback(_inEdges[i]);
+            }
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build one set of adjacency arrays from the pending edges
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildAdjacency (bool,
+                             std::vector<size_t>&,
+                             std::vector<Neighbor>&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an edge that has been added but is not yet in the adjacency arrays
+////////////////////////////////////////////////////////////////////////////////
+
+        struct PendingEdge {
+          VertexIndex from;
+          VertexIndex to;
+          double      weight;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief vertex numbers, per vertex collection and key
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<TRI_voc_cid_t, std::unordered_map<std::string, VertexIndex>> _lookup;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection ids of the vertices, indexed by vertex number
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_voc_cid_t> _vertexCids;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keys of the vertices, indexed by vertex number. the keys are owned
+/// by _lookup
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string const*> _vertexKeys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief edges added but not yet finalized
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<PendingEdge> _pending;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief outbound adjacency, CSR offsets and entries
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _outOffsets;
+
+        std::vector<Neighbor> _outEdges;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inbound adjacency, CSR offsets and entries
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _inOffsets;
+
+        std::vector<Neighbor> _inEdges;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not any edge has a weight other than 1
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _weighted;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the snapshot has been finalized
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _finalized;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,501 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief primary index checkpoints for collections
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "IndexCheckpoint.h"
+#include "Basics/Exceptions.h"
+#include "Basics/files.h"
+#include "Basics/hashes.h"
+#include "Basics/logging.h"
+#include "Basics/tri-strings.h"
+#include "Indexes/PrimaryIndex.h"
+#include "VocBase/datafile.h"
+#include "VocBase/headers.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief magic number of checkpoint files
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t const CheckpointMagic = 0x41434b50;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current version of the checkpoint file format
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t const CheckpointVersion = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size of the checkpoint file header (magic, version, crc, reserved)
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const CheckpointHeaderSize = 4 * sizeof(uint32_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory range of a datafile
+////////////////////////////////////////////////////////////////////////////////
+
+  struct DatafileRange {
+    char const*    _begin;
+    char const*    _end;
+    TRI_voc_fid_t  _fid;
+
+    bool operator< (DatafileRange const& other) const {
+      return _begin < other._begin;
+    }
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends fixed-size values to a checkpoint buffer
+////////////////////////////////////////////////////////////////////////////////
+
+  class CheckpointWriter {
+    public:
+
+      explicit CheckpointWriter (std::string& buffer)
+        : _buffer(buffer) {
+      }
+
+      template<typename T>
+      void append (T value) {
+        _buffer.append(reinterpret_cast<char const*>(&value), sizeof(T));
+      }
+
+    private:
+
+      std::string& _buffer;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads fixed-size values from a checkpoint buffer
+////////////////////////////////////////////////////////////////////////////////
+
+  class CheckpointReader {
+    public:
+
+      CheckpointReader (char const* data,
+                        size_t length)
+        : _position(data),
+          _end(data + length) {
+      }
+
+      template<typename T>
+      bool read (T& value) {
+        if (static_cast<size_t>(_end - _position) < sizeof(T)) {
+          return false;
+        }
+        memcpy(&value, _position, sizeof(T));
+        _position += sizeof(T);
+        return true;
+      }
+
+      bool exhausted () const {
+        return _position == _end;
+      }
+
+    private:
+
+      char const* _position;
+      char const* _end;
+  };
+
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the datafile a marker is located in
+////////////////////////////////////////////////////////////////////////////////
+
+static DatafileRange const* FindRange (std::vector<DatafileRange> const& ranges,
+                                       void const* marker) {
+  char const* p = static_cast<char const*>(marker);
+
+  DatafileRange search = { p, p, 0 };
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), search);
+
+  if (it == ranges.begin()) {
+    return nullptr;
+  }
+
+  --it;
+
+  if (p < (*it)._begin ||
+      p + sizeof(TRI_df_marker_t) > (*it)._end) {
+    return nullptr;
+  }
+
+  auto m = static_cast<TRI_df_marker_t const*>(marker);
+
+  if (p + m->_size > (*it)._end) {
+    return nullptr;
+  }
+
+  return &(*it);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds all datafiles of a vector to the checkpoint file list
+////////////////////////////////////////////////////////////////////////////////
+
+static void AddDatafiles (TRI_document_collection_t* document,
+                          TRI_vector_pointer_t const* files,
+                          std::vector<IndexCheckpoint::DatafileEntry>& entries,
+                          std::vector<DatafileRange>& ranges) {
+  size_t const n = files->_length;
+
+  for (size_t i = 0; i < n; ++i) {
+    auto datafile = static_cast<TRI_datafile_t const*>(files->_buffer[i]);
+
+    IndexCheckpoint::DatafileEntry entry;
+    memset(&entry, 0, sizeof(entry));
+
+    entry._fid     = datafile->_fid;
+    entry._size    = datafile->_currentSize;
+    entry._tickMin = datafile->_tickMin;
+    entry._tickMax = datafile->_tickMax;
+    entry._dataMin = datafile->_dataMin;
+    entry._dataMax = datafile->_dataMax;
+
+    TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, datafile->_fid, false);
+
+    if (dfi != nullptr) {
+      entry._info = *dfi;
+    }
+    entry._info._fid = datafile->_fid;
+
+    entries.emplace_back(entry);
+    ranges.emplace_back(DatafileRange{ datafile->_data, datafile->_data + datafile->_currentSize, datafile->_fid });
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+IndexCheckpoint::IndexCheckpoint ()
+  : _revision(0),
+    _tickMax(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+IndexCheckpoint::~IndexCheckpoint () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the filename of the checkpoint for a collection
+////////////////////////////////////////////////////////////////////////////////
+
+std::string IndexCheckpoint::filename (TRI_document_collection_t const* document) {
+  char* filename = TRI_Concatenate2File(document->_directory, "index-checkpoint.db");
+
+  if (filename == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  std::string result(filename);
+  TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes a checkpoint for the collection
+////////////////////////////////////////////////////////////////////////////////
+
+int IndexCheckpoint::write (TRI_document_collection_t* document) {
+  if (document->_uncollectedLogfileEntries > 0 ||
+      document->_compactors._length > 0 ||
+      (document->_failedTransactions != nullptr && ! document->_failedTransactions->empty())) {
+    // some of the collection's state is not contained in its datafiles
+    return TRI_ERROR_ARANGO_ILLEGAL_STATE;
+  }
+
+  IndexCheckpoint checkpoint;
+  checkpoint._revision = document->_info._revision;
+  checkpoint._tickMax  = document->_tickMax;
+
+  // the iteration order must be the same as in TRI_IterateCollection
+  std::vector<DatafileRange> ranges;
+  AddDatafiles(document, &document->_datafiles, checkpoint._datafiles, ranges);
+  AddDatafiles(document, &document->_journals, checkpoint._datafiles, ranges);
+  std::sort(ranges.begin(), ranges.end());
+
+  auto primaryIndex = document->primaryIndex();
+  checkpoint._documents.reserve(primaryIndex->size());
+
+  for (TRI_doc_mptr_t const* mptr = document->_headersPtr->front(); mptr != nullptr; mptr = mptr->_next) {
+    auto marker = static_cast<TRI_df_marker_t const*>(mptr->getDataPtr());  // ONLY IN CLOSECOLLECTION, PROTECTED by fake trx in caller
+    auto range = FindRange(ranges, marker);
+
+    if (range == nullptr ||
+        range->_fid != mptr->_fid ||
+        (marker->_type != TRI_DOC_MARKER_KEY_DOCUMENT && marker->_type != TRI_DOC_MARKER_KEY_EDGE)) {
+      return TRI_ERROR_ARANGO_ILLEGAL_STATE;
+    }
+
+    checkpoint._documents.emplace_back(DocumentEntry{ mptr->_fid, static_cast<TRI_voc_size_t>(reinterpret_cast<char const*>(marker) - range->_begin), mptr->_hash });
+  }
+
+  if (checkpoint._documents.size() != primaryIndex->size()) {
+    return TRI_ERROR_ARANGO_ILLEGAL_STATE;
+  }
+
+  bool valid = document->getShaper()->iterateMarkers([&] (TRI_df_marker_t const* marker) -> bool {  // ONLY IN CLOSECOLLECTION, PROTECTED by fake trx in caller
+    auto range = FindRange(ranges, marker);
+
+    if (range == nullptr ||
+        (marker->_type != TRI_DF_MARKER_SHAPE && marker->_type != TRI_DF_MARKER_ATTRIBUTE)) {
+      return false;
+    }
+
+    checkpoint._markers.emplace_back(MarkerEntry{ range->_fid, static_cast<TRI_voc_size_t>(reinterpret_cast<char const*>(marker) - range->_begin) });
+    return true;
+  });
+
+  if (! valid) {
+    return TRI_ERROR_ARANGO_ILLEGAL_STATE;
+  }
+
+  // serialize the checkpoint
+  std::string buffer;
+  buffer.reserve(CheckpointHeaderSize + 
+                 5 * sizeof(uint64_t) + 
+                 checkpoint._datafiles.size() * sizeof(DatafileEntry) +
+                 checkpoint._documents.size() * (sizeof(TRI_voc_fid_t) + sizeof(TRI_voc_size_t) + sizeof(uint64_t)) +
+                 checkpoint._markers.size() * (sizeof(TRI_voc_fid_t) + sizeof(TRI_voc_size_t)));
+
+  CheckpointWriter writer(buffer);
+  writer.append<uint32_t>(CheckpointMagic);
+  writer.append<uint32_t>(CheckpointVersion);
+  writer.append<uint32_t>(0); // crc, patched below
+  writer.append<uint32_t>(0); // reserved
+
+  writer.append<uint64_t>(checkpoint._revision);
+  writer.append<uint64_t>(checkpoint._tickMax);
+  writer.append<uint64_t>(checkpoint._datafiles.size());
+  writer.append<uint64_t>(checkpoint._documents.size());
+  writer.append<uint64_t>(checkpoint._markers.size());
+
+  for (auto const& it : checkpoint._datafiles) {
+    writer.append(it._fid);
+    writer.append(it._size);
+    writer.append(it._tickMin);
+    writer.append(it._tickMax);
+    writer.append(it._dataMin);
+    writer.append(it._dataMax);
+    writer.append(it._info._numberAlive);
+    writer.append(it._info._numberDead);
+    writer.append(it._info._numberDeletion);
+    writer.append(it._info._numberShapes);
+    writer.append(it._info._numberAttributes);
+    writer.append(it._info._numberTransactions);
+    writer.append(it._info._sizeAlive);
+    writer.append(it._info._sizeDead);
+    writer.append(it._info._sizeShapes);
+    writer.append(it._info._sizeAttributes);
+    writer.append(it._info._sizeTransactions);
+  }
+
+  for (auto const& it : checkpoint._documents) {
+    writer.append(it._fid);
+    writer.append(it._offset);
+    writer.append(it._hash);
+  }
+
+  for (auto const& it : checkpoint._markers) {
+    writer.append(it._fid);
+    writer.append(it._offset);
+  }
+
+  uint32_t crc = TRI_FinalCrc32(TRI_BlockCrc32(TRI_InitialCrc32(),
+                                               buffer.c_str() + CheckpointHeaderSize,
+                                               buffer.size() - CheckpointHeaderSize));
+  memcpy(&buffer[2 * sizeof(uint32_t)], &crc, sizeof(uint32_t));
+
+  // write into a temporary file first, so a crash will never leave a
+  // partially written checkpoint behind
+  std::string const name = filename(document);
+  std::string const tmpName = name + ".tmp";
+
+  TRI_UnlinkFile(tmpName.c_str());
+
+  int res = TRI_WriteFile(tmpName.c_str(), buffer.c_str(), buffer.size());
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = TRI_RenameFile(tmpName.c_str(), name.c_str());
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_UnlinkFile(tmpName.c_str());
+    return res;
+  }
+
+  LOG_DEBUG("wrote index checkpoint for collection '%s' with %llu documents",
+            document->_info._name,
+            (unsigned long long) checkpoint._documents.size());
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads and validates a checkpoint file
+////////////////////////////////////////////////////////////////////////////////
+
+int IndexCheckpoint::read (std::string const& name) {
+  size_t length;
+  char* data = TRI_SlurpFile(TRI_UNKNOWN_MEM_ZONE, name.c_str(), &length);
+
+  if (data == nullptr) {
+    return TRI_errno();
+  }
+
+  int res = TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+
+  try {
+    CheckpointReader reader(data, length);
+    uint32_t magic, version, crc, reserved;
+
+    if (reader.read(magic) && magic == CheckpointMagic &&
+        reader.read(version) && version == CheckpointVersion &&
+        reader.read(crc) && reader.read(reserved) &&
+        crc == TRI_FinalCrc32(TRI_BlockCrc32(TRI_InitialCrc32(), data + CheckpointHeaderSize, length - CheckpointHeaderSize))) {
+
+      uint64_t numberDatafiles, numberDocuments, numberMarkers;
+
+      if (reader.read(_revision) &&
+          reader.read(_tickMax) &&
+          reader.read(numberDatafiles) &&
+          reader.read(numberDocuments) &&
+          reader.read(numberMarkers) &&
+          numberDatafiles <= length &&
+          numberDocuments <= length &&
+          numberMarkers <= length) {
+
+        bool ok = true;
+
+        for (uint64_t i = 0; ok && i < numberDatafiles; ++i) {
+          DatafileEntry entry;
+          memset(&entry, 0, sizeof(entry));
+
+          ok = reader.read(entry._fid) &&
+               reader.read(entry._size) &&
+               reader.read(entry._tickMin) &&
+               reader.read(entry._tickMax) &&
+               reader.read(entry._dataMin) &&
+               reader.read(entry._dataMax) &&
+               reader.read(entry._info._numberAlive) &&
+               reader.read(entry._info._numberDead) &&
+               reader.read(entry._info._numberDeletion) &&
+               reader.read(entry._info._numberShapes) &&
+               reader.read(entry._info._numberAttributes) &&
+               reader.read(entry._info._numberTransactions) &&
+               reader.read(entry._info._sizeAlive) &&
+               reader.read(entry._info._sizeDead) &&
+               reader.read(entry._info._sizeShapes) &&
+               reader.read(entry._info._sizeAttributes) &&
+               reader.read(entry._info._sizeTransactions);
+
+          entry._info._fid = entry._fid;
+          _datafiles.emplace_back(entry);
+        }
+
+        _documents.reserve(static_cast<size_t>(numberDocuments));
+
+        for (uint64_t i = 0; ok && i < numberDocuments; ++i) {
+          DocumentEntry entry;
+          ok = reader.read(entry._fid) &&
+               reader.read(entry._offset) &&
+               reader.read(entry._hash);
+          _documents.emplace_back(entry);
+        }
+
+        _markers.reserve(static_cast<size_t>(numberMarkers));
+
+        for (uint64_t i = 0; ok && i < numberMarkers; ++i) {
+          MarkerEntry entry;
+          ok = reader.read(entry._fid) &&
+               reader.read(entry._offset);
+          _markers.emplace_back(entry);
+        }
+
+        if (ok && reader.exhausted()) {
+          res = TRI_ERROR_NO_ERROR;
+        }
+      }
+    }
+  }
+  catch (triagens::basics::Exception const& ex) {
+    res = ex.code();
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, data);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    _datafiles.clear();
+    _documents.clear();
+    _markers.clear();
+  }
+
+  return res;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
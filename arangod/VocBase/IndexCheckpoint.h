@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief primary index checkpoints for collections
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_INDEX_CHECKPOINT_H
+#define ARANGODB_VOC_BASE_INDEX_CHECKPOINT_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/voc-types.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class IndexCheckpoint
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace arango {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checkpoint of a collection's primary index
+///
+/// the checkpoint stores the positions of all live document markers (in the
+/// order of the collection's headers list), the positions of all shape and
+/// attribute markers, plus the statistics of the datafiles it covers. it is
+/// written when a collection is closed cleanly and read when the collection
+/// is loaded again, so the primary index can be rebuilt without applying
+/// every single marker of the covered datafiles
+////////////////////////////////////////////////////////////////////////////////
+
+    class IndexCheckpoint {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a datafile covered by the checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+        struct DatafileEntry {
+          TRI_voc_fid_t            _fid;
+          TRI_voc_size_t           _size;
+          TRI_voc_tick_t           _tickMin;
+          TRI_voc_tick_t           _tickMax;
+          TRI_voc_tick_t           _dataMin;
+          TRI_voc_tick_t           _dataMax;
+          TRI_doc_datafile_info_t  _info;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of a live document marker
+////////////////////////////////////////////////////////////////////////////////
+
+        struct DocumentEntry {
+          TRI_voc_fid_t            _fid;
+          TRI_voc_size_t           _offset;
+          uint64_t                 _hash;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of a shape or attribute marker
+////////////////////////////////////////////////////////////////////////////////
+
+        struct MarkerEntry {
+          TRI_voc_fid_t            _fid;
+          TRI_voc_size_t           _offset;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        IndexCheckpoint ();
+
+        ~IndexCheckpoint ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the filename of the checkpoint for a collection
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string filename (TRI_document_collection_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes a checkpoint for the collection
+///
+/// the collection must not be modified concurrently. no checkpoint is written
+/// if any of the collection's data is still located outside its datafiles
+/// (e.g. in the write-ahead log)
+////////////////////////////////////////////////////////////////////////////////
+
+        static int write (TRI_document_collection_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads and validates a checkpoint file
+////////////////////////////////////////////////////////////////////////////////
+
+        int read (std::string const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection revision at the time of the checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_rid_t revision () const {
+          return _revision;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum marker tick of the collection at the time of the checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_tick_t tickMax () const {
+          return _tickMax;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief covered datafiles, in collection iteration order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<DatafileEntry> const& datafiles () const {
+          return _datafiles;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief live documents, in headers list order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<DocumentEntry> const& documents () const {
+          return _documents;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shape and attribute markers
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<MarkerEntry> const& markers () const {
+          return _markers;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        TRI_voc_rid_t               _revision;
+
+        TRI_voc_tick_t              _tickMax;
+
+        std::vector<DatafileEntry>  _datafiles;
+
+        std::vector<DocumentEntry>  _documents;
+
+        std::vector<MarkerEntry>    _markers;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
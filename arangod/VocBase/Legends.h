@@ -317,6 +317,127 @@ namespace triagens {
           return nullptr;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries in the attribute ID table
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shape_size_t numberAttributes () const {
+          return _numberAttributes;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief attribute ID of the i-th entry in the attribute ID table
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shape_aid_t attributeIdAt (TRI_shape_size_t i) const {
+          return _aids[i].aid;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief attribute name of the i-th entry in the attribute ID table
+////////////////////////////////////////////////////////////////////////////////
+
+        char const* attributeNameAt (TRI_shape_size_t i) const {
+          return _legend + _aids[i].offset;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries in the shape table
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shape_size_t numberShapes () const {
+          return _numberShapes;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shape of the i-th entry in the shape table
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shape_t const* shapeAt (TRI_shape_size_t i) const {
+          return reinterpret_cast<TRI_shape_t const*>(_legend + _shapes[i].offset);
+        }
+
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a shaper for attributes and shapes that are received one by one,
+/// e.g. from the binary replication log format
+////////////////////////////////////////////////////////////////////////////////
+
+    class DictionaryShaper : public Shaper {
+
+      public:
+
+        DictionaryShaper ()
+          : Shaper() {
+        }
+
+        ~DictionaryShaper () {
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add an attribute
+////////////////////////////////////////////////////////////////////////////////
+
+        void addAttribute (TRI_shape_aid_t aid,
+                           char const* name,
+                           size_t length) {
+          _attributes[aid] = std::string(name, length);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add a shape. the shape is copied into 8-byte aligned memory
+////////////////////////////////////////////////////////////////////////////////
+
+        void addShape (char const* data,
+                       size_t length) {
+          TRI_ASSERT(length >= sizeof(TRI_shape_t));
+
+          std::vector<uint64_t> shape((length + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+          memcpy(shape.data(), data, length);
+
+          TRI_shape_sid_t sid = reinterpret_cast<TRI_shape_t const*>(shape.data())->_sid;
+          _shapes[sid] = std::move(shape);
+        }
+
+        char const* lookupAttributeId (TRI_shape_aid_t aid) override final {
+          auto it = _attributes.find(aid);
+
+          if (it == _attributes.end()) {
+            return nullptr;
+          }
+
+          return (*it).second.c_str();
+        }
+
+        TRI_shape_t const* lookupShapeId (TRI_shape_sid_t sid) override final {
+          // Is it a builtin basic one?
+          if (sid < Shaper::firstCustomShapeId()) {
+            return Shaper::lookupSidBasicShape(sid);
+          }
+
+          auto it = _shapes.find(sid);
+
+          if (it == _shapes.end()) {
+            return nullptr;
+          }
+
+          return reinterpret_cast<TRI_shape_t const*>((*it).second.data());
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory zone for the JSON objects created from shaped JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* memoryZone () const {
+          return TRI_UNKNOWN_MEM_ZONE;
+        }
+
+      private:
+
+        std::unordered_map<TRI_shape_aid_t, std::string> _attributes;
+
+        std::unordered_map<TRI_shape_sid_t, std::vector<uint64_t>> _shapes;
     };
 
   }
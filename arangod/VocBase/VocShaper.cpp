@@ -924,6 +924,47 @@ int VocShaper::insertAttribute (TRI_df_marker_t const* marker,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invokes the callback for all shape and attribute markers the shaper
+/// currently points to
+////////////////////////////////////////////////////////////////////////////////
+
+bool VocShaper::iterateMarkers (std::function<bool(TRI_df_marker_t const*)> const& callback) {
+  {
+    READ_LOCKER(_shapeIdsLock);
+
+    for (uint32_t i = 0; i < _shapeIds._nrAlloc; ++i) {
+      char const* shape = static_cast<char const*>(_shapeIds._table[i]);
+
+      if (shape == nullptr) {
+        continue;
+      }
+
+      if (! callback(reinterpret_cast<TRI_df_marker_t const*>(shape - sizeof(TRI_df_shape_marker_t)))) {
+        return false;
+      }
+    }
+  }
+
+  {
+    READ_LOCKER(_attributeIdsLock);
+
+    for (uint32_t i = 0; i < _attributeIds._nrAlloc; ++i) {
+      auto marker = static_cast<TRI_df_marker_t const*>(_attributeIds._table[i]);
+
+      if (marker == nullptr) {
+        continue;
+      }
+
+      if (! callback(marker)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief finds an accessor
 ////////////////////////////////////////////////////////////////////////////////
@@ -936,7 +977,7 @@ TRI_shape_access_t const* VocShaper::findAccessor (TRI_shape_sid_t sid,
 
   TRI_shape_access_t const* found = nullptr;
   {
-    READ_LOCKER(_accessorLock[i]);
+    READ_LOCKER_SCALABLE(_accessorLock[i]);
 
     found = static_cast<TRI_shape_access_t const*>(TRI_LookupByElementAssociativePointer(&_accessors[i], &search));
 
@@ -956,7 +997,7 @@ TRI_shape_access_t const* VocShaper::findAccessor (TRI_shape_sid_t sid,
   // acquire the write-lock and try to insert our own accessor
 
   {
-    WRITE_LOCKER(_accessorLock[i]);
+    WRITE_LOCKER_SCALABLE(_accessorLock[i]);
     found = static_cast<TRI_shape_access_t const*>(TRI_InsertElementAssociativePointer(&_accessors[i], const_cast<void*>(static_cast<void const*>(accessor)), false));
   }
 
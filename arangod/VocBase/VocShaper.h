@@ -32,6 +32,7 @@
 #define ARANGODB_VOC_BASE_VOC_SHAPER_H 1
 
 #include "Basics/Common.h"
+#include "Basics/ReadWriteLockScalable.h"
 #include "VocBase/datafile.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/shape-accessor.h"
@@ -155,6 +156,14 @@ class VocShaper : public Shaper {
     int insertAttribute (TRI_df_marker_t const*,
                          bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invokes the callback for all shape and attribute markers the shaper
+/// currently points to. shape markers are assumed to be datafile markers.
+/// iteration stops as soon as the callback returns false
+////////////////////////////////////////////////////////////////////////////////
+
+    bool iterateMarkers (std::function<bool(TRI_df_marker_t const*)> const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief finds an accessor
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,7 +231,7 @@ class VocShaper : public Shaper {
     TRI_associative_pointer_t       _shapeIds;
 
     // accessors
-    triagens::basics::ReadWriteLock _accessorLock[NUM_SHAPE_ACCESSORS];
+    triagens::basics::ReadWriteLockScalable _accessorLock[NUM_SHAPE_ACCESSORS];
     TRI_associative_pointer_t       _accessors[NUM_SHAPE_ACCESSORS];
 
     TRI_shape_pid_t                 _nextPid;
@@ -38,6 +38,7 @@
 #include "Basics/logging.h"
 #include "Basics/tri-strings.h"
 #include "Basics/memory-map.h"
+#include "Basics/ThreadPool.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/server.h"
 #include "VocBase/vocbase.h"
@@ -408,6 +409,68 @@ static TRI_col_file_structure_t ScanCollectionDirectory (char const* path) {
   return structure;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief datafile found in a collection directory, before it is opened
+////////////////////////////////////////////////////////////////////////////////
+
+struct PendingDatafile {
+  PendingDatafile (char* filename,
+                   char const* type,
+                   size_t typeLength)
+    : _filename(filename),
+      _type(type, typeLength),
+      _datafile(nullptr),
+      _error(TRI_ERROR_NO_ERROR) {
+  }
+
+  char*            _filename;
+  std::string      _type;
+  TRI_datafile_t*  _datafile;
+  int              _error;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief opens the datafiles of a collection
+///
+/// opening a datafile checks all its markers, which is CPU-bound. the files
+/// are therefore opened by up to the server's number of loader threads, using
+/// the server's loader pool
+////////////////////////////////////////////////////////////////////////////////
+
+static void OpenDatafiles (TRI_collection_t* collection,
+                           std::vector<PendingDatafile>& pending,
+                           bool ignoreErrors) {
+  triagens::basics::ThreadPool* pool = nullptr;
+  size_t numThreads = 1;
+
+  if (collection->_vocbase != nullptr &&
+      collection->_vocbase->_server != nullptr) {
+    pool = collection->_vocbase->_server->_loaderPool;
+    numThreads = collection->_vocbase->_server->_loaderThreads;
+  }
+
+  std::atomic<size_t> next(0);
+
+  auto work = [&pending, &next, ignoreErrors] () -> void {
+    while (true) {
+      size_t const i = next++;
+
+      if (i >= pending.size()) {
+        return;
+      }
+
+      pending[i]._datafile = TRI_OpenDatafile(pending[i]._filename, ignoreErrors);
+
+      if (pending[i]._datafile == nullptr) {
+        // the error number is thread-local
+        pending[i]._error = TRI_errno();
+      }
+    }
+  };
+
+  triagens::basics::ThreadPool::runConcurrently(pool, work, (std::min)(numThreads, pending.size()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks a collection
 ///
@@ -423,6 +486,7 @@ static bool CheckCollection (TRI_collection_t* collection,
   TRI_vector_pointer_t journals;
   TRI_vector_pointer_t sealed;
   TRI_vector_string_t files;
+  std::vector<PendingDatafile> pending;
   bool stop;
   regex_t re;
   size_t i, n;
@@ -489,8 +553,6 @@ static bool CheckCollection (TRI_collection_t* collection,
 
       else if (TRI_EqualString2("db", third, thirdLen)) {
         char* filename;
-        char* ptr;
-        TRI_col_header_marker_t* cm;
 
         if (TRI_EqualString2("compaction", first, firstLen)) {
           // found a compaction file. now rename it back
@@ -535,95 +597,117 @@ static bool CheckCollection (TRI_collection_t* collection,
         }
 
         TRI_ASSERT(filename != nullptr);
-        datafile = TRI_OpenDatafile(filename, ignoreErrors);
 
-        if (datafile == nullptr) {
-          collection->_lastError = TRI_errno();
-          LOG_ERROR("cannot open datafile '%s': %s", filename, TRI_last_error());
+        // the datafile is opened below
+        pending.emplace_back(filename, first, firstLen);
+      }
+      else {
+        LOG_ERROR("unknown datafile '%s'", file);
+      }
+    }
+  }
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+  TRI_DestroyVectorString(&files);
 
-        TRI_PushBackVectorPointer(&all, datafile);
+  regfree(&re);
 
-        // check the document header
-        ptr  = datafile->_data;
-        // skip the datafile header
-        ptr += TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_header_marker_t));
-        cm   = (TRI_col_header_marker_t*) ptr;
+  // open the datafiles, possibly in parallel
+  if (! stop) {
+    OpenDatafiles(collection, pending, ignoreErrors);
+  }
 
-        if (cm->base._type != TRI_COL_MARKER_HEADER) {
-          LOG_ERROR("collection header mismatch in file '%s', expected TRI_COL_MARKER_HEADER, found %lu",
-                    filename,
-                    (unsigned long) cm->base._type);
+  for (i = 0;  ! stop && i < pending.size();  ++i) {
+    char const* filename = pending[i]._filename;
+    std::string const& type = pending[i]._type;
+    char* ptr;
+    TRI_col_header_marker_t* cm;
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+    datafile = pending[i]._datafile;
 
-        if (cm->_cid != collection->_info._cid) {
-          LOG_ERROR("collection identifier mismatch, expected %llu, found %llu",
-                    (unsigned long long) collection->_info._cid,
-                    (unsigned long long) cm->_cid);
+    if (datafile == nullptr) {
+      collection->_lastError = pending[i]._error;
+      LOG_ERROR("cannot open datafile '%s': %s", filename, TRI_errno_string(pending[i]._error));
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+      stop = true;
+      break;
+    }
 
-        // file is a journal
-        if (TRI_EqualString2("journal", first, firstLen)) {
-          if (datafile->_isSealed) {
-            if (datafile->_state != TRI_DF_STATE_READ) {
-              LOG_WARNING("strange, journal '%s' is already sealed; must be a left over; will use it as datafile", filename);
-            }
+    // the datafile is now owned by the all vector
+    pending[i]._datafile = nullptr;
+    TRI_PushBackVectorPointer(&all, datafile);
 
-            TRI_PushBackVectorPointer(&sealed, datafile);
-          }
-          else {
-            TRI_PushBackVectorPointer(&journals, datafile);
-          }
-        }
+    // check the document header
+    ptr  = datafile->_data;
+    // skip the datafile header
+    ptr += TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_header_marker_t));
+    cm   = (TRI_col_header_marker_t*) ptr;
 
-        // file is a compactor
-        else if (TRI_EqualString2("compactor", first, firstLen)) {
-          // ignore
-        }
+    if (cm->base._type != TRI_COL_MARKER_HEADER) {
+      LOG_ERROR("collection header mismatch in file '%s', expected TRI_COL_MARKER_HEADER, found %lu",
+                filename,
+                (unsigned long) cm->base._type);
 
-        // file is a datafile (or was a compaction file)
-        else if (TRI_EqualString2("datafile", first, firstLen) ||
-                 TRI_EqualString2("compaction", first, firstLen)) {
-          if (! datafile->_isSealed) {
-            LOG_ERROR("datafile '%s' is not sealed, this should never happen", filename);
+      stop = true;
+      break;
+    }
 
-            collection->_lastError = TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
-            TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-            stop = true;
-            break;
-          }
-          else {
-            TRI_PushBackVectorPointer(&datafiles, datafile);
-          }
-        }
+    if (cm->_cid != collection->_info._cid) {
+      LOG_ERROR("collection identifier mismatch, expected %llu, found %llu",
+                (unsigned long long) collection->_info._cid,
+                (unsigned long long) cm->_cid);
 
-        else {
-          LOG_ERROR("unknown datafile '%s'", file);
+      stop = true;
+      break;
+    }
+
+    // file is a journal
+    if (type == "journal") {
+      if (datafile->_isSealed) {
+        if (datafile->_state != TRI_DF_STATE_READ) {
+          LOG_WARNING("strange, journal '%s' is already sealed; must be a left over; will use it as datafile", filename);
         }
 
-        TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+        TRI_PushBackVectorPointer(&sealed, datafile);
       }
       else {
-        LOG_ERROR("unknown datafile '%s'", file);
+        TRI_PushBackVectorPointer(&journals, datafile);
+      }
+    }
+
+    // file is a compactor
+    else if (type == "compactor") {
+      // ignore
+    }
+
+    // file is a datafile (or was a compaction file)
+    else if (type == "datafile" || type == "compaction") {
+      if (! datafile->_isSealed) {
+        LOG_ERROR("datafile '%s' is not sealed, this should never happen", filename);
+
+        collection->_lastError = TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
+        stop = true;
+        break;
       }
+      else {
+        TRI_PushBackVectorPointer(&datafiles, datafile);
+      }
+    }
+
+    else {
+      LOG_ERROR("unknown datafile '%s'", filename);
     }
   }
 
-  TRI_DestroyVectorString(&files);
+  // free the filenames, and close all datafiles that were opened but not
+  // processed because of an error
+  for (auto& it : pending) {
+    if (it._datafile != nullptr) {
+      TRI_CloseDatafile(it._datafile);
+      TRI_FreeDatafile(it._datafile);
+    }
 
-  regfree(&re);
+    TRI_FreeString(TRI_CORE_MEM_ZONE, it._filename);
+  }
 
   // convert the sealed journals into datafiles
   if (! stop) {
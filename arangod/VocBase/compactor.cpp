@@ -39,6 +39,7 @@
 #include "Basics/tri-strings.h"
 #include "Basics/memory-map.h"
 #include "Utils/transactions.h"
+#include "VocBase/CompactionScheduler.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/server.h"
 #include "VocBase/vocbase.h"
@@ -756,8 +757,29 @@ static compaction_initial_context_t InitCompaction (TRI_document_collection_t* d
   return context;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts for data written to a compactor file, and waits if the
+/// compaction bandwidth has been exhausted
+/// this must be called without the documents and datafiles locks of the
+/// collection. the wait stops when the database is shut down or dropped
+////////////////////////////////////////////////////////////////////////////////
+
+static void ThrottleCompaction (TRI_document_collection_t* document,
+                                uint64_t written) {
+  TRI_vocbase_t* vocbase = document->_vocbase;
+  auto scheduler = vocbase->_server->_compactionScheduler;
+
+  if (scheduler != nullptr && written > 0) {
+    scheduler->throttle(written, [vocbase] () -> bool {
+      return vocbase->_state != 1;
+    });
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compact a list of datafiles
+/// the data written for each datafile is charged against the compaction
+/// bandwidth once the collection's documents lock has been released
 ////////////////////////////////////////////////////////////////////////////////
 
 static void CompactifyDatafiles (TRI_document_collection_t* document,
@@ -821,6 +843,8 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
     // deletion markers
     context._keepDeletions = compaction->_keepDeletions;
 
+    TRI_voc_size_t const previousSize = compactor->_currentSize;
+
     TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
    
     // run the actual compaction of a single datafile
@@ -834,6 +858,9 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
       // TODO: Remove
       return;
     }
+
+    // limit the write rate before compacting the next datafile
+    ThrottleCompaction(document, static_cast<uint64_t>(compactor->_currentSize - previousSize));
   } // next file
 
 
@@ -1120,6 +1147,141 @@ static bool CompactifyDocumentCollection (TRI_document_collection_t* document) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the share of dead data in the datafiles of a collection
+/// this is used as the priority of the collection's compaction
+////////////////////////////////////////////////////////////////////////////////
+
+static double DeadShare (TRI_document_collection_t* document) {
+  if (! TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(document)) {
+    return 0.0;
+  }
+
+  int64_t sizeDead  = 0;
+  int64_t sizeAlive = 0;
+
+  size_t const n = document->_datafiles._length;
+
+  for (size_t i = 0;  i < n;  ++i) {
+    TRI_datafile_t* df = static_cast<TRI_datafile_t*>(document->_datafiles._buffer[i]);
+    TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, df->_fid, false);
+
+    if (dfi != nullptr) {
+      sizeDead  += dfi->_sizeDead;
+      sizeAlive += dfi->_sizeAlive;
+    }
+  }
+
+  TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(document);
+
+  if (sizeDead <= 0) {
+    return 0.0;
+  }
+
+  return (double) sizeDead / ((double) sizeDead + (double) sizeAlive);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns whether a collection should be checked for compaction, and
+/// its compaction priority
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsCompactionCandidate (TRI_vocbase_col_t* collection,
+                                   double now,
+                                   double& priority) {
+  if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
+    // if we can't acquire the read lock instantly, we continue directly
+    // we don't want to stall here for too long
+    return false;
+  }
+
+  TRI_document_collection_t* document = collection->_collection;
+  bool candidate = false;
+
+  if (document != nullptr &&
+      collection->_status == TRI_VOC_COL_STATUS_LOADED && 
+      document->_info._doCompact &&
+      TRI_TryReadLockReadWriteLock(&document->_compactionLock)) {
+    candidate = (document->_lastCompaction + COMPACTOR_COLLECTION_INTERVAL <= now);
+    TRI_ReadUnlockReadWriteLock(&document->_compactionLock);
+
+    if (candidate) {
+      priority = DeadShare(document);
+    }
+  }
+
+  TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+
+  return candidate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compacts a single collection
+/// this may be called from any compaction worker thread
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CompactifyCollection (TRI_vocbase_t* vocbase,
+                                  TRI_vocbase_col_t* collection,
+                                  double now) {
+  if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
+    return false;
+  }
+
+  TRI_document_collection_t* document = collection->_collection;
+
+  if (document == nullptr) {
+    TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+    return false;
+  }
+
+  bool worked       = false;
+  bool doCompact    = document->_info._doCompact;
+
+  // for document collection, compactify datafiles
+  if (collection->_status == TRI_VOC_COL_STATUS_LOADED && doCompact) {
+    // check whether someone else holds a read-lock on the compaction lock
+    if (! TRI_TryWriteLockReadWriteLock(&document->_compactionLock)) {
+      // someone else is holding the compactor lock, we'll not compact
+      TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+      return false;
+    }
+
+    if (document->_lastCompaction + COMPACTOR_COLLECTION_INTERVAL <= now) {
+      auto ce = document->ditches()->createCompactionDitch(__FILE__, __LINE__);
+
+      if (ce == nullptr) {
+        // out of memory
+        LOG_WARNING("out of memory when trying to create compaction ditch");
+      }
+      else {
+        worked = CompactifyDocumentCollection(document);
+
+        if (! worked) {
+          // set compaction stamp
+          document->_lastCompaction = now;
+        }
+        // if we worked, then we don't set the compaction stamp to force another round of compaction
+
+        document->ditches()->freeDitch(ce);
+      }
+    }
+
+    // read-unlock the compaction lock
+    TRI_WriteUnlockReadWriteLock(&document->_compactionLock);
+  }
+
+  TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+
+  if (worked) {
+    // signal the cleanup thread that we worked and that it can now wake up
+    TRI_LockCondition(&vocbase->_cleanupCondition);
+    TRI_SignalCondition(&vocbase->_cleanupCondition);
+    TRI_UnlockCondition(&vocbase->_cleanupCondition);
+  }
+
+  return worked;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to write-lock the compaction
 /// returns true if lock acquisition was successful. the caller is responsible
@@ -1359,10 +1521,11 @@ int TRI_RemoveBlockerCompactorVocBase (TRI_vocbase_t* vocbase,
 void TRI_CompactorVocBase (void* data) {
   TRI_vocbase_t* vocbase = static_cast<TRI_vocbase_t*>(data);
 
-  int numCompacted = 0;
+  size_t numCompacted = 0;
   TRI_ASSERT(vocbase->_state == 1);
 
   std::vector<TRI_vocbase_col_t*> collections;
+  std::vector<triagens::arango::CompactionScheduler::Task> tasks;
 
   while (true) {
     // keep initial _state value as vocbase->_state might change during compaction loop
@@ -1383,66 +1546,36 @@ void TRI_CompactorVocBase (void* data) {
         collections.clear();
       }
 
-      for (auto& collection : collections) {
-        if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
-          // if we can't acquire the read lock instantly, we continue directly
-          // we don't want to stall here for too long
-          continue;
-        }
+      tasks.clear();
 
-        TRI_document_collection_t* document = collection->_collection;
+      for (auto& collection : collections) {
+        double priority = 0.0;
 
-        if (document == nullptr) {
-          TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+        if (! IsCompactionCandidate(collection, now, priority)) {
           continue;
         }
 
-        bool worked    = false;
-        bool doCompact = document->_info._doCompact;
-
-        // for document collection, compactify datafiles
-        if (collection->_status == TRI_VOC_COL_STATUS_LOADED && doCompact) {
-          // check whether someone else holds a read-lock on the compaction lock
-          if (! TRI_TryWriteLockReadWriteLock(&document->_compactionLock)) {
-            // someone else is holding the compactor lock, we'll not compact
-            TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
-            continue;
-          }
-
-          if (document->_lastCompaction + COMPACTOR_COLLECTION_INTERVAL <= now) {
-            auto ce = document->ditches()->createCompactionDitch(__FILE__, __LINE__);
-
-            if (ce == nullptr) {
-              // out of memory
-              LOG_WARNING("out of memory when trying to create compaction ditch");
-            }
-            else {
-              worked = CompactifyDocumentCollection(document);
-
-              if (! worked) {
-                // set compaction stamp
-                document->_lastCompaction = now;
-              }
-              // if we worked, then we don't set the compaction stamp to force another round of compaction
-
-              document->ditches()->freeDitch(ce);
-            }
-          }
-
-          // read-unlock the compaction lock
-          TRI_WriteUnlockReadWriteLock(&document->_compactionLock);
+        try {
+          tasks.emplace_back(priority, [vocbase, collection, now] () -> bool {
+            return CompactifyCollection(vocbase, collection, now);
+          });
         }
+        catch (...) {
+          // out of memory. we'll try again in the next round
+          break;
+        }
+      }
 
-        TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
-
-        if (worked) {
-          ++numCompacted;
+      // collections with the highest share of dead data are compacted first.
+      // the scheduler is shared by all databases and may compact collections
+      // of this database in parallel
+      auto scheduler = vocbase->_server->_compactionScheduler;
 
-          // signal the cleanup thread that we worked and that it can now wake up
-          TRI_LockCondition(&vocbase->_cleanupCondition);
-          TRI_SignalCondition(&vocbase->_cleanupCondition);
-          TRI_UnlockCondition(&vocbase->_cleanupCondition);
-        }
+      if (scheduler != nullptr) {
+        numCompacted = scheduler->execute(tasks);
+      }
+      else {
+        numCompacted = triagens::arango::CompactionScheduler::executeSerially(tasks);
       }
 
       UnlockCompaction(vocbase);
@@ -38,6 +38,7 @@
 #include "Basics/logging.h"
 #include "Basics/memory-map.h"
 #include "Basics/tri-strings.h"
+#include "Statistics/statistics.h"
 #include "VocBase/server.h"
 
 // #define DEBUG_DATAFILE 1
@@ -112,7 +113,11 @@ static bool SyncDatafile (const TRI_datafile_t* const datafile,
     return true;
   }
 
-  return TRI_MSync(datafile->_fd, begin, end);
+  double const syncStart = TRI_microtime();
+  bool result = TRI_MSync(datafile->_fd, begin, end);
+  TRI_WaitStatistics(TRI_WAIT_DATAFILE_SYNC, TRI_microtime() - syncStart);
+
+  return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
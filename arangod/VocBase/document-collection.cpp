@@ -31,10 +31,12 @@
 
 #include "Aql/QueryCache.h"
 #include "Basics/Barrier.h"
+#include "Basics/ConditionLocker.h"
 #include "Basics/conversions.h"
 #include "Basics/Exceptions.h"
 #include "Basics/files.h"
 #include "Basics/logging.h"
+#include "Basics/memory-map.h"
 #include "Basics/tri-strings.h"
 #include "Basics/ThreadPool.h"
 #include "FulltextIndex/fulltext-index.h"
@@ -48,11 +50,13 @@
 #include "RestServer/ArangoServer.h"
 #include "Utils/transactions.h"
 #include "Utils/CollectionReadLocker.h"
-#include "Utils/CollectionWriteLocker.h"
+#include "Utils/DocumentWriteLocker.h"
 #include "VocBase/Ditch.h"
 #include "VocBase/edge-collection.h"
+#include "VocBase/EdgeSnapshot.h"
 #include "VocBase/ExampleMatcher.h"
 #include "VocBase/headers.h"
+#include "VocBase/IndexCheckpoint.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/server.h"
 #include "VocBase/shape-accessor.h"
@@ -115,12 +119,17 @@ void TRI_doc_mptr_copy_t::setDataPtr (void const* d) {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_document_collection_t::TRI_document_collection_t () 
-  : _useSecondaryIndexes(true),
+  : _concurrentWriters(0),
+    _concurrentWriteAcquiring(false),
+    _concurrentWriting(false),
+    _useSecondaryIndexes(true),
     _capConstraint(nullptr),
+    _edgeSnapshots(new triagens::arango::EdgeSnapshotCache()),
     _ditches(this),
     _headersPtr(nullptr),
     _keyGenerator(nullptr),
     _uncollectedLogfileEntries(0),
+    _numberDocuments(0),
     _cleanupIndexes(0) {
 
   _tickMax = 0;
@@ -131,6 +140,7 @@ TRI_document_collection_t::TRI_document_collection_t ()
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_document_collection_t::~TRI_document_collection_t () {
+  delete _edgeSnapshots;
   delete _keyGenerator;
 }
 
@@ -296,6 +306,80 @@ int TRI_document_collection_t::beginWriteTimed (uint64_t timeout,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locks a collection for a single-document write operation
+///
+/// single-document write operations share the write lock of the collection:
+/// the first operation acquires it, further operations join as long as no
+/// reader and no other writer waits for the lock, and the last operation
+/// to finish releases it. readers and exclusive writers are kept out as
+/// before, but single-document writers only serialize on the keys they
+/// modify (see keyLock()) and on the individual indexes. readers that blocked
+/// while a group held the lock get it before the next group does.
+///
+/// returns false if the collection must not be locked by command. nothing
+/// is locked then, and endConcurrentWrite() must not be called
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_document_collection_t::beginConcurrentWrite () {
+  if (triagens::arango::Transaction::_makeNolockHeaders != nullptr) {
+    std::string collName(_info._name);
+    auto it = triagens::arango::Transaction::_makeNolockHeaders->find(collName);
+    if (it != triagens::arango::Transaction::_makeNolockHeaders->end()) {
+      // do not lock by command
+      return false;
+    }
+  }
+
+  CONDITION_LOCKER(guard, _concurrentWritersCondition);
+
+  while (true) {
+    if (_concurrentWriting.load()) {
+      if (! _lock.hasWaiters()) {
+        // join the operations that currently hold the lock
+        ++_concurrentWriters;
+        return true;
+      }
+      // let the waiting threads go first
+    }
+    else if (! _concurrentWriteAcquiring) {
+      // acquire the lock for all operations
+      _concurrentWriteAcquiring = true;
+
+      guard.unlock();
+      TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(this);
+      guard.lock();
+
+      _concurrentWriteAcquiring = false;
+      _concurrentWriting = true;
+      ++_concurrentWriters;
+
+      guard.broadcast();
+      return true;
+    }
+
+    guard.wait();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ends a single-document write operation
+/// the write lock is released when the last concurrent operation ends
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_document_collection_t::endConcurrentWrite () {
+  CONDITION_LOCKER(guard, _concurrentWritersCondition);
+
+  TRI_ASSERT(_concurrentWriters > 0);
+
+  if (--_concurrentWriters == 0) {
+    _concurrentWriting = false;
+    TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(this);
+
+    guard.broadcast();
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the number of documents in collection
 ///
@@ -382,6 +466,11 @@ TRI_doc_collection_info_t* TRI_document_collection_t::figures () {
   info->_uncollectedLogfileEntries = _uncollectedLogfileEntries;
   info->_tickMax = _tickMax;
 
+  info->_lockReadWaits     = _lock.readWaits();
+  info->_lockWriteWaits    = _lock.writeWaits();
+  info->_lockReadWaitTime  = _lock.readWaitTime();
+  info->_lockWriteWaitTime = _lock.writeWaitTime();
+
   return info;
 }
 
@@ -595,6 +684,39 @@ static void FreeDatafileInfo (TRI_doc_datafile_info_t* dfi) {
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, dfi);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks a mutex while single-document write operations share the
+/// collection's write lock. otherwise the write lock is held exclusively, and
+/// the mutex is not needed
+////////////////////////////////////////////////////////////////////////////////
+
+class ConcurrentWriteLocker {
+
+  public:
+
+    ConcurrentWriteLocker (ConcurrentWriteLocker const&) = delete;
+    ConcurrentWriteLocker& operator= (ConcurrentWriteLocker const&) = delete;
+
+    ConcurrentWriteLocker (TRI_document_collection_t const* document,
+                           triagens::basics::Mutex& mutex)
+      : _mutex(document->isConcurrentWriting() ? &mutex : nullptr) {
+
+      if (_mutex != nullptr) {
+        _mutex->lock();
+      }
+    }
+
+    ~ConcurrentWriteLocker () {
+      if (_mutex != nullptr) {
+        _mutex->unlock();
+      }
+    }
+
+  private:
+
+    triagens::basics::Mutex* _mutex;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set the collection tick with the marker's tick value
 ////////////////////////////////////////////////////////////////////////////////
@@ -604,6 +726,8 @@ static inline void SetRevision (TRI_document_collection_t* document,
                                 bool force) {
   TRI_col_info_t* info = &document->_info;
 
+  ConcurrentWriteLocker locker(document, document->_revisionLock);
+
   if (force || rid > info->_revision) {
     info->_revision = rid;
   }
@@ -642,7 +766,11 @@ static int InsertPrimaryIndex (TRI_document_collection_t* document,
 
   // insert into primary index
   auto primaryIndex = document->primaryIndex();
-  int res = primaryIndex->insertKey(header, (void const**) &found);
+  int res;
+  {
+    ConcurrentWriteLocker locker(document, primaryIndex->bucketLock(header->_hash));
+    res = primaryIndex->insertKey(header, (void const**) &found);
+  }
 
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
@@ -685,7 +813,11 @@ static int InsertSecondaryIndexes (TRI_document_collection_t* document,
 
   for (size_t i = 1; i < n; ++i) {
     auto idx = indexes[i];
-    int res = idx->insert(header, isRollback);
+    int res;
+    {
+      ConcurrentWriteLocker locker(document, idx->concurrentWriteLock());
+      res = idx->insert(header, isRollback);
+    }
 
     // in case of no-memory, return immediately
     if (res == TRI_ERROR_OUT_OF_MEMORY) {
@@ -715,7 +847,11 @@ static int DeletePrimaryIndex (TRI_document_collection_t* document,
   }
 
   auto primaryIndex = document->primaryIndex();
-  auto found = primaryIndex->removeKey(TRI_EXTRACT_MARKER_KEY(header)); // ONLY IN INDEX, PROTECTED by RUNTIME
+  TRI_doc_mptr_t* found;
+  {
+    ConcurrentWriteLocker locker(document, primaryIndex->bucketLock(header->_hash));
+    found = primaryIndex->removeKey(TRI_EXTRACT_MARKER_KEY(header)); // ONLY IN INDEX, PROTECTED by RUNTIME
+  }
 
   if (found == nullptr) {
     return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
@@ -746,7 +882,11 @@ static int DeleteSecondaryIndexes (TRI_document_collection_t* document,
 
   for (size_t i = 1; i < n; ++i) {
     auto idx = indexes[i];
-    int res = idx->remove(header, isRollback);
+    int res;
+    {
+      ConcurrentWriteLocker locker(document, idx->concurrentWriteLock());
+      res = idx->remove(header, isRollback);
+    }
 
     if (res != TRI_ERROR_NO_ERROR) {
       // an error occurred
@@ -917,6 +1057,7 @@ static int PostInsertIndexes (TRI_transaction_collection_t* trxCollection,
 
   for (size_t i = 1; i < n; ++i) {
     auto idx = indexes[i];
+    ConcurrentWriteLocker locker(document, idx->concurrentWriteLock());
     idx->postInsert(trxCollection, header);
   }
 
@@ -999,7 +1140,9 @@ static int InsertDocument (TRI_transaction_collection_t* trxCollection,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief looks up a document by key
-/// the caller must make sure the read lock on the collection is held
+/// the caller must make sure the read lock on the collection is held. if
+/// single-document write operations run concurrently, the caller must hold
+/// the primary index bucket lock for the key, too
 ////////////////////////////////////////////////////////////////////////////////
 
 static int LookupDocument (TRI_document_collection_t* document,
@@ -2162,6 +2305,235 @@ static bool InitDocumentCollection (TRI_document_collection_t* document,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rebuilds the primary index and the shaper from a checkpoint
+///
+/// the checkpoint must cover a prefix of the collection's datafiles (in
+/// iteration order), with unchanged sizes. the number of covered datafiles is
+/// returned in covered. if the checkpoint does not match the datafiles, the
+/// collection is not modified and covered is 0
+////////////////////////////////////////////////////////////////////////////////
+
+static int ApplyIndexCheckpoint (TRI_document_collection_t* document,
+                                 IndexCheckpoint const& checkpoint,
+                                 std::vector<TRI_datafile_t*> const& files,
+                                 size_t& covered) {
+  covered = 0;
+
+  auto const& datafiles = checkpoint.datafiles();
+
+  if (datafiles.empty() || datafiles.size() > files.size()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::unordered_map<TRI_voc_fid_t, TRI_datafile_t*> byFid;
+
+  for (size_t i = 0; i < datafiles.size(); ++i) {
+    TRI_datafile_t* datafile = files[i];
+
+    if (datafile->_fid != datafiles[i]._fid ||
+        datafile->_currentSize != datafiles[i]._size) {
+      LOG_INFO("index checkpoint for collection '%s' does not match datafile %llu, ignoring it",
+               document->_info._name,
+               (unsigned long long) datafile->_fid);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    byFid.emplace(datafile->_fid, datafile);
+  }
+
+  auto resolve = [&byFid] (TRI_voc_fid_t fid, TRI_voc_size_t offset) -> TRI_df_marker_t const* {
+    auto it = byFid.find(fid);
+
+    if (it == byFid.end()) {
+      return nullptr;
+    }
+
+    TRI_datafile_t const* datafile = (*it).second;
+
+    if (static_cast<uint64_t>(offset) + sizeof(TRI_df_marker_t) > datafile->_currentSize) {
+      return nullptr;
+    }
+
+    auto marker = reinterpret_cast<TRI_df_marker_t const*>(datafile->_data + offset);
+
+    if (marker->_size < sizeof(TRI_df_marker_t) ||
+        static_cast<uint64_t>(offset) + marker->_size > datafile->_currentSize) {
+      return nullptr;
+    }
+
+    return marker;
+  };
+
+  // validate all marker positions before modifying anything
+  auto const& documents = checkpoint.documents();
+  std::vector<TRI_doc_document_key_marker_t const*> markers;
+  markers.reserve(documents.size());
+
+  for (auto const& it : documents) {
+    auto marker = resolve(it._fid, it._offset);
+
+    if (marker == nullptr ||
+        (marker->_type != TRI_DOC_MARKER_KEY_DOCUMENT && marker->_type != TRI_DOC_MARKER_KEY_EDGE) ||
+        marker->_size < sizeof(TRI_doc_document_key_marker_t)) {
+      LOG_WARNING("index checkpoint for collection '%s' contains an invalid document position, ignoring it",
+                  document->_info._name);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    markers.emplace_back(reinterpret_cast<TRI_doc_document_key_marker_t const*>(marker));
+  }
+
+  std::vector<TRI_df_marker_t const*> shapeMarkers;
+  shapeMarkers.reserve(checkpoint.markers().size());
+
+  for (auto const& it : checkpoint.markers()) {
+    auto marker = resolve(it._fid, it._offset);
+
+    if (marker == nullptr ||
+        (marker->_type != TRI_DF_MARKER_SHAPE && marker->_type != TRI_DF_MARKER_ATTRIBUTE)) {
+      LOG_WARNING("index checkpoint for collection '%s' contains an invalid shape position, ignoring it",
+                  document->_info._name);
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    shapeMarkers.emplace_back(marker);
+  }
+
+  // from here on, errors cannot be recovered from
+  auto shaper = document->getShaper();  // ONLY IN OPENCOLLECTION, PROTECTED by fake trx in caller
+
+  for (auto marker : shapeMarkers) {
+    int res;
+
+    if (marker->_type == TRI_DF_MARKER_SHAPE) {
+      res = shaper->insertShape(marker, false);
+    }
+    else {
+      res = shaper->insertAttribute(marker, false);
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  auto primaryIndex = document->primaryIndex();
+
+  if (static_cast<int64_t>(markers.size()) > document->_info._initialCount) {
+    int res = primaryIndex->resize(static_cast<size_t>(markers.size() * 1.1));
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  for (size_t i = 0; i < markers.size(); ++i) {
+    auto marker = markers[i];
+    TRI_voc_key_t key = ((char*) marker) + marker->_offsetKey;
+    TRI_ASSERT(documents[i]._hash == PrimaryIndex::calculateHash(key));
+
+    document->_keyGenerator->track(key);
+
+    TRI_doc_mptr_t* header;
+    int res = CreateHeader(document, marker, documents[i]._fid, key, documents[i]._hash, &header);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    TRI_doc_mptr_t const* found;
+    res = primaryIndex->insertKey(header, (void const**) &found);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      document->_headersPtr->release(header, true);  // ONLY IN OPENITERATOR
+      return res;
+    }
+
+    ++document->_numberDocuments;
+  }
+
+  // restore the datafile statistics
+  for (auto const& it : datafiles) {
+    TRI_datafile_t* datafile = byFid[it._fid];
+
+    datafile->_tickMin = it._tickMin;
+    datafile->_tickMax = it._tickMax;
+    datafile->_dataMin = it._dataMin;
+    datafile->_dataMax = it._dataMax;
+
+    TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, it._fid, true);
+
+    if (dfi != nullptr) {
+      *dfi = it._info;
+    }
+  }
+
+  SetRevision(document, checkpoint.revision(), false);
+
+  if (checkpoint.tickMax() > document->_tickMax) {
+    document->_tickMax = checkpoint.tickMax();
+  }
+
+  covered = datafiles.size();
+
+  LOG_DEBUG("restored %llu documents of collection '%s' from index checkpoint",
+            (unsigned long long) markers.size(),
+            document->_info._name);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads the primary index checkpoint of the collection, if present
+///
+/// the checkpoint file is removed in any case, so it can never be used for a
+/// later state of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+static int LoadIndexCheckpoint (TRI_document_collection_t* document,
+                                std::vector<TRI_datafile_t*> const& files,
+                                size_t& covered) {
+  covered = 0;
+
+  try {
+    std::string const filename = IndexCheckpoint::filename(document);
+
+    if (! TRI_ExistsFile(filename.c_str())) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    IndexCheckpoint checkpoint;
+    int res = TRI_ERROR_NO_ERROR;
+    bool const enabled = document->_vocbase->_settings.indexCheckpoints;
+
+    if (enabled) {
+      res = checkpoint.read(filename);
+    }
+
+    TRI_UnlinkFile(filename.c_str());
+
+    if (! enabled) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      LOG_WARNING("ignoring index checkpoint '%s': %s",
+                  filename.c_str(),
+                  TRI_errno_string(res));
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    return ApplyIndexCheckpoint(document, checkpoint, files, covered);
+  }
+  catch (triagens::basics::Exception const& ex) {
+    return ex.code();
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief iterate all markers of the collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -2200,8 +2572,48 @@ static int IterateMarkersCollection (TRI_collection_t* collection) {
     return res;
   }
 
-  // read all documents and fill primary index
-  TRI_IterateCollection(collection, OpenIterator, &openState);
+  // all datafiles, in the same order as used by TRI_IterateCollection
+  std::vector<TRI_datafile_t*> files;
+
+  try {
+    for (auto vector : { &collection->_datafiles, &collection->_compactors, &collection->_journals }) {
+      for (size_t i = 0; i < vector->_length; ++i) {
+        files.emplace_back(static_cast<TRI_datafile_t*>(vector->_buffer[i]));
+      }
+    }
+  }
+  catch (...) {
+    TRI_DestroyVector(&openState._operations);
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  size_t covered = 0;
+  res = LoadIndexCheckpoint(document, files, covered);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_DestroyVector(&openState._operations);
+    return res;
+  }
+
+  if (covered == 0) {
+    // read all documents and fill primary index
+    TRI_IterateCollection(collection, OpenIterator, &openState);
+  }
+  else {
+    // only read the datafiles that are not covered by the checkpoint
+    for (size_t i = covered; i < files.size(); ++i) {
+      TRI_datafile_t* datafile = files[i];
+
+      if (! TRI_IterateDatafile(datafile, OpenIterator, &openState)) {
+        break;
+      }
+
+      if (datafile->isPhysical(datafile) && datafile->_isSealed) {
+        TRI_MMFileAdvise(datafile->_data, datafile->_maximalSize,
+                         TRI_MADVISE_RANDOM);
+      }
+    }
+  }
 
   LOG_TRACE("found %llu document markers, %llu deletion markers for collection '%s'",
             (unsigned long long) openState._documents,
@@ -3091,6 +3503,29 @@ int TRI_CloseDocumentCollection (TRI_document_collection_t* document,
     TRI_SaveCollectionInfo(document->_directory, &document->_info, doSync);
   }
 
+  if (document->_vocbase->_settings.indexCheckpoints &&
+      ! document->_info._deleted &&
+      ! triagens::wal::LogfileManager::instance()->isInRecovery()) {
+    TransactionBase trx(true);  // just to protect the following call
+
+    int res;
+    try {
+      res = IndexCheckpoint::write(document);
+    }
+    catch (triagens::basics::Exception const& ex) {
+      res = ex.code();
+    }
+    catch (...) {
+      res = TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      LOG_DEBUG("not writing index checkpoint for collection '%s': %s",
+                document->_info._name,
+                TRI_errno_string(res));
+    }
+  }
+
   // closes all open compactors, journals, datafiles
   int res = TRI_CloseCollection(document);
 
@@ -5047,11 +5482,16 @@ int TRI_RemoveShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    uint64_t const hash = document->primaryIndex()->calculateHash(key);
+
+    triagens::arango::DocumentWriteLocker documentLocker(trxCollection, hash, lock);
 
     triagens::wal::DocumentOperation operation(marker, freeMarker, trxCollection, TRI_VOC_DOCUMENT_OPERATION_REMOVE, rid);
 
-    res = LookupDocument(document, key, policy, header);
+    {
+      ConcurrentWriteLocker locker(document, document->primaryIndex()->bucketLock(hash));
+      res = LookupDocument(document, key, policy, header);
+    }
 
     if (res != TRI_ERROR_NO_ERROR) {
       return res;
@@ -5188,7 +5628,7 @@ int TRI_InsertShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    triagens::arango::DocumentWriteLocker documentLocker(trxCollection, hash, lock);
 
     triagens::wal::DocumentOperation operation(marker, freeMarker, trxCollection, TRI_VOC_DOCUMENT_OPERATION_INSERT, rid);
 
@@ -5272,11 +5712,16 @@ int TRI_UpdateShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
       return TRI_ERROR_DEBUG;
     }
 
-    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+    uint64_t const hash = document->primaryIndex()->calculateHash(key);
+
+    triagens::arango::DocumentWriteLocker documentLocker(trxCollection, hash, lock);
 
     // get the header pointer of the previous revision
     TRI_doc_mptr_t* oldHeader;
-    res = LookupDocument(document, key, policy, oldHeader);
+    {
+      ConcurrentWriteLocker locker(document, document->primaryIndex()->bucketLock(hash));
+      res = LookupDocument(document, key, policy, oldHeader);
+    }
 
     if (res != TRI_ERROR_NO_ERROR) {
       return res;
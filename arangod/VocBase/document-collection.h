@@ -33,8 +33,10 @@
 
 #include "Basics/Common.h"
 #include "Basics/fasthash.h"
+#include "Basics/ConditionVariable.h"
 #include "Basics/JsonHelper.h"
-#include "Basics/ReadWriteLockCPP11.h"
+#include "Basics/Mutex.h"
+#include "Basics/ReadWriteLockScalable.h"
 #include "VocBase/collection.h"
 #include "VocBase/Ditch.h"
 #include "VocBase/transaction.h"
@@ -59,6 +61,7 @@ namespace triagens {
   namespace arango {
     class CapConstraint;
     class EdgeIndex;
+    class EdgeSnapshotCache;
     class ExampleMatcher;
     class FulltextIndex;
     class GeoIndex2;
@@ -117,6 +120,12 @@ class KeyGenerator;
 #define TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
   a->_lock.unlock()
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of key locks per collection
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_DOCUMENT_COLLECTION_KEY_LOCKS 64
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -346,6 +355,11 @@ typedef struct TRI_doc_collection_info_s {
 
   TRI_voc_tick_t  _tickMax;
   uint64_t        _uncollectedLogfileEntries;
+
+  uint64_t        _lockReadWaits;
+  uint64_t        _lockWriteWaits;
+  double          _lockReadWaitTime;
+  double          _lockWriteWaitTime;
 }
 TRI_doc_collection_info_t;
 
@@ -362,7 +376,24 @@ struct TRI_document_collection_t : public TRI_collection_t {
   // ...........................................................................
 
   // TRI_read_write_lock_t        _lock;
-  triagens::basics::ReadWriteLockCPP11 _lock;
+  triagens::basics::ReadWriteLockScalable _lock;
+
+  // ...........................................................................
+  // single-document write operations share the write lock. the first of them
+  // acquires it for all, and the last one to finish releases it. operations on
+  // the same key are serialized by the key locks. the following attributes are
+  // protected by _concurrentWritersCondition
+  // ...........................................................................
+
+  triagens::basics::ConditionVariable    _concurrentWritersCondition;
+  int                                    _concurrentWriters;
+  bool                                   _concurrentWriteAcquiring;
+  std::atomic<bool>                      _concurrentWriting;
+
+  triagens::basics::Mutex                _keyLocks[TRI_DOCUMENT_COLLECTION_KEY_LOCKS];
+
+  // protects the collection revision while write operations run concurrently
+  triagens::basics::Mutex                _revisionLock;
 
 
 private:
@@ -401,8 +432,15 @@ public:
   triagens::arango::EdgeIndex* edgeIndex ();
   triagens::arango::CapConstraint* capConstraint ();
 
+  triagens::arango::EdgeSnapshotCache* edgeSnapshots () {
+    return _edgeSnapshots;
+  }
+
   triagens::arango::CapConstraint*       _capConstraint;
 
+  // adjacency snapshot for traversals, only used for edge collections
+  triagens::arango::EdgeSnapshotCache*   _edgeSnapshots;
+
   triagens::arango::Ditches* ditches () {
     return &_ditches;
   }
@@ -418,7 +456,7 @@ public:
   std::set<TRI_voc_tid_t>*               _failedTransactions;
 
   std::atomic<int64_t>                   _uncollectedLogfileEntries;
-  int64_t                                _numberDocuments;
+  std::atomic<int64_t>                   _numberDocuments;
   TRI_read_write_lock_t                  _compactionLock;
   double                                 _lastCompaction;
 
@@ -441,6 +479,20 @@ public:
   int beginReadTimed (uint64_t, uint64_t);
   int beginWriteTimed (uint64_t, uint64_t);
 
+  bool beginConcurrentWrite ();
+  void endConcurrentWrite ();
+
+  // whether single-document write operations currently share the write lock
+  inline bool isConcurrentWriting () const {
+    return _concurrentWriting.load();
+  }
+
+  inline triagens::basics::Mutex& keyLock (uint64_t hash) {
+    // the primary index buckets are selected by the lowest bits of the hash,
+    // so use the highest bits here
+    return _keyLocks[(hash >> 32) % TRI_DOCUMENT_COLLECTION_KEY_LOCKS];
+  }
+
   TRI_doc_collection_info_t* figures ();
 
   uint64_t size ();
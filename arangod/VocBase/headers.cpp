@@ -30,6 +30,7 @@
 #include "headers.h"
 
 #include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
 #include "VocBase/document-collection.h"
 
 // -----------------------------------------------------------------------------
@@ -105,6 +106,8 @@ void TRI_headers_t::moveBack (TRI_doc_mptr_t* header,
     return;
   }
 
+  MUTEX_LOCKER(_lock);
+
   TRI_ASSERT(_nrAllocated > 0);
   TRI_ASSERT(_nrLinked > 0);
   TRI_ASSERT(_totalSize > 0);
@@ -164,54 +167,8 @@ void TRI_headers_t::moveBack (TRI_doc_mptr_t* header,
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_headers_t::unlink (TRI_doc_mptr_t* header) {
-  int64_t size;
-
-  TRI_ASSERT(header != nullptr);
-  TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
-  TRI_ASSERT(header->_prev != header);
-  TRI_ASSERT(header->_next != header);
-
-  size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
-  TRI_ASSERT(size > 0);
-
-  // unlink the header
-  if (header->_prev != nullptr) {
-    header->_prev->_next = header->_next;
-  }
-
-  if (header->_next != nullptr) {
-    header->_next->_prev = header->_prev;
-  }
-
-  // adjust begin & end pointers
-  if (_begin == header) {
-    _begin = header->_next;
-  }
-
-  if (_end == header) {
-    _end = header->_prev;
-  }
-
-  TRI_ASSERT(_begin != header);
-  TRI_ASSERT(_end != header);
-
-  TRI_ASSERT(_nrLinked > 0);
-  _nrLinked--;
-  _totalSize -= TRI_DF_ALIGN_BLOCK(size);
-
-  if (_nrLinked == 0) {
-    TRI_ASSERT(_begin == nullptr);
-    TRI_ASSERT(_end == nullptr);
-    TRI_ASSERT(_totalSize == 0);
-  }
-  else {
-    TRI_ASSERT(_begin != nullptr);
-    TRI_ASSERT(_end != nullptr);
-    TRI_ASSERT(_totalSize > 0);
-  }
-
-  TRI_ASSERT(header->_prev != header);
-  TRI_ASSERT(header->_next != header);
+  MUTEX_LOCKER(_lock);
+  unlinkInternal(header);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -221,77 +178,48 @@ void TRI_headers_t::unlink (TRI_doc_mptr_t* header) {
 
 void TRI_headers_t::move (TRI_doc_mptr_t* header,
                           TRI_doc_mptr_t* old) {
+  MUTEX_LOCKER(_lock);
+  moveInternal(header, old);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves a header back into the list, using its previous position
+/// (specified in "old")
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::relink (TRI_doc_mptr_t* header,
+                            TRI_doc_mptr_t* old) {
   if (header == nullptr) {
     return;
   }
 
-  TRI_ASSERT(_nrAllocated > 0);
-  TRI_ASSERT(header->_prev != header);
-  TRI_ASSERT(header->_next != header);
   TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
-  TRI_ASSERT(((TRI_df_marker_t*) header->getDataPtr())->_size > 0); // ONLY IN HEADERS, PROTECTED by RUNTIME
-  TRI_ASSERT(old != nullptr);
-  TRI_ASSERT(old->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
 
-  int64_t newSize = (int64_t) (((TRI_df_marker_t*) header->getDataPtr())->_size); // ONLY IN HEADERS, PROTECTED by RUNTIME
-  int64_t oldSize = (int64_t) (((TRI_df_marker_t*) old->getDataPtr())->_size); // ONLY IN HEADERS, PROTECTED by RUNTIME
-
-  // Please note the following: This operation is only used to revert an
-  // update operation. The "new" document is removed again and the "old"
-  // one is used once more. Therefore, the signs in the following statement
-  // are actually OK:
-  _totalSize -= (  TRI_DF_ALIGN_BLOCK(newSize)
-                 - TRI_DF_ALIGN_BLOCK(oldSize));
-
-  // adjust list start and end pointers
-  if (old->_prev == nullptr) {
-    _begin = header;
-  }
-  else if (_begin == header) {
-    if (old->_prev != nullptr) {
-      _begin = old->_prev;
-    }
-  }
-
-  if (old->_next == nullptr) {
-    _end = header;
-  }
-  else if (_end == header) {
-    if (old->_next != nullptr) {
-      _end = old->_next;
-    }
-  }
+  int64_t size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(size > 0);
 
-  if (header->_prev != nullptr) {
-    header->_prev->_next = header->_next;
-  }
-  if (header->_next != nullptr) {
-    header->_next->_prev = header->_prev;
-  }
+  MUTEX_LOCKER(_lock);
 
-  if (old->_prev != nullptr) {
-    old->_prev->_next = header;
-  }
-  if (old->_next != nullptr) {
-    old->_next->_prev = header;
-  }
+  TRI_ASSERT(_begin != header);
+  TRI_ASSERT(_end != header);
 
-  header->_prev = old->_prev;
-  header->_next = old->_next;
+  moveInternal(header, old);
+  _nrLinked++;
+  _totalSize += TRI_DF_ALIGN_BLOCK(size);
+  TRI_ASSERT(_totalSize > 0);
 
-  TRI_ASSERT(_begin != nullptr);
-  TRI_ASSERT(_end != nullptr);
   TRI_ASSERT(header->_prev != header);
   TRI_ASSERT(header->_next != header);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief moves a header back into the list, using its previous position
-/// (specified in "old")
+/// @brief moves a header back into the list, at its end
+/// this is used to revert a remove operation when other operations may have
+/// modified the list in the meantime, so the old neighbours of the header
+/// cannot be relied upon
 ////////////////////////////////////////////////////////////////////////////////
 
-void TRI_headers_t::relink (TRI_doc_mptr_t* header,
-                            TRI_doc_mptr_t* old) {
+void TRI_headers_t::relinkBack (TRI_doc_mptr_t* header) {
   if (header == nullptr) {
     return;
   }
@@ -301,16 +229,28 @@ void TRI_headers_t::relink (TRI_doc_mptr_t* header,
   int64_t size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
   TRI_ASSERT(size > 0);
 
+  MUTEX_LOCKER(_lock);
+
   TRI_ASSERT(_begin != header);
   TRI_ASSERT(_end != header);
 
-  this->move(header, old);
+  if (_begin == nullptr) {
+    _begin = header;
+    _end   = header;
+
+    header->_prev = nullptr;
+    header->_next = nullptr;
+  }
+  else {
+    _end->_next   = header;
+    header->_prev = _end;
+    header->_next = nullptr;
+    _end          = header;
+  }
+
   _nrLinked++;
   _totalSize += TRI_DF_ALIGN_BLOCK(size);
   TRI_ASSERT(_totalSize > 0);
-
-  TRI_ASSERT(header->_prev != header);
-  TRI_ASSERT(header->_next != header);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -322,6 +262,8 @@ TRI_doc_mptr_t* TRI_headers_t::request (size_t size) {
 
   TRI_ASSERT(size > 0);
 
+  MUTEX_LOCKER(_lock);
+
   if (_freelist == nullptr) {
     size_t blockSize = GetBlockSize(_blocks.size());
     TRI_ASSERT(blockSize > 0);
@@ -413,8 +355,10 @@ void TRI_headers_t::release (TRI_doc_mptr_t* header,
     return;
   }
 
+  MUTEX_LOCKER(_lock);
+
   if (unlinkHeader) {
-    this->unlink(header);
+    unlinkInternal(header);
   }
 
   header->clear();
@@ -452,10 +396,141 @@ void TRI_headers_t::adjustTotalSize (int64_t oldSize,
   // oldSize = size of marker in WAL
   // newSize = size of marker in datafile
 
+  MUTEX_LOCKER(_lock);
+
   _totalSize -= (  TRI_DF_ALIGN_BLOCK(oldSize) 
                  - TRI_DF_ALIGN_BLOCK(newSize));
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlinks a header from the linked list, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::unlinkInternal (TRI_doc_mptr_t* header) {
+  int64_t size;
+
+  TRI_ASSERT(header != nullptr);
+  TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(header->_prev != header);
+  TRI_ASSERT(header->_next != header);
+
+  size = (int64_t) ((TRI_df_marker_t*) header->getDataPtr())->_size; // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(size > 0);
+
+  // unlink the header
+  if (header->_prev != nullptr) {
+    header->_prev->_next = header->_next;
+  }
+
+  if (header->_next != nullptr) {
+    header->_next->_prev = header->_prev;
+  }
+
+  // adjust begin & end pointers
+  if (_begin == header) {
+    _begin = header->_next;
+  }
+
+  if (_end == header) {
+    _end = header->_prev;
+  }
+
+  TRI_ASSERT(_begin != header);
+  TRI_ASSERT(_end != header);
+
+  TRI_ASSERT(_nrLinked > 0);
+  _nrLinked--;
+  _totalSize -= TRI_DF_ALIGN_BLOCK(size);
+
+  if (_nrLinked == 0) {
+    TRI_ASSERT(_begin == nullptr);
+    TRI_ASSERT(_end == nullptr);
+    TRI_ASSERT(_totalSize == 0);
+  }
+  else {
+    TRI_ASSERT(_begin != nullptr);
+    TRI_ASSERT(_end != nullptr);
+    TRI_ASSERT(_totalSize > 0);
+  }
+
+  TRI_ASSERT(header->_prev != header);
+  TRI_ASSERT(header->_next != header);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves a header around in the list, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_headers_t::moveInternal (TRI_doc_mptr_t* header,
+                                  TRI_doc_mptr_t* old) {
+  if (header == nullptr) {
+    return;
+  }
+
+  TRI_ASSERT(_nrAllocated > 0);
+  TRI_ASSERT(header->_prev != header);
+  TRI_ASSERT(header->_next != header);
+  TRI_ASSERT(header->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(((TRI_df_marker_t*) header->getDataPtr())->_size > 0); // ONLY IN HEADERS, PROTECTED by RUNTIME
+  TRI_ASSERT(old != nullptr);
+  TRI_ASSERT(old->getDataPtr() != nullptr); // ONLY IN HEADERS, PROTECTED by RUNTIME
+
+  int64_t newSize = (int64_t) (((TRI_df_marker_t*) header->getDataPtr())->_size); // ONLY IN HEADERS, PROTECTED by RUNTIME
+  int64_t oldSize = (int64_t) (((TRI_df_marker_t*) old->getDataPtr())->_size); // ONLY IN HEADERS, PROTECTED by RUNTIME
+
+  // Please note the following: This operation is only used to revert an
+  // update operation. The "new" document is removed again and the "old"
+  // one is used once more. Therefore, the signs in the following statement
+  // are actually OK:
+  _totalSize -= (  TRI_DF_ALIGN_BLOCK(newSize)
+                 - TRI_DF_ALIGN_BLOCK(oldSize));
+
+  // adjust list start and end pointers
+  if (old->_prev == nullptr) {
+    _begin = header;
+  }
+  else if (_begin == header) {
+    if (old->_prev != nullptr) {
+      _begin = old->_prev;
+    }
+  }
+
+  if (old->_next == nullptr) {
+    _end = header;
+  }
+  else if (_end == header) {
+    if (old->_next != nullptr) {
+      _end = old->_next;
+    }
+  }
+
+  if (header->_prev != nullptr) {
+    header->_prev->_next = header->_next;
+  }
+  if (header->_next != nullptr) {
+    header->_next->_prev = header->_prev;
+  }
+
+  if (old->_prev != nullptr) {
+    old->_prev->_next = header;
+  }
+  if (old->_next != nullptr) {
+    old->_next->_prev = header;
+  }
+
+  header->_prev = old->_prev;
+  header->_next = old->_next;
+
+  TRI_ASSERT(_begin != nullptr);
+  TRI_ASSERT(_end != nullptr);
+  TRI_ASSERT(header->_prev != header);
+  TRI_ASSERT(header->_next != header);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 #define ARANGODB_VOC_BASE_HEADERS_H 1
 
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
 #include "VocBase/document-collection.h"
 
 // -----------------------------------------------------------------------------
@@ -104,6 +105,12 @@ class TRI_headers_t {
 
     void relink (TRI_doc_mptr_t*, TRI_doc_mptr_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief relink an existing header into the linked list, at its end
+////////////////////////////////////////////////////////////////////////////////
+
+    void relinkBack (TRI_doc_mptr_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief request a new header
 ////////////////////////////////////////////////////////////////////////////////
@@ -159,12 +166,35 @@ class TRI_headers_t {
       return _totalSize;
     }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+  private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlink an existing header, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+    void unlinkInternal (TRI_doc_mptr_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief move an existing header, the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+    void moveInternal (TRI_doc_mptr_t*, TRI_doc_mptr_t*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
 
   private:
 
+    // protects the list and the freelist. the headers are modified while
+    // holding the collection's write lock, but single-document write
+    // operations may share the write lock
+    triagens::basics::Mutex       _lock;
+
     TRI_doc_mptr_t const*         _freelist;    // free headers
 
     TRI_doc_mptr_t*               _begin;       // start pointer to list of allocated headers
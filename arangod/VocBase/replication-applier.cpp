@@ -158,6 +158,11 @@ static TRI_json_t* JsonConfiguration (TRI_replication_applier_configuration_t co
                        "chunkSize",
                        TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) config->_chunkSize));
 
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
+                       json,
+                       "parallelism",
+                       TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) config->_parallelism));
+
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
                        json,
                        "autoStart",
@@ -168,6 +173,11 @@ static TRI_json_t* JsonConfiguration (TRI_replication_applier_configuration_t co
                        "adaptivePolling",
                        TRI_CreateBooleanJson(TRI_CORE_MEM_ZONE, config->_adaptivePolling));
   
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
+                       json,
+                       "binaryFormat",
+                       TRI_CreateBooleanJson(TRI_CORE_MEM_ZONE, config->_binaryFormat));
+  
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
                        json,
                        "includeSystem",
@@ -311,6 +321,12 @@ static int LoadConfiguration (TRI_vocbase_t* vocbase,
     config->_chunkSize = (uint64_t) value->_value._number;
   }
 
+  value = TRI_LookupObjectJson(json.get(), "parallelism");
+
+  if (TRI_IsNumberJson(value)) {
+    config->_parallelism = (uint64_t) value->_value._number;
+  }
+
   value = TRI_LookupObjectJson(json.get(), "autoStart");
 
   if (TRI_IsBooleanJson(value)) {
@@ -323,6 +339,12 @@ static int LoadConfiguration (TRI_vocbase_t* vocbase,
     config->_adaptivePolling = value->_value._boolean;
   }
   
+  value = TRI_LookupObjectJson(json.get(), "binaryFormat");
+
+  if (TRI_IsBooleanJson(value)) {
+    config->_binaryFormat = value->_value._boolean;
+  }
+  
   value = TRI_LookupObjectJson(json.get(), "includeSystem");
 
   if (TRI_IsBooleanJson(value)) {
@@ -526,6 +548,19 @@ static TRI_json_t* JsonState (TRI_replication_applier_state_t const* state) {
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "totalEvents", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_totalEvents));
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "totalOperationsExcluded", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_skippedOperations));
 
+  // replication lag. the master's ticks are not timestamps, so the time we are
+  // behind is measured from when we first saw a master tick not yet applied
+  TRI_voc_tick_t ticksBehind = 0;
+  if (state->_lastAvailableContinuousTick > state->_lastAppliedContinuousTick) {
+    ticksBehind = state->_lastAvailableContinuousTick - state->_lastAppliedContinuousTick;
+  }
+  double secondsBehind = 0.0;
+  if (ticksBehind > 0 && state->_lagSince > 0.0) {
+    secondsBehind = TRI_microtime() - state->_lagSince;
+  }
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "ticksBehind", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) ticksBehind));
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "secondsBehind", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, secondsBehind));
+
   // lastError
   error = TRI_CreateObjectJson(TRI_CORE_MEM_ZONE);
 
@@ -660,6 +695,8 @@ int TRI_StateReplicationApplier (TRI_replication_applier_t* applier,
   state->_lastProcessedContinuousTick = applier->_state._lastProcessedContinuousTick;
   state->_lastAvailableContinuousTick = applier->_state._lastAvailableContinuousTick;
   state->_safeResumeTick              = applier->_state._safeResumeTick;
+  state->_lagTick                     = applier->_state._lagTick;
+  state->_lagSince                    = applier->_state._lagSince;
   state->_serverId                    = applier->_state._serverId;
   state->_lastError._code             = applier->_state._lastError._code;
   state->_failedConnects              = applier->_state._failedConnects;
@@ -920,9 +957,11 @@ void TRI_InitConfigurationReplicationApplier (TRI_replication_applier_configurat
   config->_ignoreErrors        = 0;
   config->_maxConnectRetries   = 100;
   config->_chunkSize           = 0;
+  config->_parallelism         = 1;
   config->_sslProtocol         = 0;
   config->_autoStart           = false;
   config->_adaptivePolling     = true;
+  config->_binaryFormat        = false;
   config->_includeSystem       = true;
   config->_requireFromPresent  = false;
   config->_verbose             = false;
@@ -996,8 +1035,10 @@ void TRI_CopyConfigurationReplicationApplier (TRI_replication_applier_configurat
   dst->_maxConnectRetries   = src->_maxConnectRetries;
   dst->_sslProtocol         = src->_sslProtocol;
   dst->_chunkSize           = src->_chunkSize;
+  dst->_parallelism         = src->_parallelism;
   dst->_autoStart           = src->_autoStart;
   dst->_adaptivePolling     = src->_adaptivePolling;
+  dst->_binaryFormat        = src->_binaryFormat;
   dst->_includeSystem       = src->_includeSystem;
   dst->_requireFromPresent  = src->_requireFromPresent;
   dst->_verbose             = src->_verbose;
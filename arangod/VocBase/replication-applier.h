@@ -67,9 +67,11 @@ typedef struct TRI_replication_applier_configuration_s {
   uint64_t      _ignoreErrors;
   uint64_t      _maxConnectRetries;
   uint64_t      _chunkSize;
+  uint64_t      _parallelism;
   uint32_t      _sslProtocol;
   bool          _autoStart;
   bool          _adaptivePolling;
+  bool          _binaryFormat;
   bool          _includeSystem;
   bool          _requireFromPresent;
   bool          _verbose;
@@ -98,6 +100,8 @@ struct TRI_replication_applier_state_t {
   TRI_voc_tick_t                           _lastAppliedContinuousTick;
   TRI_voc_tick_t                           _lastAvailableContinuousTick;
   TRI_voc_tick_t                           _safeResumeTick;
+  TRI_voc_tick_t                           _lagTick;
+  double                                   _lagSince;
   bool                                     _active;
   bool                                     _preventStart;
   char*                                    _progressMsg;
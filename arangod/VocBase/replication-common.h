@@ -71,6 +71,24 @@
 
 #define TRI_REPLICATION_HEADER_ACTIVE    "x-arango-replication-active"
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief HTTP content type of the binary replication log format
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REPLICATION_CONTENT_TYPE_BINARY "application/x-arango-dump-binary"
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief version of the binary replication log format
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REPLICATION_BINARY_VERSION 1
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief byte order marker of the binary replication log format
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REPLICATION_BINARY_BYTE_ORDER 0x01020304
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -105,6 +123,49 @@ typedef enum {
 }
 TRI_replication_operation_e;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief record types of the binary replication log format
+///
+/// The binary format is a sequence of records. Each record starts with
+///
+///   - the length of the record in bytes, including this header [uint32_t]
+///   - the record type [uint8_t]
+///
+/// followed by the data for the record type:
+///
+///   - HEADER: format version [uint8_t], byte order marker [uint32_t], word
+///     size [uint8_t]. This is always the first record of a response
+///   - COLLECTION: collection id [uint64_t], collection name (rest of record)
+///   - ATTRIBUTE: collection id [uint64_t], attribute id [uint64_t],
+///     attribute name (rest of record)
+///   - SHAPE: collection id [uint64_t], shape (rest of record)
+///   - DOCUMENT: operation type [uint16_t], tick, transaction id, collection
+///     id, revision id [uint64_t each], key. Edges then have from and to
+///     collection ids [uint64_t each], from key and to key. Documents and
+///     edges then have the number of padding bytes [uint8_t], the padding,
+///     the shape id [uint64_t] and the shaped data (rest of record). The
+///     padding aligns the shaped data to 8 bytes from the start of the stream
+///   - JSON: any other operation in the JSON format, followed by a NUL byte
+///
+/// Keys are stored as length [uint16_t] plus characters. Collection names,
+/// attributes and shapes are sent once per response, before the first record
+/// that needs them. Attribute and shape ids are those of the collection's
+/// shaper on the master. Numbers and shapes are sent in the master's byte
+/// order, so master and slave must use the same architecture. Slaves check
+/// the header record for this and fall back to the JSON format if it does not
+/// match their own.
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+  REPLICATION_BINARY_COLLECTION      = 1,
+  REPLICATION_BINARY_ATTRIBUTE       = 2,
+  REPLICATION_BINARY_SHAPE           = 3,
+  REPLICATION_BINARY_DOCUMENT        = 4,
+  REPLICATION_BINARY_JSON            = 5,
+  REPLICATION_BINARY_HEADER          = 6
+}
+TRI_replication_binary_record_e;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include "VocBase/collection.h"
 #include "VocBase/datafile.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/Legends.h"
 #include "VocBase/server.h"
 #include "VocBase/transaction.h"
 #include "VocBase/vocbase.h"
@@ -970,6 +971,305 @@ static int StringifyWalMarker (TRI_replication_dump_t* dump,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a value in binary form to a string buffer
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static inline int AppendBinaryValue (TRI_string_buffer_t* buffer,
+                                     T value) {
+  return TRI_AppendString2StringBuffer(buffer, reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a value in binary form to a string-buffer or fail
+////////////////////////////////////////////////////////////////////////////////
+
+#define APPEND_BINARY(buffer, val)  FAIL_IFNOT(AppendBinaryValue, buffer, val)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a key in binary form (length plus characters)
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBinaryKey (TRI_string_buffer_t* buffer,
+                            char const* key) {
+  size_t const length = strlen(key);
+  TRI_ASSERT(length <= UINT16_MAX);
+
+  APPEND_BINARY(buffer, static_cast<uint16_t>(length));
+  return TRI_AppendString2StringBuffer(buffer, key, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief start a record in the binary format
+/// the length of the record is written when the record is finished
+////////////////////////////////////////////////////////////////////////////////
+
+static int BeginBinaryRecord (TRI_replication_dump_t* dump,
+                              TRI_replication_binary_record_e type,
+                              size_t& start) {
+  start = TRI_LengthStringBuffer(dump->_buffer);
+
+  APPEND_BINARY(dump->_buffer, static_cast<uint32_t>(0));
+  APPEND_BINARY(dump->_buffer, static_cast<uint8_t>(type));
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish a record in the binary format
+////////////////////////////////////////////////////////////////////////////////
+
+static void EndBinaryRecord (TRI_replication_dump_t* dump,
+                             size_t start) {
+  uint32_t const length = static_cast<uint32_t>(TRI_LengthStringBuffer(dump->_buffer) - start);
+  memcpy(dump->_buffer->_buffer + start, &length, sizeof(uint32_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the header record of the binary format, so the slave can
+/// check that it understands the data
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBinaryHeader (TRI_replication_dump_t* dump) {
+  size_t start;
+  int res = BeginBinaryRecord(dump, REPLICATION_BINARY_HEADER, start);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  APPEND_BINARY(dump->_buffer, static_cast<uint8_t>(TRI_REPLICATION_BINARY_VERSION));
+  APPEND_BINARY(dump->_buffer, static_cast<uint32_t>(TRI_REPLICATION_BINARY_BYTE_ORDER));
+  APPEND_BINARY(dump->_buffer, static_cast<uint8_t>(sizeof(size_t)));
+
+  EndBinaryRecord(dump, start);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the collection name for a binary record, if it was not yet
+/// sent in this response
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBinaryCollection (TRI_replication_dump_t* dump,
+                                   TRI_voc_cid_t cid) {
+  if (dump->_binaryCollections.find(cid) != dump->_binaryCollections.end()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  size_t start;
+  int res = BeginBinaryRecord(dump, REPLICATION_BINARY_COLLECTION, start);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(cid));
+
+  char const* cname = NameFromCid(dump, cid);
+
+  if (cname != nullptr) {
+    APPEND_STRING(dump->_buffer, cname);
+  }
+
+  EndBinaryRecord(dump, start);
+  dump->_binaryCollections.emplace(cid);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the attributes and shapes of a legend that were not yet sent
+/// for the collection in this response
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBinaryLegend (TRI_replication_dump_t* dump,
+                               TRI_voc_cid_t cid,
+                               triagens::basics::LegendReader const& legend) {
+  auto& attributes = dump->_binaryAttributes[cid];
+
+  for (TRI_shape_size_t i = 0; i < legend.numberAttributes(); ++i) {
+    TRI_shape_aid_t const aid = legend.attributeIdAt(i);
+
+    if (attributes.find(aid) != attributes.end()) {
+      continue;
+    }
+
+    size_t start;
+    int res = BeginBinaryRecord(dump, REPLICATION_BINARY_ATTRIBUTE, start);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(cid));
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(aid));
+    APPEND_STRING(dump->_buffer, legend.attributeNameAt(i));
+
+    EndBinaryRecord(dump, start);
+    attributes.emplace(aid);
+  }
+
+  auto& shapes = dump->_binaryShapes[cid];
+
+  for (TRI_shape_size_t i = 0; i < legend.numberShapes(); ++i) {
+    TRI_shape_t const* shape = legend.shapeAt(i);
+
+    if (shapes.find(shape->_sid) != shapes.end()) {
+      continue;
+    }
+
+    size_t start;
+    int res = BeginBinaryRecord(dump, REPLICATION_BINARY_SHAPE, start);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(cid));
+
+    res = TRI_AppendString2StringBuffer(dump->_buffer, reinterpret_cast<char const*>(shape), static_cast<size_t>(shape->_size));
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    EndBinaryRecord(dump, start);
+    shapes.emplace(shape->_sid);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a raw marker from a WAL logfile in the binary format
+/// documents, edges and removals are sent as binary records. a document or
+/// edge is sent with its shaped data as is, with the attributes and shapes it
+/// needs taken from the marker's legend. all other markers, and documents
+/// without a legend, are sent as JSON records
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBinaryWalMarker (TRI_replication_dump_t* dump,
+                                  TRI_df_marker_t const* marker) {
+  TRI_ASSERT_EXPENSIVE(MustReplicateWalMarkerType(marker));
+
+  char const* legend = nullptr;
+
+  if (marker->_type == TRI_WAL_MARKER_DOCUMENT ||
+      marker->_type == TRI_WAL_MARKER_EDGE) {
+    auto m = reinterpret_cast<triagens::wal::document_marker_t const*>(marker);
+
+    legend = reinterpret_cast<char const*>(m) + m->_offsetLegend;
+
+    if (*reinterpret_cast<uint64_t const*>(legend) == 0ULL) {
+      // marker has no legend
+      legend = nullptr;
+    }
+    else if (m->_offsetJson - m->_offsetLegend == 8) {
+      // legend is in another marker
+      legend += *reinterpret_cast<int64_t const*>(legend);
+    }
+  }
+
+  size_t start;
+  int res;
+
+  if (marker->_type == TRI_WAL_MARKER_REMOVE ||
+      legend != nullptr) {
+    // document, edge or removal. all have the same context data
+    TRI_voc_cid_t cid;
+    TRI_voc_rid_t rid;
+    TRI_voc_tid_t tid;
+    char const* key;
+
+    if (marker->_type == TRI_WAL_MARKER_REMOVE) {
+      auto m = reinterpret_cast<triagens::wal::remove_marker_t const*>(marker);
+      cid = m->_collectionId;
+      rid = m->_revisionId;
+      tid = m->_transactionId;
+      key = reinterpret_cast<char const*>(m) + sizeof(triagens::wal::remove_marker_t);
+    }
+    else {
+      auto m = reinterpret_cast<triagens::wal::document_marker_t const*>(marker);
+      cid = m->_collectionId;
+      rid = m->_revisionId;
+      tid = m->_transactionId;
+      key = reinterpret_cast<char const*>(m) + m->_offsetKey;
+    }
+
+    res = AppendBinaryCollection(dump, cid);
+
+    if (res == TRI_ERROR_NO_ERROR && legend != nullptr) {
+      triagens::basics::LegendReader legendReader(legend);
+      res = AppendBinaryLegend(dump, cid, legendReader);
+    }
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      res = BeginBinaryRecord(dump, REPLICATION_BINARY_DOCUMENT, start);
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    APPEND_BINARY(dump->_buffer, static_cast<uint16_t>(TranslateType(marker)));
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(marker->_tick));
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(tid));
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(cid));
+    APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(rid));
+    FAIL_IFNOT(AppendBinaryKey, dump->_buffer, key);
+
+    if (marker->_type == TRI_WAL_MARKER_EDGE) {
+      auto e = reinterpret_cast<triagens::wal::edge_marker_t const*>(marker);
+
+      APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(e->_fromCid));
+      APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(e->_toCid));
+      FAIL_IFNOT(AppendBinaryKey, dump->_buffer, reinterpret_cast<char const*>(e) + e->_offsetFromKey);
+      FAIL_IFNOT(AppendBinaryKey, dump->_buffer, reinterpret_cast<char const*>(e) + e->_offsetToKey);
+    }
+
+    if (legend != nullptr) {
+      auto m = reinterpret_cast<triagens::wal::document_marker_t const*>(marker);
+
+      // pad so that the shaped data starts at an 8-byte boundary
+      size_t const offset = TRI_LengthStringBuffer(dump->_buffer) + sizeof(uint8_t) + sizeof(uint64_t);
+      uint8_t const padding = static_cast<uint8_t>((8 - (offset % 8)) % 8);
+
+      APPEND_BINARY(dump->_buffer, padding);
+      for (uint8_t i = 0; i < padding; ++i) {
+        APPEND_CHAR(dump->_buffer, '\0');
+      }
+
+      APPEND_BINARY(dump->_buffer, static_cast<uint64_t>(m->_shape));
+
+      res = TRI_AppendString2StringBuffer(dump->_buffer, reinterpret_cast<char const*>(m) + m->_offsetJson, m->_size - m->_offsetJson);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+  }
+  else {
+    res = BeginBinaryRecord(dump, REPLICATION_BINARY_JSON, start);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      res = StringifyWalMarker(dump, marker);
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    APPEND_CHAR(dump->_buffer, '\0');
+  }
+
+  EndBinaryRecord(dump, start);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief helper function to extract a database id from a marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -1460,6 +1760,14 @@ int TRI_DumpLogReplication (TRI_replication_dump_t* dump,
   try {
     bool first = true;
 
+    if (dump->_binary) {
+      res = AppendBinaryHeader(dump);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
+    }
+
     // iterate over the datafiles found
     size_t const n = logfiles.size();
 
@@ -1513,7 +1821,12 @@ int TRI_DumpLogReplication (TRI_replication_dump_t* dump,
           }
         }
   
-        res = StringifyWalMarker(dump, marker);
+        if (dump->_binary) {
+          res = AppendBinaryWalMarker(dump, marker);
+        }
+        else {
+          res = StringifyWalMarker(dump, marker);
+        }
 
         if (res != TRI_ERROR_NO_ERROR) {
           THROW_ARANGO_EXCEPTION(res);
@@ -73,7 +73,8 @@ struct TRI_replication_dump_t {
       _bufferFull(false),
       _hasMore(false),
       _includeSystem(includeSystem),
-      _fromTickIncluded(false) {
+      _fromTickIncluded(false),
+      _binary(false) {
  
     if (_chunkSize == 0) {
       // default chunk size
@@ -106,6 +107,10 @@ struct TRI_replication_dump_t {
   bool                         _hasMore;
   bool                         _includeSystem;
   bool                         _fromTickIncluded;
+  bool                         _binary;
+  std::unordered_set<TRI_voc_cid_t> _binaryCollections;
+  std::unordered_map<TRI_voc_cid_t, std::unordered_set<TRI_shape_aid_t>> _binaryAttributes;
+  std::unordered_map<TRI_voc_cid_t, std::unordered_set<TRI_shape_sid_t>> _binaryShapes;
 };
 
 // -----------------------------------------------------------------------------
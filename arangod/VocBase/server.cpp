@@ -50,6 +50,7 @@
 #include "Basics/random.h"
 #include "Basics/SpinLock.h"
 #include "Basics/SpinLocker.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/tri-strings.h"
 #include "Cluster/ServerState.h"
 #include "Utils/CursorRepository.h"
@@ -1967,6 +1968,96 @@ int TRI_InitDatabasesServer (TRI_server_t* server) {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads the specified collections of all databases in parallel
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_PreloadCollectionsServer (TRI_server_t* server,
+                                  std::vector<std::string> const& patterns) {
+  if (patterns.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  auto matches = [&patterns] (std::string const& database,
+                              std::string const& collection) -> bool {
+    for (auto const& pattern : patterns) {
+      if (pattern == "*" ||
+          pattern == collection ||
+          pattern == database + "/*" ||
+          pattern == database + "/" + collection) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  double const start = TRI_microtime();
+
+  auto unuser(server->_databasesProtector.use());
+  auto theLists = server->_databasesLists.load();
+
+  std::vector<std::pair<TRI_vocbase_t*, TRI_vocbase_col_t*>> work;
+
+  for (auto& p : theLists->_databases) {
+    TRI_vocbase_t* vocbase = p.second;
+    TRI_ASSERT(vocbase != nullptr);
+
+    for (auto collection : TRI_CollectionsVocBase(vocbase)) {
+      if (matches(vocbase->_name, collection->_name)) {
+        work.emplace_back(vocbase, collection);
+      }
+    }
+  }
+
+  if (work.empty()) {
+    LOG_WARNING("no collections found to preload");
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // collections are handed out one at a time, so a single big collection
+  // does not hold up the others
+  std::atomic<size_t> next(0);
+  std::atomic<size_t> failed(0);
+
+  auto load = [&work, &next, &failed] () -> void {
+    while (true) {
+      size_t const i = next++;
+
+      if (i >= work.size()) {
+        return;
+      }
+
+      TRI_vocbase_t* vocbase = work[i].first;
+      TRI_vocbase_col_t* collection = work[i].second;
+      TRI_vocbase_col_status_e status;
+
+      int res = TRI_UseCollectionVocBase(vocbase, collection, status);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        TRI_ReleaseCollectionVocBase(vocbase, collection);
+      }
+      else {
+        ++failed;
+        LOG_WARNING("unable to preload collection '%s/%s': %s",
+                    vocbase->_name,
+                    collection->_name,
+                    TRI_errno_string(res));
+      }
+    }
+  };
+
+  size_t numThreads = (std::min)(server->_loaderThreads, work.size());
+
+  triagens::basics::ThreadPool::runConcurrently(server->_loaderPool, load, numThreads);
+
+  LOG_INFO("preloaded %llu collection(s) using up to %llu thread(s) in %.3f s",
+           (unsigned long long) (work.size() - failed.load()),
+           (unsigned long long) numThreads,
+           TRI_microtime() - start);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief stop the server
 ////////////////////////////////////////////////////////////////////////////////
@@ -2723,6 +2814,10 @@ TRI_server_t::TRI_server_t ()
   : _databasesLists(new DatabasesLists()),
     _applicationEndpointServer(nullptr),
     _indexPool(nullptr),
+    _compactionScheduler(nullptr),
+    _loaderPool(nullptr),
+    _graphPool(nullptr),
+    _loaderThreads(1),
     _queryRegistry(nullptr),
     _basePath(nullptr),
     _databasePath(nullptr),
@@ -46,6 +46,9 @@ namespace triagens {
   namespace aql {
     class QueryRegistry;
   }
+  namespace arango {
+    class CompactionScheduler;
+  }
   namespace basics {
     class ThreadPool;
   }
@@ -83,6 +86,10 @@ struct TRI_server_t {
   TRI_vocbase_defaults_t             _defaults;
   triagens::rest::ApplicationEndpointServer*  _applicationEndpointServer; 
   triagens::basics::ThreadPool*      _indexPool;                 
+  triagens::arango::CompactionScheduler* _compactionScheduler;
+  triagens::basics::ThreadPool*      _loaderPool;
+  triagens::basics::ThreadPool*      _graphPool;
+  size_t                             _loaderThreads;
   triagens::aql::QueryRegistry*      _queryRegistry;
 
   char*                              _basePath;
@@ -150,6 +157,16 @@ int TRI_StartServer (TRI_server_t*,
 
 int TRI_InitDatabasesServer (TRI_server_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads the specified collections of all databases in parallel
+///
+/// each entry can be a collection name (matching the collection in all
+/// databases), "<database>/<collection>", "<database>/*" or "*"
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_PreloadCollectionsServer (TRI_server_t*,
+                                  std::vector<std::string> const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief stop the server
 ////////////////////////////////////////////////////////////////////////////////
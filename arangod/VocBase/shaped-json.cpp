@@ -51,7 +51,8 @@ static bool FillShapeValueJson (VocShaper*,
                                 size_t, 
                                 bool);
 
-static int JsonShapeData (VocShaper*, 
+template<typename T>
+static int JsonShapeData (T*, 
                           TRI_shape_t const*, 
                           TRI_json_t*, 
                           char const*, 
@@ -1012,7 +1013,8 @@ static inline int JsonShapeDataNumber (TRI_json_t* dst,
 /// @brief converts a data short string blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline int JsonShapeDataShortString (VocShaper* shaper,
+template<typename T>
+static inline int JsonShapeDataShortString (T* shaper,
                                             TRI_json_t* dst,
                                             char const* data) {
   TRI_shape_length_short_string_t l = * (TRI_shape_length_short_string_t const*) data;
@@ -1025,7 +1027,8 @@ static inline int JsonShapeDataShortString (VocShaper* shaper,
 /// @brief converts a data long string blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline int JsonShapeDataLongString (VocShaper* shaper,
+template<typename T>
+static inline int JsonShapeDataLongString (T* shaper,
                                            TRI_json_t* dst,
                                            char const* data) {
   TRI_shape_length_long_string_t l = * (TRI_shape_length_long_string_t const*) data;
@@ -1038,7 +1041,8 @@ static inline int JsonShapeDataLongString (VocShaper* shaper,
 /// @brief converts a data array blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static int JsonShapeDataArray (VocShaper* shaper,
+template<typename T>
+static int JsonShapeDataArray (T* shaper,
                                TRI_shape_t const* shape,
                                TRI_json_t* dst,
                                char const* data,
@@ -1186,7 +1190,8 @@ static int JsonShapeDataArray (VocShaper* shaper,
 /// @brief converts a data list blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static int JsonShapeDataList (VocShaper* shaper,
+template<typename T>
+static int JsonShapeDataList (T* shaper,
                               TRI_shape_t const* shape,
                               TRI_json_t* dst,
                               char const* data,
@@ -1251,7 +1256,8 @@ static int JsonShapeDataList (VocShaper* shaper,
 /// @brief converts a data homogeneous list blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static int JsonShapeDataHomogeneousList (VocShaper* shaper,
+template<typename T>
+static int JsonShapeDataHomogeneousList (T* shaper,
                                          TRI_shape_t const* shape,
                                          TRI_json_t* dst,
                                          char const* data,
@@ -1304,7 +1310,8 @@ static int JsonShapeDataHomogeneousList (VocShaper* shaper,
 /// @brief converts a data homogeneous sized list blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static int JsonShapeDataHomogeneousSizedList (VocShaper* shaper,
+template<typename T>
+static int JsonShapeDataHomogeneousSizedList (T* shaper,
                                               TRI_shape_t const* shape,
                                               TRI_json_t* dst,
                                               char const* data,
@@ -1354,7 +1361,8 @@ static int JsonShapeDataHomogeneousSizedList (VocShaper* shaper,
 /// @brief converts a data blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-static int JsonShapeData (VocShaper* shaper,
+template<typename T>
+static int JsonShapeData (T* shaper,
                           TRI_shape_t const* shape,
                           TRI_json_t* dst,
                           char const* data,
@@ -2152,7 +2160,8 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (VocShaper* shaper,
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-TRI_json_t* TRI_JsonShapedJson (VocShaper* shaper,
+template<typename T>
+TRI_json_t* TRI_JsonShapedJson (T* shaper,
                                 TRI_shaped_json_t const* shaped) {
   TRI_shape_t const* shape = shaper->lookupShapeId(shaped->_sid);
 
@@ -2633,11 +2642,13 @@ void TRI_PrintShapeValues (TRI_shape_value_t* values,
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief explicit instantiation of the two functions
+/// @brief explicit instantiations of the functions that can use other shapers
 ////////////////////////////////////////////////////////////////////////////////
 
 template bool TRI_StringifyArrayShapedJson<VocShaper> (VocShaper*, struct TRI_string_buffer_s*, TRI_shaped_json_t const*, bool);
 template bool TRI_StringifyArrayShapedJson<triagens::basics::LegendReader> (triagens::basics::LegendReader*, struct TRI_string_buffer_s*, TRI_shaped_json_t const*, bool);
+template TRI_json_t* TRI_JsonShapedJson<VocShaper> (VocShaper*, TRI_shaped_json_t const*);
+template TRI_json_t* TRI_JsonShapedJson<triagens::basics::DictionaryShaper> (triagens::basics::DictionaryShaper*, TRI_shaped_json_t const*);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
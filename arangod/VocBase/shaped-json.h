@@ -1005,7 +1005,8 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (VocShaper*,
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
 
-TRI_json_t* TRI_JsonShapedJson (VocShaper*,
+template<typename T>
+TRI_json_t* TRI_JsonShapedJson (T*,
                                 TRI_shaped_json_t const*);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1087,6 +1087,14 @@ bool TRI_IsLockedCollectionTransaction (TRI_transaction_collection_t const* trxC
   return IsLocked(trxCollection);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a transaction consists of a single operation
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_IsSingleOperationTransaction (TRI_transaction_t const* trx) {
+  return IsSingleOperationTransaction(trx);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief add a WAL operation for a transaction collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -295,6 +295,12 @@ bool TRI_IsLockedCollectionTransaction (TRI_transaction_collection_t const*,
 
 bool TRI_IsLockedCollectionTransaction (TRI_transaction_collection_t const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a transaction consists of a single operation
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_IsSingleOperationTransaction (TRI_transaction_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief begin a transaction
 ////////////////////////////////////////////////////////////////////////////////
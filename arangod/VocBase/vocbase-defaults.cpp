@@ -47,6 +47,7 @@ void TRI_ApplyVocBaseDefaults (TRI_vocbase_t* vocbase,
   vocbase->_settings.requireAuthenticationUnixSockets = defaults->requireAuthenticationUnixSockets;
   vocbase->_settings.authenticateSystemOnly           = defaults->authenticateSystemOnly;
   vocbase->_settings.forceSyncProperties              = defaults->forceSyncProperties;
+  vocbase->_settings.indexCheckpoints                 = defaults->indexCheckpoints;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -66,6 +67,7 @@ TRI_json_t* TRI_JsonVocBaseDefaults (TRI_memory_zone_t* zone,
   TRI_Insert3ObjectJson(zone, json, "requireAuthenticationUnixSockets", TRI_CreateBooleanJson(zone, defaults->requireAuthenticationUnixSockets));
   TRI_Insert3ObjectJson(zone, json, "authenticateSystemOnly", TRI_CreateBooleanJson(zone, defaults->authenticateSystemOnly));
   TRI_Insert3ObjectJson(zone, json, "forceSyncProperties", TRI_CreateBooleanJson(zone, defaults->forceSyncProperties));
+  TRI_Insert3ObjectJson(zone, json, "indexCheckpoints", TRI_CreateBooleanJson(zone, defaults->indexCheckpoints));
   TRI_Insert3ObjectJson(zone, json, "defaultMaximalSize", TRI_CreateNumberJson(zone, (double) defaults->defaultMaximalSize));
 
   return json;
@@ -112,6 +114,12 @@ void TRI_FromJsonVocBaseDefaults (TRI_vocbase_defaults_t* defaults,
     defaults->forceSyncProperties = optionJson->_value._boolean;
   }
 
+  optionJson = TRI_LookupObjectJson(json, "indexCheckpoints");
+
+  if (TRI_IsBooleanJson(optionJson)) {
+    defaults->indexCheckpoints = optionJson->_value._boolean;
+  }
+
   optionJson = TRI_LookupObjectJson(json, "defaultMaximalSize");
 
   if (TRI_IsNumberJson(optionJson)) {
@@ -51,6 +51,7 @@ typedef struct TRI_vocbase_defaults_s {
   bool              requireAuthenticationUnixSockets;
   bool              authenticateSystemOnly;
   bool              forceSyncProperties;
+  bool              indexCheckpoints;
 }
 TRI_vocbase_defaults_t;
 
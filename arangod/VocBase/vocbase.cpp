@@ -47,6 +47,7 @@
 #include "Basics/tri-strings.h"
 #include "Basics/threads.h"
 #include "Basics/Exceptions.h"
+#include "Basics/ThreadPool.h"
 #include "Utils/CollectionKeysRepository.h"
 #include "Utils/CursorRepository.h"
 #include "Utils/transactions.h"
@@ -803,8 +804,50 @@ static bool StartupTickIterator (TRI_df_marker_t const* marker,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection parameters read ahead of the scan
+////////////////////////////////////////////////////////////////////////////////
+
+struct ScannedCollectionInfo {
+  ScannedCollectionInfo ()
+    : _res(TRI_ERROR_NO_ERROR),
+      _loaded(false) {
+    memset(&_info, 0, sizeof(TRI_col_info_t));
+  }
+
+  ~ScannedCollectionInfo () {
+    TRI_FreeCollectionInfoOptions(&_info);
+  }
+
+  TRI_col_info_t _info;
+  int            _res;
+  bool           _loaded;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the work function with the threads of the server's loader pool
+////////////////////////////////////////////////////////////////////////////////
+
+static void RunLoaderThreads (TRI_vocbase_t* vocbase,
+                              std::function<void()> const& work,
+                              size_t n) {
+  triagens::basics::ThreadPool* pool = nullptr;
+  size_t numThreads = 1;
+
+  if (vocbase->_server != nullptr) {
+    pool = vocbase->_server->_loaderPool;
+    numThreads = (std::min)(vocbase->_server->_loaderThreads, n);
+  }
+
+  triagens::basics::ThreadPool::runConcurrently(pool, work, numThreads);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief scans a directory and loads all collections
+///
+/// the parameter files of the collections and, if requested, the markers of
+/// their datafiles are read by the threads of the loader pool. collections
+/// are added to the database in the order of the directory entries
 ////////////////////////////////////////////////////////////////////////////////
 
 static int ScanPath (TRI_vocbase_t* vocbase,
@@ -832,6 +875,41 @@ static int ScanPath (TRI_vocbase_t* vocbase,
     LOG_TRACE("scanning all collection markers in database '%s", vocbase->_name);
   }
 
+  // read the parameter files of all writable collection directories
+  std::vector<ScannedCollectionInfo> infos(n);
+  std::atomic<size_t> next(0);
+
+  auto readInfos = [&] () -> void {
+    size_t j;
+    regmatch_t m[2];
+
+    while ((j = next++) < n) {
+      char const* name = files._buffer[j];
+
+      if (regexec(&re, name, sizeof(m) / sizeof(m[0]), m, 0) != 0) {
+        continue;
+      }
+
+      char* file = TRI_Concatenate2File(path, name);
+
+      if (file == nullptr) {
+        continue;
+      }
+
+      if (TRI_IsDirectory(file) && TRI_IsWritable(file)) {
+        infos[j]._res = TRI_LoadCollectionInfo(file, &infos[j]._info, true);
+        infos[j]._loaded = true;
+      }
+
+      TRI_FreeString(TRI_CORE_MEM_ZONE, file);
+    }
+  };
+
+  RunLoaderThreads(vocbase, readInfos, n);
+
+  // directories of the collections whose markers need to be scanned
+  std::vector<std::string> scanFiles;
+
   for (i = 0;  i < n;  ++i) {
     char* name = files._buffer[i];
     TRI_ASSERT(name != nullptr);
@@ -864,7 +942,15 @@ static int ScanPath (TRI_vocbase_t* vocbase,
       }
 
       // no need to lock as we are scanning
-      res = TRI_LoadCollectionInfo(file, &info, true);
+      if (infos[i]._loaded) {
+        // take over the parameters read above
+        info = infos[i]._info;
+        res = infos[i]._res;
+        infos[i]._info._keyOptions = nullptr;
+      }
+      else {
+        res = TRI_LoadCollectionInfo(file, &info, true);
+      }
 
       if (res == TRI_ERROR_NO_ERROR) {
         TRI_UpdateTickServer(info._cid);
@@ -969,10 +1055,7 @@ static int ScanPath (TRI_vocbase_t* vocbase,
         if (iterateMarkers) {
           // iterating markers may be time-consuming. we'll only do it if
           // we have to
-          TRI_voc_tick_t tick;
-          TRI_IterateTicksCollection(file, StartupTickIterator, &tick);
-
-          TRI_UpdateTickServer(tick);
+          scanFiles.emplace_back(file);
         }
 
         LOG_DEBUG("added document collection from '%s'", file);
@@ -990,6 +1073,21 @@ static int ScanPath (TRI_vocbase_t* vocbase,
 
   TRI_DestroyVectorString(&files);
 
+  next = 0;
+
+  auto scanMarkers = [&] () -> void {
+    size_t j;
+
+    while ((j = next++) < scanFiles.size()) {
+      TRI_voc_tick_t tick = 0;
+      TRI_IterateTicksCollection(scanFiles[j].c_str(), StartupTickIterator, &tick);
+
+      TRI_UpdateTickServer(tick);
+    }
+  };
+
+  RunLoaderThreads(vocbase, scanMarkers, scanFiles.size());
+
   return TRI_ERROR_NO_ERROR;
 }
 
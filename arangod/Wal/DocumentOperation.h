@@ -117,12 +117,28 @@ namespace triagens {
           document->_headersPtr->release(header, true);  // PROTECTED by trx in trxCollection
         }
         else if (type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
-          document->_headersPtr->move(header, &oldHeader);  // PROTECTED by trx in trxCollection
+          if (document->isConcurrentWriting()) {
+            // other operations may have moved the old neighbours of the header
+            // in the meantime. leave the header where it is and only adjust
+            // the size, as move() would do
+            int64_t newSize = static_cast<TRI_df_marker_t const*>(header->getDataPtr())->_size;  // PROTECTED by trx in trxCollection
+            int64_t oldSize = static_cast<TRI_df_marker_t const*>(oldHeader.getDataPtr())->_size;  // PROTECTED by trx in trxCollection
+            document->_headersPtr->adjustTotalSize(newSize, oldSize);
+          }
+          else {
+            document->_headersPtr->move(header, &oldHeader);  // PROTECTED by trx in trxCollection
+          }
           header->copy(oldHeader);
         }
         else if (type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
           if (status != StatusType::CREATED) {
-            document->_headersPtr->relink(header, &oldHeader); // PROTECTED by trx in trxCollection 
+            if (document->isConcurrentWriting()) {
+              // the old neighbours of the header may be gone
+              document->_headersPtr->relinkBack(header); // PROTECTED by trx in trxCollection 
+            }
+            else {
+              document->_headersPtr->relink(header, &oldHeader); // PROTECTED by trx in trxCollection 
+            }
           }
         }
 
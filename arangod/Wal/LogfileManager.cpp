@@ -144,6 +144,7 @@ LogfileManager::LogfileManager (TRI_server_t* server,
     _allowOversizeEntries(true),
     _ignoreLogfileErrors(false),
     _ignoreRecoveryErrors(false),
+    _recoveryThreads(4),
     _suppressShapeInformation(false),
     _allowWrites(false), // start in read-only mode
     _hasFoundLastTick(false),
@@ -246,6 +247,7 @@ void LogfileManager::setupOptions (std::map<std::string, triagens::basics::Progr
     ("wal.ignore-recovery-errors", &_ignoreRecoveryErrors, "continue recovery even if re-applying operations fails")
     ("wal.logfile-size", &_filesize, "size of each logfile (in bytes)")
     ("wal.open-logfiles", &_maxOpenLogfiles, "maximum number of parallel open logfiles")
+    ("wal.recovery-threads", &_recoveryThreads, "number of threads used for re-applying collection operations during recovery")
     ("wal.reserve-logfiles", &_reserveLogfiles, "maximum number of reserve logfiles to maintain")
     ("wal.slots", &_numberOfSlots, "number of logfile slots to use")
     ("wal.suppress-shape-information", &_suppressShapeInformation, "do not write shape information for markers (saves a lot of disk space, but effectively disables using the write-ahead log for replication)")
@@ -324,13 +326,17 @@ bool LogfileManager::prepare () {
     LOG_FATAL_AND_EXIT("invalid value for --wal.sync-interval. Please use a value of at least %llu", (unsigned long long) MinSyncInterval());
   }
 
+  if (_recoveryThreads < 1 || _recoveryThreads > 64) {
+    LOG_FATAL_AND_EXIT("invalid value for --wal.recovery-threads. Please use a value between 1 and 64");
+  }
+
   // sync interval is specified in milliseconds by the user, but internally
   // we use microseconds
   _syncInterval = _syncInterval * 1000;
 
   // initialize some objects
   _slots = new Slots(this, _numberOfSlots, 0);
-  _recoverState = new RecoverState(_server, _ignoreRecoveryErrors);
+  _recoverState = new RecoverState(_server, _ignoreRecoveryErrors, static_cast<size_t>(_recoveryThreads));
 
   return true;
 }
@@ -1051,6 +1051,23 @@ namespace triagens {
 
         bool _ignoreRecoveryErrors;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of recovery threads
+/// @startDocuBlock WalLogfileRecoveryThreads
+/// `--wal.recovery-threads`
+///
+/// The number of threads used for re-applying document, edge and remove 
+/// operations from the write-ahead logfiles during recovery. Operations are
+/// partitioned by collection, so operations on the same collection are always
+/// re-applied in their original order. Setting this value to *1* restores
+/// the single-threaded recovery. The default value is *4*. The threads are
+/// taken from the loader threads, so no more than
+/// `--database.loader-threads` threads are used.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _recoveryThreads;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief suppress shape information
 /// @startDocuBlock WalLogfileSuppressShapeInformation
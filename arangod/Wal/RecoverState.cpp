@@ -33,18 +33,65 @@
 #include "Basics/files.h"
 #include "Basics/Exceptions.h"
 #include "Basics/memory-map.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/ThreadPool.h"
 #include "VocBase/collection.h"
 #include "VocBase/replication-applier.h"
 #include "VocBase/VocShaper.h"
 #include "Wal/LogfileManager.h"
 #include "Wal/Slots.h"
 
+#include <algorithm>
+
 using namespace triagens::wal;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  helper functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the collection id of a collection operation marker
+/// returns 0 for all markers that do not belong to a single collection
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_voc_cid_t GetCollectionId (TRI_df_marker_t const* marker) {
+  switch (marker->_type) {
+    case TRI_WAL_MARKER_ATTRIBUTE:
+      return reinterpret_cast<attribute_marker_t const*>(marker)->_collectionId;
+    case TRI_WAL_MARKER_SHAPE:
+      return reinterpret_cast<shape_marker_t const*>(marker)->_collectionId;
+    case TRI_WAL_MARKER_DOCUMENT:
+      return reinterpret_cast<document_marker_t const*>(marker)->_collectionId;
+    case TRI_WAL_MARKER_EDGE:
+      return reinterpret_cast<edge_marker_t const*>(marker)->_collectionId;
+    case TRI_WAL_MARKER_REMOVE:
+      return reinterpret_cast<remove_marker_t const*>(marker)->_collectionId;
+    default:
+      return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a marker changes databases, collections or indexes
+/// these markers must be replayed after all previous operations
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsBarrierMarker (TRI_df_marker_t const* marker) {
+  switch (marker->_type) {
+    case TRI_WAL_MARKER_RENAME_COLLECTION:
+    case TRI_WAL_MARKER_CHANGE_COLLECTION:
+    case TRI_WAL_MARKER_CREATE_INDEX:
+    case TRI_WAL_MARKER_CREATE_COLLECTION:
+    case TRI_WAL_MARKER_CREATE_DATABASE:
+    case TRI_WAL_MARKER_DROP_INDEX:
+    case TRI_WAL_MARKER_DROP_COLLECTION:
+    case TRI_WAL_MARKER_DROP_DATABASE:
+      return true;
+    default:
+      return false;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not a collection is volatile
 ////////////////////////////////////////////////////////////////////////////////
@@ -177,7 +224,8 @@ static int WaitForDeletion (TRI_vocbase_t* vocbase,
 ////////////////////////////////////////////////////////////////////////////////
 
 RecoverState::RecoverState (TRI_server_t* server,
-                            bool ignoreRecoveryErrors)
+                            bool ignoreRecoveryErrors,
+                            size_t replayThreads)
   : server(server),
     failedTransactions(),
     lastTick(0),
@@ -185,7 +233,10 @@ RecoverState::RecoverState (TRI_server_t* server,
     openedCollections(),
     openedDatabases(),
     emptyLogfiles(),
-    policy(TRI_DOC_UPDATE_ONLY_IF_NEWER, 0, nullptr),
+    cacheLock(),
+    pendingMarkers(),
+    replayThreads(replayThreads < 1 ? 1 : replayThreads),
+    replayedMarkers(0),
     ignoreRecoveryErrors(ignoreRecoveryErrors),
     errorCount(0) {
 }
@@ -230,10 +281,13 @@ void RecoverState::releaseResources () {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_vocbase_t* RecoverState::useDatabase (TRI_voc_tick_t databaseId) {
-  auto it = openedDatabases.find(databaseId);
+  {
+    MUTEX_LOCKER(cacheLock);
+    auto it = openedDatabases.find(databaseId);
 
-  if (it != openedDatabases.end()) {
-    return (*it).second;
+    if (it != openedDatabases.end()) {
+      return (*it).second;
+    }
   }
 
   TRI_vocbase_t* vocbase = TRI_UseDatabaseByIdServer(server, databaseId);
@@ -242,7 +296,15 @@ TRI_vocbase_t* RecoverState::useDatabase (TRI_voc_tick_t databaseId) {
     return nullptr;
   }
         
-  openedDatabases.insert(it, std::make_pair(databaseId, vocbase));
+  MUTEX_LOCKER(cacheLock);
+  auto result = openedDatabases.emplace(databaseId, vocbase);
+
+  if (! result.second) {
+    // another replay thread has opened the database in the meantime
+    TRI_ReleaseDatabaseServer(server, vocbase);
+    return (*result.first).second;
+  }
+
   return vocbase;
 }
 
@@ -316,13 +378,19 @@ TRI_vocbase_col_t* RecoverState::releaseCollection (TRI_voc_cid_t collectionId)
 TRI_vocbase_col_t* RecoverState::useCollection (TRI_vocbase_t* vocbase,
                                                 TRI_voc_cid_t collectionId,
                                                 int& res) {
-  auto it = openedCollections.find(collectionId);
+  {
+    MUTEX_LOCKER(cacheLock);
+    auto it = openedCollections.find(collectionId);
 
-  if (it != openedCollections.end()) {
-    res = TRI_ERROR_NO_ERROR;
-    return (*it).second;
+    if (it != openedCollections.end()) {
+      res = TRI_ERROR_NO_ERROR;
+      return (*it).second;
+    }
   }
 
+  // operations on the same collection are always replayed by the same thread,
+  // so we can open the collection without holding the lock
+
   TRI_set_errno(TRI_ERROR_NO_ERROR);
   TRI_vocbase_col_status_e status; // ignored here
   TRI_vocbase_col_t* collection = TRI_UseCollectionByIdVocBase(vocbase, collectionId, status);
@@ -344,7 +412,11 @@ TRI_vocbase_col_t* RecoverState::useCollection (TRI_vocbase_t* vocbase,
   // disable secondary indexes for the moment
   document->useSecondaryIndexes(false);
 
-  openedCollections.insert(it, std::make_pair(collectionId, collection));
+  {
+    MUTEX_LOCKER(cacheLock);
+    openedCollections.emplace(collectionId, collection);
+  }
+
   res = TRI_ERROR_NO_ERROR;
   return collection;
 }
@@ -719,8 +791,9 @@ bool RecoverState::ReplayMarker (TRI_df_marker_t const* marker,
         int res = TRI_InsertShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, nullptr, false, false, true);
 
         if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED) {
-          state->policy.setExpectedRevision(m->_revisionId);
-          res = TRI_UpdateShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, &state->policy, false, false);
+          // the policy is local because markers may be replayed concurrently
+          TRI_doc_update_policy_t policy(TRI_DOC_UPDATE_ONLY_IF_NEWER, m->_revisionId, nullptr);
+          res = TRI_UpdateShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, &policy, false, false);
         }
 
         return res;
@@ -776,8 +849,9 @@ bool RecoverState::ReplayMarker (TRI_df_marker_t const* marker,
         int res = TRI_InsertShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, &edge, false, false, true);
 
         if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED) {
-          state->policy.setExpectedRevision(m->_revisionId);
-          res = TRI_UpdateShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, &state->policy, false, false);
+          // the policy is local because markers may be replayed concurrently
+          TRI_doc_update_policy_t policy(TRI_DOC_UPDATE_ONLY_IF_NEWER, m->_revisionId, nullptr);
+          res = TRI_UpdateShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &mptr, &shaped, &policy, false, false);
         }
 
         return res;
@@ -822,8 +896,8 @@ bool RecoverState::ReplayMarker (TRI_df_marker_t const* marker,
         } 
 
         // remove the document and ignore any potential errors
-        state->policy.setExpectedRevision(m->_revisionId);
-        TRI_RemoveShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &state->policy, false, false);
+        TRI_doc_update_policy_t policy(TRI_DOC_UPDATE_ONLY_IF_NEWER, m->_revisionId, nullptr);
+        TRI_RemoveShapedJsonDocumentCollection(trx->trxCollection(), (TRI_voc_key_t) key, m->_revisionId, envelope, &policy, false, false);
 
         return TRI_ERROR_NO_ERROR;
       });
@@ -1345,6 +1419,117 @@ bool RecoverState::ReplayMarker (TRI_df_marker_t const* marker,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback to dispatch one marker during multi-threaded recovery
+////////////////////////////////////////////////////////////////////////////////
+
+bool RecoverState::DispatchMarker (TRI_df_marker_t const* marker,
+                                   void* data,
+                                   TRI_datafile_t* datafile) {
+  RecoverState* state = reinterpret_cast<RecoverState*>(data);
+
+  TRI_voc_cid_t collectionId = GetCollectionId(marker);
+
+  if (collectionId != 0) {
+    // collection operation, will be replayed later by one of the replay threads
+    state->pendingMarkers.emplace_back(marker, datafile, collectionId);
+    return true;
+  }
+
+  if (IsBarrierMarker(marker)) {
+    // apply all previous operations before changing any databases, 
+    // collections or indexes
+    if (state->replayPendingMarkers() != TRI_ERROR_NO_ERROR) {
+      return false;
+    }
+  }
+
+  return ReplayMarker(marker, data, datafile);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replays the buffered collection operations, using multiple threads
+/// of the server's loader pool
+/// all operations of a collection are replayed by the same thread and in their
+/// original order. operations on different collections are independent of
+/// each other
+////////////////////////////////////////////////////////////////////////////////
+
+int RecoverState::replayPendingMarkers () {
+  if (pendingMarkers.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // group the operations by collection
+  std::unordered_map<TRI_voc_cid_t, size_t> positions;
+  std::vector<std::vector<PendingMarker const*>> groups;
+
+  for (auto const& it : pendingMarkers) {
+    auto it2 = positions.find(it.collectionId);
+    size_t position;
+
+    if (it2 == positions.end()) {
+      position = groups.size();
+      positions.emplace(it.collectionId, position);
+      groups.emplace_back();
+    }
+    else {
+      position = (*it2).second;
+    }
+
+    groups[position].emplace_back(&it);
+  }
+
+  // start with the biggest collections so all threads finish at about the
+  // same time
+  std::sort(groups.begin(), groups.end(), [] (std::vector<PendingMarker const*> const& lhs,
+                                              std::vector<PendingMarker const*> const& rhs) {
+    return lhs.size() > rhs.size();
+  });
+
+  size_t numThreads = replayThreads;
+
+  if (numThreads > groups.size()) {
+    numThreads = groups.size();
+  }
+
+  LOG_DEBUG("replaying %llu operations for %llu collections using %llu thread(s)",
+            (unsigned long long) pendingMarkers.size(),
+            (unsigned long long) groups.size(),
+            (unsigned long long) numThreads);
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+
+  auto work = [this, &groups, &next, &failed] () -> void {
+    while (! failed.load()) {
+      size_t const i = next++;
+
+      if (i >= groups.size()) {
+        return;
+      }
+
+      for (auto const* it : groups[i]) {
+        if (! ReplayMarker(it->marker, static_cast<void*>(this), it->datafile)) {
+          failed = true;
+          return;
+        }
+      }
+    }
+  };
+
+  triagens::basics::ThreadPool::runConcurrently(server->_loaderPool, work, numThreads);
+
+  replayedMarkers += pendingMarkers.size();
+  pendingMarkers.clear();
+
+  if (failed.load()) {
+    return TRI_ERROR_ARANGO_RECOVERY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief replay a single logfile
 ////////////////////////////////////////////////////////////////////////////////
@@ -1362,9 +1547,22 @@ int RecoverState::replayLogfile (Logfile* logfile,
   TRI_MMFileAdvise(logfile->df()->_data, logfile->df()->_maximalSize,
                    TRI_MADVISE_WILLNEED);
 
-  if (! TRI_IterateDatafile(logfile->df(), &RecoverState::ReplayMarker, static_cast<void*>(this))) {
-    LOG_WARNING("WAL inspection failed when scanning logfile '%s'", logfile->filename().c_str());
-    return TRI_ERROR_ARANGO_RECOVERY;
+  if (replayThreads <= 1) {
+    if (! TRI_IterateDatafile(logfile->df(), &RecoverState::ReplayMarker, static_cast<void*>(this))) {
+      LOG_WARNING("WAL inspection failed when scanning logfile '%s'", logfile->filename().c_str());
+      return TRI_ERROR_ARANGO_RECOVERY;
+    }
+  }
+  else {
+    // buffer collection operations and replay them in parallel. the buffered
+    // markers point into the logfile, so they must be applied before we advise
+    // random access below
+    if (! TRI_IterateDatafile(logfile->df(), &RecoverState::DispatchMarker, static_cast<void*>(this)) ||
+        replayPendingMarkers() != TRI_ERROR_NO_ERROR) {
+      pendingMarkers.clear();
+      LOG_WARNING("WAL inspection failed when scanning logfile '%s'", logfile->filename().c_str());
+      return TRI_ERROR_ARANGO_RECOVERY;
+    }
   }
 
   // Advise on random access use:
@@ -1392,6 +1590,12 @@ int RecoverState::replayLogfiles () {
     }
   }
 
+  if (replayThreads > 1) {
+    LOG_INFO("replayed %llu collection operations using up to %llu threads",
+             (unsigned long long) replayedMarkers,
+             (unsigned long long) replayThreads);
+  }
+
   return TRI_ERROR_NO_ERROR;
 }
 
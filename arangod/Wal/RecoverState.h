@@ -31,6 +31,7 @@
 #define ARANGODB_WAL_RECOVER_STATE_H 1
 
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
 #include "Utils/transactions.h"
 #include "VocBase/datafile.h"
 #include "VocBase/document-collection.h"
@@ -39,6 +40,7 @@
 #include "VocBase/vocbase.h"
 #include "Wal/Logfile.h"
 #include "Wal/Marker.h"
+#include <atomic>
 #include <functional>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,7 +74,8 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
       RecoverState (TRI_server_t*,
-                    bool);
+                    bool,
+                    size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroys the recover state
@@ -214,6 +217,22 @@ namespace triagens {
                                      void*,
                                      TRI_datafile_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback to dispatch one marker during multi-threaded recovery
+/// collection operations are buffered, all other markers act as a barrier
+/// and are replayed after the buffered operations have been applied
+////////////////////////////////////////////////////////////////////////////////
+
+      static bool DispatchMarker (TRI_df_marker_t const*,
+                                  void*,
+                                  TRI_datafile_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replays the buffered collection operations, using multiple threads
+////////////////////////////////////////////////////////////////////////////////
+
+      int replayPendingMarkers ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief replay a single logfile
 ////////////////////////////////////////////////////////////////////////////////
@@ -244,6 +263,28 @@ namespace triagens {
 
       int fillIndexes ();
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a collection operation buffered for multi-threaded replay
+////////////////////////////////////////////////////////////////////////////////
+
+      struct PendingMarker {
+        PendingMarker (TRI_df_marker_t const* marker,
+                       TRI_datafile_t* datafile,
+                       TRI_voc_cid_t collectionId)
+          : marker(marker),
+            datafile(datafile),
+            collectionId(collectionId) {
+        }
+
+        TRI_df_marker_t const*  marker;
+        TRI_datafile_t*         datafile;
+        TRI_voc_cid_t           collectionId;
+      };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -260,9 +301,12 @@ namespace triagens {
       std::unordered_map<TRI_voc_tick_t, TRI_vocbase_t*>                          openedDatabases;
       std::vector<std::string>                                                    emptyLogfiles;
 
-      TRI_doc_update_policy_t                                                     policy;
+      triagens::basics::Mutex                                                     cacheLock;
+      std::vector<PendingMarker>                                                  pendingMarkers;
+      size_t                                                                      replayThreads;
+      uint64_t                                                                    replayedMarkers;
       bool                                                                        ignoreRecoveryErrors;
-      int64_t                                                                     errorCount;
+      std::atomic<int64_t>                                                        errorCount;
     };
 
   }
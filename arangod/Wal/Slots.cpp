@@ -32,6 +32,7 @@
 #include "Basics/MutexLocker.h"
 #include "Basics/hashes.h"
 #include "Basics/logging.h"
+#include "Statistics/statistics.h"
 #include "VocBase/datafile.h"
 #include "VocBase/server.h"
 #include "Wal/LogfileManager.h"
@@ -143,6 +144,7 @@ SlotInfo Slots::nextUnused (uint32_t size) {
   uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
   int iterations = 0;
   bool hasWaited = false;
+  double waitStart = 0.0;
 
   TRI_ASSERT(size > 0);
 
@@ -227,6 +229,10 @@ SlotInfo Slots::nextUnused (uint32_t size) {
         // only in this case we return a valid slot
         slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
 
+        if (hasWaited) {
+          TRI_WaitStatistics(TRI_WAIT_WAL_SLOT, TRI_microtime() - waitStart);
+        }
+
         return SlotInfo(slot);
       }
     }
@@ -236,6 +242,7 @@ SlotInfo Slots::nextUnused (uint32_t size) {
     if (! hasWaited) {
       ++_waiting;
       hasWaited = true;
+      waitStart = TRI_microtime();
     }
 
     bool mustWait;
@@ -270,6 +277,7 @@ SlotInfo Slots::nextUnused (uint32_t size,
   uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
   int iterations = 0;
   bool hasWaited = false;
+  double waitStart = 0.0;
 
   TRI_ASSERT(size > 0);
 
@@ -369,6 +377,10 @@ SlotInfo Slots::nextUnused (uint32_t size,
         // only in this case we return a valid slot
         slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
 
+        if (hasWaited) {
+          TRI_WaitStatistics(TRI_WAIT_WAL_SLOT, TRI_microtime() - waitStart);
+        }
+
         return SlotInfo(slot);
       }
     }
@@ -378,6 +390,7 @@ SlotInfo Slots::nextUnused (uint32_t size,
     if (! hasWaited) {
       ++_waiting;
       hasWaited = true;
+      waitStart = TRI_microtime();
     }
 
     bool mustWait;
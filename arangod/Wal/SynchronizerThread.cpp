@@ -32,6 +32,7 @@
 #include "Basics/logging.h"
 #include "Basics/ConditionLocker.h"
 #include "Basics/Exceptions.h"
+#include "Statistics/statistics.h"
 #include "VocBase/server.h"
 #include "Wal/LogfileManager.h"
 #include "Wal/Slots.h"
@@ -203,7 +204,9 @@ int SynchronizerThread::doSync (bool& checkMore) {
   int fd = getLogfileDescriptor(region.logfileId);
   TRI_ASSERT(fd >= 0);
 
+  double const syncStart = TRI_microtime();
   bool result = TRI_MSync(fd, region.mem, region.mem + region.size);
+  TRI_WaitStatistics(TRI_WAIT_WAL_SYNC, TRI_microtime() - syncStart);
 
   LOG_TRACE("syncing logfile %llu, region %p - %p, length: %lu, wfs: %s",
             (unsigned long long) id,
@@ -200,11 +200,31 @@ actions.defineHttp({
 /// *count* and the distribution list in *counts*. The sum (or total) of the
 /// individual values is returned in *sum*.
 ///
+/// The request latencies are returned in *latency*, grouped by endpoint and
+/// HTTP method. The endpoint is the prefix of the handler that served the
+/// requests, e.g. */_api/document*. For actions and Foxx applications, the
+/// first part of the path is added to the catch-all prefix, e.g. */_admin*.
+/// For each endpoint and method, *totalTime*, *requestTime*, *queueTime* and
+/// *ioTime* contain the number of requests in *count*, the sum and the
+/// maximum of the times in *sum* and *max* and the percentiles in
+/// *percentiles*. All times are in seconds, a percentile is precise to about
+/// 1.6 %. Requests to further endpoints are counted as *other* once there are
+/// 128 combinations of endpoint and method.
+///
+/// @RESTQUERYPARAMETERS
+///
+/// @RESTQUERYPARAM{percentiles,string,optional}
+/// A comma-separated list of the percentiles to return for the request
+/// latencies, each between 0 and 100. Defaults to *50,90,99,99.9*.
+///
 /// @RESTRETURNCODES
 ///
 /// @RESTRETURNCODE{200}
 /// Statistics were returned successfully.
 ///
+/// @RESTRETURNCODE{400}
+/// A percentile is not a number between 0 and 100.
+///
 /// @EXAMPLES
 ///
 /// @EXAMPLE_ARANGOSH_RUN{RestAdminStatistics1}
@@ -233,6 +253,94 @@ actions.defineHttp({
       result.http = internal.httpStatistics();
       result.server = internal.serverStatistics();
 
+      var percentiles;
+
+      if (req.parameters.percentiles !== undefined) {
+        percentiles = String(req.parameters.percentiles).split(",").map(Number);
+
+        if (percentiles.some(function (p) { return isNaN(p) || p < 0 || p > 100; })) {
+          actions.resultBad(req, res, arangodb.ERROR_HTTP_BAD_PARAMETER,
+                            "percentiles must be numbers between 0 and 100");
+          return;
+        }
+      }
+
+      result.latency = internal.requestLatencyStatistics(percentiles);
+
+      actions.resultOk(req, res, actions.HTTP_OK, result);
+    }
+    catch (err) {
+      actions.resultException(req, res, err, undefined, false);
+    }
+  }
+});
+
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSF_get_admin_statistics_waits
+/// @brief return where the server threads waited
+///
+/// @RESTHEADER{GET /_admin/statistics/waits, Read the wait statistics}
+///
+/// @RESTDESCRIPTION
+///
+/// Returns how often and how long the server threads waited, so contention
+/// can be located. The returned object contains:
+///
+/// - *waits*: a distribution of the wait time in seconds for each wait point.
+///   *walSlot* is the wait for a free slot in the write-ahead log, *walSync*
+///   and *datafileSync* are the time spent syncing the write-ahead log and
+///   datafiles to disk, *v8Context* is the wait for a free V8 context and
+///   *dispatcherQueue* is the time jobs waited in a dispatcher queue.
+///
+/// - *handlers*: the time jobs waited in a dispatcher queue, as distribution
+///   by the prefix of the handler that ran them.
+///
+/// - *lanes*: the time jobs waited in the *short* and the *long* lane of the
+///   dispatcher queues, as latency histogram with the *count*, *sum* and *max*
+///   of the times and their *percentiles* 50, 90, 99 and 99.9, in seconds.
+///   Single document operations use the short lane, all other requests the
+///   long lane.
+///
+/// - *collections*: for each loaded collection of the current database the
+///   number of times and the total time in seconds readers and writers
+///   waited for the collection lock.
+///
+/// - *cuts*: the upper bounds of the distribution buckets in seconds.
+///
+/// The figures are kept since the server start.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// Statistics were returned successfully.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+actions.defineHttp({
+  url : "_admin/statistics/waits",
+  prefix : false,
+
+  callback : function (req, res) {
+    var result;
+
+    try {
+      var stats = internal.waitStatistics();
+
+      result = {};
+      result.time = internal.time();
+      result.waits = stats.waits;
+      result.handlers = stats.handlers;
+      result.lanes = stats.lanes;
+      result.collections = {};
+      result.cuts = internal.waitTimeDistribution;
+
+      internal.db._collections().forEach(function (collection) {
+        // do not load collections only to read their figures
+        if (collection.status() === arangodb.ArangoCollection.STATUS_LOADED) {
+          result.collections[collection.name()] = collection.figures().locks;
+        }
+      });
+
       actions.resultOk(req, res, actions.HTTP_OK, result);
     }
     catch (err) {
@@ -598,6 +706,15 @@ actions.defineHttp({
             description: "Physical memory in bytes.",
             type: "current",
             units: "bytes"
+          },
+
+          {
+            group: "server",
+            identifier: "droppedLogMessages",
+            name: "Dropped Log Messages",
+            description: "Number of log messages dropped because the log buffer of their thread was full.",
+            type: "accumulated",
+            units: "number"
           }
 
         ]
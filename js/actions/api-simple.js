@@ -912,6 +912,140 @@ actions.defineHttp({
   }
 });
 
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSA_put_api_simple_within_polygon
+/// @brief returns all documents of a collection within a polygon
+///
+/// @RESTHEADER{PUT /_api/simple/within-polygon, Within polygon query}
+///
+/// @RESTBODYPARAM{collection,string,required,string}
+/// The name of the collection to query.
+///
+/// @RESTBODYPARAM{polygon,array,required,array}
+/// The vertices of the polygon, as an array of *[ latitude, longitude ]* pairs.
+///
+/// @RESTBODYPARAM{skip,string,required,string}
+/// The number of documents to skip in the query. (optional)
+///
+/// @RESTBODYPARAM{limit,string,required,string}
+/// The maximal amount of documents to return. The *skip* is
+/// applied before the *limit* restriction. (optional)
+///
+/// @RESTBODYPARAM{geo,string,required,string}
+/// If given, the identifier of the geo-index to use. (optional)
+///
+/// @RESTDESCRIPTION
+///
+/// This will find all documents within the specified polygon. The polygon
+/// must have at least 3 vertices and is closed automatically. Its edges are
+/// straight lines in the latitude/longitude plane. Documents on the edges of
+/// the polygon are included in the result.
+///
+/// In order to use the *within-polygon* query, a geo index must be defined for
+/// the collection. This index also defines which attribute holds the
+/// coordinates for the document.  If you have more than one geo-spatial index,
+/// you can use the *geo* field to select a particular index.
+///
+/// Returns a cursor containing the result, see [Http Cursor](../HttpAqlQueryCursor/README.md) for details.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{201}
+/// is returned if the query was executed successfully.
+///
+/// @RESTRETURNCODE{400}
+/// is returned if the body does not contain a valid JSON representation of a
+/// query. The response body contains an error document in this case.
+///
+/// @RESTRETURNCODE{404}
+/// is returned if the collection specified by *collection* is unknown.  The
+/// response body contains an error document in this case.
+///
+/// @EXAMPLES
+///
+/// @EXAMPLE_ARANGOSH_RUN{RestSimpleWithinPolygon}
+///     var cn = "products";
+///     db._drop(cn);
+///     var products = db._create(cn);
+///     var loc = products.ensureGeoIndex("loc");
+///     var i;
+///     for (i = -0.01;  i <= 0.01;  i += 0.002) {
+///       products.save({ name : "Name/" + i + "/",loc: [ i, 0 ] });
+///     }
+///     var url = "/_api/simple/within-polygon";
+///     var body = {
+///       collection: "products", 
+///       polygon : [ [ 0, -0.1 ], [ 0.2, 0 ], [ 0, 0.1 ] ],
+///       skip : 1,
+///       limit : 2
+///     };
+///
+///     var response = logCurlRequest('PUT', url, body);
+///
+///     assert(response.code === 201);
+///
+///     logJsonResponse(response);
+///     db._drop(cn);
+/// @END_EXAMPLE_ARANGOSH_RUN
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+actions.defineHttp({
+  url: API + "within-polygon",
+
+  callback : function (req, res) {
+    try {
+      var body = actions.getJsonBody(req, res);
+
+      if (body === undefined) {
+        return;
+      }
+
+      if (req.requestType !== actions.PUT) {
+        actions.resultUnsupported(req, res);
+      }
+      else {
+        var limit = body.limit;
+        var skip = body.skip;
+        var polygon = body.polygon;
+        var geo = body.geo;
+        var name = body.collection;
+        var collection = db._collection(name);
+
+        if (collection === null) {
+          actions.collectionNotFound(req, res, name);
+        }
+        else if (! Array.isArray(polygon)) {
+          actions.badParameter(req, res, "polygon");
+        }
+        else {
+          var result;
+
+          if (geo === null || geo === undefined) {
+            result = collection.withinPolygon(polygon);
+          }
+          else {
+            result = collection.geo({ id : geo }).withinPolygon(polygon);
+          }
+
+          if (skip !== null && skip !== undefined) {
+            result = result.skip(skip);
+          }
+
+          if (limit !== null && limit !== undefined) {
+            result = result.limit(limit);
+          }
+
+          createCursorResponse(req, res, CREATE_CURSOR(result.toArray(), body.batchSize, body.ttl));
+        }
+      }
+    }
+    catch (err) {
+      actions.resultException(req, res, err, undefined, false);
+    }
+  }
+});
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock JSA_put_api_simple_fulltext
 /// @brief returns documents of a collection as a result of a fulltext query
@@ -483,6 +483,9 @@ function processQuery (query, explain) {
         return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* full collection scan" + (node.random ? ", random order" : "") + " */");
       case "EnumerateListNode":
         return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + variableName(node.inVariable) + "   " + annotation("/* list iteration */");
+      case "HashJoinNode":
+        collectionVariables[node.outVariable.id] = node.collection;
+        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* hash join on " + node.attribute.map(attribute).join(".") + " == ") + variableName(node.inVariable) + annotation(" */");
       case "IndexRangeNode":
         collectionVariables[node.outVariable.id] = node.collection;
         var index = node.index;
@@ -564,6 +567,7 @@ function processQuery (query, explain) {
     if ([ "EnumerateCollectionNode",
           "EnumerateListNode",
           "IndexRangeNode",
+          "HashJoinNode",
           "SubqueryNode" ].indexOf(node.type) !== -1) {
       level++;
     }
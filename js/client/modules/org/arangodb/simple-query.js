@@ -44,6 +44,7 @@ var SimpleQueryNear = sq.SimpleQueryNear;
 var SimpleQueryRange = sq.SimpleQueryRange;
 var SimpleQueryWithin = sq.SimpleQueryWithin;
 var SimpleQueryWithinRectangle = sq.SimpleQueryWithinRectangle;
+var SimpleQueryWithinPolygon = sq.SimpleQueryWithinPolygon;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  SIMPLE QUERY ALL
@@ -440,6 +441,58 @@ SimpleQueryWithinRectangle.prototype.execute = function (batchSize) {
   }
 };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                        SIMPLE QUERY WITHINPOLYGON
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a withinPolygon query
+////////////////////////////////////////////////////////////////////////////////
+
+SimpleQueryWithinPolygon.prototype.execute = function (batchSize) {
+  if (this._execution === null) {
+    if (batchSize !== undefined && batchSize > 0) {
+      this._batchSize = batchSize;
+    }
+
+    var data = {
+      collection: this._collection.name(),
+      polygon: this._polygon
+    };
+
+    if (this._limit !== null) {
+      data.limit = this._limit;
+    }
+
+    if (this._skip !== null) {
+      data.skip = this._skip;
+    }
+
+    if (this._index !== null) {
+      data.geo = this._index;
+    }
+
+    if (this._batchSize !== null) {
+      data.batchSize = this._batchSize;
+    }
+
+    var requestResult = this._collection._database._connection.PUT(
+      "/_api/simple/within-polygon", JSON.stringify(data));
+
+    arangosh.checkRequestResult(requestResult);
+
+    this._execution = new ArangoQueryCursor(this._collection._database, requestResult);
+
+    if (requestResult.hasOwnProperty("count")) {
+      this._countQuery = requestResult.count;
+    }
+  }
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             SIMPLE QUERY FULLTEXT
 // -----------------------------------------------------------------------------
@@ -508,6 +561,7 @@ exports.SimpleQueryNear = SimpleQueryNear;
 exports.SimpleQueryRange = SimpleQueryRange;
 exports.SimpleQueryWithin = SimpleQueryWithin;
 exports.SimpleQueryWithinRectangle = SimpleQueryWithinRectangle;
+exports.SimpleQueryWithinPolygon = SimpleQueryWithinPolygon;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
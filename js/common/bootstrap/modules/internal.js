@@ -222,6 +222,28 @@ if (global.REQUEST_TIME_DISTRIBUTION) {
   delete global.REQUEST_TIME_DISTRIBUTION;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief v8ContextWaitTimeDistribution
+////////////////////////////////////////////////////////////////////////////////
+
+exports.v8ContextWaitTimeDistribution = [];
+
+if (global.V8_CONTEXT_WAIT_TIME_DISTRIBUTION) {
+  exports.v8ContextWaitTimeDistribution = global.V8_CONTEXT_WAIT_TIME_DISTRIBUTION;
+  delete global.V8_CONTEXT_WAIT_TIME_DISTRIBUTION;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waitTimeDistribution
+////////////////////////////////////////////////////////////////////////////////
+
+exports.waitTimeDistribution = [];
+
+if (global.WAIT_TIME_DISTRIBUTION) {
+  exports.waitTimeDistribution = global.WAIT_TIME_DISTRIBUTION;
+  delete global.WAIT_TIME_DISTRIBUTION;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief startupPath
 ////////////////////////////////////////////////////////////////////////////////
@@ -575,6 +597,24 @@ if (global.SYS_SERVER_STATISTICS) {
   delete global.SYS_SERVER_STATISTICS;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waitStatistics
+////////////////////////////////////////////////////////////////////////////////
+
+if (global.SYS_WAIT_STATISTICS) {
+  exports.waitStatistics = global.SYS_WAIT_STATISTICS;
+  delete global.SYS_WAIT_STATISTICS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief requestLatencyStatistics
+////////////////////////////////////////////////////////////////////////////////
+
+if (global.SYS_REQUEST_LATENCY_STATISTICS) {
+  exports.requestLatencyStatistics = global.SYS_REQUEST_LATENCY_STATISTICS;
+  delete global.SYS_REQUEST_LATENCY_STATISTICS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sleep
 ////////////////////////////////////////////////////////////////////////////////
@@ -260,8 +260,16 @@ function processQuery (query, explain) {
     maxTypeLen = 0,
     maxIdLen = String("Id").length,
     maxEstimateLen = String("Est.").length,
+    maxCallsLen = String("Calls").length,
+    maxRowsLen = String("Rows").length,
+    maxRuntimeLen = String("Runtime").length,
+    profile = explain.profile || null,
     plan = explain.plan;
 
+  var formatRuntime = function (runtime) {
+    return runtime.toFixed(5);
+  };
+
   var recursiveWalk = function (n, level) {
     n.forEach(function(node) {
       nodes[node.id] = node;
@@ -287,6 +295,18 @@ function processQuery (query, explain) {
       if (String(node.estimatedNrItems).length > maxEstimateLen) {
         maxEstimateLen = String(node.estimatedNrItems).length;
       }
+      if (profile !== null && profile.hasOwnProperty(node.id)) {
+        var stats = profile[node.id];
+        if (String(stats.calls).length > maxCallsLen) {
+          maxCallsLen = String(stats.calls).length;
+        }
+        if (String(stats.rowsOut).length > maxRowsLen) {
+          maxRowsLen = String(stats.rowsOut).length;
+        }
+        if (formatRuntime(stats.runtime).length > maxRuntimeLen) {
+          maxRuntimeLen = formatRuntime(stats.runtime).length;
+        }
+      }
     });
   };
   recursiveWalk(plan.nodes, 0);
@@ -482,6 +502,9 @@ function processQuery (query, explain) {
         return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* full collection scan" + (node.random ? ", random order" : "") + " */");
       case "EnumerateListNode":
         return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + variableName(node.inVariable) + "   " + annotation("/* list iteration */");
+      case "HashJoinNode":
+        collectionVariables[node.outVariable.id] = node.collection;
+        return keyword("FOR") + " " + variableName(node.outVariable) + " " + keyword("IN") + " " + collection(node.collection) + "   " + annotation("/* hash join on " + node.attribute.map(attribute).join(".") + " == ") + variableName(node.inVariable) + annotation(" */");
       case "IndexRangeNode":
         collectionVariables[node.outVariable.id] = node.collection;
         var index = node.index;
@@ -563,6 +586,7 @@ function processQuery (query, explain) {
     if ([ "EnumerateCollectionNode",
           "EnumerateListNode",
           "IndexRangeNode",
+          "HashJoinNode",
           "SubqueryNode" ].indexOf(node.type) !== -1) {
       level++;
     }
@@ -594,12 +618,28 @@ function processQuery (query, explain) {
     return "";
   };
     
+  var profileColumns = function (node) {
+    if (profile === null) {
+      return "";
+    }
+    var calls = "", rows = "", runtime = "";
+    if (profile.hasOwnProperty(node.id)) {
+      calls = String(profile[node.id].calls);
+      rows = String(profile[node.id].rowsOut);
+      runtime = formatRuntime(profile[node.id].runtime);
+    }
+    return pad(1 + maxCallsLen - calls.length) + value(calls) + "   " +
+      pad(1 + maxRowsLen - rows.length) + value(rows) + "   " +
+      pad(1 + maxRuntimeLen - runtime.length) + value(runtime) + "   ";
+  };
+
   var printNode = function (node) {
     preHandle(node);
     var line = " " +  
       pad(1 + maxIdLen - String(node.id).length) + variable(node.id) + "   " +
       keyword(node.type) + pad(1 + maxTypeLen - String(node.type).length) + "   " + 
       pad(1 + maxEstimateLen - String(node.estimatedNrItems).length) + value(node.estimatedNrItems) + "   " +
+      profileColumns(node) +
       indent(level, node.type === "SingletonNode") + label(node);
 
     if (node.type === "CalculationNode") {
@@ -615,8 +655,14 @@ function processQuery (query, explain) {
   var line = " " + 
     pad(1 + maxIdLen - String("Id").length) + header("Id") + "   " +
     header("NodeType") + pad(1 + maxTypeLen - String("NodeType").length) + "   " +   
-    pad(1 + maxEstimateLen - String("Est.").length) + header("Est.") + "   " +
-    header("Comment");
+    pad(1 + maxEstimateLen - String("Est.").length) + header("Est.") + "   ";
+
+  if (profile !== null) {
+    line += pad(1 + maxCallsLen - String("Calls").length) + header("Calls") + "   " +
+      pad(1 + maxRowsLen - String("Rows").length) + header("Rows") + "   " +
+      pad(1 + maxRuntimeLen - String("Runtime").length) + header("Runtime") + "   ";
+  }
+  line += header("Comment");
 
   stringBuilder.appendLine(line);
 
@@ -657,6 +703,22 @@ function explain (data, options, shouldPrint) {
   var stmt = db._createStatement(data);
   var result = stmt.explain(options);
 
+  if (options.profile) {
+    // execute the query to get the statistics of its execution nodes
+    var extra = db._createStatement({
+      query: data.query, 
+      bindVars: data.bindVars, 
+      options: { profile: true } 
+    }).execute().getExtra();
+
+    result.profile = { };
+    if (extra && extra.stats && Array.isArray(extra.stats.nodes)) {
+      extra.stats.nodes.forEach(function(node) {
+        result.profile[node.id] = node;
+      });
+    }
+  }
+
   stringBuilder.clearOutput();
   processQuery(data.query, result, true);
 
@@ -45,6 +45,7 @@ var SimpleQueryGeo = simple.SimpleQueryGeo;
 var SimpleQueryNear = simple.SimpleQueryNear;
 var SimpleQueryWithin = simple.SimpleQueryWithin;
 var SimpleQueryWithinRectangle = simple.SimpleQueryWithinRectangle;
+var SimpleQueryWithinPolygon = simple.SimpleQueryWithinPolygon;
 var SimpleQueryFulltext = simple.SimpleQueryFulltext;
 
 // -----------------------------------------------------------------------------
@@ -786,6 +787,10 @@ ArangoCollection.prototype.withinRectangle = function (lat1, lon1, lat2, lon2) {
   return new SimpleQueryWithinRectangle(this, lat1, lon1, lat2, lon2);
 };
 
+ArangoCollection.prototype.withinPolygon = function (polygon) {
+  return new SimpleQueryWithinPolygon(this, polygon);
+};
+
 ArangoCollection.prototype.fulltext = function (attribute, query, iid) {
   return new SimpleQueryFulltext(this, attribute, query, iid);
 };
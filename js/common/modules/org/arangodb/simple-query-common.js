@@ -36,6 +36,7 @@ var SimpleQueryArray;
 var SimpleQueryNear;
 var SimpleQueryWithin;
 var SimpleQueryWithinRectangle;
+var SimpleQueryWithinPolygon;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                              GENERAL ARRAY CURSOR
@@ -1000,6 +1001,14 @@ SimpleQueryGeo.prototype.withinRectangle = function (lat1, lon1, lat2, lon2) {
   return new SimpleQueryWithinRectangle(this._collection, lat1, lon1, lat2, lon2, this._index);
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a within-polygon query for an index
+////////////////////////////////////////////////////////////////////////////////
+
+SimpleQueryGeo.prototype.withinPolygon = function (polygon) {
+  return new SimpleQueryWithinPolygon(this._collection, polygon, this._index);
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 SIMPLE QUERY NEAR
 // -----------------------------------------------------------------------------
@@ -1351,6 +1360,107 @@ SimpleQueryWithinRectangle.prototype._PRINT = function (context) {
   context.output += text;
 };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                        SIMPLE QUERY WITHINPOLYGON
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief within-polygon query
+////////////////////////////////////////////////////////////////////////////////
+
+SimpleQueryWithinPolygon = function (collection, polygon, iid) {
+  var idx;
+  var i;
+
+  this._collection = collection;
+  this._polygon = polygon;
+  this._index = (iid === undefined ? null : iid);
+
+  if (! Array.isArray(polygon) || polygon.length < 3) {
+    var err1 = new ArangoError();
+    err1.errorNum = arangodb.ERROR_BAD_PARAMETER;
+    err1.errorMessage = "polygon must be an array of at least 3 [ latitude, longitude ] pairs";
+    throw err1;
+  }
+
+  if (iid === undefined) {
+    idx = collection.getIndexes();
+
+    for (i = 0;  i < idx.length;  ++i) {
+      var index = idx[i];
+
+      if (index.type === "geo1" || index.type === "geo2") {
+        if (this._index === null) {
+          this._index = index.id;
+        }
+        else if (index.id < this._index) {
+          this._index = index.id;
+        }
+      }
+    }
+  }
+
+  if (this._index === null) {
+    var err = new ArangoError();
+    err.errorNum = arangodb.ERROR_QUERY_GEO_INDEX_MISSING;
+    err.errorMessage = arangodb.errors.ERROR_QUERY_GEO_INDEX_MISSING.message;
+    throw err;
+  }
+};
+
+SimpleQueryWithinPolygon.prototype = new SimpleQuery();
+SimpleQueryWithinPolygon.prototype.constructor = SimpleQueryWithinPolygon;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clones a within-polygon query
+////////////////////////////////////////////////////////////////////////////////
+
+SimpleQueryWithinPolygon.prototype.clone = function () {
+  var query;
+
+  query = new SimpleQueryWithinPolygon(this._collection,
+                                       this._polygon,
+                                       this._index);
+  query._skip = this._skip;
+  query._limit = this._limit;
+
+  return query;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prints a within-polygon query
+////////////////////////////////////////////////////////////////////////////////
+
+SimpleQueryWithinPolygon.prototype._PRINT = function (context) {
+  var text;
+
+  text = "SimpleQueryWithinPolygon("
+       + this._collection.name()
+       + ", "
+       + JSON.stringify(this._polygon)
+       + ", "
+       + this._index
+       + ")";
+
+  if (this._skip !== null && this._skip !== 0) {
+    text += ".skip(" + this._skip + ")";
+  }
+
+  if (this._limit !== null) {
+    text += ".limit(" + this._limit + ")";
+  }
+
+  context.output += text;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             SIMPLE QUERY FULLTEXT
 // -----------------------------------------------------------------------------
@@ -1457,6 +1567,7 @@ exports.SimpleQueryGeo = SimpleQueryGeo;
 exports.SimpleQueryNear = SimpleQueryNear;
 exports.SimpleQueryWithin = SimpleQueryWithin;
 exports.SimpleQueryWithinRectangle = SimpleQueryWithinRectangle;
+exports.SimpleQueryWithinPolygon = SimpleQueryWithinPolygon;
 exports.SimpleQueryFulltext = SimpleQueryFulltext;
 
 // -----------------------------------------------------------------------------
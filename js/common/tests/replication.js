@@ -1997,6 +1997,7 @@ function ReplicationApplierSuite () {
       assertEqual(0, properties.chunkSize);
       assertFalse(properties.autoStart);
       assertTrue(properties.adaptivePolling);
+      assertFalse(properties.binaryFormat);
       assertUndefined(properties.endpoint);
       assertTrue(properties.includeSystem);
       assertEqual("", properties.restrictType);
@@ -2027,6 +2028,7 @@ function ReplicationApplierSuite () {
         endpoint: "tcp://9.9.9.9:9998",
         autoStart: true,
         adaptivePolling: false,
+        binaryFormat: true,
         requestTimeout: 5,
         connectTimeout: 9,
         maxConnectRetries: 4,
@@ -2044,6 +2046,7 @@ function ReplicationApplierSuite () {
       assertEqual(65536, properties.chunkSize);
       assertTrue(properties.autoStart);
       assertFalse(properties.adaptivePolling);
+      assertTrue(properties.binaryFormat);
       assertFalse(properties.includeSystem);
       assertEqual("include", properties.restrictType);
       assertEqual([ "_users" ], properties.restrictCollections);
@@ -2051,6 +2054,7 @@ function ReplicationApplierSuite () {
       replication.applier.properties({
         endpoint: "tcp://9.9.9.9:9998",
         autoStart: false,
+        binaryFormat: false,
         maxConnectRetries: 10,
         chunkSize: 128 * 1024,
         includeSystem: true,
@@ -2066,6 +2070,7 @@ function ReplicationApplierSuite () {
       assertEqual(128 * 1024, properties.chunkSize);
       assertFalse(properties.autoStart);
       assertFalse(properties.adaptivePolling);
+      assertFalse(properties.binaryFormat);
       assertTrue(properties.includeSystem);
       assertEqual("exclude", properties.restrictType);
       assertEqual([ "bar", "baz", "foo" ], properties.restrictCollections.sort());
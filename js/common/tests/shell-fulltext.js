@@ -913,6 +913,38 @@ function fulltextQuerySuite () {
       assertEqual(0, collection.fulltext("text", "banana", idx).toArray().length);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test words contained in many documents
+////////////////////////////////////////////////////////////////////////////////
+    
+    testCommonWords: function () {
+      var i;
+      for (i = 0; i < 5000; ++i) {
+        collection.save({ text: "common word" + (i % 3 === 0 ? " fizz" : "") + (i % 5 === 0 ? " buzz" : "") + (i === 4321 ? " rare" : "") });
+      }
+     
+      assertEqual(5000, collection.fulltext("text", "common", idx).toArray().length);
+      assertEqual(5000, collection.fulltext("text", "common,word", idx).toArray().length);
+      assertEqual(1667, collection.fulltext("text", "common,fizz", idx).toArray().length);
+      assertEqual(334, collection.fulltext("text", "fizz,buzz", idx).toArray().length);
+      assertEqual(334, collection.fulltext("text", "buzz,common,fizz,word", idx).toArray().length);
+      assertEqual(1, collection.fulltext("text", "common,rare", idx).toArray().length);
+      assertEqual(1, collection.fulltext("text", "rare,prefix:comm", idx).toArray().length);
+      assertEqual(1333, collection.fulltext("text", "fizz,-buzz", idx).toArray().length);
+      assertEqual(2333, collection.fulltext("text", "fizz,|buzz", idx).toArray().length);
+      assertEqual(0, collection.fulltext("text", "common,banana", idx).toArray().length);
+
+      // remove documents from the middle of the lists
+      collection.byExample({ text: "common word fizz" }).toArray().forEach(function(doc) {
+        collection.remove(doc);
+      });
+
+      assertEqual(334, collection.fulltext("text", "common,fizz", idx).toArray().length);
+      assertEqual(334, collection.fulltext("text", "fizz,buzz", idx).toArray().length);
+      assertEqual(0, collection.fulltext("text", "fizz,-buzz", idx).toArray().length);
+      assertEqual(5000 - 1333, collection.fulltext("text", "common", idx).toArray().length);
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test duplicate entries
 ////////////////////////////////////////////////////////////////////////////////
@@ -3973,6 +3973,32 @@ function AQL_WITHIN_RECTANGLE (collection, latitude1, longitude1, latitude2, lon
   return COLLECTION(collection).withinRectangle(latitude1, longitude1, latitude2, longitude2).toArray();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return documents within a polygon
+////////////////////////////////////////////////////////////////////////////////
+
+function AQL_WITHIN_POLYGON (collection, polygon) {
+  'use strict';
+
+  if (TYPEWEIGHT(polygon) !== TYPEWEIGHT_ARRAY || polygon.length < 3) {
+    WARN("WITHIN_POLYGON", INTERNAL.errors.ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return null;
+  }
+
+  var i;
+  for (i = 0; i < polygon.length; ++i) {
+    if (TYPEWEIGHT(polygon[i]) !== TYPEWEIGHT_ARRAY ||
+        polygon[i].length !== 2 ||
+        TYPEWEIGHT(polygon[i][0]) !== TYPEWEIGHT_NUMBER ||
+        TYPEWEIGHT(polygon[i][1]) !== TYPEWEIGHT_NUMBER) {
+      WARN("WITHIN_POLYGON", INTERNAL.errors.ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+      return null;
+    }
+  }
+
+  return COLLECTION(collection).withinPolygon(polygon).toArray();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return true if a point is contained inside a polygon
 ////////////////////////////////////////////////////////////////////////////////
@@ -4059,6 +4085,9 @@ function AQL_FULLTEXT (collection, attribute, query, limit) {
   }
 
   if (isCoordinator) {
+    // the shards do not return the scores of their documents, and the scores
+    // would be based on the shard's statistics only. so documents are not
+    // ranked in a cluster, and the limit returns any of the matches
     if (limit !== undefined && limit !== null && limit > 0) {
       return COLLECTION(collection).fulltext(attribute, query, idx).limit(limit).toArray();
     }
@@ -8339,6 +8368,7 @@ function AQL_GRAPH_ECCENTRICITY (graphName, options) {
   if (! options.direction) {
     options.direction =  'any';
   }
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_ECCENTRICITY", options);
   if (! options.algorithm) {
     options.algorithm = "dijkstra";
   }
@@ -8615,6 +8645,7 @@ function AQL_GRAPH_CLOSENESS (graphName, options) {
   if (! options.direction) {
     options.direction =  'any';
   }
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_CLOSENESS", options);
   if (! options.algorithm) {
     options.algorithm = "dijkstra";
   }
@@ -8649,6 +8680,27 @@ function AQL_GRAPH_CLOSENESS (graphName, options) {
   return list;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks the *algorithm* option of the graph measurement functions.
+/// the measurements always use exact shortest paths, so both algorithms
+/// lead to the same result. other values are rejected
+////////////////////////////////////////////////////////////////////////////////
+
+function CHECK_SHORTEST_PATH_ALGORITHM (func, options) {
+  'use strict';
+
+  var algorithm = options.algorithm;
+
+  if (algorithm === undefined || algorithm === null || algorithm === "") {
+    return;
+  }
+
+  if (typeof algorithm !== "string" ||
+      [ "floyd-warshall", "dijkstra" ].indexOf(algorithm.toLowerCase()) === -1) {
+    THROW(null, INTERNAL.errors.ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, func);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock JSF_aql_general_graph_absolute_betweenness
 ///
@@ -8718,30 +8770,112 @@ function AQL_GRAPH_ABSOLUTE_BETWEENNESS (graphName, options) {
   if (! options.direction) {
     options.direction =  'any';
   }
-  options.algorithm = "Floyd-Warshall";
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_ABSOLUTE_BETWEENNESS", options);
 
-  // Make sure we ONLY extract _ids
-  options.includeData = false;
   let graph = graphModule._graph(graphName);
   let vertexCollections = graph._vertexCollections().map(function (c) { return c.name();});
   let vertexIds = DOCUMENT_IDS_BY_EXAMPLE(vertexCollections, {});
-  let result = {};
-  let distanceMap = AQL_GRAPH_SHORTEST_PATH(graphName, vertexIds , vertexIds, options);
-  for (let k = 0; k < vertexIds.length; k++) {
-    result[vertexIds[k]] = 0;
-  }
-  distanceMap.forEach(function(d) {
-    let startVertex = d.vertices[0];
-    let l = d.vertices.length;
-    let targetVertex = d.vertices[l - 1];
-    let val = 1 / l;
-    d.vertices.forEach(function (v) {
-      if (v === startVertex || v === targetVertex) {
-        return;
-      }
-      result[v] += val;
-    });
+  let edges = RESOLVE_GRAPH_TO_DOCUMENTS(graphName, options, "GRAPH_ABSOLUTE_BETWEENNESS").edges;
+  let n = vertexIds.length;
+  let positions = {};
+  let neighbors = [];
+
+  for (let k = 0; k < n; k++) {
+    positions[vertexIds[k]] = k;
+    neighbors.push([]);
+  }
+
+  edges.forEach(function (e) {
+    let from = positions[e._from];
+    let to = positions[e._to];
+    let weight = DETERMINE_WEIGHT(e, options.weight, options.defaultWeight);
+
+    if (from === undefined || to === undefined || weight === Infinity || weight !== weight) {
+      // the edge cannot be followed
+      return;
+    }
+    if (options.direction !== 'inbound') {
+      neighbors[from].push({ vertex: to, weight: weight });
+    }
+    if (options.direction !== 'outbound') {
+      neighbors[to].push({ vertex: from, weight: weight });
+    }
   });
+
+  // Brandes' algorithm: one shortest path search per source vertex, counting
+  // the shortest paths to each vertex, then accumulating the dependencies in
+  // order of decreasing distance
+  let betweenness = [];
+  for (let k = 0; k < n; k++) {
+    betweenness.push(0);
+  }
+
+  for (let source = 0; source < n; source++) {
+    let dist = [], sigma = [], predecessors = [], delta = [], settled = [], order = [];
+
+    for (let k = 0; k < n; k++) {
+      dist.push(Infinity);
+      sigma.push(0);
+      predecessors.push([]);
+      delta.push(0);
+      settled.push(false);
+    }
+    dist[source] = 0;
+    sigma[source] = 1;
+
+    while (true) {
+      // the graphs handled here are small, so the next vertex is found by a
+      // linear scan instead of a priority queue
+      let v = -1;
+      for (let k = 0; k < n; k++) {
+        if (! settled[k] && dist[k] !== Infinity && (v === -1 || dist[k] < dist[v])) {
+          v = k;
+        }
+      }
+      if (v === -1) {
+        break;
+      }
+
+      settled[v] = true;
+      order.push(v);
+
+      neighbors[v].forEach(function (neighbor) {
+        let w = neighbor.vertex;
+        if (settled[w]) {
+          return;
+        }
+
+        let next = dist[v] + neighbor.weight;
+        if (next < dist[w]) {
+          dist[w] = next;
+          sigma[w] = sigma[v];
+          predecessors[w] = [ v ];
+        }
+        else if (next === dist[w]) {
+          sigma[w] += sigma[v];
+          predecessors[w].push(v);
+        }
+      });
+    }
+
+    for (let j = order.length - 1; j >= 0; j--) {
+      let w = order[j];
+      let factor = (1 + delta[w]) / sigma[w];
+
+      predecessors[w].forEach(function (v) {
+        delta[v] += sigma[v] * factor;
+      });
+
+      if (w !== source) {
+        betweenness[w] += delta[w];
+      }
+    }
+  }
+
+  let result = {};
+  for (let k = 0; k < n; k++) {
+    result[vertexIds[k]] = betweenness[k];
+  }
   return result;
 }
 
@@ -8810,6 +8944,7 @@ function AQL_GRAPH_BETWEENNESS (graphName, options) {
   'use strict';
 
   options = CLONE(options) || {};
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_BETWEENNESS", options);
 
   var result = AQL_GRAPH_ABSOLUTE_BETWEENNESS(graphName, options),  max = 0;
   Object.keys(result).forEach(function (r) {
@@ -8896,6 +9031,7 @@ function AQL_GRAPH_RADIUS (graphName, options) {
   if (! options.direction) {
     options.direction =  'any';
   }
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_RADIUS", options);
   if (! options.algorithm) {
     options.algorithm = "Floyd-Warshall";
   }
@@ -8985,6 +9121,7 @@ function AQL_GRAPH_DIAMETER (graphName, options) {
   if (! options.direction) {
     options.direction =  'any';
   }
+  CHECK_SHORTEST_PATH_ALGORITHM("GRAPH_DIAMETER", options);
   if (! options.algorithm) {
     options.algorithm = "Floyd-Warshall";
   }
@@ -9108,6 +9245,7 @@ exports.AQL_STDDEV_POPULATION = AQL_STDDEV_POPULATION;
 exports.AQL_NEAR = AQL_NEAR;
 exports.AQL_WITHIN = AQL_WITHIN;
 exports.AQL_WITHIN_RECTANGLE = AQL_WITHIN_RECTANGLE;
+exports.AQL_WITHIN_POLYGON = AQL_WITHIN_POLYGON;
 exports.AQL_IS_IN_POLYGON = AQL_IS_IN_POLYGON;
 exports.AQL_FULLTEXT = AQL_FULLTEXT;
 exports.AQL_PATHS = AQL_PATHS;
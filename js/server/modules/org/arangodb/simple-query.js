@@ -45,6 +45,7 @@ var SimpleQueryNear = sq.SimpleQueryNear;
 var SimpleQueryRange = sq.SimpleQueryRange;
 var SimpleQueryWithin = sq.SimpleQueryWithin;
 var SimpleQueryWithinRectangle = sq.SimpleQueryWithinRectangle;
+var SimpleQueryWithinPolygon = sq.SimpleQueryWithinPolygon;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief rewrites an index id by stripping the collection name from it
@@ -1283,138 +1284,123 @@ SimpleQueryWithinRectangle.prototype.execute = function () {
     };
   }
   else {
-    var distanceMeters = function (lat1, lon1, lat2, lon2) {  
-      var deltaLat = (lat2 - lat1) * Math.PI / 180;
-      var deltaLon = (lon2 - lon1) * Math.PI / 180;
-      var a = Math.sin(deltaLat / 2) * Math.sin(deltaLat / 2) +
-              Math.cos(lat1 * Math.PI / 180) * Math.cos(lat2 * Math.PI / 180) *
-              Math.sin(deltaLon / 2) * Math.sin(deltaLon / 2);
-      var c = 2 * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a));
-
-      return 6378.137 /* radius of earth in kilometers */  
-             * c 
-             * 1000; // kilometers to meters;
+    result = this._collection.WITHIN_RECTANGLE(this._index,
+                                               this._latitude1,
+                                               this._longitude1,
+                                               this._latitude2,
+                                               this._longitude2);
+
+    documents = {
+      documents: result.documents,
+      count: result.documents.length,
+      total: result.documents.length
     };
+    
+    if (this._limit > 0) {
+      documents.documents = documents.documents.slice(0, this._skip + this._limit);
+    }
+  }
 
-    var diameter = distanceMeters(this._latitude1, this._longitude1, this._latitude2, this._longitude2);
-    var midpoint = [ 
-      this._latitude1 + (this._latitude2 - this._latitude1) * 0.5, 
-      this._longitude1 + (this._longitude2 - this._longitude1) * 0.5 
-    ];
+  this._execution = new GeneralArrayCursor(documents.documents, this._skip, null);
+  this._countQuery = documents.total - this._skip;
+  this._countTotal = documents.total;
+};
 
-    result = this._collection.WITHIN(this._index, midpoint[0], midpoint[1], diameter);
+// -----------------------------------------------------------------------------
+// --SECTION--                                        SIMPLE QUERY WITHINPOLYGON
+// -----------------------------------------------------------------------------
 
-    var idx = this._collection.index(this._index);
-    var latLower, latUpper, lonLower, lonUpper;
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
 
-    if (this._latitude1 < this._latitude2) {
-      latLower = this._latitude1;
-      latUpper = this._latitude2;
-    }
-    else {
-      latLower = this._latitude2;
-      latUpper = this._latitude1;
-    }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a within-polygon query
+////////////////////////////////////////////////////////////////////////////////
 
-    if (this._longitude1 < this._longitude2) {
-      lonLower = this._longitude1;
-      lonUpper = this._longitude2;
-    }
-    else {
-      lonLower = this._longitude2;
-      lonUpper = this._longitude1;
-    }
-      
-    var deref = function(doc, parts) {
-      if (parts.length === 1) {
-        return doc[parts[0]];
-      }
+SimpleQueryWithinPolygon.prototype.execute = function () {
+  var result;
+  var documents;
 
-      var i = 0;
-      try {
-        while (i < parts.length && doc !== null && doc !== undefined) {
-          doc = doc[parts[i]];
-          ++i;
-        }
-        return doc;
-      }
-      catch (err) {
-        return null;
-      }
-    }; 
+  if (this._execution !== null) {
+    return;
+  }
 
-    documents = [ ];
-    if (idx.type === 'geo1') {
-      // geo1, we have both coordinates in a list
-      var attribute = idx.fields[0];
-      var parts = attribute.split(".");
-    
-      if (idx.geoJson) {
-        result.documents.forEach(function(document) {
-          var doc = deref(document, parts);
-          if (! Array.isArray(doc)) {
-            return;
-          }
+  if (this._skip === null) {
+    this._skip = 0;
+  }
 
-          // check if within bounding rectangle
-          // first list value is longitude, then latitude
-          if (doc[1] >= latLower && doc[1] <= latUpper &&
-              doc[0] >= lonLower && doc[0] <= lonUpper) {
-            documents.push(document);
-          }
-        });
-      }
-      else {
-        result.documents.forEach(function(document) {
-          var doc = deref(document, parts);
-          if (! Array.isArray(doc)) {
-            return;
-          }
+  if (this._skip < 0) {
+    var err = new ArangoError();
+    err.errorNum = internal.errors.ERROR_BAD_PARAMETER.code;
+    err.errorMessage = "skip must be non-negative";
+    throw err;
+  }
 
-          // check if within bounding rectangle
-          // first list value is latitude, then longitude
-          if (doc[0] >= latLower && doc[0] <= latUpper &&
-              doc[1] >= lonLower && doc[1] <= lonUpper) {
-            documents.push(document);
-          }
-        });
+  var cluster = require("org/arangodb/cluster");
+
+  if (cluster.isCoordinator()) {
+    var dbName = require("internal").db._name();
+    var shards = cluster.shardList(dbName, this._collection.name());
+    var coord = { coordTransactionID: ArangoClusterInfo.uniqid() };
+    var options = { coordTransactionID: coord.coordTransactionID, timeout: 360 };
+    var _limit = 0;
+    if (this._limit > 0) {
+      if (this._skip >= 0) {
+        _limit = this._skip + this._limit;
       }
     }
-    else {
-      // geo2, we have dedicated latitude and longitude attributes
-      var latAtt = idx.fields[0], lonAtt = idx.fields[1];
-      var latParts = latAtt.split(".");
-      var lonParts = lonAtt.split(".");
-
-      result.documents.forEach(function(document) {
-        var latDoc = deref(document, latParts);
-        if (latDoc === null || latDoc === undefined) {
-          return;
-        }
-        var lonDoc = deref(document, lonParts);
-        if (lonDoc === null || lonDoc === undefined) {
-          return;
-        }
 
-        // check if within bounding rectangle
-        if (latDoc >= latLower && latDoc <= latUpper &&
-            lonDoc >= lonLower && lonDoc <= lonUpper) {
-          documents.push(document);
-        }
-      });
+    var self = this;
+    shards.forEach(function (shard) {
+      ArangoClusterComm.asyncRequest("put",
+                                     "shard:" + shard,
+                                     dbName,
+                                     "/_api/simple/within-polygon",
+                                     JSON.stringify({
+                                       collection: shard,
+                                       polygon: self._polygon,
+                                       geo: rewriteIndex(self._index),
+                                       skip: 0,
+                                       limit: _limit || undefined,
+                                       batchSize: 100000000
+                                     }),
+                                     { },
+                                     options);
+    });
+
+    var _documents = [ ], total = 0;
+    result = cluster.wait(coord, shards);
+
+    result.forEach(function(part) {
+      var body = JSON.parse(part.body);
+      total += body.total;
+
+      _documents = _documents.concat(body.result);
+    });
+
+    if (this._limit > 0) {
+      _documents = _documents.slice(0, this._skip + this._limit);
     }
-    
+
+    documents = {
+      documents: _documents,
+      count: _documents.length,
+      total: total
+    };
+  }
+  else {
+    result = this._collection.WITHIN_POLYGON(this._index, this._polygon);
+
     documents = {
-      documents: documents,
+      documents: result.documents,
       count: result.documents.length,
       total: result.documents.length
     };
     
     if (this._limit > 0) {
       documents.documents = documents.documents.slice(0, this._skip + this._limit);
-      documents.count = documents.documents.length;
     }
-
   }
 
   this._execution = new GeneralArrayCursor(documents.documents, this._skip, null);
@@ -1529,6 +1515,7 @@ exports.SimpleQueryNear = SimpleQueryNear;
 exports.SimpleQueryRange = SimpleQueryRange;
 exports.SimpleQueryWithin = SimpleQueryWithin;
 exports.SimpleQueryWithinRectangle = SimpleQueryWithinRectangle;
+exports.SimpleQueryWithinPolygon = SimpleQueryWithinPolygon;
 exports.byExample = byExample;
 
 // -----------------------------------------------------------------------------
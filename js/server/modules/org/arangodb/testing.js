@@ -43,7 +43,11 @@ var functionsDocumentation = {
     "            Run without to get more detail",
   "single_server"     : "run one test suite on the server; options required\n" + 
     "            Run without to get more detail",
-  "single_localserver": "run on this very instance of arangod, don't fork a new one.\n"
+  "single_localserver": "run on this very instance of arangod, don't fork a new one.\n",
+  "index_checkpoints" : "run the primary index checkpoint tests on a server with\n" +
+    "            --database.index-checkpoints turned on",
+  "preload_collections": "restart a server with --database.preload-collections and\n" +
+    "            check that the collections are loaded"
 };
 
 var optionsDocumentation = [
@@ -159,7 +163,9 @@ var allTests =
     "importing",
     "upgrade",
     "authentication",
-    "authentication_parameters"
+    "authentication_parameters",
+    "index_checkpoints",
+    "preload_collections"
   ];
 
 
@@ -1951,6 +1957,80 @@ testFuncs.arangob = function (options) {
   return results;
 };
 
+testFuncs.index_checkpoints = function (options) {
+  if (options.cluster) {
+    print("skipping index checkpoint tests in cluster mode!");
+    return {};
+  }
+
+  print("Index checkpoint tests...");
+  var instanceInfo = startInstance("tcp", options,
+                                   {"database.index-checkpoints": "true"},
+                                   "index_checkpoints");
+  if (instanceInfo === false) {
+    return {status: false, message: "failed to start server!"};
+  }
+  var results = {};
+  var te = makePathUnix("js/server/tests/index-checkpoints-noncluster.js");
+  results[te] = runThere(options, instanceInfo, te);
+  print("Shutting down...");
+  shutdownInstance(instanceInfo,options);
+  print("done.");
+  if ((!options.skipLogAnalysis) &&
+      instanceInfo.hasOwnProperty('importantLogLines') &&
+      Object.keys(instanceInfo.importantLogLines).length > 0) {
+    print("Found messages in the server logs: \n" + yaml.safeDump(instanceInfo.importantLogLines));
+  }
+  return results;
+};
+
+testFuncs.preload_collections = function (options) {
+  if (options.cluster) {
+    print("skipping collection preload tests in cluster mode!");
+    return {};
+  }
+
+  print("Collection preload tests...");
+  var instanceInfo = startInstance("tcp", options, {}, "preload_collections");
+  if (instanceInfo === false) {
+    return {status: false, message: "failed to start server!"};
+  }
+  var results = {};
+  print(Date() + ": Setting up");
+  results.setup = runInArangosh(options, instanceInfo,
+       makePathUnix("js/server/tests/preload-collections-setup.js"));
+  print("Shutting down...");
+  shutdownInstance(instanceInfo,options);
+
+  if (results.setup.status === true) {
+    // restart on the same database directory
+    print(Date() + ": Restarting with preloaded collections");
+    instanceInfo = startInstance("tcp", options,
+                                 {"flatCommands": [
+                                   "--database.preload-collections", "UnitTestsPreload0",
+                                   "--database.preload-collections", "UnitTestsPreload1",
+                                   "--database.preload-collections", "_system/UnitTestsPreload2",
+                                   "--database.preload-collections", "UnitTestsPreloadDb/*"
+                                 ]},
+                                 "preload_collections",
+                                 instanceInfo.flatTmpDataDir);
+    if (instanceInfo === false) {
+      return {status: false, message: "failed to restart server!"};
+    }
+    var te = makePathUnix("js/server/tests/preload-collections-noncluster.js");
+    results[te] = runThere(options, instanceInfo, te);
+    print("Shutting down...");
+    shutdownInstance(instanceInfo,options);
+  }
+  print("done.");
+  if ((!options.skipLogAnalysis) &&
+      instanceInfo.hasOwnProperty('importantLogLines') &&
+      Object.keys(instanceInfo.importantLogLines).length > 0) {
+    print("Found messages in the server logs: \n" + yaml.safeDump(instanceInfo.importantLogLines));
+  }
+  return results;
+};
+
 testFuncs.authentication = function (options) {
   if (options.skipAuth === true) {
     print("skipping Authentication tests!");
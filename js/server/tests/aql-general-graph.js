@@ -32,6 +32,7 @@ var jsunity = require("jsunity");
 var db = require("org/arangodb").db;
 var graph = require("org/arangodb/general-graph");
 var helper = require("org/arangodb/aql-helper");
+var errors = require("internal").errors;
 var getQueryResults = helper.getQueryResults;
 var getRawQueryResults = helper.getRawQueryResults;
 
@@ -1842,7 +1843,6 @@ function ahuacatlQueryGeneralTraversalTestSuite() {
       assertEqual(actual[0]["UnitTests_Leipziger/Gerda"].toFixed(2), (1).toFixed(2));
     },
 
-    /*
     testGRAPH_BETWEENNESS: function () {
       var actual;
 
@@ -1855,18 +1855,16 @@ function ahuacatlQueryGeneralTraversalTestSuite() {
       assertEqual(actual[0]["UnitTests_Hamburger/Dieter"], 16);
       assertEqual(actual[0]["UnitTests_Leipziger/Gerda"], 18);
 
-
       actual = getQueryResults("RETURN GRAPH_BETWEENNESS('werKenntWen', {algorithm : 'Floyd-Warshall'})");
 
       assertEqual(actual[0]["UnitTests_Berliner/Anton"], 0);
-      assertEqual(actual[0]["UnitTests_Berliner/Berta"].toFixed(2), 0.89);
-      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), 0.56);
+      assertEqual(actual[0]["UnitTests_Berliner/Berta"].toFixed(2), (0.89).toFixed(2));
+      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), (0.56).toFixed(2));
       assertEqual(actual[0]["UnitTests_Frankfurter/Fritz"], 0);
       assertEqual(actual[0]["UnitTests_Hamburger/Caesar"], 0);
-      assertEqual(actual[0]["UnitTests_Hamburger/Dieter"].toFixed(2), 0.89);
+      assertEqual(actual[0]["UnitTests_Hamburger/Dieter"].toFixed(2), (0.89).toFixed(2));
       assertEqual(actual[0]["UnitTests_Leipziger/Gerda"], 1);
 
-
       actual = getQueryResults("RETURN GRAPH_ABSOLUTE_BETWEENNESS('werKenntWen', {algorithm : 'Floyd-Warshall', direction : 'inbound'})");
       assertEqual(actual[0]["UnitTests_Berliner/Anton"], 0);
       assertEqual(actual[0]["UnitTests_Berliner/Berta"], 4);
@@ -1878,27 +1876,63 @@ function ahuacatlQueryGeneralTraversalTestSuite() {
 
       actual = getQueryResults("RETURN GRAPH_BETWEENNESS('werKenntWen', {algorithm : 'Floyd-Warshall', direction : 'inbound'})");
       assertEqual(actual[0]["UnitTests_Berliner/Anton"], 0);
-      assertEqual(actual[0]["UnitTests_Berliner/Berta"].toFixed(2), 0.67);
-      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), 0.67);
+      assertEqual(actual[0]["UnitTests_Berliner/Berta"].toFixed(2), (0.67).toFixed(2));
+      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), (0.67).toFixed(2));
       assertEqual(actual[0]["UnitTests_Frankfurter/Fritz"], 0);
       assertEqual(actual[0]["UnitTests_Hamburger/Caesar"], 0);
       assertEqual(actual[0]["UnitTests_Hamburger/Dieter"], 1);
       assertEqual(actual[0]["UnitTests_Leipziger/Gerda"], 1);
 
-
+      actual = getQueryResults("RETURN GRAPH_ABSOLUTE_BETWEENNESS('werKenntWen', {weight : 'entfernung', defaultWeight : 80, algorithm : 'Floyd-Warshall'})");
+      assertEqual(actual[0]["UnitTests_Berliner/Anton"], 0);
+      assertEqual(actual[0]["UnitTests_Berliner/Berta"], 18);
+      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"], 10);
+      assertEqual(actual[0]["UnitTests_Frankfurter/Fritz"], 0);
+      assertEqual(actual[0]["UnitTests_Hamburger/Caesar"], 0);
+      assertEqual(actual[0]["UnitTests_Hamburger/Dieter"], 16);
+      assertEqual(actual[0]["UnitTests_Leipziger/Gerda"], 18);
 
       actual = getQueryResults("RETURN GRAPH_BETWEENNESS('werKenntWen', {weight : 'entfernung', defaultWeight : 80, algorithm : 'Floyd-Warshall'})");
       assertEqual(actual[0]["UnitTests_Berliner/Anton"], 0);
       assertEqual(actual[0]["UnitTests_Berliner/Berta"], 1);
-      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), 0.56);
+      assertEqual(actual[0]["UnitTests_Frankfurter/Emil"].toFixed(2), (0.56).toFixed(2));
       assertEqual(actual[0]["UnitTests_Frankfurter/Fritz"], 0);
       assertEqual(actual[0]["UnitTests_Hamburger/Caesar"], 0);
-      assertEqual(actual[0]["UnitTests_Hamburger/Dieter"].toFixed(2), 0.89);
+      assertEqual(actual[0]["UnitTests_Hamburger/Dieter"].toFixed(2), (0.89).toFixed(2));
       assertEqual(actual[0]["UnitTests_Leipziger/Gerda"], 1);
+    },
+
+    testGRAPH_MEASUREMENTS_UNKNOWN_GRAPH: function () {
+      [ "GRAPH_BETWEENNESS", "GRAPH_ABSOLUTE_BETWEENNESS", "GRAPH_CLOSENESS", "GRAPH_ECCENTRICITY", "GRAPH_DIAMETER", "GRAPH_RADIUS" ].forEach(function (f) {
+        try {
+          getQueryResults("RETURN " + f + "('UnitTestsThisGraphDoesNotExist')");
+          fail();
+        }
+        catch (err) {
+          assertEqual(errors.ERROR_GRAPH_INVALID_GRAPH.code, err.errorNum);
+        }
+      });
+    },
 
+    testGRAPH_MEASUREMENTS_ALGORITHM: function () {
+      [ "GRAPH_BETWEENNESS", "GRAPH_ABSOLUTE_BETWEENNESS", "GRAPH_CLOSENESS", "GRAPH_ECCENTRICITY", "GRAPH_DIAMETER", "GRAPH_RADIUS" ].forEach(function (f) {
+        // all algorithms compute exact shortest paths
+        var expected = getQueryResults("RETURN " + f + "('werKenntWen', {algorithm : 'Floyd-Warshall'})");
+        assertEqual(expected, getQueryResults("RETURN " + f + "('werKenntWen', {algorithm : 'dijkstra'})"));
+        assertEqual(expected, getQueryResults("RETURN " + f + "('werKenntWen', {algorithm : 'Dijkstra'})"));
+        assertEqual(expected, getQueryResults("RETURN " + f + "('werKenntWen')"));
 
+        [ "'foo'", "1", "[ ]" ].forEach(function (algorithm) {
+          try {
+            getQueryResults("RETURN " + f + "('werKenntWen', {algorithm : " + algorithm + "})");
+            fail();
+          }
+          catch (err) {
+            assertEqual(errors.ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH.code, err.errorNum);
+          }
+        });
+      });
     },
-*/
 
     testGRAPH_DIAMETER_AND_RADIUS: function () {
       var actual;
@@ -1941,6 +1975,22 @@ function ahuacatlQueryGeneralTraversalTestSuite() {
       assertEqual(actual[0].toFixed(1), 830.3);
     },
 
+    testGRAPH_DIAMETER_AFTER_MODIFICATION: function () {
+      var actual;
+      // the second call uses the cached edges of the first one
+      actual = getQueryResults("RETURN GRAPH_DIAMETER('werKenntWen')");
+      assertEqual(actual[0], 5);
+      actual = getQueryResults("RETURN GRAPH_DIAMETER('werKenntWen')");
+      assertEqual(actual[0], 5);
+
+      db.UnitTests_KenntAnderen.save(vertexIds.Caesar, vertexIds.Emil, { what: "Caesar->Emil", entfernung: 1 });
+
+      actual = getQueryResults("RETURN GRAPH_DIAMETER('werKenntWen')");
+      assertEqual(actual[0], 3);
+      actual = getQueryResults("RETURN GRAPH_DIAMETER('werKenntWen')");
+      assertEqual(actual[0], 3);
+    },
+
     testGRAPH_SHORTEST_PATHWithExamples: function () {
       var actual;
 
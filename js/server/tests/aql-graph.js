@@ -535,6 +535,47 @@ function ahuacatlQueryNeighborsTestSuite () {
       // Should be able to handle internal attributes
       actual = getQueryResults(query, {startId: v3, examples: {_to: v4}});
       assertEqual(actual, [ v4 ]);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks NEIGHBORS() after modifications of the edge collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testNeighborsRepeatedWithModifications : function () {
+      var v1 = "UnitTestsAhuacatlVertex/v1";
+      var v2 = "UnitTestsAhuacatlVertex/v2";
+      var v3 = "UnitTestsAhuacatlVertex/v3";
+      var v4 = "UnitTestsAhuacatlVertex/v4";
+      var v5 = "UnitTestsAhuacatlVertex/v5";
+      var v6 = "UnitTestsAhuacatlVertex/v6";
+      var v7 = "UnitTestsAhuacatlVertex/v7";
+      var query = "FOR n IN NEIGHBORS(UnitTestsAhuacatlVertex, UnitTestsAhuacatlEdge, @startId"
+                + ", @direction) SORT n RETURN n";
+      var i;
+
+      // repeated queries on an unmodified collection
+      for (i = 0; i < 3; ++i) {
+        assertEqual([ v4, v6, v7 ], getQueryResults(query, { startId: v3, direction: "outbound" }));
+        assertEqual([ v1, v2, v6, v7 ], getQueryResults(query, { startId: v3, direction: "inbound" }));
+        assertEqual([ v1, v2, v4, v6, v7 ], getQueryResults(query, { startId: v3, direction: "any" }));
+      }
+
+      edge.remove("v3_v4");
+      edge.save(v3, v5, { _key: "v3_v5" });
+      // self-loops never produce a neighbor
+      edge.save(v3, v3, { _key: "v3_v3" });
+
+      for (i = 0; i < 3; ++i) {
+        assertEqual([ v5, v6, v7 ], getQueryResults(query, { startId: v3, direction: "outbound" }));
+        assertEqual([ v3 ], getQueryResults(query, { startId: v5, direction: "any" }));
+        assertEqual([ v2 ], getQueryResults(query, { startId: v4, direction: "any" }));
+      }
+
+      edge.truncate();
+
+      for (i = 0; i < 3; ++i) {
+        assertEqual([ ], getQueryResults(query, { startId: v3, direction: "any" }));
+      }
     }
 
   };
@@ -1112,6 +1153,63 @@ function ahuacatlQueryShortestPathTestSuite () {
       assertEqual([ "A", "B", "C", "D", "E", "G", "H" ], actual);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shortest path with weights read from an edge attribute
+////////////////////////////////////////////////////////////////////////////////
+
+    testShortestPathDijkstraWeightAttribute : function () {
+      var config = {
+        weight: "weight",
+        defaultWeight: 1,
+        _sort: true
+      };
+
+      var actual = getQueryResults("RETURN SHORTEST_PATH(@@v, @@e, '" + vn + "/A', '" + vn + "/H', 'outbound', " + JSON.stringify(config) + ")", { "@v" : vn, "@e" : en }); 
+
+      assertEqual(1, actual.length);
+      assertEqual([ "A", "B", "C", "D", "E", "G", "H" ].map(function (v) { return vn + "/" + v; }), actual[0].vertices);
+      assertEqual([ "AB", "BC", "CD", "DE", "EG", "GH" ].map(function (e) { return en + "/" + e; }), actual[0].edges);
+      assertEqual(20, actual[0].distance);
+      
+      // non-numeric weights use the default weight
+      edgeCollection.update(en + "/AD", { weight: "heavy" });
+      config.defaultWeight = 2;
+      actual = getQueryResults("RETURN SHORTEST_PATH(@@v, @@e, '" + vn + "/A', '" + vn + "/H', 'outbound', " + JSON.stringify(config) + ")", { "@v" : vn, "@e" : en }); 
+      assertEqual([ "A", "D", "E", "G", "H" ].map(function (v) { return vn + "/" + v; }), actual[0].vertices);
+      assertEqual(15, actual[0].distance);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shortest path between vertices with many neighbors
+////////////////////////////////////////////////////////////////////////////////
+
+    testShortestPathWideFrontiers : function () {
+      var i;
+
+      vertexCollection.save({ _key: "S" });
+      vertexCollection.save({ _key: "T" });
+      for (i = 0; i < 100; ++i) {
+        vertexCollection.save({ _key: "M" + i });
+        vertexCollection.save({ _key: "N" + i });
+        edgeCollection.save(vn + "/S", vn + "/M" + i, { });
+        edgeCollection.save(vn + "/M" + i, vn + "/N" + i, { });
+        edgeCollection.save(vn + "/N" + i, vn + "/T", { });
+      }
+
+      [ "outbound", "inbound", "any" ].forEach(function (direction) {
+        var from = (direction === "inbound" ? "T" : "S");
+        var to = (direction === "inbound" ? "S" : "T");
+        var actual = getQueryResults("RETURN SHORTEST_PATH(@@v, @@e, '" + vn + "/" + from + "', '" + vn + "/" + to + "', @direction, { })", { "@v" : vn, "@e" : en, direction: direction }); 
+
+        assertEqual(1, actual.length);
+        assertEqual(3, actual[0].distance);
+        assertEqual(4, actual[0].vertices.length);
+        assertEqual(3, actual[0].edges.length);
+        assertEqual(vn + "/" + from, actual[0].vertices[0]);
+        assertEqual(vn + "/" + to, actual[0].vertices[3]);
+      });
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief shortest path with vertex filter function
 ////////////////////////////////////////////////////////////////////////////////
@@ -443,6 +443,53 @@ function optimizerIndexesTestSuite () {
       assertEqual([ [ [ 'test1' ], [ 'test2' ], [ 'test3' ], [ 'test4' ], [ 'test5' ], [ 'test6' ], [ 'test7' ], [ 'test8' ], [ 'test9' ], [ 'test10' ] ] ], results.json);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test index usage with repeated lookup values
+////////////////////////////////////////////////////////////////////////////////
+
+    testJoinRepeatedLookupValues : function () {
+      c.dropIndex(c.getIndexes()[1]); // drop skiplist index
+      c.ensureHashIndex("value");
+      for (var i = 0; i < 10; ++i) {
+        c.save({ value: i % 3 });
+      }
+
+      var options = { optimizer: { rules: [ "-use-hash-join" ] } };
+      var queries = [
+        [ "FOR i IN 1..3000 FOR j IN " + c.name() + " FILTER j.value == i % 7 SORT i RETURN [ i, j.value ]", "hash" ],
+        [ "FOR i IN 1..3000 FOR j IN " + c.name() + " FILTER j._key == CONCAT('test', i % 7) SORT i RETURN [ i, j.value ]", "primary" ]
+      ];
+
+      queries.forEach(function(query) {
+        var plan = AQL_EXPLAIN(query[0], { }, options).plan;
+        var indexNodes = 0;
+        plan.nodes.forEach(function(node) {
+          if (node.type === "IndexRangeNode") {
+            ++indexNodes;
+            assertEqual(query[1], node.index.type);
+          }
+        });
+        assertEqual(1, indexNodes);
+
+        var expected = [ ];
+        for (var i = 1; i <= 3000; ++i) {
+          var value = i % 7;
+          // the hash query also finds the additional documents
+          var n = 1;
+          if (query[1] === "hash" && value < 3) {
+            n += (value === 0 ? 4 : 3);
+          }
+          for (var k = 0; k < n; ++k) {
+            expected.push([ i, value ]);
+          }
+        }
+
+        var results = AQL_EXECUTE(query[0], { }, options);
+        assertEqual(0, results.stats.scannedFull);
+        assertEqual(expected, results.json);
+      });
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test index usage
 ////////////////////////////////////////////////////////////////////////////////
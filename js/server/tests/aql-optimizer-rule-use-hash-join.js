@@ -0,0 +1,260 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var helper = require("org/arangodb/aql-helper");
+var db = require("org/arangodb").db;
+var removeAlwaysOnClusterRules = helper.removeAlwaysOnClusterRules;
+var removeClusterNodes = helper.removeClusterNodes;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "use-hash-join";
+  // various choices to control the optimizer: 
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var c1, c2;
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsCollection1");
+      db._drop("UnitTestsCollection2");
+      c1 = db._create("UnitTestsCollection1");
+      c2 = db._create("UnitTestsCollection2");
+
+      var i;
+      for (i = 0; i < 100; ++i) {
+        c1.save({ _key: "test" + i, value: i, sub: { value: i % 10 } });
+      }
+      for (i = 0; i < 200; ++i) {
+        c2.save({ _key: "test" + i, value: i % 50, ref: "test" + (i % 20), sub: { value: i % 5 } });
+      }
+      c2.save({ _key: "nulls" });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsCollection1");
+      db._drop("UnitTestsCollection2");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var queries = [ 
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value == j.value RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value RETURN [ i, j ]"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramNone);
+        assertEqual([ ], removeAlwaysOnClusterRules(result.plan.rules));
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has no effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [ 
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value != j.value RETURN [ i, j ]", // not an equality
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value < j.value RETURN [ i, j ]", // not an equality
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == 1 RETURN [ i, j ]", // constant value
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == j.sub.value RETURN [ i, j ]", // same variable
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j == i RETURN [ i, j ]", // no attribute
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value + RAND() RETURN [ i, j ]", // non-deterministic
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value || j.value == 1 RETURN [ i, j ]", // or condition
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value REMOVE j IN " + c2.name(), // data-modification
+        "FOR i IN " + c1.name() + " FOR j IN 1..10 FILTER j == i.value RETURN [ i, j ]", // no collection
+        "FOR i IN " + c1.name() + " FILTER i.value == 1 RETURN i" // no join
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rule has an effect
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleHasEffect : function () {
+      var queries = [ 
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value == j.value RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.sub.value == i.sub.value RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.ref == i._key RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j._key == i._key RETURN [ i, j ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value + 1 RETURN [ i, j ]"
+      ];
+
+      queries.forEach(function(query) {
+        var result = AQL_EXPLAIN(query, { }, paramEnabled);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        var nodeTypes = result.plan.nodes.map(function(node) { return node.type; });
+        assertEqual(-1, nodeTypes.indexOf("FilterNode"), query);
+        var joinNode = nodeTypes.indexOf("HashJoinNode");
+        assertNotEqual(-1, joinNode, query);
+        assertEqual(c2.name(), result.plan.nodes[joinNode].collection, query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test generated plans
+////////////////////////////////////////////////////////////////////////////////
+
+    testPlans : function () {
+      var plans = [ 
+        [ "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value == j.value RETURN [ i, j ]", [ "SingletonNode", "EnumerateCollectionNode", "CalculationNode", "HashJoinNode", "CalculationNode", "ReturnNode" ], [ "value" ] ],
+        [ "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.sub.value == i.value RETURN j", [ "SingletonNode", "EnumerateCollectionNode", "CalculationNode", "HashJoinNode", "ReturnNode" ], [ "sub", "value" ] ],
+        [ "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value FILTER j.ref == 'test1' RETURN j", [ "SingletonNode", "EnumerateCollectionNode", "CalculationNode", "HashJoinNode", "CalculationNode", "FilterNode", "ReturnNode" ], [ "value" ] ]
+      ];
+
+      plans.forEach(function(plan) {
+        var result = AQL_EXPLAIN(plan[0], { }, paramEnabled);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), plan[0]);
+        assertEqual(plan[1], removeClusterNodes(helper.getCompactPlan(result).map(function(node) { return node.type; })), plan[0]);
+        var joinNode = result.plan.nodes.map(function(node) { return node.type; }).indexOf("HashJoinNode");
+        assertEqual(plan[2], result.plan.nodes[joinNode].attribute, plan[0]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var queries = [ 
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value == j.value SORT i._key, j._key RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.sub.value == i.sub.value SORT i._key, j._key RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.ref == i._key SORT i._key, j._key RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j._key == i._key SORT i._key RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value + 1 SORT i._key, j._key RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.missing == i.missing SORT i._key, j._key LIMIT 10, 20 RETURN [ i._key, j._key ]",
+        "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER i.value == j.value LIMIT 10 RETURN 1"
+      ];
+
+      queries.forEach(function(query) {
+        var planDisabled   = AQL_EXPLAIN(query, { }, paramNone);
+        var planEnabled    = AQL_EXPLAIN(query, { }, paramEnabled);
+        var resultDisabled = AQL_EXECUTE(query, { }, paramNone).json;
+        var resultEnabled  = AQL_EXECUTE(query, { }, paramEnabled).json;
+
+        assertEqual(-1, planDisabled.plan.rules.indexOf(ruleName), query);
+        assertNotEqual(-1, planEnabled.plan.rules.indexOf(ruleName), query);
+
+        assertEqual(resultDisabled, resultEnabled, query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results for join values that compare equal with a different
+/// attribute order or with null attributes
+////////////////////////////////////////////////////////////////////////////////
+
+    testResultsObjectValues : function () {
+      c1.toArray().forEach(function(doc) {
+        c1.update(doc, { obj: { a: doc.value % 10, b: "x" } });
+      });
+      c2.toArray().forEach(function(doc) {
+        c2.update(doc, { obj: { c: null, b: "x", a: doc.value === undefined ? 0 : doc.value % 10 } });
+      });
+
+      var query = "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.obj == i.obj SORT i._key, j._key RETURN [ i._key, j._key ]";
+      var planEnabled    = AQL_EXPLAIN(query, { }, paramEnabled);
+      var resultDisabled = AQL_EXECUTE(query, { }, paramNone).json;
+      var resultEnabled  = AQL_EXECUTE(query, { }, paramEnabled).json;
+
+      assertNotEqual(-1, planEnabled.plan.rules.indexOf(ruleName), query);
+      assertEqual(100 * 201 / 10, resultDisabled.length);
+      assertEqual(resultDisabled, resultEnabled, query);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the estimate takes several matches per item into account
+////////////////////////////////////////////////////////////////////////////////
+
+    testEstimateFanOut : function () {
+      var query = "FOR i IN " + c1.name() + " FILTER i.value < 10 FOR j IN " + c2.name() + " FILTER j.value == i.value RETURN [ i, j ]";
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      var nodes = result.plan.nodes;
+      var types = nodes.map(function(node) { return node.type; });
+      var joinNode = nodes[types.indexOf("HashJoinNode")];
+      var filterNode = nodes[types.indexOf("FilterNode")];
+
+      // each outer document matches several documents of the inner collection
+      assertTrue(joinNode.estimatedNrItems > filterNode.estimatedNrItems, query);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test results with an outer loop that produces no matches at all
+////////////////////////////////////////////////////////////////////////////////
+
+    testResultsNoMatches : function () {
+      var query = "FOR i IN " + c1.name() + " FOR j IN " + c2.name() + " FILTER j.value == i.value + 1000 RETURN [ i, j ]";
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query);
+
+      result = AQL_EXECUTE(query, { }, paramEnabled);
+      assertEqual([ ], result.json);
+      // the inner collection is scanned only once
+      assertEqual(100 + 201, result.stats.scannedFull);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
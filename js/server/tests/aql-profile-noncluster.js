@@ -0,0 +1,136 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, assertUndefined, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for profiling of query execution nodes
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function ahuacatlProfileTestSuite () {
+  var c = null;
+
+  var nodeStats = function (query, profile) {
+    var stats = AQL_EXECUTE(query, { }, { profile: profile }).stats;
+    var nodes = { };
+    (stats.nodes || [ ]).forEach(function (node) {
+      nodes[node.type] = node;
+    });
+    return nodes;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsAhuacatlProfile");
+      c = db._create("UnitTestsAhuacatlProfile");
+
+      for (var i = 0; i < 2500; ++i) {
+        c.save({ value: i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsAhuacatlProfile");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief no node statistics without profiling
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoProfile : function () {
+      var stats = AQL_EXECUTE("FOR d IN " + c.name() + " RETURN d", { }, { }).stats;
+
+      assertUndefined(stats.nodes);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rows and calls of each node
+////////////////////////////////////////////////////////////////////////////////
+
+    testRows : function () {
+      var nodes = nodeStats("FOR d IN " + c.name() + " FILTER d.value < 100 RETURN d.value", true);
+
+      assertEqual(1, nodes.SingletonNode.rowsOut);
+      assertEqual(1, nodes.EnumerateCollectionNode.rowsIn);
+      assertEqual(2500, nodes.EnumerateCollectionNode.rowsOut);
+      assertEqual(2500, nodes.FilterNode.rowsIn);
+      assertEqual(100, nodes.FilterNode.rowsOut);
+      assertEqual(100, nodes.ReturnNode.rowsIn);
+      assertEqual(100, nodes.ReturnNode.rowsOut);
+
+      [ "SingletonNode", "EnumerateCollectionNode", "CalculationNode", "FilterNode", "ReturnNode" ].forEach(function (type) {
+        var node = nodes[type];
+        assertTrue(node.calls > 0, type);
+        assertTrue(node.runtime >= 0, type);
+        assertTrue(node.peakMemory > 0, type);
+        assertEqual("number", typeof node.expressionRuntime, type);
+      });
+
+      assertTrue(nodes.ReturnNode.runtime >= nodes.FilterNode.runtime);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipped rows are counted
+////////////////////////////////////////////////////////////////////////////////
+
+    testSkip : function () {
+      var nodes = nodeStats("FOR d IN " + c.name() + " LIMIT 1000, 10 RETURN d.value", true);
+
+      assertTrue(nodes.EnumerateCollectionNode.rowsOut >= 1010);
+      assertEqual(10, nodes.LimitNode.rowsOut);
+      assertEqual(10, nodes.ReturnNode.rowsOut);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(ahuacatlProfileTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -146,6 +146,36 @@ function ahuacatlFulltextTestSuite () {
       assertEqual(2, actual.length);
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test ranking of fulltext results with a limit
+////////////////////////////////////////////////////////////////////////////////
+
+    testFulltextRanked : function () {
+      for (var i = 0; i < 50; ++i) {
+        fulltext.save({ id : 100 + i, text : "banana filler text here" });
+      }
+
+      fulltext.save({ id : 1, text : "a long text that mentions the apple only once among lots of other unrelated words in it" });
+      fulltext.save({ id : 2, text : "apple apple apple pie" });
+      fulltext.save({ id : 3, text : "apple pie" });
+     
+      var actual;
+      actual = getQueryResults("FOR d IN FULLTEXT(" + fulltext.name() + ", 'text', 'apple', 3) RETURN d.id");
+      assertEqual([ 2, 3, 1 ], actual);
+      
+      actual = getQueryResults("FOR d IN FULLTEXT(" + fulltext.name() + ", 'text', 'apple', 1) RETURN d.id");
+      assertEqual([ 2 ], actual);
+      
+      actual = getQueryResults("FOR d IN FULLTEXT(" + fulltext.name() + ", 'text', 'text,apple', 2) RETURN d.id");
+      assertEqual([ 1 ], actual);
+      
+      actual = getQueryResults("FOR d IN FULLTEXT(" + fulltext.name() + ", 'text', 'banana,|pie', 2) RETURN d.id");
+      assertEqual([ 3, 2 ], actual);
+      
+      actual = getQueryResults("FOR d IN FULLTEXT(" + fulltext.name() + ", 'text', 'apple,-pie', 5) RETURN d.id");
+      assertEqual([ 1 ], actual);
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test without fulltext index available
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,283 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, assertFalse, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for queries reading collections from snapshots
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("org/arangodb").db;
+var internal = require("internal");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function ahuacatlSnapshotReadsTestSuite () {
+  var c1 = null;
+  var c2 = null;
+  var cnResult = "UnitTestsAhuacatlSnapshotResult";
+
+  var execute = function (query, snapshotReads) {
+    return AQL_EXECUTE(query, { }, { snapshotReads: snapshotReads }).json;
+  };
+
+  var stats = function (query, options) {
+    return AQL_EXECUTE(query, { }, options).stats;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop("UnitTestsAhuacatlSnapshot1");
+      db._drop("UnitTestsAhuacatlSnapshot2");
+
+      c1 = db._create("UnitTestsAhuacatlSnapshot1");
+      c2 = db._create("UnitTestsAhuacatlSnapshot2");
+
+      var i;
+      for (i = 0; i < 2000; ++i) {
+        c1.save({ _key: "test" + i, value: i });
+      }
+      for (i = 0; i < 10; ++i) {
+        c2.save({ _key: "test" + i, value: i });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop("UnitTestsAhuacatlSnapshot1");
+      db._drop("UnitTestsAhuacatlSnapshot2");
+      db._drop(cnResult);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief full scan of a collection with more documents than a batch
+////////////////////////////////////////////////////////////////////////////////
+
+    testFullScan : function () {
+      var query = "FOR d IN " + c1.name() + " SORT d.value RETURN d.value";
+
+      [ true, false ].forEach(function (snapshotReads) {
+        var actual = execute(query, snapshotReads);
+        assertEqual(2000, actual.length);
+        for (var i = 0; i < 2000; ++i) {
+          assertEqual(i, actual[i]);
+        }
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief nested scans of two collections, the inner one is restarted
+////////////////////////////////////////////////////////////////////////////////
+
+    testNestedScans : function () {
+      var query = "FOR d1 IN " + c1.name() + " FOR d2 IN " + c2.name() + " FILTER d1.value == d2.value * 100 SORT d2.value RETURN [ d1._key, d2._key ]";
+
+      [ true, false ].forEach(function (snapshotReads) {
+        var actual = execute(query, snapshotReads);
+        assertEqual(10, actual.length);
+        for (var i = 0; i < 10; ++i) {
+          assertEqual([ "test" + (i * 100), "test" + i ], actual[i]);
+        }
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief self join and subquery on the same collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testSelfJoin : function () {
+      var query = "FOR d1 IN " + c2.name() + " LET s = (FOR d2 IN " + c2.name() + " FILTER d2.value <= d1.value RETURN 1) SORT d1.value RETURN LENGTH(s)";
+
+      [ true, false ].forEach(function (snapshotReads) {
+        var actual = execute(query, snapshotReads);
+        assertEqual([ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 ], actual);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief query in a transaction sees the transaction's own writes
+////////////////////////////////////////////////////////////////////////////////
+
+    testQueryInTransaction : function () {
+      var actual = db._executeTransaction({
+        collections: { write: [ c2.name() ] },
+        action: function (params) {
+          var c = require("org/arangodb").db._collection(params.name);
+          c.save({ _key: "test10", value: 10 });
+          return AQL_EXECUTE("FOR d IN " + params.name + " RETURN d.value").json;
+        },
+        params: { name: c2.name() }
+      });
+
+      assertEqual(11, actual.length);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief snapshots are only taken if requested
+////////////////////////////////////////////////////////////////////////////////
+
+    testSnapshotOptIn : function () {
+      var query = "FOR d IN " + c1.name() + " RETURN d.value";
+
+      assertFalse(stats(query, { }).hasOwnProperty("snapshotDocuments"));
+      assertFalse(stats(query, { snapshotReads: false }).hasOwnProperty("snapshotDocuments"));
+      assertEqual(2000, stats(query, { snapshotReads: true }).snapshotDocuments);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a query with a LIMIT does not copy the collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testLimitDoesNotCopy : function () {
+      [ "FOR d IN " + c1.name() + " LIMIT 1 RETURN d",
+        "FOR d IN " + c1.name() + " LIMIT 10, 5 RETURN d",
+        "FOR d1 IN " + c2.name() + " FOR d2 IN " + c1.name() + " LIMIT 1 RETURN d2" ].forEach(function (query) {
+        var result = AQL_EXECUTE(query, { }, { snapshotReads: true });
+        assertFalse(result.stats.hasOwnProperty("snapshotDocuments"));
+        assertTrue(result.json.length > 0);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection can be written after a query has read it
+////////////////////////////////////////////////////////////////////////////////
+
+    testWriteAfterQuery : function () {
+      var query = "FOR d IN " + c2.name() + " RETURN d";
+
+      assertEqual(10, execute(query, true).length);
+      c2.save({ _key: "test10", value: 10 });
+      c2.remove("test0");
+      c2.update("test1", { value: 11 });
+
+      var actual = execute("FOR d IN " + c2.name() + " SORT d.value RETURN d.value", true);
+      assertEqual([ 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 ], actual);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection can be written while a cursor is not exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+    testWriteWithOpenCursor : function () {
+      var query = "FOR d IN " + c1.name() + " SORT d.value RETURN d.value";
+      var cursor = db._query(query, null, { batchSize: 100 }, { snapshotReads: true });
+      var actual = [ ];
+
+      while (actual.length < 500) {
+        actual.push(cursor.next());
+      }
+
+      c1.save({ _key: "test2000", value: 2000 });
+      c1.remove("test0");
+      c1.update("test1", { value: -1 });
+
+      while (cursor.hasNext()) {
+        actual.push(cursor.next());
+      }
+
+      assertEqual(2000, actual.length);
+      for (var i = 0; i < 2000; ++i) {
+        assertEqual(i, actual[i]);
+      }
+
+      assertEqual(2000, c1.document("test2000").value);
+      assertFalse(c1.exists("test0"));
+      assertEqual(-1, c1.document("test1").value);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection can be written while a query reading it still runs
+////////////////////////////////////////////////////////////////////////////////
+
+    testWriteWhileQueryRuns : function () {
+      var queries = require("org/arangodb/aql/queries");
+      var tasks = require("org/arangodb/tasks");
+      var result = db._create(cnResult);
+
+      // the query sleeps for each document, so it runs for about two seconds
+      var query = "FOR d IN " + c2.name() + " LET s = SLEEP(0.2) SORT d.value RETURN d.value";
+
+      var running = function () {
+        return queries.current().filter(function (q) {
+          return q.query === query;
+        }).length > 0;
+      };
+
+      tasks.register({
+        id: "UnitTestsAhuacatlSnapshotQuery",
+        offset: 0,
+        params: { query: query, cn: cnResult },
+        command: "var db = require('internal').db; " +
+                 "var values = AQL_EXECUTE(params.query, { }, { snapshotReads: true }).json; " +
+                 "db._collection(params.cn).save({ values: values });"
+      });
+
+      var tries = 0;
+      while (! running() && ++tries < 200) {
+        internal.wait(0.05, false);
+      }
+      assertTrue(running());
+
+      // the writes must not wait for the query
+      c2.save({ _key: "test10", value: 10 });
+      c2.remove("test0");
+      c2.update("test1", { value: 11 });
+      assertTrue(running());
+
+      tries = 0;
+      while (result.count() === 0 && ++tries < 600) {
+        internal.wait(0.1, false);
+      }
+
+      assertEqual(1, result.count());
+      assertEqual([ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 ], result.toArray()[0].values);
+      assertEqual([ 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 ],
+                  execute("FOR d IN " + c2.name() + " SORT d.value RETURN d.value", false));
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(ahuacatlSnapshotReadsTestSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -1,5 +1,5 @@
 /*jshint globalstrict:false, strict:false, maxlen: 500 */
-/*global assertEqual, AQL_EXECUTE, assertTrue, fail */
+/*global assertEqual, AQL_EXECUTE, assertTrue, assertNull, fail */
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tests for optimizer rules
@@ -130,6 +130,70 @@ function withinRectangleSuite () {
     testWithinRectangleAsResultForMissingDocumentWithPositionBasedGeoIndex : function () {
       var actual =AQL_EXECUTE("RETURN WITHIN_RECTANGLE(geo2, -41, -41, -41, -41)").json[0];
       assertEqual(actual.length , 0);
+    },
+
+    testWithinRectangleLarger : function () {
+      var actual = AQL_EXECUTE("RETURN WITHIN_RECTANGLE(geo, 7, 12.2, -10.5, 3)").json[0];
+      assertEqual(actual.length , 18 * 10);
+      actual.forEach(function(doc) {
+        assertTrue(doc.lat >= -10 && doc.lat <= 7);
+        assertTrue(doc.lon >= 3 && doc.lon <= 12);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test WITHIN_POLYGON as result
+////////////////////////////////////////////////////////////////////////////////
+
+    testWithinPolygonSquare : function () {
+      var actual = AQL_EXECUTE("RETURN WITHIN_POLYGON(geo, [ [ 0, 0 ], [ 0, 10 ], [ 10, 10 ], [ 10, 0 ] ])").json[0];
+      assertEqual(actual.length , 11 * 11);
+    },
+
+    testWithinPolygonTriangle : function () {
+      var actual = AQL_EXECUTE("RETURN WITHIN_POLYGON(geo, [ [ 0, 0 ], [ 0, 10 ], [ 10, 0 ], [ 0, 0 ] ])").json[0];
+      assertEqual(actual.length , 66);
+      actual.forEach(function(doc) {
+        assertTrue(doc.lat >= 0 && doc.lon >= 0 && doc.lat + doc.lon <= 10);
+      });
+    },
+
+    testWithinPolygonConcave : function () {
+      var polygon = [ [ -5.5, -5.5 ], [ -5.5, 20.5 ], [ 3.5, 0.5 ], [ 20.5, 20.5 ], [ 20.5, -5.5 ] ];
+      var expected = AQL_EXECUTE("FOR doc IN geo FILTER IS_IN_POLYGON(@polygon, doc.lat, doc.lon) SORT doc.lat, doc.lon RETURN [ doc.lat, doc.lon ]", { polygon: polygon }).json;
+      var actual = AQL_EXECUTE("FOR doc IN WITHIN_POLYGON(geo, @polygon) SORT doc.lat, doc.lon RETURN [ doc.lat, doc.lon ]", { polygon: polygon }).json;
+      assertTrue(expected.length > 0);
+      assertEqual(expected, actual);
+      
+      actual = AQL_EXECUTE("FOR doc IN WITHIN_POLYGON(geo2, @polygon) SORT doc.pos RETURN doc.pos", { polygon: polygon }).json;
+      assertEqual(expected, actual);
+    },
+
+    testWithinPolygonSimpleQuery : function () {
+      var actual = db.geo.withinPolygon([ [ 0, 0 ], [ 0, 10 ], [ 10, 10 ], [ 10, 0 ] ]).toArray();
+      assertEqual(actual.length , 11 * 11);
+      
+      actual = db.geo.withinPolygon([ [ 0, 0 ], [ 0, 10 ], [ 10, 10 ], [ 10, 0 ] ]).limit(5).toArray();
+      assertEqual(actual.length , 5);
+    },
+
+    testWithinPolygonForMissingDocument : function () {
+      var actual = AQL_EXECUTE("RETURN WITHIN_POLYGON(geo, [ [ 50, 50 ], [ 50, 60 ], [ 60, 60 ] ])").json[0];
+      assertEqual(actual.length , 0);
+    },
+
+    testWithinPolygonInvalid : function () {
+      assertNull(AQL_EXECUTE("RETURN WITHIN_POLYGON(geo, [ [ 0, 0 ], [ 0, 10 ] ])").json[0]);
+      assertNull(AQL_EXECUTE("RETURN WITHIN_POLYGON(geo, [ [ 0, 0 ], [ 0, 10 ], 3 ])").json[0]);
+    },
+
+    testWithinPolygonForCollectionWithoutGeoIndex : function () {
+      try  {
+        AQL_EXECUTE("RETURN WITHIN_POLYGON(_graphs, [ [ 0, 0 ], [ 0, 10 ], [ 10, 10 ] ])");
+        fail();
+      } catch (e) {
+        assertTrue(e.errorNum === errors.ERROR_QUERY_GEO_INDEX_MISSING.code);
+      }
     }
 
   };
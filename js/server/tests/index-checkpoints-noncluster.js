@@ -0,0 +1,358 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual, assertTrue, assertFalse */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test primary index checkpoints
+///
+/// the server must be started with --database.index-checkpoints true, which
+/// is done by the index_checkpoints test suite of the testing framework
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+
+var db = require("org/arangodb").db;
+var internal = require("internal");
+var fs = require("fs");
+var testHelper = require("org/arangodb/test-helper").Helper;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 index checkpoints
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function IndexCheckpointsSuite () {
+  'use strict';
+  var cn = "UnitTestsIndexCheckpoints";
+  var n = 1000;
+  var c;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the filename of the collection's checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+  var checkpoint = function () {
+    return fs.join(db._path(), "collection-" + c._id, "index-checkpoint.db");
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unloads the collection, which writes a checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+  var unload = function () {
+    // no checkpoint is written while operations are still in the WAL
+    internal.wal.flush(true, true);
+    testHelper.waitUnload(c, true);
+    assertTrue(fs.exists(checkpoint()));
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves all data of the collection into sealed datafiles
+////////////////////////////////////////////////////////////////////////////////
+
+  var rotate = function () {
+    internal.wal.flush(true, true);
+    c.rotate();
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the state of the collection for comparisons
+////////////////////////////////////////////////////////////////////////////////
+
+  var state = function () {
+    var docs = { };
+    c.toArray().forEach(function (doc) {
+      docs[doc._key] = doc;
+    });
+
+    return {
+      count: c.count(),
+      revision: c.revision(),
+      alive: c.figures().alive.count,
+      docs: docs
+    };
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares the state of the collection after a reload
+////////////////////////////////////////////////////////////////////////////////
+
+  var checkState = function (expected) {
+    var actual = state();
+
+    assertEqual(expected.count, actual.count);
+    assertEqual(expected.revision, actual.revision);
+    assertEqual(expected.alive, actual.alive);
+    assertEqual(Object.keys(expected.docs).sort(), Object.keys(actual.docs).sort());
+
+    Object.keys(expected.docs).forEach(function (key) {
+      assertEqual(expected.docs[key], actual.docs[key]);
+    });
+
+    // the key generator and the primary index must work as before
+    c.insert({ _key: "new", value: -1 });
+    assertEqual(expected.count + 1, c.count());
+    assertEqual(-1, c.document("new").value);
+    c.remove("new");
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief corrupts the checkpoint with the function and reloads
+////////////////////////////////////////////////////////////////////////////////
+
+  var reloadWithCheckpoint = function (modify) {
+    var expected = state();
+
+    unload();
+
+    var buffer = fs.readBuffer(checkpoint());
+    fs.write(checkpoint(), modify(buffer));
+
+    c.load();
+    assertFalse(fs.exists(checkpoint()));
+    checkState(expected);
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      var i;
+
+      db._drop(cn);
+      c = db._create(cn, { doCompact: false });
+
+      for (i = 0; i < n; ++i) {
+        c.insert({ _key: "test" + i, value: i, values: [ i, "test" + i ] });
+      }
+
+      for (i = 0; i < n; i += 3) {
+        c.update("test" + i, { value: i + 1, added: true });
+      }
+
+      for (i = 0; i < n; i += 5) {
+        c.remove("test" + i);
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      c = null;
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unload and reload with a checkpoint
+////////////////////////////////////////////////////////////////////////////////
+
+    testReload : function () {
+      var expected = state();
+
+      unload();
+      c.load();
+
+      // the checkpoint is removed when it is read
+      assertFalse(fs.exists(checkpoint()));
+      checkState(expected);
+
+      // a second cycle must work the same way
+      expected = state();
+      unload();
+      c.load();
+      checkState(expected);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reload with a checkpoint while the secondary indexes are rebuilt
+////////////////////////////////////////////////////////////////////////////////
+
+    testReloadWithIndexes : function () {
+      c.ensureHashIndex("value");
+      c.ensureSkiplist("values");
+
+      var expected = state();
+
+      unload();
+      c.load();
+      checkState(expected);
+
+      assertEqual(1, c.byExample({ value: 2 }).toArray().length);
+      assertEqual(0, c.byExample({ value: 5 }).toArray().length);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief changes in datafiles the checkpoint does not cover are applied
+////////////////////////////////////////////////////////////////////////////////
+
+    testUncoveredDatafiles : function () {
+      var i;
+
+      // seal the journal, so the checkpoint only covers datafiles that do
+      // not change anymore
+      rotate();
+      unload();
+
+      var old = fs.readBuffer(checkpoint());
+      c.load();
+
+      // these go into a new journal
+      for (i = 1; i < n; i += 5) {
+        c.update("test" + i, { value: "updated" });
+      }
+
+      for (i = 2; i < n; i += 5) {
+        c.remove("test" + i);
+      }
+
+      for (i = 0; i < 100; ++i) {
+        c.insert({ _key: "uncovered" + i, value: i });
+      }
+
+      var expected = state();
+
+      // use the checkpoint from before the changes
+      unload();
+      fs.write(checkpoint(), old);
+
+      c.load();
+      assertFalse(fs.exists(checkpoint()));
+      checkState(expected);
+
+      for (i = 1; i < n; i += 5) {
+        assertEqual("updated", c.document("test" + i).value);
+      }
+
+      for (i = 2; i < n; i += 5) {
+        assertFalse(c.exists("test" + i));
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a stale checkpoint is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testStale : function () {
+      var i;
+
+      unload();
+
+      var old = fs.readBuffer(checkpoint());
+      c.load();
+
+      // these change the journal the checkpoint covers
+      for (i = 1; i < n; i += 5) {
+        c.remove("test" + i);
+      }
+
+      var expected = state();
+
+      unload();
+      fs.write(checkpoint(), old);
+
+      c.load();
+      assertFalse(fs.exists(checkpoint()));
+      checkState(expected);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a checkpoint with a wrong checksum is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testCorrupted : function () {
+      reloadWithCheckpoint(function (buffer) {
+        var pos = Math.floor(buffer.length / 2);
+        buffer[pos] = (buffer[pos] + 1) % 256;
+        return buffer;
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a checkpoint with a wrong header is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testWrongMagic : function () {
+      reloadWithCheckpoint(function (buffer) {
+        buffer[0] = (buffer[0] + 1) % 256;
+        return buffer;
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a truncated checkpoint is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testTruncated : function () {
+      reloadWithCheckpoint(function (buffer) {
+        return buffer.slice(0, buffer.length - 7);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a checkpoint shorter than its header is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testTruncatedHeader : function () {
+      reloadWithCheckpoint(function (buffer) {
+        return buffer.slice(0, 6);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an empty checkpoint is rejected
+////////////////////////////////////////////////////////////////////////////////
+
+    testEmpty : function () {
+      reloadWithCheckpoint(function () {
+        return "";
+      });
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(IndexCheckpointsSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\|/\\*jslint\\)"
+// End:
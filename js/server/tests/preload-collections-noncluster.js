@@ -0,0 +1,132 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test preloading collections at server start
+///
+/// the collections are created by preload-collections-setup.js, and the
+/// server is then restarted with --database.preload-collections, which is
+/// done by the preload_collections test suite of the testing framework
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+
+var arangodb = require("org/arangodb");
+var ArangoCollection = arangodb.ArangoCollection;
+var db = arangodb.db;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               collection preload
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function PreloadCollectionsSuite () {
+  'use strict';
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks the status and the data of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+  var check = function (name, status) {
+    var c = db._collection(name);
+
+    // status() does not load the collection
+    assertEqual(status, c.status());
+
+    assertEqual(10000, c.count());
+    assertEqual(9999, c.document("test9999").value);
+    assertEqual(1, c.byExample({ value: 42 }).toArray().length);
+    assertEqual(ArangoCollection.STATUS_LOADED, c.status());
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._useDatabase("_system");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collections specified by name are loaded
+////////////////////////////////////////////////////////////////////////////////
+
+    testPreloadByName : function () {
+      check("UnitTestsPreload0", ArangoCollection.STATUS_LOADED);
+      check("UnitTestsPreload1", ArangoCollection.STATUS_LOADED);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collections specified as database/collection are loaded
+////////////////////////////////////////////////////////////////////////////////
+
+    testPreloadByDatabaseAndName : function () {
+      check("UnitTestsPreload2", ArangoCollection.STATUS_LOADED);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief all collections of a database specified as database/* are loaded
+////////////////////////////////////////////////////////////////////////////////
+
+    testPreloadDatabase : function () {
+      db._useDatabase("UnitTestsPreloadDb");
+
+      check("UnitTestsPreloadOther1", ArangoCollection.STATUS_LOADED);
+      check("UnitTestsPreloadOther2", ArangoCollection.STATUS_LOADED);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief other collections are loaded on first access
+////////////////////////////////////////////////////////////////////////////////
+
+    testNoPreload : function () {
+      check("UnitTestsPreload3", ArangoCollection.STATUS_UNLOADED);
+      check("UnitTestsNoPreload", ArangoCollection.STATUS_UNLOADED);
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(PreloadCollectionsSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\|/\\*jslint\\)"
+// End:
@@ -0,0 +1,82 @@
+/*jshint globalstrict:false, strict:false */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup collections for the collection preloading tests
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+(function () {
+  'use strict';
+  var db = require("org/arangodb").db;
+  var internal = require("internal");
+
+  // small journals, so the datafiles of a collection are opened in parallel
+  var create = function (name) {
+    var i, c;
+
+    db._drop(name);
+    c = db._create(name, { journalSize: 1024 * 1024 });
+
+    for (i = 0; i < 10000; ++i) {
+      c.save({ _key: "test" + i, value: i, text: "this is a test document that fills the journal" });
+    }
+
+    c.ensureHashIndex("value");
+    return c;
+  };
+
+  var i;
+
+  for (i = 0; i < 4; ++i) {
+    create("UnitTestsPreload" + i);
+  }
+  create("UnitTestsNoPreload");
+
+  try {
+    db._dropDatabase("UnitTestsPreloadDb");
+  }
+  catch (err) {
+  }
+
+  db._createDatabase("UnitTestsPreloadDb");
+  db._useDatabase("UnitTestsPreloadDb");
+
+  create("UnitTestsPreloadOther1");
+  create("UnitTestsPreloadOther2");
+
+  db._useDatabase("_system");
+
+  // move all operations into the datafiles, so the recovery does not touch
+  // the collections when the server is restarted
+  internal.wal.flush(true, true);
+})();
+
+return {
+  status: true
+};
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @page\\|/// @}\\)"
+// End:
@@ -607,6 +607,54 @@ function ReplicationSuite () {
       );
     },
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test interleaved operations on several collections, applied in
+/// parallel
+////////////////////////////////////////////////////////////////////////////////
+
+    testParallelCollections : function () {
+      compare(
+        function (state) {
+          var c1 = db._create(cn), c2 = db._create(cn2), i;
+
+          for (i = 0; i < 5000; ++i) {
+            c1.save({ "_key" : "test" + i, "value" : i });
+            c2.save({ "_key" : "test" + i, "value" : i });
+            if (i % 3 === 0) {
+              c1.remove("test" + i);
+              c2.update("test" + i, { "value" : -i });
+            }
+            else if (i % 5 === 0) {
+              c1.update("test" + i, { "value" : -i });
+              c2.remove("test" + i);
+            }
+          }
+
+          state.checksum1 = collectionChecksum(cn);
+          state.checksum2 = collectionChecksum(cn2);
+          state.count1 = collectionCount(cn);
+          state.count2 = collectionCount(cn2);
+          assertEqual(3333, state.count1);
+          assertEqual(4334, state.count2);
+        },
+        function (state) {
+          assertEqual(state.count1, collectionCount(cn));
+          assertEqual(state.checksum1, collectionChecksum(cn));
+          assertEqual(state.count2, collectionCount(cn2));
+          assertEqual(state.checksum2, collectionChecksum(cn2));
+
+          var s = replication.applier.state().state;
+          assertTrue(s.hasOwnProperty("ticksBehind"));
+          assertTrue(s.hasOwnProperty("secondsBehind"));
+          assertEqual(4, replication.applier.properties().parallelism);
+        },
+        {
+          chunkSize: 65536,
+          parallelism: 4
+        }
+      );
+    },
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test edges
 ////////////////////////////////////////////////////////////////////////////////
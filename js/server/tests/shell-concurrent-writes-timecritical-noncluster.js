@@ -0,0 +1,333 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual, assertTrue, assertFalse */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test concurrent single-document writes on the same collection
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+
+var arangodb = require("org/arangodb");
+var db = arangodb.db;
+var internal = require("internal");
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 concurrent writes
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function ConcurrentWritesSuite () {
+  'use strict';
+  var cn = "UnitTestsConcurrentWrites";
+  var cnCollect = cn + "Collect";
+  var numTasks = 8;
+  var c;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the command in numTasks parallel tasks and waits for them.
+/// each task reports its result into the collect collection
+////////////////////////////////////////////////////////////////////////////////
+
+  var runTasks = function (command, params) {
+    var tasks = require("org/arangodb/tasks");
+    var i;
+
+    for (i = 0; i < numTasks; ++i) {
+      params.cn = cn;
+      params.task = i;
+
+      tasks.register({
+        id: "concurrentwrites" + i,
+        offset: 0,
+        params: params,
+        command: "var db = require('internal').db; " +
+                 "var result = { task: params.task, ok: 0, failed: 0, errors: { } }; " +
+                 "try { (" + String(command) + ")(params, result); } " +
+                 "catch (err) { result.error = String(err); } " +
+                 "db._collection(params.cn + 'Collect').save(result);"
+      });
+    }
+
+    var collect = db._collection(cnCollect);
+    var tries = 0;
+
+    while (collect.count() < numTasks && ++tries < 1200) {
+      internal.wait(0.1, false);
+    }
+
+    var results = collect.toArray();
+    assertEqual(numTasks, results.length);
+
+    results.forEach(function (result) {
+      assertFalse(result.hasOwnProperty("error"), result.error);
+    });
+
+    return results;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      db._drop(cnCollect);
+      c = db._create(cn);
+      db._create(cnCollect);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      c = null;
+      db._drop(cn);
+      db._drop(cnCollect);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief concurrent inserts, updates and removes of distinct documents
+////////////////////////////////////////////////////////////////////////////////
+
+    testInsertUpdateRemove : function () {
+      var n = 500;
+
+      runTasks(function (params, result) {
+        var c = db._collection(params.cn);
+        var i, key;
+
+        for (i = 0; i < params.n; ++i) {
+          key = "test" + params.task + "-" + i;
+          c.insert({ _key: key, task: params.task, value: i });
+          c.update(key, { value: i + 1 });
+
+          if (i % 2 === 0) {
+            c.remove(key);
+          }
+          result.ok++;
+        }
+      }, { n: n });
+
+      assertEqual(numTasks * n / 2, c.count());
+      assertEqual(numTasks * n / 2, c.figures().alive.count);
+
+      var i, t, doc;
+      for (t = 0; t < numTasks; ++t) {
+        for (i = 0; i < n; ++i) {
+          if (i % 2 === 0) {
+            assertFalse(c.exists("test" + t + "-" + i));
+          }
+          else {
+            doc = c.document("test" + t + "-" + i);
+            assertEqual(t, doc.task);
+            assertEqual(i + 1, doc.value);
+          }
+        }
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief concurrent updates of the same documents
+////////////////////////////////////////////////////////////////////////////////
+
+    testUpdateSameDocuments : function () {
+      var n = 100;
+      var i;
+
+      for (i = 0; i < n; ++i) {
+        c.insert({ _key: "test" + i, value: 0 });
+      }
+
+      var results = runTasks(function (params, result) {
+        var c = db._collection(params.cn);
+        var i, j;
+
+        for (j = 0; j < 10; ++j) {
+          for (i = 0; i < params.n; ++i) {
+            c.update("test" + i, { value: params.task });
+            result.ok++;
+          }
+        }
+      }, { n: n });
+
+      results.forEach(function (result) {
+        assertEqual(10 * n, result.ok);
+      });
+
+      assertEqual(n, c.count());
+
+      var revs = { };
+      c.toArray().forEach(function (doc) {
+        assertTrue(doc.value >= 0 && doc.value < numTasks);
+        assertFalse(revs.hasOwnProperty(doc._rev));
+        revs[doc._rev] = true;
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief operations that fail are rolled back while other operations of the
+/// same group succeed
+////////////////////////////////////////////////////////////////////////////////
+
+    testRollbackInsideGroup : function () {
+      var n = 200;
+      var i;
+
+      c.ensureUniqueConstraint("value");
+
+      for (i = 0; i < n; ++i) {
+        c.insert({ _key: "existing" + i, value: "existing" + i });
+      }
+
+      var results = runTasks(function (params, result) {
+        var c = db._collection(params.cn);
+        var i;
+
+        for (i = 0; i < params.n; ++i) {
+          // this one is fine
+          c.insert({ _key: "new" + params.task + "-" + i, value: "new" + params.task + "-" + i });
+          result.ok++;
+
+          // this one violates the unique constraint and must be rolled back
+          try {
+            c.insert({ _key: "failed" + params.task + "-" + i, value: "existing" + i });
+            result.ok++;
+          }
+          catch (err) {
+            result.failed++;
+            result.errors[err.errorNum] = (result.errors[err.errorNum] || 0) + 1;
+          }
+
+          // this one violates the primary index and must be rolled back
+          try {
+            c.insert({ _key: "existing" + i, value: "failed" + params.task + "-" + i });
+            result.ok++;
+          }
+          catch (err) {
+            result.failed++;
+            result.errors[err.errorNum] = (result.errors[err.errorNum] || 0) + 1;
+          }
+        }
+      }, { n: n });
+
+      var errors = internal.errors;
+
+      results.forEach(function (result) {
+        assertEqual(n, result.ok);
+        assertEqual(2 * n, result.failed);
+        assertEqual(2 * n, result.errors[errors.ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED.code]);
+      });
+
+      assertEqual(n + numTasks * n, c.count());
+      assertEqual(n + numTasks * n, c.figures().alive.count);
+
+      var t;
+      for (t = 0; t < numTasks; ++t) {
+        for (i = 0; i < n; ++i) {
+          assertFalse(c.exists("failed" + t + "-" + i));
+          assertEqual(0, c.byExample({ value: "failed" + t + "-" + i }).toArray().length);
+          assertEqual(1, c.byExample({ value: "new" + t + "-" + i }).toArray().length);
+        }
+      }
+
+      for (i = 0; i < n; ++i) {
+        var docs = c.byExample({ value: "existing" + i }).toArray();
+        assertEqual(1, docs.length);
+        assertEqual("existing" + i, docs[0]._key);
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief members of the same group insert conflicting unique values
+////////////////////////////////////////////////////////////////////////////////
+
+    testUniqueConflictsBetweenMembers : function () {
+      var n = 500;
+
+      c.ensureUniqueConstraint("value");
+
+      var results = runTasks(function (params, result) {
+        var c = db._collection(params.cn);
+        var i;
+
+        for (i = 0; i < params.n; ++i) {
+          try {
+            c.insert({ task: params.task, value: i });
+            result.ok++;
+          }
+          catch (err) {
+            result.failed++;
+            result.errors[err.errorNum] = (result.errors[err.errorNum] || 0) + 1;
+          }
+        }
+      }, { n: n });
+
+      var ok = 0;
+      var errors = internal.errors;
+
+      results.forEach(function (result) {
+        ok += result.ok;
+        assertEqual(n, result.ok + result.failed);
+
+        if (result.failed > 0) {
+          assertEqual(result.failed, result.errors[errors.ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED.code]);
+        }
+      });
+
+      // exactly one insert per value succeeded
+      assertEqual(n, ok);
+      assertEqual(n, c.count());
+
+      var i;
+      for (i = 0; i < n; ++i) {
+        assertEqual(1, c.byExample({ value: i }).toArray().length);
+      }
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(ConcurrentWritesSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\|/\\*jslint\\)"
+// End:
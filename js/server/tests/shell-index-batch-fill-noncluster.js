@@ -0,0 +1,245 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual, assertTrue */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test filling geo and fulltext indexes in batches
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+
+var db = require("org/arangodb").db;
+var testHelper = require("org/arangodb/test-helper").Helper;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  batch index fill
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function IndexBatchFillSuite () {
+  'use strict';
+  var cn = "UnitTestsIndexBatchFill";
+
+  // indexes of collections with more than 256K documents and more than one
+  // index bucket are filled in batches
+  var n = 300000;
+  var batch, single;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts the test documents. every 97th document has an invalid
+/// latitude, and every 101st document has no attributes at all
+////////////////////////////////////////////////////////////////////////////////
+
+  var fill = function (c) {
+    db._query("FOR i IN 0..@max " +
+              "INSERT MERGE({ _key: CONCAT('test', i) }, i % 101 == 0 ? { } : { " +
+              "lat: i % 97 == 0 ? 100 : (i % 1800) / 10 - 90, " +
+              "lon: FLOOR(i / 1800) / 10 - 180, " +
+              "text: CONCAT('word', i % 7, ' common', i % 13 == 0 ? ' rare' : '') " +
+              "}) IN @@cn", { max: n - 1, "@cn": c.name() });
+
+    assertEqual(n, c.count());
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of test documents matching the filter
+////////////////////////////////////////////////////////////////////////////////
+
+  var expected = function (filter) {
+    var i, count = 0;
+
+    for (i = 0; i < n; ++i) {
+      if (i % 101 !== 0 && filter(i)) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the sorted keys of the query result
+////////////////////////////////////////////////////////////////////////////////
+
+  var keys = function (query, c) {
+    return db._query(query + " SORT doc._key RETURN doc._key", { "@cn": c.name() }).toArray();
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the distances of the nearest documents
+////////////////////////////////////////////////////////////////////////////////
+
+  var distances = function (c) {
+    return db._query("FOR doc IN NEAR(@@cn, 10.03, -175.02, 500, 'd') " +
+                     "RETURN FLOOR(doc.d)", { "@cn": c.name() }).toArray();
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares the geo index of the batch-filled collection
+////////////////////////////////////////////////////////////////////////////////
+
+  var checkGeo = function () {
+    var query = "FOR doc IN WITHIN(@@cn, 0, -170, 500000)";
+    var result = keys(query, batch);
+
+    assertTrue(result.length > 1000);
+    assertEqual(keys(query, single), result);
+
+    result = distances(batch);
+    assertEqual(500, result.length);
+    assertEqual(distances(single), result);
+
+    // documents with invalid coordinates are not indexed
+    query = "FOR doc IN WITHIN(@@cn, 0, -170, 20000000)";
+    assertEqual(expected(function (i) { return i % 97 !== 0; }), keys(query, batch).length);
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares the fulltext index of the batch-filled collection
+////////////////////////////////////////////////////////////////////////////////
+
+  var checkFulltext = function () {
+    var check = function (search, filter) {
+      var query = "FOR doc IN FULLTEXT(@@cn, 'text', '" + search + "')";
+      var result = keys(query, batch);
+
+      assertEqual(expected(filter), result.length);
+      assertEqual(keys(query, single), result);
+    };
+
+    check("word3", function (i) { return i % 7 === 3; });
+    check("rare", function (i) { return i % 13 === 0; });
+    check("rare,word5", function (i) { return i % 13 === 0 && i % 7 === 5; });
+    check("common,-rare", function (i) { return i % 13 !== 0; });
+    check("prefix:wor", function () { return true; });
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unloads and reloads the collection, which fills its indexes again
+////////////////////////////////////////////////////////////////////////////////
+
+  var reload = function (c) {
+    testHelper.waitUnload(c, true);
+    c.load();
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      db._drop(cn + "Single");
+
+      batch = db._create(cn, { indexBuckets: 8 });
+      fill(batch);
+
+      // the indexes of this collection are created before the documents are
+      // inserted, so they are filled one document at a time
+      single = db._create(cn + "Single", { indexBuckets: 8 });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      batch = null;
+      single = null;
+      db._drop(cn);
+      db._drop(cn + "Single");
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fill a geo index in batches
+////////////////////////////////////////////////////////////////////////////////
+
+    testGeo : function () {
+      single.ensureGeoIndex("lat", "lon");
+      fill(single);
+
+      batch.ensureGeoIndex("lat", "lon");
+      checkGeo();
+
+      // the index is rebuilt in batches when the collection is loaded
+      reload(batch);
+      checkGeo();
+
+      // the batch-filled index must still handle single operations
+      batch.remove("test1");
+      batch.insert({ _key: "new", lat: -89.9, lon: -180 });
+      single.remove("test1");
+      single.insert({ _key: "new", lat: -89.9, lon: -180 });
+      checkGeo();
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fill a fulltext index in batches
+////////////////////////////////////////////////////////////////////////////////
+
+    testFulltext : function () {
+      single.ensureFulltextIndex("text");
+      fill(single);
+
+      batch.ensureFulltextIndex("text");
+      checkFulltext();
+
+      // the index is rebuilt in batches when the collection is loaded
+      reload(batch);
+      checkFulltext();
+
+      // the batch-filled index must still handle single operations
+      batch.update("test3", { text: "updated" });
+      single.update("test3", { text: "updated" });
+
+      var query = "FOR doc IN FULLTEXT(@@cn, 'text', 'updated')";
+      assertEqual([ "test3" ], keys(query, batch));
+      assertEqual(keys(query, single), keys(query, batch));
+      assertEqual(keys("FOR doc IN FULLTEXT(@@cn, 'text', 'word3')", single),
+                  keys("FOR doc IN FULLTEXT(@@cn, 'text', 'word3')", batch));
+    }
+
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              main
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(IndexBatchFillSuite);
+
+return jsunity.done();
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\|/\\*jslint\\)"
+// End:
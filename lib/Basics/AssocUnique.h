@@ -400,6 +400,24 @@ namespace triagens {
             return sum;
           }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the number of buckets
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t numBuckets () const {
+            return _buckets.size();
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the bucket an element with the given hash value belongs to.
+/// operations on different buckets do not touch any shared state, so callers
+/// that lock the buckets themselves can modify different buckets concurrently
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t bucketIndex (uint64_t hash) const {
+            return static_cast<size_t>(hash & _bucketsMask);
+          }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief resizes the hash table
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief log-linear latency histogram
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Dr. Frank Celler
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/LatencyHistogram.h"
+
+#include <cmath>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class LatencyHistogram
+// -----------------------------------------------------------------------------
+
+uint64_t const LatencyHistogram::SubBucketCount;
+uint64_t const LatencyHistogram::SubBucketHalfCount;
+uint64_t const LatencyHistogram::MaxValue;
+size_t const LatencyHistogram::BucketCount;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+LatencyHistogram::LatencyHistogram ()
+  : _count(0),
+    _sum(0),
+    _max(0) {
+
+  for (size_t i = 0; i < BucketCount; ++i) {
+    _counts[i] = 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a value
+////////////////////////////////////////////////////////////////////////////////
+
+void LatencyHistogram::record (uint64_t value) {
+  _counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  _sum.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t max = _max.load(std::memory_order_relaxed);
+
+  while (value > max &&
+         ! _max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    // max has been reloaded, try again
+  }
+
+  // the count is increased last, so a reader that sees it sees the bucket
+  // counter as well in most cases
+  _count.fetch_add(1, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value below or at which the given percentage of the values lie
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t LatencyHistogram::valueAtPercentile (double percentile) const {
+  uint64_t const total = count();
+
+  if (total == 0) {
+    return 0;
+  }
+
+  if (percentile < 0.0) {
+    percentile = 0.0;
+  }
+  else if (percentile > 100.0) {
+    percentile = 100.0;
+  }
+
+  uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+
+  if (target == 0) {
+    target = 1;
+  }
+
+  uint64_t const max = this->max();
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < BucketCount; ++i) {
+    seen += _counts[i].load(std::memory_order_relaxed);
+
+    if (seen >= target) {
+      uint64_t value = highestEquivalentValue(i);
+      return (value < max ? value : max);
+    }
+  }
+
+  // a value is being recorded concurrently
+  return max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bucket of a value
+////////////////////////////////////////////////////////////////////////////////
+
+size_t LatencyHistogram::bucketIndex (uint64_t value) {
+  if (value > MaxValue) {
+    value = MaxValue;
+  }
+
+  if (value < SubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+
+  // shift the value until it fits into the upper half of the sub-buckets
+  size_t shift = 0;
+
+  for (uint64_t high = value >> LATENCY_HISTOGRAM_SUB_BITS; high != 0; high >>= 1) {
+    ++shift;
+  }
+
+  return static_cast<size_t>(SubBucketCount +
+                             (shift - 1) * SubBucketHalfCount +
+                             ((value >> shift) - SubBucketHalfCount));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value that falls into a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t LatencyHistogram::highestEquivalentValue (size_t index) {
+  if (index < SubBucketCount) {
+    return index;
+  }
+
+  size_t const k     = index - SubBucketCount;
+  size_t const shift = k / SubBucketHalfCount + 1;
+  uint64_t const sub = k % SubBucketHalfCount + SubBucketHalfCount;
+
+  return ((sub + 1) << shift) - 1;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief log-linear latency histogram
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Dr. Frank Celler
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_LATENCY_HISTOGRAM_H
+#define ARANGODB_BASICS_LATENCY_HISTOGRAM_H 1
+
+#include "Basics/Common.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bits of the linear part of a histogram bucket
+/// values below 2^LATENCY_HISTOGRAM_SUB_BITS are counted exactly, larger
+/// values with a relative error below 2^-(LATENCY_HISTOGRAM_SUB_BITS - 1)
+////////////////////////////////////////////////////////////////////////////////
+
+#define LATENCY_HISTOGRAM_SUB_BITS 7
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bits of the largest value a histogram can count
+/// larger values are counted as the largest value
+////////////////////////////////////////////////////////////////////////////////
+
+#define LATENCY_HISTOGRAM_MAX_BITS 36
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class LatencyHistogram
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief log-linear histogram of latencies
+///
+/// The histogram counts integer values, usually microseconds. Values are
+/// grouped by their highest bit, and each such group is split linearly into
+/// buckets of equal width, so the width of a bucket grows with its values and
+/// the relative error of a percentile is bounded independently of the scale.
+/// With 7 sub-bucket bits and values up to 2^36 microseconds (about 19
+/// hours), the error is below 1.6 % and the histogram has 1984 buckets.
+///
+/// All counters are atomic and are updated with relaxed memory order, so a
+/// histogram can be filled and read concurrently without a lock. A reader may
+/// see the figures of a value that is being recorded only partially.
+////////////////////////////////////////////////////////////////////////////////
+
+    class LatencyHistogram {
+
+      private:
+
+        LatencyHistogram (LatencyHistogram const&) = delete;
+        LatencyHistogram& operator= (LatencyHistogram const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public constants
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of values counted exactly
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const SubBucketCount = (uint64_t) 1 << LATENCY_HISTOGRAM_SUB_BITS;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of buckets per highest bit
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const SubBucketHalfCount = SubBucketCount / 2;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value that can be counted
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const MaxValue = ((uint64_t) 1 << LATENCY_HISTOGRAM_MAX_BITS) - 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of buckets
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const BucketCount = SubBucketCount +
+          (LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BITS) * SubBucketHalfCount;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        LatencyHistogram ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a value
+////////////////////////////////////////////////////////////////////////////////
+
+        void record (uint64_t value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of values counted
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t count () const {
+          return _count.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sum of all values counted
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t sum () const {
+          return _sum.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value counted
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t max () const {
+          return _max.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value below or at which the given percentage of the values lie
+///
+/// the result is the largest value of the bucket the percentile falls into,
+/// but never larger than the largest value counted. returns 0 if nothing was
+/// counted
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t valueAtPercentile (double percentile) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bucket of a value
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t bucketIndex (uint64_t value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value that falls into a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t highestEquivalentValue (size_t index);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of values counted
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _count;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sum of all values counted
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _sum;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value counted
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _max;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counters of the buckets
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _counts[BucketCount];
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
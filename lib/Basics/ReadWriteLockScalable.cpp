@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Read-Write Lock with distributed reader counters
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/ReadWriteLockScalable.h"
+#include "Basics/memory.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        class ReadWriteLockScalable
+// -----------------------------------------------------------------------------
+
+thread_local int ReadWriteLockScalable::_mySlot = -1;
+
+std::atomic<uint32_t> ReadWriteLockScalable::_last(0);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+ReadWriteLockScalable::ReadWriteLockScalable ()
+  : _memory(nullptr),
+    _list(nullptr),
+    _writers(0),
+    _writeLocked(false),
+    _readerBackedOff(false),
+    _readersWaiting(0),
+    _writeClaimed(false),
+    _readerTurn(false),
+    _readWaits(0),
+    _writeWaits(0),
+    _readWaitTime(0),
+    _writeWaitTime(0) {
+
+  _memory = new char[READ_WRITE_LOCK_SCALABLE_SLOTS * sizeof(Entry) + 64];
+  _list = static_cast<Entry*>(TRI_Align64(_memory));
+
+  for (size_t i = 0; i < READ_WRITE_LOCK_SCALABLE_SLOTS; ++i) {
+    new (&_list[i]) Entry();
+    _list[i]._readers = 0;
+  }
+}
+
+ReadWriteLockScalable::~ReadWriteLockScalable () {
+  for (size_t i = 0; i < READ_WRITE_LOCK_SCALABLE_SLOTS; ++i) {
+    _list[i].~Entry();
+  }
+
+  delete[] _memory;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing
+////////////////////////////////////////////////////////////////////////////////
+
+void ReadWriteLockScalable::writeLock () {
+  // from now on, no new readers will get the lock
+  ++_writers;
+
+  // the clock is only read when we have to wait
+  double waitStart = 0.0;
+  std::unique_lock<std::mutex> guard(_mutex);
+
+  // wait for other writers and for the readers whose turn it is
+  while (_writeClaimed || _readerTurn) {
+    if (waitStart == 0.0) {
+      waitStart = TRI_microtime();
+    }
+    _bell.wait(guard);
+  }
+
+  _writeClaimed = true;
+
+  // wait for the readers to leave. a reader that leaves takes the mutex
+  // before it wakes us up, so we cannot miss it
+  while (readers() != 0) {
+    if (waitStart == 0.0) {
+      waitStart = TRI_microtime();
+    }
+    _bell.wait(guard);
+  }
+
+  _writeLocked = true;
+  _readerBackedOff = false;
+
+  if (waitStart != 0.0) {
+    _writeWaits.fetch_add(1, std::memory_order_relaxed);
+    _writeWaitTime.fetch_add(static_cast<uint64_t>((TRI_microtime() - waitStart) * 1000000.0), std::memory_order_relaxed);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing, but only tries
+////////////////////////////////////////////////////////////////////////////////
+
+bool ReadWriteLockScalable::tryWriteLock () {
+  {
+    std::unique_lock<std::mutex> guard(_mutex);
+
+    if (_writeClaimed || _readerTurn) {
+      return false;
+    }
+
+    ++_writers;
+
+    if (readers() == 0) {
+      _writeClaimed = true;
+      _writeLocked = true;
+      _readerBackedOff = false;
+      return true;
+    }
+
+    --_writers;
+  }
+
+  // readers that backed off in the meantime can continue
+  _bell.notify_all();
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the read lock after tryReadLock failed
+////////////////////////////////////////////////////////////////////////////////
+
+void ReadWriteLockScalable::readLockSlow () {
+  _readWaits.fetch_add(1, std::memory_order_relaxed);
+
+  double const waitStart = TRI_microtime();
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(_mutex);
+
+      ++_readersWaiting;
+
+      while (_writers.load() > 0 && ! _readerTurn) {
+        _bell.wait(guard);
+      }
+
+      --_readersWaiting;
+
+      if (_readerTurn) {
+        // a writer left while we were waiting. we get the lock even though
+        // the next writer is already waiting for it. the writer checks the
+        // reader counters under the mutex, so it will see ours
+        ++(_list[getMyId()]._readers);
+
+        if (_readersWaiting.load() == 0) {
+          // we are the last reader of this turn
+          _readerTurn = false;
+          guard.unlock();
+          _bell.notify_all();
+        }
+
+        _readWaitTime.fetch_add(static_cast<uint64_t>((TRI_microtime() - waitStart) * 1000000.0), std::memory_order_relaxed);
+        return;
+      }
+    }
+
+    if (tryReadLock()) {
+      _readWaitTime.fetch_add(static_cast<uint64_t>((TRI_microtime() - waitStart) * 1000000.0), std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+void ReadWriteLockScalable::writeUnlock () {
+  {
+    std::unique_lock<std::mutex> guard(_mutex);
+
+    _writeLocked = false;
+    _writeClaimed = false;
+    --_writers;
+
+    if (_writers.load() > 0 && _readersWaiting.load() > 0) {
+      // let the blocked readers go before the next writer
+      _readerTurn = true;
+    }
+  }
+
+  _bell.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up all waiting threads
+////////////////////////////////////////////////////////////////////////////////
+
+void ReadWriteLockScalable::wakeUp () {
+  {
+    // acquire the mutex once so a writer that has checked the reader
+    // counters is waiting on the condition variable when we notify it
+    std::unique_lock<std::mutex> guard(_mutex);
+  }
+
+  _bell.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sum of all reader counters
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t ReadWriteLockScalable::readers () const {
+  int64_t sum = 0;
+
+  for (size_t i = 0; i < READ_WRITE_LOCK_SCALABLE_SLOTS; ++i) {
+    sum += _list[i]._readers.load();
+  }
+
+  return sum;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,497 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Read-Write Lock with distributed reader counters
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_READ_WRITE_LOCK_SCALABLE_H
+#define ARANGODB_BASICS_READ_WRITE_LOCK_SCALABLE_H 1
+
+#include "Basics/Common.h"
+
+#include <mutex>
+#include <condition_variable>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of reader counters per lock
+/// threads are assigned to the counters round-robin. if there are more threads
+/// than counters, some threads share a counter, which is still correct but
+/// makes them contend for the counter's cache line again
+////////////////////////////////////////////////////////////////////////////////
+
+#define READ_WRITE_LOCK_SCALABLE_SLOTS 32
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     public macros
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief construct lockers for a ReadWriteLockScalable
+///
+/// Ones needs to use macros twice to get a unique variable based on the line
+/// number.
+////////////////////////////////////////////////////////////////////////////////
+
+#define SCALABLE_LOCKER_VAR_A(a) _scalable_lock_variable ## a
+#define SCALABLE_LOCKER_VAR_B(a) SCALABLE_LOCKER_VAR_A(a)
+
+#define READ_LOCKER_SCALABLE(b) \
+  triagens::basics::ReadLockerScalable SCALABLE_LOCKER_VAR_B(__LINE__)(&b)
+
+#define WRITE_LOCKER_SCALABLE(b) \
+  triagens::basics::WriteLockerScalable SCALABLE_LOCKER_VAR_B(__LINE__)(&b)
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        class ReadWriteLockScalable
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read-write lock optimized for many concurrent readers
+///
+/// Readers do not share any state with each other: a reader increments the
+/// counter of its own slot (each slot lies in a cache line of its own) and
+/// then checks whether a writer wants the lock. If not, the read lock is
+/// acquired without taking a mutex. A writer announces itself, waits until
+/// the sum of all reader counters drops to zero and then holds the lock.
+/// Readers that find a writer announced back off and wait until it is gone,
+/// so the mutex and the condition variable are only used when readers and
+/// writers actually meet.
+///
+/// The lock has the same semantics as ReadWriteLockCPP11, which it replaces:
+///  (1) a lock can be released by another thread than the one that acquired
+///      it, and a thread can acquire a read lock that it already holds
+///  (2) writers have a preference over readers: as long as a writer wants
+///      the lock, no new read locks are granted. When a writer releases the
+///      lock while readers are blocked, these readers get a turn before the
+///      next writer, so a queue of writers cannot starve them
+///  (3) there is a single unlock() for read and write locks
+///
+/// The lock counts how often and how long a reader or a writer had to wait
+/// for it, so contention on a lock can be observed.
+////////////////////////////////////////////////////////////////////////////////
+
+    class ReadWriteLockScalable {
+
+      private:
+
+        ReadWriteLockScalable (ReadWriteLockScalable const&) = delete;
+        ReadWriteLockScalable& operator= (ReadWriteLockScalable const&) = delete;
+
+        struct TRI_ALIGNAS(64) Entry {  // 64 is the size of a cache line,
+             // the counters of different slots must not share a cache line
+          std::atomic<int64_t> _readers;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        ReadWriteLockScalable ();
+
+        ~ReadWriteLockScalable ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing
+////////////////////////////////////////////////////////////////////////////////
+
+        void writeLock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing, but only tries
+////////////////////////////////////////////////////////////////////////////////
+
+        bool tryWriteLock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for reading
+////////////////////////////////////////////////////////////////////////////////
+
+        void readLock () {
+          if (tryReadLock()) {
+            return;
+          }
+
+          readLockSlow();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for reading, tries only
+////////////////////////////////////////////////////////////////////////////////
+
+        bool tryReadLock () {
+          std::atomic<int64_t>& readers = _list[getMyId()]._readers;
+
+          // this is implicitly using memory_order_seq_cst, which is required
+          // so that either the writer sees our counter or we see the writer
+          ++readers;
+
+          if (_writers.load() == 0) {
+            return true;
+          }
+
+          // a writer wants the lock. back off
+          --readers;
+          _readerBackedOff.store(true);
+          wakeUp();
+
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the read-lock or write-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void unlock () {
+          if (_writeLocked.load()) {
+            // there cannot be any readers while the write lock is held, so
+            // this must be the writer
+            writeUnlock();
+            return;
+          }
+
+          --(_list[getMyId()]._readers);
+
+          if (_writers.load() > 0) {
+            // a writer may wait for us
+            wakeUp();
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times a reader had to wait for the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t readWaits () const {
+          return _readWaits.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times a writer had to wait for the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t writeWaits () const {
+          return _writeWaits.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time readers waited for the lock, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+        double readWaitTime () const {
+          return _readWaitTime.load(std::memory_order_relaxed) / 1000000.0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time writers waited for the lock, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+        double writeWaitTime () const {
+          return _writeWaitTime.load(std::memory_order_relaxed) / 1000000.0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether other threads wait for the lock
+///
+/// this is meant to be called by the holder of the write lock. it returns
+/// true if another writer wants the lock, if a reader waits for it or if a
+/// reader backed off since the write lock was acquired. a holder that shares
+/// the write lock with further threads uses this to stop admitting them, so
+/// readers and other writers are not starved
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasWaiters () const {
+          return (_writers.load() > 1 ||
+                  _readersWaiting.load() > 0 ||
+                  _readerBackedOff.load());
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits for the read lock after tryReadLock failed
+////////////////////////////////////////////////////////////////////////////////
+
+        void readLockSlow ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void writeUnlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up all waiting threads
+////////////////////////////////////////////////////////////////////////////////
+
+        void wakeUp ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sum of all reader counters
+/// the counter of a single slot can become negative if a read lock is
+/// released by another thread than the one that acquired it
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t readers () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief slot of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static int getMyId () {
+          int id = _mySlot;
+
+          if (id >= 0) {
+            return id;
+          }
+
+          id = static_cast<int>((_last++) % READ_WRITE_LOCK_SCALABLE_SLOTS);
+          _mySlot = id;
+
+          return id;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory of the reader counters. operator new does not honor the
+/// alignment of Entry before C++17, so the counters are placed at the first
+/// cache line boundary inside this block
+////////////////////////////////////////////////////////////////////////////////
+
+        char* _memory;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the reader counters, one per slot
+////////////////////////////////////////////////////////////////////////////////
+
+        Entry* _list;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of writers that want or hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<int> _writers;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a writer holds the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<bool> _writeLocked;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a reader backed off since the last write lock was acquired
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<bool> _readerBackedOff;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of readers blocked in readLock()
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<int> _readersWaiting;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a writer holds the lock or waits for the readers to leave,
+/// protected by _mutex
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _writeClaimed;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the readers that were blocked when the last writer left
+/// may acquire the lock before the next writer, protected by _mutex
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _readerTurn;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a mutex, only used when readers and writers meet
+////////////////////////////////////////////////////////////////////////////////
+
+        std::mutex _mutex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a condition variable to wake up threads
+////////////////////////////////////////////////////////////////////////////////
+
+        std::condition_variable _bell;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times a reader had to wait for the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _readWaits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times a writer had to wait for the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _writeWaits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time readers waited for the lock, in microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _readWaitTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time writers waited for the lock, in microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _writeWaitTime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief next slot to assign to a thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::atomic<uint32_t> _last;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief slot of the current thread, shared by all locks
+////////////////////////////////////////////////////////////////////////////////
+
+        static thread_local int _mySlot;
+
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          class ReadLockerScalable
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read locker
+///
+/// A ReadLockerScalable read-locks a ReadWriteLockScalable during its lifetime
+/// and unlocks the lock when it is destroyed.
+////////////////////////////////////////////////////////////////////////////////
+
+    class ReadLockerScalable {
+        ReadLockerScalable (ReadLockerScalable const&) = delete;
+        ReadLockerScalable& operator= (ReadLockerScalable const&) = delete;
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aquires a read-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit
+        ReadLockerScalable (ReadWriteLockScalable* lock)
+          : _lock(lock) {
+          _lock->readLock();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the read-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        ~ReadLockerScalable () {
+          _lock->unlock();
+        }
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        ReadWriteLockScalable* _lock;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class WriteLockerScalable
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write locker
+///
+/// A WriteLockerScalable write-locks a ReadWriteLockScalable during its
+/// lifetime and unlocks the lock when it is destroyed.
+////////////////////////////////////////////////////////////////////////////////
+
+    class WriteLockerScalable {
+        WriteLockerScalable (WriteLockerScalable const&) = delete;
+        WriteLockerScalable& operator= (WriteLockerScalable const&) = delete;
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aquires a write-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit
+        WriteLockerScalable (ReadWriteLockScalable* lock)
+          : _lock(lock) {
+          _lock->writeLock();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the write-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        ~WriteLockerScalable () {
+          _lock->unlock();
+        }
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        ReadWriteLockScalable* _lock;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -30,8 +30,37 @@
 #include "ThreadPool.h"
 #include "Basics/WorkerThread.h"
 
+#include <exception>
+#include <memory>
+
 using namespace triagens::basics;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state of a concurrent run, shared with the pool tasks
+////////////////////////////////////////////////////////////////////////////////
+
+  struct ConcurrentRun {
+    ConcurrentRun ()
+      : _condition(),
+        _running(0),
+        _closed(false),
+        _error() {
+    }
+
+    triagens::basics::ConditionVariable _condition;
+    size_t _running;
+    bool _closed;
+    std::exception_ptr _error;
+  };
+
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        ThreadPool
 // -----------------------------------------------------------------------------
@@ -113,6 +142,94 @@ bool ThreadPool::dequeue (std::function<void()>& result) {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the work function in the calling thread and in up to
+/// concurrency - 1 threads of the pool at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::runConcurrently (ThreadPool* pool,
+                                  std::function<void()> const& work,
+                                  size_t concurrency) {
+  size_t helpers = 0;
+
+  if (pool != nullptr && concurrency > 1) {
+    helpers = (std::min)(concurrency - 1, pool->numThreads());
+  }
+
+  if (helpers == 0) {
+    work();
+    return;
+  }
+
+  auto run = std::make_shared<ConcurrentRun>();
+
+  // the tasks only call the work function as long as the run is open, so
+  // they may refer to it until the caller has closed the run
+  auto task = [run, &work] () -> void {
+    {
+      CONDITION_LOCKER(guard, run->_condition);
+
+      if (run->_closed) {
+        return;
+      }
+      ++run->_running;
+    }
+
+    std::exception_ptr error;
+
+    try {
+      work();
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+
+    CONDITION_LOCKER(guard, run->_condition);
+
+    if (error != nullptr && run->_error == nullptr) {
+      run->_error = error;
+    }
+    --run->_running;
+    guard.broadcast();
+  };
+
+  for (size_t i = 0; i < helpers; ++i) {
+    try {
+      pool->enqueue(task);
+    }
+    catch (...) {
+      // the caller does the work of the missing tasks
+      break;
+    }
+  }
+
+  std::exception_ptr error;
+
+  try {
+    work();
+  }
+  catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    CONDITION_LOCKER(guard, run->_condition);
+    run->_closed = true;
+
+    while (run->_running > 0) {
+      guard.wait();
+    }
+
+    if (error == nullptr) {
+      error = run->_error;
+    }
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
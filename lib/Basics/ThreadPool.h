@@ -103,6 +103,23 @@ namespace triagens {
           _condition.signal();
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the work function in the calling thread and in up to
+/// concurrency - 1 threads of the pool at the same time
+///
+/// the function must fetch its share of the work itself, e.g. by counting
+/// up an atomic, and return when there is nothing left to do. the calling
+/// thread always takes part, and pool threads that only get to the work
+/// when the caller has already finished skip it. so this may be called from
+/// a thread of the same pool and never waits for queued tasks. the first
+/// exception thrown by the function is rethrown once all threads are done.
+/// if pool is a nullptr, the function only runs in the calling thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static void runConcurrently (ThreadPool*,
+                                     std::function<void()> const&,
+                                     size_t);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "Basics/Exceptions.h"
 #include "Basics/hashes.h"
+#include "Basics/ThreadPool.h"
 
 #include <mutex>
 #include <functional>
@@ -1233,10 +1234,13 @@ namespace triagens {
     };
 
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                         class ConstDistanceFinder
+// -----------------------------------------------------------------------------
+
     template <typename VertexId, typename EdgeId>
     class ConstDistanceFinder {
 
-
       public:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1264,25 +1268,36 @@ namespace triagens {
         typedef std::function<void(VertexId& V, std::vector<EdgeId>& edges, std::vector<VertexId>& neighbors)>
                 ExpanderFunction;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimum size of both frontiers for expanding them in parallel in
+/// searchTwoThreads. smaller frontiers are cheaper to expand one at a time
+/// than to hand one of them to another thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const ParallelFrontierSize = 64;
 
       private:
 
         struct PathSnippet {
           VertexId const _pred;
           EdgeId const _path;
+          size_t const _depth;
 
-          PathSnippet (VertexId& pred, EdgeId& path) 
+          PathSnippet (VertexId& pred, EdgeId& path, size_t depth) 
             : _pred(pred),
-              _path(path) {
+              _path(path),
+              _depth(depth) {
 
           }
 
         };
 
-        std::unordered_map<VertexId, PathSnippet*> _leftFound;
+        typedef std::unordered_map<VertexId, PathSnippet*> FoundMap;
+
+        FoundMap _leftFound;
         std::deque<VertexId> _leftClosure;
 
-        std::unordered_map<VertexId, PathSnippet*> _rightFound;
+        FoundMap _rightFound;
         std::deque<VertexId> _rightClosure;
 
         ExpanderFunction _leftNeighborExpander;
@@ -1304,6 +1319,12 @@ namespace triagens {
           }
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find a path with the least number of edges between start and end.
+/// always expands the smaller of the two frontiers. nullptr indicates there
+/// is no path
+////////////////////////////////////////////////////////////////////////////////
+
         Path* search (VertexId& start, VertexId& end) {
           std::unique_ptr<Path> res(new Path());
           // Init
@@ -1320,90 +1341,256 @@ namespace triagens {
             THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
           }
 
-          std::vector<EdgeId> edges;
-          std::vector<VertexId> neighbors;
+          size_t leftDepth = 0;
+          size_t rightDepth = 0;
+          VertexId meeting;
+
           while (_leftClosure.size() > 0 && _rightClosure.size() > 0) {
-            edges.clear();
-            neighbors.clear();
-            std::deque<VertexId> _nextClosure;
+            bool found;
             if (_leftClosure.size() < _rightClosure.size()) {
-              for (VertexId& v : _leftClosure) {
-                _leftNeighborExpander(v, edges, neighbors);
-                TRI_ASSERT(edges.size() == neighbors.size());
-                for (size_t i = 0; i < neighbors.size(); ++i) {
-                  VertexId n = neighbors.at(i);
-                  if (_leftFound.find(n) == _leftFound.end()) {
-                    _leftFound.emplace(n, new PathSnippet(v, edges.at(i)));
-                    if (_rightFound.find(n) != _rightFound.end()) {
-                      res->vertices.emplace_back(n);
-                      auto it = _leftFound.find(n);
-                      VertexId next;
-                      while (it->second != nullptr) {
-                        next = it->second->_pred;
-                        res->vertices.push_front(next);
-                        res->edges.push_front(it->second->_path);
-                        it = _leftFound.find(next);
-                      }
-                      it = _rightFound.find(n);
-                      while (it->second != nullptr) {
-                        next = it->second->_pred;
-                        res->vertices.emplace_back(next);
-                        res->edges.emplace_back(it->second->_path);
-                        it = _rightFound.find(next);
-                      }
-                      res->weight = res->edges.size();
-                      TRI_IF_FAILURE("TraversalOOMPath") {
-                        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-                      }
-                      return res.release();
-                    }
-                    _nextClosure.emplace_back(n);
-                  }
-                }
-              }
-              _leftClosure = _nextClosure;
+              found = expandClosure(_leftClosure, _leftFound, _rightFound, 
+                                    _leftNeighborExpander, ++leftDepth, meeting);
             } 
             else {
-               for (VertexId& v : _rightClosure) {
-                _rightNeighborExpander(v, edges, neighbors);
-                TRI_ASSERT(edges.size() == neighbors.size());
-                for (size_t i = 0; i < neighbors.size(); ++i) {
-                  VertexId n = neighbors.at(i);
-                  if (_rightFound.find(n) == _rightFound.end()) {
-                    _rightFound.emplace(n, new PathSnippet(v, edges.at(i)));
-                    if (_leftFound.find(n) != _leftFound.end()) {
-                      res->vertices.emplace_back(n);
-                      auto it = _leftFound.find(n);
-                      VertexId next;
-                      while (it->second != nullptr) {
-                        next = it->second->_pred;
-                        res->vertices.push_front(next);
-                        res->edges.push_front(it->second->_path);
-                        it = _leftFound.find(next);
-                      }
-                      it = _rightFound.find(n);
-                      while (it->second != nullptr) {
-                        next = it->second->_pred;
-                        res->vertices.emplace_back(next);
-                        res->edges.emplace_back(it->second->_path);
-                        it = _rightFound.find(next);
-                      }
-                      res->weight = res->edges.size();
-
-                      TRI_IF_FAILURE("TraversalOOMPath") {
-                        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-                      }
-                      return res.release();
-                    }
-                    _nextClosure.emplace_back(n);
+              found = expandClosure(_rightClosure, _rightFound, _leftFound, 
+                                    _rightNeighborExpander, ++rightDepth, meeting);
+            }         
+            if (found) {
+              return buildPath(meeting);
+            }
+          }
+          return nullptr;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find a path with the least number of edges between start and end,
+/// expanding the two frontiers at the same time when both are large. the
+/// calling thread expands one of them and a thread of the pool the other,
+/// or the calling thread expands both if no thread of the pool is free. a
+/// search round ends when both frontiers have been expanded by one level,
+/// and the search terminates after the first round in which they meet.
+/// nullptr indicates there is no path
+////////////////////////////////////////////////////////////////////////////////
+
+        Path* searchTwoThreads (VertexId& start,
+                                VertexId& end,
+                                triagens::basics::ThreadPool* pool) {
+          if (start == end) {
+            std::unique_ptr<Path> res(new Path());
+            res->vertices.emplace_back(start);
+            return res.release();
+          }
+          _leftFound.emplace(start, nullptr);
+          _rightFound.emplace(end, nullptr);
+          _leftClosure.emplace_back(start);
+          _rightClosure.emplace_back(end);
+
+          TRI_IF_FAILURE("TraversalOOMInitialize") {
+            THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+          }
+
+          size_t leftDepth = 0;
+          size_t rightDepth = 0;
+          VertexId meeting;
+
+          while (_leftClosure.size() > 0 && _rightClosure.size() > 0) {
+            if (_leftClosure.size() < ParallelFrontierSize ||
+                _rightClosure.size() < ParallelFrontierSize) {
+              // at least one frontier is small. expanding the smaller one
+              // alone is cheaper than handing it to another thread
+              bool found;
+              if (_leftClosure.size() < _rightClosure.size()) {
+                found = expandClosure(_leftClosure, _leftFound, _rightFound, 
+                                      _leftNeighborExpander, ++leftDepth, meeting);
+              } 
+              else {
+                found = expandClosure(_rightClosure, _rightFound, _leftFound, 
+                                      _rightNeighborExpander, ++rightDepth, meeting);
+              }         
+              if (found) {
+                return buildPath(meeting);
+              }
+              continue;
+            }
+
+            // expand both frontiers at the same time. each side only
+            // modifies its own found map, so no locking is required
+            std::vector<VertexId> leftNew;
+            std::vector<VertexId> rightNew;
+            ++leftDepth;
+            ++rightDepth;
+
+            std::atomic<size_t> next(0);
+            std::atomic<int> res(TRI_ERROR_NO_ERROR);
+
+            auto worker = [&] () -> void {
+              try {
+                size_t side;
+                while ((side = next++) < 2) {
+                  if (side == 0) {
+                    expandLevel(_leftClosure, _leftFound, _leftNeighborExpander, leftDepth, leftNew);
+                  }
+                  else {
+                    expandLevel(_rightClosure, _rightFound, _rightNeighborExpander, rightDepth, rightNew);
                   }
                 }
               }
-              _rightClosure = _nextClosure;
-            }         
+              catch (triagens::basics::Exception const& ex) {
+                res = ex.code();
+              }
+              catch (std::bad_alloc const&) {
+                res = TRI_ERROR_OUT_OF_MEMORY;
+              }
+              catch (...) {
+                res = TRI_ERROR_INTERNAL;
+              }
+            };
+
+            try {
+              triagens::basics::ThreadPool::runConcurrently(pool, worker, 2);
+            }
+            catch (...) {
+              res = TRI_ERROR_OUT_OF_MEMORY;
+            }
+
+            if (res.load() != TRI_ERROR_NO_ERROR) {
+              THROW_ARANGO_EXCEPTION(res.load());
+            }
+
+            // the frontiers may have met in several vertices now, with
+            // different total distances. pick the closest one
+            bool found = false;
+            size_t best = 0;
+            auto check = [&] (std::vector<VertexId> const& vertices) -> void {
+              for (auto const& n : vertices) {
+                auto l = _leftFound.find(n);
+                auto r = _rightFound.find(n);
+                if (l == _leftFound.end() || r == _rightFound.end()) {
+                  continue;
+                }
+                size_t total = depth(l->second) + depth(r->second);
+                if (! found || total < best) {
+                  found = true;
+                  best = total;
+                  meeting = n;
+                }
+              }
+            };
+            check(leftNew);
+            check(rightNew);
+
+            if (found) {
+              return buildPath(meeting);
+            }
+
+            _leftClosure.assign(leftNew.begin(), leftNew.end());
+            _rightClosure.assign(rightNew.begin(), rightNew.end());
           }
           return nullptr;
         }
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the distance of a found vertex from its side's start
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t depth (PathSnippet const* snippet) {
+          return snippet == nullptr ? 0 : snippet->_depth;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief expand one side by one level. returns true as soon as a vertex is
+/// found that is also known to the other side
+////////////////////////////////////////////////////////////////////////////////
+
+        bool expandClosure (std::deque<VertexId>& closure,
+                            FoundMap& found,
+                            FoundMap const& peerFound,
+                            ExpanderFunction& expander,
+                            size_t depth,
+                            VertexId& meeting) {
+          std::vector<EdgeId> edges;
+          std::vector<VertexId> neighbors;
+          std::deque<VertexId> nextClosure;
+
+          for (VertexId& v : closure) {
+            edges.clear();
+            neighbors.clear();
+            expander(v, edges, neighbors);
+            TRI_ASSERT(edges.size() == neighbors.size());
+            for (size_t i = 0; i < neighbors.size(); ++i) {
+              VertexId& n = neighbors[i];
+              if (found.find(n) == found.end()) {
+                found.emplace(n, new PathSnippet(v, edges[i], depth));
+                if (peerFound.find(n) != peerFound.end()) {
+                  meeting = n;
+                  return true;
+                }
+                nextClosure.emplace_back(n);
+              }
+            }
+          }
+          closure = nextClosure;
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief expand one side by one level without looking at the other side
+////////////////////////////////////////////////////////////////////////////////
+
+        void expandLevel (std::deque<VertexId> const& closure,
+                          FoundMap& found,
+                          ExpanderFunction& expander,
+                          size_t depth,
+                          std::vector<VertexId>& result) {
+          std::vector<EdgeId> edges;
+          std::vector<VertexId> neighbors;
+
+          for (VertexId v : closure) {
+            edges.clear();
+            neighbors.clear();
+            expander(v, edges, neighbors);
+            TRI_ASSERT(edges.size() == neighbors.size());
+            for (size_t i = 0; i < neighbors.size(); ++i) {
+              VertexId& n = neighbors[i];
+              if (found.find(n) == found.end()) {
+                found.emplace(n, new PathSnippet(v, edges[i], depth));
+                result.emplace_back(n);
+              }
+            }
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief assemble the path running through the meeting vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        Path* buildPath (VertexId const& meeting) {
+          std::unique_ptr<Path> res(new Path());
+          res->vertices.emplace_back(meeting);
+          auto it = _leftFound.find(meeting);
+          VertexId next;
+          while (it->second != nullptr) {
+            next = it->second->_pred;
+            res->vertices.push_front(next);
+            res->edges.push_front(it->second->_path);
+            it = _leftFound.find(next);
+          }
+          it = _rightFound.find(meeting);
+          while (it->second != nullptr) {
+            next = it->second->_pred;
+            res->vertices.emplace_back(next);
+            res->edges.emplace_back(it->second->_path);
+            it = _rightFound.find(next);
+          }
+          res->weight = res->edges.size();
+
+          TRI_IF_FAILURE("TraversalOOMPath") {
+            THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+          }
+          return res.release();
+        }
     };
   }
 }
@@ -665,6 +665,106 @@ uint64_t TRI_FastHashJson (TRI_json_t const* json) {
   return FastHashJsonRecursive(0x012345678, json);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether TRI_CompareValuesJson treats a value like null
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsNullValueJson (TRI_json_t const* object) {
+  return (object == nullptr ||
+          object->_type == TRI_JSON_NULL ||
+          object->_type == TRI_JSON_UNUSED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief workhorse for TRI_ValueHashJson
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t ValueHashJsonRecursive (uint64_t hash, 
+                                        TRI_json_t const* object) {
+  if (IsNullValueJson(object)) {
+    return fasthash64(static_cast<const void*>("null"), 4, hash);
+  }
+
+  switch (object->_type) {
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL: {
+      return fasthash64(static_cast<const void*>("null"), 4, hash);
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      if (object->_value._boolean) {
+        return fasthash64(static_cast<const void*>("true"), 4, hash);
+      }
+      return fasthash64(static_cast<const void*>("false"), 5, hash);
+    }
+
+    case TRI_JSON_NUMBER: {
+      double value = object->_value._number;
+
+      if (value == 0.0) {
+        // -0 and 0 are equal
+        value = 0.0;
+      }
+      return fasthash64(static_cast<const void*>(&value), sizeof(value), hash);
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      // strings are compared with strcmp
+      char const* data = object->_value._string.data;
+      return fasthash64(static_cast<const void*>(data), strlen(data), hash);
+    }
+
+    case TRI_JSON_OBJECT: {
+      // attributes are compared by name, and a missing attribute is equal to
+      // an attribute with a null value. the attributes are hashed on their own
+      // and combined regardless of their order
+      uint64_t sum = 0;
+      size_t const n = TRI_LengthVector(&object->_value._objects);
+
+      for (size_t i = 0;  i < n;  i += 2) {
+        auto key = static_cast<TRI_json_t const*>(TRI_AddressVector(&object->_value._objects, i));
+        auto value = static_cast<TRI_json_t const*>(TRI_AddressVector(&object->_value._objects, i + 1));
+
+        if (! IsNullValueJson(value)) {
+          sum += ValueHashJsonRecursive(ValueHashJsonRecursive(0x012345678, key), value);
+        }
+      }
+
+      hash = fasthash64(static_cast<const void*>("object"), 6, hash);
+      return fasthash64(static_cast<const void*>(&sum), sizeof(sum), hash);
+    }
+
+    case TRI_JSON_ARRAY: {
+      // a missing element is equal to a null element, so trailing nulls are
+      // not hashed
+      size_t n = TRI_LengthVector(&object->_value._objects);
+
+      while (n > 0 && IsNullValueJson(static_cast<TRI_json_t const*>(TRI_AddressVector(&object->_value._objects, n - 1)))) {
+        --n;
+      }
+
+      hash = fasthash64(static_cast<const void*>("array"), 5, hash);
+
+      for (size_t i = 0;  i < n;  ++i) {
+        auto subjson = static_cast<TRI_json_t const*>(TRI_AddressVector(&object->_value._objects, i));
+        hash = ValueHashJsonRecursive(hash, subjson);
+      }
+      return hash;
+    }
+  }
+  return hash;   // never reached
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute a hash value for a JSON value that is the same for all
+/// values TRI_CheckSameValueJson considers equal
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_ValueHashJson (TRI_json_t const* json) {
+  return ValueHashJsonRecursive(0x012345678, json);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
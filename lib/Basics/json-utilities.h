@@ -106,6 +106,17 @@ uint64_t TRI_HashJson (TRI_json_t const* json);
 
 uint64_t TRI_FastHashJson (TRI_json_t const* json);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compute a hash value for a JSON value that is the same for all
+/// values TRI_CheckSameValueJson considers equal
+///
+/// unlike TRI_FastHashJson, the hash does not depend on the order of object
+/// attributes, and attributes or trailing array elements with a null value
+/// do not change it
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_ValueHashJson (TRI_json_t const* json);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compute a hash value for a JSON document depending on a list
 /// of attributes.
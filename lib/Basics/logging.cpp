@@ -40,9 +40,12 @@
 #include <syslog.h>
 #endif
 
+#include "Basics/ConditionLocker.h"
+#include "Basics/ConditionVariable.h"
 #include "Basics/Exceptions.h"
 #include "Basics/files.h"
 #include "Basics/hashes.h"
+#include "Basics/memory.h"
 #include "Basics/Mutex.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/shell-colors.h"
@@ -69,53 +72,76 @@ typedef enum {
 TRI_log_appender_type_e;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief message container
+/// @brief number of log records a thread can buffer for the logging thread
 ////////////////////////////////////////////////////////////////////////////////
 
-struct log_message_t {
-  log_message_t (log_message_t const&) = delete;
-  log_message_t& operator= (log_message_t const&) = delete;
+#define LOG_RING_SIZE 1024
 
-  log_message_t (TRI_log_level_e level,
-                 TRI_log_severity_e severity,
-                 char* message,
-                 size_t length,
-                 bool claimOwnership) 
-    : _level(level),
-      _severity(severity),
-      _message(message),
-      _length(length),
-      _freeMessage(false) {
+////////////////////////////////////////////////////////////////////////////////
+/// @brief formatted log message, waiting for the logging thread
+////////////////////////////////////////////////////////////////////////////////
 
-    TRI_ASSERT(message != nullptr);
+struct log_record_t {
+  TRI_log_level_e    _level;
+  TRI_log_severity_e _severity;
+  char*              _message;    // owned by the record
+  size_t             _length;
+  size_t             _offset;     // start of the text without date and level
+  double             _stamp;      // used to order the records of all threads
+};
 
-    if (! claimOwnership) {
-      // need to copy the message before it is invalidated
-      _message = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, message, length);
-    }
-    
-    if (_message == nullptr) {
-      _message = (char*) "out-of-memory";
-      _freeMessage = false;
-    }
-    else {
-      _freeMessage = true;
-    }
-  }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief log records of one thread
+///
+/// the ring has a single producer, the thread it belongs to, and a single
+/// consumer, the logging thread. the producer only writes _tail and the
+/// consumer only writes _head, so neither needs a lock. both counters only
+/// grow, the position of a record is its number modulo the size of the ring.
+/// the producer sets _writing while it uses the ring, so that the shutdown
+/// can wait for it before taking the last records.
+/// rings are created with CreateLogRing and freed with FreeLogRing
+////////////////////////////////////////////////////////////////////////////////
+
+struct log_ring_t {
+  explicit log_ring_t (char* memory)
+    : _head(0),
+      _tail(0),
+      _writing(false),
+      _orphaned(false),
+      _memory(memory) {
+  }
+
+  TRI_ALIGNAS(64) std::atomic<uint64_t> _head;   // next record to read
+  TRI_ALIGNAS(64) std::atomic<uint64_t> _tail;   // next record to write
+  std::atomic<bool> _writing;                    // the thread uses the ring
+  std::atomic<bool> _orphaned;                   // the thread has ended
+  char* const _memory;                           // the block the ring is in
+
+  log_record_t _records[LOG_RING_SIZE];
+};
 
-  ~log_message_t () {
-    if (_freeMessage) {
-      // free the message
-      TRI_ASSERT(_message != nullptr);
-      TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, _message);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the ring of the current thread
+///
+/// the ring is marked as orphaned when the thread ends, and freed by the
+/// logging thread once it is empty. the rings of threads that are still
+/// running are kept when logging is shut down, and used again when it is
+/// restarted. messages logged after the holder was destroyed are written
+/// directly
+////////////////////////////////////////////////////////////////////////////////
+
+struct log_ring_holder_t {
+  ~log_ring_holder_t () {
+    if (_ring != nullptr) {
+      _ring->_orphaned.store(true, std::memory_order_release);
+      _ring = nullptr;
     }
+
+    _ended = true;
   }
 
-  TRI_log_level_e const    _level;
-  TRI_log_severity_e const _severity;
-  char*                    _message;
-  size_t const             _length;
-  bool                     _freeMessage;
+  log_ring_t* _ring;
+  bool        _ended;        // the thread is ending
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -246,16 +272,56 @@ static triagens::basics::Mutex BufferLock;
 static TRI_condition_t LogCondition;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief message queue lock
+/// @brief lock for the list of rings, only taken when a thread logs for the
+/// first time and by the logging thread
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex LogRingsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the rings of all threads that logged
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<log_ring_t*> LogRings;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the ring of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local log_ring_holder_t CurrentLogRing = { nullptr, false };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief condition a thread with a full ring waits on for the logging thread
+/// to make room
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::ConditionVariable LogSpaceCondition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads waiting on LogSpaceCondition
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int> LogSpaceWaiters(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a thread whose ring is full waits for the logging thread,
+/// otherwise the message is dropped
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<bool> BlockOnOverflow(false);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of messages dropped because a ring was full. fatal errors
+/// and errors are never dropped
 ////////////////////////////////////////////////////////////////////////////////
 
-static triagens::basics::Mutex LogMessageQueueLock;
+static std::atomic<uint64_t> DroppedMessages(0);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief message queue
+/// @brief whether the logging thread is writing records it took from the rings
 ////////////////////////////////////////////////////////////////////////////////
 
-static std::vector<log_message_t*> LogMessageQueue;
+static std::atomic<bool> LoggingThreadBusy(false);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief thread used for logging
@@ -602,27 +668,60 @@ static void WriteStderr (TRI_log_level_e level,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief outputs a message string to all appenders
+/// @brief writes a message to the appenders, the caller holds AppendersLock
 ////////////////////////////////////////////////////////////////////////////////
 
-static void OutputMessage (TRI_log_level_e level,
-                           TRI_log_severity_e severity,
-                           char* message,
-                           size_t length,
-                           size_t offset,
-                           bool claimOwnership) {
-  TRI_ASSERT(message != nullptr);
-
-  if (! LoggingActive) {
+static void WriteAppenders (TRI_log_level_e level,
+                            TRI_log_severity_e severity,
+                            char const* message,
+                            size_t length) {
+  if (Appenders.empty()) {
     WriteStderr(level, message);
+    return;
+  }
 
-    if (claimOwnership) {
-      TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
+  for (auto& it : Appenders) {
+    // apply severity filter
+    if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
+        it->_severityFilter != severity) {
+      continue;
     }
 
-    return;
+    // apply content filter on log message
+    if (it->_contentFilter != nullptr) {
+      if (! TRI_IsContainedString(message, it->_contentFilter)) {
+        continue;
+      }
+    }
+
+    it->logMessage(level, severity, message, length);
+
+    if (it->_consume) {
+      break;
+    }
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up the logging thread
+////////////////////////////////////////////////////////////////////////////////
+
+static void WakeUpLoggingThread () {
+  TRI_LockCondition(&LogCondition);
+  TRI_SignalCondition(&LogCondition);
+  TRI_UnlockCondition(&LogCondition);
+}
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes a message in the calling thread
+////////////////////////////////////////////////////////////////////////////////
+
+static void WriteMessage (TRI_log_level_e level,
+                          TRI_log_severity_e severity,
+                          char* message,
+                          size_t length,
+                          size_t offset,
+                          bool claimOwnership) {
   // copy message to ring buffer of recent log messages
   if (severity == TRI_LOG_SEVERITY_HUMAN) {
     // we start copying the message from the given offset to skip any irrelevant
@@ -633,9 +732,185 @@ static void OutputMessage (TRI_log_level_e level,
 
   {
     MUTEX_LOCKER(AppendersLock);
+    WriteAppenders(level, severity, message, length);
+  }
+
+  if (claimOwnership) {
+    TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a ring
+///
+/// operator new does not honor the alignment of the ring's counters before
+/// C++17, so the ring is placed at a cache line boundary inside a larger
+/// block
+////////////////////////////////////////////////////////////////////////////////
+
+static log_ring_t* CreateLogRing () {
+  char* memory = new char[sizeof(log_ring_t) + 64];
+
+  return new (TRI_Align64(memory)) log_ring_t(memory);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a ring
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeLogRing (log_ring_t* ring) {
+  char* memory = ring->_memory;
+
+  ring->~log_ring_t();
+  delete[] memory;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the ring of the current thread
+/// returns nullptr if the thread is ending
+////////////////////////////////////////////////////////////////////////////////
+
+static log_ring_t* GetLogRing () {
+  if (CurrentLogRing._ended) {
+    return nullptr;
+  }
+
+  if (CurrentLogRing._ring == nullptr) {
+    log_ring_t* ring = CreateLogRing();
+
+    try {
+      MUTEX_LOCKER(LogRingsLock);
+      LogRings.emplace_back(ring);
+    }
+    catch (...) {
+      FreeLogRing(ring);
+      throw;
+    }
+
+    CurrentLogRing._ring = ring;
+  }
+
+  return CurrentLogRing._ring;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marks the ring of the current thread as being written
+////////////////////////////////////////////////////////////////////////////////
+
+class LogRingWriter {
+  public:
+
+    explicit LogRingWriter (log_ring_t* ring)
+      : _ring(ring) {
+      _ring->_writing.store(true);
+    }
+
+    ~LogRingWriter () {
+      _ring->_writing.store(false, std::memory_order_release);
+    }
+
+  private:
 
-    if (Appenders.empty()) {
-      WriteStderr(level, message);
+    log_ring_t* _ring;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until the logging thread has made room in the ring
+/// returns false if logging was shut down in the meantime
+////////////////////////////////////////////////////////////////////////////////
+
+static bool WaitForLogRing (log_ring_t* ring,
+                            uint64_t tail) {
+  CONDITION_LOCKER(guard, LogSpaceCondition);
+
+  ++LogSpaceWaiters;
+
+  while (true) {
+    // the shutdown waits for us, so do not wait for the logging thread
+    // once it has ended
+    if (! LoggingActive) {
+      --LogSpaceWaiters;
+      return false;
+    }
+
+    if (tail - ring->_head.load() < LOG_RING_SIZE) {
+      break;
+    }
+
+    WakeUpLoggingThread();
+
+    // the logging thread signals us after it took records. the timeout only
+    // guards against a logging thread that has ended
+    guard.wait(100 * 1000);
+  }
+
+  --LogSpaceWaiters;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands a message to the logging thread
+///
+/// the message is put into the ring of the current thread, so threads that
+/// log do not contend with each other. if the ring is full, the thread waits
+/// until the logging thread has made room, or the message is dropped. fatal
+/// errors and errors are never dropped but written by the calling thread.
+/// threads that are ending and cannot get a ring write all messages
+/// themselves
+////////////////////////////////////////////////////////////////////////////////
+
+static void PushLogRecord (TRI_log_level_e level,
+                           TRI_log_severity_e severity,
+                           char* message,
+                           size_t length,
+                           size_t offset,
+                           bool claimOwnership) {
+  log_ring_t* ring = nullptr;
+
+  try {
+    ring = GetLogRing();
+  }
+  catch (...) {
+    // out of memory
+  }
+
+  if (ring == nullptr) {
+    WriteMessage(level, severity, message, length, offset, claimOwnership);
+    return;
+  }
+
+  // announce the write before checking that logging is still active. the
+  // shutdown clears LoggingActive before it looks at the flag, so either it
+  // waits for us, or we write the message ourselves
+  LogRingWriter writer(ring);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (! LoggingActive) {
+    WriteMessage(level, severity, message, length, offset, claimOwnership);
+    return;
+  }
+
+  uint64_t const tail = ring->_tail.load(std::memory_order_relaxed);
+
+  if (tail - ring->_head.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+    bool const important = (level == TRI_LOG_LEVEL_FATAL || level == TRI_LOG_LEVEL_ERROR);
+
+    if (! important && BlockOnOverflow.load(std::memory_order_relaxed)) {
+      if (! WaitForLogRing(ring, tail)) {
+        // logging was shut down
+        WriteMessage(level, severity, message, length, offset, claimOwnership);
+        return;
+      }
+    }
+    else if (important) {
+      // we must not lose this message, and we do not want to wait for the
+      // logging thread either. it may end up out of order in the log
+      WriteMessage(level, severity, message, length, offset, claimOwnership);
+      return;
+    }
+    else {
+      DroppedMessages.fetch_add(1, std::memory_order_relaxed);
 
       if (claimOwnership) {
         TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
@@ -644,144 +919,258 @@ static void OutputMessage (TRI_log_level_e level,
     }
   }
 
-  if (ThreadedLogging) {
-    std::unique_ptr<log_message_t> msg(new log_message_t(
-      level, 
-      severity, 
-      message, 
-      length,
-      claimOwnership
-    ));
+  if (! claimOwnership) {
+    // need to copy the message before it is invalidated
+    char* copy = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, message, length);
 
-    try {
-      MUTEX_LOCKER(LogMessageQueueLock);
-      LogMessageQueue.emplace_back(msg.get());
-      msg.release();
+    if (copy == nullptr) {
+      WriteMessage(level, severity, message, length, offset, false);
+      return;
     }
-    catch (...) {
-      if (claimOwnership) {
-        TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
+
+    message = copy;
+  }
+
+  log_record_t& record = ring->_records[tail % LOG_RING_SIZE];
+
+  record._level    = level;
+  record._severity = severity;
+  record._message  = message;
+  record._length   = length;
+  record._offset   = offset;
+  record._stamp    = TRI_microtime();
+
+  ring->_tail.store(tail + 1, std::memory_order_release);
+
+  if (tail - ring->_head.load(std::memory_order_relaxed) == LOG_RING_SIZE / 2) {
+    // do not let the ring run full while the logging thread sleeps
+    WakeUpLoggingThread();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes the records of all rings and frees the rings of ended threads
+///
+/// if wait is true, waits for threads that are still putting a record into
+/// their ring, so that no record is left behind
+////////////////////////////////////////////////////////////////////////////////
+
+static void DrainLogRings (std::vector<log_record_t>& records,
+                           bool wait) {
+  MUTEX_LOCKER(LogRingsLock);
+
+  for (auto it = LogRings.begin(); it != LogRings.end(); /* no hoisting */) {
+    log_ring_t* ring = (*it);
+
+    if (wait) {
+      while (ring->_writing.load(std::memory_order_acquire)) {
+        usleep(10);
       }
-      // we can do nothing else here if we ran out of memory
+    }
+
+    // read the flag first, so all records of an ended thread are seen
+    bool const orphaned = ring->_orphaned.load(std::memory_order_acquire);
+    uint64_t head = ring->_head.load(std::memory_order_relaxed);
+    uint64_t const tail = ring->_tail.load(std::memory_order_acquire);
+
+    while (head < tail) {
+      records.emplace_back(ring->_records[head % LOG_RING_SIZE]);
+      ++head;
+    }
+
+    ring->_head.store(head);
+
+    if (orphaned) {
+      FreeLogRing(ring);
+      it = LogRings.erase(it);
+    }
+    else {
+      ++it;
     }
   }
-  else {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up the threads that wait for room in their rings
+////////////////////////////////////////////////////////////////////////////////
+
+static void WakeUpLogSpaceWaiters () {
+  if (LogSpaceWaiters.load() > 0) {
+    CONDITION_LOCKER(guard, LogSpaceCondition);
+    guard.broadcast();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes records taken from the rings and frees their messages
+////////////////////////////////////////////////////////////////////////////////
+
+static void WriteLogRecords (std::vector<log_record_t>& records) {
+  // the records of different threads are only ordered by time
+  std::stable_sort(records.begin(), records.end(), 
+                   [] (log_record_t const& left, log_record_t const& right) {
+                     return left._stamp < right._stamp;
+                   });
+
+  for (auto& record : records) {
+    if (record._severity == TRI_LOG_SEVERITY_HUMAN) {
+      TRI_ASSERT(record._length >= record._offset);
+      StoreOutput(record._level, 
+                  (time_t) record._stamp, 
+                  record._message + record._offset, 
+                  record._length - record._offset);
+    }
+  }
+
+  // output messages using the appenders
+  {
     MUTEX_LOCKER(AppendersLock);
 
-    for (auto& it : Appenders) {
-      // apply severity filter
-      if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
-          it->_severityFilter != severity) {
-        continue;
-      }
+    for (auto& record : records) {
+      WriteAppenders(record._level, record._severity, record._message, record._length);
+    }
+  }
 
-      // apply content filter on log message
-      if (it->_contentFilter != nullptr) {
-        if (! TRI_IsContainedString(message, it->_contentFilter)) {
-          continue;
-        }
-      }
+  for (auto& record : records) {
+    TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, record._message);
+  }
 
-      it->logMessage(level, severity, message, length);
+  records.clear();
+}
 
-      if (it->_consume) {
-        break;
-      }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the records the logging thread has not taken anymore
+///
+/// the rings of threads that are still running are kept, as the threads may
+/// use them at any time. they are used again if logging is restarted
+////////////////////////////////////////////////////////////////////////////////
+
+static void FlushLogRings () {
+  std::vector<log_record_t> records;
+
+  try {
+    DrainLogRings(records, true);
+  }
+  catch (...) {
+    // out of memory. the records that were taken are written
+  }
+
+  WriteLogRecords(records);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether all rings are empty
+////////////////////////////////////////////////////////////////////////////////
+
+static bool LogRingsEmpty () {
+  MUTEX_LOCKER(LogRingsLock);
+
+  for (auto& ring : LogRings) {
+    if (ring->_head.load(std::memory_order_acquire) != ring->_tail.load(std::memory_order_acquire)) {
+      return false;
     }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief outputs a message string to all appenders
+////////////////////////////////////////////////////////////////////////////////
+
+static void OutputMessage (TRI_log_level_e level,
+                           TRI_log_severity_e severity,
+                           char* message,
+                           size_t length,
+                           size_t offset,
+                           bool claimOwnership) {
+  TRI_ASSERT(message != nullptr);
+
+  if (! LoggingActive) {
+    WriteStderr(level, message);
 
     if (claimOwnership) {
       TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
     }
+
+    return;
   }
+
+  if (ThreadedLogging) {
+    // the logging thread stores the message in the ring buffer of recent
+    // log messages and writes it
+    PushLogRecord(level, severity, message, length, offset, claimOwnership);
+    return;
+  }
+
+  WriteMessage(level, severity, message, length, offset, claimOwnership);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief checks the message queue and sends message to appenders
+/// @brief takes the records of all threads and sends them to the appenders
 ////////////////////////////////////////////////////////////////////////////////
 
 static void MessageQueueWorker (void* data) {
   int sl = 100;
+  uint64_t reportedDropped = DroppedMessages.load();
+  std::vector<log_record_t> records;
   
   // now we're active
   LoggingThreadActive.store(true);
 
   while (true) {
-    std::vector<log_message_t*> buffer;
-    // copy the MessageQueue into the local buffer
-    {
-      MUTEX_LOCKER(LogMessageQueueLock);
-      buffer.swap(LogMessageQueue);
+    LoggingThreadBusy.store(true);
+
+    try {
+      DrainLogRings(records, false);
+    }
+    catch (...) {
+      // out of memory. the records that were taken are written
     }
 
-    if (buffer.empty()) {
+    WakeUpLogSpaceWaiters();
+
+    if (records.empty()) {
       sl += 1000;
 
-      if (1000000 < sl) {
-        sl = 1000000;
+      if (100000 < sl) {
+        sl = 100000;
       }
     }
     else {
-      TRI_ASSERT(! buffer.empty());
-
-      // output messages using the appenders
-      for (auto& msg : buffer) {
-        {
-          MUTEX_LOCKER(AppendersLock);
-
-          for (auto& it : Appenders) {
-            // apply severity filter
-            if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
-                it->_severityFilter != msg->_severity) {
-              continue;
-            }
-
-            // apply content filter on log message
-            if (it->_contentFilter != nullptr) {
-              if (! TRI_IsContainedString(msg->_message, it->_contentFilter)) {
-                continue;
-              }
-            }
-
-            it->logMessage(msg->_level, msg->_severity, msg->_message, msg->_length);
-
-            if (it->_consume) {
-              break;
-            }
-          }
-        }
-
-        delete msg;
-      }
-
-      buffer.clear();
+      WriteLogRecords(records);
 
       // sleep a little while
       sl = 100;
     }
 
+    LoggingThreadBusy.store(false);
+
+    uint64_t const dropped = DroppedMessages.load();
+
+    if (dropped != reportedDropped && LoggingActive) {
+      // LOG_WARNING is the syslog priority in this file
+      if (TRI_IsWarningLogging()) {
+        TRI_Log(__FUNCTION__, __FILE__, __LINE__,
+                TRI_LOG_LEVEL_WARNING,
+                TRI_LOG_SEVERITY_HUMAN,
+                "dropped %llu log message(s) because the log buffer of their thread was full",
+                (unsigned long long) (dropped - reportedDropped));
+      }
+      reportedDropped = dropped;
+    }
+
     if (LoggingActive) {
       TRI_LockCondition(&LogCondition);
       TRI_TimedWaitCondition(&LogCondition, (uint64_t) sl);
       TRI_UnlockCondition(&LogCondition);
     }
-    else {
-      MUTEX_LOCKER(LogMessageQueueLock);
-      if (LogMessageQueue.empty()) {
-        // queue is empty. we can leave this loop
-        break;
-      }
+    else if (LogRingsEmpty()) {
+      // all records have been written. we can leave this loop
+      break;
     }
   }
 
-  // cleanup
-  {
-    MUTEX_LOCKER(LogMessageQueueLock);
-    for (auto& it : LogMessageQueue) {
-      delete it;
-    }
-    LogMessageQueue.clear();
-  }
-
   LoggingThreadActive.store(false);
 }
 
@@ -1091,6 +1480,22 @@ void TRI_SetLineNumberLogging (bool show) {
   ShowLineNumber = show ? 1 : 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets whether a thread waits when its log buffer is full
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetBlockOnOverflowLogging (bool block) {
+  BlockOnOverflow.store(block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of log messages dropped
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_DroppedMessagesLogging () {
+  return DroppedMessages.load();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the file to log for debug and trace
 ////////////////////////////////////////////////////////////////////////////////
@@ -1886,6 +2291,19 @@ bool TRI_ShutdownLogging (bool clearBuffers) {
       // TODO: find some means to signal errors on shutdown
     }
 
+    // release the threads that still wait for room in their rings. they
+    // write their messages themselves now
+    {
+      CONDITION_LOCKER(guard, LogSpaceCondition);
+      guard.broadcast();
+    }
+
+    // write the records that were put into the rings after the logging
+    // thread took the last ones. this waits for threads that still use their
+    // ring, and thus LogCondition
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    FlushLogRings();
+
     TRI_DestroyCondition(&LogCondition);
   }
 
@@ -1954,11 +2372,10 @@ void TRI_FlushLogging () {
 
     int tries = 0;
     while (++tries < 500) {
-      {
-        MUTEX_LOCKER(LogMessageQueueLock);
-        if (LogMessageQueue.empty()) {
-          break;
-        }
+      // the logging thread is busy while it writes the records it has taken,
+      // so it must be checked after the rings
+      if (LogRingsEmpty() && ! LoggingThreadBusy.load()) {
+        break;
       }
 
       usleep(10000);
@@ -129,6 +129,27 @@ void TRI_SetUseLocalTimeLogging (bool);
 
 void TRI_SetLineNumberLogging (bool show);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets whether a thread waits when its log buffer is full
+///
+/// with threaded logging, each thread hands its messages to the logging
+/// thread in a buffer of its own. if the buffer is full, the thread waits
+/// until the logging thread has made room. otherwise the message is dropped
+/// and counted. fatal errors and errors are never dropped, but written by the
+/// thread itself
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetBlockOnOverflowLogging (bool block);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of log messages dropped because the log buffer
+/// of their thread was full
+///
+/// the number is reported as `droppedLogMessages` in the server statistics
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_DroppedMessagesLogging ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the file to log for debug and trace
 ////////////////////////////////////////////////////////////////////////////////